@@ -0,0 +1,251 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2019 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Measures the command round trip time of the ProteusIII driver for a burst
+ * of ProteusIII_Get calls.
+ *
+ * A pseudo terminal is used instead of a module: the serial interface of the
+ * driver opens the slave side, a responder thread on the master side answers
+ * every request after BENCHMARK_RESPONSE_US, like a module would do.
+ * Until it receives the first request the responder repeats the
+ * ProteusIII_CMD_GETSTATE_CNF a module sends after its reset.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "../drivers/ProteusIII/ProteusIII.h"
+
+#define BENCHMARK_BAUDRATE     115200
+#define BENCHMARK_COMMANDS     1000
+#define BENCHMARK_RESPONSE_US  300      /* processing time of the simulated module */
+#define BENCHMARK_MAX_FRAME    300
+
+#define CMD_STX                0x02
+#define CMD_GET_REQ            0x10
+#define CMD_GETSTATE_CNF       0x41
+#define CMD_GET_CNF            0x50
+#define CMD_TYPE_CNF           0x40
+
+static void *responder_thread(void *pArgs);
+static void SendModuleFrame(uint8_t cmd, uint8_t *dataP, uint16_t length);
+static int CompareDouble(const void *a, const void *b);
+static double GetTime_us();
+
+static int master_fd = -1;
+static volatile bool requestReceived = false;
+static double rtt_us[BENCHMARK_COMMANDS];
+
+int main ()
+{
+    ProteusIII_CallbackConfig_t callbackConfig;
+    pthread_t thread_responder;
+    char *slave_name;
+    double start_us, total_us;
+    int good = 0;
+    int i;
+
+    /* create the pty loopback */
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if((master_fd < 0) || (grantpt(master_fd) != 0) || (unlockpt(master_fd) != 0) || ((slave_name = ptsname(master_fd)) == NULL))
+    {
+        fprintf(stdout, "Creating the pseudo terminal failed: %s\n", strerror(errno));
+        return 1;
+    }
+    SetSerialDevice(slave_name);
+
+    if(pthread_create(&thread_responder, NULL, &responder_thread, NULL))
+    {
+        fprintf(stdout, "Failed to start responder thread\n");
+        return 1;
+    }
+
+    memset(&callbackConfig, 0, sizeof(callbackConfig));
+    if(false == ProteusIII_Init(BENCHMARK_BAUDRATE, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfig))
+    {
+        fprintf(stdout, "ProteusIII_Init on %s failed\n", slave_name);
+        return 1;
+    }
+    fprintf(stdout, "pty loopback on %s, %u ProteusIII_Get, module response after %u us\n\n", slave_name, BENCHMARK_COMMANDS, BENCHMARK_RESPONSE_US);
+
+    start_us = GetTime_us();
+    for(i = 0; i < BENCHMARK_COMMANDS; i++)
+    {
+        uint8_t response[BENCHMARK_MAX_FRAME];
+        uint16_t length = 0;
+        double t0 = GetTime_us();
+
+        if(ProteusIII_Get(ProteusIII_USERSETTING_POSITION_FS_FWVersion, response, &length) && (length == 3))
+        {
+            good++;
+        }
+        rtt_us[i] = GetTime_us() - t0;
+    }
+    total_us = GetTime_us() - start_us;
+
+    qsort(rtt_us, BENCHMARK_COMMANDS, sizeof(double), CompareDouble);
+    fprintf(stdout, "%-10s %10s %10s %10s %10s %10s\n", "ok", "mean us", "p50 us", "p99 us", "max us", "total ms");
+    fprintf(stdout, "%4d/%-5d %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+            good, BENCHMARK_COMMANDS,
+            total_us / BENCHMARK_COMMANDS,
+            rtt_us[BENCHMARK_COMMANDS / 2],
+            rtt_us[(BENCHMARK_COMMANDS * 99) / 100],
+            rtt_us[BENCHMARK_COMMANDS - 1],
+            total_us / 1000.0);
+
+    ProteusIII_Deinit();
+    close(master_fd);
+    return 0;
+}
+
+/* answer the requests written by the driver */
+static void *responder_thread(void *pArgs)
+{
+    uint8_t frame[BENCHMARK_MAX_FRAME];
+    uint16_t frameLength = 0;
+
+    while(1)
+    {
+        uint8_t rxChunk[SERIAL_RX_CHUNK_SIZE];
+        ssize_t received;
+        ssize_t i;
+
+        if(!requestReceived)
+        {
+            /* module announces its state after a reset */
+            uint8_t state[2] = {0x01, 0x01};
+            struct pollfd pfd;
+
+            SendModuleFrame(CMD_GETSTATE_CNF, state, sizeof(state));
+            pfd.fd = master_fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if(poll(&pfd, 1, 50) <= 0)
+            {
+                continue;
+            }
+        }
+
+        received = read(master_fd, rxChunk, sizeof(rxChunk));
+        if(received <= 0)
+        {
+            if((received < 0) && (errno == EINTR))
+            {
+                continue;
+            }
+            break;
+        }
+
+        for(i = 0; i < received; i++)
+        {
+            uint16_t length;
+
+            if((frameLength == 0) && (rxChunk[i] != CMD_STX))
+            {
+                continue;
+            }
+            frame[frameLength++] = rxChunk[i];
+            if(frameLength < 4)
+            {
+                continue;
+            }
+
+            length = (uint16_t)frame[2] | ((uint16_t)frame[3] << 8);
+            if((length + 5) > sizeof(frame))
+            {
+                frameLength = 0;
+                continue;
+            }
+            if(frameLength == (length + 5))
+            {
+                struct timespec response = {0, BENCHMARK_RESPONSE_US * 1000L};
+
+                requestReceived = true;
+                nanosleep(&response, NULL);
+                if(frame[1] == CMD_GET_REQ)
+                {
+                    uint8_t data[4] = {0x00, 0x01, 0x01, 0x02};   /* status success, version 2.1.1 */
+                    SendModuleFrame(CMD_GET_CNF, data, sizeof(data));
+                }
+                else
+                {
+                    uint8_t status = 0x00;
+                    SendModuleFrame(frame[1] | CMD_TYPE_CNF, &status, 1);
+                }
+                frameLength = 0;
+            }
+        }
+    }
+    return 0;
+}
+
+static void SendModuleFrame(uint8_t cmd, uint8_t *dataP, uint16_t length)
+{
+    uint8_t frame[BENCHMARK_MAX_FRAME];
+    uint8_t checksum = 0;
+    int i;
+
+    frame[0] = CMD_STX;
+    frame[1] = cmd;
+    frame[2] = (uint8_t)(length & 0xFF);
+    frame[3] = (uint8_t)(length >> 8);
+    memcpy(&frame[4], dataP, length);
+    for(i = 0; i < length + 4; i++)
+    {
+        checksum ^= frame[i];
+    }
+    frame[length + 4] = checksum;
+
+    if(write(master_fd, frame, length + 5) < 0)
+    {
+        fprintf(stdout, "Responder write failed: %s\n", strerror(errno));
+    }
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double GetTime_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
@@ -0,0 +1,1040 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Benchmark suite comparing the drivers against the simulated modules of
+ * the Simulator project, printing the results as JSON on stdout.
+ *
+ * For every driver it measures:
+ * - the start-up time: from calling *_Init, which resets the module, until
+ *   the driver returned ready for requests (Calypso: until its startup event)
+ * - the round trip time (p50, p99, max) of Get and Set requests
+ * - the transmit throughput with frames of the maximum payload length
+ *   and the CPU time the driver spends per frame
+ * - the receive throughput: the data indications of the simulator are
+ *   raised step by step until the driver loses frames or the simulator
+ *   can not generate them any faster, reporting the last lossless step
+ *
+ * Each driver runs in a child process, since the drivers without an
+ * *_InitEx use the default transport, which can be set up only once per
+ * process. The simulator runs in the child as well, its CPU time (see
+ * ModuleSimulator_Statistics_t) is subtracted from the CPU time of the
+ * process, so the CPU time per frame is the one of the driver.
+ * Messages printed by the drivers go to stderr.
+ *
+ * Usage: Benchmark_Drivers [-m driver] [-n commands] [-l latency_us] [-t step_ms]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <getopt.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "../drivers/ProteusIII/ProteusIII.h"
+#include "../drivers/ThyoneI/ThyoneI.h"
+#include "../drivers/TarvosIII/TarvosIII.h"
+#include "../drivers/Metis/Metis.h"
+#include "../drivers/Triton/Triton.h"
+#include "../drivers/Calypso/Calypso.h"
+#include "../drivers/Calypso/ATCommands/ATDevice.h"
+#include "../drivers/Calypso/ATCommands/ATSocket.h"
+#include "../drivers/Calypso/ATCommands/ATWLAN.h"
+#include "../drivers/Calypso/ATCommands/events.h"
+#include "../Simulator/ModuleSimulator.h"
+#include "../Simulator/CalypsoSimulator.h"
+
+#define BENCHMARK_COMMANDS         1000     /* default number of Get, Set and transmit requests */
+#define BENCHMARK_MAX_COMMANDS     100000
+#define BENCHMARK_LATENCY_US       0        /* default processing time of the simulated module */
+#define BENCHMARK_STEP_MS          500      /* default duration of a receive step */
+#define BENCHMARK_DRAIN_MS         100      /* time for the driver to read the last indications of a step */
+#define BENCHMARK_TIMEOUT_S        120      /* time after which a driver run is aborted */
+#define BENCHMARK_MAX_RESPONSE     256
+#define BENCHMARK_RESULT_SIZE      2048
+
+#define CALYPSO_BAUDRATE           921600
+#define CALYPSO_PAYLOAD_LENGTH     1000     /* payload of AT+sendTo */
+#define CALYPSO_RECV_LENGTH        256      /* payload of +recvfrom */
+#define CALYPSO_EVENT_TIMEOUT_MS   100
+
+typedef struct Benchmark_Rtt_t
+{
+    double p50_us;
+    double p99_us;
+    double max_us;
+    int errors;
+} Benchmark_Rtt_t;
+
+typedef struct Benchmark_Transmit_t
+{
+    double framesPerSecond;
+    double bytesPerSecond;
+    double cpuPerFrame_us;
+    int errors;
+} Benchmark_Transmit_t;
+
+typedef struct Benchmark_Receive_t
+{
+    unsigned int rate_hz;               /* last lossless rate */
+    unsigned int lossRate_hz;           /* first rate the driver lost frames at, 0 if none */
+    double framesPerSecond;
+    double bytesPerSecond;
+    double cpuPerFrame_us;
+    uint64_t lost;
+} Benchmark_Receive_t;
+
+typedef struct Benchmark_Driver_t
+{
+    const char *name;
+    ModuleSimulator_Module_t module;    /* ModuleSimulator_Module_Count for Calypso */
+    uint16_t payloadLength;             /* transmit and indication payload */
+    bool (*init)(void);
+    bool (*get)(void);
+    bool (*set)(void);
+    bool (*transmit)(uint8_t *payloadP, uint16_t length);
+    bool (*receive)(Benchmark_Receive_t *resultP);
+    void (*deinit)(void);
+} Benchmark_Driver_t;
+
+static bool RunDriver(const Benchmark_Driver_t *driverP, int fd);
+static bool MeasureRtt(bool (*request)(void), Benchmark_Rtt_t *resultP);
+static bool MeasureTransmit(const Benchmark_Driver_t *driverP, Benchmark_Transmit_t *resultP);
+static bool ReceiveIndications(Benchmark_Receive_t *resultP);
+static bool StartModuleSimulator(ModuleSimulator_Module_t module, uint16_t payloadLength);
+static void StopModuleSimulator();
+static bool WaitFor(volatile bool *flagP, int timeout_ms);
+static void CountRx(uint16_t length);
+static uint64_t GetDriverCpuTime_us();
+static int CompareDouble(const void *a, const void *b);
+static double GetTime_us();
+
+static bool ProteusIII_BenchInit(void);
+static bool ProteusIII_BenchGet(void);
+static bool ProteusIII_BenchSet(void);
+static bool ProteusIII_BenchTransmit(uint8_t *payloadP, uint16_t length);
+static void ProteusIII_BenchDeinit(void);
+static bool ThyoneI_BenchInit(void);
+static bool ThyoneI_BenchGet(void);
+static bool ThyoneI_BenchSet(void);
+static bool ThyoneI_BenchTransmit(uint8_t *payloadP, uint16_t length);
+static void ThyoneI_BenchDeinit(void);
+static bool TarvosIII_BenchInit(void);
+static bool TarvosIII_BenchGet(void);
+static bool TarvosIII_BenchSet(void);
+static bool TarvosIII_BenchTransmit(uint8_t *payloadP, uint16_t length);
+static void TarvosIII_BenchDeinit(void);
+static bool Metis_BenchInit(void);
+static bool Metis_BenchGet(void);
+static bool Metis_BenchSet(void);
+static bool Metis_BenchTransmit(uint8_t *payloadP, uint16_t length);
+static void Metis_BenchDeinit(void);
+static bool Triton_BenchInit(void);
+static bool Triton_BenchGet(void);
+static bool Triton_BenchSet(void);
+static bool Triton_BenchTransmit(uint8_t *payloadP, uint16_t length);
+static void Triton_BenchDeinit(void);
+static bool Calypso_BenchInit(void);
+static bool Calypso_BenchGet(void);
+static bool Calypso_BenchSet(void);
+static bool Calypso_BenchTransmit(uint8_t *payloadP, uint16_t length);
+static bool Calypso_BenchReceive(Benchmark_Receive_t *resultP);
+static void Calypso_BenchDeinit(void);
+
+static const Benchmark_Driver_t drivers[] =
+{
+    { "ProteusIII", ModuleSimulator_Module_ProteusIII, 243, ProteusIII_BenchInit, ProteusIII_BenchGet, ProteusIII_BenchSet, ProteusIII_BenchTransmit, ReceiveIndications, ProteusIII_BenchDeinit },
+    { "ThyoneI", ModuleSimulator_Module_ThyoneI, 224, ThyoneI_BenchInit, ThyoneI_BenchGet, ThyoneI_BenchSet, ThyoneI_BenchTransmit, ReceiveIndications, ThyoneI_BenchDeinit },
+    { "TarvosIII", ModuleSimulator_Module_TarvosIII, 224, TarvosIII_BenchInit, TarvosIII_BenchGet, TarvosIII_BenchSet, TarvosIII_BenchTransmit, ReceiveIndications, TarvosIII_BenchDeinit },
+    { "Metis", ModuleSimulator_Module_Metis, 250, Metis_BenchInit, Metis_BenchGet, Metis_BenchSet, Metis_BenchTransmit, ReceiveIndications, Metis_BenchDeinit },
+    { "Triton", ModuleSimulator_Module_Triton, 26, Triton_BenchInit, Triton_BenchGet, Triton_BenchSet, Triton_BenchTransmit, ReceiveIndications, Triton_BenchDeinit },
+    { "Calypso", ModuleSimulator_Module_Count, CALYPSO_PAYLOAD_LENGTH, Calypso_BenchInit, Calypso_BenchGet, Calypso_BenchSet, Calypso_BenchTransmit, Calypso_BenchReceive, Calypso_BenchDeinit },
+};
+
+/* indication rates of the receive steps */
+static const unsigned int receiveRates_hz[] = { 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000 };
+
+static int commands = BENCHMARK_COMMANDS;
+static unsigned int latency_us = BENCHMARK_LATENCY_US;
+static unsigned int step_ms = BENCHMARK_STEP_MS;
+static double rtt_us[BENCHMARK_MAX_COMMANDS];
+static double startup_us = 0;
+
+static ModuleSimulator_t *moduleSimP = NULL;
+static CalypsoSimulator_t *calypsoSimP = NULL;
+static volatile uint64_t rxFrames = 0;
+static volatile uint64_t rxBytes = 0;
+static volatile bool channelOpen = false;
+
+/* Calypso: host sockets the simulated module sends to and receives from */
+static int calypsoSinkFd = -1;
+static int calypsoSourceFd = -1;
+static uint16_t calypsoSinkPort = 0;
+static uint16_t calypsoSocketPort = 0;
+static uint8_t calypsoSocketID = 0;
+static volatile bool calypsoStartup = false;
+static volatile bool calypsoIPAcquired = false;
+
+int main(int argc, char *argv[])
+{
+    const char *selected = NULL;
+    bool first = true;
+    bool found = false;
+    int opt;
+    size_t i;
+
+    while((opt = getopt(argc, argv, "m:n:l:t:h")) != -1)
+    {
+        switch(opt)
+        {
+        case 'm':
+            selected = optarg;
+            break;
+        case 'n':
+            commands = atoi(optarg);
+            break;
+        case 'l':
+            latency_us = (unsigned int)atoi(optarg);
+            break;
+        case 't':
+            step_ms = (unsigned int)atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-m driver] [-n commands] [-l latency_us] [-t step_ms]\n", argv[0]);
+            fprintf(stderr, "  -m  run only this driver: ProteusIII, ThyoneI, TarvosIII, Metis, Triton or Calypso\n");
+            fprintf(stderr, "  -n  number of Get, Set and transmit requests (default %d)\n", BENCHMARK_COMMANDS);
+            fprintf(stderr, "  -l  processing time of the simulated module in us (default %d)\n", BENCHMARK_LATENCY_US);
+            fprintf(stderr, "  -t  duration of a receive step in ms (default %d)\n", BENCHMARK_STEP_MS);
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if((commands <= 0) || (commands > BENCHMARK_MAX_COMMANDS) || (step_ms == 0))
+    {
+        fprintf(stderr, "Invalid number of commands or step duration\n");
+        return 1;
+    }
+
+    fprintf(stdout, "[");
+    for(i = 0; i < sizeof(drivers) / sizeof(drivers[0]); i++)
+    {
+        char result[BENCHMARK_RESULT_SIZE];
+        size_t length = 0;
+        int pipefd[2];
+        int status = 0;
+        pid_t pid;
+
+        if((selected != NULL) && (strcasecmp(selected, drivers[i].name) != 0))
+        {
+            continue;
+        }
+        found = true;
+
+        if(pipe(pipefd) != 0)
+        {
+            fprintf(stderr, "Creating the result pipe failed: %s\n", strerror(errno));
+            return 1;
+        }
+        fflush(stdout);
+        pid = fork();
+        if(pid < 0)
+        {
+            fprintf(stderr, "Starting the %s benchmark failed: %s\n", drivers[i].name, strerror(errno));
+            return 1;
+        }
+        if(pid == 0)
+        {
+            /* the result goes to the pipe, the messages of the drivers to stderr */
+            close(pipefd[0]);
+            dup2(STDERR_FILENO, STDOUT_FILENO);
+            alarm(BENCHMARK_TIMEOUT_S);
+            _exit(RunDriver(&drivers[i], pipefd[1]) ? 0 : 1);
+        }
+
+        close(pipefd[1]);
+        while(length < sizeof(result) - 1)
+        {
+            ssize_t received = read(pipefd[0], &result[length], sizeof(result) - 1 - length);
+            if(received < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            if(received == 0)
+            {
+                break;
+            }
+            length += (size_t)received;
+        }
+        result[length] = '\0';
+        close(pipefd[0]);
+        waitpid(pid, &status, 0);
+
+        if((length == 0) || !WIFEXITED(status))
+        {
+            snprintf(result, sizeof(result), "{\"driver\":\"%s\",\"ok\":false}", drivers[i].name);
+        }
+        fprintf(stdout, "%s\n  %s", first ? "" : ",", result);
+        first = false;
+    }
+    fprintf(stdout, "\n]\n");
+
+    if(!found)
+    {
+        fprintf(stderr, "Unknown driver %s\n", selected);
+        return 1;
+    }
+    return 0;
+}
+
+/* run all measurements of a driver and write its JSON object to fd */
+static bool RunDriver(const Benchmark_Driver_t *driverP, int fd)
+{
+    char result[BENCHMARK_RESULT_SIZE];
+    Benchmark_Rtt_t get, set;
+    Benchmark_Transmit_t transmit;
+    Benchmark_Receive_t receive;
+    bool ok;
+    int length;
+
+    memset(&get, 0, sizeof(get));
+    memset(&set, 0, sizeof(set));
+    memset(&transmit, 0, sizeof(transmit));
+    memset(&receive, 0, sizeof(receive));
+
+    ok = driverP->init();
+    if(ok)
+    {
+        ok = MeasureRtt(driverP->get, &get);
+        ok = MeasureRtt(driverP->set, &set) && ok;
+        ok = MeasureTransmit(driverP, &transmit) && ok;
+        ok = driverP->receive(&receive) && ok;
+    }
+    else
+    {
+        fprintf(stderr, "%s: initialization failed\n", driverP->name);
+    }
+    driverP->deinit();
+
+    length = snprintf(result, sizeof(result),
+                      "{\"driver\":\"%s\",\"ok\":%s,\"commands\":%d,\"latency_us\":%u,\"startup_ms\":%.1f,"
+                      "\"get_rtt_us\":{\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f,\"errors\":%d},"
+                      "\"set_rtt_us\":{\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f,\"errors\":%d},"
+                      "\"transmit\":{\"payload\":%u,\"frames_per_s\":%.1f,\"bytes_per_s\":%.1f,\"cpu_us_per_frame\":%.2f,\"errors\":%d},"
+                      "\"receive\":{\"payload\":%u,\"rate_hz\":%u,\"loss_rate_hz\":%u,\"frames_per_s\":%.1f,\"bytes_per_s\":%.1f,\"cpu_us_per_frame\":%.2f,\"lost\":%llu}}",
+                      driverP->name, ok ? "true" : "false", commands, latency_us, startup_us / 1000,
+                      get.p50_us, get.p99_us, get.max_us, get.errors,
+                      set.p50_us, set.p99_us, set.max_us, set.errors,
+                      driverP->payloadLength, transmit.framesPerSecond, transmit.bytesPerSecond, transmit.cpuPerFrame_us, transmit.errors,
+                      (driverP->module == ModuleSimulator_Module_Count) ? CALYPSO_RECV_LENGTH : driverP->payloadLength,
+                      receive.rate_hz, receive.lossRate_hz, receive.framesPerSecond, receive.bytesPerSecond, receive.cpuPerFrame_us,
+                      (unsigned long long)receive.lost);
+    if((length <= 0) || (write(fd, result, (size_t)length) != length))
+    {
+        return false;
+    }
+    close(fd);
+    return ok;
+}
+
+static bool MeasureRtt(bool (*request)(void), Benchmark_Rtt_t *resultP)
+{
+    int i;
+
+    for(i = 0; i < commands; i++)
+    {
+        double t0 = GetTime_us();
+
+        if(!request())
+        {
+            resultP->errors++;
+        }
+        rtt_us[i] = GetTime_us() - t0;
+    }
+
+    qsort(rtt_us, commands, sizeof(double), CompareDouble);
+    resultP->p50_us = rtt_us[commands / 2];
+    resultP->p99_us = rtt_us[(commands * 99) / 100];
+    resultP->max_us = rtt_us[commands - 1];
+    return resultP->errors < commands;
+}
+
+static bool MeasureTransmit(const Benchmark_Driver_t *driverP, Benchmark_Transmit_t *resultP)
+{
+    uint8_t payload[CALYPSO_PAYLOAD_LENGTH + 1];
+    uint64_t cpu0_us;
+    double t0, total_us;
+    int good;
+    int i;
+
+    for(i = 0; i < driverP->payloadLength; i++)
+    {
+        payload[i] = (uint8_t)('A' + (i % 26));
+    }
+    /* the AT commands of Calypso take the payload as string */
+    payload[driverP->payloadLength] = '\0';
+
+    cpu0_us = GetDriverCpuTime_us();
+    t0 = GetTime_us();
+    for(i = 0; i < commands; i++)
+    {
+        if(!driverP->transmit(payload, driverP->payloadLength))
+        {
+            resultP->errors++;
+        }
+    }
+    total_us = GetTime_us() - t0;
+
+    good = commands - resultP->errors;
+    if(good > 0)
+    {
+        resultP->framesPerSecond = (double)good * 1000000.0 / total_us;
+        resultP->bytesPerSecond = resultP->framesPerSecond * driverP->payloadLength;
+        resultP->cpuPerFrame_us = (double)(GetDriverCpuTime_us() - cpu0_us) / good;
+    }
+    return good > 0;
+}
+
+/* raise the indication rate of the simulator until the driver loses frames */
+static bool ReceiveIndications(Benchmark_Receive_t *resultP)
+{
+    size_t i;
+
+    for(i = 0; i < sizeof(receiveRates_hz) / sizeof(receiveRates_hz[0]); i++)
+    {
+        ModuleSimulator_Statistics_t before, after;
+        struct timespec drain = {0, BENCHMARK_DRAIN_MS * 1000000L};
+        uint64_t frames0, bytes0, cpu0_us, sent, received, lost;
+        double t0, duration_us;
+
+        ModuleSimulator_GetStatistics(moduleSimP, &before);
+        frames0 = rxFrames;
+        bytes0 = rxBytes;
+        cpu0_us = GetDriverCpuTime_us();
+        t0 = GetTime_us();
+
+        ModuleSimulator_SetIndicationRate(moduleSimP, receiveRates_hz[i]);
+        usleep(step_ms * 1000);
+        ModuleSimulator_SetIndicationRate(moduleSimP, 0);
+        duration_us = GetTime_us() - t0;
+        nanosleep(&drain, NULL);
+
+        ModuleSimulator_GetStatistics(moduleSimP, &after);
+        sent = (after.indications - before.indications) + (after.droppedFrames - before.droppedFrames);
+        received = rxFrames - frames0;
+        lost = (sent > received) ? (sent - received) : 0;
+
+        if(lost > 0)
+        {
+            resultP->lossRate_hz = receiveRates_hz[i];
+            resultP->lost = lost;
+            break;
+        }
+
+        resultP->rate_hz = receiveRates_hz[i];
+        resultP->framesPerSecond = (double)received * 1000000.0 / duration_us;
+        resultP->bytesPerSecond = (double)(rxBytes - bytes0) * 1000000.0 / duration_us;
+        resultP->cpuPerFrame_us = (received > 0) ? ((double)(GetDriverCpuTime_us() - cpu0_us) / received) : 0;
+
+        if(sent * 10 < (uint64_t)receiveRates_hz[i] * step_ms * 9 / 1000)
+        {
+            /* the simulator reached its limit */
+            break;
+        }
+    }
+    return resultP->rate_hz > 0;
+}
+
+/* create the simulator and connect the default transport to it */
+static bool StartModuleSimulator(ModuleSimulator_Module_t module, uint16_t payloadLength)
+{
+    ModuleSimulator_Config_t config;
+
+    ModuleSimulator_GetDefaultConfig(module, &config);
+    config.latency_us = latency_us;
+    config.airtime_us = 0;
+    config.ind_payload_length = payloadLength;
+
+    moduleSimP = ModuleSimulator_Create(&config);
+    if((moduleSimP == NULL) || !ModuleSimulator_Start(moduleSimP))
+    {
+        fprintf(stderr, "Starting the %s simulator failed\n", ModuleSimulator_GetModuleName(module));
+        return false;
+    }
+    if(!SetSerialDevice(ModuleSimulator_GetPeerName(moduleSimP)))
+    {
+        return false;
+    }
+    PtyTransport_SetPinCallback(GetDefaultTransport(), ModuleSimulator_PinCallback, moduleSimP);
+    return true;
+}
+
+static void StopModuleSimulator()
+{
+    ModuleSimulator_Destroy(moduleSimP);
+    moduleSimP = NULL;
+}
+
+static bool WaitFor(volatile bool *flagP, int timeout_ms)
+{
+    while(!*flagP && (timeout_ms-- > 0))
+    {
+        usleep(1000);
+    }
+    return *flagP;
+}
+
+static void CountRx(uint16_t length)
+{
+    rxFrames++;
+    rxBytes += length;
+}
+
+/* CPU time of the process without the threads of the simulator */
+static uint64_t GetDriverCpuTime_us()
+{
+    struct timespec ts;
+    uint64_t process_us, simulator_us = 0;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    process_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+
+    if(moduleSimP != NULL)
+    {
+        ModuleSimulator_Statistics_t statistics;
+        ModuleSimulator_GetStatistics(moduleSimP, &statistics);
+        simulator_us = statistics.cpuTime_us;
+    }
+    else if(calypsoSimP != NULL)
+    {
+        CalypsoSimulator_Statistics_t statistics;
+        CalypsoSimulator_GetStatistics(calypsoSimP, &statistics);
+        simulator_us = statistics.cpuTime_us;
+    }
+    return (process_us > simulator_us) ? (process_us - simulator_us) : 0;
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double GetTime_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
+
+/**************************************
+ *             ProteusIII             *
+ **************************************/
+
+static void ProteusIII_RxCallback(uint8_t *payload, uint16_t payload_length, uint8_t *BTMAC, int8_t rssi)
+{
+    CountRx(payload_length);
+}
+
+static void ProteusIII_ChannelOpenCallback(uint8_t *BTMAC, uint16_t max_payload)
+{
+    channelOpen = true;
+}
+
+static bool ProteusIII_BenchInit(void)
+{
+    ProteusIII_CallbackConfig_t callbackConfig;
+    double t0;
+
+    if(!StartModuleSimulator(ModuleSimulator_Module_ProteusIII, 243))
+    {
+        return false;
+    }
+    memset(&callbackConfig, 0, sizeof(callbackConfig));
+    callbackConfig.rxCb = ProteusIII_RxCallback;
+    callbackConfig.channelOpenCb = ProteusIII_ChannelOpenCallback;
+    t0 = GetTime_us();
+    if(!ProteusIII_Init(115200, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfig))
+    {
+        return false;
+    }
+    startup_us = GetTime_us() - t0;
+    /* the simulated peer connects after the startup */
+    return WaitFor(&channelOpen, 1000);
+}
+
+static bool ProteusIII_BenchGet(void)
+{
+    uint8_t response[BENCHMARK_MAX_RESPONSE];
+    uint16_t length = 0;
+    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_FS_FWVersion, response, &length) && (length == 3);
+}
+
+static bool ProteusIII_BenchSet(void)
+{
+    uint8_t scanFactor = 2;
+    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_SCAN_FACTOR, &scanFactor, 1);
+}
+
+static bool ProteusIII_BenchTransmit(uint8_t *payloadP, uint16_t length)
+{
+    return ProteusIII_Transmit(payloadP, length);
+}
+
+static void ProteusIII_BenchDeinit(void)
+{
+    ProteusIII_Deinit();
+    StopModuleSimulator();
+}
+
+/**************************************
+ *              ThyoneI               *
+ **************************************/
+
+static void ThyoneI_RxCallback(uint8_t *payload, uint16_t payload_length, uint32_t sourceAddress, int8_t rssi)
+{
+    CountRx(payload_length);
+}
+
+static bool ThyoneI_BenchInit(void)
+{
+    double t0;
+
+    if(!StartModuleSimulator(ModuleSimulator_Module_ThyoneI, 224))
+    {
+        return false;
+    }
+    t0 = GetTime_us();
+    if(!ThyoneI_Init(115200, ThyoneI_PIN_RESET, ThyoneI_PIN_WAKEUP, ThyoneI_PIN_BOOT, ThyoneI_RxCallback))
+    {
+        return false;
+    }
+    startup_us = GetTime_us() - t0;
+    return true;
+}
+
+static bool ThyoneI_BenchGet(void)
+{
+    uint8_t response[BENCHMARK_MAX_RESPONSE];
+    uint16_t length = 0;
+    return ThyoneI_Get(ThyoneI_USERSETTING_INDEX_FW_VERSION, response, &length) && (length == 3);
+}
+
+static bool ThyoneI_BenchSet(void)
+{
+    uint8_t txPower = 4;
+    return ThyoneI_Set(ThyoneI_USERSETTING_INDEX_RF_TX_POWER, &txPower, 1);
+}
+
+static bool ThyoneI_BenchTransmit(uint8_t *payloadP, uint16_t length)
+{
+    return ThyoneI_TransmitBroadcast(payloadP, length);
+}
+
+static void ThyoneI_BenchDeinit(void)
+{
+    ThyoneI_Deinit();
+    StopModuleSimulator();
+}
+
+/**************************************
+ *             TarvosIII              *
+ **************************************/
+
+static void TarvosIII_RxCallback(uint8_t *payload, uint8_t payload_length, uint8_t dest_network_id, uint8_t dest_address_lsb, uint8_t dest_address_msb, int8_t rssi)
+{
+    CountRx(payload_length);
+}
+
+static bool TarvosIII_BenchInit(void)
+{
+    double t0;
+
+    if(!StartModuleSimulator(ModuleSimulator_Module_TarvosIII, 224))
+    {
+        return false;
+    }
+    t0 = GetTime_us();
+    if(!TarvosIII_Init(115200, TarvosIII_PIN_RESET, TarvosIII_PIN_WAKEUP, TarvosIII_PIN_BOOT, TarvosIII_RxCallback, AddressMode_0))
+    {
+        return false;
+    }
+    startup_us = GetTime_us() - t0;
+    return true;
+}
+
+static bool TarvosIII_BenchGet(void)
+{
+    uint8_t response[BENCHMARK_MAX_RESPONSE];
+    uint8_t length = 0;
+    return TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_DEFAULTRFCHANNEL, response, &length) && (length == 1);
+}
+
+static bool TarvosIII_BenchSet(void)
+{
+    uint8_t retries = 0;
+    return TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_NUMRETRYS, &retries, 1);
+}
+
+static bool TarvosIII_BenchTransmit(uint8_t *payloadP, uint16_t length)
+{
+    return TarvosIII_Transmit(payloadP, (uint8_t)length);
+}
+
+static void TarvosIII_BenchDeinit(void)
+{
+    TarvosIII_Deinit();
+    StopModuleSimulator();
+}
+
+/**************************************
+ *               Metis                *
+ **************************************/
+
+static void Metis_RxCallback(uint8_t *payload, uint8_t payload_length, int8_t rssi)
+{
+    CountRx(payload_length);
+}
+
+static bool Metis_BenchInit(void)
+{
+    double t0;
+
+    if(!StartModuleSimulator(ModuleSimulator_Module_Metis, 250))
+    {
+        return false;
+    }
+    t0 = GetTime_us();
+    if(!Metis_Init(9600, Metis_PIN_RESET, MBus_Frequency_868, MBus_Mode_868_S1, true, Metis_RxCallback))
+    {
+        return false;
+    }
+    startup_us = GetTime_us() - t0;
+    return true;
+}
+
+static bool Metis_BenchGet(void)
+{
+    uint8_t response[BENCHMARK_MAX_RESPONSE];
+    uint8_t length = 0;
+    return Metis_Get(Metis_USERSETTING_MEMPOSITION_DEFAULTRFTXPOWER, response, &length) && (length == 1);
+}
+
+static bool Metis_BenchSet(void)
+{
+    uint8_t txPower = 14;
+    return Metis_Set(Metis_USERSETTING_MEMPOSITION_DEFAULTRFTXPOWER, &txPower, 1);
+}
+
+/* the first byte of a wM-BUS frame is its length */
+static bool Metis_BenchTransmit(uint8_t *payloadP, uint16_t length)
+{
+    uint8_t frame[256];
+
+    frame[0] = (uint8_t)length;
+    memcpy(&frame[1], payloadP, length);
+    return Metis_Transmit(frame);
+}
+
+static void Metis_BenchDeinit(void)
+{
+    Metis_Deinit();
+    StopModuleSimulator();
+}
+
+/**************************************
+ *              Triton                *
+ **************************************/
+
+static void Triton_RxCallback(uint8_t *payload, uint8_t payload_length, uint8_t sourceAddress, int8_t rssi)
+{
+    CountRx(payload_length);
+}
+
+static bool Triton_BenchInit(void)
+{
+    double t0;
+
+    if(!StartModuleSimulator(ModuleSimulator_Module_Triton, 26))
+    {
+        return false;
+    }
+    t0 = GetTime_us();
+    if(!Triton_Init(115200, Triton_PIN_RESET, Triton_PIN_WAKEUP, Triton_RxCallback))
+    {
+        return false;
+    }
+    startup_us = GetTime_us() - t0;
+    return true;
+}
+
+static bool Triton_BenchGet(void)
+{
+    uint8_t response[BENCHMARK_MAX_RESPONSE];
+    uint8_t length = 0;
+    return Triton_Get(Triton_CMD_SETGET_OPTION_RFPOWERLEVEL, response, &length) && (length == 1);
+}
+
+static bool Triton_BenchSet(void)
+{
+    uint8_t powerLevel = 0x0C;
+    return Triton_Set(Triton_CMD_SETGET_OPTION_RFPOWERLEVEL, &powerLevel, 1);
+}
+
+static bool Triton_BenchTransmit(uint8_t *payloadP, uint16_t length)
+{
+    return Triton_Transmit_Extended(payloadP, (uint8_t)length, 0xFF);
+}
+
+static void Triton_BenchDeinit(void)
+{
+    Triton_Deinit();
+    StopModuleSimulator();
+}
+
+/**************************************
+ *              Calypso               *
+ **************************************/
+
+static void Calypso_EventCallback(char *eventP)
+{
+    ATEvent_t event;
+    char *argumentsP = eventP;
+
+    if(!ATEvent_parseEventName(&argumentsP, &event))
+    {
+        return;
+    }
+    switch(event)
+    {
+    case ATEvent_Startup:
+        calypsoStartup = true;
+        break;
+    case ATEvent_NetappIP4Aquired:
+        calypsoIPAcquired = true;
+        break;
+    case ATEvent_SocketRcvdFrom:
+        CountRx(CALYPSO_RECV_LENGTH);
+        break;
+    default:
+        break;
+    }
+}
+
+/* bind a host UDP socket to an ephemeral port of the loopback interface */
+static int OpenHostSocket(uint16_t *portP)
+{
+    struct sockaddr_in addr;
+    socklen_t addrLength = sizeof(addr);
+    int fd;
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if(fd < 0)
+    {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if((bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+       (getsockname(fd, (struct sockaddr *)&addr, &addrLength) != 0))
+    {
+        close(fd);
+        return -1;
+    }
+    *portP = ntohs(addr.sin_port);
+    return fd;
+}
+
+static bool Calypso_BenchInit(void)
+{
+    CalypsoSimulator_Config_t config;
+    ATWLAN_ConnectionArguments_t connection;
+    ATSocket_Descriptor_t local;
+    uint16_t port;
+    int fd;
+    double t0;
+
+    CalypsoSimulator_GetDefaultConfig(&config);
+    config.latency_us = latency_us;
+    calypsoSimP = CalypsoSimulator_Create(&config);
+    if((calypsoSimP == NULL) || !CalypsoSimulator_Start(calypsoSimP))
+    {
+        fprintf(stderr, "Starting the Calypso simulator failed\n");
+        return false;
+    }
+    if(!SetSerialDevice(CalypsoSimulator_GetPeerName(calypsoSimP)))
+    {
+        return false;
+    }
+    t0 = GetTime_us();
+    if(!Calypso_Init(CALYPSO_BAUDRATE, Calypso_ParityBit_EVEN, Calypso_EventCallback) ||
+       !WaitFor(&calypsoStartup, 1000))
+    {
+        return false;
+    }
+    startup_us = GetTime_us() - t0;
+
+    memset(&connection, 0, sizeof(connection));
+    strcpy(connection.SSID, "benchmark");
+    connection.securityParams.securityType = ATWLAN_SECURITY_TYPE_WPA_WPA2;
+    strcpy(connection.securityParams.securityKey, "benchmark");
+    if(!ATWLAN_connect(connection) || !WaitFor(&calypsoIPAcquired, 1000))
+    {
+        return false;
+    }
+
+    calypsoSinkFd = OpenHostSocket(&calypsoSinkPort);
+    calypsoSourceFd = OpenHostSocket(&port);
+    if((calypsoSinkFd < 0) || (calypsoSourceFd < 0))
+    {
+        fprintf(stderr, "Creating the host sockets failed: %s\n", strerror(errno));
+        return false;
+    }
+
+    /* reserve a free port for the socket of the module */
+    fd = OpenHostSocket(&calypsoSocketPort);
+    if(fd < 0)
+    {
+        return false;
+    }
+    close(fd);
+
+    local.family = ATSocket_Family_INET;
+    local.port = calypsoSocketPort;
+    strcpy(local.address, "127.0.0.1");
+    return ATSocket_create(ATSocket_Family_INET, ATSocket_Type_Datagram, ATSocket_Protocol_UDP, &calypsoSocketID) &&
+           ATSocket_bind(calypsoSocketID, local);
+}
+
+static bool Calypso_BenchGet(void)
+{
+    ATDevice_Version_t version;
+    size_t size = 0;
+    return ATDevice_get(ATDEVICE_ID_general, ATDEVICE_GENERAL_version, &version, &size);
+}
+
+static bool Calypso_BenchSet(void)
+{
+    uint32_t persistent = 1;
+    return ATDevice_set(ATDEVICE_ID_general, ATDEVICE_GENERAL_persistent, &persistent);
+}
+
+static bool Calypso_BenchTransmit(uint8_t *payloadP, uint16_t length)
+{
+    ATSocket_Descriptor_t destination;
+
+    destination.family = ATSocket_Family_INET;
+    destination.port = calypsoSinkPort;
+    strcpy(destination.address, "127.0.0.1");
+    return ATSocket_sendTo(calypsoSocketID, destination, Calypso_DataFormat_Base64, true, length, (char *)payloadP);
+}
+
+/*
+ * The module reports received data only after AT+recvFrom, so the rate
+ * can not be raised like for the other modules: each datagram is sent to
+ * the socket of the module, received with AT+recvFrom and its +recvfrom
+ * event awaited before the next one.
+ */
+static bool Calypso_BenchReceive(Benchmark_Receive_t *resultP)
+{
+    uint8_t payload[CALYPSO_RECV_LENGTH];
+    struct sockaddr_in addr;
+    ATSocket_Descriptor_t source;
+    uint64_t frames0, cpu0_us, received;
+    double t0, duration_us;
+    int i;
+
+    memset(payload, 'R', sizeof(payload));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(calypsoSocketPort);
+    source.family = ATSocket_Family_INET;
+    source.port = 0;
+    strcpy(source.address, "127.0.0.1");
+
+    frames0 = rxFrames;
+    cpu0_us = GetDriverCpuTime_us();
+    t0 = GetTime_us();
+    for(i = 0; i < commands; i++)
+    {
+        uint64_t expected = rxFrames + 1;
+        int timeout_ms = CALYPSO_EVENT_TIMEOUT_MS;
+
+        if((sendto(calypsoSourceFd, payload, sizeof(payload), 0, (struct sockaddr *)&addr, sizeof(addr)) != sizeof(payload)) ||
+           !ATSocket_recvFrom(calypsoSocketID, source, Calypso_DataFormat_Base64, sizeof(payload)))
+        {
+            resultP->lost++;
+            continue;
+        }
+        while((rxFrames < expected) && (timeout_ms-- > 0))
+        {
+            usleep(100);
+        }
+        if(rxFrames < expected)
+        {
+            resultP->lost++;
+        }
+    }
+    duration_us = GetTime_us() - t0;
+
+    received = rxFrames - frames0;
+    resultP->framesPerSecond = (double)received * 1000000.0 / duration_us;
+    resultP->bytesPerSecond = resultP->framesPerSecond * CALYPSO_RECV_LENGTH;
+    resultP->cpuPerFrame_us = (received > 0) ? ((double)(GetDriverCpuTime_us() - cpu0_us) / received) : 0;
+    resultP->rate_hz = (unsigned int)resultP->framesPerSecond;
+    return received > 0;
+}
+
+static void Calypso_BenchDeinit(void)
+{
+    Calypso_Deinit();
+    CalypsoSimulator_Destroy(calypsoSimP);
+    calypsoSimP = NULL;
+    if(calypsoSinkFd >= 0)
+    {
+        close(calypsoSinkFd);
+    }
+    if(calypsoSourceFd >= 0)
+    {
+        close(calypsoSourceFd);
+    }
+}
@@ -0,0 +1,269 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Sends messages longer than a data packet by ProteusIII_SendMessage over
+ * the simulated module of the Simulator project, whose peer sends each
+ * packet back, and checks the messages reassembled from the DATA_IND.
+ *
+ * Each message starts with its number and is filled with a pattern derived
+ * from it. The peer loses (-p) and reorders (-r) the given percentages of
+ * the packets; a message missing a packet or receiving one out of order has
+ * to be dropped as a whole, never be delivered corrupted or twice. Without
+ * loss and reordering every message has to arrive.
+ *
+ * Usage: Benchmark_Fragmenter [-n messages] [-s size] [-p loss%] [-r reorder%] [-w window]
+ *
+ * Returns 0 if all delivered messages were intact (and all arrived without
+ * loss and reordering), 1 otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "../drivers/ProteusIII/ProteusIII.h"
+#include "../Simulator/ModuleSimulator.h"
+
+#define BENCHMARK_BAUDRATE     115200
+#define BENCHMARK_MESSAGES     200
+#define BENCHMARK_SIZE         2000     /* bytes per message, about 9 packets */
+#define BENCHMARK_LATENCY_US   300      /* processing time of the simulated module */
+#define BENCHMARK_AIRTIME_US   1000     /* time a packet occupies the link */
+#define BENCHMARK_WINDOW       4        /* stream window */
+#define BENCHMARK_MAX_SIZE     65536
+#define BENCHMARK_IDLE_MS      1000     /* time without a message after which the rest counts as lost */
+
+static volatile bool channelOpen = false;
+
+/* written by the callback thread */
+static pthread_mutex_t resultMutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t received = 0;           /* intact messages */
+static uint32_t corrupted = 0;          /* wrong length, content or order */
+static int64_t lastNumber = -1;         /* number of the last message received */
+static uint32_t messageSize = BENCHMARK_SIZE;
+
+static void ChannelOpenCallback(uint8_t *BTMAC, uint16_t max_payload)
+{
+    channelOpen = true;
+}
+
+static double GetTime_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
+
+/* message number in the first 4 bytes, the rest a pattern of the number */
+static void FillMessage(uint8_t *messageP, uint32_t length, uint32_t number)
+{
+    uint32_t i;
+
+    memcpy(messageP, &number, sizeof(number));
+    for(i = sizeof(number); i < length; i++)
+    {
+        messageP[i] = (uint8_t)(number * 31 + i);
+    }
+}
+
+static void MessageCallback(uint8_t *messageP, uint32_t length, void *contextP)
+{
+    uint32_t number, i;
+    bool intact = (length == messageSize);
+
+    if(intact)
+    {
+        memcpy(&number, messageP, sizeof(number));
+        for(i = sizeof(number); intact && (i < length); i++)
+        {
+            intact = (messageP[i] == (uint8_t)(number * 31 + i));
+        }
+    }
+    pthread_mutex_lock(&resultMutex);
+    /* the messages are sent in order, a lost message leaves a gap only */
+    if(intact && ((int64_t)number > lastNumber))
+    {
+        lastNumber = number;
+        received++;
+    }
+    else
+    {
+        corrupted++;
+    }
+    pthread_mutex_unlock(&resultMutex);
+}
+
+static uint32_t GetReceived()
+{
+    pthread_mutex_lock(&resultMutex);
+    uint32_t count = received + corrupted;
+    pthread_mutex_unlock(&resultMutex);
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    ModuleSimulator_Config_t config;
+    ModuleSimulator_t *simP;
+    ProteusIII_CallbackConfig_t callbackConfig;
+    uint8_t *messageP;
+    int messages = BENCHMARK_MESSAGES;
+    int window = BENCHMARK_WINDOW;
+    int opt, i, sent;
+    uint32_t count;
+    double t0, time_us;
+    bool ok;
+
+    ModuleSimulator_GetDefaultConfig(ModuleSimulator_Module_ProteusIII, &config);
+    config.latency_us = BENCHMARK_LATENCY_US;
+    config.airtime_us = BENCHMARK_AIRTIME_US;
+    config.connect = true;
+    config.echo = true;
+
+    while((opt = getopt(argc, argv, "n:s:p:r:w:h")) != -1)
+    {
+        switch(opt)
+        {
+        case 'n':
+            messages = atoi(optarg);
+            break;
+        case 's':
+            messageSize = (uint32_t)atoi(optarg);
+            break;
+        case 'p':
+            config.loss_percent = (unsigned int)atoi(optarg);
+            break;
+        case 'r':
+            config.reorder_percent = (unsigned int)atoi(optarg);
+            break;
+        case 'w':
+            window = atoi(optarg);
+            break;
+        default:
+            fprintf(stdout, "Usage: %s [-n messages] [-s size] [-p loss%%] [-r reorder%%] [-w window]\n", argv[0]);
+            fprintf(stdout, "  -n  messages sent (default %d)\n", BENCHMARK_MESSAGES);
+            fprintf(stdout, "  -s  bytes per message, 4 to %d (default %d)\n", BENCHMARK_MAX_SIZE, BENCHMARK_SIZE);
+            fprintf(stdout, "  -p  percentage of the packets lost on the way back (default 0)\n");
+            fprintf(stdout, "  -r  percentage of the packets overtaken on the way back (default 0)\n");
+            fprintf(stdout, "  -w  stream window, 1 to 255 (default %d)\n", BENCHMARK_WINDOW);
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if((messages <= 0) || (messageSize < sizeof(uint32_t)) || (messageSize > BENCHMARK_MAX_SIZE) ||
+       (window <= 0) || (window > 255) || (config.loss_percent > 100) || (config.reorder_percent > 100))
+    {
+        fprintf(stdout, "Invalid number of messages, size, percentage or window\n");
+        return 1;
+    }
+    messageP = malloc(messageSize);
+    if(messageP == NULL)
+    {
+        return 1;
+    }
+
+    simP = ModuleSimulator_Create(&config);
+    if((simP == NULL) || !ModuleSimulator_Start(simP) || !SetSerialDevice(ModuleSimulator_GetPeerName(simP)))
+    {
+        fprintf(stdout, "Starting the simulator failed\n");
+        free(messageP);
+        return 1;
+    }
+    PtyTransport_SetPinCallback(GetDefaultTransport(), ModuleSimulator_PinCallback, simP);
+
+    memset(&callbackConfig, 0, sizeof(callbackConfig));
+    callbackConfig.channelOpenCb = ChannelOpenCallback;
+    if(!ProteusIII_Init(BENCHMARK_BAUDRATE, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfig) ||
+       !ProteusIII_SetMessageCallback(messageSize, MessageCallback, NULL))
+    {
+        fprintf(stdout, "ProteusIII_Init failed\n");
+        ProteusIII_Deinit();
+        ModuleSimulator_Destroy(simP);
+        free(messageP);
+        return 1;
+    }
+    /* the simulated peer connects after the startup */
+    for(i = 0; !channelOpen && (i < 1000); i++)
+    {
+        usleep(1000);
+    }
+    if(!channelOpen)
+    {
+        fprintf(stdout, "Channel was not opened\n");
+        ProteusIII_Deinit();
+        ModuleSimulator_Destroy(simP);
+        free(messageP);
+        return 1;
+    }
+    ProteusIII_SetStreamWindow((uint8_t)window);
+    ProteusIII_SetPipelineDepth((uint8_t)window);
+
+    fprintf(stdout, "%d messages of %u bytes, stream window %d, %u%% of the packets lost, %u%% reordered\n\n",
+            messages, (unsigned int)messageSize, window, config.loss_percent, config.reorder_percent);
+
+    sent = 0;
+    t0 = GetTime_us();
+    for(i = 0; i < messages; i++)
+    {
+        FillMessage(messageP, messageSize, (uint32_t)i);
+        sent += ProteusIII_SendMessage(messageP, messageSize) ? 1 : 0;
+    }
+    /* wait for the messages sent back, until none arrived for a while */
+    count = GetReceived();
+    for(i = 0; (count < (uint32_t)sent) && (i < BENCHMARK_IDLE_MS); i++)
+    {
+        usleep(1000);
+        if(GetReceived() != count)
+        {
+            count = GetReceived();
+            i = 0;
+        }
+    }
+    time_us = GetTime_us() - t0;
+
+    pthread_mutex_lock(&resultMutex);
+    fprintf(stdout, "%-12s %d/%d\n", "sent", sent, messages);
+    fprintf(stdout, "%-12s %u\n", "received", (unsigned int)received);
+    fprintf(stdout, "%-12s %u\n", "dropped", (unsigned int)(sent - received - corrupted));
+    fprintf(stdout, "%-12s %u\n", "corrupted", (unsigned int)corrupted);
+    fprintf(stdout, "%-12s %.1f\n", "time ms", time_us / 1000.0);
+    fprintf(stdout, "%-12s %.0f\n", "bytes/s", (double)received * messageSize * 1000000.0 / time_us);
+    ok = (corrupted == 0) && (sent == messages) &&
+         (((config.loss_percent > 0) || (config.reorder_percent > 0)) || (received == (uint32_t)sent));
+    pthread_mutex_unlock(&resultMutex);
+
+    ProteusIII_Deinit();
+    ModuleSimulator_Destroy(simP);
+    free(messageP);
+    fprintf(stdout, "\n%s\n", ok ? "PASSED" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,324 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Benchmark of the GPIO cache of a ProteusIII: a dashboard polls the six
+ * local and the six remote pins several times per second, once with every
+ * read requested from the module and once with the cache of
+ * ProteusIII_SetGPIOCacheEx. The connected device writes local pins meanwhile,
+ * the GPIO_LOCAL_WRITE_IND keep the cache up to date and are reported to the
+ * callback of ProteusIII_SetGPIOChangeCallbackEx.
+ *
+ * For each run the requests sent to the module (simulated module only), the
+ * mean and maximum time of a read and the reported pin changes are printed.
+ *
+ * Without -d the module is simulated (see the Simulator project) with the
+ * pin writes of the connected device per second given by -G.
+ *
+ * Usage: Benchmark_GPIOCache [-d device] [-b baudrate] [-G writes] [-t seconds] [-r rate] [-a maxAge_ms]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "../drivers/ProteusIII/ProteusIII.h"
+#include "../Simulator/ModuleSimulator.h"
+
+#define GPIOCACHE_BAUDRATE      115200
+#define GPIOCACHE_WRITES        5           /* simulated pin writes of the connected device per second */
+#define GPIOCACHE_SECONDS       5           /* polling time of each run */
+#define GPIOCACHE_RATE          10          /* polls of all pins per second */
+#define GPIOCACHE_MAX_AGE_MS    500         /* freshness bound of the cache */
+
+typedef struct
+{
+    uint32_t reads;
+    uint32_t failed;
+    double total_us;
+    double max_us;
+} ReadStatistics_t;
+
+typedef struct
+{
+    uint32_t changes[2];                        /* reported changes of the local and remote pins */
+    uint8_t values[2][ProteusIII_AMOUNT_GPIO_PINS];
+} Changes_t;
+
+static bool Poll(ProteusIII_Handle_t *proteusP, ModuleSimulator_t *simP, const char *name, int seconds, int rate, Changes_t *changesP);
+static void Read(ProteusIII_Handle_t *proteusP, bool remote, ReadStatistics_t *statisticsP);
+static void OnGPIOChange(bool remote, ProteusIII_GPIO_t GPIO_ID, uint8_t value, void* contextP);
+static double GetTime_us();
+
+static uint8_t pins[ProteusIII_AMOUNT_GPIO_PINS] = { ProteusIII_GPIO_1, ProteusIII_GPIO_2, ProteusIII_GPIO_3, ProteusIII_GPIO_4, ProteusIII_GPIO_5, ProteusIII_GPIO_6 };
+
+int main(int argc, char *argv[])
+{
+    const char *device = NULL;
+    int baudrate = GPIOCACHE_BAUDRATE;
+    unsigned int writes = GPIOCACHE_WRITES;
+    int seconds = GPIOCACHE_SECONDS;
+    int rate = GPIOCACHE_RATE;
+    int maxAge_ms = GPIOCACHE_MAX_AGE_MS;
+    ModuleSimulator_t *simP = NULL;
+    Transport_t *transportP;
+    ProteusIII_Handle_t *proteusP;
+    ProteusIII_CallbackConfig_t callbackConfig;
+    Changes_t changes;
+    int opt;
+    bool ret = false;
+
+    while((opt = getopt(argc, argv, "d:b:G:t:r:a:h")) != -1)
+    {
+        bool valid = true;
+        switch(opt)
+        {
+        case 'd':
+            device = optarg;
+            break;
+        case 'b':
+            baudrate = atoi(optarg);
+            break;
+        case 'G':
+            writes = (unsigned int)atoi(optarg);
+            break;
+        case 't':
+            seconds = atoi(optarg);
+            break;
+        case 'r':
+            rate = atoi(optarg);
+            break;
+        case 'a':
+            maxAge_ms = atoi(optarg);
+            break;
+        default:
+            valid = false;
+            break;
+        }
+        if(!valid)
+        {
+            fprintf(stdout, "Usage: %s [options]\n", argv[0]);
+            fprintf(stdout, "  -d device   serial interface of the module, simulated if omitted\n");
+            fprintf(stdout, "  -b baudrate baudrate of the module (default %d)\n", GPIOCACHE_BAUDRATE);
+            fprintf(stdout, "  -G writes   simulated pin writes of the connected device per second (default %d)\n", GPIOCACHE_WRITES);
+            fprintf(stdout, "  -t seconds  polling time of each run (default %d)\n", GPIOCACHE_SECONDS);
+            fprintf(stdout, "  -r rate     polls of all pins per second (default %d)\n", GPIOCACHE_RATE);
+            fprintf(stdout, "  -a ms       freshness bound of the cache (default %d)\n", GPIOCACHE_MAX_AGE_MS);
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if((seconds <= 0) || (rate <= 0) || (rate > 1000) || (maxAge_ms <= 0))
+    {
+        fprintf(stdout, "Invalid polling time, rate or freshness bound\n");
+        return 1;
+    }
+
+    if(device != NULL)
+    {
+        transportP = SerialTransport_Create(device);
+    }
+    else
+    {
+        ModuleSimulator_Config_t config;
+        ModuleSimulator_GetDefaultConfig(ModuleSimulator_Module_ProteusIII, &config);
+        config.gpio_rate_hz = writes;
+        simP = ModuleSimulator_Create(&config);
+        if((simP == NULL) || !ModuleSimulator_Start(simP))
+        {
+            fprintf(stdout, "Starting the simulator failed\n");
+            ModuleSimulator_Destroy(simP);
+            return 1;
+        }
+        transportP = PtyTransport_Create(ModuleSimulator_GetPeerName(simP));
+        if(transportP != NULL)
+        {
+            PtyTransport_SetPinCallback(transportP, ModuleSimulator_PinCallback, simP);
+        }
+    }
+    if(transportP == NULL)
+    {
+        fprintf(stdout, "Creating the transport failed\n");
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+
+    memset(&callbackConfig, 0, sizeof(callbackConfig));
+    proteusP = ProteusIII_InitEx(transportP, baudrate, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfig);
+    if(proteusP == NULL)
+    {
+        fprintf(stdout, "ProteusIII_InitEx failed\n");
+        Transport_Destroy(transportP);
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+
+    /* remote pins need a connection, the simulated device connects after the startup */
+    int wait_ms;
+    for(wait_ms = 0; (wait_ms < 10000) && (ProteusIII_GetDriverStateEx(proteusP) != ProteusIII_State_BLE_Channel_Open); wait_ms += 10)
+    {
+        usleep(10000);
+    }
+    if(ProteusIII_GetDriverStateEx(proteusP) != ProteusIII_State_BLE_Channel_Open)
+    {
+        fprintf(stdout, "No connected device\n");
+        ProteusIII_DeinitEx(proteusP);
+        Transport_Destroy(transportP);
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+
+    memset(&changes, 0, sizeof(changes));
+    ProteusIII_SetGPIOChangeCallbackEx(proteusP, OnGPIOChange, &changes);
+
+    if(simP != NULL)
+    {
+        fprintf(stdout, "%u simulated pin writes per second, ", writes);
+    }
+    fprintf(stdout, "%d polls of 6 local and 6 remote pins per second for %d s\n\n", rate, seconds);
+
+    /* every read requested from the module */
+    ret = Poll(proteusP, simP, "no cache", seconds, rate, &changes);
+
+    /* reads served by the cache while its values are younger than maxAge_ms */
+    ProteusIII_SetGPIOCacheEx(proteusP, (uint32_t)maxAge_ms);
+    char name[32];
+    snprintf(name, sizeof(name), "cache %d ms", maxAge_ms);
+    ret = Poll(proteusP, simP, name, seconds, rate, &changes) && ret;
+
+    /* the values reported last are the values of the pins, unless a write is in flight */
+    ProteusIII_SetGPIOChangeCallbackEx(proteusP, NULL, NULL);
+    ProteusIII_SetGPIOCacheEx(proteusP, 0);
+    ProteusIII_GPIOControlBlock_t control[ProteusIII_AMOUNT_GPIO_PINS];
+    uint16_t controlLength = 0;
+    uint32_t matching = 0, i;
+    if(ProteusIII_GPIOLocalReadEx(proteusP, pins, sizeof(pins), control, &controlLength))
+    {
+        for(i = 0; i < controlLength / sizeof(ProteusIII_GPIOControlBlock_t); i++)
+        {
+            matching += (control[i].value == changes.values[0][control[i].GPIO_ID - 1]) ? 1 : 0;
+        }
+    }
+    fprintf(stdout, "\n%u of %d local pins as reported by the change callback\n", matching, ProteusIII_AMOUNT_GPIO_PINS);
+
+    ProteusIII_DeinitEx(proteusP);
+    Transport_Destroy(transportP);
+    ModuleSimulator_Destroy(simP);
+    return ret ? 0 : 1;
+}
+
+/* function to poll all local and remote pins 'rate' times per second */
+static bool Poll(ProteusIII_Handle_t *proteusP, ModuleSimulator_t *simP, const char *name, int seconds, int rate, Changes_t *changesP)
+{
+    ReadStatistics_t statistics;
+    ModuleSimulator_Statistics_t before, after;
+    uint32_t changes = changesP->changes[0] + changesP->changes[1];
+    double start_us, next_us;
+
+    memset(&statistics, 0, sizeof(statistics));
+    memset(&before, 0, sizeof(before));
+    memset(&after, 0, sizeof(after));
+    if(simP != NULL)
+    {
+        ModuleSimulator_GetStatistics(simP, &before);
+    }
+
+    start_us = GetTime_us();
+    next_us = start_us;
+    while(next_us - start_us < seconds * 1000000.0)
+    {
+        Read(proteusP, false, &statistics);
+        Read(proteusP, true, &statistics);
+
+        next_us += 1000000.0 / rate;
+        double now_us = GetTime_us();
+        if(next_us > now_us)
+        {
+            usleep((useconds_t)(next_us - now_us));
+        }
+    }
+
+    fprintf(stdout, "%-14s %6u reads (%u failed), %7.1f us mean, %8.1f us max, %4u changes reported",
+            name, statistics.reads, statistics.failed, statistics.total_us / statistics.reads, statistics.max_us,
+            changesP->changes[0] + changesP->changes[1] - changes);
+    if(simP != NULL)
+    {
+        ModuleSimulator_GetStatistics(simP, &after);
+        fprintf(stdout, ", %6llu requests, %4llu indications", (unsigned long long)(after.requests - before.requests),
+                (unsigned long long)(after.indications - before.indications));
+    }
+    fprintf(stdout, "\n");
+    return (statistics.failed == 0);
+}
+
+/* function to read all local or remote pins like a dashboard does */
+static void Read(ProteusIII_Handle_t *proteusP, bool remote, ReadStatistics_t *statisticsP)
+{
+    ProteusIII_GPIOControlBlock_t control[ProteusIII_AMOUNT_GPIO_PINS];
+    uint16_t controlLength = 0;
+    bool ok;
+
+    double start_us = GetTime_us();
+    if(remote)
+    {
+        ok = ProteusIII_GPIORemoteReadEx(proteusP, pins, sizeof(pins), control, &controlLength);
+    }
+    else
+    {
+        ok = ProteusIII_GPIOLocalReadEx(proteusP, pins, sizeof(pins), control, &controlLength);
+    }
+    double elapsed_us = GetTime_us() - start_us;
+
+    statisticsP->reads++;
+    statisticsP->total_us += elapsed_us;
+    if(elapsed_us > statisticsP->max_us)
+    {
+        statisticsP->max_us = elapsed_us;
+    }
+    if(!ok || (controlLength != sizeof(control)))
+    {
+        statisticsP->failed++;
+    }
+}
+
+static void OnGPIOChange(bool remote, ProteusIII_GPIO_t GPIO_ID, uint8_t value, void* contextP)
+{
+    Changes_t *changesP = contextP;
+
+    changesP->changes[remote ? 1 : 0]++;
+    changesP->values[remote ? 1 : 0][GPIO_ID - 1] = value;
+}
+
+static double GetTime_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
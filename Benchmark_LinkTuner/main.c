@@ -0,0 +1,571 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Auto-tuner for the BLE link of a ProteusIII: cycles through candidate
+ * connection timings, PHYs and TX powers on a live connection, measures the
+ * goodput and the latency of each combination, prints them as table and
+ * keeps the best profile.
+ *
+ * Connection timing and TX power are user settings, which take effect with
+ * the next startup: for each combination of them the settings that differ
+ * from the ones of the module are written (the timing once per timing, the
+ * TX power once per combination except when the timing changes, nothing for
+ * settings already in place),
+ * the module is reset and the connection is set up again, either by the peer
+ * (the module is peripheral, default) or by connecting to the peer given by
+ * -c. The PHY is updated on the live connection.
+ *
+ * - goodput: payloads of the maximum length reported when the channel was
+ *   opened are streamed (ProteusIII_StreamTransmitEx) for the measurement
+ *   time, they count once the stream was flushed
+ * - latency: time from the data request of a short payload to its
+ *   TXCOMPLETE_RSP, i.e. until the peer acknowledged it on the link
+ *
+ * The best profile (highest goodput, or lowest latency with -o latency) is
+ * written to the module. The PHY is no user setting: it is updated on the
+ * connection, the application has to request it after each connect.
+ *
+ * Without -d the module is simulated (see the Simulator project) with its
+ * link model, whose path loss is set by -L.
+ *
+ * Usage: Benchmark_LinkTuner [-d device] [-b baudrate] [-c btmac] [-L path_loss_db] [-T timings]
+ *                            [-H phys] [-P powers] [-t ms] [-n samples] [-w window] [-o goal]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "../drivers/ProteusIII/ProteusIII.h"
+#include "../Simulator/ModuleSimulator.h"
+
+#define LINKTUNER_BAUDRATE      115200
+#define LINKTUNER_MEASURE_MS    1000        /* goodput measurement per candidate */
+#define LINKTUNER_SAMPLES       20          /* latency measurements per candidate */
+#define LINKTUNER_WINDOW        4           /* stream window of the goodput measurement */
+#define LINKTUNER_PATH_LOSS_DB  90          /* simulated attenuation between module and peer */
+#define LINKTUNER_CONNECT_MS    10000       /* time for the connection to be set up */
+#define LINKTUNER_PHY_MS        2000        /* time for the PHY update */
+#define LINKTUNER_MAX_PAYLOAD   963         /* longest payload of a data request */
+#define LINKTUNER_PING_LENGTH   20          /* payload of the latency measurement */
+#define LINKTUNER_MAX_LIST      16
+#define LINKTUNER_MAX_SAMPLES   1000
+
+typedef enum LinkTuner_Goal_t
+{
+    LinkTuner_Goal_Goodput,
+    LinkTuner_Goal_Latency,
+} LinkTuner_Goal_t;
+
+typedef struct LinkTuner_Result_t
+{
+    ProteusIII_ConnectionTiming_t timing;
+    ProteusIII_Phy_t phy;
+    ProteusIII_TXPower_t power;
+    bool ok;
+    double goodput;                         /* bytes/s */
+    double latency_p50_us;
+    double latency_max_us;
+} LinkTuner_Result_t;
+
+static bool ParseList(const char *textP, int *listP, int *countP);
+static bool ParseBTMAC(const char *textP, uint8_t *btmacP);
+static bool Reconnect(void);
+static bool ApplySettings(ProteusIII_ConnectionTiming_t timing, ProteusIII_TXPower_t power);
+static bool ApplyPhy(ProteusIII_Phy_t phy);
+static void Measure(LinkTuner_Result_t *resultP);
+static bool IsBetter(const LinkTuner_Result_t *aP, const LinkTuner_Result_t *bP);
+static const char *PhyName(ProteusIII_Phy_t phy);
+static double GetTime_us();
+static int CompareDouble(const void *a, const void *b);
+
+static ProteusIII_Handle_t *proteusP = NULL;
+static bool central = false;
+static uint8_t peerBTMAC[6];
+static int measure_ms = LINKTUNER_MEASURE_MS;
+static int samples = LINKTUNER_SAMPLES;
+static int window = LINKTUNER_WINDOW;
+static LinkTuner_Goal_t goal = LinkTuner_Goal_Goodput;
+
+static volatile bool channelOpen = false;
+static volatile bool phyUpdated = false;
+static volatile uint16_t maxPayload = 0;
+
+static void LinkTuner_ChannelOpen(uint8_t *BTMAC, uint16_t max_payload)
+{
+    maxPayload = (max_payload < LINKTUNER_MAX_PAYLOAD) ? max_payload : LINKTUNER_MAX_PAYLOAD;
+    channelOpen = true;
+}
+
+static void LinkTuner_Disconnect()
+{
+    channelOpen = false;
+}
+
+static void LinkTuner_PhyUpdate(uint8_t *BTMAC, uint8_t phy_rx, uint8_t phy_tx)
+{
+    phyUpdated = true;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *device = NULL;
+    int baudrate = LINKTUNER_BAUDRATE;
+    unsigned int pathLoss_db = LINKTUNER_PATH_LOSS_DB;
+    int timings[LINKTUNER_MAX_LIST] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+    int phys[LINKTUNER_MAX_LIST] = { ProteusIII_Phy_1MBit, ProteusIII_Phy_2MBit, ProteusIII_Phy_125kBit_LECoded };
+    int powers[LINKTUNER_MAX_LIST] = { 8, 4, 0, -8 };
+    int timingCount = 9, phyCount = 3, powerCount = 4;
+    LinkTuner_Result_t best;
+    ModuleSimulator_t *simP = NULL;
+    Transport_t *transportP;
+    ProteusIII_CallbackConfig_t callbackConfig;
+    int opt, t, h, p;
+    bool ret = false;
+
+    while((opt = getopt(argc, argv, "d:b:c:L:T:H:P:t:n:w:o:h")) != -1)
+    {
+        bool valid = true;
+        switch(opt)
+        {
+        case 'd':
+            device = optarg;
+            break;
+        case 'b':
+            baudrate = atoi(optarg);
+            break;
+        case 'c':
+            central = true;
+            valid = ParseBTMAC(optarg, peerBTMAC);
+            break;
+        case 'L':
+            pathLoss_db = (unsigned int)atoi(optarg);
+            break;
+        case 'T':
+            valid = ParseList(optarg, timings, &timingCount);
+            break;
+        case 'H':
+            valid = ParseList(optarg, phys, &phyCount);
+            break;
+        case 'P':
+            valid = ParseList(optarg, powers, &powerCount);
+            break;
+        case 't':
+            measure_ms = atoi(optarg);
+            break;
+        case 'n':
+            samples = atoi(optarg);
+            break;
+        case 'w':
+            window = atoi(optarg);
+            break;
+        case 'o':
+            if(strcasecmp(optarg, "latency") == 0)
+            {
+                goal = LinkTuner_Goal_Latency;
+            }
+            else
+            {
+                valid = (strcasecmp(optarg, "goodput") == 0);
+            }
+            break;
+        default:
+            valid = false;
+            break;
+        }
+        if(!valid)
+        {
+            fprintf(stdout, "Usage: %s [options]\n", argv[0]);
+            fprintf(stdout, "  -d device   serial interface of the module, simulated if omitted\n");
+            fprintf(stdout, "  -b baudrate baudrate of the module (default %d)\n", LINKTUNER_BAUDRATE);
+            fprintf(stdout, "  -c btmac    connect to this peer (12 hex digits as reported by the scan),\n");
+            fprintf(stdout, "              otherwise wait for the peer to connect\n");
+            fprintf(stdout, "  -L dB       path loss of the simulated link (default %d)\n", LINKTUNER_PATH_LOSS_DB);
+            fprintf(stdout, "  -T list     connection timings, e.g. 0,1,2 (default 0 to 8)\n");
+            fprintf(stdout, "  -H list     PHYs: 1 (1MBit), 2 (2MBit), 4 (LE coded) (default 1,2,4)\n");
+            fprintf(stdout, "  -P list     TX powers in dBm (default 8,4,0,-8)\n");
+            fprintf(stdout, "  -t ms       goodput measurement per candidate (default %d)\n", LINKTUNER_MEASURE_MS);
+            fprintf(stdout, "  -n samples  latency measurements per candidate, 1 to %d (default %d)\n", LINKTUNER_MAX_SAMPLES, LINKTUNER_SAMPLES);
+            fprintf(stdout, "  -w window   stream window of the goodput measurement (default %d)\n", LINKTUNER_WINDOW);
+            fprintf(stdout, "  -o goal     goodput or latency (default goodput)\n");
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if((measure_ms <= 0) || (samples <= 0) || (samples > LINKTUNER_MAX_SAMPLES) || (window <= 0) || (window > 255))
+    {
+        fprintf(stdout, "Invalid measurement time, samples or window\n");
+        return 1;
+    }
+
+    if(device != NULL)
+    {
+        transportP = SerialTransport_Create(device);
+    }
+    else
+    {
+        ModuleSimulator_Config_t config;
+        ModuleSimulator_GetDefaultConfig(ModuleSimulator_Module_ProteusIII, &config);
+        config.link_model = true;
+        config.path_loss_db = pathLoss_db;
+        config.connect = !central;
+        simP = ModuleSimulator_Create(&config);
+        if((simP == NULL) || !ModuleSimulator_Start(simP))
+        {
+            fprintf(stdout, "Starting the simulator failed\n");
+            ModuleSimulator_Destroy(simP);
+            return 1;
+        }
+        transportP = PtyTransport_Create(ModuleSimulator_GetPeerName(simP));
+        if(transportP != NULL)
+        {
+            PtyTransport_SetPinCallback(transportP, ModuleSimulator_PinCallback, simP);
+        }
+    }
+    if(transportP == NULL)
+    {
+        fprintf(stdout, "Creating the transport failed\n");
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+
+    memset(&callbackConfig, 0, sizeof(callbackConfig));
+    callbackConfig.channelOpenCb = LinkTuner_ChannelOpen;
+    callbackConfig.disconnectCb = LinkTuner_Disconnect;
+    callbackConfig.phyUpdateCb = LinkTuner_PhyUpdate;
+    proteusP = ProteusIII_InitEx(transportP, baudrate, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfig);
+    if(proteusP == NULL)
+    {
+        fprintf(stdout, "ProteusIII_InitEx failed\n");
+        Transport_Destroy(transportP);
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+    ProteusIII_SetStreamWindowEx(proteusP, (uint8_t)window);
+
+    if(simP != NULL)
+    {
+        fprintf(stdout, "simulated link, path loss %u dB\n", pathLoss_db);
+    }
+    fprintf(stdout, "%d candidates, goodput for %d ms, latency of %d packets, optimizing %s\n\n",
+            timingCount * phyCount * powerCount, measure_ms, samples, (goal == LinkTuner_Goal_Goodput) ? "goodput" : "latency");
+    fprintf(stdout, "%6s %-6s %6s %12s %12s %12s  %s\n", "timing", "PHY", "dBm", "goodput B/s", "p50 ms", "max ms", "status");
+
+    memset(&best, 0, sizeof(best));
+    for(t = 0; t < timingCount; t++)
+    {
+        for(p = 0; p < powerCount; p++)
+        {
+            /* every other timing runs through the powers backwards, so the power stays when the timing changes */
+            const int power = powers[(t % 2 == 0) ? p : powerCount - 1 - p];
+            bool applied = ApplySettings((ProteusIII_ConnectionTiming_t)timings[t], (ProteusIII_TXPower_t)power);
+
+            for(h = 0; h < phyCount; h++)
+            {
+                LinkTuner_Result_t result;
+                const char *status = "ok";
+
+                memset(&result, 0, sizeof(result));
+                result.timing = (ProteusIII_ConnectionTiming_t)timings[t];
+                result.power = (ProteusIII_TXPower_t)power;
+                result.phy = (ProteusIII_Phy_t)phys[h];
+                if(!applied)
+                {
+                    status = "settings rejected or no connection";
+                }
+                else if(!ApplyPhy(result.phy))
+                {
+                    status = "PHY rejected";
+                }
+                else
+                {
+                    Measure(&result);
+                    status = result.ok ? "ok" : "packets lost";
+                }
+                fprintf(stdout, "%6d %-6s %6d %12.0f %12.2f %12.2f  %s\n", result.timing, PhyName(result.phy), result.power,
+                        result.goodput, result.latency_p50_us / 1000.0, result.latency_max_us / 1000.0, status);
+                fflush(stdout);
+
+                if(result.ok && (!best.ok || IsBetter(&result, &best)))
+                {
+                    best = result;
+                }
+            }
+        }
+    }
+
+    if(best.ok)
+    {
+        fprintf(stdout, "\nbest profile: connection timing %d, PHY %s, TX power %d dBm, %.0f B/s, latency %.2f ms\n",
+                best.timing, PhyName(best.phy), best.power, best.goodput, best.latency_p50_us / 1000.0);
+        /* the user settings are kept in the flash of the module, nothing is written if the
+         * best profile was the last one measured */
+        ret = ApplySettings(best.timing, best.power) && ApplyPhy(best.phy);
+        fprintf(stdout, ret ? "connection timing and TX power written to the module, request the PHY after each connect\n"
+                            : "writing the best profile failed\n");
+    }
+    else
+    {
+        fprintf(stdout, "\nno candidate could be measured\n");
+    }
+
+    ProteusIII_DeinitEx(proteusP);
+    Transport_Destroy(transportP);
+    ModuleSimulator_Destroy(simP);
+    return ret ? 0 : 1;
+}
+
+/* parse a comma separated list of numbers */
+static bool ParseList(const char *textP, int *listP, int *countP)
+{
+    int count = 0;
+    char *endP;
+
+    while(*textP != '\0')
+    {
+        if(count == LINKTUNER_MAX_LIST)
+        {
+            return false;
+        }
+        listP[count++] = (int)strtol(textP, &endP, 0);
+        if(endP == textP)
+        {
+            return false;
+        }
+        textP = (*endP == ',') ? endP + 1 : endP;
+        if((*endP != ',') && (*endP != '\0'))
+        {
+            return false;
+        }
+    }
+    *countP = count;
+    return count > 0;
+}
+
+/* parse 12 hex digits, the first pair being BTMAC[0] */
+static bool ParseBTMAC(const char *textP, uint8_t *btmacP)
+{
+    int i;
+
+    if((strncasecmp(textP, "0x", 2) == 0))
+    {
+        textP += 2;
+    }
+    if(strlen(textP) != 12)
+    {
+        return false;
+    }
+    for(i = 0; i < 6; i++)
+    {
+        char byte[3] = { textP[2 * i], textP[2 * i + 1], '\0' };
+        char *endP;
+        btmacP[i] = (uint8_t)strtoul(byte, &endP, 16);
+        if(*endP != '\0')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* wait until the channel is open again, connecting to the peer in the central role */
+static bool Reconnect(void)
+{
+    int timeout_ms = LINKTUNER_CONNECT_MS;
+
+    if(central && !ProteusIII_ConnectEx(proteusP, peerBTMAC))
+    {
+        return false;
+    }
+    while(!channelOpen && (timeout_ms-- > 0))
+    {
+        usleep(1000);
+    }
+    return channelOpen;
+}
+
+/* write the user settings that differ from the ones of the module and restart it, so that they
+ * take effect; settings already in place are not written again, to spare the flash */
+static bool ApplySettings(ProteusIII_ConnectionTiming_t timing, ProteusIII_TXPower_t power)
+{
+    ProteusIII_ConnectionTiming_t currentTiming;
+    ProteusIII_TXPower_t currentPower;
+    bool changed = false;
+
+    if(!ProteusIII_GetConnectionTimingEx(proteusP, &currentTiming) || !ProteusIII_GetTXPowerEx(proteusP, &currentPower))
+    {
+        return false;
+    }
+    if(currentTiming != timing)
+    {
+        if(!ProteusIII_SetConnectionTimingEx(proteusP, timing))
+        {
+            return false;
+        }
+        changed = true;
+    }
+    if(currentPower != power)
+    {
+        if(!ProteusIII_SetTXPowerEx(proteusP, power))
+        {
+            return false;
+        }
+        changed = true;
+    }
+    if(!changed)
+    {
+        /* in place since the last startup */
+        return channelOpen || Reconnect();
+    }
+    channelOpen = false;
+    return ProteusIII_ResetEx(proteusP) && Reconnect();
+}
+
+/* update the PHY of the connection and wait until the update was done */
+static bool ApplyPhy(ProteusIII_Phy_t phy)
+{
+    int timeout_ms = LINKTUNER_PHY_MS;
+
+    phyUpdated = false;
+    if(!ProteusIII_PhyUpdateEx(proteusP, phy))
+    {
+        return false;
+    }
+    while(!phyUpdated && (timeout_ms-- > 0))
+    {
+        usleep(1000);
+    }
+    return phyUpdated;
+}
+
+static void Measure(LinkTuner_Result_t *resultP)
+{
+    uint8_t payload[LINKTUNER_MAX_PAYLOAD];
+    double latency_us[LINKTUNER_MAX_SAMPLES];
+    uint64_t bytes = 0;
+    double t0, elapsed_us;
+    int i;
+
+    for(i = 0; i < LINKTUNER_MAX_PAYLOAD; i++)
+    {
+        payload[i] = (uint8_t)i;
+    }
+
+    /* goodput: stream for the measurement time, the packets count once all were transmitted */
+    t0 = GetTime_us();
+    do
+    {
+        if(!ProteusIII_StreamTransmitEx(proteusP, payload, maxPayload))
+        {
+            break;
+        }
+        bytes += maxPayload;
+    }
+    while(GetTime_us() - t0 < measure_ms * 1000.0);
+    resultP->ok = ProteusIII_StreamFlushEx(proteusP) && channelOpen;
+    elapsed_us = GetTime_us() - t0;
+    resultP->goodput = resultP->ok ? (double)bytes * 1000000.0 / elapsed_us : 0;
+    if(!resultP->ok)
+    {
+        return;
+    }
+
+    /* latency: one packet at a time */
+    for(i = 0; i < samples; i++)
+    {
+        t0 = GetTime_us();
+        if(!ProteusIII_TransmitEx(proteusP, payload, LINKTUNER_PING_LENGTH))
+        {
+            resultP->ok = false;
+            return;
+        }
+        latency_us[i] = GetTime_us() - t0;
+    }
+    qsort(latency_us, samples, sizeof(double), CompareDouble);
+    resultP->latency_p50_us = latency_us[samples / 2];
+    resultP->latency_max_us = latency_us[samples - 1];
+}
+
+/* whether a is better than b for the goal: goodput within 2 % counts as equal, then the latency and
+ * the lower TX power decide */
+static bool IsBetter(const LinkTuner_Result_t *aP, const LinkTuner_Result_t *bP)
+{
+    if(goal == LinkTuner_Goal_Goodput)
+    {
+        if(aP->goodput > bP->goodput * 1.02)
+        {
+            return true;
+        }
+        if(aP->goodput < bP->goodput * 0.98)
+        {
+            return false;
+        }
+    }
+    if(aP->latency_p50_us < bP->latency_p50_us * 0.98)
+    {
+        return true;
+    }
+    if(aP->latency_p50_us > bP->latency_p50_us * 1.02)
+    {
+        return false;
+    }
+    return aP->power < bP->power;
+}
+
+static const char *PhyName(ProteusIII_Phy_t phy)
+{
+    switch(phy)
+    {
+    case ProteusIII_Phy_1MBit:
+        return "1M";
+    case ProteusIII_Phy_2MBit:
+        return "2M";
+    case ProteusIII_Phy_125kBit_LECoded:
+        return "coded";
+    default:
+        return "?";
+    }
+}
+
+static double GetTime_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
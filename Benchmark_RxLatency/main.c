@@ -0,0 +1,289 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2019 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Compares the RX latency and the idle cpu load of the driver rx_thread loop
+ * polling every 1 ms (delay + ReadBytes) with the event driven loop sleeping
+ * in WaitForRxData until bytes arrive or the thread is signalled.
+ *
+ * A pseudo terminal is used as loopback: the benchmark writes frames into the
+ * master side and the serial interface reads from the slave side, so no
+ * module is required.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+
+#define BENCHMARK_BAUDRATE     921600
+#define BENCHMARK_FRAMES       500      /* frames per latency run */
+#define BENCHMARK_FRAME_LENGTH 8        /* size of a short CNF frame */
+#define BENCHMARK_IDLE_MS      2000     /* duration of the idle run */
+
+typedef enum Benchmark_Mode_t
+{
+    Benchmark_Mode_Polling = 0,
+    Benchmark_Mode_Event,
+}Benchmark_Mode_t;
+
+typedef struct Benchmark_Result_t
+{
+    const char *name;
+    uint32_t frames;              /* frames received */
+    double p50_us;                /* median latency write -> frame complete */
+    double p99_us;
+    double max_us;
+    uint64_t idleWakeups;         /* loop iterations without traffic */
+    double idleCpu_ms;            /* cpu time of the reading thread without traffic */
+} Benchmark_Result_t;
+
+static void *writer_thread(void *pArgs);
+static void *idle_timer_thread(void *pArgs);
+static bool WaitLoop(Benchmark_Mode_t mode, uint64_t *wakeupsP);
+static bool RunLatency(Benchmark_Mode_t mode, Benchmark_Result_t *resultP);
+static bool RunIdle(Benchmark_Mode_t mode, Benchmark_Result_t *resultP);
+static int CompareDouble(const void *a, const void *b);
+static double GetTime_us(clockid_t clock);
+static void PrintResult(Benchmark_Result_t *resultP);
+
+static int master_fd = -1;
+static int rxThreadEvent = -1;
+static volatile bool abortPolling = false;
+static double sendTime_us[BENCHMARK_FRAMES];
+static double latency_us[BENCHMARK_FRAMES];
+
+int main ()
+{
+    Benchmark_Result_t polling, event;
+    char *slave_name;
+
+    /* create the pty loopback */
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if((master_fd < 0) || (grantpt(master_fd) != 0) || (unlockpt(master_fd) != 0) || ((slave_name = ptsname(master_fd)) == NULL))
+    {
+        fprintf(stdout, "Creating the pseudo terminal failed: %s\n", strerror(errno));
+        return 1;
+    }
+
+    if((false == SetSerialDevice(slave_name)) || (false == OpenSerial(BENCHMARK_BAUDRATE)))
+    {
+        fprintf(stdout, "Opening %s failed\n", slave_name);
+        return 1;
+    }
+
+    rxThreadEvent = RxThreadEvent_Create();
+    if(rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Creating the rx thread event failed\n");
+        CloseSerial();
+        return 1;
+    }
+    fprintf(stdout, "pty loopback on %s, %u frames of %u bytes, %u ms idle\n\n", slave_name, BENCHMARK_FRAMES, BENCHMARK_FRAME_LENGTH, BENCHMARK_IDLE_MS);
+
+    memset(&polling, 0, sizeof(polling));
+    memset(&event, 0, sizeof(event));
+    polling.name = "delay(1) polling";
+    event.name = "WaitForRxData";
+    if(!RunLatency(Benchmark_Mode_Polling, &polling) || !RunIdle(Benchmark_Mode_Polling, &polling) ||
+       !RunLatency(Benchmark_Mode_Event, &event) || !RunIdle(Benchmark_Mode_Event, &event))
+    {
+        RxThreadEvent_Destroy(rxThreadEvent);
+        CloseSerial();
+        return 1;
+    }
+
+    fprintf(stdout, "%-18s %8s %10s %10s %10s %14s %14s\n", "rx loop", "frames", "p50 us", "p99 us", "max us", "idle wakeups", "idle cpu ms");
+    PrintResult(&polling);
+    PrintResult(&event);
+
+    RxThreadEvent_Destroy(rxThreadEvent);
+    CloseSerial();
+    close(master_fd);
+    return 0;
+}
+
+/* write the frames with irregular gaps, so they do not line up with the 1 ms polling period */
+static void *writer_thread(void *pArgs)
+{
+    uint8_t frame[BENCHMARK_FRAME_LENGTH];
+    uint32_t i;
+
+    for(i = 0; i < BENCHMARK_FRAMES; i++)
+    {
+        struct timespec gap;
+        gap.tv_sec = 0;
+        gap.tv_nsec = 1000000L + (long)((i * 7919) % 1000) * 1000L;
+        nanosleep(&gap, NULL);
+
+        memset(frame, (uint8_t)i, sizeof(frame));
+        sendTime_us[i] = GetTime_us(CLOCK_MONOTONIC);
+        if(write(master_fd, frame, sizeof(frame)) != sizeof(frame))
+        {
+            break;
+        }
+    }
+    return 0;
+}
+
+/* end the idle run after BENCHMARK_IDLE_MS, the same way a driver Deinit ends its rx_thread */
+static void *idle_timer_thread(void *pArgs)
+{
+    delay(BENCHMARK_IDLE_MS);
+    abortPolling = true;
+    RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_ABORT);
+    return 0;
+}
+
+/*
+ * One iteration of the rx_thread loop head
+ *
+ * return: false, if the loop was aborted
+ */
+static bool WaitLoop(Benchmark_Mode_t mode, uint64_t *wakeupsP)
+{
+    (*wakeupsP)++;
+    if(mode == Benchmark_Mode_Polling)
+    {
+        /* rx_thread before WaitForRxData */
+        delay(1);
+        return !abortPolling;
+    }
+
+    if(WaitForRxData(rxThreadEvent, -1) == Serial_RxWait_Event)
+    {
+        return (0 == (RxThreadEvent_Read(rxThreadEvent) & RXTHREAD_EVENT_ABORT));
+    }
+    return true;
+}
+
+static bool RunLatency(Benchmark_Mode_t mode, Benchmark_Result_t *resultP)
+{
+    pthread_t thread_write;
+    uint8_t rxChunk[SERIAL_RX_CHUNK_SIZE];
+    size_t rxChunkLength = 0;
+    uint32_t bytes = 0;
+    uint64_t wakeups = 0;
+
+    FlushSerial();
+    if(pthread_create(&thread_write, NULL, &writer_thread, NULL))
+    {
+        fprintf(stdout, "Failed to start writer thread\n");
+        return false;
+    }
+
+    while((resultP->frames < BENCHMARK_FRAMES) && WaitLoop(mode, &wakeups))
+    {
+        while(ReadBytes(rxChunk, sizeof(rxChunk), &rxChunkLength, 0) && (rxChunkLength > 0))
+        {
+            double now_us = GetTime_us(CLOCK_MONOTONIC);
+
+            bytes += rxChunkLength;
+            while((resultP->frames < BENCHMARK_FRAMES) && (bytes >= (resultP->frames + 1) * BENCHMARK_FRAME_LENGTH))
+            {
+                latency_us[resultP->frames] = now_us - sendTime_us[resultP->frames];
+                resultP->frames++;
+            }
+        }
+    }
+    pthread_join(thread_write, NULL);
+
+    qsort(latency_us, resultP->frames, sizeof(double), CompareDouble);
+    if(resultP->frames > 0)
+    {
+        resultP->p50_us = latency_us[resultP->frames / 2];
+        resultP->p99_us = latency_us[(resultP->frames * 99) / 100];
+        resultP->max_us = latency_us[resultP->frames - 1];
+    }
+    return true;
+}
+
+static bool RunIdle(Benchmark_Mode_t mode, Benchmark_Result_t *resultP)
+{
+    pthread_t thread_timer;
+    uint8_t rxChunk[SERIAL_RX_CHUNK_SIZE];
+    size_t rxChunkLength = 0;
+    double cpu_start;
+
+    abortPolling = false;
+    FlushSerial();
+    if(pthread_create(&thread_timer, NULL, &idle_timer_thread, NULL))
+    {
+        fprintf(stdout, "Failed to start timer thread\n");
+        return false;
+    }
+
+    cpu_start = GetTime_us(CLOCK_THREAD_CPUTIME_ID);
+    while(WaitLoop(mode, &resultP->idleWakeups))
+    {
+        while(ReadBytes(rxChunk, sizeof(rxChunk), &rxChunkLength, 0) && (rxChunkLength > 0))
+        {
+        }
+    }
+    resultP->idleCpu_ms = (GetTime_us(CLOCK_THREAD_CPUTIME_ID) - cpu_start) / 1000.0;
+
+    pthread_join(thread_timer, NULL);
+    if(mode == Benchmark_Mode_Polling)
+    {
+        /* the polling loop does not consume the abort event */
+        RxThreadEvent_Read(rxThreadEvent);
+    }
+    return true;
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double GetTime_us(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
+
+static void PrintResult(Benchmark_Result_t *resultP)
+{
+    fprintf(stdout, "%-18s %8u %10.1f %10.1f %10.1f %14llu %14.1f\n",
+            resultP->name,
+            resultP->frames,
+            resultP->p50_us,
+            resultP->p99_us,
+            resultP->max_us,
+            (unsigned long long)resultP->idleWakeups,
+            resultP->idleCpu_ms);
+}
@@ -0,0 +1,281 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Benchmark of the continuous scan of a ProteusIII: compares the devices an
+ * application knows when it polls the 10 entry snapshots of
+ * ProteusIII_GetDevicesEx with the devices collected by the scan index of
+ * ProteusIII_ScanStreamStartEx, and measures the queries of the index.
+ *
+ * - snapshots: Scanstart, then ProteusIII_GetDevicesEx every interval for
+ *   the scan time, the devices of the last snapshot are counted
+ * - scan stream: the same scan time with the scan index, the number of
+ *   indexed devices is printed every second
+ * - queries: lookup of every indexed device by BTMAC, the strongest devices
+ *   by mean RSSI and the age-out, timed on the filled index
+ *
+ * Without -d the module is simulated (see the Simulator project) with the
+ * number of advertising devices given by -D.
+ *
+ * Usage: Benchmark_ScanIndex [-d device] [-b baudrate] [-D devices] [-t seconds] [-i interval_ms] [-n top]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "../drivers/ProteusIII/ProteusIII.h"
+#include "../Simulator/ModuleSimulator.h"
+
+#define SCANINDEX_BAUDRATE      115200
+#define SCANINDEX_DEVICES       2000        /* simulated advertising devices */
+#define SCANINDEX_SECONDS       10          /* scan time of each method */
+#define SCANINDEX_INTERVAL_MS   20          /* time between two requests of the scan results */
+#define SCANINDEX_TOP           10          /* strongest devices printed */
+#define SCANINDEX_MAX_TOP       1000
+
+static void PrintDevice(const ProteusIII_ScanDevice_t *deviceP);
+static double GetTime_us();
+
+int main(int argc, char *argv[])
+{
+    const char *device = NULL;
+    int baudrate = SCANINDEX_BAUDRATE;
+    unsigned int devices = SCANINDEX_DEVICES;
+    int seconds = SCANINDEX_SECONDS;
+    int interval_ms = SCANINDEX_INTERVAL_MS;
+    int top = SCANINDEX_TOP;
+    ModuleSimulator_t *simP = NULL;
+    Transport_t *transportP;
+    ProteusIII_Handle_t *proteusP;
+    ProteusIII_CallbackConfig_t callbackConfig;
+    ProteusIII_GetDevices_t snapshot;
+    ProteusIII_ScanDevice_t *indexedP = NULL;
+    uint32_t indexed = 0, polls = 0, failed = 0, found, i;
+    double start_us, elapsed_us;
+    int opt, s;
+    bool ret = false;
+
+    while((opt = getopt(argc, argv, "d:b:D:t:i:n:h")) != -1)
+    {
+        bool valid = true;
+        switch(opt)
+        {
+        case 'd':
+            device = optarg;
+            break;
+        case 'b':
+            baudrate = atoi(optarg);
+            break;
+        case 'D':
+            devices = (unsigned int)atoi(optarg);
+            break;
+        case 't':
+            seconds = atoi(optarg);
+            break;
+        case 'i':
+            interval_ms = atoi(optarg);
+            break;
+        case 'n':
+            top = atoi(optarg);
+            break;
+        default:
+            valid = false;
+            break;
+        }
+        if(!valid)
+        {
+            fprintf(stdout, "Usage: %s [options]\n", argv[0]);
+            fprintf(stdout, "  -d device   serial interface of the module, simulated if omitted\n");
+            fprintf(stdout, "  -b baudrate baudrate of the module (default %d)\n", SCANINDEX_BAUDRATE);
+            fprintf(stdout, "  -D devices  simulated advertising devices (default %d)\n", SCANINDEX_DEVICES);
+            fprintf(stdout, "  -t seconds  scan time of each method (default %d)\n", SCANINDEX_SECONDS);
+            fprintf(stdout, "  -i ms       time between two requests of the scan results (default %d)\n", SCANINDEX_INTERVAL_MS);
+            fprintf(stdout, "  -n top      strongest devices printed, 1 to %d (default %d)\n", SCANINDEX_MAX_TOP, SCANINDEX_TOP);
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if((seconds <= 0) || (interval_ms < 0) || (interval_ms > 65535) || (top <= 0) || (top > SCANINDEX_MAX_TOP))
+    {
+        fprintf(stdout, "Invalid scan time, interval or number of devices\n");
+        return 1;
+    }
+
+    if(device != NULL)
+    {
+        transportP = SerialTransport_Create(device);
+    }
+    else
+    {
+        ModuleSimulator_Config_t config;
+        ModuleSimulator_GetDefaultConfig(ModuleSimulator_Module_ProteusIII, &config);
+        config.connect = false;
+        config.scan_devices = devices;
+        simP = ModuleSimulator_Create(&config);
+        if((simP == NULL) || !ModuleSimulator_Start(simP))
+        {
+            fprintf(stdout, "Starting the simulator failed\n");
+            ModuleSimulator_Destroy(simP);
+            return 1;
+        }
+        transportP = PtyTransport_Create(ModuleSimulator_GetPeerName(simP));
+        if(transportP != NULL)
+        {
+            PtyTransport_SetPinCallback(transportP, ModuleSimulator_PinCallback, simP);
+        }
+    }
+    if(transportP == NULL)
+    {
+        fprintf(stdout, "Creating the transport failed\n");
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+
+    memset(&callbackConfig, 0, sizeof(callbackConfig));
+    proteusP = ProteusIII_InitEx(transportP, baudrate, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfig);
+    if(proteusP == NULL)
+    {
+        fprintf(stdout, "ProteusIII_InitEx failed\n");
+        Transport_Destroy(transportP);
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+
+    if(simP != NULL)
+    {
+        fprintf(stdout, "%u simulated devices, ", devices);
+    }
+    fprintf(stdout, "scan results requested every %d ms for %d s\n\n", interval_ms, seconds);
+
+    /* snapshots: the application only knows the devices of the last GETDEVICES_CNF */
+    memset(&snapshot, 0, sizeof(snapshot));
+    if(!ProteusIII_ScanstartEx(proteusP))
+    {
+        fprintf(stdout, "Scanstart failed\n");
+        goto cleanup;
+    }
+    start_us = GetTime_us();
+    while(GetTime_us() - start_us < seconds * 1000000.0)
+    {
+        if(ProteusIII_GetDevicesEx(proteusP, &snapshot))
+        {
+            polls++;
+        }
+        else
+        {
+            failed++;
+        }
+        usleep(interval_ms * 1000);
+    }
+    ProteusIII_ScanstopEx(proteusP);
+    fprintf(stdout, "snapshots:   %u requests (%u failed), %u devices known after the last one\n", polls, failed, snapshot.numberofdevices);
+
+    /* scan stream: every result is kept in the scan index */
+    ProteusIII_ScanClearEx(proteusP);
+    if(!ProteusIII_ScanStreamStartEx(proteusP, (uint16_t)interval_ms, 0))
+    {
+        fprintf(stdout, "ProteusIII_ScanStreamStartEx failed\n");
+        goto cleanup;
+    }
+    for(s = 1; s <= seconds; s++)
+    {
+        sleep(1);
+        fprintf(stdout, "scan stream: %3d s %6u devices indexed\n", s, ProteusIII_ScanCountEx(proteusP));
+    }
+    ProteusIII_ScanStreamStopEx(proteusP);
+
+    /* queries of the filled index */
+    indexed = ProteusIII_ScanCountEx(proteusP);
+    if(indexed == 0)
+    {
+        fprintf(stdout, "no devices found\n");
+        goto cleanup;
+    }
+    indexedP = malloc(indexed * sizeof(ProteusIII_ScanDevice_t));
+    if(indexedP == NULL)
+    {
+        goto cleanup;
+    }
+    start_us = GetTime_us();
+    indexed = ProteusIII_ScanTopEx(proteusP, indexedP, indexed);
+    elapsed_us = GetTime_us() - start_us;
+    fprintf(stdout, "\nall %u devices sorted by mean RSSI in %.1f us\n", indexed, elapsed_us);
+
+    found = 0;
+    start_us = GetTime_us();
+    for(i = 0; i < indexed; i++)
+    {
+        ProteusIII_ScanDevice_t device;
+        found += ProteusIII_ScanFindEx(proteusP, indexedP[i].btmac, &device) ? 1 : 0;
+    }
+    elapsed_us = GetTime_us() - start_us;
+    fprintf(stdout, "%u of %u devices looked up by BTMAC, %.3f us per lookup\n", found, indexed, elapsed_us / indexed);
+
+    start_us = GetTime_us();
+    uint32_t strongest = ProteusIII_ScanTopEx(proteusP, indexedP, (uint32_t)top);
+    elapsed_us = GetTime_us() - start_us;
+    fprintf(stdout, "%u strongest devices in %.1f us:\n", strongest, elapsed_us);
+    for(i = 0; i < strongest; i++)
+    {
+        PrintDevice(&indexedP[i]);
+    }
+
+    /* devices not seen for a second: all of them, as the scan was stopped before */
+    sleep(1);
+    start_us = GetTime_us();
+    uint32_t removed = ProteusIII_ScanAgeOutEx(proteusP, 1000);
+    elapsed_us = GetTime_us() - start_us;
+    fprintf(stdout, "%u devices aged out in %.1f us, %u left\n", removed, elapsed_us, ProteusIII_ScanCountEx(proteusP));
+
+    ret = (found == indexed) && (ProteusIII_ScanCountEx(proteusP) == 0);
+
+cleanup:
+    free(indexedP);
+    ProteusIII_DeinitEx(proteusP);
+    Transport_Destroy(transportP);
+    ModuleSimulator_Destroy(simP);
+    return ret ? 0 : 1;
+}
+
+static void PrintDevice(const ProteusIII_ScanDevice_t *deviceP)
+{
+    fprintf(stdout, "  %02X%02X%02X%02X%02X%02X %-32.*s mean %4d dBm, last %4d dBm, TX %3d dBm, %5u results, seen %u ms ago\n",
+            deviceP->btmac[0], deviceP->btmac[1], deviceP->btmac[2], deviceP->btmac[3], deviceP->btmac[4], deviceP->btmac[5],
+            deviceP->devicenamelength, (const char *)deviceP->devicename, deviceP->rssiAverage, deviceP->rssi, deviceP->txpower,
+            deviceP->results, deviceP->age_ms);
+}
+
+static double GetTime_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
@@ -0,0 +1,262 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2019 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Compares the per byte BytesAvailable()/ReadByte() RX path with the bulk
+ * ReadBytes() RX path of the serial interface.
+ *
+ * A pseudo terminal is used as loopback: the benchmark writes into the master
+ * side and the serial interface reads from the slave side, so no module is
+ * required. Both read loops are modelled on the driver rx_thread functions.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+
+#define BENCHMARK_BAUDRATE     921600
+#define BENCHMARK_BYTES        (uint32_t)(256 * 1024)
+#define BENCHMARK_WRITE_CHUNK  1024
+
+typedef struct Benchmark_Result_t
+{
+    const char *name;
+    uint32_t bytes;               /* bytes received */
+    uint64_t transportCalls;      /* calls into the serial interface */
+    uint64_t readSyscalls;        /* read() system calls reported by the kernel */
+    double wall_ms;               /* time until all bytes were received */
+    double cpu_ms;                /* cpu time used by the reading thread */
+    bool dataOk;                  /* received bytes match the written pattern */
+} Benchmark_Result_t;
+
+static void *writer_thread(void *pArgs);
+static bool RunBenchmark(const char *name, void (*readLoop)(Benchmark_Result_t *), Benchmark_Result_t *resultP);
+static void ReadLoop_PerByte(Benchmark_Result_t *resultP);
+static void ReadLoop_Bulk(Benchmark_Result_t *resultP);
+static uint64_t GetReadSyscalls(void);
+static double GetTime_ms(clockid_t clock);
+static void PrintResult(Benchmark_Result_t *resultP);
+
+static int master_fd = -1;
+
+int main ()
+{
+    Benchmark_Result_t perByte, bulk;
+    char *slave_name;
+
+    /* create the pty loopback */
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if((master_fd < 0) || (grantpt(master_fd) != 0) || (unlockpt(master_fd) != 0) || ((slave_name = ptsname(master_fd)) == NULL))
+    {
+        fprintf(stdout, "Creating the pseudo terminal failed: %s\n", strerror(errno));
+        return 1;
+    }
+
+    if((false == SetSerialDevice(slave_name)) || (false == OpenSerial(BENCHMARK_BAUDRATE)))
+    {
+        fprintf(stdout, "Opening %s failed\n", slave_name);
+        return 1;
+    }
+    fprintf(stdout, "pty loopback on %s, %u bytes per run\n\n", slave_name, BENCHMARK_BYTES);
+
+    if(!RunBenchmark("BytesAvailable/ReadByte", ReadLoop_PerByte, &perByte) ||
+       !RunBenchmark("ReadBytes", ReadLoop_Bulk, &bulk))
+    {
+        CloseSerial();
+        return 1;
+    }
+
+    fprintf(stdout, "%-24s %10s %14s %14s %10s %10s %6s\n", "rx path", "bytes", "iface calls", "read syscalls", "wall ms", "cpu ms", "data");
+    PrintResult(&perByte);
+    PrintResult(&bulk);
+
+    if(bulk.readSyscalls > 0)
+    {
+        fprintf(stdout, "\nread syscall reduction: %.1fx\n", (double)perByte.readSyscalls / (double)bulk.readSyscalls);
+    }
+
+    CloseSerial();
+    close(master_fd);
+    return 0;
+}
+
+/* write a known byte pattern into the master side of the pty */
+static void *writer_thread(void *pArgs)
+{
+    uint8_t chunk[BENCHMARK_WRITE_CHUNK];
+    uint32_t written = 0;
+
+    while(written < BENCHMARK_BYTES)
+    {
+        int i;
+        ssize_t ret;
+        size_t length = BENCHMARK_BYTES - written;
+        if(length > sizeof(chunk))
+        {
+            length = sizeof(chunk);
+        }
+        for(i = 0; i < length; i++)
+        {
+            chunk[i] = (uint8_t)(written + i);
+        }
+
+        ret = write(master_fd, chunk, length);
+        if(ret < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        written += ret;
+    }
+    return 0;
+}
+
+static bool RunBenchmark(const char *name, void (*readLoop)(Benchmark_Result_t *), Benchmark_Result_t *resultP)
+{
+    pthread_t thread_write;
+    double wall_start, cpu_start;
+    uint64_t syscalls_start;
+
+    memset(resultP, 0, sizeof(*resultP));
+    resultP->name = name;
+    resultP->dataOk = true;
+    FlushSerial();
+
+    syscalls_start = GetReadSyscalls();
+    wall_start = GetTime_ms(CLOCK_MONOTONIC);
+    cpu_start = GetTime_ms(CLOCK_THREAD_CPUTIME_ID);
+
+    if(pthread_create(&thread_write, NULL, &writer_thread, NULL))
+    {
+        fprintf(stdout, "Failed to start writer thread\n");
+        return false;
+    }
+
+    readLoop(resultP);
+
+    resultP->cpu_ms = GetTime_ms(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+    resultP->wall_ms = GetTime_ms(CLOCK_MONOTONIC) - wall_start;
+    resultP->readSyscalls = GetReadSyscalls() - syscalls_start;
+
+    pthread_join(thread_write, NULL);
+    return true;
+}
+
+/* RX loop of the drivers before ReadBytes: one ioctl and one read per byte */
+static void ReadLoop_PerByte(Benchmark_Result_t *resultP)
+{
+    uint8_t readBuffer;
+
+    while(resultP->bytes < BENCHMARK_BYTES)
+    {
+        delay(1);
+
+        while(resultP->transportCalls++, BytesAvailable())
+        {
+            resultP->transportCalls++;
+            if(ReadByte(&readBuffer))
+            {
+                resultP->dataOk &= (readBuffer == (uint8_t)resultP->bytes);
+                resultP->bytes++;
+            }
+        }
+    }
+}
+
+/* RX loop of the drivers with ReadBytes: everything available per call */
+static void ReadLoop_Bulk(Benchmark_Result_t *resultP)
+{
+    uint8_t rxChunk[SERIAL_RX_CHUNK_SIZE];
+    size_t rxChunkLength = 0;
+    size_t rxChunkIndex;
+
+    while(resultP->bytes < BENCHMARK_BYTES)
+    {
+        delay(1);
+
+        while(resultP->transportCalls++, ReadBytes(rxChunk, sizeof(rxChunk), &rxChunkLength, 0) && (rxChunkLength > 0))
+        {
+            for(rxChunkIndex = 0; rxChunkIndex < rxChunkLength; rxChunkIndex++)
+            {
+                resultP->dataOk &= (rxChunk[rxChunkIndex] == (uint8_t)resultP->bytes);
+                resultP->bytes++;
+            }
+        }
+    }
+}
+
+/* number of read() system calls of this process, see proc(5) */
+static uint64_t GetReadSyscalls()
+{
+    char line[64];
+    unsigned long long syscr = 0;
+    FILE *f = fopen("/proc/self/io", "r");
+
+    if(f == NULL)
+    {
+        return 0;
+    }
+    while(fgets(line, sizeof(line), f) != NULL)
+    {
+        if(sscanf(line, "syscr: %llu", &syscr) == 1)
+        {
+            break;
+        }
+    }
+    fclose(f);
+    return (uint64_t)syscr;
+}
+
+static double GetTime_ms(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static void PrintResult(Benchmark_Result_t *resultP)
+{
+    fprintf(stdout, "%-24s %10u %14llu %14llu %10.1f %10.1f %6s\n",
+            resultP->name,
+            resultP->bytes,
+            (unsigned long long)resultP->transportCalls,
+            (unsigned long long)resultP->readSyscalls,
+            resultP->wall_ms,
+            resultP->cpu_ms,
+            resultP->dataOk ? "ok" : "BAD");
+}
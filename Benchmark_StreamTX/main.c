@@ -0,0 +1,200 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Measures the transmit throughput of the ProteusIII driver over the
+ * simulated module of the Simulator project.
+ *
+ * The simulated module sends the buffered data packets one after another,
+ * each one occupies the link for the air time (-a). First the packets are
+ * sent by ProteusIII_Transmit, which waits for the TXCOMPLETE_RSP of each
+ * packet, so that the link idles while the next request is on its way.
+ * Then the packets are streamed by ProteusIII_StreamTransmit with growing
+ * stream windows (1, 2, 4, ... up to -w), which keeps the next packets
+ * buffered in the module. The pipeline depth of the driver is raised to
+ * the window as well, so that the DATA_CNF of a packet is not waited for
+ * before the next packet is sent.
+ *
+ * Usage: Benchmark_StreamTX [-n packets] [-l latency_us] [-a airtime_us] [-w window]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "../drivers/ProteusIII/ProteusIII.h"
+#include "../Simulator/ModuleSimulator.h"
+
+#define BENCHMARK_BAUDRATE     115200
+#define BENCHMARK_PACKETS      1000
+#define BENCHMARK_LATENCY_US   300      /* processing time of the simulated module */
+#define BENCHMARK_AIRTIME_US   1000     /* time a packet occupies the link */
+#define BENCHMARK_WINDOW       16       /* largest stream window measured */
+#define BENCHMARK_PAYLOAD      243      /* maximum payload of a packet */
+
+static volatile bool channelOpen = false;
+
+static void ChannelOpenCallback(uint8_t *BTMAC, uint16_t max_payload)
+{
+    channelOpen = true;
+}
+
+static double GetTime_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
+
+static void PrintResult(const char *mode, int window, int packets, int ok, double time_us)
+{
+    fprintf(stdout, "%-10s %6d %9d/%-6d %10.1f %12.0f %12.0f\n", mode, window, ok, packets, time_us / 1000.0,
+            (double)ok * 1000000.0 / time_us, (double)ok * BENCHMARK_PAYLOAD * 1000000.0 / time_us);
+}
+
+int main(int argc, char *argv[])
+{
+    ModuleSimulator_Config_t config;
+    ModuleSimulator_t *simP;
+    ProteusIII_CallbackConfig_t callbackConfig;
+    uint8_t payload[BENCHMARK_PAYLOAD];
+    int packets = BENCHMARK_PACKETS;
+    int maxWindow = BENCHMARK_WINDOW;
+    int opt, i, ok, window;
+    double t0;
+
+    ModuleSimulator_GetDefaultConfig(ModuleSimulator_Module_ProteusIII, &config);
+    config.latency_us = BENCHMARK_LATENCY_US;
+    config.airtime_us = BENCHMARK_AIRTIME_US;
+    config.connect = true;
+
+    while((opt = getopt(argc, argv, "n:l:a:w:h")) != -1)
+    {
+        switch(opt)
+        {
+        case 'n':
+            packets = atoi(optarg);
+            break;
+        case 'l':
+            config.latency_us = (unsigned int)atoi(optarg);
+            break;
+        case 'a':
+            config.airtime_us = (unsigned int)atoi(optarg);
+            break;
+        case 'w':
+            maxWindow = atoi(optarg);
+            break;
+        default:
+            fprintf(stdout, "Usage: %s [-n packets] [-l latency_us] [-a airtime_us] [-w window]\n", argv[0]);
+            fprintf(stdout, "  -n  packets per measurement (default %d)\n", BENCHMARK_PACKETS);
+            fprintf(stdout, "  -l  processing time of the simulated module in us (default %d)\n", BENCHMARK_LATENCY_US);
+            fprintf(stdout, "  -a  air time of a packet in us (default %d)\n", BENCHMARK_AIRTIME_US);
+            fprintf(stdout, "  -w  largest stream window, 1 to 255 (default %d)\n", BENCHMARK_WINDOW);
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    if((packets <= 0) || (maxWindow <= 0) || (maxWindow > 255))
+    {
+        fprintf(stdout, "Invalid number of packets or window\n");
+        return 1;
+    }
+
+    simP = ModuleSimulator_Create(&config);
+    if((simP == NULL) || !ModuleSimulator_Start(simP) || !SetSerialDevice(ModuleSimulator_GetPeerName(simP)))
+    {
+        fprintf(stdout, "Starting the simulator failed\n");
+        return 1;
+    }
+    PtyTransport_SetPinCallback(GetDefaultTransport(), ModuleSimulator_PinCallback, simP);
+
+    memset(&callbackConfig, 0, sizeof(callbackConfig));
+    callbackConfig.channelOpenCb = ChannelOpenCallback;
+    if(!ProteusIII_Init(BENCHMARK_BAUDRATE, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfig))
+    {
+        fprintf(stdout, "ProteusIII_Init failed\n");
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+    /* the simulated peer connects after the startup */
+    for(i = 0; !channelOpen && (i < 1000); i++)
+    {
+        usleep(1000);
+    }
+    if(!channelOpen)
+    {
+        fprintf(stdout, "Channel was not opened\n");
+        ProteusIII_Deinit();
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+
+    for(i = 0; i < BENCHMARK_PAYLOAD; i++)
+    {
+        payload[i] = (uint8_t)i;
+    }
+
+    fprintf(stdout, "%d packets of %d bytes, module latency %u us, air time %u us, link limit %.0f packets/s\n\n",
+            packets, BENCHMARK_PAYLOAD, config.latency_us, config.airtime_us,
+            (config.airtime_us > 0) ? 1000000.0 / config.airtime_us : 0.0);
+    fprintf(stdout, "%-10s %6s %16s %10s %12s %12s\n", "mode", "window", "ok", "time ms", "packets/s", "bytes/s");
+
+    /* one packet at a time */
+    ok = 0;
+    t0 = GetTime_us();
+    for(i = 0; i < packets; i++)
+    {
+        ok += ProteusIII_Transmit(payload, sizeof(payload)) ? 1 : 0;
+    }
+    PrintResult("transmit", 1, packets, ok, GetTime_us() - t0);
+
+    /* streamed with a growing window, a packet counts if it was accepted and the flush succeeded */
+    for(window = 1; window <= maxWindow; window *= 2)
+    {
+        /* the simulated module accepts the next request before it confirmed the previous one */
+        ProteusIII_SetStreamWindow((uint8_t)window);
+        ProteusIII_SetPipelineDepth((uint8_t)window);
+        ok = 0;
+        t0 = GetTime_us();
+        for(i = 0; i < packets; i++)
+        {
+            ok += ProteusIII_StreamTransmit(payload, sizeof(payload)) ? 1 : 0;
+        }
+        if(!ProteusIII_StreamFlush())
+        {
+            ok = 0;
+        }
+        PrintResult("stream", window, packets, ok, GetTime_us() - t0);
+    }
+
+    ProteusIII_Deinit();
+    ModuleSimulator_Destroy(simP);
+    return 0;
+}
@@ -0,0 +1,207 @@
+﻿/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Gateway example using several radio modules side by side in one program:
+ *
+ * - a ProteusIII on the UART of the Raspberry Pi (wiringPi pins for reset, wakeup and boot)
+ * - two MetisPlugs, one in S2 and one in T2 mode, on the FTDI devices 0 and 1
+ * - a TarvosIII on an USB serial adapter without any pins connected
+ *
+ * Each module is driven by its own driver instance (see *_InitEx) on its own transport.
+ * Every wM-Bus telegram and every TarvosIII packet received is forwarded via Bluetooth LE
+ * to the device connected to the ProteusIII.
+ *
+ * The project is built with GLOBAL_NO_DEFAULT_TRANSPORT defined, as the serial and the FTDI
+ * backend are linked side by side.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../drivers/ProteusIII/ProteusIII.h"
+#include "../drivers/TarvosIII/TarvosIII.h"
+#include "../drivers/Metis/Metis.h"
+#include "../drivers/global/global.h"
+#include "../drivers/WE-common.h"
+
+#define GATEWAY_PROTEUSIII_DEVICE   "/dev/serial0"
+#define GATEWAY_TARVOSIII_DEVICE    "/dev/ttyUSB0"
+#define GATEWAY_METIS_COUNT         2
+
+static void Gateway_function();
+static void Forward(const char *source, uint8_t* payload, uint8_t payload_length, int8_t rssi);
+
+static void ProteusIII_RXcallback(uint8_t* payload, uint16_t payload_length, uint8_t* BTMAC, int8_t rssi);
+static void ProteusIII_Channelopencallback(uint8_t* BTMAC, uint16_t max_payload);
+static void ProteusIII_Disconnectcallback();
+static void Metis_RXcallback(uint8_t* payload, uint8_t payload_length, int8_t rssi);
+static void TarvosIII_RXcallback(uint8_t* payload, uint8_t payload_length, uint8_t dest_network_id, uint8_t dest_address_lsb, uint8_t dest_address_msb, int8_t rssi);
+
+pthread_t thread_main;
+
+bool AbortMainLoop = false;
+
+static ProteusIII_Handle_t *proteusP = NULL;
+static Metis_Handle_t *metisP[GATEWAY_METIS_COUNT] = {NULL};
+static TarvosIII_Handle_t *tarvosP = NULL;
+
+/* true while a BLE device is connected and the channel is open */
+static volatile bool channelOpen = false;
+
+void *main_Thread(void *pArgs)
+{
+    /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
+    setThreadPrio(PRIO_MAIN_THREAD);
+
+    Gateway_function();
+
+    AbortMainLoop = true;
+    return 0 ;
+}
+
+/* the main function simply starts the MainThread */
+int main ()
+{
+    AbortMainLoop = false;
+
+    if(pthread_create(&thread_main, NULL, &main_Thread, NULL))
+    {
+        fprintf(stdout, "Failed to start thread_main");
+        return false;
+    }
+
+    while(1)
+    {
+        delay(1000);
+        if(AbortMainLoop == true)
+        {
+            /* jump out of the main loop and exit program */
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+/* forward the received data to the BLE device connected to the ProteusIII */
+static void Forward(const char *source, uint8_t* payload, uint8_t payload_length, int8_t rssi)
+{
+    printf (COLOR_RED "%s received %d bytes with RSSI: %d dBm\n" COLOR_RESET, source, payload_length, rssi);
+    fflush (stdout) ;
+
+    if(channelOpen)
+    {
+        /* the RX callbacks of the other instances run in their own RX threads,
+         * so the ProteusIII can be used directly from here */
+        if(false == ProteusIII_TransmitEx(proteusP, payload, payload_length))
+        {
+            printf ("Forwarding data of %s failed\n", source);
+        }
+    }
+}
+
+static void ProteusIII_RXcallback(uint8_t* payload, uint16_t payload_length, uint8_t* BTMAC, int8_t rssi)
+{
+    printf (COLOR_RED "Received %d bytes from device with BTMAC (0x%02x%02x%02x%02x%02x%02x)\n" COLOR_RESET, payload_length, BTMAC[0],BTMAC[1],BTMAC[2],BTMAC[3],BTMAC[4],BTMAC[5]);
+    fflush (stdout) ;
+}
+
+static void ProteusIII_Channelopencallback(uint8_t* BTMAC, uint16_t max_payload)
+{
+    printf (COLOR_RED "Channel to device with BTMAC (0x%02x%02x%02x%02x%02x%02x) opened\n" COLOR_RESET, BTMAC[0],BTMAC[1],BTMAC[2],BTMAC[3],BTMAC[4],BTMAC[5]);
+    fflush (stdout) ;
+    channelOpen = true;
+}
+
+static void ProteusIII_Disconnectcallback()
+{
+    printf (COLOR_RED "Disconnected\n" COLOR_RESET);
+    fflush (stdout) ;
+    channelOpen = false;
+}
+
+/* shared by both Metis instances, the instance is identified by Metis_GetCallbackHandle */
+static void Metis_RXcallback(uint8_t* payload, uint8_t payload_length, int8_t rssi)
+{
+    Metis_Handle_t *handleP = Metis_GetCallbackHandle();
+
+    Forward((handleP == metisP[0]) ? "Metis S2" : "Metis T2", payload, payload_length, rssi);
+}
+
+static void TarvosIII_RXcallback(uint8_t* payload, uint8_t payload_length, uint8_t dest_network_id, uint8_t dest_address_lsb, uint8_t dest_address_msb, int8_t rssi)
+{
+    Forward("TarvosIII", payload, payload_length, rssi);
+}
+
+static void Gateway_function()
+{
+    ProteusIII_CallbackConfig_t callbackConfig = {0};
+    Transport_t *transportsP[2 + GATEWAY_METIS_COUNT] = {NULL};
+    static const Metis_Mode_Preselect_t metisModes[GATEWAY_METIS_COUNT] = {MBus_Mode_868_S2, MBus_Mode_868_T2_other};
+    int i;
+
+    /* ProteusIII on the UART of the Raspberry Pi */
+    transportsP[0] = SerialTransport_Create(GATEWAY_PROTEUSIII_DEVICE);
+    callbackConfig.rxCb = ProteusIII_RXcallback;
+    callbackConfig.channelOpenCb = ProteusIII_Channelopencallback;
+    callbackConfig.disconnectCb = ProteusIII_Disconnectcallback;
+    proteusP = ProteusIII_InitEx(transportsP[0], 115200, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfig);
+    Debug_out("ProteusIII_InitEx", proteusP != NULL);
+
+    /* MetisPlugs on the FTDI devices */
+    for(i = 0; i < GATEWAY_METIS_COUNT; i++)
+    {
+        transportsP[1 + i] = FTDITransport_Create(i);
+        metisP[i] = Metis_InitEx(transportsP[1 + i], 9600, PIN_FTDI_CBUS0, MBus_Frequency_868, metisModes[i], true, Metis_RXcallback);
+        Debug_out("Metis_InitEx", metisP[i] != NULL);
+    }
+
+    /* TarvosIII on an USB serial adapter, no pins connected */
+    transportsP[1 + GATEWAY_METIS_COUNT] = SerialTransport_Create(GATEWAY_TARVOSIII_DEVICE);
+    tarvosP = TarvosIII_InitEx(transportsP[1 + GATEWAY_METIS_COUNT], 115200, PIN_INVALID, PIN_INVALID, PIN_INVALID, TarvosIII_RXcallback, AddressMode_0);
+    Debug_out("TarvosIII_InitEx", tarvosP != NULL);
+
+    if(proteusP != NULL)
+    {
+        printf ("Waiting for a BLE connection, press enter to stop the gateway\n");
+        fflush (stdout) ;
+        getchar();
+    }
+
+    TarvosIII_DeinitEx(tarvosP);
+    for(i = 0; i < GATEWAY_METIS_COUNT; i++)
+    {
+        Metis_DeinitEx(metisP[i]);
+    }
+    ProteusIII_DeinitEx(proteusP);
+
+    for(i = 0; i < 2 + GATEWAY_METIS_COUNT; i++)
+    {
+        Transport_Destroy(transportsP[i]);
+    }
+}
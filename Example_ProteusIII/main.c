@@ -35,6 +35,7 @@
 static void ProteusIII_test_function();
 static void ProteusIII_wait4connect_function();
 static void ProteusIII_scanNconnect_function();
+static void ProteusIII_messages_function();
 
 static void SetCallbacks(ProteusIII_CallbackConfig_t *callbackConfigP);
 
@@ -46,6 +47,7 @@ static void DisplayPasskeycallback(ProteusIII_DisplayPasskeyAction_t action, uin
 static void Disconnectcallback();
 static void Channelopencallback(uint8_t* BTMAC, uint16_t max_payload);
 static void Phyupdatecallback(uint8_t* BTMAC, uint8_t phy_rx, uint8_t phy_tx);
+static void Messagecallback(uint8_t* messageP, uint32_t length, void* contextP);
 
 pthread_t thread_main;
 
@@ -61,6 +63,9 @@ void *main_Thread(void *pArgs)
     ProteusIII_scanNconnect_function();
 #elif 1
     ProteusIII_wait4connect_function();
+#elif 0
+    /* function sending messages longer than a packet */
+    ProteusIII_messages_function();
 #else
     /* function to test all functions of the ProteusIII driver */
     ProteusIII_test_function();
@@ -149,6 +154,14 @@ static void Phyupdatecallback(uint8_t* BTMAC, uint8_t phy_rx, uint8_t phy_tx)
     fflush (stdout) ;
 }
 
+/* callback for messages reassembled from the received packets */
+static void Messagecallback(uint8_t* messageP, uint32_t length, void* contextP)
+{
+    printf (COLOR_RED "Received message of %u bytes" COLOR_CYAN, (unsigned int)length);
+    printf ("\n") ;
+    fflush (stdout) ;
+}
+
 static void SetCallbacks(ProteusIII_CallbackConfig_t *callbackConfigP)
 {
     callbackConfigP->rxCb = RXcallback;
@@ -496,6 +509,56 @@ static void ProteusIII_wait4connect_function()
     Debug_out("ProteusIII deinit", ret);
 }
 
+/* this function waits for a connection and sends messages longer than the payload of a packet,
+ * the connected device has to reassemble them, e.g. by ProteusIII_SetMessageCallback */
+static void ProteusIII_messages_function()
+{
+    bool ret = false;
+    static uint8_t message[2000];
+
+    /* initialize the module ProteusIII */
+    ProteusIII_CallbackConfig_t callbackConfiguration;
+    SetCallbacks(&callbackConfiguration);
+
+    ret = ProteusIII_Init(115200, ProteusIII_PIN_RESET, ProteusIII_PIN_WAKEUP, ProteusIII_PIN_BOOT, callbackConfiguration);
+    Debug_out("ProteusIII init", ret);
+
+    if (ret == true)
+    {
+        ret = ProteusIII_PinReset();
+        Debug_out("Reset", ret);
+        delay(500);
+
+        /* the received packets carry segments of messages from now on */
+        ret = ProteusIII_SetMessageCallback(sizeof(message), Messagecallback, NULL);
+        Debug_out("ProteusIII_SetMessageCallback", ret);
+
+        fprintf (stdout, "Waiting for incoming connections\n");
+        while(1)
+        {
+            if( ProteusIII_State_BLE_Channel_Open == ProteusIII_GetDriverState())
+            {
+                /* send messages and disconnect */
+                int i = 0;
+                for(i=0; i<5; i++)
+                {
+                    memset(message, '0' + i, sizeof(message));
+                    ret = ProteusIII_SendMessage(message, sizeof(message));
+                    Debug_out("ProteusIII_SendMessage",ret);
+                    delay(500);
+                }
+
+                ret = ProteusIII_Disconnect();
+                Debug_out("ProteusIII_Disconnect",ret);
+                delay(500);
+            }
+            delay(1000);
+        }
+    }
+    ret = ProteusIII_Deinit();
+    Debug_out("ProteusIII deinit", ret);
+}
+
 /* this function scans for available ProteusIII modules and connects to the first */
 static void ProteusIII_scanNconnect_function()
 {
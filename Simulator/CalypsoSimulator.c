@@ -0,0 +1,2736 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Calypso AT command simulator, see CalypsoSimulator.h
+ *
+ * Two threads serve a simulator: the RX thread assembles the command lines
+ * of the driver, executes them and writes the answer, the IO thread waits
+ * on the sockets and MQTT connections of the module and sends the
+ * unsolicited lines (+recv, +accept, +eventmqtt and the delayed events
+ * like +eventstartup). The mutex of the simulator serializes both, so that
+ * answers and events are never interleaved on the pty.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "CalypsoSimulator.h"
+
+/**************************************
+ *     Definitions                    *
+ **************************************/
+
+#define CSIM_LINE_MAX_SIZE      4096        /* command line received from the driver */
+#define CSIM_OUT_MAX_SIZE       8192        /* answer or event being assembled */
+#define CSIM_MAX_DATA_LENGTH    1400        /* payload of a +recv, +fileread or +eventmqtt line, Base64 encoded it still fits into the 2048 byte line buffer of the driver */
+#define CSIM_SOCKET_COUNT       16
+#define CSIM_MQTT_COUNT         4
+#define CSIM_FILE_COUNT         8
+#define CSIM_PROFILE_COUNT      7
+#define CSIM_SETTING_COUNT      64
+#define CSIM_TIMER_COUNT        16          /* delayed events */
+#define CSIM_TIMER_LINE_SIZE    256
+#define CSIM_MQTT_BUFFER_SIZE   8192
+#define CSIM_RX_CHUNK_SIZE      256
+#define CSIM_CONNECT_TIMEOUT_MS 400         /* the driver waits 500 ms for the answer of AT+connect and AT+mqttConnect */
+#define CSIM_SEND_TIMEOUT_MS    400
+#define CSIM_IDLE_POLL_MS       1000
+
+/*
+ * Unsolicited lines are held back for this time after an answer, so with
+ * a latency they arrive while the next command is pending: the driver has
+ * to tell them from the response lines of that command.
+ */
+#define CSIM_EVENT_HOLD_US      500
+
+#define CSIM_STATUS_OK          0
+#define CSIM_ERROR_INVALID      -1          /* unknown command or invalid arguments, host errors are reported as -errno */
+
+#define CSIM_FORMAT_BINARY      0
+#define CSIM_FORMAT_BASE64      1
+
+#define MQTT_CONNECT            0x10
+#define MQTT_CONNACK            0x20
+#define MQTT_PUBLISH            0x30
+#define MQTT_PUBACK             0x40
+#define MQTT_PUBREC             0x50
+#define MQTT_PUBREL             0x62
+#define MQTT_PUBCOMP            0x70
+#define MQTT_SUBSCRIBE          0x82
+#define MQTT_SUBACK             0x90
+#define MQTT_UNSUBSCRIBE        0xA2
+#define MQTT_UNSUBACK           0xB0
+#define MQTT_PINGREQ            0xC0
+#define MQTT_PINGRESP           0xD0
+#define MQTT_DISCONNECT         0xE0
+
+typedef struct CSim_Socket_t
+{
+    bool used;
+    int fd;
+    int family;                                 /* AF_INET or AF_INET6 */
+    bool stream;                                /* TCP, UDP otherwise */
+    bool peerClosed;                            /* TCP: the peer closed the connection */
+    bool acceptPending;                         /* AT+accept: send +accept when a client connects */
+    bool recvPending;                           /* AT+recv, AT+recvFrom: send +recv or +recvfrom when data arrives */
+    bool recvFrom;
+    uint8_t format;
+    uint16_t recvLength;
+} CSim_Socket_t;
+
+typedef struct CSim_Mqtt_t
+{
+    bool used;
+    bool connected;
+    int fd;
+    char clientID[64];
+    char address[128];
+    uint16_t port;
+    uint8_t protocolLevel;                      /* 3 for MQTT 3.1, 4 for MQTT 3.1.1 */
+    uint8_t format;                             /* of the messages */
+    char user[64];
+    char password[64];
+    bool will;
+    char willTopic[128];
+    char willMessage[256];
+    uint8_t willQoS;
+    bool willRetain;
+    uint16_t keepAlive_s;
+    bool clean;
+    uint16_t packetId;
+    struct timespec lastSent;                   /* for the keep alive */
+    uint8_t rxBuffer[CSIM_MQTT_BUFFER_SIZE];
+    size_t rxFill;
+} CSim_Mqtt_t;
+
+typedef struct CSim_File_t
+{
+    bool used;
+    uint32_t id;
+    int fd;
+} CSim_File_t;
+
+typedef struct CSim_Profile_t
+{
+    bool used;
+    char arguments[256];                        /* SSID,BSSID,security type,key,user,anonymous user,EAP method */
+    uint32_t priority;
+} CSim_Profile_t;
+
+typedef struct CSim_Setting_t
+{
+    char key[64];                               /* e.g. "get:UART,baudrate", "wlan:general,COUNTRY_CODE", "policy:PM" */
+    char value[160];
+} CSim_Setting_t;
+
+typedef struct CSim_Timer_t
+{
+    bool used;
+    struct timespec due;
+    uint64_t order;                             /* keeps lines with the same due time in order */
+    char line[CSIM_TIMER_LINE_SIZE];
+} CSim_Timer_t;
+
+typedef struct CSim_Command_t
+{
+    const char *name;
+    int (*handler)(CalypsoSimulator_t *simP, char *argsP);
+} CSim_Command_t;
+
+struct CalypsoSimulator_t
+{
+    CalypsoSimulator_Config_t config;
+    Transport_t *transportP;
+    int rxThreadEvent;                          /* eventfd to stop the RX thread */
+    int ioThreadEvent;                          /* eventfd to stop the IO thread or to make it wait on the changed sockets */
+    pthread_t thread_rx;
+    pthread_t thread_io;
+    bool running;
+
+    pthread_mutex_t mutex;                      /* protects all members below, held while writing to the pty */
+    bool stop;
+    bool scanned;                               /* the first AT+wlanScan only starts the scan */
+    bool wlanConnected;
+    char ssid[33];
+    time_t timeOffset;                          /* AT+set=general,time, relative to the host clock */
+    uint32_t nextFileID;
+    uint64_t order;
+    struct timespec lastAnswer;
+    CSim_Socket_t sockets[CSIM_SOCKET_COUNT];
+    CSim_Mqtt_t mqtt[CSIM_MQTT_COUNT];
+    CSim_File_t files[CSIM_FILE_COUNT];
+    CSim_Profile_t profiles[CSIM_PROFILE_COUNT];
+    CSim_Setting_t settings[CSIM_SETTING_COUNT];
+    CSim_Timer_t timers[CSIM_TIMER_COUNT];
+    CalypsoSimulator_Statistics_t statistics;
+    char out[CSIM_OUT_MAX_SIZE];
+    size_t outLength;
+    uint8_t data[CSIM_LINE_MAX_SIZE];           /* decoded payload of a command or received payload of an event */
+
+    /* command line, only used by the RX thread */
+    char rxLine[CSIM_LINE_MAX_SIZE];
+    size_t rxLength;
+    bool rxOverflow;
+};
+
+static void *rx_thread(void *pArgs);
+static void *io_thread(void *pArgs);
+static void HandleLine(CalypsoSimulator_t *simP, char *lineP);
+static void Out(CalypsoSimulator_t *simP, const char *formatP, ...);
+static void OutData(CalypsoSimulator_t *simP, uint8_t format, const uint8_t *dataP, size_t length);
+static void Flush(CalypsoSimulator_t *simP);
+static void Event(CalypsoSimulator_t *simP, const char *formatP, ...);
+static void AddTimer(CalypsoSimulator_t *simP, unsigned int delay_ms, const char *formatP, ...);
+static void SendDueTimers(CalypsoSimulator_t *simP, const struct timespec *nowP, int *timeoutP);
+static void WakeIoThread(CalypsoSimulator_t *simP);
+static uint64_t GetThreadCpuTime_us(pthread_t thread);
+static void Boot(CalypsoSimulator_t *simP);
+static void CloseAll(CalypsoSimulator_t *simP);
+static void ResetSettings(CalypsoSimulator_t *simP);
+static const char *GetSetting(CalypsoSimulator_t *simP, const char *prefixP, const char *keyP);
+static bool SetSetting(CalypsoSimulator_t *simP, const char *prefixP, const char *keyP, const char *valueP);
+static char *NextArgument(char **argsPP);
+static bool ParseInt(const char *textP, long min, long max, long *valueP);
+static bool ParseData(CalypsoSimulator_t *simP, const char *textP, long format, long length, size_t *dataLengthP);
+static size_t Base64Encode(const uint8_t *dataP, size_t length, char *textP);
+static bool Base64Decode(const char *textP, uint8_t *dataP, size_t max, size_t *lengthP);
+static bool ParseAddress(const char *familyP, const char *portP, const char *addressP, struct sockaddr_storage *addrP, socklen_t *addrLengthP);
+static int ConnectWithTimeout(int fd, const struct sockaddr *addrP, socklen_t addrLength, int timeout_ms);
+static CSim_Socket_t *GetSocket(CalypsoSimulator_t *simP, const char *idP);
+static void CloseSocket(CSim_Socket_t *socketP);
+static void Socket_HandleReadable(CalypsoSimulator_t *simP, int id);
+static CSim_Mqtt_t *GetMqtt(CalypsoSimulator_t *simP, const char *indexP);
+static int Mqtt_Send(CSim_Mqtt_t *mqttP, uint8_t type, const uint8_t *bodyP, size_t length);
+static size_t Mqtt_PutString(uint8_t *bufferP, const char *textP, size_t length);
+static void Mqtt_Close(CalypsoSimulator_t *simP, CSim_Mqtt_t *mqttP, bool event);
+static void Mqtt_HandleReadable(CalypsoSimulator_t *simP, int index);
+static void Mqtt_HandlePacket(CalypsoSimulator_t *simP, CSim_Mqtt_t *mqttP, uint8_t type, const uint8_t *bodyP, size_t length);
+static CSim_File_t *GetFile(CalypsoSimulator_t *simP, const char *idP);
+static bool FilePath(CalypsoSimulator_t *simP, const char *nameP, char *pathP, size_t size);
+static void GetTime(struct timespec *timeP);
+static void AddTime(struct timespec *timeP, uint64_t us);
+static bool IsBefore(const struct timespec *aP, const struct timespec *bP);
+static int DiffMs(const struct timespec *laterP, const struct timespec *earlierP);
+
+static int Device_Ok(CalypsoSimulator_t *simP, char *argsP);
+static int Device_Reboot(CalypsoSimulator_t *simP, char *argsP);
+static int Device_FactoryReset(CalypsoSimulator_t *simP, char *argsP);
+static int Device_Get(CalypsoSimulator_t *simP, char *argsP);
+static int Device_Set(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_SetMode(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_Scan(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_Connect(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_Disconnect(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_ProfileAdd(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_ProfileGet(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_ProfileDel(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_Get(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_Set(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_PolicySet(CalypsoSimulator_t *simP, char *argsP);
+static int Wlan_PolicyGet(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_Create(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_Close(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_Bind(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_Listen(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_Connect(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_Accept(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_Recv(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_RecvFrom(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_Send(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_SendTo(CalypsoSimulator_t *simP, char *argsP);
+static int Socket_SetSockOpt(CalypsoSimulator_t *simP, char *argsP);
+static int File_Open(CalypsoSimulator_t *simP, char *argsP);
+static int File_Close(CalypsoSimulator_t *simP, char *argsP);
+static int File_Del(CalypsoSimulator_t *simP, char *argsP);
+static int File_Read(CalypsoSimulator_t *simP, char *argsP);
+static int File_Write(CalypsoSimulator_t *simP, char *argsP);
+static int Mqtt_Create(CalypsoSimulator_t *simP, char *argsP);
+static int Mqtt_Delete(CalypsoSimulator_t *simP, char *argsP);
+static int Mqtt_Connect(CalypsoSimulator_t *simP, char *argsP);
+static int Mqtt_Disconnect(CalypsoSimulator_t *simP, char *argsP);
+static int Mqtt_Publish(CalypsoSimulator_t *simP, char *argsP);
+static int Mqtt_Subscribe(CalypsoSimulator_t *simP, char *argsP);
+static int Mqtt_Unsubscribe(CalypsoSimulator_t *simP, char *argsP);
+static int Mqtt_Set(CalypsoSimulator_t *simP, char *argsP);
+
+/**************************************
+ *          Static variables          *
+ **************************************/
+
+static const CSim_Command_t commands[] =
+{
+    { "test", Device_Ok },
+    { "start", Device_Ok },
+    { "stop", Device_Ok },
+    { "sleep", Device_Ok },
+    { "reboot", Device_Reboot },
+    { "factoryreset", Device_FactoryReset },
+    { "get", Device_Get },
+    { "set", Device_Set },
+    { "wlanSetMode", Wlan_SetMode },
+    { "wlanScan", Wlan_Scan },
+    { "wlanConnect", Wlan_Connect },
+    { "wlanDisconnect", Wlan_Disconnect },
+    { "wlanProfileAdd", Wlan_ProfileAdd },
+    { "wlanProfileGet", Wlan_ProfileGet },
+    { "wlanProfileDel", Wlan_ProfileDel },
+    { "wlanGet", Wlan_Get },
+    { "wlanSet", Wlan_Set },
+    { "wlanPolicySet", Wlan_PolicySet },
+    { "wlanPolicyGet", Wlan_PolicyGet },
+    { "socket", Socket_Create },
+    { "close", Socket_Close },
+    { "bind", Socket_Bind },
+    { "listen", Socket_Listen },
+    { "connect", Socket_Connect },
+    { "accept", Socket_Accept },
+    { "recv", Socket_Recv },
+    { "recvFrom", Socket_RecvFrom },
+    { "send", Socket_Send },
+    { "sendTo", Socket_SendTo },
+    { "setSockOpt", Socket_SetSockOpt },
+    { "fileOpen", File_Open },
+    { "fileClose", File_Close },
+    { "fileDel", File_Del },
+    { "fileRead", File_Read },
+    { "fileWrite", File_Write },
+    { "mqttCreate", Mqtt_Create },
+    { "mqttDelete", Mqtt_Delete },
+    { "mqttConnect", Mqtt_Connect },
+    { "mqttDisconnect", Mqtt_Disconnect },
+    { "mqttDisconnet", Mqtt_Disconnect },     /* spelling used by ATMQTT_disconnect */
+    { "mqttPublish", Mqtt_Publish },
+    { "mqttSubscribe", Mqtt_Subscribe },
+    { "mqttUnsubscribe", Mqtt_Unsubscribe },
+    { "mqttSet", Mqtt_Set },
+};
+
+/* values of AT+get, AT+wlanGet and AT+wlanPolicyGet after a factory reset */
+static const CSim_Setting_t defaultSettings[] =
+{
+    { "get:status,device", "0" },
+    { "get:status,WLAN", "0" },
+    { "get:status,BSD", "0" },
+    { "get:status,netapp", "0" },
+    { "get:general,version", "0x31000019,1.9.0,2.2.0.4,3.7.0.1,1.0.0.0" },
+    { "get:general,persistent", "1" },
+    { "get:IOT,UDID", "3A1F22C5B8E04D7A9C1E6B2F0D4A5E87" },
+    { "get:UART,baudrate", "921600" },
+    { "get:UART,parity", "2" },
+    { "wlan:general,COUNTRY_CODE", "EU" },
+    { "wlan:general,STA_TX_POWER", "0" },
+    { "wlan:general,AP_TX_POWER", "0" },
+    { "wlan:general,SCAN_PARAMS", "8191,-95" },
+    { "wlan:general,SUSPEND_PROFILES", "0" },
+    { "wlan:general,DISABLE_ENT_SERVER_AUTH", "0" },
+    { "wlan:P2P,CHANNEL_N_REGS", "11,81,6,81" },
+    { "wlan:AP,SSID", "calypso_simulator" },
+    { "wlan:AP,CHANNEL", "1" },
+    { "wlan:AP,HIDDEN_SSID", "0" },
+    { "wlan:AP,SECURITY", "OPEN" },
+    { "wlan:AP,PASSWORD", "" },
+    { "wlan:AP,MAX_STATIONS", "4" },
+    { "wlan:AP,MAX_STA_AGING", "60" },
+    { "wlan:mode", "STA" },
+    { "policy:connection", "auto" },
+    { "policy:scan", "Hidden_SSID,0" },
+    { "policy:PM", "normal,0" },
+    { "policy:P2P", "NEGOTIATE,ACTIVE" },
+};
+
+/* access points reported by AT+wlanScan */
+static const char *scanEntries[] =
+{
+    "calypso_simulator,14:AE:DB:00:00:01,-40,1,WPA_WPA2,0,CCMP,PSK",
+    "office,14:AE:DB:00:00:02,-62,6,WPA2,0,CCMP,PSK",
+    "guest,14:AE:DB:00:00:03,-75,11,OPEN,0,NONE,NONE",
+};
+
+#define CSIM_STARTUP_EVENT      "+eventstartup:2610011025000,0x31000019,0C:61:CF:00:00:01,1.9.0"
+#define CSIM_BSSID              "14:AE:DB:00:00:01"
+
+static const char base64Table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**************************************
+ *         Global functions           *
+ **************************************/
+
+void CalypsoSimulator_GetDefaultConfig(CalypsoSimulator_Config_t *configP)
+{
+    memset(configP, 0, sizeof(CalypsoSimulator_Config_t));
+    configP->device = NULL;
+    configP->latency_us = 500;
+    configP->boot_ms = 50;
+    configP->connect_ms = 50;
+    configP->fileRoot = "/tmp/calypso_files";
+    configP->ipAddress = "127.0.0.1";
+}
+
+CalypsoSimulator_t *CalypsoSimulator_Create(const CalypsoSimulator_Config_t *configP)
+{
+    CalypsoSimulator_t *simP;
+    int i;
+
+    if((configP == NULL) || (configP->fileRoot == NULL) || (configP->ipAddress == NULL))
+    {
+        return NULL;
+    }
+
+    simP = calloc(1, sizeof(CalypsoSimulator_t));
+    if(simP == NULL)
+    {
+        return NULL;
+    }
+    simP->config = *configP;
+    simP->rxThreadEvent = -1;
+    simP->ioThreadEvent = -1;
+    simP->nextFileID = 1;
+    for(i = 0; i < CSIM_SOCKET_COUNT; i++)
+    {
+        simP->sockets[i].fd = -1;
+    }
+    for(i = 0; i < CSIM_MQTT_COUNT; i++)
+    {
+        simP->mqtt[i].fd = -1;
+    }
+    for(i = 0; i < CSIM_FILE_COUNT; i++)
+    {
+        simP->files[i].fd = -1;
+    }
+    ResetSettings(simP);
+    pthread_mutex_init(&simP->mutex, NULL);
+
+    if((mkdir(configP->fileRoot, 0755) != 0) && (errno != EEXIST))
+    {
+        fprintf(stdout, "Creating the file directory %s of the Calypso simulator failed: %s\n", configP->fileRoot, strerror(errno));
+        CalypsoSimulator_Destroy(simP);
+        return NULL;
+    }
+
+    /* the pty is created (or attached to) right away, so that the driver can open it before the simulator runs */
+    simP->transportP = PtyTransport_Create(configP->device);
+    if((simP->transportP == NULL) || (false == Transport_Open(simP->transportP, 0, Serial_ParityBit_NONE)))
+    {
+        fprintf(stdout, "Setting up the pseudo terminal of the Calypso simulator failed\n");
+        CalypsoSimulator_Destroy(simP);
+        return NULL;
+    }
+    return simP;
+}
+
+const char *CalypsoSimulator_GetPeerName(CalypsoSimulator_t *simP)
+{
+    return (simP != NULL) ? PtyTransport_GetPeerName(simP->transportP) : NULL;
+}
+
+bool CalypsoSimulator_Start(CalypsoSimulator_t *simP)
+{
+    if((simP == NULL) || simP->running)
+    {
+        return false;
+    }
+
+    simP->stop = false;
+    simP->rxLength = 0;
+    simP->rxOverflow = false;
+    Boot(simP);
+
+    simP->rxThreadEvent = RxThreadEvent_Create();
+    simP->ioThreadEvent = RxThreadEvent_Create();
+    if((simP->rxThreadEvent < 0) || (simP->ioThreadEvent < 0))
+    {
+        fprintf(stdout, "Failed to create the thread events\n");
+        RxThreadEvent_Destroy(simP->rxThreadEvent);
+        RxThreadEvent_Destroy(simP->ioThreadEvent);
+        simP->rxThreadEvent = -1;
+        simP->ioThreadEvent = -1;
+        return false;
+    }
+    if(pthread_create(&simP->thread_rx, NULL, &rx_thread, simP))
+    {
+        fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(simP->rxThreadEvent);
+        RxThreadEvent_Destroy(simP->ioThreadEvent);
+        simP->rxThreadEvent = -1;
+        simP->ioThreadEvent = -1;
+        return false;
+    }
+    if(pthread_create(&simP->thread_io, NULL, &io_thread, simP))
+    {
+        fprintf(stdout, "Failed to start io_Thread\n");
+        RxThreadEvent_Signal(simP->rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(simP->thread_rx, NULL);
+        RxThreadEvent_Destroy(simP->rxThreadEvent);
+        RxThreadEvent_Destroy(simP->ioThreadEvent);
+        simP->rxThreadEvent = -1;
+        simP->ioThreadEvent = -1;
+        return false;
+    }
+
+    simP->running = true;
+    return true;
+}
+
+void CalypsoSimulator_Stop(CalypsoSimulator_t *simP)
+{
+    if((simP == NULL) || (false == simP->running))
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&simP->mutex);
+    simP->stop = true;
+    pthread_mutex_unlock(&simP->mutex);
+    RxThreadEvent_Signal(simP->rxThreadEvent, RXTHREAD_EVENT_ABORT);
+    RxThreadEvent_Signal(simP->ioThreadEvent, RXTHREAD_EVENT_ABORT);
+
+    pthread_join(simP->thread_rx, NULL);
+    pthread_join(simP->thread_io, NULL);
+    RxThreadEvent_Destroy(simP->rxThreadEvent);
+    RxThreadEvent_Destroy(simP->ioThreadEvent);
+    simP->rxThreadEvent = -1;
+    simP->ioThreadEvent = -1;
+
+    pthread_mutex_lock(&simP->mutex);
+    CloseAll(simP);
+    pthread_mutex_unlock(&simP->mutex);
+    simP->running = false;
+}
+
+void CalypsoSimulator_Destroy(CalypsoSimulator_t *simP)
+{
+    if(simP == NULL)
+    {
+        return;
+    }
+    CalypsoSimulator_Stop(simP);
+    Transport_Destroy(simP->transportP);
+    pthread_mutex_destroy(&simP->mutex);
+    free(simP);
+}
+
+void CalypsoSimulator_GetStatistics(CalypsoSimulator_t *simP, CalypsoSimulator_Statistics_t *statisticsP)
+{
+    if((simP == NULL) || (statisticsP == NULL))
+    {
+        return;
+    }
+    pthread_mutex_lock(&simP->mutex);
+    *statisticsP = simP->statistics;
+    pthread_mutex_unlock(&simP->mutex);
+
+    statisticsP->cpuTime_us = 0;
+    if(simP->running)
+    {
+        statisticsP->cpuTime_us = GetThreadCpuTime_us(simP->thread_rx) + GetThreadCpuTime_us(simP->thread_io);
+    }
+}
+
+/**************************************
+ *         Static functions           *
+ **************************************/
+
+/* assemble the command lines of the driver and answer them */
+static void *rx_thread(void *pArgs)
+{
+    CalypsoSimulator_t *simP = pArgs;
+    uint8_t chunk[CSIM_RX_CHUNK_SIZE];
+    size_t got;
+    size_t i;
+
+    while(1)
+    {
+        Serial_RxWait_t rxWait = Transport_WaitForRxData(simP->transportP, simP->rxThreadEvent, -1);
+        if(rxWait == Serial_RxWait_Event)
+        {
+            if(RxThreadEvent_Read(simP->rxThreadEvent) & RXTHREAD_EVENT_ABORT)
+            {
+                return NULL;
+            }
+            continue;
+        }
+        else if(rxWait == Serial_RxWait_Error)
+        {
+            /* no driver attached to a pty created by the driver transport */
+            delay(10);
+            continue;
+        }
+        else if(rxWait != Serial_RxWait_Data)
+        {
+            continue;
+        }
+
+        while(Transport_ReadBytes(simP->transportP, chunk, sizeof(chunk), &got, 0) && (got > 0))
+        {
+            pthread_mutex_lock(&simP->mutex);
+            simP->statistics.bytesReceived += got;
+            pthread_mutex_unlock(&simP->mutex);
+
+            for(i = 0; i < got; i++)
+            {
+                if(chunk[i] != '\n')
+                {
+                    if(simP->rxLength < CSIM_LINE_MAX_SIZE - 1)
+                    {
+                        simP->rxLine[simP->rxLength++] = (char)chunk[i];
+                    }
+                    else
+                    {
+                        simP->rxOverflow = true;
+                    }
+                    continue;
+                }
+
+                /* line complete, the driver ends it with "\r\n" */
+                if((simP->rxLength > 0) && (simP->rxLine[simP->rxLength - 1] == '\r'))
+                {
+                    simP->rxLength--;
+                }
+                simP->rxLine[simP->rxLength] = '\0';
+                if(simP->rxOverflow)
+                {
+                    pthread_mutex_lock(&simP->mutex);
+                    simP->statistics.commands++;
+                    simP->statistics.errors++;
+                    Out(simP, "error:line,%d\r\n", CSIM_ERROR_INVALID);
+                    Flush(simP);
+                    GetTime(&simP->lastAnswer);
+                    pthread_mutex_unlock(&simP->mutex);
+                }
+                else if(simP->rxLength > 0)
+                {
+                    /* processing time of the module */
+                    if(simP->config.latency_us > 0)
+                    {
+                        usleep(simP->config.latency_us);
+                    }
+                    pthread_mutex_lock(&simP->mutex);
+                    HandleLine(simP, simP->rxLine);
+                    pthread_mutex_unlock(&simP->mutex);
+                }
+                simP->rxLength = 0;
+                simP->rxOverflow = false;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* wait on the sockets and MQTT connections and send the unsolicited lines */
+static void *io_thread(void *pArgs)
+{
+    CalypsoSimulator_t *simP = pArgs;
+    struct pollfd pfds[1 + CSIM_SOCKET_COUNT + CSIM_MQTT_COUNT];
+    int owners[1 + CSIM_SOCKET_COUNT + CSIM_MQTT_COUNT];     /* socket id, or -1 - MQTT index */
+    struct timespec now;
+    struct timespec holdUntil;
+    int count;
+    int timeout_ms;
+    int i;
+
+    while(1)
+    {
+        pthread_mutex_lock(&simP->mutex);
+        if(simP->stop)
+        {
+            pthread_mutex_unlock(&simP->mutex);
+            break;
+        }
+
+        GetTime(&now);
+        holdUntil = simP->lastAnswer;
+        AddTime(&holdUntil, CSIM_EVENT_HOLD_US);
+        if(IsBefore(&now, &holdUntil))
+        {
+            pthread_mutex_unlock(&simP->mutex);
+            struct timespec pause = { 0, CSIM_EVENT_HOLD_US * 1000L };
+            nanosleep(&pause, NULL);
+            continue;
+        }
+
+        timeout_ms = CSIM_IDLE_POLL_MS;
+        SendDueTimers(simP, &now, &timeout_ms);
+
+        count = 0;
+        pfds[count].fd = simP->ioThreadEvent;
+        pfds[count].events = POLLIN;
+        owners[count++] = 0;
+        for(i = 0; i < CSIM_SOCKET_COUNT; i++)
+        {
+            CSim_Socket_t *socketP = &simP->sockets[i];
+            if(socketP->used && (socketP->recvPending || socketP->acceptPending))
+            {
+                pfds[count].fd = socketP->fd;
+                pfds[count].events = POLLIN;
+                owners[count++] = i;
+            }
+        }
+        for(i = 0; i < CSIM_MQTT_COUNT; i++)
+        {
+            CSim_Mqtt_t *mqttP = &simP->mqtt[i];
+            if(mqttP->used && mqttP->connected)
+            {
+                if(mqttP->keepAlive_s > 0)
+                {
+                    /* ping at half of the keep alive interval */
+                    int idle_ms = DiffMs(&now, &mqttP->lastSent);
+                    int interval_ms = mqttP->keepAlive_s * 500;
+                    if(idle_ms >= interval_ms)
+                    {
+                        Mqtt_Send(mqttP, MQTT_PINGREQ, NULL, 0);
+                        idle_ms = 0;
+                    }
+                    if(interval_ms - idle_ms < timeout_ms)
+                    {
+                        timeout_ms = interval_ms - idle_ms;
+                    }
+                }
+                pfds[count].fd = mqttP->fd;
+                pfds[count].events = POLLIN;
+                owners[count++] = -1 - i;
+            }
+        }
+        pthread_mutex_unlock(&simP->mutex);
+
+        if(poll(pfds, count, timeout_ms) <= 0)
+        {
+            continue;
+        }
+        if(pfds[0].revents != 0)
+        {
+            if(RxThreadEvent_Read(simP->ioThreadEvent) & RXTHREAD_EVENT_ABORT)
+            {
+                break;
+            }
+        }
+
+        pthread_mutex_lock(&simP->mutex);
+        GetTime(&now);
+        holdUntil = simP->lastAnswer;
+        AddTime(&holdUntil, CSIM_EVENT_HOLD_US);
+        if(false == IsBefore(&now, &holdUntil))
+        {
+            for(i = 1; i < count; i++)
+            {
+                if(pfds[i].revents == 0)
+                {
+                    continue;
+                }
+                /* the socket or connection may have been closed or replaced meanwhile */
+                if(owners[i] >= 0)
+                {
+                    if(simP->sockets[owners[i]].used && (simP->sockets[owners[i]].fd == pfds[i].fd))
+                    {
+                        Socket_HandleReadable(simP, owners[i]);
+                    }
+                }
+                else
+                {
+                    CSim_Mqtt_t *mqttP = &simP->mqtt[-1 - owners[i]];
+                    if(mqttP->used && mqttP->connected && (mqttP->fd == pfds[i].fd))
+                    {
+                        Mqtt_HandleReadable(simP, -1 - owners[i]);
+                    }
+                }
+            }
+        }
+        pthread_mutex_unlock(&simP->mutex);
+    }
+    return NULL;
+}
+
+/* execute a command line and answer it, called with the mutex held */
+static void HandleLine(CalypsoSimulator_t *simP, char *lineP)
+{
+    char *nameP;
+    char *argsP;
+    size_t i;
+    int status = CSIM_ERROR_INVALID;
+
+    simP->statistics.commands++;
+
+    if(strcasecmp(lineP, "AT") == 0)
+    {
+        status = CSIM_STATUS_OK;
+        nameP = lineP;
+    }
+    else if(strncasecmp(lineP, "AT+", 3) == 0)
+    {
+        nameP = &lineP[3];
+        argsP = strchr(nameP, '=');
+        if(argsP != NULL)
+        {
+            *argsP++ = '\0';
+        }
+        for(i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+        {
+            if(strcasecmp(nameP, commands[i].name) == 0)
+            {
+                status = commands[i].handler(simP, argsP);
+                break;
+            }
+        }
+    }
+    else
+    {
+        nameP = lineP;
+    }
+
+    if(status == CSIM_STATUS_OK)
+    {
+        Out(simP, "OK\r\n");
+    }
+    else
+    {
+        /* drop the value lines of a failed command */
+        simP->outLength = 0;
+        simP->statistics.errors++;
+        Out(simP, "error:%.32s,%d\r\n", nameP, status);
+    }
+    Flush(simP);
+    GetTime(&simP->lastAnswer);
+}
+
+/* append to the line(s) being assembled */
+static void Out(CalypsoSimulator_t *simP, const char *formatP, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, formatP);
+    length = vsnprintf(&simP->out[simP->outLength], CSIM_OUT_MAX_SIZE - simP->outLength, formatP, args);
+    va_end(args);
+    if(length > 0)
+    {
+        simP->outLength += length;
+        if(simP->outLength >= CSIM_OUT_MAX_SIZE)
+        {
+            simP->outLength = CSIM_OUT_MAX_SIZE - 1;
+        }
+    }
+}
+
+/* append a payload as it is or Base64 encoded */
+static void OutData(CalypsoSimulator_t *simP, uint8_t format, const uint8_t *dataP, size_t length)
+{
+    if(format == CSIM_FORMAT_BASE64)
+    {
+        if(simP->outLength + (length + 2) / 3 * 4 < CSIM_OUT_MAX_SIZE)
+        {
+            simP->outLength += Base64Encode(dataP, length, &simP->out[simP->outLength]);
+        }
+    }
+    else if(simP->outLength + length < CSIM_OUT_MAX_SIZE)
+    {
+        memcpy(&simP->out[simP->outLength], dataP, length);
+        simP->outLength += length;
+    }
+}
+
+/* write the assembled line(s) to the pty */
+static void Flush(CalypsoSimulator_t *simP)
+{
+    if(simP->outLength > 0)
+    {
+        if(Transport_SendBytes(simP->transportP, (uint8_t *)simP->out, (uint16_t)simP->outLength))
+        {
+            simP->statistics.bytesSent += simP->outLength;
+        }
+        simP->outLength = 0;
+    }
+}
+
+/* send an unsolicited line */
+static void Event(CalypsoSimulator_t *simP, const char *formatP, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, formatP);
+    length = vsnprintf(&simP->out[simP->outLength], CSIM_OUT_MAX_SIZE - simP->outLength - 2, formatP, args);
+    va_end(args);
+    if(length > 0)
+    {
+        simP->outLength += length;
+        if(simP->outLength > CSIM_OUT_MAX_SIZE - 3)
+        {
+            simP->outLength = CSIM_OUT_MAX_SIZE - 3;
+        }
+    }
+    Out(simP, "\r\n");
+    Flush(simP);
+    simP->statistics.events++;
+}
+
+/* send an unsolicited line after 'delay_ms', called with the mutex held */
+static void AddTimer(CalypsoSimulator_t *simP, unsigned int delay_ms, const char *formatP, ...)
+{
+    va_list args;
+    int i;
+
+    for(i = 0; i < CSIM_TIMER_COUNT; i++)
+    {
+        if(false == simP->timers[i].used)
+        {
+            break;
+        }
+    }
+    if(i == CSIM_TIMER_COUNT)
+    {
+        return;
+    }
+
+    va_start(args, formatP);
+    vsnprintf(simP->timers[i].line, CSIM_TIMER_LINE_SIZE, formatP, args);
+    va_end(args);
+    GetTime(&simP->timers[i].due);
+    AddTime(&simP->timers[i].due, (uint64_t)delay_ms * 1000);
+    simP->timers[i].order = simP->order++;
+    simP->timers[i].used = true;
+    WakeIoThread(simP);
+}
+
+/* send the delayed lines that are due and reduce the timeout to the next due time */
+static void SendDueTimers(CalypsoSimulator_t *simP, const struct timespec *nowP, int *timeoutP)
+{
+    while(1)
+    {
+        CSim_Timer_t *nextP = NULL;
+        int i;
+
+        for(i = 0; i < CSIM_TIMER_COUNT; i++)
+        {
+            CSim_Timer_t *timerP = &simP->timers[i];
+            if(timerP->used && ((nextP == NULL) || IsBefore(&timerP->due, &nextP->due) ||
+                                ((timerP->due.tv_sec == nextP->due.tv_sec) && (timerP->due.tv_nsec == nextP->due.tv_nsec) && (timerP->order < nextP->order))))
+            {
+                nextP = timerP;
+            }
+        }
+        if(nextP == NULL)
+        {
+            return;
+        }
+        if(IsBefore(nowP, &nextP->due))
+        {
+            int due_ms = DiffMs(&nextP->due, nowP) + 1;
+            if(due_ms < *timeoutP)
+            {
+                *timeoutP = due_ms;
+            }
+            return;
+        }
+        Event(simP, "%s", nextP->line);
+        nextP->used = false;
+    }
+}
+
+/* make the IO thread wait on the changed sockets and timers */
+static void WakeIoThread(CalypsoSimulator_t *simP)
+{
+    if(simP->ioThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(simP->ioThreadEvent, RXTHREAD_EVENT_RESET);
+    }
+}
+
+/* (re)start the module, called with the mutex held or before the threads run */
+static void Boot(CalypsoSimulator_t *simP)
+{
+    CloseAll(simP);
+    memset(simP->timers, 0, sizeof(simP->timers));
+    simP->scanned = false;
+    simP->wlanConnected = false;
+    AddTimer(simP, simP->config.boot_ms, CSIM_STARTUP_EVENT);
+}
+
+/* close the sockets, MQTT connections and files of the module, called with the mutex held */
+static void CloseAll(CalypsoSimulator_t *simP)
+{
+    int i;
+
+    for(i = 0; i < CSIM_SOCKET_COUNT; i++)
+    {
+        if(simP->sockets[i].used)
+        {
+            CloseSocket(&simP->sockets[i]);
+        }
+    }
+    for(i = 0; i < CSIM_MQTT_COUNT; i++)
+    {
+        if(simP->mqtt[i].used)
+        {
+            Mqtt_Close(simP, &simP->mqtt[i], false);
+            simP->mqtt[i].used = false;
+        }
+    }
+    for(i = 0; i < CSIM_FILE_COUNT; i++)
+    {
+        if(simP->files[i].used)
+        {
+            close(simP->files[i].fd);
+            simP->files[i].fd = -1;
+            simP->files[i].used = false;
+        }
+    }
+    WakeIoThread(simP);
+}
+
+static void ResetSettings(CalypsoSimulator_t *simP)
+{
+    size_t i;
+
+    memset(simP->settings, 0, sizeof(simP->settings));
+    memset(simP->profiles, 0, sizeof(simP->profiles));
+    simP->timeOffset = 0;
+    for(i = 0; i < sizeof(defaultSettings) / sizeof(defaultSettings[0]); i++)
+    {
+        simP->settings[i] = defaultSettings[i];
+    }
+}
+
+static const char *GetSetting(CalypsoSimulator_t *simP, const char *prefixP, const char *keyP)
+{
+    char key[64];
+    int i;
+
+    snprintf(key, sizeof(key), "%s:%s", prefixP, keyP);
+    for(i = 0; i < CSIM_SETTING_COUNT; i++)
+    {
+        if(strcasecmp(simP->settings[i].key, key) == 0)
+        {
+            return simP->settings[i].value;
+        }
+    }
+    return NULL;
+}
+
+static bool SetSetting(CalypsoSimulator_t *simP, const char *prefixP, const char *keyP, const char *valueP)
+{
+    char key[64];
+    int i;
+    int freeIndex = -1;
+
+    snprintf(key, sizeof(key), "%s:%s", prefixP, keyP);
+    for(i = 0; i < CSIM_SETTING_COUNT; i++)
+    {
+        if(strcasecmp(simP->settings[i].key, key) == 0)
+        {
+            break;
+        }
+        if((freeIndex < 0) && (simP->settings[i].key[0] == '\0'))
+        {
+            freeIndex = i;
+        }
+    }
+    if(i == CSIM_SETTING_COUNT)
+    {
+        if(freeIndex < 0)
+        {
+            return false;
+        }
+        i = freeIndex;
+        snprintf(simP->settings[i].key, sizeof(simP->settings[i].key), "%s", key);
+    }
+    snprintf(simP->settings[i].value, sizeof(simP->settings[i].value), "%s", (valueP != NULL) ? valueP : "");
+    return true;
+}
+
+/* split the next argument off the argument list, NULL if there is none left */
+static char *NextArgument(char **argsPP)
+{
+    char *argP = *argsPP;
+    char *delimP;
+
+    if(argP == NULL)
+    {
+        return NULL;
+    }
+    delimP = strchr(argP, ',');
+    if(delimP != NULL)
+    {
+        *delimP = '\0';
+        *argsPP = delimP + 1;
+    }
+    else
+    {
+        *argsPP = NULL;
+    }
+    return argP;
+}
+
+static bool ParseInt(const char *textP, long min, long max, long *valueP)
+{
+    char *endP;
+    long value;
+
+    if((textP == NULL) || (*textP == '\0'))
+    {
+        return false;
+    }
+    value = strtol(textP, &endP, 0);
+    if((*endP != '\0') || (value < min) || (value > max))
+    {
+        return false;
+    }
+    *valueP = value;
+    return true;
+}
+
+/* decode the payload argument of a command into simP->data */
+static bool ParseData(CalypsoSimulator_t *simP, const char *textP, long format, long length, size_t *dataLengthP)
+{
+    size_t textLength;
+
+    if(textP == NULL)
+    {
+        textP = "";
+    }
+    textLength = strlen(textP);
+    if(((size_t)length < textLength) && (format != CSIM_FORMAT_BASE64))
+    {
+        textLength = length;
+    }
+    if(format == CSIM_FORMAT_BASE64)
+    {
+        return Base64Decode(textP, simP->data, sizeof(simP->data), dataLengthP);
+    }
+    memcpy(simP->data, textP, textLength);
+    *dataLengthP = textLength;
+    return true;
+}
+
+static size_t Base64Encode(const uint8_t *dataP, size_t length, char *textP)
+{
+    size_t i;
+    size_t j = 0;
+
+    for(i = 0; i < length; i += 3)
+    {
+        uint32_t value = (uint32_t)dataP[i] << 16;
+        if(i + 1 < length)
+        {
+            value |= (uint32_t)dataP[i + 1] << 8;
+        }
+        if(i + 2 < length)
+        {
+            value |= dataP[i + 2];
+        }
+        textP[j++] = base64Table[(value >> 18) & 0x3F];
+        textP[j++] = base64Table[(value >> 12) & 0x3F];
+        textP[j++] = (i + 1 < length) ? base64Table[(value >> 6) & 0x3F] : '=';
+        textP[j++] = (i + 2 < length) ? base64Table[value & 0x3F] : '=';
+    }
+    textP[j] = '\0';
+    return j;
+}
+
+static bool Base64Decode(const char *textP, uint8_t *dataP, size_t max, size_t *lengthP)
+{
+    uint32_t value = 0;
+    int bits = 0;
+    size_t length = 0;
+
+    for(; (*textP != '\0') && (*textP != '='); textP++)
+    {
+        const char *posP = strchr(base64Table, *textP);
+        if(posP == NULL)
+        {
+            return false;
+        }
+        value = (value << 6) | (uint32_t)(posP - base64Table);
+        bits += 6;
+        if(bits >= 8)
+        {
+            bits -= 8;
+            if(length == max)
+            {
+                return false;
+            }
+            dataP[length++] = (uint8_t)(value >> bits);
+        }
+    }
+    *lengthP = length;
+    return true;
+}
+
+/* socket address of the arguments [family],[port],[address] */
+static bool ParseAddress(const char *familyP, const char *portP, const char *addressP, struct sockaddr_storage *addrP, socklen_t *addrLengthP)
+{
+    long port;
+
+    memset(addrP, 0, sizeof(struct sockaddr_storage));
+    if((familyP == NULL) || (addressP == NULL) || (false == ParseInt(portP, 0, 65535, &port)))
+    {
+        return false;
+    }
+    if(strcasecmp(familyP, "INET") == 0)
+    {
+        struct sockaddr_in *addr4P = (struct sockaddr_in *)addrP;
+        addr4P->sin_family = AF_INET;
+        addr4P->sin_port = htons((uint16_t)port);
+        *addrLengthP = sizeof(struct sockaddr_in);
+        return (inet_pton(AF_INET, addressP, &addr4P->sin_addr) == 1);
+    }
+    if(strcasecmp(familyP, "INET6") == 0)
+    {
+        struct sockaddr_in6 *addr6P = (struct sockaddr_in6 *)addrP;
+        addr6P->sin6_family = AF_INET6;
+        addr6P->sin6_port = htons((uint16_t)port);
+        *addrLengthP = sizeof(struct sockaddr_in6);
+        return (inet_pton(AF_INET6, addressP, &addr6P->sin6_addr) == 1);
+    }
+    return false;
+}
+
+/* connect a blocking socket, but give up after 'timeout_ms' */
+static int ConnectWithTimeout(int fd, const struct sockaddr *addrP, socklen_t addrLength, int timeout_ms)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    int error = 0;
+    socklen_t errorLength = sizeof(error);
+
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    if(connect(fd, addrP, addrLength) != 0)
+    {
+        error = errno;
+        if(error == EINPROGRESS)
+        {
+            struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+            if(poll(&pfd, 1, timeout_ms) <= 0)
+            {
+                error = ETIMEDOUT;
+            }
+            else if(getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &errorLength) != 0)
+            {
+                error = errno;
+            }
+        }
+    }
+    fcntl(fd, F_SETFL, flags);
+    return -error;
+}
+
+static CSim_Socket_t *GetSocket(CalypsoSimulator_t *simP, const char *idP)
+{
+    long id;
+
+    if(ParseInt(idP, 0, CSIM_SOCKET_COUNT - 1, &id) && simP->sockets[id].used)
+    {
+        return &simP->sockets[id];
+    }
+    return NULL;
+}
+
+static void CloseSocket(CSim_Socket_t *socketP)
+{
+    close(socketP->fd);
+    memset(socketP, 0, sizeof(CSim_Socket_t));
+    socketP->fd = -1;
+}
+
+/* a socket waited on by the IO thread is readable, called with the mutex held */
+static void Socket_HandleReadable(CalypsoSimulator_t *simP, int id)
+{
+    CSim_Socket_t *socketP = &simP->sockets[id];
+    struct sockaddr_storage addr;
+    socklen_t addrLength = sizeof(addr);
+    char address[INET6_ADDRSTRLEN];
+    uint16_t port;
+    ssize_t length;
+
+    if(socketP->acceptPending)
+    {
+        int fd = accept(socketP->fd, (struct sockaddr *)&addr, &addrLength);
+        int newId;
+
+        if(fd < 0)
+        {
+            return;
+        }
+        for(newId = 0; newId < CSIM_SOCKET_COUNT; newId++)
+        {
+            if(false == simP->sockets[newId].used)
+            {
+                break;
+            }
+        }
+        if(newId == CSIM_SOCKET_COUNT)
+        {
+            /* no socket left, refuse the client */
+            close(fd);
+            return;
+        }
+        socketP->acceptPending = false;
+        simP->sockets[newId].used = true;
+        simP->sockets[newId].fd = fd;
+        simP->sockets[newId].family = socketP->family;
+        simP->sockets[newId].stream = true;
+
+        if(addr.ss_family == AF_INET6)
+        {
+            inet_ntop(AF_INET6, &((struct sockaddr_in6 *)&addr)->sin6_addr, address, sizeof(address));
+            port = ntohs(((struct sockaddr_in6 *)&addr)->sin6_port);
+        }
+        else
+        {
+            inet_ntop(AF_INET, &((struct sockaddr_in *)&addr)->sin_addr, address, sizeof(address));
+            port = ntohs(((struct sockaddr_in *)&addr)->sin_port);
+        }
+        Event(simP, "+accept:%d,%s,%u,%s", newId, (addr.ss_family == AF_INET6) ? "INET6" : "INET", port, address);
+        return;
+    }
+
+    if(false == socketP->recvPending)
+    {
+        return;
+    }
+    if(socketP->recvFrom)
+    {
+        length = recvfrom(socketP->fd, simP->data, socketP->recvLength, MSG_DONTWAIT, (struct sockaddr *)&addr, &addrLength);
+    }
+    else
+    {
+        length = recv(socketP->fd, simP->data, socketP->recvLength, MSG_DONTWAIT);
+    }
+    if((length < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)))
+    {
+        return;
+    }
+    if(length <= 0)
+    {
+        /* the peer closed the connection, report an empty receive */
+        length = 0;
+        socketP->peerClosed = true;
+    }
+
+    socketP->recvPending = false;
+    simP->statistics.socketBytesReceived += length;
+    Out(simP, "%s:%d,%u,%u,", socketP->recvFrom ? "+recvfrom" : "+recv", id, socketP->format,
+        (socketP->format == CSIM_FORMAT_BASE64) ? (unsigned int)((length + 2) / 3 * 4) : (unsigned int)length);
+    OutData(simP, socketP->format, simP->data, length);
+    Out(simP, "\r\n");
+    Flush(simP);
+    simP->statistics.events++;
+}
+
+static CSim_Mqtt_t *GetMqtt(CalypsoSimulator_t *simP, const char *indexP)
+{
+    long index;
+
+    if(ParseInt(indexP, 0, CSIM_MQTT_COUNT - 1, &index) && simP->mqtt[index].used)
+    {
+        return &simP->mqtt[index];
+    }
+    return NULL;
+}
+
+/* send an MQTT control packet, returns 0 or -errno */
+static int Mqtt_Send(CSim_Mqtt_t *mqttP, uint8_t type, const uint8_t *bodyP, size_t length)
+{
+    uint8_t header[5];
+    size_t headerLength = 1;
+    size_t remaining = length;
+    struct iovec iov[2];
+    struct msghdr msg;
+
+    header[0] = type;
+    do
+    {
+        header[headerLength] = remaining & 0x7F;
+        remaining >>= 7;
+        if(remaining > 0)
+        {
+            header[headerLength] |= 0x80;
+        }
+        headerLength++;
+    }
+    while((remaining > 0) && (headerLength < sizeof(header)));
+
+    iov[0].iov_base = header;
+    iov[0].iov_len = headerLength;
+    iov[1].iov_base = (void *)bodyP;
+    iov[1].iov_len = length;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = (length > 0) ? 2 : 1;
+    if(sendmsg(mqttP->fd, &msg, MSG_NOSIGNAL) != (ssize_t)(headerLength + length))
+    {
+        return -EIO;
+    }
+    GetTime(&mqttP->lastSent);
+    return CSIM_STATUS_OK;
+}
+
+/* put a length prefixed UTF-8 string, returns the bytes used */
+static size_t Mqtt_PutString(uint8_t *bufferP, const char *textP, size_t length)
+{
+    bufferP[0] = (uint8_t)(length >> 8);
+    bufferP[1] = (uint8_t)length;
+    memcpy(&bufferP[2], textP, length);
+    return length + 2;
+}
+
+static void Mqtt_Close(CalypsoSimulator_t *simP, CSim_Mqtt_t *mqttP, bool event)
+{
+    if(mqttP->fd >= 0)
+    {
+        close(mqttP->fd);
+        mqttP->fd = -1;
+    }
+    if(mqttP->connected && event)
+    {
+        Event(simP, "+eventmqtt:disconnect");
+    }
+    mqttP->connected = false;
+    mqttP->rxFill = 0;
+}
+
+/* an MQTT connection waited on by the IO thread is readable, called with the mutex held */
+static void Mqtt_HandleReadable(CalypsoSimulator_t *simP, int index)
+{
+    CSim_Mqtt_t *mqttP = &simP->mqtt[index];
+    ssize_t length;
+    size_t offset = 0;
+
+    length = recv(mqttP->fd, &mqttP->rxBuffer[mqttP->rxFill], CSIM_MQTT_BUFFER_SIZE - mqttP->rxFill, MSG_DONTWAIT);
+    if((length < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)))
+    {
+        return;
+    }
+    if(length <= 0)
+    {
+        Mqtt_Close(simP, mqttP, true);
+        return;
+    }
+    mqttP->rxFill += length;
+
+    /* fixed header: type and flags, remaining length in 1 to 4 bytes */
+    while(mqttP->rxFill - offset >= 2)
+    {
+        size_t remaining = 0;
+        size_t headerLength = 1;
+        int shift = 0;
+        bool complete = false;
+
+        while(offset + headerLength < mqttP->rxFill)
+        {
+            uint8_t byte = mqttP->rxBuffer[offset + headerLength++];
+            remaining |= (size_t)(byte & 0x7F) << shift;
+            shift += 7;
+            if((byte & 0x80) == 0)
+            {
+                complete = true;
+                break;
+            }
+            if(headerLength > 4)
+            {
+                Mqtt_Close(simP, mqttP, true);
+                return;
+            }
+        }
+        if(false == complete)
+        {
+            break;
+        }
+        if(headerLength + remaining > CSIM_MQTT_BUFFER_SIZE)
+        {
+            /* packet does not fit into the buffer */
+            Mqtt_Close(simP, mqttP, true);
+            return;
+        }
+        if(offset + headerLength + remaining > mqttP->rxFill)
+        {
+            break;
+        }
+        Mqtt_HandlePacket(simP, mqttP, mqttP->rxBuffer[offset], &mqttP->rxBuffer[offset + headerLength], remaining);
+        if(false == mqttP->connected)
+        {
+            return;
+        }
+        offset += headerLength + remaining;
+    }
+    memmove(mqttP->rxBuffer, &mqttP->rxBuffer[offset], mqttP->rxFill - offset);
+    mqttP->rxFill -= offset;
+}
+
+static void Mqtt_HandlePacket(CalypsoSimulator_t *simP, CSim_Mqtt_t *mqttP, uint8_t type, const uint8_t *bodyP, size_t length)
+{
+    switch(type & 0xF0)
+    {
+    case MQTT_PUBLISH:
+    {
+        uint8_t qos = (type >> 1) & 0x03;
+        size_t topicLength;
+        size_t position;
+        size_t payloadLength;
+
+        if(length < 2)
+        {
+            break;
+        }
+        topicLength = ((size_t)bodyP[0] << 8) | bodyP[1];
+        position = 2 + topicLength + ((qos > 0) ? 2 : 0);
+        if(position > length)
+        {
+            break;
+        }
+        if(qos > 0)
+        {
+            /* acknowledge with the packet identifier following the topic */
+            Mqtt_Send(mqttP, (qos == 1) ? MQTT_PUBACK : MQTT_PUBREC, &bodyP[2 + topicLength], 2);
+        }
+        payloadLength = length - position;
+        if(payloadLength > CSIM_MAX_DATA_LENGTH)
+        {
+            payloadLength = CSIM_MAX_DATA_LENGTH;
+        }
+        simP->statistics.mqttReceived++;
+        Out(simP, "+eventmqtt:recv,%.*s,%u,%u,%u,%u,%u,", (int)((topicLength > 128) ? 128 : topicLength), (const char *)&bodyP[2],
+            qos, type & 0x01, (type >> 3) & 0x01, mqttP->format,
+            (mqttP->format == CSIM_FORMAT_BASE64) ? (unsigned int)((payloadLength + 2) / 3 * 4) : (unsigned int)payloadLength);
+        OutData(simP, mqttP->format, &bodyP[position], payloadLength);
+        Out(simP, "\r\n");
+        Flush(simP);
+        simP->statistics.events++;
+        break;
+    }
+    case MQTT_PUBACK:
+    {
+        Event(simP, "+eventmqtt:operation,PUBACK,0");
+        break;
+    }
+    case MQTT_PUBREC:
+    {
+        if(length >= 2)
+        {
+            Mqtt_Send(mqttP, MQTT_PUBREL, bodyP, 2);
+        }
+        break;
+    }
+    case (MQTT_PUBREL & 0xF0):
+    {
+        if(length >= 2)
+        {
+            Mqtt_Send(mqttP, MQTT_PUBCOMP, bodyP, 2);
+        }
+        break;
+    }
+    case MQTT_PUBCOMP:
+    {
+        Event(simP, "+eventmqtt:operation,PUBCOMP,0");
+        break;
+    }
+    case MQTT_SUBACK:
+    {
+        Event(simP, "+eventmqtt:operation,SUBACK,%u", (length > 2) ? bodyP[2] : 0x80);
+        break;
+    }
+    case MQTT_UNSUBACK:
+    {
+        Event(simP, "+eventmqtt:operation,UNSUBACK,0");
+        break;
+    }
+    default:
+    {
+        /* PINGRESP */
+        break;
+    }
+    }
+}
+
+static CSim_File_t *GetFile(CalypsoSimulator_t *simP, const char *idP)
+{
+    long id;
+    int i;
+
+    if(ParseInt(idP, 0, UINT32_MAX, &id))
+    {
+        for(i = 0; i < CSIM_FILE_COUNT; i++)
+        {
+            if(simP->files[i].used && (simP->files[i].id == (uint32_t)id))
+            {
+                return &simP->files[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+/* host path of a file of the module, the directories of the module are flattened */
+static bool FilePath(CalypsoSimulator_t *simP, const char *nameP, char *pathP, size_t size)
+{
+    char *p;
+    int length;
+
+    while(*nameP == '/')
+    {
+        nameP++;
+    }
+    if((*nameP == '\0') || (strcmp(nameP, ".") == 0) || (strcmp(nameP, "..") == 0))
+    {
+        return false;
+    }
+    length = snprintf(pathP, size, "%s/", simP->config.fileRoot);
+    if((length < 0) || ((size_t)length + strlen(nameP) >= size))
+    {
+        return false;
+    }
+    p = &pathP[length];
+    strcpy(p, nameP);
+    for(; *p != '\0'; p++)
+    {
+        if(*p == '/')
+        {
+            *p = '_';
+        }
+    }
+    return true;
+}
+
+static void GetTime(struct timespec *timeP)
+{
+    clock_gettime(CLOCK_MONOTONIC, timeP);
+}
+
+static void AddTime(struct timespec *timeP, uint64_t us)
+{
+    timeP->tv_sec += us / 1000000;
+    timeP->tv_nsec += (long)(us % 1000000) * 1000;
+    if(timeP->tv_nsec >= 1000000000L)
+    {
+        timeP->tv_sec++;
+        timeP->tv_nsec -= 1000000000L;
+    }
+}
+
+static bool IsBefore(const struct timespec *aP, const struct timespec *bP)
+{
+    return (aP->tv_sec < bP->tv_sec) || ((aP->tv_sec == bP->tv_sec) && (aP->tv_nsec < bP->tv_nsec));
+}
+
+static int DiffMs(const struct timespec *laterP, const struct timespec *earlierP)
+{
+    return (int)((laterP->tv_sec - earlierP->tv_sec) * 1000 + (laterP->tv_nsec - earlierP->tv_nsec) / 1000000);
+}
+
+/**************************************
+ *   Command handlers, ATDevice.c     *
+ **************************************/
+
+static int Device_Ok(CalypsoSimulator_t *simP, char *argsP)
+{
+    return CSIM_STATUS_OK;
+}
+
+static int Device_Reboot(CalypsoSimulator_t *simP, char *argsP)
+{
+    Boot(simP);
+    return CSIM_STATUS_OK;
+}
+
+static int Device_FactoryReset(CalypsoSimulator_t *simP, char *argsP)
+{
+    /* the files on the host are kept */
+    ResetSettings(simP);
+    Boot(simP);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+get=[id],[option] */
+static int Device_Get(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *idP = NextArgument(&argsP);
+    char *optionP = NextArgument(&argsP);
+    char key[48];
+    const char *valueP;
+
+    if((idP == NULL) || (optionP == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if((strcasecmp(idP, "general") == 0) && (strcasecmp(optionP, "time") == 0))
+    {
+        time_t now = time(NULL) + simP->timeOffset;
+        struct tm tm;
+        gmtime_r(&now, &tm);
+        Out(simP, "+get:%d,%d,%d,%d,%d,%d\r\n", tm.tm_hour, tm.tm_min, tm.tm_sec, tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900);
+        return CSIM_STATUS_OK;
+    }
+    snprintf(key, sizeof(key), "%s,%s", idP, optionP);
+    valueP = GetSetting(simP, "get", key);
+    if(valueP == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    Out(simP, "+get:%s\r\n", valueP);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+set=[id],[option],[values] */
+static int Device_Set(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *idP = NextArgument(&argsP);
+    char *optionP = NextArgument(&argsP);
+    char key[48];
+
+    if((idP == NULL) || (optionP == NULL) || (argsP == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if((strcasecmp(idP, "general") == 0) && (strcasecmp(optionP, "time") == 0))
+    {
+        struct tm tm;
+        long values[6];
+        int i;
+
+        memset(&tm, 0, sizeof(tm));
+        for(i = 0; i < 6; i++)
+        {
+            if(false == ParseInt(NextArgument(&argsP), 0, 9999, &values[i]))
+            {
+                return CSIM_ERROR_INVALID;
+            }
+        }
+        tm.tm_hour = values[0];
+        tm.tm_min = values[1];
+        tm.tm_sec = values[2];
+        tm.tm_mday = values[3];
+        tm.tm_mon = values[4] - 1;
+        tm.tm_year = values[5] - 1900;
+        simP->timeOffset = timegm(&tm) - time(NULL);
+        return CSIM_STATUS_OK;
+    }
+    snprintf(key, sizeof(key), "%s,%s", idP, optionP);
+    if(GetSetting(simP, "get", key) == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    return SetSetting(simP, "get", key, argsP) ? CSIM_STATUS_OK : CSIM_ERROR_INVALID;
+}
+
+/**************************************
+ *   Command handlers, ATWLAN.c       *
+ **************************************/
+
+static int Wlan_SetMode(CalypsoSimulator_t *simP, char *argsP)
+{
+    return SetSetting(simP, "wlan", "mode", argsP) ? CSIM_STATUS_OK : CSIM_ERROR_INVALID;
+}
+
+/* AT+wlanScan=[index],[count], the first scan only starts scanning and fails */
+static int Wlan_Scan(CalypsoSimulator_t *simP, char *argsP)
+{
+    long index, count;
+    long i;
+
+    if((false == ParseInt(NextArgument(&argsP), 0, 29, &index)) || (false == ParseInt(NextArgument(&argsP), 0, 30, &count)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(false == simP->scanned)
+    {
+        simP->scanned = true;
+        return -EAGAIN;
+    }
+    for(i = index; (i < index + count) && (i < (long)(sizeof(scanEntries) / sizeof(scanEntries[0]))); i++)
+    {
+        Out(simP, "+wlanscan:%s\r\n", scanEntries[i]);
+    }
+    return CSIM_STATUS_OK;
+}
+
+/* AT+wlanConnect=[SSID],[BSSID],[SecurityType],[SecurityKey],[ExtUser],[ExtAnonUser],[EapMethod] */
+static int Wlan_Connect(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *ssidP = NextArgument(&argsP);
+
+    if((ssidP == NULL) || (*ssidP == '\0') || (strlen(ssidP) >= sizeof(simP->ssid)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    strcpy(simP->ssid, ssidP);
+    simP->wlanConnected = true;
+    AddTimer(simP, simP->config.connect_ms, "+eventwlan:connect,%s," CSIM_BSSID, simP->ssid);
+    AddTimer(simP, simP->config.connect_ms, "+eventnetapp:ipv4_acquired,%s,%s,%s", simP->config.ipAddress, simP->config.ipAddress, simP->config.ipAddress);
+    return CSIM_STATUS_OK;
+}
+
+static int Wlan_Disconnect(CalypsoSimulator_t *simP, char *argsP)
+{
+    if(simP->wlanConnected)
+    {
+        simP->wlanConnected = false;
+        AddTimer(simP, 0, "+eventwlan:disconnect,%s," CSIM_BSSID ",0", simP->ssid);
+    }
+    return CSIM_STATUS_OK;
+}
+
+/* AT+wlanProfileAdd=[SSID],[BSSID],[SecurityType],[SecurityKey],[ExtUser],[ExtAnonUser],[EapMethod],[priority] */
+static int Wlan_ProfileAdd(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *priorityP;
+    long priority;
+    int i;
+
+    if((argsP == NULL) || ((priorityP = strrchr(argsP, ',')) == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    *priorityP++ = '\0';
+    if((false == ParseInt(priorityP, 0, 15, &priority)) || (strlen(argsP) >= sizeof(simP->profiles[0].arguments)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    for(i = 0; i < CSIM_PROFILE_COUNT; i++)
+    {
+        if(false == simP->profiles[i].used)
+        {
+            simP->profiles[i].used = true;
+            strcpy(simP->profiles[i].arguments, argsP);
+            simP->profiles[i].priority = priority;
+            Out(simP, "+wlanprofileadd:%d\r\n", i);
+            return CSIM_STATUS_OK;
+        }
+    }
+    return -ENOSPC;
+}
+
+static int Wlan_ProfileGet(CalypsoSimulator_t *simP, char *argsP)
+{
+    long index;
+
+    if((false == ParseInt(NextArgument(&argsP), 0, CSIM_PROFILE_COUNT - 1, &index)) || (false == simP->profiles[index].used))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    Out(simP, "+wlanprofileget:%s,%u\r\n", simP->profiles[index].arguments, simP->profiles[index].priority);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+wlanProfileDel=[index], 255 deletes all profiles */
+static int Wlan_ProfileDel(CalypsoSimulator_t *simP, char *argsP)
+{
+    long index;
+
+    if(false == ParseInt(NextArgument(&argsP), 0, 255, &index))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(index == 255)
+    {
+        memset(simP->profiles, 0, sizeof(simP->profiles));
+        return CSIM_STATUS_OK;
+    }
+    if((index >= CSIM_PROFILE_COUNT) || (false == simP->profiles[index].used))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    simP->profiles[index].used = false;
+    return CSIM_STATUS_OK;
+}
+
+/* AT+wlanGet=[id],[option] */
+static int Wlan_Get(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *idP = NextArgument(&argsP);
+    char *optionP = NextArgument(&argsP);
+    char key[48];
+    const char *valueP;
+
+    if((idP == NULL) || (optionP == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    snprintf(key, sizeof(key), "%s,%s", idP, optionP);
+    valueP = GetSetting(simP, "wlan", key);
+    if(valueP == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    Out(simP, "+wlanget:%s\r\n", valueP);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+wlanSet=[id],[option],[values] */
+static int Wlan_Set(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *idP = NextArgument(&argsP);
+    char *optionP = NextArgument(&argsP);
+    char key[48];
+
+    if((idP == NULL) || (optionP == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    snprintf(key, sizeof(key), "%s,%s", idP, optionP);
+    if(GetSetting(simP, "wlan", key) == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    return SetSetting(simP, "wlan", key, argsP) ? CSIM_STATUS_OK : CSIM_ERROR_INVALID;
+}
+
+/* AT+wlanPolicySet=[id],[option],[value] */
+static int Wlan_PolicySet(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *idP = NextArgument(&argsP);
+
+    if((idP == NULL) || (argsP == NULL) || (GetSetting(simP, "policy", idP) == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    return SetSetting(simP, "policy", idP, argsP) ? CSIM_STATUS_OK : CSIM_ERROR_INVALID;
+}
+
+static int Wlan_PolicyGet(CalypsoSimulator_t *simP, char *argsP)
+{
+    const char *valueP = (argsP != NULL) ? GetSetting(simP, "policy", argsP) : NULL;
+
+    if(valueP == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    Out(simP, "+wlanpolicyget:%s\r\n", valueP);
+    return CSIM_STATUS_OK;
+}
+
+/**************************************
+ *   Command handlers, ATSocket.c     *
+ **************************************/
+
+/* AT+socket=[family],[type],[protocol] */
+static int Socket_Create(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *familyP = NextArgument(&argsP);
+    char *typeP = NextArgument(&argsP);
+    char *protocolP = NextArgument(&argsP);
+    CSim_Socket_t *socketP;
+    struct timeval timeout = { 0, CSIM_SEND_TIMEOUT_MS * 1000 };
+    int family, id;
+    bool stream;
+
+    if((familyP == NULL) || (typeP == NULL) || (protocolP == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(strcasecmp(familyP, "INET") == 0)
+    {
+        family = AF_INET;
+    }
+    else if(strcasecmp(familyP, "INET6") == 0)
+    {
+        family = AF_INET6;
+    }
+    else
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(strcasecmp(typeP, "STREAM") == 0)
+    {
+        /* SEC falls back to plain TCP */
+        stream = true;
+    }
+    else if((strcasecmp(typeP, "DGRAM") == 0) && (strcasecmp(protocolP, "UDP") == 0))
+    {
+        stream = false;
+    }
+    else
+    {
+        return CSIM_ERROR_INVALID;
+    }
+
+    for(id = 0; id < CSIM_SOCKET_COUNT; id++)
+    {
+        if(false == simP->sockets[id].used)
+        {
+            break;
+        }
+    }
+    if(id == CSIM_SOCKET_COUNT)
+    {
+        return -ENFILE;
+    }
+    socketP = &simP->sockets[id];
+    socketP->fd = socket(family, (stream ? SOCK_STREAM : SOCK_DGRAM) | SOCK_CLOEXEC, 0);
+    if(socketP->fd < 0)
+    {
+        return -errno;
+    }
+    setsockopt(socketP->fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    socketP->used = true;
+    socketP->family = family;
+    socketP->stream = stream;
+    Out(simP, "+socket:%d\r\n", id);
+    return CSIM_STATUS_OK;
+}
+
+static int Socket_Close(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+
+    if(socketP == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    CloseSocket(socketP);
+    WakeIoThread(simP);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+bind=[id],[family],[port],[address] */
+static int Socket_Bind(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+    char *familyP = NextArgument(&argsP);
+    char *portP = NextArgument(&argsP);
+    struct sockaddr_storage addr;
+    socklen_t addrLength;
+    int on = 1;
+
+    if((socketP == NULL) || (false == ParseAddress(familyP, portP, NextArgument(&argsP), &addr, &addrLength)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    setsockopt(socketP->fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    return (bind(socketP->fd, (struct sockaddr *)&addr, addrLength) == 0) ? CSIM_STATUS_OK : -errno;
+}
+
+/* AT+listen=[id],[backlog] */
+static int Socket_Listen(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+    long backlog;
+
+    if((socketP == NULL) || (false == socketP->stream) || (false == ParseInt(NextArgument(&argsP), 0, 65535, &backlog)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    return (listen(socketP->fd, (int)backlog) == 0) ? CSIM_STATUS_OK : -errno;
+}
+
+/* AT+connect=[id],[family],[port],[address] */
+static int Socket_Connect(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+    char *familyP = NextArgument(&argsP);
+    char *portP = NextArgument(&argsP);
+    struct sockaddr_storage addr;
+    socklen_t addrLength;
+
+    if((socketP == NULL) || (false == ParseAddress(familyP, portP, NextArgument(&argsP), &addr, &addrLength)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    return ConnectWithTimeout(socketP->fd, (struct sockaddr *)&addr, addrLength, CSIM_CONNECT_TIMEOUT_MS);
+}
+
+/* AT+accept=[id],[family], +accept is sent when a client connects */
+static int Socket_Accept(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+
+    if((socketP == NULL) || (false == socketP->stream))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    socketP->acceptPending = true;
+    WakeIoThread(simP);
+    return CSIM_STATUS_OK;
+}
+
+/* arm the receive, +recv or +recvfrom is sent when data arrives */
+static int Socket_ArmReceive(CalypsoSimulator_t *simP, CSim_Socket_t *socketP, bool recvFrom, const char *formatP, const char *lengthP)
+{
+    long format, length;
+
+    if((socketP == NULL) || (false == ParseInt(formatP, 0, 1, &format)) || (false == ParseInt(lengthP, 1, 65535, &length)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(socketP->peerClosed)
+    {
+        return -ENOTCONN;
+    }
+    socketP->recvPending = true;
+    socketP->recvFrom = recvFrom;
+    socketP->format = (uint8_t)format;
+    socketP->recvLength = (length > CSIM_MAX_DATA_LENGTH) ? CSIM_MAX_DATA_LENGTH : (uint16_t)length;
+    WakeIoThread(simP);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+recv=[id],[format],[length] */
+static int Socket_Recv(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+    char *formatP = NextArgument(&argsP);
+
+    return Socket_ArmReceive(simP, socketP, false, formatP, NextArgument(&argsP));
+}
+
+/* AT+recvFrom=[id],[family],[port],[address],[format],[length], the address filter is not applied */
+static int Socket_RecvFrom(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+    char *formatP;
+
+    NextArgument(&argsP);
+    NextArgument(&argsP);
+    NextArgument(&argsP);
+    formatP = NextArgument(&argsP);
+    return Socket_ArmReceive(simP, socketP, true, formatP, NextArgument(&argsP));
+}
+
+/* AT+send=[id],[format],[length],[data] */
+static int Socket_Send(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+    long format, length;
+    size_t dataLength;
+    ssize_t sent;
+
+    if((socketP == NULL) || (false == ParseInt(NextArgument(&argsP), 0, 1, &format)) || (false == ParseInt(NextArgument(&argsP), 0, 65535, &length)) ||
+       (false == ParseData(simP, argsP, format, length, &dataLength)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    sent = send(socketP->fd, simP->data, dataLength, MSG_NOSIGNAL);
+    if(sent < 0)
+    {
+        return -errno;
+    }
+    simP->statistics.socketBytesSent += sent;
+    return CSIM_STATUS_OK;
+}
+
+/* AT+sendTo=[id],[family],[port],[address],[format],[length],[data] */
+static int Socket_SendTo(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+    char *familyP = NextArgument(&argsP);
+    char *portP = NextArgument(&argsP);
+    struct sockaddr_storage addr;
+    socklen_t addrLength;
+    long format, length;
+    size_t dataLength;
+    ssize_t sent;
+
+    if((socketP == NULL) || (false == ParseAddress(familyP, portP, NextArgument(&argsP), &addr, &addrLength)) ||
+       (false == ParseInt(NextArgument(&argsP), 0, 1, &format)) || (false == ParseInt(NextArgument(&argsP), 0, 65535, &length)) ||
+       (false == ParseData(simP, argsP, format, length, &dataLength)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    sent = sendto(socketP->fd, simP->data, dataLength, MSG_NOSIGNAL, (struct sockaddr *)&addr, addrLength);
+    if(sent < 0)
+    {
+        return -errno;
+    }
+    simP->statistics.socketBytesSent += sent;
+    return CSIM_STATUS_OK;
+}
+
+/* AT+setSockOpt=[id],[level],[option],[values], only the receive buffer size is applied */
+static int Socket_SetSockOpt(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Socket_t *socketP = GetSocket(simP, NextArgument(&argsP));
+    char *levelP = NextArgument(&argsP);
+    char *optionP = NextArgument(&argsP);
+    long value;
+
+    if((socketP == NULL) || (levelP == NULL) || (optionP == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if((strcasecmp(optionP, "RCVBUF") == 0) && ParseInt(NextArgument(&argsP), 0, INT32_MAX, &value))
+    {
+        int size = (int)value;
+        setsockopt(socketP->fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+    return CSIM_STATUS_OK;
+}
+
+/**************************************
+ *   Command handlers, ATFile.c       *
+ **************************************/
+
+/* AT+fileOpen=[name],[options],[max size] */
+static int File_Open(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *nameP = NextArgument(&argsP);
+    char *optionsP = NextArgument(&argsP);
+    char path[512];
+    char *optionP;
+    char *saveP;
+    int flags = 0;
+    bool read = false;
+    bool write = false;
+    int i;
+
+    if((nameP == NULL) || (optionsP == NULL) || (false == FilePath(simP, nameP, path, sizeof(path))))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    for(optionP = strtok_r(optionsP, "|", &saveP); optionP != NULL; optionP = strtok_r(NULL, "|", &saveP))
+    {
+        if(strcasecmp(optionP, "READ") == 0)
+        {
+            read = true;
+        }
+        else if(strcasecmp(optionP, "WRITE") == 0)
+        {
+            write = true;
+        }
+        else if(strcasecmp(optionP, "OVERWRITE") == 0)
+        {
+            write = true;
+            flags |= O_CREAT | O_TRUNC;
+        }
+        else if(strncasecmp(optionP, "CREATE", 6) == 0)
+        {
+            /* CREATE, CREATE_FAILSAFE, CREATE_SECURE, ... */
+            write = true;
+            flags |= O_CREAT | O_TRUNC;
+        }
+    }
+    if(read == write)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+
+    for(i = 0; i < CSIM_FILE_COUNT; i++)
+    {
+        if(false == simP->files[i].used)
+        {
+            break;
+        }
+    }
+    if(i == CSIM_FILE_COUNT)
+    {
+        return -EMFILE;
+    }
+    simP->files[i].fd = open(path, flags | (read ? O_RDONLY : O_WRONLY) | O_CLOEXEC, 0644);
+    if(simP->files[i].fd < 0)
+    {
+        return -errno;
+    }
+    simP->files[i].used = true;
+    simP->files[i].id = simP->nextFileID++;
+    Out(simP, "+fileopen:%u,0\r\n", simP->files[i].id);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+fileClose=[id],[certificate],[signature] */
+static int File_Close(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_File_t *fileP = GetFile(simP, NextArgument(&argsP));
+
+    if(fileP == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    close(fileP->fd);
+    fileP->fd = -1;
+    fileP->used = false;
+    return CSIM_STATUS_OK;
+}
+
+/* AT+fileDel=[name],[secure token] */
+static int File_Del(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *nameP = NextArgument(&argsP);
+    char path[512];
+
+    if((nameP == NULL) || (false == FilePath(simP, nameP, path, sizeof(path))))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    return (unlink(path) == 0) ? CSIM_STATUS_OK : -errno;
+}
+
+/* AT+fileRead=[id],[offset],[format],[length] */
+static int File_Read(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_File_t *fileP = GetFile(simP, NextArgument(&argsP));
+    long offset, format, length;
+    ssize_t bytesRead;
+
+    if((fileP == NULL) || (false == ParseInt(NextArgument(&argsP), 0, INT32_MAX, &offset)) ||
+       (false == ParseInt(NextArgument(&argsP), 0, 1, &format)) || (false == ParseInt(NextArgument(&argsP), 0, 65535, &length)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(length > CSIM_MAX_DATA_LENGTH)
+    {
+        length = CSIM_MAX_DATA_LENGTH;
+    }
+    bytesRead = pread(fileP->fd, simP->data, length, offset);
+    if(bytesRead < 0)
+    {
+        return -errno;
+    }
+    simP->statistics.fileBytesRead += bytesRead;
+    Out(simP, "+fileread:%ld,%u,", format, (format == CSIM_FORMAT_BASE64) ? (unsigned int)((bytesRead + 2) / 3 * 4) : (unsigned int)bytesRead);
+    OutData(simP, (uint8_t)format, simP->data, bytesRead);
+    Out(simP, "\r\n");
+    return CSIM_STATUS_OK;
+}
+
+/* AT+fileWrite=[id],[offset],[format],[length],[data] */
+static int File_Write(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_File_t *fileP = GetFile(simP, NextArgument(&argsP));
+    long offset, format, length;
+    size_t dataLength;
+    ssize_t written;
+
+    if((fileP == NULL) || (false == ParseInt(NextArgument(&argsP), 0, INT32_MAX, &offset)) ||
+       (false == ParseInt(NextArgument(&argsP), 0, 1, &format)) || (false == ParseInt(NextArgument(&argsP), 0, 65535, &length)) ||
+       (false == ParseData(simP, argsP, format, length, &dataLength)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    written = pwrite(fileP->fd, simP->data, dataLength, offset);
+    if(written < 0)
+    {
+        return -errno;
+    }
+    simP->statistics.fileBytesWritten += written;
+    Out(simP, "+filewrite:%u\r\n", (unsigned int)written);
+    return CSIM_STATUS_OK;
+}
+
+/**************************************
+ *   Command handlers, ATMQTT.c       *
+ **************************************/
+
+/* AT+mqttCreate=[clientID],[flags],[address],[port],[method],[cipher],[key],[certificate],[CA],[DH key],[protocol],[blocking send],[format] */
+static int Mqtt_Create(CalypsoSimulator_t *simP, char *argsP)
+{
+    char *clientIDP = NextArgument(&argsP);
+    char *addressP;
+    char *protocolP;
+    long port, format;
+    int i;
+
+    NextArgument(&argsP);
+    addressP = NextArgument(&argsP);
+    if((clientIDP == NULL) || (strlen(clientIDP) >= sizeof(simP->mqtt[0].clientID)) ||
+       (addressP == NULL) || (strlen(addressP) >= sizeof(simP->mqtt[0].address)) ||
+       (false == ParseInt(NextArgument(&argsP), 0, 65535, &port)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    /* security parameters are not simulated */
+    for(i = 0; i < 6; i++)
+    {
+        NextArgument(&argsP);
+    }
+    protocolP = NextArgument(&argsP);
+    NextArgument(&argsP);
+    if((protocolP == NULL) || (false == ParseInt(NextArgument(&argsP), 0, 1, &format)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+
+    for(i = 0; i < CSIM_MQTT_COUNT; i++)
+    {
+        if(false == simP->mqtt[i].used)
+        {
+            break;
+        }
+    }
+    if(i == CSIM_MQTT_COUNT)
+    {
+        return -ENOSPC;
+    }
+    memset(&simP->mqtt[i], 0, offsetof(CSim_Mqtt_t, rxBuffer));
+    simP->mqtt[i].used = true;
+    simP->mqtt[i].fd = -1;
+    strcpy(simP->mqtt[i].clientID, clientIDP);
+    strcpy(simP->mqtt[i].address, addressP);
+    simP->mqtt[i].port = (uint16_t)port;
+    simP->mqtt[i].protocolLevel = (strcasecmp(protocolP, "v3_1") == 0) ? 3 : 4;
+    simP->mqtt[i].format = (uint8_t)format;
+    simP->mqtt[i].clean = true;
+    Out(simP, "+mqttcreate:%d\r\n", i);
+    return CSIM_STATUS_OK;
+}
+
+static int Mqtt_Delete(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Mqtt_t *mqttP = GetMqtt(simP, NextArgument(&argsP));
+
+    if(mqttP == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(mqttP->connected)
+    {
+        Mqtt_Send(mqttP, MQTT_DISCONNECT, NULL, 0);
+    }
+    Mqtt_Close(simP, mqttP, false);
+    mqttP->used = false;
+    WakeIoThread(simP);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+mqttConnect=[index]: TCP connection to the broker, CONNECT and CONNACK */
+static int Mqtt_Connect(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Mqtt_t *mqttP = GetMqtt(simP, NextArgument(&argsP));
+    struct addrinfo hints;
+    struct addrinfo *resultP;
+    char port[8];
+    uint8_t body[1024];
+    uint8_t connack[4];
+    size_t length = 0;
+    size_t received = 0;
+    uint8_t flags = 0;
+    int status;
+
+    if(mqttP == NULL)
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(mqttP->connected)
+    {
+        return -EISCONN;
+    }
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(port, sizeof(port), "%u", mqttP->port);
+    if(getaddrinfo(mqttP->address, port, &hints, &resultP) != 0)
+    {
+        return -EHOSTUNREACH;
+    }
+    mqttP->fd = socket(resultP->ai_family, resultP->ai_socktype | SOCK_CLOEXEC, resultP->ai_protocol);
+    status = (mqttP->fd < 0) ? -errno : ConnectWithTimeout(mqttP->fd, resultP->ai_addr, resultP->ai_addrlen, CSIM_CONNECT_TIMEOUT_MS);
+    freeaddrinfo(resultP);
+    if(status != CSIM_STATUS_OK)
+    {
+        Mqtt_Close(simP, mqttP, false);
+        return status;
+    }
+
+    /* CONNECT: protocol name and level, flags, keep alive, client ID, will, user, password */
+    if(mqttP->protocolLevel == 3)
+    {
+        length += Mqtt_PutString(&body[length], "MQIsdp", 6);
+    }
+    else
+    {
+        length += Mqtt_PutString(&body[length], "MQTT", 4);
+    }
+    body[length++] = mqttP->protocolLevel;
+    if(mqttP->clean)
+    {
+        flags |= 0x02;
+    }
+    if(mqttP->will)
+    {
+        flags |= 0x04 | (uint8_t)(mqttP->willQoS << 3) | (mqttP->willRetain ? 0x20 : 0x00);
+    }
+    if(mqttP->user[0] != '\0')
+    {
+        flags |= 0x80;
+    }
+    if(mqttP->password[0] != '\0')
+    {
+        flags |= 0x40;
+    }
+    body[length++] = flags;
+    body[length++] = (uint8_t)(mqttP->keepAlive_s >> 8);
+    body[length++] = (uint8_t)mqttP->keepAlive_s;
+    length += Mqtt_PutString(&body[length], mqttP->clientID, strlen(mqttP->clientID));
+    if(mqttP->will)
+    {
+        length += Mqtt_PutString(&body[length], mqttP->willTopic, strlen(mqttP->willTopic));
+        length += Mqtt_PutString(&body[length], mqttP->willMessage, strlen(mqttP->willMessage));
+    }
+    if(mqttP->user[0] != '\0')
+    {
+        length += Mqtt_PutString(&body[length], mqttP->user, strlen(mqttP->user));
+    }
+    if(mqttP->password[0] != '\0')
+    {
+        length += Mqtt_PutString(&body[length], mqttP->password, strlen(mqttP->password));
+    }
+    status = Mqtt_Send(mqttP, MQTT_CONNECT, body, length);
+
+    /* the broker answers with a CONNACK of 4 bytes */
+    while((status == CSIM_STATUS_OK) && (received < sizeof(connack)))
+    {
+        struct pollfd pfd = { .fd = mqttP->fd, .events = POLLIN };
+        ssize_t bytesRead;
+
+        if(poll(&pfd, 1, CSIM_CONNECT_TIMEOUT_MS) <= 0)
+        {
+            status = -ETIMEDOUT;
+            break;
+        }
+        bytesRead = recv(mqttP->fd, &connack[received], sizeof(connack) - received, 0);
+        if(bytesRead <= 0)
+        {
+            status = -ECONNRESET;
+            break;
+        }
+        received += bytesRead;
+    }
+    if((status == CSIM_STATUS_OK) && ((connack[0] != MQTT_CONNACK) || (connack[1] != 2) || (connack[3] != 0)))
+    {
+        /* connection refused, the return code of the broker is reported */
+        status = -(int)connack[3];
+        if(status == CSIM_STATUS_OK)
+        {
+            status = -EPROTO;
+        }
+    }
+    if(status != CSIM_STATUS_OK)
+    {
+        Mqtt_Close(simP, mqttP, false);
+        return status;
+    }
+    mqttP->connected = true;
+    mqttP->rxFill = 0;
+    WakeIoThread(simP);
+    AddTimer(simP, 0, "+eventmqtt:operation,CONNACK,0");
+    return CSIM_STATUS_OK;
+}
+
+static int Mqtt_Disconnect(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Mqtt_t *mqttP = GetMqtt(simP, NextArgument(&argsP));
+
+    if((mqttP == NULL) || (false == mqttP->connected))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    Mqtt_Send(mqttP, MQTT_DISCONNECT, NULL, 0);
+    Mqtt_Close(simP, mqttP, false);
+    WakeIoThread(simP);
+    return CSIM_STATUS_OK;
+}
+
+/* AT+mqttPublish=[index],[topic],[QoS],[retain],[length],[message] */
+static int Mqtt_Publish(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Mqtt_t *mqttP = GetMqtt(simP, NextArgument(&argsP));
+    char *topicP = NextArgument(&argsP);
+    uint8_t body[CSIM_MQTT_BUFFER_SIZE];
+    long qos, retain, length;
+    size_t dataLength;
+    size_t bodyLength;
+    int status;
+
+    if((mqttP == NULL) || (topicP == NULL) || (strlen(topicP) > 1024) ||
+       (false == ParseInt(NextArgument(&argsP), 0, 2, &qos)) || (false == ParseInt(NextArgument(&argsP), 0, 1, &retain)) ||
+       (false == ParseInt(NextArgument(&argsP), 0, 65535, &length)) ||
+       (false == ParseData(simP, argsP, mqttP->format, length, &dataLength)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(false == mqttP->connected)
+    {
+        return -ENOTCONN;
+    }
+    bodyLength = Mqtt_PutString(body, topicP, strlen(topicP));
+    if(qos > 0)
+    {
+        mqttP->packetId = (mqttP->packetId == 0xFFFF) ? 1 : mqttP->packetId + 1;
+        body[bodyLength++] = (uint8_t)(mqttP->packetId >> 8);
+        body[bodyLength++] = (uint8_t)mqttP->packetId;
+    }
+    memcpy(&body[bodyLength], simP->data, dataLength);
+    bodyLength += dataLength;
+    status = Mqtt_Send(mqttP, MQTT_PUBLISH | (uint8_t)(qos << 1) | (uint8_t)retain, body, bodyLength);
+    if(status == CSIM_STATUS_OK)
+    {
+        simP->statistics.mqttPublished++;
+    }
+    return status;
+}
+
+/* AT+mqttSubscribe=[index],[count],[topic1],[QoS1],,...,[topic4],[QoS4], */
+static int Mqtt_Subscribe(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Mqtt_t *mqttP = GetMqtt(simP, NextArgument(&argsP));
+    uint8_t body[1200];
+    size_t bodyLength = 2;
+    long count, qos;
+    long i;
+
+    if((mqttP == NULL) || (false == ParseInt(NextArgument(&argsP), 1, 4, &count)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(false == mqttP->connected)
+    {
+        return -ENOTCONN;
+    }
+    for(i = 0; i < count; i++)
+    {
+        char *topicP = NextArgument(&argsP);
+        if((topicP == NULL) || (*topicP == '\0') || (strlen(topicP) > 256) || (false == ParseInt(NextArgument(&argsP), 0, 2, &qos)))
+        {
+            return CSIM_ERROR_INVALID;
+        }
+        NextArgument(&argsP);
+        bodyLength += Mqtt_PutString(&body[bodyLength], topicP, strlen(topicP));
+        body[bodyLength++] = (uint8_t)qos;
+    }
+    mqttP->packetId = (mqttP->packetId == 0xFFFF) ? 1 : mqttP->packetId + 1;
+    body[0] = (uint8_t)(mqttP->packetId >> 8);
+    body[1] = (uint8_t)mqttP->packetId;
+    return Mqtt_Send(mqttP, MQTT_SUBSCRIBE, body, bodyLength);
+}
+
+/* AT+mqttUnsubscribe=[index],[count],[topic1],,[topic2],,[topic3],,[topic4], */
+static int Mqtt_Unsubscribe(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Mqtt_t *mqttP = GetMqtt(simP, NextArgument(&argsP));
+    uint8_t body[1200];
+    size_t bodyLength = 2;
+    long count;
+    long i;
+
+    if((mqttP == NULL) || (false == ParseInt(NextArgument(&argsP), 1, 4, &count)))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(false == mqttP->connected)
+    {
+        return -ENOTCONN;
+    }
+    for(i = 0; i < count; i++)
+    {
+        char *topicP = NextArgument(&argsP);
+        if((topicP == NULL) || (*topicP == '\0') || (strlen(topicP) > 256))
+        {
+            return CSIM_ERROR_INVALID;
+        }
+        NextArgument(&argsP);
+        bodyLength += Mqtt_PutString(&body[bodyLength], topicP, strlen(topicP));
+    }
+    mqttP->packetId = (mqttP->packetId == 0xFFFF) ? 1 : mqttP->packetId + 1;
+    body[0] = (uint8_t)(mqttP->packetId >> 8);
+    body[1] = (uint8_t)mqttP->packetId;
+    return Mqtt_Send(mqttP, MQTT_UNSUBSCRIBE, body, bodyLength);
+}
+
+/* AT+mqttSet=[index],[option],[values], applied with the next AT+mqttConnect */
+static int Mqtt_Set(CalypsoSimulator_t *simP, char *argsP)
+{
+    CSim_Mqtt_t *mqttP = GetMqtt(simP, NextArgument(&argsP));
+    char *optionP = NextArgument(&argsP);
+    long value;
+
+    if((mqttP == NULL) || (optionP == NULL) || (argsP == NULL))
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    if(strcasecmp(optionP, "user") == 0)
+    {
+        snprintf(mqttP->user, sizeof(mqttP->user), "%s", argsP);
+    }
+    else if(strcasecmp(optionP, "password") == 0)
+    {
+        snprintf(mqttP->password, sizeof(mqttP->password), "%s", argsP);
+    }
+    else if(strcasecmp(optionP, "keepAlive") == 0)
+    {
+        if(false == ParseInt(argsP, 0, 65535, &value))
+        {
+            return CSIM_ERROR_INVALID;
+        }
+        mqttP->keepAlive_s = (uint16_t)value;
+    }
+    else if(strcasecmp(optionP, "clean") == 0)
+    {
+        if(false == ParseInt(argsP, 0, 1, &value))
+        {
+            return CSIM_ERROR_INVALID;
+        }
+        mqttP->clean = (value == 1);
+    }
+    else if(strcasecmp(optionP, "will") == 0)
+    {
+        /* [topic],[QoS],[retain],[length],[message] */
+        char *topicP = NextArgument(&argsP);
+        long qos, retain;
+
+        if((topicP == NULL) || (strlen(topicP) >= sizeof(mqttP->willTopic)) ||
+           (false == ParseInt(NextArgument(&argsP), 0, 2, &qos)) || (false == ParseInt(NextArgument(&argsP), 0, 1, &retain)))
+        {
+            return CSIM_ERROR_INVALID;
+        }
+        NextArgument(&argsP);
+        strcpy(mqttP->willTopic, topicP);
+        snprintf(mqttP->willMessage, sizeof(mqttP->willMessage), "%s", (argsP != NULL) ? argsP : "");
+        mqttP->willQoS = (uint8_t)qos;
+        mqttP->willRetain = (retain == 1);
+        mqttP->will = true;
+    }
+    else
+    {
+        return CSIM_ERROR_INVALID;
+    }
+    return CSIM_STATUS_OK;
+}
+
+static uint64_t GetThreadCpuTime_us(pthread_t thread)
+{
+    clockid_t clock;
+    struct timespec ts;
+
+    if((pthread_getcpuclockid(thread, &clock) != 0) || (clock_gettime(clock, &ts) != 0))
+    {
+        return 0;
+    }
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
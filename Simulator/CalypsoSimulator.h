@@ -0,0 +1,149 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _CalypsoSimulator_defined
+#define _CalypsoSimulator_defined
+
+/*
+ * Software model of a Calypso WiFi module speaking the AT command interface
+ * (AT+cmd=args\r\n, answered by +cmd:values\r\n lines and OK\r\n or
+ * error:cmd,code\r\n) on a pseudo terminal.
+ *
+ * The simulator answers the commands sent by Calypso.c and the ATCommands
+ * modules (ATDevice, ATWLAN, ATSocket, ATFile, ATMQTT) and emits the
+ * unsolicited +eventstartup, +eventwlan, +eventnetapp, +recv, +recvfrom,
+ * +accept and +eventmqtt lines parsed by events.c. The network is the one
+ * of the host:
+ * - the sockets of the module are real UDP and TCP sockets of the host, so
+ *   that data is exchanged with any program on the host or the network,
+ * - the MQTT clients of the module speak MQTT 3.1 / 3.1.1 over TCP to a
+ *   real broker (e.g. mosquitto on localhost),
+ * - the file system of the module is a directory of the host.
+ * Secure sockets (SEC) and TLS are not simulated, they fall back to plain TCP.
+ *
+ * Binary (format 0) payloads are transferred as they are and must not
+ * contain the line end "\r\n", use Base64 (format 1) for binary data.
+ */
+
+typedef struct CalypsoSimulator_Config_t
+{
+    const char *device;             /* pty slave created by the driver transport to attach to, NULL to create a pty pair */
+    unsigned int latency_us;        /* processing time of a command */
+    unsigned int boot_ms;           /* time from the start (power up, AT+reboot, AT+start) to +eventstartup */
+    unsigned int connect_ms;        /* time from AT+wlanConnect to +eventwlan:connect and +eventnetapp:ipv4_acquired */
+    const char *fileRoot;           /* directory of the host holding the files of the module, created if missing */
+    const char *ipAddress;          /* address reported by +eventnetapp:ipv4_acquired */
+} CalypsoSimulator_Config_t;
+
+typedef struct CalypsoSimulator_Statistics_t
+{
+    uint64_t commands;              /* AT command lines received */
+    uint64_t errors;                /* commands answered with error */
+    uint64_t events;                /* unsolicited lines sent */
+    uint64_t socketBytesSent;       /* payload sent by AT+send and AT+sendTo */
+    uint64_t socketBytesReceived;   /* payload passed to the driver by +recv and +recvfrom */
+    uint64_t mqttPublished;         /* messages published by AT+mqttPublish */
+    uint64_t mqttReceived;          /* messages passed to the driver by +eventmqtt:recv */
+    uint64_t fileBytesWritten;
+    uint64_t fileBytesRead;
+    uint64_t bytesReceived;         /* on the pty */
+    uint64_t bytesSent;             /* on the pty */
+    uint64_t cpuTime_us;            /* CPU time consumed by the threads of the simulator */
+} CalypsoSimulator_Statistics_t;
+
+typedef struct CalypsoSimulator_t CalypsoSimulator_t;
+
+/*
+ * Fill a configuration with the defaults
+ *
+ * output:
+ * - configP: configuration
+ *
+ */
+extern void CalypsoSimulator_GetDefaultConfig(CalypsoSimulator_Config_t *configP);
+
+/*
+ * Create a simulator, set up its pseudo terminal and its file directory
+ *
+ * input:
+ * - configP: configuration, copied (the strings are not)
+ *
+ * return: simulator, if success
+ *         NULL, otherwise
+ *
+ */
+extern CalypsoSimulator_t *CalypsoSimulator_Create(const CalypsoSimulator_Config_t *configP);
+
+/*
+ * Get the device the driver has to open
+ *
+ * return: slave side of the pty pair created by the simulator,
+ *         NULL, if the simulator attached to the pty of the driver
+ *
+ */
+extern const char *CalypsoSimulator_GetPeerName(CalypsoSimulator_t *simP);
+
+/*
+ * Power up the module: answer commands and send +eventstartup after boot_ms
+ *
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool CalypsoSimulator_Start(CalypsoSimulator_t *simP);
+
+/*
+ * Stop the threads of the simulator and close its sockets, files and
+ * MQTT connections, the pty stays set up
+ */
+extern void CalypsoSimulator_Stop(CalypsoSimulator_t *simP);
+
+/*
+ * Stop the simulator if it is running and free it
+ */
+extern void CalypsoSimulator_Destroy(CalypsoSimulator_t *simP);
+
+/*
+ * Read the counters of the simulator
+ *
+ * output:
+ * - statisticsP: counters since the creation
+ *
+ */
+extern void CalypsoSimulator_GetStatistics(CalypsoSimulator_t *simP, CalypsoSimulator_Statistics_t *statisticsP);
+
+#endif // _CalypsoSimulator_defined
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,1859 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Module simulator for the WE command protocol, see ModuleSimulator.h
+ *
+ * Two threads serve a simulator: the RX thread parses the request frames of
+ * the driver and queues the answers with their due time, the TX thread sends
+ * the queued frames when they are due and generates the indications.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "ModuleSimulator.h"
+
+/**************************************
+ *     Definitions                    *
+ **************************************/
+
+#define SIM_MAX_DATA_LENGTH     1024                        /* payload of a frame */
+#define SIM_MAX_FRAME_LENGTH    (SIM_MAX_DATA_LENGTH + 5)   /* STX, CMD, two length bytes, payload, CS */
+#define SIM_QUEUE_LENGTH        64                          /* answers waiting for their due time */
+#define SIM_SEND_BATCH          16                          /* frames sent with one write */
+#define SIM_MAX_SETTING_LENGTH  32
+#define SIM_PIN_COUNT           16                          /* pins tracked for rising edges */
+#define SIM_RX_CHUNK_SIZE       256
+#define SIM_RECONNECT_GAP_US    10000                       /* time between DISCONNECT_IND and CONNECT_IND */
+#define SIM_MAX_LAG_US          1000000                     /* indications later than this are not caught up */
+#define SIM_LINK_EVENT_PACKETS  6                           /* link model: data packets per connection event */
+#define SIM_LINK_OVERHEAD       21                          /* link model: bytes added to the payload: preamble, access address, headers, MIC, CRC */
+#define SIM_LINK_ACK_LENGTH     10                          /* link model: bytes of the empty packet acknowledging a data packet */
+#define SIM_LINK_IFS_US         150                         /* link model: inter frame space */
+#define SIM_SCAN_LIST_LENGTH    10                          /* ProteusIII: devices in the scan result list of the module */
+#define SIM_SCAN_ADV_INTERVAL_US 100000                     /* ProteusIII: advertising interval of the simulated devices */
+#define SIM_GPIO_PINS           6                           /* ProteusIII: pins of the GPIO feature, local and remote */
+#define SIM_REORDER_DELAY_US    5000                        /* ProteusIII echo: delay of a data packet sent back out of order */
+
+#define CMD_TYPE_CNF            (uint8_t)(1 << 6)
+#define CMD_TYPE_IND            (uint8_t)(2 << 6)
+#define CMD_TYPE_RSP            (uint8_t)(3 << 6)
+
+#define STATUS_SUCCESS          (uint8_t)0x00
+#define STATUS_FAILED           (uint8_t)0x01
+
+/* ProteusIII and ThyoneI commands */
+#define P3_CMD_RESET_REQ            0x00
+#define P3_CMD_GETSTATE_REQ         0x01
+#define P3_CMD_DATA_REQ             0x04
+#define P3_CMD_DATA_IND             0x84
+#define P3_CMD_TXCOMPLETE_RSP       0xC4
+#define P3_CMD_CONNECT_REQ          0x06
+#define P3_CMD_CONNECT_IND          0x86
+#define P3_CMD_CHANNELOPEN_RSP      0xC6
+#define P3_CMD_DISCONNECT_REQ       0x07
+#define P3_CMD_DISCONNECT_IND       0x87
+#define P3_CMD_SCANSTART_REQ        0x09
+#define P3_CMD_SCANSTOP_REQ         0x0A
+#define P3_CMD_GETDEVICES_REQ       0x0B
+#define P3_CMD_GET_REQ              0x10
+#define P3_CMD_SET_REQ              0x11
+#define P3_CMD_FACTORYRESET_REQ     0x1C
+#define P3_CMD_GPIO_LOCAL_WRITE_REQ 0x26
+#define P3_CMD_GPIO_LOCAL_WRITE_IND 0xA6
+#define P3_CMD_GPIO_LOCAL_READ_REQ  0x27
+#define P3_CMD_GPIO_REMOTE_WRITE_REQ 0x29
+#define P3_CMD_GPIO_REMOTE_READ_REQ 0x2A
+#define P3_CMD_PHYUPDATE_REQ        0x1A
+#define P3_CMD_PHYUPDATE_IND        0x9A
+#define P3_SETTING_CONNECTION_TIMING 0x08
+#define P3_SETTING_TX_POWER         0x11
+#define P3_PHY_1MBIT                0x01
+#define P3_PHY_2MBIT                0x02
+#define P3_PHY_CODED                0x04
+#define P3_MAX_PAYLOAD              243         /* reported in CHANNELOPEN_RSP */
+
+#define THYONEI_CMD_RESET_REQ               0x00
+#define THYONEI_CMD_START_IND               0x73
+#define THYONEI_CMD_UNICAST_DATA_REQ        0x04
+#define THYONEI_CMD_MULTICAST_DATA_EX_REQ   0x08
+#define THYONEI_CMD_DATA_CNF                0x44
+#define THYONEI_CMD_DATA_IND                0x84
+#define THYONEI_CMD_TXCOMPLETE_RSP          0xC4
+#define THYONEI_CMD_GET_REQ                 0x10
+#define THYONEI_CMD_SET_REQ                 0x11
+#define THYONEI_CMD_FACTORYRESET_REQ        0x1C
+#define THYONEI_MAX_PAYLOAD                 224
+
+/* TarvosIII commands */
+#define TARVOSIII_CMD_DATA_REQ          0x00
+#define TARVOSIII_CMD_DATA_CNF          0x40
+#define TARVOSIII_CMD_DATAEX_REQ        0x01
+#define TARVOSIII_CMD_DATAEX_IND        0x81
+#define TARVOSIII_CMD_RESET_REQ         0x05
+#define TARVOSIII_CMD_RESET_IND         0x85
+#define TARVOSIII_CMD_SET_CHANNEL_REQ   0x06
+#define TARVOSIII_CMD_SET_REQ           0x09
+#define TARVOSIII_CMD_GET_REQ           0x0A
+#define TARVOSIII_CMD_SET_PAPOWER_REQ   0x11
+#define TARVOSIII_CMD_FACTORY_RESET_REQ 0x12
+#define TARVOSIII_CMD_PINGDUT_REQ       0x1F
+#define TARVOSIII_SETTING_ADDRESSMODE   0x04
+#define TARVOSIII_MAX_PAYLOAD           224
+
+/* Metis commands, confirmations have bit 7 set */
+#define METIS_CMD_TYPE_CNF              (uint8_t)(2 << 6)
+#define METIS_CMD_DATA_REQ              0x00
+#define METIS_CMD_DATA_IND              0x03
+#define METIS_CMD_SET_REQ               0x09
+#define METIS_CMD_GET_REQ               0x0A
+#define METIS_CMD_GET_SERIALNO_REQ      0x0B
+#define METIS_CMD_GET_FWRELEASE_REQ     0x0C
+#define METIS_MEMPOSITION_RSSI_ENABLE   0x45
+#define METIS_MAX_PAYLOAD               250
+
+#define TRITON_CMD_DATAEX_REQ           0x01
+#define TRITON_CMD_DATAEX_IND           0x81
+#define TRITON_CMD_RESET_REQ            0x05
+#define TRITON_CMD_SET_REQ              0x09
+#define TRITON_CMD_GET_REQ              0x0A
+#define TRITON_CMD_SERIALNO_REQ         0x0B
+#define TRITON_CMD_FWVERSION_REQ        0x0C
+#define TRITON_CMD_RSSI_REQ             0x0D
+#define TRITON_CMD_FACTORY_RESET_REQ    0x11
+#define TRITON_CMD_SET_OPMODE_REQ       0x28
+#define TRITON_CMD_STATUS_IND           0xC0
+#define TRITON_MAX_PAYLOAD              26
+
+typedef struct Sim_Setting_t
+{
+    uint8_t length;                             /* 0 if the setting does not exist */
+    uint8_t value[SIM_MAX_SETTING_LENGTH];
+} Sim_Setting_t;
+
+typedef struct Sim_DefaultSetting_t
+{
+    uint8_t index;
+    uint8_t length;
+    uint8_t value[SIM_MAX_SETTING_LENGTH];
+} Sim_DefaultSetting_t;
+
+typedef struct Sim_Frame_t
+{
+    struct timespec due;
+    uint64_t order;                             /* keeps frames with the same due time in order */
+    bool used;
+    bool indication;
+    uint16_t length;
+    uint8_t data[SIM_MAX_FRAME_LENGTH];
+} Sim_Frame_t;
+
+/* frame format and behaviour of a module */
+typedef struct Sim_Protocol_t
+{
+    const char *name;
+    uint8_t stx;
+    uint8_t lengthBytes;                        /* 1 or 2, little endian */
+    uint16_t maxPayload;                        /* of the data indications */
+    void (*handleRequest)(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length);
+    void (*startup)(ModuleSimulator_t *simP, unsigned int delay_us);
+    uint16_t (*indication)(ModuleSimulator_t *simP, uint8_t *frameP);
+    const Sim_DefaultSetting_t *defaults;
+} Sim_Protocol_t;
+
+struct ModuleSimulator_t
+{
+    ModuleSimulator_Config_t config;
+    const Sim_Protocol_t *protocolP;
+    Transport_t *transportP;
+    int rxThreadEvent;                          /* eventfd to stop the RX thread */
+    pthread_t thread_rx;
+    pthread_t thread_tx;
+    bool running;
+    bool stop;
+
+    pthread_mutex_t mutex;                      /* protects all members below */
+    pthread_cond_t cond;                        /* signalled when the TX thread has to recompute its deadline */
+    Sim_Frame_t queue[SIM_QUEUE_LENGTH];
+    uint64_t order;
+    unsigned int seed;
+    bool requestSeen;
+    bool booted;
+    struct timespec nextAnnounce;
+    struct timespec nextIndication;
+    uint32_t indicationSequence;
+    bool channelOpen;                           /* ProteusIII: peer connected and channel open */
+    bool connectPending;
+    struct timespec nextConnectEvent;
+    struct timespec linkFree;                   /* ProteusIII: end of the transmission of the last data request */
+    struct timespec linkAnchor;                 /* ProteusIII link model: first connection event */
+    uint64_t linkEvent;                         /* ProteusIII link model: connection event sending, counted from linkAnchor */
+    uint16_t linkEventPackets;                  /* ProteusIII link model: packets sent in this connection event */
+    uint8_t connectionTiming;                   /* ProteusIII: RF_CONNECTION_TIMING applied at the startup */
+    int8_t txPower;                             /* ProteusIII: RF_TX_POWER applied at the startup */
+    uint8_t phy;                                /* ProteusIII: PHY of the connection */
+    bool scanning;                              /* ProteusIII: between SCANSTART_REQ and SCANSTOP_REQ */
+    struct timespec scanResults;                /* ProteusIII: time of the last scan results, see ProteusIII_ScanResults */
+    uint8_t gpio[2][SIM_GPIO_PINS];             /* ProteusIII: values of the local (0) and remote (1) pins by GPIO_ID - 1 */
+    struct timespec nextGPIOEvent;              /* ProteusIII: next write of a local pin by the peer */
+    struct { int pin; bool low; } pins[SIM_PIN_COUNT];
+    Sim_Setting_t settings[256];                /* user settings by index */
+    uint8_t memory[256];                        /* Metis: user settings by memory address */
+    ModuleSimulator_Statistics_t statistics;
+
+    /* frames sent with one write, only used by the TX thread */
+    uint8_t txBatch[SIM_SEND_BATCH][SIM_MAX_FRAME_LENGTH];
+
+    /* RX parser, only used by the RX thread */
+    uint8_t rxFrame[SIM_MAX_FRAME_LENGTH];
+    uint16_t rxIndex;
+    uint16_t rxLength;
+};
+
+static void *rx_thread(void *pArgs);
+static void *tx_thread(void *pArgs);
+static void HandleRxByte(ModuleSimulator_t *simP, uint8_t byte);
+static void Boot(ModuleSimulator_t *simP);
+static bool QueueFrame(ModuleSimulator_t *simP, unsigned int delay_us, bool indication, uint8_t cmd, const uint8_t *headerP, uint16_t header_length, const uint8_t *payloadP, uint16_t payload_length);
+static uint16_t BuildFrame(const Sim_Protocol_t *protocolP, uint8_t *frameP, uint8_t cmd, const uint8_t *headerP, uint16_t header_length, const uint8_t *payloadP, uint16_t payload_length);
+static unsigned int Latency(ModuleSimulator_t *simP);
+static void FillPayload(ModuleSimulator_t *simP, uint8_t *payloadP, uint16_t length);
+static void Confirm(ModuleSimulator_t *simP, uint8_t cmd, uint8_t status);
+static void GetSetting(ModuleSimulator_t *simP, uint8_t cnf, uint8_t index);
+static void SetSetting(ModuleSimulator_t *simP, uint8_t cnf, const uint8_t *dataP, uint16_t length);
+static void ProteusIII_Connect(ModuleSimulator_t *simP, unsigned int delay_us);
+static void ProteusIII_Disconnect(ModuleSimulator_t *simP, unsigned int delay_us, uint8_t reason);
+static void ProteusIII_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length);
+static void ProteusIII_Startup(ModuleSimulator_t *simP, unsigned int delay_us);
+static void ProteusIII_LinkTransmit(ModuleSimulator_t *simP, const struct timespec *readyP, uint16_t length);
+static void ProteusIII_ScanResults(ModuleSimulator_t *simP, uint8_t cnf, unsigned int delay_us);
+static void ProteusIII_GPIORead(ModuleSimulator_t *simP, uint8_t cnf, bool remote, const uint8_t *dataP, uint16_t length, unsigned int delay_us);
+static void ProteusIII_GPIOWrite(ModuleSimulator_t *simP, uint8_t cnf, bool remote, const uint8_t *dataP, uint16_t length, unsigned int delay_us);
+static void ProteusIII_GPIOEvent(ModuleSimulator_t *simP);
+static void ProteusIII_Echo(ModuleSimulator_t *simP, unsigned int delay_us, const uint8_t *dataP, uint16_t length);
+static uint16_t ProteusIII_Indication(ModuleSimulator_t *simP, uint8_t *frameP);
+static void ThyoneI_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length);
+static void ThyoneI_Startup(ModuleSimulator_t *simP, unsigned int delay_us);
+static uint16_t ThyoneI_Indication(ModuleSimulator_t *simP, uint8_t *frameP);
+static void TarvosIII_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length);
+static void TarvosIII_Startup(ModuleSimulator_t *simP, unsigned int delay_us);
+static uint16_t TarvosIII_Indication(ModuleSimulator_t *simP, uint8_t *frameP);
+static void Metis_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length);
+static void Metis_Startup(ModuleSimulator_t *simP, unsigned int delay_us);
+static uint16_t Metis_Indication(ModuleSimulator_t *simP, uint8_t *frameP);
+static void Triton_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length);
+static void Triton_Startup(ModuleSimulator_t *simP, unsigned int delay_us);
+static uint16_t Triton_Indication(ModuleSimulator_t *simP, uint8_t *frameP);
+static void GetTime(struct timespec *timeP);
+static void AddTime(struct timespec *timeP, uint64_t us);
+static bool IsBefore(const struct timespec *aP, const struct timespec *bP);
+static uint64_t Elapsed_us(const struct timespec *fromP, const struct timespec *toP);
+static uint64_t GetThreadCpuTime_us(pthread_t thread);
+
+/**************************************
+ *          Static variables          *
+ **************************************/
+
+/* BTMAC of the simulated ProteusIII peer */
+static const uint8_t peerBTMAC[6] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+
+/* ProteusIII link model: connection interval by RF_CONNECTION_TIMING */
+static const uint32_t ProteusIII_connectionInterval_us[] = { 15000, 7500, 30000, 50000, 100000, 200000, 400000, 20000, 10000 };
+
+static const Sim_DefaultSetting_t ProteusIII_defaults[] =
+{
+    { 0x01, 3, { 0x00, 0x04, 0x01 } },                                      /* FS_FWVersion */
+    { 0x02, 5, { 'P', '3', 'S', 'I', 'M' } },                               /* RF_DEVICE_NAME */
+    { 0x03, 8, { 0x00, 0x00, 0x18, 0xDA, 0x00, 0x00, 0x00, 0x00 } },        /* FS_MAC */
+    { 0x04, 6, { 0x01, 0x00, 0x00, 0xDA, 0x18, 0x00 } },                    /* FS_BTMAC */
+    { 0x07, 2, { 0x00, 0x00 } },                                            /* RF_ADVERTISING_TIMEOUT */
+    { 0x08, 1, { 0x00 } },                                                  /* RF_CONNECTION_TIMING */
+    { 0x09, 1, { 0x00 } },                                                  /* RF_SCAN_TIMING */
+    { 0x0A, 1, { 0x02 } },                                                  /* RF_SCAN_FACTOR */
+    { 0x0B, 1, { 0x0B } },                                                  /* UART_CONFIG_INDEX */
+    { 0x0C, 1, { 0x00 } },                                                  /* RF_SEC_FLAGS */
+    { 0x0D, 1, { 0x00 } },                                                  /* RF_SCAN_FLAGS */
+    { 0x0E, 1, { 0x00 } },                                                  /* RF_BEACON_FLAGS */
+    { 0x0F, 8, { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },        /* FS_DEVICE_INFO */
+    { 0x10, 3, { 0x01, 0x00, 0x00 } },                                      /* FS_SERIAL_NUMBER */
+    { 0x11, 1, { 0x04 } },                                                  /* RF_TX_POWER */
+    { 0x12, 6, { '1', '2', '3', '1', '2', '3' } },                          /* RF_STATIC_PASSKEY */
+    { 0x1C, 2, { 0x00, 0x00 } },                                            /* RF_CFGFLAGS */
+    { 0x1D, 1, { 0x00 } },                                                  /* RF_ADVERTISING_FLAGS */
+    { 0x00, 0, { 0 } },
+};
+
+static const Sim_DefaultSetting_t ThyoneI_defaults[] =
+{
+    { 0x01, 4, { 0x01, 0x00, 0x00, 0x00 } },                                /* SERIAL_NUMBER */
+    { 0x02, 3, { 0x00, 0x01, 0x01 } },                                      /* FW_VERSION */
+    { 0x04, 4, { 0x00, 0xC2, 0x01, 0x00 } },                                /* UART_CONFIG */
+    { 0x07, 1, { 21 } },                                                    /* RF_CHANNEL */
+    { 0x08, 1, { 0x00 } },                                                  /* ENCRYPTION_MODE */
+    { 0x09, 1, { 0x00 } },                                                  /* RF_PROFILE */
+    { 0x0A, 1, { 0x0A } },                                                  /* RF_NUM_RETRIES */
+    { 0x0B, 1, { 0x04 } },                                                  /* RF_TX_POWER */
+    { 0x0C, 1, { 0x03 } },                                                  /* RF_RP_NUM_SLOTS */
+    { 0x10, 4, { 0x01, 0x00, 0x00, 0x00 } },                                /* MAC_SOURCE_ADDRESS */
+    { 0x11, 4, { 0xFF, 0xFF, 0xFF, 0xFF } },                                /* MAC_DESTINATION_ADDRESS */
+    { 0x12, 1, { 0x00 } },                                                  /* MAC_GROUP_ID */
+    { 0x15, 1, { 0x00 } },                                                  /* MAC_TLL */
+    { 0x16, 1, { 0x00 } },                                                  /* CCA_MODE */
+    { 0x17, 1, { 0x50 } },                                                  /* CCA_THRESHOLD */
+    { 0x18, 1, { 0x00 } },                                                  /* REMOTE_GPIO_CONFIG */
+    { 0x20, 1, { 0x00 } },                                                  /* MODULE_MODE */
+    { 0x00, 0, { 0 } },
+};
+
+static const Sim_DefaultSetting_t TarvosIII_defaults[] =
+{
+    { 0x00, 1, { 0x00 } },                                                  /* UARTBAUDRATE */
+    { 0x01, 1, { 0x00 } },                                                  /* DEFAULTRFPROFILE */
+    { 0x02, 1, { 14 } },                                                    /* DEFAULTRFTXPOWER */
+    { 0x03, 1, { 106 } },                                                   /* DEFAULTRFCHANNEL */
+    { 0x04, 1, { 0x00 } },                                                  /* DEFAULTADDRESSMODE */
+    { 0x06, 1, { 0x00 } },                                                  /* NUMRETRYS */
+    { 0x07, 1, { 0x00 } },                                                  /* DEFAULTDESTNETID */
+    { 0x08, 2, { 0x00, 0x00 } },                                            /* DEFAULTDESTADDR */
+    { 0x0A, 1, { 0x00 } },                                                  /* SOURCENETID */
+    { 0x0B, 2, { 0x00, 0x00 } },                                            /* SOURCEADDR */
+    { 0x0F, 2, { 0x00, 0x00 } },                                            /* CFG_FLAGS */
+    { 0x10, 1, { 0x00 } },                                                  /* RP_FLAGS */
+    { 0x11, 1, { 0x02 } },                                                  /* RP_NUMSLOTS */
+    { 0x21, 3, { 0x00, 0x00, 0x01 } },                                      /* FWVERSION */
+    { 0x00, 0, { 0 } },
+};
+
+static const Sim_DefaultSetting_t Metis_defaults[] =
+{
+    { 0x05, 1, { 0x01 } },                                                  /* UART_CMD_OUT_ENABLE */
+    { 0x0B, 1, { 0x00 } },                                                  /* APP_AES_ENABLE */
+    { 0x3D, 1, { 14 } },                                                    /* DEFAULTRFTXPOWER */
+    { 0x45, 1, { 0x01 } },                                                  /* RSSI_ENABLE */
+    { 0x46, 1, { 0x00 } },                                                  /* MODE_PRESELECT */
+    { 0x50, 2, { 0x00, 0x00 } },                                            /* CFG_FLAGS */
+    { 0x00, 0, { 0 } },
+};
+
+static const Sim_DefaultSetting_t Triton_defaults[] =
+{
+    { 0x00, 1, { 0x00 } },                                                  /* RFCHANNEL */
+    { 0x01, 1, { 0x00 } },                                                  /* RFRATE */
+    { 0x02, 1, { 0x00 } },                                                  /* SUBNETID */
+    { 0x03, 1, { 0x01 } },                                                  /* ADDRESSSOURCE */
+    { 0x04, 1, { 0x0C } },                                                  /* RFPOWERLEVEL */
+    { 0x05, 1, { 0x00 } },                                                  /* CFG_FLAGS */
+    { 0x3C, 4, { 0x00, 0xC2, 0x01, 0x00 } },                                /* UARTBAUDRATE */
+    { 0x00, 0, { 0 } },
+};
+
+static const Sim_Protocol_t protocols[ModuleSimulator_Module_Count] =
+{
+    [ModuleSimulator_Module_ProteusIII] = { "ProteusIII", 0x02, 2, P3_MAX_PAYLOAD, ProteusIII_HandleRequest, ProteusIII_Startup, ProteusIII_Indication, ProteusIII_defaults },
+    [ModuleSimulator_Module_ThyoneI] = { "ThyoneI", 0x02, 2, THYONEI_MAX_PAYLOAD, ThyoneI_HandleRequest, ThyoneI_Startup, ThyoneI_Indication, ThyoneI_defaults },
+    [ModuleSimulator_Module_TarvosIII] = { "TarvosIII", 0x02, 1, TARVOSIII_MAX_PAYLOAD, TarvosIII_HandleRequest, TarvosIII_Startup, TarvosIII_Indication, TarvosIII_defaults },
+    [ModuleSimulator_Module_Metis] = { "Metis", 0xFF, 1, METIS_MAX_PAYLOAD, Metis_HandleRequest, Metis_Startup, Metis_Indication, Metis_defaults },
+    [ModuleSimulator_Module_Triton] = { "Triton", 0x02, 1, TRITON_MAX_PAYLOAD, Triton_HandleRequest, Triton_Startup, Triton_Indication, Triton_defaults },
+};
+
+/**************************************
+ *         Global functions           *
+ **************************************/
+
+const char *ModuleSimulator_GetModuleName(ModuleSimulator_Module_t module)
+{
+    return (module < ModuleSimulator_Module_Count) ? protocols[module].name : NULL;
+}
+
+void ModuleSimulator_GetDefaultConfig(ModuleSimulator_Module_t module, ModuleSimulator_Config_t *configP)
+{
+    memset(configP, 0, sizeof(ModuleSimulator_Config_t));
+    configP->module = module;
+    configP->device = NULL;
+    configP->latency_us = 200;
+    configP->jitter_us = 0;
+    configP->airtime_us = 1000;
+    configP->boot_ms = 10;
+    configP->announce_ms = 0;
+    configP->ind_rate_hz = 0;
+    configP->ind_payload_length = 16;
+    configP->connect = (module == ModuleSimulator_Module_ProteusIII);
+    configP->reconnect_ms = 0;
+    configP->link_model = false;
+    configP->path_loss_db = 60;
+    configP->scan_devices = 0;
+    configP->gpio_rate_hz = 0;
+    configP->echo = false;
+    configP->loss_percent = 0;
+    configP->reorder_percent = 0;
+}
+
+ModuleSimulator_t *ModuleSimulator_Create(const ModuleSimulator_Config_t *configP)
+{
+    ModuleSimulator_t *simP;
+    const Sim_DefaultSetting_t *defaultP;
+
+    if((configP == NULL) || (configP->module >= ModuleSimulator_Module_Count))
+    {
+        return NULL;
+    }
+
+    simP = calloc(1, sizeof(ModuleSimulator_t));
+    if(simP == NULL)
+    {
+        return NULL;
+    }
+    simP->config = *configP;
+    simP->protocolP = &protocols[configP->module];
+    if(simP->config.ind_payload_length > simP->protocolP->maxPayload)
+    {
+        simP->config.ind_payload_length = simP->protocolP->maxPayload;
+    }
+    simP->rxThreadEvent = -1;
+    simP->seed = (unsigned int)time(NULL);
+    pthread_mutex_init(&simP->mutex, NULL);
+    InitMonotonicCond(&simP->cond);
+
+    for(defaultP = simP->protocolP->defaults; defaultP->length != 0; defaultP++)
+    {
+        ModuleSimulator_SetUserSetting(simP, defaultP->index, defaultP->value, defaultP->length);
+    }
+
+    /* the pty is created (or attached to) right away, so that the driver can open it before the simulator runs */
+    simP->transportP = PtyTransport_Create(configP->device);
+    if((simP->transportP == NULL) || (false == Transport_Open(simP->transportP, 0, Serial_ParityBit_NONE)))
+    {
+        fprintf(stdout, "Setting up the pseudo terminal of the %s simulator failed\n", simP->protocolP->name);
+        ModuleSimulator_Destroy(simP);
+        return NULL;
+    }
+    return simP;
+}
+
+const char *ModuleSimulator_GetPeerName(ModuleSimulator_t *simP)
+{
+    return (simP != NULL) ? PtyTransport_GetPeerName(simP->transportP) : NULL;
+}
+
+bool ModuleSimulator_Start(ModuleSimulator_t *simP)
+{
+    if((simP == NULL) || simP->running)
+    {
+        return false;
+    }
+
+    simP->stop = false;
+    GetTime(&simP->nextAnnounce);
+    simP->nextIndication = simP->nextAnnounce;
+    simP->rxThreadEvent = RxThreadEvent_Create();
+    if(simP->rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        return false;
+    }
+    if(pthread_create(&simP->thread_rx, NULL, &rx_thread, simP))
+    {
+        fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(simP->rxThreadEvent);
+        simP->rxThreadEvent = -1;
+        return false;
+    }
+    if(pthread_create(&simP->thread_tx, NULL, &tx_thread, simP))
+    {
+        fprintf(stdout, "Failed to start tx_Thread\n");
+        RxThreadEvent_Signal(simP->rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(simP->thread_rx, NULL);
+        RxThreadEvent_Destroy(simP->rxThreadEvent);
+        simP->rxThreadEvent = -1;
+        return false;
+    }
+
+    simP->running = true;
+    return true;
+}
+
+void ModuleSimulator_Stop(ModuleSimulator_t *simP)
+{
+    if((simP == NULL) || (false == simP->running))
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&simP->mutex);
+    simP->stop = true;
+    pthread_cond_signal(&simP->cond);
+    pthread_mutex_unlock(&simP->mutex);
+    RxThreadEvent_Signal(simP->rxThreadEvent, RXTHREAD_EVENT_ABORT);
+
+    pthread_join(simP->thread_rx, NULL);
+    pthread_join(simP->thread_tx, NULL);
+    RxThreadEvent_Destroy(simP->rxThreadEvent);
+    simP->rxThreadEvent = -1;
+    simP->running = false;
+}
+
+void ModuleSimulator_Destroy(ModuleSimulator_t *simP)
+{
+    if(simP == NULL)
+    {
+        return;
+    }
+    ModuleSimulator_Stop(simP);
+    Transport_Destroy(simP->transportP);
+    pthread_cond_destroy(&simP->cond);
+    pthread_mutex_destroy(&simP->mutex);
+    free(simP);
+}
+
+void ModuleSimulator_SetPin(ModuleSimulator_t *simP, int pin_number, SetPin_Out_t out)
+{
+    int i;
+    int freeIndex = -1;
+
+    if(simP == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&simP->mutex);
+    for(i = 0; i < SIM_PIN_COUNT; i++)
+    {
+        if(simP->pins[i].pin == pin_number + 1)
+        {
+            break;
+        }
+        if((freeIndex < 0) && (simP->pins[i].pin == 0))
+        {
+            freeIndex = i;
+        }
+    }
+    if(i == SIM_PIN_COUNT)
+    {
+        /* pins are stored with an offset of 1, so that 0 marks a free entry */
+        i = freeIndex;
+        if(i >= 0)
+        {
+            simP->pins[i].pin = pin_number + 1;
+            simP->pins[i].low = false;
+        }
+    }
+    if(i >= 0)
+    {
+        if(out == SetPin_Out_Low)
+        {
+            simP->pins[i].low = true;
+        }
+        else if(simP->pins[i].low)
+        {
+            /* rising edge of the reset or wakeup pin */
+            simP->pins[i].low = false;
+            Boot(simP);
+        }
+    }
+    pthread_mutex_unlock(&simP->mutex);
+}
+
+void ModuleSimulator_PinCallback(Transport_t *transportP, const PtyTransport_PinEvent_t *eventP, void *contextP)
+{
+    /* a pin configured as input is pulled up by the module */
+    ModuleSimulator_SetPin((ModuleSimulator_t*)contextP, eventP->pin_number, (eventP->inout == SetPin_InputOutput_Input) ? SetPin_Out_High : eventP->out);
+}
+
+bool ModuleSimulator_SetUserSetting(ModuleSimulator_t *simP, uint8_t index, const uint8_t *valueP, uint8_t length)
+{
+    if((simP == NULL) || (valueP == NULL) || (length == 0))
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&simP->mutex);
+    if(simP->config.module == ModuleSimulator_Module_Metis)
+    {
+        if((uint16_t)index + length > sizeof(simP->memory))
+        {
+            pthread_mutex_unlock(&simP->mutex);
+            return false;
+        }
+        memcpy(&simP->memory[index], valueP, length);
+    }
+    else
+    {
+        if(length > SIM_MAX_SETTING_LENGTH)
+        {
+            pthread_mutex_unlock(&simP->mutex);
+            return false;
+        }
+        simP->settings[index].length = length;
+        memcpy(simP->settings[index].value, valueP, length);
+    }
+    pthread_mutex_unlock(&simP->mutex);
+    return true;
+}
+
+void ModuleSimulator_SetIndicationRate(ModuleSimulator_t *simP, unsigned int rate_hz)
+{
+    if(simP == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&simP->mutex);
+    simP->config.ind_rate_hz = rate_hz;
+    GetTime(&simP->nextIndication);
+    pthread_cond_signal(&simP->cond);
+    pthread_mutex_unlock(&simP->mutex);
+}
+
+void ModuleSimulator_GetStatistics(ModuleSimulator_t *simP, ModuleSimulator_Statistics_t *statisticsP)
+{
+    if((simP == NULL) || (statisticsP == NULL))
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&simP->mutex);
+    *statisticsP = simP->statistics;
+    pthread_mutex_unlock(&simP->mutex);
+
+    statisticsP->cpuTime_us = 0;
+    if(simP->running)
+    {
+        statisticsP->cpuTime_us = GetThreadCpuTime_us(simP->thread_rx) + GetThreadCpuTime_us(simP->thread_tx);
+    }
+}
+
+/**************************************
+ *         Static functions           *
+ **************************************/
+
+/* parse the requests of the driver */
+static void *rx_thread(void *pArgs)
+{
+    ModuleSimulator_t *simP = pArgs;
+    uint8_t chunk[SIM_RX_CHUNK_SIZE];
+    size_t got;
+    size_t i;
+
+    while(1)
+    {
+        Serial_RxWait_t rxWait = Transport_WaitForRxData(simP->transportP, simP->rxThreadEvent, -1);
+        if(rxWait == Serial_RxWait_Event)
+        {
+            if(RxThreadEvent_Read(simP->rxThreadEvent) & RXTHREAD_EVENT_ABORT)
+            {
+                return NULL;
+            }
+            continue;
+        }
+        else if(rxWait == Serial_RxWait_Error)
+        {
+            /* no driver attached to a pty created by the driver transport */
+            delay(10);
+            continue;
+        }
+        else if(rxWait != Serial_RxWait_Data)
+        {
+            continue;
+        }
+
+        while(Transport_ReadBytes(simP->transportP, chunk, sizeof(chunk), &got, 0) && (got > 0))
+        {
+            pthread_mutex_lock(&simP->mutex);
+            simP->statistics.bytesReceived += got;
+            pthread_mutex_unlock(&simP->mutex);
+            for(i = 0; i < got; i++)
+            {
+                HandleRxByte(simP, chunk[i]);
+            }
+        }
+    }
+    return NULL;
+}
+
+/* send the answers when they are due and generate the indications */
+static void *tx_thread(void *pArgs)
+{
+    ModuleSimulator_t *simP = pArgs;
+    struct iovec iov[SIM_SEND_BATCH];
+    bool isIndication[SIM_SEND_BATCH];
+    struct timespec now, deadline;
+    int count, i;
+
+    pthread_mutex_lock(&simP->mutex);
+    while(false == simP->stop)
+    {
+        GetTime(&now);
+        count = 0;
+
+        /* answers due, earliest first */
+        while(count < SIM_SEND_BATCH)
+        {
+            Sim_Frame_t *frameP = NULL;
+            for(i = 0; i < SIM_QUEUE_LENGTH; i++)
+            {
+                Sim_Frame_t *candidateP = &simP->queue[i];
+                if(candidateP->used && (false == IsBefore(&now, &candidateP->due)) &&
+                   ((frameP == NULL) || IsBefore(&candidateP->due, &frameP->due) ||
+                    ((false == IsBefore(&frameP->due, &candidateP->due)) && (candidateP->order < frameP->order))))
+                {
+                    frameP = candidateP;
+                }
+            }
+            if(frameP == NULL)
+            {
+                break;
+            }
+            memcpy(simP->txBatch[count], frameP->data, frameP->length);
+            iov[count].iov_base = simP->txBatch[count];
+            iov[count].iov_len = frameP->length;
+            isIndication[count] = frameP->indication;
+            frameP->used = false;
+            count++;
+        }
+
+        /* startup frame repeated for drivers without pin access */
+        if((simP->config.announce_ms != 0) && (false == simP->requestSeen) && (false == IsBefore(&now, &simP->nextAnnounce)))
+        {
+            AddTime(&simP->nextAnnounce, (uint64_t)simP->config.announce_ms * 1000);
+            simP->protocolP->startup(simP, 0);
+        }
+
+        /* ProteusIII peer connecting and disconnecting, while announcing only after the driver is up */
+        if(simP->connectPending && ((simP->config.announce_ms == 0) || simP->requestSeen) && (false == IsBefore(&now, &simP->nextConnectEvent)))
+        {
+            if(simP->channelOpen)
+            {
+                ProteusIII_Disconnect(simP, 0, 0x13);
+                simP->nextConnectEvent = now;
+                AddTime(&simP->nextConnectEvent, SIM_RECONNECT_GAP_US);
+            }
+            else
+            {
+                ProteusIII_Connect(simP, 0);
+                simP->connectPending = (simP->config.reconnect_ms != 0);
+                simP->nextConnectEvent = now;
+                AddTime(&simP->nextConnectEvent, (uint64_t)simP->config.reconnect_ms * 1000);
+            }
+        }
+
+        /* ProteusIII peer writing local pins */
+        if((simP->config.gpio_rate_hz != 0) && simP->channelOpen && (false == IsBefore(&now, &simP->nextGPIOEvent)))
+        {
+            struct timespec lag = simP->nextGPIOEvent;
+            AddTime(&lag, SIM_MAX_LAG_US);
+            if(IsBefore(&lag, &now))
+            {
+                simP->nextGPIOEvent = now;
+            }
+            ProteusIII_GPIOEvent(simP);
+            AddTime(&simP->nextGPIOEvent, 1000000 / simP->config.gpio_rate_hz);
+        }
+
+        /* data indications */
+        if((simP->config.ind_rate_hz != 0) && simP->booted &&
+           ((simP->config.module != ModuleSimulator_Module_ProteusIII) || simP->channelOpen))
+        {
+            struct timespec lag = simP->nextIndication;
+            AddTime(&lag, SIM_MAX_LAG_US);
+            if(IsBefore(&lag, &now))
+            {
+                /* do not send a burst after a stall */
+                simP->nextIndication = now;
+            }
+            while((count < SIM_SEND_BATCH) && (false == IsBefore(&now, &simP->nextIndication)))
+            {
+                iov[count].iov_base = simP->txBatch[count];
+                iov[count].iov_len = simP->protocolP->indication(simP, simP->txBatch[count]);
+                isIndication[count] = true;
+                count++;
+                AddTime(&simP->nextIndication, 1000000 / simP->config.ind_rate_hz);
+            }
+        }
+
+        if(count > 0)
+        {
+            size_t bytes = 0;
+            int indications = 0;
+            bool ok;
+
+            for(i = 0; i < count; i++)
+            {
+                bytes += iov[i].iov_len;
+                indications += isIndication[i] ? 1 : 0;
+            }
+
+            pthread_mutex_unlock(&simP->mutex);
+            ok = Transport_SendFrame(simP->transportP, iov, count);
+            pthread_mutex_lock(&simP->mutex);
+
+            if(ok)
+            {
+                simP->statistics.indications += indications;
+                simP->statistics.confirmations += count - indications;
+                simP->statistics.bytesSent += bytes;
+            }
+            else
+            {
+                simP->statistics.droppedFrames += count;
+            }
+            continue;
+        }
+
+        /* sleep until the next frame is due or the state changed */
+        deadline = now;
+        AddTime(&deadline, 1000000);
+        for(i = 0; i < SIM_QUEUE_LENGTH; i++)
+        {
+            if(simP->queue[i].used && IsBefore(&simP->queue[i].due, &deadline))
+            {
+                deadline = simP->queue[i].due;
+            }
+        }
+        if((simP->config.announce_ms != 0) && (false == simP->requestSeen) && IsBefore(&simP->nextAnnounce, &deadline))
+        {
+            deadline = simP->nextAnnounce;
+        }
+        if(simP->connectPending && ((simP->config.announce_ms == 0) || simP->requestSeen) && IsBefore(&simP->nextConnectEvent, &deadline))
+        {
+            deadline = simP->nextConnectEvent;
+        }
+        if((simP->config.gpio_rate_hz != 0) && simP->channelOpen && IsBefore(&simP->nextGPIOEvent, &deadline))
+        {
+            deadline = simP->nextGPIOEvent;
+        }
+        if((simP->config.ind_rate_hz != 0) && simP->booted &&
+           ((simP->config.module != ModuleSimulator_Module_ProteusIII) || simP->channelOpen) &&
+           IsBefore(&simP->nextIndication, &deadline))
+        {
+            deadline = simP->nextIndication;
+        }
+        pthread_cond_timedwait(&simP->cond, &simP->mutex, &deadline);
+    }
+    pthread_mutex_unlock(&simP->mutex);
+    return NULL;
+}
+
+/* collect a request frame byte by byte and hand it to the module */
+static void HandleRxByte(ModuleSimulator_t *simP, uint8_t byte)
+{
+    const Sim_Protocol_t *protocolP = simP->protocolP;
+    uint16_t headerLength = 2 + protocolP->lengthBytes;
+    uint8_t checksum = 0;
+    uint16_t i;
+
+    if((simP->rxIndex == 0) && (byte != protocolP->stx))
+    {
+        return;
+    }
+    simP->rxFrame[simP->rxIndex++] = byte;
+
+    if(simP->rxIndex == headerLength)
+    {
+        simP->rxLength = simP->rxFrame[2];
+        if(protocolP->lengthBytes == 2)
+        {
+            simP->rxLength |= (uint16_t)simP->rxFrame[3] << 8;
+        }
+        if(simP->rxLength > SIM_MAX_DATA_LENGTH)
+        {
+            /* no valid frame, wait for the next STX */
+            simP->rxIndex = 0;
+        }
+        return;
+    }
+    if((simP->rxIndex < headerLength) || (simP->rxIndex < headerLength + simP->rxLength + 1))
+    {
+        return;
+    }
+
+    /* complete frame received */
+    simP->rxIndex = 0;
+    for(i = 0; i < headerLength + simP->rxLength; i++)
+    {
+        checksum ^= simP->rxFrame[i];
+    }
+
+    pthread_mutex_lock(&simP->mutex);
+    if(checksum != simP->rxFrame[headerLength + simP->rxLength])
+    {
+        simP->statistics.checksumErrors++;
+    }
+    else
+    {
+        simP->statistics.requests++;
+        simP->requestSeen = true;
+        simP->booted = true;
+        protocolP->handleRequest(simP, simP->rxFrame[1], &simP->rxFrame[headerLength], simP->rxLength);
+        pthread_cond_signal(&simP->cond);
+    }
+    pthread_mutex_unlock(&simP->mutex);
+}
+
+/* restart the module after its reset or wakeup pin rose, called with the mutex held */
+static void Boot(ModuleSimulator_t *simP)
+{
+    int i;
+
+    /* a reset drops everything the module was about to send */
+    for(i = 0; i < SIM_QUEUE_LENGTH; i++)
+    {
+        simP->queue[i].used = false;
+    }
+    simP->channelOpen = false;
+    simP->connectPending = false;
+    simP->booted = true;
+    simP->protocolP->startup(simP, simP->config.boot_ms * 1000);
+    GetTime(&simP->nextIndication);
+    AddTime(&simP->nextIndication, (uint64_t)simP->config.boot_ms * 1000);
+    pthread_cond_signal(&simP->cond);
+}
+
+/* queue a frame to be sent after delay_us, called with the mutex held */
+static bool QueueFrame(ModuleSimulator_t *simP, unsigned int delay_us, bool indication, uint8_t cmd, const uint8_t *headerP, uint16_t header_length, const uint8_t *payloadP, uint16_t payload_length)
+{
+    int i;
+
+    if(header_length + payload_length > SIM_MAX_DATA_LENGTH)
+    {
+        simP->statistics.droppedFrames++;
+        return false;
+    }
+    for(i = 0; i < SIM_QUEUE_LENGTH; i++)
+    {
+        if(false == simP->queue[i].used)
+        {
+            Sim_Frame_t *frameP = &simP->queue[i];
+            GetTime(&frameP->due);
+            AddTime(&frameP->due, delay_us);
+            frameP->order = simP->order++;
+            frameP->indication = indication;
+            frameP->length = BuildFrame(simP->protocolP, frameP->data, cmd, headerP, header_length, payloadP, payload_length);
+            frameP->used = true;
+            pthread_cond_signal(&simP->cond);
+            return true;
+        }
+    }
+    simP->statistics.droppedFrames++;
+    return false;
+}
+
+/* add STX, command, length and checksum to a payload given in two parts */
+static uint16_t BuildFrame(const Sim_Protocol_t *protocolP, uint8_t *frameP, uint8_t cmd, const uint8_t *headerP, uint16_t header_length, const uint8_t *payloadP, uint16_t payload_length)
+{
+    uint16_t length = header_length + payload_length;
+    uint16_t index = 0;
+    uint8_t checksum = 0;
+    uint16_t i;
+
+    frameP[index++] = protocolP->stx;
+    frameP[index++] = cmd;
+    frameP[index++] = (uint8_t)(length >> 0);
+    if(protocolP->lengthBytes == 2)
+    {
+        frameP[index++] = (uint8_t)(length >> 8);
+    }
+    if(header_length > 0)
+    {
+        memcpy(&frameP[index], headerP, header_length);
+        index += header_length;
+    }
+    if(payload_length > 0)
+    {
+        memcpy(&frameP[index], payloadP, payload_length);
+        index += payload_length;
+    }
+    for(i = 0; i < index; i++)
+    {
+        checksum ^= frameP[i];
+    }
+    frameP[index++] = checksum;
+    return index;
+}
+
+/* processing time of a request, called with the mutex held */
+static unsigned int Latency(ModuleSimulator_t *simP)
+{
+    if(simP->config.jitter_us == 0)
+    {
+        return simP->config.latency_us;
+    }
+    return simP->config.latency_us + (unsigned int)(rand_r(&simP->seed) % (simP->config.jitter_us + 1));
+}
+
+/* indication payload: sequence number (little endian) followed by a counting pattern */
+static void FillPayload(ModuleSimulator_t *simP, uint8_t *payloadP, uint16_t length)
+{
+    uint32_t sequence = simP->indicationSequence++;
+    uint16_t i;
+
+    for(i = 0; i < length; i++)
+    {
+        payloadP[i] = (i < sizeof(sequence)) ? (uint8_t)(sequence >> (8 * i)) : (uint8_t)i;
+    }
+}
+
+static void Confirm(ModuleSimulator_t *simP, uint8_t cmd, uint8_t status)
+{
+    QueueFrame(simP, Latency(simP), false, cmd, &status, 1, NULL, 0);
+}
+
+/* GET_CNF with status and value of a user setting (ProteusIII, ThyoneI, TarvosIII) */
+static void GetSetting(ModuleSimulator_t *simP, uint8_t cnf, uint8_t index)
+{
+    Sim_Setting_t *settingP = &simP->settings[index];
+    uint8_t status = STATUS_SUCCESS;
+
+    if(settingP->length == 0)
+    {
+        Confirm(simP, cnf, STATUS_FAILED);
+        return;
+    }
+    QueueFrame(simP, Latency(simP), false, cnf, &status, 1, settingP->value, settingP->length);
+}
+
+/* SET_CNF after storing the value of a user setting (ProteusIII, ThyoneI, TarvosIII) */
+static void SetSetting(ModuleSimulator_t *simP, uint8_t cnf, const uint8_t *dataP, uint16_t length)
+{
+    if((length < 2) || (length - 1 > SIM_MAX_SETTING_LENGTH))
+    {
+        Confirm(simP, cnf, STATUS_FAILED);
+        return;
+    }
+    simP->settings[dataP[0]].length = length - 1;
+    memcpy(simP->settings[dataP[0]].value, &dataP[1], length - 1);
+    Confirm(simP, cnf, STATUS_SUCCESS);
+}
+
+/*
+ * ProteusIII
+ */
+
+static void ProteusIII_Connect(ModuleSimulator_t *simP, unsigned int delay_us)
+{
+    uint8_t status = STATUS_SUCCESS;
+    uint8_t channelOpen[1 + sizeof(peerBTMAC) + 1];
+
+    QueueFrame(simP, delay_us, true, P3_CMD_CONNECT_IND, &status, 1, peerBTMAC, sizeof(peerBTMAC));
+
+    /* status, BTMAC and maximum payload */
+    channelOpen[0] = status;
+    memcpy(&channelOpen[1], peerBTMAC, sizeof(peerBTMAC));
+    channelOpen[1 + sizeof(peerBTMAC)] = P3_MAX_PAYLOAD;
+    QueueFrame(simP, delay_us, true, P3_CMD_CHANNELOPEN_RSP, channelOpen, sizeof(channelOpen), NULL, 0);
+    simP->channelOpen = true;
+    simP->phy = P3_PHY_1MBIT;
+    GetTime(&simP->linkAnchor);
+    AddTime(&simP->linkAnchor, delay_us);
+    simP->linkFree = simP->linkAnchor;
+    simP->linkEvent = 0;
+    simP->linkEventPackets = 0;
+    GetTime(&simP->nextIndication);
+    AddTime(&simP->nextIndication, delay_us);
+    simP->nextGPIOEvent = simP->nextIndication;
+}
+
+static void ProteusIII_Disconnect(ModuleSimulator_t *simP, unsigned int delay_us, uint8_t reason)
+{
+    QueueFrame(simP, delay_us, true, P3_CMD_DISCONNECT_IND, &reason, 1, NULL, 0);
+    simP->channelOpen = false;
+}
+
+static void ProteusIII_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length)
+{
+    uint8_t cnf = cmd | CMD_TYPE_CNF;
+    unsigned int latency = Latency(simP);
+
+    switch(cmd)
+    {
+    case P3_CMD_RESET_REQ:
+    case P3_CMD_FACTORYRESET_REQ:
+        Confirm(simP, cnf, STATUS_SUCCESS);
+        simP->channelOpen = false;
+        simP->connectPending = false;
+        simP->scanning = false;
+        memset(simP->gpio, 0, sizeof(simP->gpio));
+        ProteusIII_Startup(simP, latency + simP->config.boot_ms * 1000);
+        break;
+
+    case P3_CMD_GETSTATE_REQ:
+    {
+        /* role and action: peripheral, idle or connected */
+        uint8_t state[2] = { 0x01, simP->channelOpen ? 0x03 : 0x01 };
+        QueueFrame(simP, latency, false, cnf, state, sizeof(state), NULL, 0);
+    }
+    break;
+
+    case P3_CMD_DATA_REQ:
+        if(simP->channelOpen)
+        {
+            /* buffered data is sent over the link packet by packet, the TXCOMPLETE_RSP
+             * follows once the previous packets and this one were transmitted */
+            uint8_t status = STATUS_SUCCESS;
+            struct timespec now, start;
+            GetTime(&now);
+            start = now;
+            AddTime(&start, latency);
+            if(simP->config.link_model)
+            {
+                ProteusIII_LinkTransmit(simP, &start, length);
+            }
+            else
+            {
+                if(IsBefore(&start, &simP->linkFree))
+                {
+                    start = simP->linkFree;
+                }
+                simP->linkFree = start;
+                AddTime(&simP->linkFree, simP->config.airtime_us);
+            }
+            Confirm(simP, cnf, STATUS_SUCCESS);
+            QueueFrame(simP, (unsigned int)Elapsed_us(&now, &simP->linkFree), false, P3_CMD_TXCOMPLETE_RSP, &status, 1, NULL, 0);
+            if(simP->config.echo)
+            {
+                ProteusIII_Echo(simP, (unsigned int)Elapsed_us(&now, &simP->linkFree), dataP, length);
+            }
+        }
+        else
+        {
+            Confirm(simP, cnf, STATUS_FAILED);
+        }
+        break;
+
+    case P3_CMD_CONNECT_REQ:
+        Confirm(simP, cnf, STATUS_SUCCESS);
+        ProteusIII_Connect(simP, latency + simP->config.airtime_us);
+        break;
+
+    case P3_CMD_DISCONNECT_REQ:
+        Confirm(simP, cnf, simP->channelOpen ? STATUS_SUCCESS : STATUS_FAILED);
+        if(simP->channelOpen)
+        {
+            /* connection terminated by local host */
+            ProteusIII_Disconnect(simP, latency + simP->config.airtime_us, 0x16);
+        }
+        simP->connectPending = false;
+        break;
+
+    case P3_CMD_SCANSTART_REQ:
+        Confirm(simP, cnf, STATUS_SUCCESS);
+        simP->scanning = true;
+        GetTime(&simP->scanResults);
+        break;
+
+    case P3_CMD_SCANSTOP_REQ:
+        Confirm(simP, cnf, simP->scanning ? STATUS_SUCCESS : STATUS_FAILED);
+        simP->scanning = false;
+        break;
+
+    case P3_CMD_GETDEVICES_REQ:
+        ProteusIII_ScanResults(simP, cnf, latency);
+        break;
+
+    case P3_CMD_GPIO_LOCAL_READ_REQ:
+        ProteusIII_GPIORead(simP, cnf, false, dataP, length, latency);
+        break;
+
+    case P3_CMD_GPIO_LOCAL_WRITE_REQ:
+        ProteusIII_GPIOWrite(simP, cnf, false, dataP, length, latency);
+        break;
+
+    case P3_CMD_GPIO_REMOTE_READ_REQ:
+        /* request and answer are sent over the link */
+        ProteusIII_GPIORead(simP, cnf, true, dataP, length, latency + 2 * simP->config.airtime_us);
+        break;
+
+    case P3_CMD_GPIO_REMOTE_WRITE_REQ:
+        ProteusIII_GPIOWrite(simP, cnf, true, dataP, length, latency + 2 * simP->config.airtime_us);
+        break;
+
+    case P3_CMD_GET_REQ:
+        if(length == 1)
+        {
+            GetSetting(simP, cnf, dataP[0]);
+        }
+        else
+        {
+            Confirm(simP, cnf, STATUS_FAILED);
+        }
+        break;
+
+    case P3_CMD_SET_REQ:
+        SetSetting(simP, cnf, dataP, length);
+        break;
+
+    case P3_CMD_PHYUPDATE_REQ:
+        if(simP->channelOpen && (length == 1) &&
+           ((dataP[0] == P3_PHY_1MBIT) || (dataP[0] == P3_PHY_2MBIT) || (dataP[0] == P3_PHY_CODED)))
+        {
+            /* status, PHY of RX and TX, BTMAC */
+            uint8_t phys[3] = { STATUS_SUCCESS, dataP[0], dataP[0] };
+            Confirm(simP, cnf, STATUS_SUCCESS);
+            simP->phy = dataP[0];
+            QueueFrame(simP, latency + simP->config.airtime_us, true, P3_CMD_PHYUPDATE_IND, phys, sizeof(phys), peerBTMAC, sizeof(peerBTMAC));
+        }
+        else
+        {
+            Confirm(simP, cnf, STATUS_FAILED);
+        }
+        break;
+
+    default:
+        /* sleep, passkey, GPIO configuration, ...: accepted without further action */
+        if((cmd & CMD_TYPE_RSP) == 0)
+        {
+            Confirm(simP, cnf, STATUS_SUCCESS);
+        }
+        else
+        {
+            simP->statistics.unknownRequests++;
+        }
+        break;
+    }
+}
+
+static void ProteusIII_Startup(ModuleSimulator_t *simP, unsigned int delay_us)
+{
+    /* GETSTATE_CNF with role and action sent after the module booted */
+    uint8_t state[2] = { 0x01, 0x01 };
+
+    QueueFrame(simP, delay_us, false, P3_CMD_GETSTATE_REQ | CMD_TYPE_CNF, state, sizeof(state), NULL, 0);
+
+    /* the radio settings take effect with the startup */
+    simP->connectionTiming = simP->settings[P3_SETTING_CONNECTION_TIMING].value[0];
+    simP->txPower = (int8_t)simP->settings[P3_SETTING_TX_POWER].value[0];
+
+    if(simP->config.connect && (false == simP->channelOpen) && (false == simP->connectPending))
+    {
+        simP->connectPending = true;
+        GetTime(&simP->nextConnectEvent);
+        AddTime(&simP->nextConnectEvent, delay_us + SIM_RECONNECT_GAP_US);
+    }
+}
+
+/* link model: schedule a data packet ready at *readyP and set linkFree to the end of its transmission;
+ * the packet follows the previous one within the connection event, unless the link idled, the event
+ * is full or the packet would overlap the next event, then it waits for the next connection event;
+ * lost packets are repeated, the model uses the expected air time for the packet error rate given
+ * by the margin above the sensitivity of the PHY */
+static void ProteusIII_LinkTransmit(ModuleSimulator_t *simP, const struct timespec *readyP, uint16_t length)
+{
+    size_t timing = (simP->connectionTiming < sizeof(ProteusIII_connectionInterval_us) / sizeof(ProteusIII_connectionInterval_us[0])) ? simP->connectionTiming : 0;
+    uint64_t interval_us = ProteusIII_connectionInterval_us[timing];
+    uint64_t ready_us = Elapsed_us(&simP->linkAnchor, readyP);
+    uint64_t free_us = Elapsed_us(&simP->linkAnchor, &simP->linkFree);
+    uint64_t packet_us, start_us;
+    double bitrate, sensitivity_dbm, margin_db, packetError;
+
+    switch(simP->phy)
+    {
+    case P3_PHY_2MBIT:
+        bitrate = 2000000.0;
+        sensitivity_dbm = -92.0;
+        break;
+    case P3_PHY_CODED:
+        bitrate = 125000.0;
+        sensitivity_dbm = -103.0;
+        break;
+    default:
+        bitrate = 1000000.0;
+        sensitivity_dbm = -95.0;
+        break;
+    }
+    margin_db = (double)simP->txPower - (double)simP->config.path_loss_db - sensitivity_dbm;
+    packetError = (margin_db >= 6.0) ? 0.0 : ((margin_db <= -4.0) ? 0.9 : (6.0 - margin_db) * 0.09);
+    packet_us = (uint64_t)(((double)(length + SIM_LINK_OVERHEAD + SIM_LINK_ACK_LENGTH) * 8.0 * 1000000.0 / bitrate + 2 * SIM_LINK_IFS_US) / (1.0 - packetError));
+
+    if((simP->linkEventPackets > 0) && (simP->linkEventPackets < SIM_LINK_EVENT_PACKETS) &&
+       (free_us >= ready_us) && (free_us + packet_us <= (simP->linkEvent + 1) * interval_us))
+    {
+        /* more data in the same connection event */
+        start_us = free_us;
+    }
+    else
+    {
+        /* next connection event, a packet longer than the interval delays it */
+        uint64_t event = (((ready_us > free_us) ? ready_us : free_us) + interval_us - 1) / interval_us;
+        if((simP->linkEventPackets > 0) && (event <= simP->linkEvent))
+        {
+            event = simP->linkEvent + 1;
+        }
+        simP->linkEvent = event;
+        simP->linkEventPackets = 0;
+        start_us = event * interval_us;
+    }
+    simP->linkEventPackets++;
+
+    simP->linkFree = simP->linkAnchor;
+    AddTime(&simP->linkFree, start_us + packet_us);
+}
+
+static void ProteusIII_ScanResults(ModuleSimulator_t *simP, uint8_t cnf, unsigned int delay_us)
+{
+    /* status, number of devices and per device: BTMAC, RSSI, TX power, name length and name */
+    uint8_t results[2 + SIM_SCAN_LIST_LENGTH * (9 + 8)];
+    uint16_t length = 2;
+    uint64_t heard = 0;
+    struct timespec now;
+
+    /* the module lists the devices it heard last, each device advertises once per interval */
+    if(simP->scanning && (simP->config.scan_devices > 0))
+    {
+        GetTime(&now);
+        heard = Elapsed_us(&simP->scanResults, &now) * simP->config.scan_devices / SIM_SCAN_ADV_INTERVAL_US;
+        if(heard > 0)
+        {
+            simP->scanResults = now;
+        }
+        if(heard > SIM_SCAN_LIST_LENGTH)
+        {
+            heard = SIM_SCAN_LIST_LENGTH;
+        }
+    }
+
+    results[0] = STATUS_SUCCESS;
+    results[1] = (uint8_t)heard;
+    while(heard-- > 0)
+    {
+        /* a random device, its RSSI fluctuates around a level given by its number */
+        unsigned int device = (unsigned int)rand_r(&simP->seed) % simP->config.scan_devices;
+        static const int8_t txPowers[4] = { 0, 4, -4, 8 };
+        uint8_t *entryP = &results[length];
+        char name[9];
+
+        entryP[0] = (uint8_t)(device >> 0);
+        entryP[1] = (uint8_t)(device >> 8);
+        entryP[2] = (uint8_t)(device >> 16);
+        entryP[3] = 0xDA;
+        entryP[4] = 0x18;
+        entryP[5] = 0x00;
+        entryP[6] = (uint8_t)(int8_t)(-45 - (int)(device * 37 % 50) + (rand_r(&simP->seed) % 9) - 4);
+        entryP[7] = (uint8_t)txPowers[device % 4];
+        entryP[8] = 8;
+        snprintf(name, sizeof(name), "SIM-%04X", device & 0xFFFF);
+        memcpy(&entryP[9], name, 8);
+        length += 9 + 8;
+    }
+    QueueFrame(simP, delay_us, false, cnf, results, length, NULL, 0);
+}
+
+static void ProteusIII_GPIORead(ModuleSimulator_t *simP, uint8_t cnf, bool remote, const uint8_t *dataP, uint16_t length, unsigned int delay_us)
+{
+    /* status and per pin: block length, GPIO_ID and value */
+    uint8_t values[1 + 3 * UINT8_MAX];
+    uint16_t valuesLength = 1;
+    uint8_t status = STATUS_SUCCESS;
+    int i;
+
+    /* number of pins and their GPIO_IDs */
+    if((length == 0) || (length != 1 + dataP[0]) || (remote && (false == simP->channelOpen)))
+    {
+        status = STATUS_FAILED;
+    }
+    for(i = 0; (status == STATUS_SUCCESS) && (i < dataP[0]); i++)
+    {
+        uint8_t id = dataP[1 + i];
+        if((id < 1) || (id > SIM_GPIO_PINS))
+        {
+            status = STATUS_FAILED;
+            break;
+        }
+        values[valuesLength++] = 2;
+        values[valuesLength++] = id;
+        values[valuesLength++] = simP->gpio[remote ? 1 : 0][id - 1];
+    }
+
+    values[0] = status;
+    QueueFrame(simP, delay_us, false, cnf, values, (status == STATUS_SUCCESS) ? valuesLength : 1, NULL, 0);
+}
+
+static void ProteusIII_GPIOWrite(ModuleSimulator_t *simP, uint8_t cnf, bool remote, const uint8_t *dataP, uint16_t length, unsigned int delay_us)
+{
+    uint8_t status = (remote && (false == simP->channelOpen)) ? STATUS_FAILED : STATUS_SUCCESS;
+    uint16_t position = 0;
+
+    /* per pin: block length, GPIO_ID and value */
+    while((status == STATUS_SUCCESS) && (position + 3 <= length))
+    {
+        uint8_t id = dataP[position + 1];
+        if((dataP[position] != 2) || (id < 1) || (id > SIM_GPIO_PINS))
+        {
+            status = STATUS_FAILED;
+            break;
+        }
+        simP->gpio[remote ? 1 : 0][id - 1] = dataP[position + 2];
+        position += 3;
+    }
+
+    QueueFrame(simP, delay_us, false, cnf, &status, 1, NULL, 0);
+}
+
+static void ProteusIII_GPIOEvent(ModuleSimulator_t *simP)
+{
+    /* the peer toggles a random local pin: block length, GPIO_ID and value */
+    uint8_t id = 1 + (uint8_t)(rand_r(&simP->seed) % SIM_GPIO_PINS);
+    uint8_t block[3] = { 2, id, (uint8_t)(simP->gpio[0][id - 1] ^ 1) };
+
+    simP->gpio[0][id - 1] = block[2];
+    QueueFrame(simP, 0, true, P3_CMD_GPIO_LOCAL_WRITE_IND, block, sizeof(block), NULL, 0);
+}
+
+/* the peer sends the payload of a transmitted data packet back, some packets are lost or overtaken */
+static void ProteusIII_Echo(ModuleSimulator_t *simP, unsigned int delay_us, const uint8_t *dataP, uint16_t length)
+{
+    /* BTMAC and RSSI of the sender */
+    uint8_t header[sizeof(peerBTMAC) + 1];
+
+    if((unsigned int)(rand_r(&simP->seed) % 100) < simP->config.loss_percent)
+    {
+        return;
+    }
+    if((unsigned int)(rand_r(&simP->seed) % 100) < simP->config.reorder_percent)
+    {
+        delay_us += SIM_REORDER_DELAY_US;
+    }
+    memcpy(header, peerBTMAC, sizeof(peerBTMAC));
+    header[sizeof(peerBTMAC)] = (uint8_t)-50;
+    QueueFrame(simP, delay_us, true, P3_CMD_DATA_IND, header, sizeof(header), dataP, length);
+}
+
+static uint16_t ProteusIII_Indication(ModuleSimulator_t *simP, uint8_t *frameP)
+{
+    /* BTMAC and RSSI of the sender */
+    uint8_t header[sizeof(peerBTMAC) + 1];
+    uint8_t payload[P3_MAX_PAYLOAD];
+
+    memcpy(header, peerBTMAC, sizeof(peerBTMAC));
+    header[sizeof(peerBTMAC)] = (uint8_t)-50;
+    FillPayload(simP, payload, simP->config.ind_payload_length);
+    return BuildFrame(simP->protocolP, frameP, P3_CMD_DATA_IND, header, sizeof(header), payload, simP->config.ind_payload_length);
+}
+
+/*
+ * ThyoneI
+ */
+
+static void ThyoneI_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length)
+{
+    uint8_t cnf = cmd | CMD_TYPE_CNF;
+    unsigned int latency = Latency(simP);
+
+    switch(cmd)
+    {
+    case THYONEI_CMD_RESET_REQ:
+    case THYONEI_CMD_FACTORYRESET_REQ:
+        Confirm(simP, cnf, STATUS_SUCCESS);
+        ThyoneI_Startup(simP, latency + simP->config.boot_ms * 1000);
+        break;
+
+    case THYONEI_CMD_GET_REQ:
+        if(length == 1)
+        {
+            GetSetting(simP, cnf, dataP[0]);
+        }
+        else
+        {
+            Confirm(simP, cnf, STATUS_FAILED);
+        }
+        break;
+
+    case THYONEI_CMD_SET_REQ:
+        SetSetting(simP, cnf, dataP, length);
+        break;
+
+    default:
+        if((cmd >= THYONEI_CMD_UNICAST_DATA_REQ) && (cmd <= THYONEI_CMD_MULTICAST_DATA_EX_REQ))
+        {
+            /* unicast, multicast and broadcast data requests share their confirmation */
+            uint8_t status = STATUS_SUCCESS;
+            Confirm(simP, THYONEI_CMD_DATA_CNF, STATUS_SUCCESS);
+            QueueFrame(simP, latency + simP->config.airtime_us, false, THYONEI_CMD_TXCOMPLETE_RSP, &status, 1, NULL, 0);
+        }
+        else if((cmd & CMD_TYPE_RSP) == 0)
+        {
+            Confirm(simP, cnf, STATUS_SUCCESS);
+        }
+        else
+        {
+            simP->statistics.unknownRequests++;
+        }
+        break;
+    }
+}
+
+static void ThyoneI_Startup(ModuleSimulator_t *simP, unsigned int delay_us)
+{
+    QueueFrame(simP, delay_us, false, THYONEI_CMD_START_IND, NULL, 0, NULL, 0);
+}
+
+static uint16_t ThyoneI_Indication(ModuleSimulator_t *simP, uint8_t *frameP)
+{
+    /* source address (MSB first) and RSSI */
+    uint8_t header[5] = { 0x00, 0x00, 0x00, 0x02, (uint8_t)-50 };
+    uint8_t payload[THYONEI_MAX_PAYLOAD];
+
+    FillPayload(simP, payload, simP->config.ind_payload_length);
+    return BuildFrame(simP->protocolP, frameP, THYONEI_CMD_DATA_IND, header, sizeof(header), payload, simP->config.ind_payload_length);
+}
+
+/*
+ * TarvosIII
+ */
+
+static void TarvosIII_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length)
+{
+    uint8_t cnf = cmd | CMD_TYPE_CNF;
+    unsigned int latency = Latency(simP);
+
+    switch(cmd)
+    {
+    case TARVOSIII_CMD_DATA_REQ:
+    case TARVOSIII_CMD_DATAEX_REQ:
+    {
+        /* the confirmation follows the transmission */
+        uint8_t status = STATUS_SUCCESS;
+        QueueFrame(simP, latency + simP->config.airtime_us, false, TARVOSIII_CMD_DATA_CNF, &status, 1, NULL, 0);
+    }
+    break;
+
+    case TARVOSIII_CMD_RESET_REQ:
+    case TARVOSIII_CMD_FACTORY_RESET_REQ:
+        Confirm(simP, cnf, STATUS_SUCCESS);
+        TarvosIII_Startup(simP, latency + simP->config.boot_ms * 1000);
+        break;
+
+    case TARVOSIII_CMD_SET_CHANNEL_REQ:
+    case TARVOSIII_CMD_SET_PAPOWER_REQ:
+        /* the confirmation contains the new value */
+        Confirm(simP, cnf, (length >= 1) ? dataP[0] : STATUS_FAILED);
+        break;
+
+    case TARVOSIII_CMD_GET_REQ:
+        if(length == 1)
+        {
+            GetSetting(simP, cnf, dataP[0]);
+        }
+        else
+        {
+            Confirm(simP, cnf, STATUS_FAILED);
+        }
+        break;
+
+    case TARVOSIII_CMD_SET_REQ:
+        SetSetting(simP, cnf, dataP, length);
+        break;
+
+    case TARVOSIII_CMD_PINGDUT_REQ:
+    {
+        uint8_t ping[5] = { STATUS_SUCCESS, 0x00, 0x00, 0x00, 0x0A };
+        QueueFrame(simP, latency, false, cnf, ping, sizeof(ping), NULL, 0);
+    }
+    break;
+
+    default:
+        if((cmd & CMD_TYPE_IND) == 0)
+        {
+            Confirm(simP, cnf, STATUS_SUCCESS);
+        }
+        else
+        {
+            simP->statistics.unknownRequests++;
+        }
+        break;
+    }
+}
+
+static void TarvosIII_Startup(ModuleSimulator_t *simP, unsigned int delay_us)
+{
+    QueueFrame(simP, delay_us, false, TARVOSIII_CMD_RESET_IND, NULL, 0, NULL, 0);
+}
+
+static uint16_t TarvosIII_Indication(ModuleSimulator_t *simP, uint8_t *frameP)
+{
+    /* source address as configured by the address mode, payload and RSSI */
+    uint8_t header[3] = { 0x00, 0x02, 0x00 };
+    uint8_t payload[TARVOSIII_MAX_PAYLOAD + 1];
+    uint8_t addressMode = simP->settings[TARVOSIII_SETTING_ADDRESSMODE].value[0];
+    uint16_t payload_length = simP->config.ind_payload_length;
+
+    if(addressMode > 3)
+    {
+        addressMode = 0;
+    }
+    if(payload_length + addressMode + 1 > TARVOSIII_MAX_PAYLOAD)
+    {
+        payload_length = TARVOSIII_MAX_PAYLOAD - addressMode - 1;
+    }
+    FillPayload(simP, payload, payload_length);
+    payload[payload_length] = (uint8_t)-50;
+    return BuildFrame(simP->protocolP, frameP, TARVOSIII_CMD_DATAEX_IND, header, addressMode, payload, payload_length + 1);
+}
+
+/*
+ * Metis
+ */
+
+static void Metis_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length)
+{
+    uint8_t cnf = cmd | METIS_CMD_TYPE_CNF;
+    unsigned int latency = Latency(simP);
+
+    switch(cmd)
+    {
+    case METIS_CMD_DATA_REQ:
+    {
+        /* the confirmation follows the transmission */
+        uint8_t status = STATUS_SUCCESS;
+        QueueFrame(simP, latency + simP->config.airtime_us, false, cnf, &status, 1, NULL, 0);
+    }
+    break;
+
+    case METIS_CMD_GET_REQ:
+        /* memory address and length, answered with address, length and value */
+        if((length == 2) && ((uint16_t)dataP[0] + dataP[1] <= sizeof(simP->memory)))
+        {
+            QueueFrame(simP, latency, false, cnf, dataP, 2, &simP->memory[dataP[0]], dataP[1]);
+        }
+        else
+        {
+            Confirm(simP, cnf, STATUS_FAILED);
+        }
+        break;
+
+    case METIS_CMD_SET_REQ:
+        /* memory address, length and value */
+        if((length >= 2) && (length == 2 + dataP[1]) && ((uint16_t)dataP[0] + dataP[1] <= sizeof(simP->memory)))
+        {
+            memcpy(&simP->memory[dataP[0]], &dataP[2], dataP[1]);
+            Confirm(simP, cnf, STATUS_SUCCESS);
+        }
+        else
+        {
+            Confirm(simP, cnf, STATUS_FAILED);
+        }
+        break;
+
+    case METIS_CMD_GET_SERIALNO_REQ:
+    {
+        uint8_t serialNumber[4] = { 0x00, 0x00, 0x00, 0x01 };
+        QueueFrame(simP, latency, false, cnf, serialNumber, sizeof(serialNumber), NULL, 0);
+    }
+    break;
+
+    case METIS_CMD_GET_FWRELEASE_REQ:
+    {
+        uint8_t version[3] = { 0x01, 0x00, 0x00 };
+        QueueFrame(simP, latency, false, cnf, version, sizeof(version), NULL, 0);
+    }
+    break;
+
+    default:
+        /* set mode, reset, UART speed, factory reset, ... */
+        if((cmd & METIS_CMD_TYPE_CNF) == 0)
+        {
+            Confirm(simP, cnf, STATUS_SUCCESS);
+        }
+        else
+        {
+            simP->statistics.unknownRequests++;
+        }
+        break;
+    }
+}
+
+static void Metis_Startup(ModuleSimulator_t *simP, unsigned int delay_us)
+{
+    /* the module does not announce its startup */
+}
+
+static uint16_t Metis_Indication(ModuleSimulator_t *simP, uint8_t *frameP)
+{
+    /* wM-Bus telegram, followed by the RX level if enabled */
+    uint8_t payload[METIS_MAX_PAYLOAD + 1];
+    uint16_t payload_length = simP->config.ind_payload_length;
+
+    FillPayload(simP, payload, payload_length);
+    if(simP->memory[METIS_MEMPOSITION_RSSI_ENABLE] == 0x01)
+    {
+        /* RX level of -50 dBm */
+        payload[payload_length++] = 48;
+    }
+    return BuildFrame(simP->protocolP, frameP, METIS_CMD_DATA_IND, NULL, 0, payload, payload_length);
+}
+
+/*
+ * Triton
+ */
+
+static void Triton_HandleRequest(ModuleSimulator_t *simP, uint8_t cmd, const uint8_t *dataP, uint16_t length)
+{
+    uint8_t cnf = cmd | CMD_TYPE_CNF;
+    unsigned int latency = Latency(simP);
+
+    switch(cmd)
+    {
+    case TRITON_CMD_DATAEX_REQ:
+    {
+        /* the confirmation follows the transmission */
+        uint8_t status = STATUS_SUCCESS;
+        QueueFrame(simP, latency + simP->config.airtime_us, false, cnf, &status, 1, NULL, 0);
+    }
+    break;
+
+    case TRITON_CMD_RESET_REQ:
+    case TRITON_CMD_FACTORY_RESET_REQ:
+        Confirm(simP, cnf, STATUS_SUCCESS);
+        Triton_Startup(simP, latency + simP->config.boot_ms * 1000);
+        break;
+
+    case TRITON_CMD_GET_REQ:
+        /* index and length of the setting */
+        if(length == 2)
+        {
+            GetSetting(simP, cnf, dataP[0]);
+        }
+        else
+        {
+            Confirm(simP, cnf, STATUS_FAILED);
+        }
+        break;
+
+    case TRITON_CMD_SET_REQ:
+        SetSetting(simP, cnf, dataP, length);
+        break;
+
+    case TRITON_CMD_SERIALNO_REQ:
+    {
+        uint8_t serialNumber[4] = { 0x00, 0x00, 0x00, 0x01 };
+        QueueFrame(simP, latency, false, cnf, serialNumber, sizeof(serialNumber), NULL, 0);
+    }
+    break;
+
+    case TRITON_CMD_FWVERSION_REQ:
+    {
+        uint8_t version[3] = { 0x01, 0x00, 0x00 };
+        QueueFrame(simP, latency, false, cnf, version, sizeof(version), NULL, 0);
+    }
+    break;
+
+    case TRITON_CMD_RSSI_REQ:
+        /* -48 dBm, the driver computes -120 + 8 * value */
+        Confirm(simP, cnf, 9);
+        break;
+
+    case TRITON_CMD_SET_OPMODE_REQ:
+        /* the confirmation contains the new operation mode */
+        Confirm(simP, cnf, (length >= 1) ? dataP[0] : STATUS_FAILED);
+        break;
+
+    default:
+        /* volatile channel, address, subnet and power level */
+        if((cmd & CMD_TYPE_IND) == 0)
+        {
+            Confirm(simP, cnf, STATUS_SUCCESS);
+        }
+        else
+        {
+            simP->statistics.unknownRequests++;
+        }
+        break;
+    }
+}
+
+static void Triton_Startup(ModuleSimulator_t *simP, unsigned int delay_us)
+{
+    uint8_t status = STATUS_SUCCESS;
+    QueueFrame(simP, delay_us, false, TRITON_CMD_STATUS_IND, &status, 1, NULL, 0);
+}
+
+static uint16_t Triton_Indication(ModuleSimulator_t *simP, uint8_t *frameP)
+{
+    /* source address, payload and RSSI (-48 dBm) */
+    uint8_t header[1] = { 0x02 };
+    uint8_t payload[TRITON_MAX_PAYLOAD + 1];
+    uint16_t payload_length = simP->config.ind_payload_length;
+
+    if(payload_length > TRITON_MAX_PAYLOAD)
+    {
+        payload_length = TRITON_MAX_PAYLOAD;
+    }
+    FillPayload(simP, payload, payload_length);
+    payload[payload_length] = 9;
+    return BuildFrame(simP->protocolP, frameP, TRITON_CMD_DATAEX_IND, header, sizeof(header), payload, payload_length + 1);
+}
+
+/*
+ * Time
+ */
+
+static void GetTime(struct timespec *timeP)
+{
+    clock_gettime(CLOCK_MONOTONIC, timeP);
+}
+
+static void AddTime(struct timespec *timeP, uint64_t us)
+{
+    timeP->tv_sec += us / 1000000;
+    timeP->tv_nsec += (long)(us % 1000000) * 1000;
+    if(timeP->tv_nsec >= 1000000000L)
+    {
+        timeP->tv_sec++;
+        timeP->tv_nsec -= 1000000000L;
+    }
+}
+
+static bool IsBefore(const struct timespec *aP, const struct timespec *bP)
+{
+    return (aP->tv_sec < bP->tv_sec) || ((aP->tv_sec == bP->tv_sec) && (aP->tv_nsec < bP->tv_nsec));
+}
+
+static uint64_t Elapsed_us(const struct timespec *fromP, const struct timespec *toP)
+{
+    if(IsBefore(toP, fromP))
+    {
+        return 0;
+    }
+    return (uint64_t)(toP->tv_sec - fromP->tv_sec) * 1000000 + (uint64_t)((toP->tv_nsec - fromP->tv_nsec) / 1000);
+}
+
+static uint64_t GetThreadCpuTime_us(pthread_t thread)
+{
+    clockid_t clock;
+    struct timespec ts;
+
+    if((pthread_getcpuclockid(thread, &clock) != 0) || (clock_gettime(clock, &ts) != 0))
+    {
+        return 0;
+    }
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
@@ -0,0 +1,210 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ModuleSimulator_defined
+#define _ModuleSimulator_defined
+
+/*
+ * Software model of a radio module speaking the WE command protocol
+ * (STX, CMD, LEN, DATA, XOR checksum) on a pseudo terminal.
+ *
+ * The simulator answers the *_REQ frames of the driver with the *_CNF and
+ * *_RSP frames of the module after a configurable latency and generates
+ * *_IND traffic (e.g. DATA_IND, DATAEX_IND, CONNECT_IND) at configurable
+ * rates. It either creates a pty pair and the driver attaches to the
+ * device returned by ModuleSimulator_GetPeerName (e.g. WE_PTY_DEVICE), or
+ * it attaches to the pty created by the driver transport.
+ *
+ * The simulated module boots when its reset or wakeup pin rises, see
+ * ModuleSimulator_SetPin and ModuleSimulator_PinCallback.
+ */
+
+typedef enum ModuleSimulator_Module_t
+{
+    ModuleSimulator_Module_ProteusIII = 0,
+    ModuleSimulator_Module_ThyoneI,
+    ModuleSimulator_Module_TarvosIII,
+    ModuleSimulator_Module_Metis,
+    ModuleSimulator_Module_Triton,
+    ModuleSimulator_Module_Count,
+} ModuleSimulator_Module_t;
+
+typedef struct ModuleSimulator_Config_t
+{
+    ModuleSimulator_Module_t module;
+    const char *device;             /* pty slave created by the driver transport to attach to, NULL to create a pty pair */
+    unsigned int latency_us;        /* processing time from a request to its confirmation */
+    unsigned int jitter_us;         /* random extra latency, 0 to 'jitter_us' */
+    unsigned int airtime_us;        /* time from the confirmation of a data request to its TXCOMPLETE_RSP or DATA_CNF; ProteusIII sends buffered packets one after another */
+    unsigned int boot_ms;           /* time from the rising reset pin to the startup frame */
+    unsigned int announce_ms;       /* repeat the startup frame until the first request, for drivers without pin access; 0 to disable */
+    unsigned int ind_rate_hz;       /* data indications (DATA_IND, DATAEX_IND) per second, 0 to disable */
+    uint16_t ind_payload_length;    /* payload length of the data indications */
+    bool connect;                   /* ProteusIII: a peer connects and opens the channel after the startup */
+    unsigned int reconnect_ms;      /* ProteusIII: disconnect and reconnect the peer periodically (CONNECT_IND rate), 0 to disable */
+    bool link_model;                /* ProteusIII: derive the air time of data packets from the connection timing, PHY and TX power instead of airtime_us */
+    unsigned int path_loss_db;      /* ProteusIII link model: attenuation between module and peer */
+    unsigned int scan_devices;      /* ProteusIII: devices advertising around the module, reported by GETDEVICES_CNF while scanning */
+    unsigned int gpio_rate_hz;      /* ProteusIII: the peer writes a local pin (GPIO_LOCAL_WRITE_IND) this many times per second, 0 to disable */
+    bool echo;                      /* ProteusIII: the peer sends the payload of each transmitted data packet back (DATA_IND) */
+    unsigned int loss_percent;      /* ProteusIII echo: share of the data packets sent back that are lost */
+    unsigned int reorder_percent;   /* ProteusIII echo: share of the data packets sent back that are overtaken by the next ones */
+} ModuleSimulator_Config_t;
+
+typedef struct ModuleSimulator_Statistics_t
+{
+    uint64_t requests;              /* valid request frames received */
+    uint64_t checksumErrors;        /* request frames dropped due to a wrong checksum */
+    uint64_t unknownRequests;       /* requests not supported by the simulated module */
+    uint64_t confirmations;         /* *_CNF and *_RSP frames sent */
+    uint64_t indications;           /* *_IND frames sent */
+    uint64_t droppedFrames;         /* frames not sent, because the queue was full or the driver did not read */
+    uint64_t bytesReceived;
+    uint64_t bytesSent;
+    uint64_t cpuTime_us;            /* CPU time consumed by the threads of the simulator */
+} ModuleSimulator_Statistics_t;
+
+typedef struct ModuleSimulator_t ModuleSimulator_t;
+
+/*
+ * Fill a configuration with the defaults of a module
+ *
+ * input:
+ * - module: module to simulate
+ * output:
+ * - configP: configuration
+ *
+ */
+extern void ModuleSimulator_GetDefaultConfig(ModuleSimulator_Module_t module, ModuleSimulator_Config_t *configP);
+
+/*
+ * Create a simulator and set up its pseudo terminal
+ *
+ * input:
+ * - configP: configuration, copied
+ *
+ * return: simulator, if success
+ *         NULL, otherwise
+ *
+ */
+extern ModuleSimulator_t *ModuleSimulator_Create(const ModuleSimulator_Config_t *configP);
+
+/*
+ * Get the device the driver has to open
+ *
+ * return: slave side of the pty pair created by the simulator,
+ *         NULL, if the simulator attached to the pty of the driver
+ *
+ */
+extern const char *ModuleSimulator_GetPeerName(ModuleSimulator_t *simP);
+
+/*
+ * Start answering requests and generating indications
+ *
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool ModuleSimulator_Start(ModuleSimulator_t *simP);
+
+/*
+ * Stop the threads of the simulator, the pty stays set up
+ */
+extern void ModuleSimulator_Stop(ModuleSimulator_t *simP);
+
+/*
+ * Stop the simulator if it is running and free it
+ */
+extern void ModuleSimulator_Destroy(ModuleSimulator_t *simP);
+
+/*
+ * Apply a level change of a pin of the simulated module
+ *
+ * A rising pin after it was driven low boots the module, like the
+ * reset or wakeup pin of the real module does.
+ *
+ * input:
+ * - pin_number: number of the pin
+ * - out: new level
+ *
+ */
+extern void ModuleSimulator_SetPin(ModuleSimulator_t *simP, int pin_number, SetPin_Out_t out);
+
+/*
+ * PtyTransport_PinCallback_t forwarding the pins of a driver transport,
+ * register with PtyTransport_SetPinCallback(transportP, ModuleSimulator_PinCallback, simP)
+ */
+extern void ModuleSimulator_PinCallback(Transport_t *transportP, const PtyTransport_PinEvent_t *eventP, void *contextP);
+
+/*
+ * Set a user setting of the simulated module, as if written by a SET request
+ *
+ * input:
+ * - index: index of the user setting (memory address for Metis)
+ * - valueP: value
+ * - length: length of the value
+ *
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool ModuleSimulator_SetUserSetting(ModuleSimulator_t *simP, uint8_t index, const uint8_t *valueP, uint8_t length);
+
+/*
+ * Change the rate of the data indications while running
+ *
+ * input:
+ * - rate_hz: indications per second, 0 to disable
+ *
+ */
+extern void ModuleSimulator_SetIndicationRate(ModuleSimulator_t *simP, unsigned int rate_hz);
+
+/*
+ * Copy the counters of the simulator
+ *
+ * output:
+ * - statisticsP: counters since ModuleSimulator_Create
+ *
+ */
+extern void ModuleSimulator_GetStatistics(ModuleSimulator_t *simP, ModuleSimulator_Statistics_t *statisticsP);
+
+/*
+ * Get the module name, e.g. "ProteusIII"
+ */
+extern const char *ModuleSimulator_GetModuleName(ModuleSimulator_Module_t module);
+
+#endif // _ModuleSimulator_defined
+#ifdef __cplusplus
+}
+#endif
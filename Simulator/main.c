@@ -0,0 +1,437 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Module simulator: runs a simulated ProteusIII, ThyoneI, TarvosIII, Metis or Triton
+ * on a pseudo terminal, so that the drivers and example programs can be run,
+ * measured and tested without a module (see ModuleSimulator.h).
+ *
+ * Typical use with a program built with the pty backend (target "Pty"):
+ *
+ *   Simulator -m ProteusIII -p /tmp/pins -r 100
+ *   WE_PTY_DEVICE=<printed device> WE_PTY_PIN_EVENTS=/tmp/pins ./Example_ProteusIII
+ *
+ * A Calypso is simulated on the AT command level, its sockets, MQTT clients
+ * and files are backed by those of the host (see CalypsoSimulator.h):
+ *
+ *   Simulator -m Calypso -f /tmp/calypso_files
+ *   WE_PTY_DEVICE=<printed device> ./Example_Calypso
+ *
+ * The simulator prints its counters once per second until it is stopped with Ctrl+C.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+#include "ModuleSimulator.h"
+#include "CalypsoSimulator.h"
+
+#define SIMULATOR_MAX_SETTINGS  16
+
+static void Usage(const char *program);
+static int CalypsoMain(int argc, char *argv[]);
+static bool ParseSetting(const char *argP, uint8_t *indexP, uint8_t *valueP, uint8_t *lengthP);
+static void *pin_thread(void *pArgs);
+static void StopHandler(int signal);
+
+static ModuleSimulator_t *simP = NULL;
+static volatile sig_atomic_t stopRequested = 0;
+static int pinFifoFd = -1;
+
+int main(int argc, char *argv[])
+{
+    ModuleSimulator_Config_t config;
+    ModuleSimulator_Module_t module = ModuleSimulator_Module_ProteusIII;
+    const char *pinFifo = NULL;
+    struct { uint8_t index; uint8_t length; uint8_t value[32]; } settings[SIMULATOR_MAX_SETTINGS];
+    int settingCount = 0;
+    int pinFifoWriteFd = -1;
+    pthread_t thread_pins;
+    int opt, i;
+
+    /* the module has to be known first, as it selects the defaults of the other options */
+    for(i = 1; i < argc - 1; i++)
+    {
+        if(strcmp(argv[i], "-m") == 0)
+        {
+            if(strcasecmp(argv[i + 1], "Calypso") == 0)
+            {
+                return CalypsoMain(argc, argv);
+            }
+            for(module = 0; module < ModuleSimulator_Module_Count; module++)
+            {
+                if(strcasecmp(argv[i + 1], ModuleSimulator_GetModuleName(module)) == 0)
+                {
+                    break;
+                }
+            }
+            if(module == ModuleSimulator_Module_Count)
+            {
+                Usage(argv[0]);
+                return 1;
+            }
+        }
+    }
+    ModuleSimulator_GetDefaultConfig(module, &config);
+
+    while((opt = getopt(argc, argv, "m:d:p:l:j:a:b:A:r:n:c:NL:D:G:e:s:h")) != -1)
+    {
+        switch(opt)
+        {
+        case 'm':
+            break;
+        case 'd':
+            config.device = optarg;
+            break;
+        case 'p':
+            pinFifo = optarg;
+            break;
+        case 'l':
+            config.latency_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'j':
+            config.jitter_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'a':
+            config.airtime_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            config.boot_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'A':
+            config.announce_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            config.ind_rate_hz = strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            config.ind_payload_length = (uint16_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            config.reconnect_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'N':
+            config.connect = false;
+            break;
+        case 'L':
+            config.link_model = true;
+            config.path_loss_db = strtoul(optarg, NULL, 0);
+            break;
+        case 'D':
+            config.scan_devices = strtoul(optarg, NULL, 0);
+            break;
+        case 'G':
+            config.gpio_rate_hz = strtoul(optarg, NULL, 0);
+            break;
+        case 'e':
+            config.echo = true;
+            if(2 != sscanf(optarg, "%u,%u", &config.loss_percent, &config.reorder_percent))
+            {
+                Usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 's':
+            if((settingCount == SIMULATOR_MAX_SETTINGS) ||
+               (false == ParseSetting(optarg, &settings[settingCount].index, settings[settingCount].value, &settings[settingCount].length)))
+            {
+                Usage(argv[0]);
+                return 1;
+            }
+            settingCount++;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    simP = ModuleSimulator_Create(&config);
+    if(simP == NULL)
+    {
+        return 1;
+    }
+    for(i = 0; i < settingCount; i++)
+    {
+        ModuleSimulator_SetUserSetting(simP, settings[i].index, settings[i].value, settings[i].length);
+    }
+
+    if(pinFifo != NULL)
+    {
+        if((mkfifo(pinFifo, 0644) != 0) && (errno != EEXIST))
+        {
+            fprintf(stdout, "Creating the FIFO %s failed: %s\n", pinFifo, strerror(errno));
+            ModuleSimulator_Destroy(simP);
+            return 1;
+        }
+        /* keep a writer open, so that the FIFO does not report a hang up between two driver runs */
+        pinFifoFd = open(pinFifo, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        pinFifoWriteFd = open(pinFifo, O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if((pinFifoFd < 0) || (pinFifoWriteFd < 0) || pthread_create(&thread_pins, NULL, &pin_thread, NULL))
+        {
+            fprintf(stdout, "Reading the pin events from %s failed\n", pinFifo);
+            ModuleSimulator_Destroy(simP);
+            return 1;
+        }
+    }
+
+    signal(SIGINT, StopHandler);
+    signal(SIGTERM, StopHandler);
+
+    if(false == ModuleSimulator_Start(simP))
+    {
+        ModuleSimulator_Destroy(simP);
+        return 1;
+    }
+
+    fprintf(stdout, COLOR_CYAN "Simulated %s on %s" COLOR_RESET "\n", ModuleSimulator_GetModuleName(config.module),
+            (ModuleSimulator_GetPeerName(simP) != NULL) ? ModuleSimulator_GetPeerName(simP) : config.device);
+    fprintf(stdout, "latency %u us (+%u us jitter), airtime %u us, %u indications/s with %u bytes\n",
+            config.latency_us, config.jitter_us, config.airtime_us, config.ind_rate_hz, config.ind_payload_length);
+    fflush(stdout);
+
+    while(0 == stopRequested)
+    {
+        ModuleSimulator_Statistics_t statistics;
+
+        sleep(1);
+        ModuleSimulator_GetStatistics(simP, &statistics);
+        fprintf(stdout, "requests %llu, confirmations %llu, indications %llu, checksum errors %llu, dropped %llu\n",
+                (unsigned long long)statistics.requests, (unsigned long long)statistics.confirmations,
+                (unsigned long long)statistics.indications, (unsigned long long)statistics.checksumErrors,
+                (unsigned long long)statistics.droppedFrames);
+        fflush(stdout);
+    }
+
+    ModuleSimulator_Destroy(simP);
+    if(pinFifoFd >= 0)
+    {
+        close(pinFifoWriteFd);
+    }
+    return 0;
+}
+
+static void Usage(const char *program)
+{
+    fprintf(stdout, "usage: %s [options]\n"
+            " -m module      ProteusIII, ThyoneI, TarvosIII, Metis, Triton or Calypso\n"
+            "                (default ProteusIII)\n"
+            " -d device      attach to the pty created by the driver instead of creating one\n"
+            " -p fifo        read the pin events of the driver from this FIFO (WE_PTY_PIN_EVENTS)\n"
+            " -l us          latency of the confirmations\n"
+            " -j us          random extra latency\n"
+            " -a us          airtime of a data request\n"
+            " -b ms          boot time after a reset\n"
+            " -A ms          repeat the startup frame until the first request\n"
+            " -r rate        data indications per second\n"
+            " -n length      payload length of the data indications\n"
+            " -c ms          ProteusIII: disconnect and reconnect the peer periodically\n"
+            " -N             ProteusIII: no peer connects after the startup\n"
+            " -L dB          ProteusIII: air time by the link model with this path loss,\n"
+            "                from connection timing, PHY and TX power instead of -a\n"
+            " -D count       ProteusIII: devices advertising around the module, found by a scan\n"
+            " -G rate        ProteusIII: writes of a local pin by the peer per second (GPIO_LOCAL_WRITE_IND)\n"
+            " -e loss,reorder ProteusIII: the peer sends each data packet back, losing and\n"
+            "                reordering the given percentages of them, e.g. -e 0,0\n"
+            " -s index=hex   preset a user setting, e.g. -s 0x04=01\n"
+            "Calypso options: -d, -l and -b as above and\n"
+            " -w ms          time from AT+wlanConnect to the connect and IP events\n"
+            " -f directory   host directory of the module files\n"
+            " -i address     IPv4 address reported to the driver\n", program);
+}
+
+/* run a simulated Calypso, which has its own configuration */
+static int CalypsoMain(int argc, char *argv[])
+{
+    CalypsoSimulator_Config_t config;
+    CalypsoSimulator_t *calypsoP;
+    int opt;
+
+    CalypsoSimulator_GetDefaultConfig(&config);
+    while((opt = getopt(argc, argv, "m:d:l:b:w:f:i:h")) != -1)
+    {
+        switch(opt)
+        {
+        case 'm':
+            break;
+        case 'd':
+            config.device = optarg;
+            break;
+        case 'l':
+            config.latency_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            config.boot_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            config.connect_ms = strtoul(optarg, NULL, 0);
+            break;
+        case 'f':
+            config.fileRoot = optarg;
+            break;
+        case 'i':
+            config.ipAddress = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    calypsoP = CalypsoSimulator_Create(&config);
+    if(calypsoP == NULL)
+    {
+        return 1;
+    }
+
+    signal(SIGINT, StopHandler);
+    signal(SIGTERM, StopHandler);
+
+    if(false == CalypsoSimulator_Start(calypsoP))
+    {
+        CalypsoSimulator_Destroy(calypsoP);
+        return 1;
+    }
+
+    fprintf(stdout, COLOR_CYAN "Simulated Calypso on %s" COLOR_RESET "\n",
+            (CalypsoSimulator_GetPeerName(calypsoP) != NULL) ? CalypsoSimulator_GetPeerName(calypsoP) : config.device);
+    fprintf(stdout, "latency %u us, files in %s, IP address %s\n", config.latency_us, config.fileRoot, config.ipAddress);
+    fflush(stdout);
+
+    while(0 == stopRequested)
+    {
+        CalypsoSimulator_Statistics_t statistics;
+
+        sleep(1);
+        CalypsoSimulator_GetStatistics(calypsoP, &statistics);
+        fprintf(stdout, "commands %llu, errors %llu, events %llu, socket tx/rx %llu/%llu bytes, MQTT tx/rx %llu/%llu, file write/read %llu/%llu bytes\n",
+                (unsigned long long)statistics.commands, (unsigned long long)statistics.errors, (unsigned long long)statistics.events,
+                (unsigned long long)statistics.socketBytesSent, (unsigned long long)statistics.socketBytesReceived,
+                (unsigned long long)statistics.mqttPublished, (unsigned long long)statistics.mqttReceived,
+                (unsigned long long)statistics.fileBytesWritten, (unsigned long long)statistics.fileBytesRead);
+        fflush(stdout);
+    }
+
+    CalypsoSimulator_Destroy(calypsoP);
+    return 0;
+}
+
+/* parse "index=value" with the value given as hex bytes */
+static bool ParseSetting(const char *argP, uint8_t *indexP, uint8_t *valueP, uint8_t *lengthP)
+{
+    char *endP;
+    unsigned long index = strtoul(argP, &endP, 0);
+    size_t length;
+    size_t i;
+
+    if((*endP != '=') || (index > 0xFF))
+    {
+        return false;
+    }
+    endP++;
+    length = strlen(endP);
+    if((length == 0) || (length % 2 != 0) || (length / 2 > 32))
+    {
+        return false;
+    }
+    for(i = 0; i < length / 2; i++)
+    {
+        unsigned int byte;
+        if(sscanf(&endP[2 * i], "%2x", &byte) != 1)
+        {
+            return false;
+        }
+        valueP[i] = (uint8_t)byte;
+    }
+    *indexP = (uint8_t)index;
+    *lengthP = (uint8_t)(length / 2);
+    return true;
+}
+
+/* apply the lines "pin <number> <in|out> <no|up|down> <low|high>" written by the pty backend of the driver */
+static void *pin_thread(void *pArgs)
+{
+    char line[128];
+    size_t fill = 0;
+
+    while(1)
+    {
+        struct pollfd pfd = { .fd = pinFifoFd, .events = POLLIN };
+        ssize_t bytesRead;
+        char *endP;
+
+        if(poll(&pfd, 1, -1) <= 0)
+        {
+            continue;
+        }
+        bytesRead = read(pinFifoFd, &line[fill], sizeof(line) - 1 - fill);
+        if(bytesRead <= 0)
+        {
+            continue;
+        }
+        fill += bytesRead;
+        line[fill] = '\0';
+
+        while((endP = strchr(line, '\n')) != NULL)
+        {
+            int pin_number;
+            char inout[8], pull[8], out[8];
+
+            *endP = '\0';
+            if(sscanf(line, "pin %d %7s %7s %7s", &pin_number, inout, pull, out) == 4)
+            {
+                /* an input is pulled up by the module */
+                bool high = (strcmp(inout, "in") == 0) || (strcmp(out, "high") == 0);
+                ModuleSimulator_SetPin(simP, pin_number, high ? SetPin_Out_High : SetPin_Out_Low);
+            }
+            fill -= (endP + 1 - line);
+            memmove(line, endP + 1, fill + 1);
+        }
+        if(fill == sizeof(line) - 1)
+        {
+            /* no line end found, drop the garbage */
+            fill = 0;
+        }
+    }
+    return NULL;
+}
+
+static void StopHandler(int signal)
+{
+    stopRequested = 1;
+}
@@ -0,0 +1,275 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Test of the order in which a CallbackExecutor_t runs its jobs: a producer
+ * thread floods the executor with numbered jobs in bursts while the callback
+ * is slow now and then, so the ring fills up and jobs pass the overflow list,
+ * also while the executor thread is between the ring and the overflow list.
+ * The jobs have to run in the order they were posted, each exactly once.
+ *
+ * Each round starts with the window between the ring and the overflow list
+ * forced: the test holds the mutex of the executor while the executor thread
+ * waits for it with an empty ring, fills the ring and posts one more job,
+ * which goes to the overflow list, but must not overtake the jobs of the ring.
+ *
+ * Usage: Test_CallbackExecutor [-r rounds] [-j jobs] [-s slow_us]
+ *
+ * return: 0, if all jobs ran in order, 1 otherwise
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "../drivers/WE-common.h"
+#include "../drivers/global/global.h"
+
+#define TEST_ROUNDS             20
+#define TEST_JOBS               20000       /* jobs posted in each round */
+#define TEST_SLOW_US            200         /* sleep of every slow job */
+#define TEST_SLOW_EVERY         97          /* every that many jobs is slow */
+
+typedef struct Test_t
+{
+    uint32_t expected;                      /* number of the next job, touched by the executor thread only */
+    uint32_t errors;
+    uint32_t slow_us;
+    bool holding;                           /* the first job of the window test runs */
+} Test_t;
+
+static void Job(void *contextP, uint8_t *frameP)
+{
+    Test_t *testP = contextP;
+    uint32_t number;
+
+    memcpy(&number, frameP, sizeof(number));
+    if(number != testP->expected)
+    {
+        if(testP->errors < 10)
+        {
+            fprintf(stdout, "Job %u ran, expected job %u\n", (unsigned)number, (unsigned)testP->expected);
+        }
+        testP->errors++;
+    }
+    testP->expected = number + 1;
+
+    if((number % TEST_SLOW_EVERY) == 0)
+    {
+        usleep(testP->slow_us);
+    }
+}
+
+/* first job of the window test, keeps the executor thread busy until the test holds the mutex */
+static void Hold(void *contextP, uint8_t *frameP)
+{
+    Test_t *testP = contextP;
+
+    Job(contextP, frameP);
+    __atomic_store_n(&testP->holding, true, __ATOMIC_RELEASE);
+    usleep(10000);
+}
+
+static void Stop(void *contextP, uint8_t *frameP)
+{
+    bool *doneP = contextP;
+    (void)frameP;
+    __atomic_store_n(doneP, true, __ATOMIC_RELEASE);
+}
+
+static bool Post(CallbackExecutor_t *executorP, FramePool_t *poolP, CallbackExecutor_Function_t function, void *contextP, uint32_t number)
+{
+    FrameBuffer_t *bufferP = FramePool_Get(poolP);
+    bool ret;
+
+    if(bufferP == NULL)
+    {
+        return false;
+    }
+    memcpy(bufferP->data, &number, sizeof(number));
+    ret = CallbackExecutor_Post(executorP, function, contextP, bufferP->data);
+    /* the executor holds its own reference until the job ran */
+    FrameBuffer_Release(bufferP);
+    return ret;
+}
+
+/* wait until the last job posted ran, and stop the executor */
+static bool Finish(CallbackExecutor_t *executorP, FramePool_t *poolP)
+{
+    bool done = false;
+    bool ret = Post(executorP, poolP, Stop, &done, 0);
+
+    if(!ret)
+    {
+        fprintf(stdout, "Post of the last job failed\n");
+    }
+    while(ret && !__atomic_load_n(&done, __ATOMIC_ACQUIRE))
+    {
+        usleep(1000);
+    }
+    CallbackExecutor_Deinit(executorP);
+    return ret;
+}
+
+/* fill the ring while the executor thread waits for the overflow list, then post one more job */
+static bool RunWindow(FramePool_t *poolP, Test_t *testP)
+{
+    CallbackExecutor_t executor;
+    bool ret = true;
+    uint32_t number;
+
+    memset(&executor, 0, sizeof(executor));
+    if(!CallbackExecutor_Init(&executor))
+    {
+        fprintf(stdout, "Init of the executor failed\n");
+        return false;
+    }
+
+    testP->expected = 0;
+    testP->holding = false;
+    ret = Post(&executor, poolP, Hold, testP, 0);
+    while(ret && !__atomic_load_n(&testP->holding, __ATOMIC_ACQUIRE))
+    {
+        usleep(100);
+    }
+
+    /* the executor thread finds the ring empty after Hold and blocks on the mutex */
+    pthread_mutex_lock(&executor.mutex);
+    usleep(20000);
+    for(number = 1; ret && (number <= CALLBACKEXECUTOR_RING_LENGTH); number++)
+    {
+        ret = Post(&executor, poolP, Job, testP, number);
+    }
+    pthread_mutex_unlock(&executor.mutex);
+    /* the ring is full, this job goes to the overflow list */
+    ret = ret && Post(&executor, poolP, Job, testP, number);
+
+    ret = Finish(&executor, poolP) && ret;
+    if(ret && (testP->expected != number + 1))
+    {
+        fprintf(stdout, "%u of %u jobs ran\n", (unsigned)testP->expected, (unsigned)(number + 1));
+        ret = false;
+    }
+    return ret && (testP->errors == 0);
+}
+
+/* post the jobs of a round and wait until all of them ran */
+static bool RunRound(FramePool_t *poolP, Test_t *testP, uint32_t jobs)
+{
+    CallbackExecutor_t executor;
+    bool ret = true;
+    uint32_t number;
+
+    memset(&executor, 0, sizeof(executor));
+    if(!CallbackExecutor_Init(&executor))
+    {
+        fprintf(stdout, "Init of the executor failed\n");
+        return false;
+    }
+
+    testP->expected = 0;
+    for(number = 0; number < jobs; number++)
+    {
+        if(!Post(&executor, poolP, Job, testP, number))
+        {
+            fprintf(stdout, "Post of job %u failed\n", (unsigned)number);
+            ret = false;
+            break;
+        }
+        /* bursts of varying length, so the ring fills at different points of the executor thread */
+        if((number % (CALLBACKEXECUTOR_RING_LENGTH + (number / 1000) % 7)) == 0)
+        {
+            usleep(testP->slow_us / 4);
+        }
+    }
+
+    ret = Finish(&executor, poolP) && ret;
+
+    if(ret && (testP->expected != jobs))
+    {
+        fprintf(stdout, "%u of %u jobs ran\n", (unsigned)testP->expected, (unsigned)jobs);
+        ret = false;
+    }
+    return ret && (testP->errors == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t rounds = TEST_ROUNDS;
+    uint32_t jobs = TEST_JOBS;
+    Test_t test;
+    FramePool_t *poolP;
+    uint32_t round;
+    bool ok = true;
+    int opt;
+
+    memset(&test, 0, sizeof(test));
+    test.slow_us = TEST_SLOW_US;
+
+    while((opt = getopt(argc, argv, "r:j:s:")) != -1)
+    {
+        switch(opt)
+        {
+        case 'r':
+            rounds = (uint32_t)atoi(optarg);
+            break;
+        case 'j':
+            jobs = (uint32_t)atoi(optarg);
+            break;
+        case 's':
+            test.slow_us = (uint32_t)atoi(optarg);
+            break;
+        default:
+            fprintf(stdout, "Usage: %s [-r rounds] [-j jobs] [-s slow_us]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    /* jobs of the overflow list hold their buffers as well, up to all jobs of a round and the last one */
+    poolP = FramePool_Create(CALLBACKEXECUTOR_RING_LENGTH, jobs + 2, sizeof(uint32_t));
+    if(poolP == NULL)
+    {
+        fprintf(stdout, "Out of memory\n");
+        return 1;
+    }
+
+    for(round = 0; round < rounds; round++)
+    {
+        if(!RunWindow(poolP, &test) || !RunRound(poolP, &test, jobs))
+        {
+            fprintf(stdout, "Round %u failed, %u jobs out of order\n", (unsigned)round, (unsigned)test.errors);
+            ok = false;
+            break;
+        }
+    }
+    FramePool_Destroy(poolP);
+
+    fprintf(stdout, "%s: %u rounds of %u jobs\n", ok ? "OK" : "FAILED", (unsigned)round, (unsigned)jobs);
+    return ok ? 0 : 1;
+}
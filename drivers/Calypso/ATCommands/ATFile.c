@@ -60,11 +60,11 @@
 * Static Globals:
 */
 
-char responseBuffer[ATFILE_MAX_BUFFER_SIZE];
-char requestBuffer[ATFILE_MAX_BUFFER_SIZE];
+static char responseBuffer[ATFILE_MAX_BUFFER_SIZE];
+static char requestBuffer[ATFILE_MAX_BUFFER_SIZE];
 
-char *pRequestCommand;
-char *pRespondCommand;
+static char *pRequestCommand;
+static char *pRespondCommand;
 
 
 static const char *ATFile_OpenOptions_Strings[] =
@@ -521,7 +521,7 @@ static bool ATFile_AddArgumentsFileWrite(char *pAtCommand, uint32_t fileID, uint
         uint32_t lengthEncoded;
         lengthEncoded = Calypso_getBase64EncBufSize(bytesToWrite);
 
-        char base64Buffer[lengthEncoded];
+        char base64Buffer[lengthEncoded + 1];   /* Calypso_encodeBase64 terminates the string */
         Calypso_encodeBase64((uint8_t *)pData, bytesToWrite, (uint8_t *)base64Buffer, &lengthEncoded);
 
         if(ret)
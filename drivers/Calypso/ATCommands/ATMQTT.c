@@ -90,11 +90,11 @@ static const char *ATMQTT_CreateFlagsStrings[] =
     "ip4", "ip6", "url", "sec", "skip_domain_verify", "skip_cert_verify", "skip_date_verify"
 };
 
-char responseBuffer[ATMQTT_MAX_BUFFER_SIZE];
-char requestBuffer[ATMQTT_MAX_BUFFER_SIZE];
+static char responseBuffer[ATMQTT_MAX_BUFFER_SIZE];
+static char requestBuffer[ATMQTT_MAX_BUFFER_SIZE];
 
-char *pRequestCommand;
-char *pRespondCommand;
+static char *pRequestCommand;
+static char *pRespondCommand;
 
 
 /*
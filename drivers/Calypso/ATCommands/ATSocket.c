@@ -118,11 +118,11 @@ static const char *AtSocketSockOptSecMethod[] =
 };
 
 
-char responseBuffer[ATSOCKET_MAX_BUFFER_SIZE];
-char requestBuffer[ATSOCKET_MAX_BUFFER_SIZE];
+static char responseBuffer[ATSOCKET_MAX_BUFFER_SIZE];
+static char requestBuffer[ATSOCKET_MAX_BUFFER_SIZE];
 
-char *pRequestCommand;
-char *pRespondCommand;
+static char *pRequestCommand;
+static char *pRespondCommand;
 /*
 * Static Globals.
 * ########################## */
@@ -459,6 +459,36 @@ bool ATSocket_send(uint8_t socketID, Calypso_DataFormat_t format, bool encodeToB
     return ret;
 }
 
+/**
+ * Sends the AT+send=[socketID],[format],[length],[data] command without waiting for the response
+ *
+ * input:
+ * -  socketID        Id of the socket which should send the data
+ * -  format          format in which the data is present. If Base64 encoding is selected, the modul will decode the data befor transmiting.
+ * -  encodeToBase64  if true, data will be encoded to Base64 prio to sending to the module.
+ * -  length          bytes to send
+ * -  pData           data to send, copied before returning
+ * -  cb              called with the result of the command
+ * -  contextP        passed to cb
+ *
+ * return true if command was queued, cb is called exactly once then
+ *        false otherwise
+ */
+bool ATSocket_sendAsync(uint8_t socketID, Calypso_DataFormat_t format, bool encodeToBase64, uint16_t length, char *pData, Calypso_CommandCallback cb, void *contextP)
+{
+    /* not requestBuffer, a blocking command of another thread may be built there */
+    char request[ATSOCKET_MAX_BUFFER_SIZE];
+
+    memset(request, 0, sizeof(request));
+    strcpy(request, "AT+send=");
+
+    if(!ATSocket_addArgumentsSend(request, socketID, format, encodeToBase64, length, pData))
+    {
+        return false;
+    }
+    return Calypso_sendRequestAsync(request, 500, cb, contextP);
+}
+
 /**
  * Sends the AT+sendTo=[socketID],[family],[remotePort],[remoteAddress],[format],[length],[data] command
  *
@@ -767,7 +797,7 @@ static bool ATSocket_addArgumentsSend(char *pAtCommand, uint8_t socketID, Calyps
         uint32_t lengthEncoded;
         lengthEncoded = Calypso_getBase64EncBufSize(length);
 
-        char base64Buffer[lengthEncoded];
+        char base64Buffer[lengthEncoded + 1];   /* Calypso_encodeBase64 terminates the string */
         Calypso_encodeBase64((uint8_t *)pData, length, (uint8_t *)base64Buffer, &lengthEncoded);
 
         if(ret)
@@ -792,11 +822,12 @@ static bool ATSocket_addArgumentsSend(char *pAtCommand, uint8_t socketID, Calyps
         {
             Calypso_appendArgumentString(pAtCommand, pData, STRING_TERMINATE);
         }
+    }
 
-        if(ret)
-        {
-            ret = Calypso_appendArgumentString(pAtCommand, CRLF,STRING_TERMINATE);
-        }
+    /* the line is terminated for Base64 encoded data as well */
+    if(ret)
+    {
+        ret = Calypso_appendArgumentString(pAtCommand, CRLF,STRING_TERMINATE);
     }
 
     return ret;
@@ -845,7 +876,7 @@ static bool ATSocket_addArgumentsSendTo(char *pAtCommand, uint8_t socketID, ATSo
         uint32_t lengthEncoded;
         lengthEncoded = Calypso_getBase64EncBufSize(length);
 
-        char base64Buffer[lengthEncoded];
+        char base64Buffer[lengthEncoded + 1];   /* Calypso_encodeBase64 terminates the string */
         Calypso_encodeBase64((uint8_t *)pData, length, (uint8_t *)base64Buffer, &lengthEncoded);
 
         if(ret)
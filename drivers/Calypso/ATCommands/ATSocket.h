@@ -150,6 +150,7 @@ extern bool ATSocket_getSockOpt(uint8_t socketID, uint8_t level, uint8_t option,
 extern bool ATSocket_recv(uint8_t socketID, Calypso_DataFormat_t format, uint16_t length);
 extern bool ATSocket_recvFrom(uint8_t socketID, ATSocket_Descriptor_t socket, Calypso_DataFormat_t format, uint16_t length);
 extern bool ATSocket_send(uint8_t socketID, Calypso_DataFormat_t format, bool encodeToBase64, uint16_t length, char *pData);
+extern bool ATSocket_sendAsync(uint8_t socketID, Calypso_DataFormat_t format, bool encodeToBase64, uint16_t length, char *pData, Calypso_CommandCallback cb, void *contextP);
 extern bool ATSocket_sendTo(uint8_t socketID, ATSocket_Descriptor_t socket, Calypso_DataFormat_t format, bool encodeToBase64, uint16_t length, char *pData);
 
 
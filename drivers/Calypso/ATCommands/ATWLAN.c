@@ -141,11 +141,11 @@ static const char *ATWLAN_SecurityEAPStrings[] =
     ATWLAN_SECURITY_EAP(GENERATE_STRING)
 };
 
-char responseBuffer[ATWLAN_MAX_BUFFER_SIZE];
-char requestBuffer[ATWLAN_MAX_BUFFER_SIZE];
+static char responseBuffer[ATWLAN_MAX_BUFFER_SIZE];
+static char requestBuffer[ATWLAN_MAX_BUFFER_SIZE];
 
-char *pRequestCommand;
-char *pRespondCommand;
+static char *pRequestCommand;
+static char *pRespondCommand;
 
 /*
 * Static Globals.
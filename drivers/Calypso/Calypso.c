@@ -2,6 +2,8 @@
 * Includes:
 */
 #include <stdio.h>
+#include <errno.h>
+#include <pthread.h>
 
 #include "../WE-common.h"
 #include  "../global/global.h"
@@ -25,6 +27,8 @@
 #define CALYPSO_RESPONSE_BUFFER_SIZE 2048
 #define CALYPSO_EVENT_BUFFER_SIZE    2048
 #define CALYPSO_MAX_CMD_LENGTH               64
+#define CALYPSO_SUBMIT_TIME                  1000    /* time to wait until the previous command was answered */
+#define CALYPSO_CONFIRMATION                 (uint8_t)0  /* OK and error answer the oldest command, whatever it was */
 /*
 * Constant Macros.
 * ########################### */
@@ -41,6 +45,13 @@
 * Typedefs:
 */
 
+/* asynchronous command, stored as the context of its request, see Calypso_sendRequestAsync */
+typedef struct
+{
+    Calypso_CommandCallback callback;
+    void *contextP;
+} AsyncCommand_t;
+
 /*
 * Typedefs.
 * ########################## */
@@ -85,20 +96,23 @@ static uint8_t Calypso_base64DecTable[123] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
                                              }; /* a-z */
 
 
-static bool ResetUartRxThread;
-static bool AbortUartRxThread;
-static bool requestPending;
+static int rxThreadEvent = -1;                  /* eventfd to reset or abort the UART RX thread */
 
-static char Calypso_respndCmd[CALYPSO_LINE_MAX_SIZE];
+static char Calypso_respndCmd[CALYPSO_RESPONSE_BUFFER_SIZE];    /* response lines of the pending command, RX thread only */
 static char Calypso_eventCmd[CALYPSO_LINE_MAX_SIZE];
 static size_t lengthResponse;
 
+static CommandQueue_t cmdQueue;                         /* commands waiting for OK or error, one at a time */
+static CommandQueue_Request_t syncRequest;              /* command of Calypso_sendRequest, waited for by Calypso_Wait4CNF */
+static bool syncRequestSubmitted;
+static char syncResponse[CALYPSO_RESPONSE_BUFFER_SIZE]; /* response of syncRequest */
 
-static Calypso_CNFStatus_t cmdConfirmation;
+/* unsolicited lines besides the +event* lines, they are never part of a response */
+static const char *eventNames[] = { "+recv", "+recvfrom", "+connect", "+accept" };
 
 static char RxBuffer[CALYPSO_LINE_MAX_SIZE]; /* data buffer for RX */
 
-pthread_t thread_read;
+static pthread_t thread_read;
 
 /*
 * Static Globals.
@@ -108,10 +122,12 @@ pthread_t thread_read;
 * Static Functions:
 */
 
-void(*eventCallback)(char *); /* callback function for events*/
+static void(*eventCallback)(char *); /* callback function for events*/
 
 static void HandleRxLine(char *rxPacket, uint16_t rxLength);
-void *rx_thread();
+static bool IsEventLine(const char *lineP);
+static void AsyncCommandDone(CommandQueue_Request_t *requestP, bool answered);
+static void *rx_thread(void *argP);
 
 /*
 * Static Functions.
@@ -141,17 +157,32 @@ void *rx_thread();
  */
 bool Calypso_Init(int baudrate, Calypso_ParityBit_t parityBit, void(*evtCb)(char *))
 {
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
-    requestPending = false;
+    lengthResponse = 0;
+    syncRequestSubmitted = false;
+
+    if(!CommandQueue_Init(&cmdQueue, 1))
+    {
+        return false;
+    }
 
     eventCallback = evtCb;
     OpenSerialWithParity(baudrate, parityBit); /* calypso default: 921600 Baud 8e1 */
 
+    /* create the event to abort the rx thread */
+    rxThreadEvent = RxThreadEvent_Create();
+    if(rxThreadEvent < 0)
+    {
+        CommandQueue_Deinit(&cmdQueue);
+        return false;
+    }
+
     /* start rx thread */
     if(0 != pthread_create(&thread_read, NULL, rx_thread, NULL))
     {
-
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
+        CommandQueue_Deinit(&cmdQueue);
+        return false;
     }
     return true;
 }
@@ -164,11 +195,20 @@ bool Calypso_Init(int baudrate, Calypso_ParityBit_t parityBit, void(*evtCb)(char
  */
 bool Calypso_Deinit()
 {
-    AbortUartRxThread = true;
     eventCallback = NULL;
     CloseSerial();
 
-    pthread_cancel(thread_read);
+    /* abort rx thread */
+    if(rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(thread_read, NULL);
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
+    }
+
+    /* fails the asynchronous commands still waiting */
+    CommandQueue_Deinit(&cmdQueue);
     return true;
 }
 
@@ -181,14 +221,14 @@ bool Calypso_Deinit()
  */
 void Calypso_sendRequest(char *data)
 {
+    struct iovec frame = { .iov_base = data, .iov_len = strlen(data) };
 
-    requestPending = true;
-    lengthResponse = 0;
+    /* the request is queued before sending, the response may arrive before Calypso_Wait4CNF is called */
+    CommandQueue_InitRequest(&syncRequest, CALYPSO_CONFIRMATION, (uint8_t*)syncResponse, sizeof(syncResponse));
 #ifdef DEBUG
     printf("> %s", data);
 #endif
-    SendBytes((uint8_t *)data, strlen(data));
-
+    syncRequestSubmitted = CommandQueue_Submit(&cmdQueue, &syncRequest, GetDefaultTransport(), &frame, 1, CALYPSO_SUBMIT_TIME);
 }
 
 /**
@@ -197,7 +237,7 @@ void Calypso_sendRequest(char *data)
  * input:
  * - max_time_ms        maximum wait time in milliseconds
  * - expectedStatus     status to wait for
- * - reset_confirmstate resets the
+ * - reset_confirmstate unused, Calypso_sendRequest resets the confirmation of the request
  *
  * output:
  * - pOutResponse
@@ -206,50 +246,62 @@ void Calypso_sendRequest(char *data)
  */
 bool Calypso_Wait4CNF(int max_time_ms, Calypso_CNFStatus_t expectedStatus, bool reset_confirmstate, char *pOutResponse)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
+    (void)reset_confirmstate;
 
-    if(reset_confirmstate)
+    if(!syncRequestSubmitted)
     {
-        cmdConfirmation = Calypso_CNFStatus_Invalid;
+        return false;
     }
+    syncRequestSubmitted = false;
 
-
-    while (1)
+    if(!CommandQueue_Wait(&cmdQueue, &syncRequest, max_time_ms) || (syncRequest.status != expectedStatus))
     {
-        if(Calypso_CNFStatus_Invalid != cmdConfirmation)
-        {
-            requestPending = false;
-            if(cmdConfirmation == expectedStatus)
-            {
-                if(NULL != pOutResponse)
-                {
-                    /* copy response for further pocessign*/
-                    memcpy(pOutResponse, Calypso_respndCmd, lengthResponse);
-                }
-                return true;
-            }
-            else
-            {
-                return false;
-            }
+        return false;
+    }
 
-        }
+    if(NULL != pOutResponse)
+    {
+        /* copy response for further pocessign*/
+        memcpy(pOutResponse, syncResponse, (syncRequest.responseLength < sizeof(syncResponse)) ? syncRequest.responseLength : sizeof(syncResponse));
+    }
+    return true;
+}
 
+/**
+ *  Sends the at+command request to the module without waiting for the response
+ *
+ * input:
+ *  - data:        at command to send, copied before returning
+ *  - max_time_ms  maximum time for the response once the command was sent
+ *  - cb           called with the response lines (as Calypso_Wait4CNF outputs them) or with success false
+ *  - contextP     passed to cb
+ *
+ * note: cb is called by a thread of the driver, it must not block for long
+ *
+ * return true if the command was queued, cb is called exactly once then
+ *        false otherwise
+ */
+bool Calypso_sendRequestAsync(char *data, int max_time_ms, Calypso_CommandCallback cb, void *contextP)
+{
+    struct iovec frame = { .iov_base = data, .iov_len = strlen(data) };
 
-        if (count >= max_count)
-        {
-            /* received no correct response within timeout */
-            requestPending = false;
-            return false;
-        }
+    if(NULL == cb)
+    {
+        return false;
+    }
 
-        /* wait */
-        count++;
-        delay(time_step_ms);
+    CommandQueue_Request_t *requestP = CommandQueue_NewRequest(CALYPSO_CONFIRMATION, &frame, 1, CALYPSO_RESPONSE_BUFFER_SIZE, sizeof(AsyncCommand_t));
+    if(NULL == requestP)
+    {
+        return false;
     }
-    return false;
+    AsyncCommand_t *commandP = requestP->contextP;
+    commandP->callback = cb;
+    commandP->contextP = contextP;
+#ifdef DEBUG
+    printf("> %s", data);
+#endif
+    return CommandQueue_SubmitAsync(&cmdQueue, requestP, GetDefaultTransport(), max_time_ms, AsyncCommandDone);
 }
 
 /**
@@ -713,42 +765,51 @@ bool Calypso_encodeBase64(uint8_t *inputData, uint32_t inputLength, uint8_t *out
 * Static Functions:
 */
 
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
     uint16_t RxByteCounter = 0;
-    uint8_t readBuffer;
+    uint8_t readBuffer;                             /* byte currently interpreted */
+    uint8_t rxChunk[SERIAL_RX_CHUNK_SIZE];          /* bytes drained from the interface by one ReadBytes call */
+    size_t rxChunkLength = 0;
+    size_t rxChunkIndex;
+    Serial_RxWait_t rxWait;
     bool returnFound = false;
 
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
-
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
 
     while(1)
     {
-        /* wait for 1ms, then check if new RX data is available */
-        delay (1) ;
-
-        if(AbortUartRxThread == true)
+        /* sleep until new RX data is available or the thread is signalled */
+        rxWait = WaitForRxData(rxThreadEvent, -1);
+        if(rxWait == Serial_RxWait_Event)
         {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
+            uint64_t rxEvents = RxThreadEvent_Read(rxThreadEvent);
 
-        if(ResetUartRxThread == true)
+            if(rxEvents & RXTHREAD_EVENT_ABORT)
+            {
+                /* jump out of the while loop and finish the thread */
+                break;
+            }
+
+            if(rxEvents & RXTHREAD_EVENT_RESET)
+            {
+                /* reset the RX thread */
+                RxByteCounter = 0;
+            }
+        }
+        else if(rxWait == Serial_RxWait_Error)
         {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
+            /* interface can not be waited on, do not spin */
+            delay(1);
         }
 
-        while (BytesAvailable())
+        while (ReadBytes(rxChunk, sizeof(rxChunk), &rxChunkLength, 0) && (rxChunkLength > 0))
         {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
+            for (rxChunkIndex = 0; rxChunkIndex < rxChunkLength; rxChunkIndex++)
             {
+                /* interprete received byte */
+                readBuffer = rxChunk[rxChunkIndex];
                 switch(RxByteCounter)
                 {
                 case 0:
@@ -765,7 +826,10 @@ void *rx_thread()
 
                     if(RxByteCounter >= CALYPSO_LINE_MAX_SIZE)
                     {
-                        ResetUartRxThread = true;
+                        /* line does not fit into the buffer, drop it */
+                        RxByteCounter = 0;
+                        returnFound = false;
+                        break;
                     }
 
                     if(readBuffer == '\r')
@@ -804,55 +868,98 @@ void *rx_thread()
 
 static void HandleRxLine(char *rxPacket, uint16_t rxLength)
 {
-    /* AT command was sent to module. Waiting fot response*/
-    if(requestPending)
+    Calypso_CNFStatus_t status = Calypso_CNFStatus_Invalid;
+
+    /* If starts with 'O', check if response is "OK\r\n" */
+    if(('O' == rxPacket[0]) || ('o' == rxPacket[0]))
     {
-        /* If starts with 'O', check if response is "OK\r\n" */
-        if(('O' == rxPacket[0]) || ('o' == rxPacket[0]))
+        if(0 == strncasecmp(&rxPacket[0], RESPONSE_OK, strlen(RESPONSE_OK)))
         {
-            if(0 == strncasecmp(&rxPacket[0], RESPONSE_OK, strlen(RESPONSE_OK)))
-            {
-                cmdConfirmation = Calypso_CNFStatus_Success;
-            }
-            else
-            {
-                cmdConfirmation = Calypso_CNFStatus_Failed;
-            }
+            status = Calypso_CNFStatus_Success;
         }
-        /* If starts with 'E', check if response is "Error:[arguments]\r\n" */
-        else if(('E' == rxPacket[0]) || ('e' == rxPacket[0]))
+        else
+        {
+            status = Calypso_CNFStatus_Failed;
+        }
+    }
+    /* If starts with 'E', check if response is "Error:[arguments]\r\n" */
+    else if(('E' == rxPacket[0]) || ('e' == rxPacket[0]))
+    {
+        if(!(0 == strncasecmp(&rxPacket[0], RESPONSE_Error, strlen(RESPONSE_Error))))
         {
-            if(!(0 == strncasecmp(&rxPacket[0], RESPONSE_Error, strlen(RESPONSE_Error))))
-            {
-
-                cmdConfirmation = Calypso_CNFStatus_Success;
-            }
-            else
-            {
-                cmdConfirmation = Calypso_CNFStatus_Failed;
 
-            }
+            status = Calypso_CNFStatus_Success;
         }
         else
         {
-            if(rxLength < CALYPSO_RESPONSE_BUFFER_SIZE)
-            {
-                memcpy(&Calypso_respndCmd[lengthResponse], RxBuffer, rxLength);
-                lengthResponse += rxLength;
-            }
+            status = Calypso_CNFStatus_Failed;
+
         }
     }
-    else
-        /* If no request is pending, an event was received*/
+
+    if(Calypso_CNFStatus_Invalid != status)
+    {
+        /* the oldest command is answered with the response lines received before */
+        bool confirmed = CommandQueue_Confirm(&cmdQueue, CALYPSO_CONFIRMATION, status, (uint8_t*)Calypso_respndCmd, lengthResponse);
+        lengthResponse = 0;
+        if(confirmed)
+        {
+            return;
+        }
+    }
+    else if(!IsEventLine(rxPacket) && (CommandQueue_Pending(&cmdQueue) > 0))
     {
-        if(NULL != eventCallback)
+        /* response line of the command waiting for OK or error */
+        if(lengthResponse + rxLength <= sizeof(Calypso_respndCmd))
         {
-            memcpy(&Calypso_eventCmd[0], RxBuffer, rxLength);
-            eventCallback(Calypso_eventCmd);
+            memcpy(&Calypso_respndCmd[lengthResponse], rxPacket, rxLength);
+            lengthResponse += rxLength;
         }
+        return;
+    }
 
+    /* events are passed on even while commands are pending */
+    if(NULL != eventCallback)
+    {
+        memcpy(&Calypso_eventCmd[0], rxPacket, rxLength);
+        eventCallback(Calypso_eventCmd);
     }
+}
 
+/* check if the line is an event, i.e. it is never the response of a command */
+static bool IsEventLine(const char *lineP)
+{
+    size_t nameLength;
+    size_t i;
+
+    if(0 == strncasecmp(lineP, "+event", strlen("+event")))
+    {
+        return true;
+    }
+
+    nameLength = strcspn(lineP, ":");
+    for(i = 0; i < sizeof(eventNames) / sizeof(eventNames[0]); i++)
+    {
+        if((strlen(eventNames[i]) == nameLength) && (0 == strncasecmp(lineP, eventNames[i], nameLength)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* called by the dispatcher of the command queue when a command of Calypso_sendRequestAsync was answered or timed out */
+static void AsyncCommandDone(CommandQueue_Request_t *requestP, bool answered)
+{
+    AsyncCommand_t *commandP = requestP->contextP;
+    bool success = answered && (requestP->status == Calypso_CNFStatus_Success);
+    uint16_t length = 0;
+
+    if(success)
+    {
+        length = (requestP->responseLength < requestP->responseSize) ? requestP->responseLength : requestP->responseSize;
+    }
+    commandP->callback(success, (char*)requestP->responseP, length, commandP->contextP);
 }
 /*
 * Static Functions.
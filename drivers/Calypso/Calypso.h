@@ -76,6 +76,9 @@ typedef enum Calypso_CNFStatus_t
     Calypso_CNFStatus_Invalid,
 } Calypso_CNFStatus_t;
 
+/* completion of Calypso_sendRequestAsync, responseP is valid until the callback returns */
+typedef void (*Calypso_CommandCallback)(bool success, char *responseP, uint16_t length, void *contextP);
+
 typedef enum Calypso_ParityBit_t
 {
     Calypso_ParityBit_NONE = 0,
@@ -121,6 +124,7 @@ extern bool Calypso_startRxThread();
 extern void Calypso_stopRxThread();
 extern void Calypso_sendRequest(char *data);
 extern bool Calypso_Wait4CNF(int max_time_ms, Calypso_CNFStatus_t expectedStatus, bool reset_confirmstate, char *pOutResponse);
+extern bool Calypso_sendRequestAsync(char *data, int max_time_ms, Calypso_CommandCallback cb, void *contextP);
 
 extern uint32_t Calypso_getBase64DecBufSize(uint8_t *inputData, uint32_t inputLength);
 extern uint32_t Calypso_getBase64EncBufSize(uint32_t inputLength);
@@ -36,8 +36,11 @@
 #include "../global/global.h"
 
 #define CMD_WAIT_TIME 500
+#define STARTUP_WAIT_TIME 1000      /* time for the module to restart */
+#define STARTUP_POLL_TIME 20        /* time for an answer while waiting for the module to restart */
 #define CNFINVALID 255
 #define MAX_PAYLOAD_LENGTH 255
+#define MAX_GETMULTIPLE_LENGTH (MAX_PAYLOAD_LENGTH - 2)  /* the GET_CNF starts with memory position and length */
 #define TXPOWERINVALID -128
 #define RSSIINVALID -128
 
@@ -120,128 +123,100 @@ typedef struct
  *    Static function declarations    *
  **************************************/
 
-static void HandleRxPacket(uint8_t*RxBuffer);                                                                                   /* RX packet interpreter */
-static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);   /* wait for response, when a command was sent to the Metis */
-static bool FillChecksum(uint8_t* array, uint8_t length);                                                                       /* add the CS needed to finalize the command */
-static bool InitDriver(Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t));     /* init module and dríver */
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                                                                           /* RX packet interpreter */
+static bool Wait4CNF(Metis_Handle_t *handleP, CommandQueue_Request_t *requestP, int max_time_ms, CMD_Status_t expectedStatus);   /* wait for response, when a command was sent to the Metis */
+static bool SendCommand(Metis_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length, CommandQueue_Request_t *requestP);       /* send a command without copying its payload */
+static uint8_t *ReserveFrame(Metis_Handle_t *handleP);                                                                                     /* take a TX frame to fill in place */
+static bool SubmitFrame(Metis_Handle_t *handleP, uint8_t *frameP, CommandQueue_Request_t *requestP);                                       /* send a filled TX frame and give it back */
+static bool SendRequest(Metis_Handle_t *handleP, uint8_t *frameP, uint16_t length, CommandQueue_Request_t *requestP);                      /* send a complete request frame */
+static bool InitDriver(Metis_Handle_t *handleP, Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t));     /* init module and dríver */
+static bool InitModule(Metis_Handle_t *handleP, int baudrate, int rp, Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t));
 static int8_t CalculateRSSIValue(uint8_t rxLevel);
+static bool GetFirmwareVersion(Metis_Handle_t *handleP, uint8_t* fw, int max_time_ms);                                                   /* request the firmware version with a custom timeout */
+static bool WaitForStartup(Metis_Handle_t *handleP, uint8_t* fw);                                                                        /* wait until the module answers after a reset */
+static bool CompareConfiguration(Metis_Handle_t *handleP, Metis_Configuration_t* config, uint8_t config_length, bool* changed); /* find the settings to be written */
 
 /**************************************
  *          Static variables          *
  **************************************/
 
-CMD_Frame_t RxPacket;                        /* data buffer for RX */
-bool AbortUartRxThread;                      /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                      /* boolean to reset the UART RX thread */
+/* command frames of the module: STX, CMD, 8 bit LEN, DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 1, HandleRxPacket };
 
-pthread_t thread_read;
-
-#define CMDCONFIRMATIONARRAY_LENGTH 2
-
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
-US_Confirmation_t usConfirmation;            /* variable used to check if GET function was successfull */
-uint8_t powerVolatile = TXPOWERINVALID;      /* variable used to check if setting the TXPower was successfull */
-
-int reset_pin;                               /* reset pin number for gpio */
-
-void(*RXcallback)(uint8_t*,uint8_t,int8_t);  /* callback function */
-Metis_Frequency_t frequency;               /* frequency used by module */
-bool rssi_enable = false;
+#define CMDQUEUE_DEPTH 1                        /* requests in flight, see Metis_SetPipelineDepthEx */
+#define TXPOOL_LENGTH 4                         /* requests built concurrently without allocations */
+#define TXPOOL_MAX_ALLOCATED 12                 /* further requests built concurrently, requests beyond fail */
 
+/* state of one driver instance */
+struct Metis_Handle_t
+{
+    Transport_t *transportP;                    /* communication interface to the module */
+    FramePool_t *txPoolP;                       /* frames for UART TX to module, see ReserveFrame */
+    int rxThreadEvent;                          /* eventfd to reset or abort the UART RX thread */
+    pthread_t thread_read;
+    CommandQueue_t cmdQueue;                    /* requests waiting for their confirmation */
+    US_Confirmation_t usConfirmation;           /* variable used to check if GET function was successfull */
+    uint8_t powerVolatile;                      /* variable used to check if setting the TXPower was successfull */
+    int reset_pin;                              /* reset pin number for gpio */
+    void(*RXcallback)(uint8_t*,uint8_t,int8_t); /* callback function */
+    Metis_Frequency_t frequency;                /* frequency used by module */
+    bool rssi_enable;
+    uint8_t RxBuffer[sizeof(CMD_Frame_t)];      /* data buffer for RX */
+};
+
+/* instance whose RX thread is executing the current callback */
+static __thread Metis_Handle_t *callbackHandleP = NULL;
 
 /**************************************
  *          Static functions          *
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint8_t RxByteCounter = 0;
-    uint8_t BytesToReceive = 0;
-    uint8_t readBuffer;                             /* read buffer for next available byte*/
-    static uint8_t RxBuffer[sizeof(CMD_Frame_t)];   /* data buffer for RX */
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    Metis_Handle_t *handleP = argP;
+    FrameCodec_t codec;
+
+    /* callbacks can ask which instance they belong to */
+    callbackHandleP = handleP;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
-    while(1)
-    {
-        /* wait for 10ms, then check if new RX data is available */
-        delay (10);
 
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
+    FrameCodec_Init(&codec, &frameProtocol, handleP->RxBuffer, sizeof(handleP->RxBuffer), handleP);
+    FrameCodec_RxLoop(&codec, handleP->transportP, handleP->rxThreadEvent);
+    return 0;
+}
 
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
+/* function to take a TX frame of the instance, the request is written into it in place, so that
+ * several threads can build their requests at the same time; give it back by SubmitFrame */
+static uint8_t *ReserveFrame(Metis_Handle_t *handleP)
+{
+    FrameBuffer_t *bufferP = FramePool_Get(handleP->txPoolP);
+    if(bufferP == NULL)
+    {
+        fprintf(stdout, "No TX frame available\n");
+        return NULL;
+    }
+    return bufferP->data;
+}
 
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
+/* function to send a complete request frame as the request waiting for requestP */
+static bool SendRequest(Metis_Handle_t *handleP, uint8_t *frameP, uint16_t length, CommandQueue_Request_t *requestP)
+{
+    struct iovec frame = { .iov_base = frameP, .iov_len = length };
+    return CommandQueue_Submit(&handleP->cmdQueue, requestP, handleP->transportP, &frame, 1, CMD_WAIT_TIME);
+}
 
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for SFD */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field */
-                    RxByteCounter++;
-                    BytesToReceive = (RxBuffer[RxByteCounter - 1] + 4); /* len + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
-    }
-    return 0;
+/* function to add the checksum to a frame taken by ReserveFrame and send it as the request
+ * waiting for requestP, the frame is given back to the pool in any case */
+static bool SubmitFrame(Metis_Handle_t *handleP, uint8_t *frameP, CommandQueue_Request_t *requestP)
+{
+    bool ret = FrameCodec_FillChecksum(&frameProtocol, frameP, sizeof(CMD_Frame_t)) &&
+               SendRequest(handleP, frameP, frameP[2] + 4, requestP);
+
+    FrameBuffer_Release(FrameBuffer_Of(frameP));
+    return ret;
 }
 
 /*
@@ -256,22 +231,31 @@ void *rx_thread()
  *return true if initialization succeeded
  *       false otherwise
  */
-static bool InitDriver(Metis_Frequency_t freq, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*, uint8_t, int8_t))
+static bool InitDriver(Metis_Handle_t *handleP, Metis_Frequency_t freq, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*, uint8_t, int8_t))
 {
     /* set frequency used by module */
-    frequency = freq;
+    handleP->frequency = freq;
 
     /* set rssi_enable */
-    rssi_enable = enable_rssi;
+    handleP->rssi_enable = enable_rssi;
 
     /* set RX callback function */
-    RXcallback = RXcb;
+    handleP->RXcallback = RXcb;
+
+    /* create the event to reset and abort the RX thread */
+    handleP->rxThreadEvent = RxThreadEvent_Create();
+    if(handleP->rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        return false;
+    }
 
     /* start RX thread */
-    if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
+    if(pthread_create(&handleP->thread_read, NULL, &rx_thread, handleP))
     {
         fprintf(stdout, "Failed to start rx_Thread\n");
-        Metis_Deinit();
+        RxThreadEvent_Destroy(handleP->rxThreadEvent);
+        handleP->rxThreadEvent = -1;
         return false;
     }
 
@@ -281,18 +265,12 @@ static bool InitDriver(Metis_Frequency_t freq, Metis_Mode_Preselect_t mode, bool
      * Setting is written to flash so write only if necessary
      */
     uint8_t uartEnable;
-    Metis_GetUartOutEnable(&uartEnable);
+    Metis_GetUartOutEnableEx(handleP, &uartEnable);
     if(uartEnable != 1)
     {
-        delay(50);
-        if(Metis_SetUartOutEnable(1))
-        {
-            delay(50);
-        }
-        else
+        if(false == Metis_SetUartOutEnableEx(handleP, 1))
         {
             fprintf(stdout, "Set UART_CMD_OUT_MODE failed\n");
-            Metis_Deinit();
             return false;
         }
     }
@@ -301,18 +279,12 @@ static bool InitDriver(Metis_Frequency_t freq, Metis_Mode_Preselect_t mode, bool
      * Setting is written to flash so write only if necessary
      */
     uint8_t rssi;
-    Metis_GetRSSIEnable(&rssi);
-    if(rssi != rssi_enable)
+    Metis_GetRSSIEnableEx(handleP, &rssi);
+    if(rssi != handleP->rssi_enable)
     {
-        delay(50);
-        if(Metis_SetRSSIEnable(rssi_enable ? 1 : 0))
-        {
-            delay(50);
-        }
-        else
+        if(false == Metis_SetRSSIEnableEx(handleP, handleP->rssi_enable ? 1 : 0))
         {
             fprintf(stdout, "Set RSSI failed\n");
-            Metis_Deinit();
             return false;
         }
     }
@@ -321,18 +293,12 @@ static bool InitDriver(Metis_Frequency_t freq, Metis_Mode_Preselect_t mode, bool
      * Setting is written to flash so write only if necessary
      */
     uint8_t aesEnable;
-    Metis_GetAESEnable(&aesEnable);
+    Metis_GetAESEnableEx(handleP, &aesEnable);
     if(aesEnable != 0)
     {
-        delay(50);
-        if(Metis_SetAESEnable(0))
-        {
-            delay(50);
-        }
-        else
+        if(false == Metis_SetAESEnableEx(handleP, 0))
         {
             fprintf(stdout, "Set AESEnable failed\n");
-            Metis_Deinit();
             return false;
         }
     }
@@ -341,67 +307,80 @@ static bool InitDriver(Metis_Frequency_t freq, Metis_Mode_Preselect_t mode, bool
      * Setting is written to flash so write only if necessary
      */
     uint8_t modePreselect;
-    Metis_GetModePreselect(&modePreselect);
+    Metis_GetModePreselectEx(handleP, &modePreselect);
     if(modePreselect != mode)
     {
-        delay(50);
-        if(Metis_SetModePreselect(mode))
-        {
-            delay(50);
-        }
-        else
+        if(false == Metis_SetModePreselectEx(handleP, mode))
         {
             fprintf(stdout, "Set mode preselect failed\n");
-            Metis_Deinit();
             return false;
         }
     }
 
     /* Reset module to apply changes */
-    if(Metis_Reset())
-    {
-        delay(300);
-    }
-    else
+    if(false == Metis_ResetEx(handleP))
     {
         fprintf(stdout, "Reset failed\n");
-        Metis_Deinit();
         return false;
     }
 
-    /* Read out the firmware version of the connected module */
+    /* Read out the firmware version of the connected module as soon as it restarted */
     uint8_t response[3];
-    if(Metis_GetFirmwareVersion(response))
+    if(WaitForStartup(handleP, response))
     {
         fprintf (stdout, "Firmware version %d.%d.%d detected\n",response[0],response[1],response[2]);
     }
     else
     {
         fprintf (stdout, "Readout of the firmware version failed.\nProbably invalid UART configuration or module is shut down.\n");
-        Metis_Deinit();
         return false;
     }
     return true;
 }
 
+/* open the interface, set up the pins and start the driver */
+static bool InitModule(Metis_Handle_t *handleP, int baudrate, int rp, Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t))
+{
+    if (false == Transport_Open(handleP->transportP, baudrate, Serial_ParityBit_NONE))
+    {
+        /* error */
+        return false ;
+    }
+    /* let the timeouts of the commands adapt to the answer times of the module */
+    CommandQueue_SetLineRate(&handleP->cmdQueue, baudrate);
+
+    /* initialize the reset pin,
+     * we have to define it as input/pull-up such that the reset button
+     * can pull the pin level down if the button is pressed
+     */
+    handleP->reset_pin = rp;
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
+
+	/* empty the UART buffers */
+    Transport_Flush(handleP->transportP);
+
+    return InitDriver(handleP, frequency, mode, enable_rssi, RXcb);
+}
+
 
 
 /* interprete the valid received data packet */
-static void HandleRxPacket(uint8_t*RxBuffer)
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer)
 {
+    Metis_Handle_t *handleP = contextP;
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
     cmdConfirmation.status = CMD_Status_Invalid;
 
     uint cmd_length = RxBuffer[2];
-    memcpy((uint8_t*)&RxPacket,RxBuffer,cmd_length + 4); /* payload + std + command + length byte + checksum */
+    CMD_Frame_t *packetP = (CMD_Frame_t*)RxBuffer;
 
-    switch (RxPacket.Cmd)
+    switch (packetP->Cmd)
     {
     case Metis_CMD_SET_MODE_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -409,14 +388,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case Metis_CMD_RESET_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -424,14 +403,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case Metis_CMD_DATA_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -439,28 +418,28 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case Metis_CMD_DATA_IND:
     {
         /* the call of the RXcallback strongly depends on the configuration of the module*/
-        if(rssi_enable == 0x01)
+        if(handleP->rssi_enable == 0x01)
         {
             /* the following implementation expects that the RSSI_Enable usersetting is enabled */
-            if(RXcallback != NULL)
+            if(handleP->RXcallback != NULL)
             {
-                RxPacket.Length = RxPacket.Length - 1;
-                RXcallback(&RxPacket.Length, RxPacket.Length + 1, CalculateRSSIValue(RxPacket.Data[RxPacket.Length]));
+                packetP->Length = packetP->Length - 1;
+                handleP->RXcallback(&packetP->Length, packetP->Length + 1, CalculateRSSIValue(packetP->Data[packetP->Length]));
             }
         }
         else
         {
             /* the following implementation expects that the RSSI_Enable usersetting is disabled */
-            if(RXcallback != NULL)
+            if(handleP->RXcallback != NULL)
             {
-                RXcallback(&RxPacket.Length, RxPacket.Length + 1, (int8_t)RSSIINVALID);
+                handleP->RXcallback(&packetP->Length, packetP->Length + 1, (int8_t)RSSIINVALID);
             }
         }
     }
@@ -472,7 +451,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
          * Data[1] contains length of parameter, which is depending on usersetting
          * On success mode responds with usersetting, length of parameter and paramter
          */
-        switch(RxPacket.Data[0])
+        switch(packetP->Data[0])
         {
         /* usersettings with value length of 1 byte */
         case(Metis_USERSETTING_MEMPOSITION_UART_CMD_OUT_ENABLE):
@@ -482,7 +461,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         case(Metis_USERSETTING_MEMPOSITION_MODE_PRESELECT):
         {
             /* check if correct usersetting was changed and if length corresponds to usersetting */
-            if((usConfirmation.memoryPosition == RxPacket.Data[0]) && (usConfirmation.lengthGetRequest == RxPacket.Data[1]))
+            if((handleP->usConfirmation.memoryPosition == packetP->Data[0]) && (handleP->usConfirmation.lengthGetRequest == packetP->Data[1]))
             {
                 cmdConfirmation.status = CMD_Status_Success;
             }
@@ -490,14 +469,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
             {
                 cmdConfirmation.status = CMD_Status_Failed;
             }
-            cmdConfirmation.cmd = RxPacket.Cmd;
+            cmdConfirmation.cmd = packetP->Cmd;
         }
         break;
         /* usersettings with value length of 2 byte*/
         case(Metis_USERSETTING_MEMPOSITION_CFG_FLAGS):
         {
             /* check if correct usersetting was changed and if length corresponds to usersetting */
-            if((usConfirmation.memoryPosition == RxPacket.Data[0]) && (usConfirmation.lengthGetRequest == RxPacket.Data[1]))
+            if((handleP->usConfirmation.memoryPosition == packetP->Data[0]) && (handleP->usConfirmation.lengthGetRequest == packetP->Data[1]))
             {
                 cmdConfirmation.status = CMD_Status_Success;
             }
@@ -505,7 +484,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
             {
                 cmdConfirmation.status = CMD_Status_Failed;
             }
-            cmdConfirmation.cmd = RxPacket.Cmd;
+            cmdConfirmation.cmd = packetP->Cmd;
         }
         break;
 
@@ -518,7 +497,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
     case Metis_CMD_SET_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -526,14 +505,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case Metis_CMD_GET_SERIALNO_CNF:
     {
         /* check whether the module returns serial number of 4 bytes */
-        if (RxPacket.Length == 4)
+        if (packetP->Length == 4)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -541,14 +520,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case Metis_CMD_GET_FWRELEASE_CNF:
     {
         /* check whether the module returns firmware version of 3 bytes */
-        if (RxPacket.Length == 3)
+        if (packetP->Length == 3)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -556,14 +535,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case Metis_CMD_SETUARTSPEED_CNF:
     {
         /* check whether the module returns success*/
-        if(RxPacket.Data[0] == 0x00)
+        if(packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -571,14 +550,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case Metis_CMD_FACTORYRESET_CNF:
     {
         /* check whether the module returns success*/
-        if(RxPacket.Data[0] == 0x00)
+        if(packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -586,7 +565,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
@@ -594,77 +573,32 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         break;
     }
 
-    int i = 0;
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+    if(cmdConfirmation.cmd != CNFINVALID)
     {
-        if(cmdConfirmation_array[i].cmd == CNFINVALID)
-        {
-            cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
-            cmdConfirmation_array[i].status = cmdConfirmation.status;
-            break;
-        }
+        /* the confirmation is copied for the command waiting for it */
+        CommandQueue_Confirm(&handleP->cmdQueue, cmdConfirmation.cmd, cmdConfirmation.status, RxBuffer, cmd_length + 4);
     }
 }
 
-
 /* function that waits for the return value of Metis (*_CNF), when a command (*_REQ) was sent before */
-static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
+static bool Wait4CNF(Metis_Handle_t *handleP, CommandQueue_Request_t *requestP, int max_time_ms, CMD_Status_t expectedStatus)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
-    int i = 0;
-
-    if(reset_confirmstate)
-    {
-        for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-        {
-            cmdConfirmation_array[i].cmd = CNFINVALID;
-        }
-    }
-    while (1)
-    {
-        for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-        {
-            if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
-            {
-                return (cmdConfirmation_array[i].status == expectedStatus);
-            }
-        }
-
-        if (count >= max_count)
-        {
-            /* received no correct response within timeout */
-            return false;
-        }
-
-        /* wait */
-        count++;
-        delay(time_step_ms);
-    }
-    return true;
+    return CommandQueue_Wait(&handleP->cmdQueue, requestP, max_time_ms) && (requestP->status == expectedStatus);
 }
 
-/* function to add the checksum at the end of the data packet */
-static bool FillChecksum(uint8_t* array, uint8_t length)
+/* function to send a command with its payload in place, i.e. without copying the payload
+ * behind the header first; the length field of the header has to be filled already */
+static bool SendCommand(Metis_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length, CommandQueue_Request_t *requestP)
 {
-    bool ret = false;
+    uint8_t checksum = FrameCodec_Checksum(FrameCodec_Checksum(0, header, header_length), payload, payload_length);
 
-    if ((length >= 4) && (array[0] == CMD_STX))
+    struct iovec frame[3] =
     {
-        uint8_t checksum = 0;
-        uint8_t payload_length = array[2];
-        int i = 0;
-        for (i = 0;
-                i < payload_length + 3;
-                i++)
-        {
-            checksum ^= array[i];
-        }
-        array[payload_length + 3] = checksum;
-        ret = true;
-    }
-    return ret;
+        { .iov_base = header,    .iov_len = header_length },
+        { .iov_base = payload,   .iov_len = payload_length },
+        { .iov_base = &checksum, .iov_len = 1 },
+    };
+    return CommandQueue_Submit(&handleP->cmdQueue, requestP, handleP->transportP, frame, 3, CMD_WAIT_TIME);
 }
 
 /* function to calculate the rssi value from the rx level */
@@ -694,6 +628,7 @@ static int8_t CalculateRSSIValue(uint8_t rxLevel)
  *Initialize the AMB module for serial interface
  *
  *input:
+ * -transportP:     interface to the module, see SerialTransport_Create and FTDITransport_Create
  * -baudrate:    baudrate of the interface
  * -rp:          Reset Pin
  * -frequency:   frequency used by the AMBER module(AMB8xxx-M uses 868Mhz, AMB36xx-M uses 169MHz)
@@ -706,35 +641,42 @@ static int8_t CalculateRSSIValue(uint8_t rxLevel)
  *          the mode parameter must match the other participant of the RF communication
  *          Check Manual of the wMBus AMB modules for the suitable modes
  *
- *return true if initialization succeeded
- *       false otherwise
+ *return driver instance if initialization succeeded
+ *       NULL otherwise
  */
-bool Metis_Init( int baudrate, int rp, Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t))
+Metis_Handle_t *Metis_InitEx(Transport_t *transportP, int baudrate, int rp, Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t))
 {
-    if (false == InitSerial(rp))
+    Metis_Handle_t *handleP;
+
+    if(transportP == NULL)
     {
-        /* error */
-        return false ;
+        return NULL;
     }
 
-    if (false == OpenSerial(baudrate))
+    handleP = calloc(1, sizeof(Metis_Handle_t));
+    if(handleP == NULL)
     {
-        /* error */
-        return false ;
+        return NULL;
     }
+    handleP->transportP = transportP;
+    handleP->rxThreadEvent = -1;
+    handleP->powerVolatile = TXPOWERINVALID;
 
-    /* initialize the reset pin,
-     * we have to define it as input/pull-up such that the reset button
-     * can pull the pin level down if the button is pressed
-     */
-    reset_pin = rp;
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
+    if(!CommandQueue_Init(&handleP->cmdQueue, CMDQUEUE_DEPTH))
+    {
+        fprintf(stdout, "Failed to initialize command queue\n");
+        free(handleP);
+        return NULL;
+    }
 
-	/* empty the UART buffers */
-    FlushSerial();
+    handleP->txPoolP = FramePool_Create(TXPOOL_LENGTH, TXPOOL_MAX_ALLOCATED, sizeof(CMD_Frame_t));
+    if((handleP->txPoolP == NULL) || (false == InitModule(handleP, baudrate, rp, frequency, mode, enable_rssi, RXcb)))
+    {
+        Metis_DeinitEx(handleP);
+        return NULL;
+    }
 
-    return InitDriver(frequency, mode, enable_rssi, RXcb);
+    return handleP;
 }
 
 /*
@@ -743,21 +685,33 @@ bool Metis_Init( int baudrate, int rp, Metis_Frequency_t frequency, Metis_Mode_P
  * return true if deinitialization succeeded
  *        false otherwise
  */
-bool Metis_Deinit()
+bool Metis_DeinitEx(Metis_Handle_t *handleP)
 {
+    if(handleP == NULL)
+    {
+        return false;
+    }
+
     /* close the communication interface to the module */
-    CloseSerial();
-    DeinitSerial();
+    Transport_Close(handleP->transportP);
 
     /* abort RX thread */
-    AbortUartRxThread = true;
+    if(handleP->rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(handleP->rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(handleP->thread_read, NULL);
+        RxThreadEvent_Destroy(handleP->rxThreadEvent);
+        handleP->rxThreadEvent = -1;
+    }
 
     /* deinit pins */
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
-    DeinitPin(reset_pin);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
+    Transport_DeinitPin(handleP->transportP, handleP->reset_pin);
+
+    FramePool_Destroy(handleP->txPoolP);
 
-    /* deinit RX callback */
-    RXcallback = NULL;
+    CommandQueue_Deinit(&handleP->cmdQueue);
+    free(handleP);
 
     return true;
 }
@@ -768,19 +722,19 @@ bool Metis_Deinit()
  *return true if reset succeeded
  *       false otherwise
  */
-bool Metis_PinReset()
+bool Metis_PinResetEx(Metis_Handle_t *handleP)
 {
 /* set to output mode */
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
     delay (5);
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
-    FlushSerial();
-    ResetUartRxThread = true;
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+    Transport_Flush(handleP->transportP);
+    RxThreadEvent_Signal(handleP->rxThreadEvent, RXTHREAD_EVENT_RESET);
     delay (5);
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
 
     /* set to input mode again */
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
 
     return true;
 }
@@ -791,7 +745,7 @@ bool Metis_PinReset()
  *return true if reset succeeded
  *       false otherwise
  */
-bool Metis_Reset()
+bool Metis_ResetEx(Metis_Handle_t *handleP)
 {
     bool ret = false;
 
@@ -800,13 +754,16 @@ bool Metis_Reset()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = Metis_CMD_RESET_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, Metis_CMD_RESET_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        return Wait4CNF(CMD_WAIT_TIME, Metis_CMD_RESET_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            return Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -820,7 +777,7 @@ bool Metis_Reset()
  *return true if factory reset succeeded
  *       false otherwise
  */
-bool Metis_FactoryReset()
+bool Metis_FactoryResetEx(Metis_Handle_t *handleP)
 {
     bool ret = false;
 
@@ -829,13 +786,18 @@ bool Metis_FactoryReset()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = Metis_CMD_FACTORYRESET_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, Metis_CMD_FACTORYRESET_CNF, NULL, 0);
+        /* answered once the settings were restored in flash */
+        CommandQueue_SetFixedTimeout(&request);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, Metis_CMD_FACTORYRESET_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -849,7 +811,7 @@ bool Metis_FactoryReset()
  *return true if setting baudrate succeeded
  *       false otherwise
  */
-bool Metis_SetUartSpeed(Metis_UartBaudrate_t baudrate)
+bool Metis_SetUartSpeedEx(Metis_Handle_t *handleP, Metis_UartBaudrate_t baudrate)
 {
     bool ret = false;
 
@@ -860,13 +822,16 @@ bool Metis_SetUartSpeed(Metis_UartBaudrate_t baudrate)
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = baudrate;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, Metis_CMD_SETUARTSPEED_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, Metis_CMD_SETUARTSPEED_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -884,7 +849,7 @@ bool Metis_SetUartSpeed(Metis_UartBaudrate_t baudrate)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_Get(Metis_UserSettings_t us, uint8_t* response, uint8_t* response_length)
+bool Metis_GetEx(Metis_Handle_t *handleP, Metis_UserSettings_t us, uint8_t* response, uint8_t* response_length)
 {
     bool ret = false;
 
@@ -917,24 +882,28 @@ bool Metis_Get(Metis_UserSettings_t us, uint8_t* response, uint8_t* response_len
         break;
     }
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
-        usConfirmation.memoryPosition = us;
-        usConfirmation.lengthGetRequest = CMD_ARRAY[4];
+        handleP->usConfirmation.memoryPosition = us;
+        handleP->usConfirmation.lengthGetRequest = CMD_ARRAY[4];
 
+        CMD_Frame_t cnfPacket;
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, Metis_CMD_GET_CNF, (uint8_t*)&cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, Metis_CMD_GET_CNF, CMD_Status_Success, true))
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
         {
-            int length = RxPacket.Length - 2;
-            memcpy(response,&RxPacket.Data[2],length);
-            *response_length = length;
-            ret = true;
+            /* wait for cnf */
+            if (Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success))
+            {
+                int length = cnfPacket.Length - 2;
+                memcpy(response,&cnfPacket.Data[2],length);
+                *response_length = length;
+                ret = true;
+            }
         }
-        usConfirmation.memoryPosition = -1;
-        usConfirmation.lengthGetRequest = -1;
+        handleP->usConfirmation.memoryPosition = -1;
+        handleP->usConfirmation.lengthGetRequest = -1;
     }
     return ret;
 }
@@ -953,7 +922,7 @@ bool Metis_Get(Metis_UserSettings_t us, uint8_t* response, uint8_t* response_len
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_GetMultiple(uint8_t startAddress, uint8_t lengthToRead, uint8_t *response, uint8_t *response_length)
+bool Metis_GetMultipleEx(Metis_Handle_t *handleP, uint8_t startAddress, uint8_t lengthToRead, uint8_t *response, uint8_t *response_length)
 {
     bool ret = false;
 
@@ -964,24 +933,28 @@ bool Metis_GetMultiple(uint8_t startAddress, uint8_t lengthToRead, uint8_t *resp
     CMD_ARRAY[3] = startAddress;
     CMD_ARRAY[4] = lengthToRead;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
-        usConfirmation.memoryPosition = startAddress;
-        usConfirmation.lengthGetRequest = lengthToRead;
+        handleP->usConfirmation.memoryPosition = startAddress;
+        handleP->usConfirmation.lengthGetRequest = lengthToRead;
 
+        CMD_Frame_t cnfPacket;
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, Metis_CMD_GET_CNF, (uint8_t*)&cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, Metis_CMD_GET_CNF, CMD_Status_Success, true))
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
         {
-            int length = RxPacket.Length - 2;
-            memcpy(response,&RxPacket.Data[2],length);
-            *response_length = length;
-            ret = true;
+            /* wait for cnf */
+            if (Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success))
+            {
+                int length = cnfPacket.Length - 2;
+                memcpy(response,&cnfPacket.Data[2],length);
+                *response_length = length;
+                ret = true;
+            }
         }
-        usConfirmation.memoryPosition = -1;
-        usConfirmation.lengthGetRequest = -1;
+        handleP->usConfirmation.memoryPosition = -1;
+        handleP->usConfirmation.lengthGetRequest = -1;
     }
     return ret;
 }
@@ -1000,25 +973,35 @@ bool Metis_GetMultiple(uint8_t startAddress, uint8_t lengthToRead, uint8_t *resp
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_Set(Metis_UserSettings_t us, uint8_t* value, uint8_t length)
+bool Metis_SetEx(Metis_Handle_t *handleP, Metis_UserSettings_t us, uint8_t* value, uint8_t length)
 {
     bool ret = false;
 
-    /* fill CMD_ARRAY packet */
-    uint8_t CMD_ARRAY[length + 6];
-    CMD_ARRAY[0] = CMD_STX;
-    CMD_ARRAY[1] = Metis_CMD_SET_REQ;
-    CMD_ARRAY[2] = (2 + length);
-    CMD_ARRAY[3] = us;
-    CMD_ARRAY[4] = length;
-    memcpy(&CMD_ARRAY[5],value,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(length > UINT8_MAX - 2)
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
+        /* does not fit into the length field */
+        return false;
+    }
 
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[0] = CMD_STX;
+    frameP[1] = Metis_CMD_SET_REQ;
+    frameP[2] = (2 + length);
+    frameP[3] = us;
+    frameP[4] = length;
+    memcpy(&frameP[5],value,length);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, Metis_CMD_SET_CNF, NULL, 0);
+    if(SubmitFrame(handleP, frameP, &request))
+    {
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, Metis_CMD_SET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
     }
     return ret;
 }
@@ -1032,25 +1015,54 @@ bool Metis_Set(Metis_UserSettings_t us, uint8_t* value, uint8_t length)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_GetFirmwareVersion(uint8_t* fw)
+bool Metis_GetFirmwareVersionEx(Metis_Handle_t *handleP, uint8_t* fw)
+{
+    return GetFirmwareVersion(handleP, fw, CMD_WAIT_TIME);
+}
+
+/* request the firmware version, waiting max_time_ms for the answer */
+static bool GetFirmwareVersion(Metis_Handle_t *handleP, uint8_t* fw, int max_time_ms)
 {
     uint8_t CMD_ARRAY[4];
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = Metis_CMD_GET_FWRELEASE;
     CMD_ARRAY[2] = 0;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CMD_Frame_t cnfPacket;
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, Metis_CMD_GET_FWRELEASE_CNF, (uint8_t*)&cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            if (Wait4CNF(handleP, &request, max_time_ms, CMD_Status_Success))
+            {
+                memcpy(fw,&cnfPacket.Data[0],cnfPacket.Length);
+                return true;
+            }
+        }
+    }
+    return false;
+}
 
-        /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, Metis_CMD_GET_FWRELEASE_CNF, CMD_Status_Success, true))
+/* wait until the module answers after a reset, the module does not announce its
+ * startup, so the firmware version is requested until it is answered */
+static bool WaitForStartup(Metis_Handle_t *handleP, uint8_t* fw)
+{
+    struct timespec deadline, now;
+
+    GetDeadline(&deadline, STARTUP_WAIT_TIME);
+    do
+    {
+        if(GetFirmwareVersion(handleP, fw, STARTUP_POLL_TIME))
         {
-            memcpy(fw,&RxPacket.Data[0],RxPacket.Length);
             return true;
         }
+        clock_gettime(CLOCK_MONOTONIC, &now);
     }
+    while((now.tv_sec < deadline.tv_sec) || ((now.tv_sec == deadline.tv_sec) && (now.tv_nsec < deadline.tv_nsec)));
     return false;
 }
 
@@ -1063,23 +1075,27 @@ bool Metis_GetFirmwareVersion(uint8_t* fw)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_GetSerialNumber(uint8_t* sn)
+bool Metis_GetSerialNumberEx(Metis_Handle_t *handleP, uint8_t* sn)
 {
     uint8_t CMD_ARRAY[4];
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = Metis_CMD_GET_SERIALNO;
     CMD_ARRAY[2] = 0;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CMD_Frame_t cnfPacket;
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, Metis_CMD_GET_SERIALNO_CNF, (uint8_t*)&cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, Metis_CMD_GET_SERIALNO_CNF, CMD_Status_Success, true))
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
         {
-            memcpy(sn,&RxPacket.Data[0], RxPacket.Length);
-            return true;
+            /* wait for cnf */
+            if (Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success))
+            {
+                memcpy(sn,&cnfPacket.Data[0], cnfPacket.Length);
+                return true;
+            }
         }
     }
     return false;
@@ -1094,11 +1110,11 @@ bool Metis_GetSerialNumber(uint8_t* sn)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_GetDefaultTXPower(int8_t* txpower)
+bool Metis_GetDefaultTXPowerEx(Metis_Handle_t *handleP, int8_t* txpower)
 {
     uint8_t length;
 
-    if(Metis_Get(Metis_USERSETTING_MEMPOSITION_DEFAULTRFTXPOWER, (uint8_t*)txpower, &length))
+    if(Metis_GetEx(handleP, Metis_USERSETTING_MEMPOSITION_DEFAULTRFTXPOWER, (uint8_t*)txpower, &length))
     {
         return true;
     }
@@ -1117,10 +1133,10 @@ bool Metis_GetDefaultTXPower(int8_t* txpower)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_GetUartOutEnable(uint8_t* uartEnable)
+bool Metis_GetUartOutEnableEx(Metis_Handle_t *handleP, uint8_t* uartEnable)
 {
     uint8_t length;
-    return Metis_Get(Metis_USERSETTING_MEMPOSITION_UART_CMD_OUT_ENABLE, uartEnable, &length);
+    return Metis_GetEx(handleP, Metis_USERSETTING_MEMPOSITION_UART_CMD_OUT_ENABLE, uartEnable, &length);
 }
 
 /*
@@ -1131,10 +1147,10 @@ bool Metis_GetUartOutEnable(uint8_t* uartEnable)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_GetRSSIEnable(uint8_t* rssiEnable)
+bool Metis_GetRSSIEnableEx(Metis_Handle_t *handleP, uint8_t* rssiEnable)
 {
     uint8_t length;
-    return Metis_Get(Metis_USERSETTING_MEMPOSITION_RSSI_ENABLE, rssiEnable, &length);
+    return Metis_GetEx(handleP, Metis_USERSETTING_MEMPOSITION_RSSI_ENABLE, rssiEnable, &length);
 }
 
 /*
@@ -1146,10 +1162,10 @@ bool Metis_GetRSSIEnable(uint8_t* rssiEnable)
  *       false otherwise
  */
 
-bool Metis_GetModePreselect(uint8_t* modePreselect)
+bool Metis_GetModePreselectEx(Metis_Handle_t *handleP, uint8_t* modePreselect)
 {
     uint8_t length;
-    return Metis_Get(Metis_USERSETTING_MEMPOSITION_MODE_PRESELECT, modePreselect, &length);
+    return Metis_GetEx(handleP, Metis_USERSETTING_MEMPOSITION_MODE_PRESELECT, modePreselect, &length);
 }
 
 /*
@@ -1160,10 +1176,10 @@ bool Metis_GetModePreselect(uint8_t* modePreselect)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_GetAESEnable(uint8_t* aesEnable)
+bool Metis_GetAESEnableEx(Metis_Handle_t *handleP, uint8_t* aesEnable)
 {
     uint8_t length;
-    return Metis_Get(Metis_USERSETTING_MEMPOSITION_APP_AES_ENABLE, aesEnable, &length);
+    return Metis_GetEx(handleP, Metis_USERSETTING_MEMPOSITION_APP_AES_ENABLE, aesEnable, &length);
 }
 
 /*
@@ -1179,7 +1195,7 @@ bool Metis_GetAESEnable(uint8_t* aesEnable)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_SetDefaultTXPower(int8_t txpower)
+bool Metis_SetDefaultTXPowerEx(Metis_Handle_t *handleP, int8_t txpower)
 {
     /* check for invalid power */
     if((txpower < -11) || (txpower > 15))
@@ -1187,7 +1203,7 @@ bool Metis_SetDefaultTXPower(int8_t txpower)
         /* invalid power */
         return false;
     }
-    return Metis_Set(Metis_USERSETTING_MEMPOSITION_DEFAULTRFTXPOWER, (uint8_t*)&txpower, 1);
+    return Metis_SetEx(handleP, Metis_USERSETTING_MEMPOSITION_DEFAULTRFTXPOWER, (uint8_t*)&txpower, 1);
 }
 
 /*
@@ -1202,13 +1218,13 @@ bool Metis_SetDefaultTXPower(int8_t txpower)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_SetUartOutEnable(uint8_t uartEnable)
+bool Metis_SetUartOutEnableEx(Metis_Handle_t *handleP, uint8_t uartEnable)
 {
     if((uartEnable != 0) && (uartEnable != 1))
     {
         return false;
     }
-    return Metis_Set(Metis_USERSETTING_MEMPOSITION_UART_CMD_OUT_ENABLE, &uartEnable, 1);
+    return Metis_SetEx(handleP, Metis_USERSETTING_MEMPOSITION_UART_CMD_OUT_ENABLE, &uartEnable, 1);
 }
 /*
  *Set the RSSI Enable byte
@@ -1222,13 +1238,13 @@ bool Metis_SetUartOutEnable(uint8_t uartEnable)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_SetRSSIEnable(uint8_t rssiEnable)
+bool Metis_SetRSSIEnableEx(Metis_Handle_t *handleP, uint8_t rssiEnable)
 {
     if((rssiEnable !=0) && (rssiEnable != 1))
     {
         return false;
     }
-    return Metis_Set(Metis_USERSETTING_MEMPOSITION_RSSI_ENABLE, &rssiEnable,1);
+    return Metis_SetEx(handleP, Metis_USERSETTING_MEMPOSITION_RSSI_ENABLE, &rssiEnable,1);
 }
 
 /*
@@ -1244,13 +1260,13 @@ bool Metis_SetRSSIEnable(uint8_t rssiEnable)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_SetAESEnable(uint8_t aesEnable)
+bool Metis_SetAESEnableEx(Metis_Handle_t *handleP, uint8_t aesEnable)
 {
     if(aesEnable !=0)
     {
         return false;
     }
-    return Metis_Set(Metis_USERSETTING_MEMPOSITION_APP_AES_ENABLE, &aesEnable,1);
+    return Metis_SetEx(handleP, Metis_USERSETTING_MEMPOSITION_APP_AES_ENABLE, &aesEnable,1);
 }
 
 /*
@@ -1266,9 +1282,9 @@ bool Metis_SetAESEnable(uint8_t aesEnable)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_SetModePreselect(Metis_Mode_Preselect_t modePreselect)
+bool Metis_SetModePreselectEx(Metis_Handle_t *handleP, Metis_Mode_Preselect_t modePreselect)
 {
-    return Metis_Set(Metis_USERSETTING_MEMPOSITION_MODE_PRESELECT, (uint8_t*)&modePreselect, 1);
+    return Metis_SetEx(handleP, Metis_USERSETTING_MEMPOSITION_MODE_PRESELECT, (uint8_t*)&modePreselect, 1);
 }
 
 /*
@@ -1280,7 +1296,7 @@ bool Metis_SetModePreselect(Metis_Mode_Preselect_t modePreselect)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_SetVolatile_ModePreselect(Metis_Mode_Preselect_t modePreselect)
+bool Metis_SetVolatile_ModePreselectEx(Metis_Handle_t *handleP, Metis_Mode_Preselect_t modePreselect)
 {
     bool ret = false;
 
@@ -1290,13 +1306,16 @@ bool Metis_SetVolatile_ModePreselect(Metis_Mode_Preselect_t modePreselect)
     CMD_ARRAY[1] = Metis_CMD_SET_MODE;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = modePreselect;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, Metis_CMD_SET_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf*/
-        ret = Wait4CNF(CMD_WAIT_TIME, Metis_CMD_SET_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf*/
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -1310,7 +1329,7 @@ bool Metis_SetVolatile_ModePreselect(Metis_Mode_Preselect_t modePreselect)
  *return true if request succeeded
  *       false otherwise
  */
-bool Metis_Transmit(uint8_t* payload)
+bool Metis_TransmitEx(Metis_Handle_t *handleP, uint8_t* payload)
 {
     bool ret = false;
     uint8_t length = *payload; /* first byte of wM-BUS frame is length field */
@@ -1322,10 +1341,10 @@ bool Metis_Transmit(uint8_t* payload)
     }
 
     /* mode preselect C2/T2 for frequency 868 is not suitable for sending frames */
-    if((frequency == MBus_Frequency_868))
+    if((handleP->frequency == MBus_Frequency_868))
     {
         uint8_t modePreselect;
-        Metis_GetModePreselect(&modePreselect);
+        Metis_GetModePreselectEx(handleP, &modePreselect);
         if(modePreselect == MBus_Mode_868_C2_T2_other)
         {
             /* module can not send in this mode. */
@@ -1335,84 +1354,344 @@ bool Metis_Transmit(uint8_t* payload)
     }
 
 
-    /* fill CMD_ARRAY packet */
-    uint8_t CMD_ARRAY[length + 4];
-    CMD_ARRAY[0] = CMD_STX;
-    CMD_ARRAY[1] = Metis_CMD_DATA_REQ;
-    CMD_ARRAY[2] = length;
-    memcpy(&CMD_ARRAY[3],&payload[1],length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    /* fill header, the wM-BUS frame is sent from the buffer of the caller */
+    uint8_t header[3];
+    header[0] = CMD_STX;
+    header[1] = Metis_CMD_DATA_REQ;
+    header[2] = length;
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, Metis_CMD_DATA_CNF, NULL, 0);
+    /* answered once the data was sent over the air */
+    CommandQueue_SetFixedTimeout(&request);
+    if(SendCommand(handleP, header, sizeof(header), &payload[1], length, &request))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, Metis_CMD_DATA_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
     }
     return ret;
 }
 
 /*
- *Configure the Metis
+ *Read the settings of a configuration with as few GET requests as possible and compare them locally
  *
  *input:
  * -config: pointer to the configuration struct
  * -config_length: length of the configuration struct
- * -factory_reset: apply a factory reset before or not
  *
- *return true if request succeeded
+ *output:
+ * -changed: true for each setting whose value differs from the configuration
+ *
+ *return true if all settings were read
  *       false otherwise
-*/
-bool Metis_Configure(Metis_Configuration_t* config, uint8_t config_length, bool factory_reset)
+ */
+static bool CompareConfiguration(Metis_Handle_t *handleP, Metis_Configuration_t* config, uint8_t config_length, bool* changed)
 {
-    int i = 0;
-    uint8_t help_length;
-    uint8_t help[MAX_USERSETTING_LENGTH];
+    bool read[UINT8_MAX];
+    uint8_t response[MAX_GETMULTIPLE_LENGTH];
+    uint8_t response_length;
+    int i;
 
-    if(factory_reset)
+    for(i=0; i<config_length; i++)
     {
-        /* perform a factory reset */
-        if(false == Metis_FactoryReset())
+        if((config[i].value_length == 0) || (config[i].value_length > MAX_USERSETTING_LENGTH))
         {
-            /* error */
+            /* error, invalid length */
             return false;
         }
+        read[i] = false;
     }
-    delay(500);
 
-    /* now check all settings and update them if necessary */
-    for(i=0; i<config_length; i++)
+    while(true)
     {
-        /* read current value */
-        if(false == Metis_Get(config[i].usersetting, help, &help_length))
+        int first = -1;
+        int end = 0;
+
+        /* the next request starts at the lowest memory position not read yet */
+        for(i=0; i<config_length; i++)
+        {
+            if(!read[i] && ((first < 0) || (config[i].usersetting < config[first].usersetting)))
+            {
+                first = i;
+            }
+        }
+        if(first < 0)
+        {
+            /* all settings read */
+            return true;
+        }
+
+        /* and covers all further settings that fit into its answer */
+        for(i=0; i<config_length; i++)
+        {
+            if(!read[i] && (config[i].usersetting >= config[first].usersetting) && (config[i].usersetting + config[i].value_length <= config[first].usersetting + MAX_GETMULTIPLE_LENGTH))
+            {
+                read[i] = true;
+                if(config[i].usersetting + config[i].value_length > end)
+                {
+                    end = config[i].usersetting + config[i].value_length;
+                }
+            }
+        }
+        if((false == Metis_GetMultipleEx(handleP, config[first].usersetting, end - config[first].usersetting, response, &response_length)) ||
+           (response_length != end - config[first].usersetting))
         {
             /* error */
             return false;
         }
-        delay(200);
 
-        /* check the value read out */
-        if(help_length != config[i].value_length)
+        for(i=0; i<config_length; i++)
+        {
+            if(read[i] && (config[i].usersetting >= config[first].usersetting) && (config[i].usersetting + config[i].value_length <= end))
+            {
+                changed[i] = (memcmp(&response[config[i].usersetting - config[first].usersetting], config[i].value, config[i].value_length) != 0);
+            }
+        }
+    }
+}
+
+/*
+ *Configure the Metis
+ *
+ *input:
+ * -config: pointer to the configuration struct
+ * -config_length: length of the configuration struct
+ * -factory_reset: apply a factory reset before or not
+ *
+ *note: only the settings whose values differ are written, the module is reset only if a setting was written
+ *
+ *return true if request succeeded
+ *       false otherwise
+*/
+bool Metis_ConfigureEx(Metis_Handle_t *handleP, Metis_Configuration_t* config, uint8_t config_length, bool factory_reset)
+{
+    int i = 0;
+    bool changed[UINT8_MAX];
+    bool update = false;
+    uint8_t fw[3];
+
+    if(factory_reset)
+    {
+        /* perform a factory reset, the module restarts with the default settings */
+        if((false == Metis_FactoryResetEx(handleP)) || (false == WaitForStartup(handleP, fw)))
         {
-            /* error, length does not match */
+            /* error */
             return false;
         }
-        if(memcmp(help,config[i].value,config[i].value_length) != 0)
+    }
+
+    /* now check all settings */
+    if(false == CompareConfiguration(handleP, config, config_length, changed))
+    {
+        /* error */
+        return false;
+    }
+
+    /* and update those that are not up to date */
+    for(i=0; i<config_length; i++)
+    {
+        if(changed[i])
         {
-            /* read value is not up to date, thus write the new value */
-            if(false == Metis_Set(config[i].usersetting, config[i].value, config[i].value_length))
+            if(false == Metis_SetEx(handleP, config[i].usersetting, config[i].value, config[i].value_length))
             {
                 /* error */
                 return false;
             }
+            update = true;
+        }
+    }
+
+    if(update)
+    {
+        /* reset to take effect of the updated parameters */
+        if((false == Metis_PinResetEx(handleP)) || (false == WaitForStartup(handleP, fw)))
+        {
+            return false;
         }
-        delay(200);
     }
+    return true;
+}
+
+/*
+ *Request the instance whose callback is currently executed,
+ *callbacks use it to tell which module an event belongs to
+ *
+ *return driver instance, if called from a callback
+ *       NULL otherwise
+ */
+Metis_Handle_t *Metis_GetCallbackHandle()
+{
+    return callbackHandleP;
+}
 
-    /* reset to take effect of the updated parameters */
-    if(false == Metis_PinReset())
+/*
+ *Set the number of requests sent to the module before the first of them is confirmed
+ *
+ *Commands called concurrently, e.g. by several threads, are sent back to back up to
+ *this number, so that their round trips overlap. Confirmations are matched to the
+ *requests in the order of sending.
+ *
+ *input:
+ * -depth: requests in flight, 1 (default) waits for each confirmation before the next request is sent
+ *
+ *note: use a depth above 1 only with a firmware that accepts requests while a
+ *      previous request is processed
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool Metis_SetPipelineDepthEx(Metis_Handle_t *handleP, uint8_t depth)
+{
+    if((handleP == NULL) || (depth == 0))
     {
         return false;
     }
+    CommandQueue_SetDepth(&handleP->cmdQueue, depth);
     return true;
 }
+
+#ifndef GLOBAL_NO_DEFAULT_TRANSPORT
+
+/**************************************
+ *   Functions of the default driver  *
+ *   instance, see Metis_Init        *
+ **************************************/
+
+static Metis_Handle_t *defaultHandleP = NULL;
+
+bool Metis_Init( int baudrate, int rp, Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t))
+{
+    if(defaultHandleP != NULL)
+    {
+        /* already initialized */
+        return false;
+    }
+
+    defaultHandleP = Metis_InitEx(GetDefaultTransport(), baudrate, rp, frequency, mode, enable_rssi, RXcb);
+    return (defaultHandleP != NULL);
+}
+
+bool Metis_Deinit(void)
+{
+    bool ret = Metis_DeinitEx(defaultHandleP);
+    defaultHandleP = NULL;
+    return ret;
+}
+
+bool Metis_SetPipelineDepth(uint8_t depth)
+{
+    return Metis_SetPipelineDepthEx(defaultHandleP, depth);
+}
+
+bool Metis_PinReset(void)
+{
+    return (defaultHandleP != NULL) && Metis_PinResetEx(defaultHandleP);
+}
+
+bool Metis_Reset(void)
+{
+    return (defaultHandleP != NULL) && Metis_ResetEx(defaultHandleP);
+}
+
+bool Metis_Transmit(uint8_t* payload)
+{
+    return (defaultHandleP != NULL) && Metis_TransmitEx(defaultHandleP, payload);
+}
+
+bool Metis_Get(Metis_UserSettings_t us, uint8_t* response, uint8_t* response_length)
+{
+    return (defaultHandleP != NULL) && Metis_GetEx(defaultHandleP, us, response, response_length);
+}
+
+bool Metis_GetMultiple(uint8_t startAddress, uint8_t lengthToRead, uint8_t *response, uint8_t *response_length)
+{
+    return (defaultHandleP != NULL) && Metis_GetMultipleEx(defaultHandleP, startAddress, lengthToRead, response, response_length);
+}
+
+bool Metis_GetFirmwareVersion(uint8_t* fw)
+{
+    return (defaultHandleP != NULL) && Metis_GetFirmwareVersionEx(defaultHandleP, fw);
+}
+
+bool Metis_GetSerialNumber(uint8_t* sn)
+{
+    return (defaultHandleP != NULL) && Metis_GetSerialNumberEx(defaultHandleP, sn);
+}
+
+bool Metis_GetDefaultTXPower(int8_t* txpower)
+{
+    return (defaultHandleP != NULL) && Metis_GetDefaultTXPowerEx(defaultHandleP, txpower);
+}
+
+bool Metis_GetUartOutEnable(uint8_t* uartEnable)
+{
+    return (defaultHandleP != NULL) && Metis_GetUartOutEnableEx(defaultHandleP, uartEnable);
+}
+
+bool Metis_GetRSSIEnable(uint8_t* rssiEnable)
+{
+    return (defaultHandleP != NULL) && Metis_GetRSSIEnableEx(defaultHandleP, rssiEnable);
+}
+
+bool Metis_GetAESEnable(uint8_t* aesEnable)
+{
+    return (defaultHandleP != NULL) && Metis_GetAESEnableEx(defaultHandleP, aesEnable);
+}
+
+bool Metis_GetModePreselect(uint8_t* modePreselect)
+{
+    return (defaultHandleP != NULL) && Metis_GetModePreselectEx(defaultHandleP, modePreselect);
+}
+
+bool Metis_FactoryReset(void)
+{
+    return (defaultHandleP != NULL) && Metis_FactoryResetEx(defaultHandleP);
+}
+
+bool Metis_SetUartSpeed(Metis_UartBaudrate_t baudrate)
+{
+    return (defaultHandleP != NULL) && Metis_SetUartSpeedEx(defaultHandleP, baudrate);
+}
+
+bool Metis_Set(Metis_UserSettings_t us, uint8_t* value, uint8_t length)
+{
+    return (defaultHandleP != NULL) && Metis_SetEx(defaultHandleP, us, value, length);
+}
+
+bool Metis_Configure(Metis_Configuration_t* config, uint8_t config_length, bool factory_reset)
+{
+    return (defaultHandleP != NULL) && Metis_ConfigureEx(defaultHandleP, config, config_length, factory_reset);
+}
+
+bool Metis_SetDefaultTXPower(int8_t txpower)
+{
+    return (defaultHandleP != NULL) && Metis_SetDefaultTXPowerEx(defaultHandleP, txpower);
+}
+
+bool Metis_SetUartOutEnable(uint8_t uartEnable)
+{
+    return (defaultHandleP != NULL) && Metis_SetUartOutEnableEx(defaultHandleP, uartEnable);
+}
+
+bool Metis_SetRSSIEnable(uint8_t rssiEnable)
+{
+    return (defaultHandleP != NULL) && Metis_SetRSSIEnableEx(defaultHandleP, rssiEnable);
+}
+
+bool Metis_SetAESEnable(uint8_t aesEnable)
+{
+    return (defaultHandleP != NULL) && Metis_SetAESEnableEx(defaultHandleP, aesEnable);
+}
+
+bool Metis_SetModePreselect(Metis_Mode_Preselect_t modePreselect)
+{
+    return (defaultHandleP != NULL) && Metis_SetModePreselectEx(defaultHandleP, modePreselect);
+}
+
+bool Metis_SetVolatile_ModePreselect(Metis_Mode_Preselect_t modePreselect)
+{
+    return (defaultHandleP != NULL) && Metis_SetVolatile_ModePreselectEx(defaultHandleP, modePreselect);
+}
+
+#endif // GLOBAL_NO_DEFAULT_TRANSPORT
@@ -128,12 +128,17 @@ typedef struct Metis_Configuration_t
     uint8_t value_length;
 } Metis_Configuration_t;
 
+/* driver instance, see Metis_InitEx */
+typedef struct Metis_Handle_t Metis_Handle_t;
+struct Transport_t;
+
 /* Functions to initialize/deinitialize the module.
 
  * Deinit can be used for both.
  */
 extern bool Metis_Init( int baudrate, int rp, Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t));
 extern bool Metis_Deinit(void);
+extern bool Metis_SetPipelineDepth(uint8_t depth);
 
 extern bool Metis_PinReset(void);
 extern bool Metis_Reset(void);
@@ -169,6 +174,41 @@ extern bool Metis_SetModePreselect(Metis_Mode_Preselect_t modePreselect);
 /* write volatile settings into RAM, these settings are lost after a reset */
 extern bool Metis_SetVolatile_ModePreselect(Metis_Mode_Preselect_t modePreselect);
 
+/* the functions above act on the default driver instance created by Metis_Init,
+ * the functions below act on the driver instance given by handleP, so that several
+ * modules can be used side by side on different transports */
+extern Metis_Handle_t *Metis_InitEx(struct Transport_t *transportP, int baudrate, int rp, Metis_Frequency_t frequency, Metis_Mode_Preselect_t mode, bool enable_rssi, void(*RXcb)(uint8_t*,uint8_t,int8_t));
+extern bool Metis_DeinitEx(Metis_Handle_t *handleP);
+extern Metis_Handle_t *Metis_GetCallbackHandle();
+extern bool Metis_SetPipelineDepthEx(Metis_Handle_t *handleP, uint8_t depth);
+
+extern bool Metis_PinResetEx(Metis_Handle_t *handleP);
+extern bool Metis_ResetEx(Metis_Handle_t *handleP);
+
+extern bool Metis_TransmitEx(Metis_Handle_t *handleP, uint8_t* payload);
+
+extern bool Metis_GetEx(Metis_Handle_t *handleP, Metis_UserSettings_t us, uint8_t* response, uint8_t* response_length);
+extern bool Metis_GetMultipleEx(Metis_Handle_t *handleP, uint8_t startAddress, uint8_t lengthToRead, uint8_t *response, uint8_t *response_length);
+extern bool Metis_GetFirmwareVersionEx(Metis_Handle_t *handleP, uint8_t* fw);
+extern bool Metis_GetSerialNumberEx(Metis_Handle_t *handleP, uint8_t* sn);
+extern bool Metis_GetDefaultTXPowerEx(Metis_Handle_t *handleP, int8_t* txpower);
+extern bool Metis_GetUartOutEnableEx(Metis_Handle_t *handleP, uint8_t* uartEnable);
+extern bool Metis_GetRSSIEnableEx(Metis_Handle_t *handleP, uint8_t* rssiEnable);
+extern bool Metis_GetAESEnableEx(Metis_Handle_t *handleP, uint8_t* aesEnable);
+extern bool Metis_GetModePreselectEx(Metis_Handle_t *handleP, uint8_t* modePreselect);
+
+extern bool Metis_FactoryResetEx(Metis_Handle_t *handleP);
+extern bool Metis_SetUartSpeedEx(Metis_Handle_t *handleP, Metis_UartBaudrate_t baudrate);
+extern bool Metis_SetEx(Metis_Handle_t *handleP, Metis_UserSettings_t us, uint8_t* value, uint8_t length);
+extern bool Metis_ConfigureEx(Metis_Handle_t *handleP, Metis_Configuration_t* config, uint8_t config_length, bool factory_reset);
+extern bool Metis_SetDefaultTXPowerEx(Metis_Handle_t *handleP, int8_t txpower);
+extern bool Metis_SetUartOutEnableEx(Metis_Handle_t *handleP, uint8_t uartEnable);
+extern bool Metis_SetRSSIEnableEx(Metis_Handle_t *handleP, uint8_t rssiEnable);
+extern bool Metis_SetAESEnableEx(Metis_Handle_t *handleP, uint8_t aesEnable);
+extern bool Metis_SetModePreselectEx(Metis_Handle_t *handleP, Metis_Mode_Preselect_t modePreselect);
+
+extern bool Metis_SetVolatile_ModePreselectEx(Metis_Handle_t *handleP, Metis_Mode_Preselect_t modePreselect);
+
 #endif // _Metis_defined
 #ifdef __cplusplus
 }
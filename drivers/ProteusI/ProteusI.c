@@ -146,40 +146,44 @@ typedef struct
  *     Static function declarations   *
  **************************************/
 
-static void HandleRxPacket(uint8_t*RxBuffer);                                                      /* RX packet interpreter */
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                     /* RX packet interpreter */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);
-static bool FillChecksum(uint8_t* array, uint16_t length);                                           /* add the CS needed to finalize the command */
+static void ClearCNF();
 static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint8_t*,int8_t),void(*Ccb)(uint8_t*),void(*DCcb)(),void(*COcb)(uint8_t*,uint16_t),void(*Scb)(uint8_t*,ProteusI_Security_t),void(*PKcb)(uint8_t*));
 
 /**************************************
  *          Static variables          *
  **************************************/
+
+/* command frames of the module: STX, CMD, 16 bit LEN (LSB first), DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 2, HandleRxPacket };
 static uint8_t CMD_Array[MAX_CMD_LENGTH]; /* for UART TX to module*/
 static uint8_t RxPacket[MAX_CMD_LENGTH];
 
-bool AbortUartRxThread;                     /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                     /* boolean to reset the UART RX thread */
+static int rxThreadEvent = -1;                  /* eventfd to reset or abort the UART RX thread */
 
-pthread_t thread_read;
+static pthread_t thread_read;
 
 #define CMDCONFIRMATIONARRAY_LENGTH 2
 
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
+static CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
+static pthread_mutex_t cmdConfirmation_mutex = PTHREAD_MUTEX_INITIALIZER;  /* protects cmdConfirmation_array */
+static pthread_cond_t cmdConfirmation_cond = PTHREAD_COND_INITIALIZER;     /* signalled when a confirmation was stored */
 
 static ProteusI_GetDevices_t* ProteusI_GetDevicesP = NULL;
 static ProteusI_States_t ble_state;
 static bool askedForState;
 
-int reset_pin = 0;                              /* reset pin number */
-int wakeup_pin = 0;                             /* wakeup pin number */
-int boot_pin = 0;                               /* boot pin number */
+static int reset_pin = 0;                       /* reset pin number */
+static int wakeup_pin = 0;                      /* wakeup pin number */
+static int boot_pin = 0;                        /* boot pin number */
 
-void(*RXcallback)(uint8_t*,uint16_t,uint8_t*,int8_t);       /* callback function */
-void(*Connectcallback)(uint8_t*);
-void(*Securitycallback)(uint8_t*,ProteusI_Security_t);
-void(*Passkeycallback)(uint8_t*);
-void(*Disconnectcallback)();
-void(*Channelopencallback)(uint8_t*, uint16_t);
+static void(*RXcallback)(uint8_t*,uint16_t,uint8_t*,int8_t); /* callback function */
+static void(*Connectcallback)(uint8_t*);
+static void(*Securitycallback)(uint8_t*,ProteusI_Security_t);
+static void(*Passkeycallback)(uint8_t*);
+static void(*Disconnectcallback)();
+static void(*Channelopencallback)(uint8_t*, uint16_t);
 
 
 /**************************************
@@ -187,100 +191,16 @@ void(*Channelopencallback)(uint8_t*, uint16_t);
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint16_t RxByteCounter = 0;
-    uint16_t BytesToReceive = 0;
-    uint8_t readBuffer;
     static uint8_t RxBuffer[MAX_CMD_LENGTH]; /* For UART RX from module */
-
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    FrameCodec_t codec;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
-    while(1)
-    {
-        /* wait for 1ms, then check if new RX data is available */
-        delay (1);
-
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
-
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
-
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
 
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for start byte of frame */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field lsb */
-                    RxByteCounter++;
-                    BytesToReceive = (uint16_t)(RxBuffer[RxByteCounter - 1]);
-                    break;
-
-                case 3:
-                    /* length field msb */
-                    RxByteCounter++;
-                    BytesToReceive += (((uint16_t)RxBuffer[RxByteCounter - 1]<<8) + LENGTH_CMD_OVERHEAD); /* len_msb + len_lsb + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
-    }
+    FrameCodec_Init(&codec, &frameProtocol, RxBuffer, sizeof(RxBuffer), NULL);
+    FrameCodec_RxLoop(&codec, GetDefaultTransport(), rxThreadEvent);
     return 0;
 }
 
@@ -312,20 +232,35 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint8_t*,int8_t),void(*Ccb)
     ble_state = ProteusI_State_BLE_Invalid;
     ProteusI_GetDevicesP = NULL;
 
+    /* confirmations are waited for with CLOCK_MONOTONIC deadlines */
+    if(!InitMonotonicCond(&cmdConfirmation_cond))
+    {
+        fprintf(stdout, "Failed to initialize confirmation condition\n");
+        ProteusI_Deinit();
+        return false;
+    }
+
+    /* create the event to reset and abort the RX thread */
+    rxThreadEvent = RxThreadEvent_Create();
+    if(rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        ProteusI_Deinit();
+        return false;
+    }
+
     /* start RX thread */
     if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
     {
         fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
         ProteusI_Deinit();
         return false;
     }
 
-    /* reset module*/
-    if(ProteusI_PinReset())
-    {
-        delay(300);
-    }
-    else
+    /* reset module, it accepts requests as soon as it sent its GETSTATE_CNF */
+    if(false == ProteusI_PinReset())
     {
         fprintf(stdout, "Pin Reset failed\n");
         ProteusI_Deinit();
@@ -337,20 +272,17 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint8_t*,int8_t),void(*Ccb)
     {
         fprintf (stdout, COLOR_CYAN "ProteusI driver version %d.%d.%d\n" COLOR_RESET,driver_version[0],driver_version[1],driver_version[2]);
     }
-    delay(100);
-
 
     uint8_t firmware_version[3];
     if(ProteusI_GetFWVersion(firmware_version))
     {
         fprintf (stdout, COLOR_CYAN "Firmware version %d.%d.%d\n" COLOR_RESET,firmware_version[2],firmware_version[1],firmware_version[0]);
     }
-    delay(100);
 
     return true;
 }
 
-static void HandleRxPacket(uint8_t * pRxBuffer)
+static void HandleRxPacket(void *contextP, uint8_t *pRxBuffer)
 {
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
@@ -551,25 +483,30 @@ static void HandleRxPacket(uint8_t * pRxBuffer)
     }
 
     int i = 0;
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
         if(cmdConfirmation_array[i].cmd == CNFINVALID)
         {
             cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
             cmdConfirmation_array[i].status = cmdConfirmation.status;
+            pthread_cond_broadcast(&cmdConfirmation_cond);
             break;
         }
     }
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 /* function that waits for the return value of ProteusI (*_CNF), when a command (*_REQ) was sent before */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
+    struct timespec deadline;
+    int waitResult = 0;
     int i = 0;
 
+    GetDeadline(&deadline, max_time_ms);
+
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     if(reset_confirmstate)
     {
         for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
@@ -583,44 +520,38 @@ static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Statu
         {
             if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
             {
-                return (cmdConfirmation_array[i].status == expectedStatus);
+                bool ret = (cmdConfirmation_array[i].status == expectedStatus);
+                pthread_mutex_unlock(&cmdConfirmation_mutex);
+                return ret;
             }
         }
 
-        if (count >= max_count)
+        if (waitResult == ETIMEDOUT)
         {
             /* received no correct response within timeout */
+            pthread_mutex_unlock(&cmdConfirmation_mutex);
             return false;
         }
 
-        /* wait */
-        count++;
-        delay(time_step_ms);
+        /* sleep until HandleRxPacket stored a confirmation */
+        waitResult = pthread_cond_timedwait(&cmdConfirmation_cond, &cmdConfirmation_mutex, &deadline);
     }
     return true;
 }
 
-/* function to add the checksum at the end of the data packet */
-static bool
-FillChecksum(uint8_t* pArray, uint16_t length)
+/* function that discards all received confirmations, call it before the request is sent
+ * so that a fast confirmation can not be discarded by Wait4CNF */
+static void ClearCNF()
 {
-    bool ret = false;
+    int i = 0;
 
-    if ((length >= LENGTH_CMD_OVERHEAD) && (pArray[0] == CMD_STX))
+    pthread_mutex_lock(&cmdConfirmation_mutex);
+    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
-        uint8_t checksum = (uint8_t)0;
-        uint16_t payload_length = (uint16_t) (pArray[CMD_POSITION_LENGTH_MSB] << 8) + pArray[CMD_POSITION_LENGTH_LSB];
-        uint16_t i = 0;
-        for (i = 0;
-            i < (payload_length + LENGTH_CMD_OVERHEAD_WITHOUT_CRC);
-            i++)
-        {
-            checksum ^= pArray[i];
-        }
-        pArray[payload_length + LENGTH_CMD_OVERHEAD_WITHOUT_CRC] = checksum;
-        ret = true;
+        cmdConfirmation_array[i].status = CMD_Status_Invalid;
+        cmdConfirmation_array[i].cmd = CNFINVALID;
     }
-    return ret;
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 
@@ -685,7 +616,6 @@ bool ProteusI_Init(int baudrate, int rp,  int wp, int bp, void(*RXcb)(uint8_t*,u
      */
     reset_pin = rp;
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
 
 	/* empty the UART buffers */
     FlushSerial();
@@ -707,7 +637,13 @@ bool ProteusI_Deinit()
     DeinitSerial();
 
     /* abort RX thread */
-    AbortUartRxThread = true;
+    if(rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(thread_read, NULL);
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
+    }
 
     /* deinit pins */
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
@@ -734,15 +670,9 @@ bool ProteusI_Deinit()
  */
 bool ProteusI_PinWakeup()
 {
-    int i = 0;
-
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
     delay (5);
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-    {
-        cmdConfirmation_array[i].status = CMD_Status_Invalid;
-        cmdConfirmation_array[i].cmd = CNFINVALID;
-    }
+    ClearCNF();
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
 
     /* wait for cnf */
@@ -762,7 +692,8 @@ bool ProteusI_PinReset()
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
     FlushSerial();
-    ResetUartRxThread = true;
+    RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_RESET);
+    ClearCNF();
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
 
@@ -770,7 +701,7 @@ bool ProteusI_PinReset()
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
+    return Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false);
 }
 
 /*
@@ -789,13 +720,14 @@ bool ProteusI_Reset()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false);
     }
     return ret;
 }
@@ -816,13 +748,14 @@ ProteusI_Disconnect()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* Confirmation is sent before perfoming the disconnect. After disconnect, module sends dicsonnect indication */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_DISCONNECT_IND, CMD_Status_NoStatus, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_DISCONNECT_IND, CMD_Status_NoStatus, false);
     }
     return ret;
 }
@@ -843,13 +776,14 @@ ProteusI_Sleep()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes( CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_SLEEP_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_SLEEP_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -877,10 +811,11 @@ ProteusI_Transmit(uint8_t *PayloadP, uint16_t length)
 
         memcpy(&CMD_Array[CMD_POSITION_DATA], PayloadP, length);
 
-        if (FillChecksum(&CMD_Array[0], (length + LENGTH_CMD_OVERHEAD)))
+        if (FrameCodec_FillChecksum(&frameProtocol, &CMD_Array[0], (length + LENGTH_CMD_OVERHEAD)))
         {
+            ClearCNF();
             SendBytes( CMD_Array, (length + LENGTH_CMD_OVERHEAD));
-            ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_TXCOMPLETE_RSP, CMD_Status_Success, true);
+            ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_TXCOMPLETE_RSP, CMD_Status_Success, false);
         }
     }
 
@@ -904,13 +839,14 @@ ProteusI_FactoryReset()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for reset after factory reset */
-		return Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
+		return Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false);
     }
     return ret;
 
@@ -943,13 +879,14 @@ ProteusI_Set(ProteusI_UserSettings_t userSetting, uint8_t *ValueP, uint8_t lengt
     CMD_Array[CMD_POSITION_DATA] = userSetting;
     memcpy(&CMD_Array[CMD_POSITION_DATA + 1], ValueP, length);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_SET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_SET_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1125,13 +1062,14 @@ ProteusI_Get(ProteusI_UserSettings_t userSetting, uint8_t *ResponseP, uint16_t *
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_DATA] = userSetting;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GET_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GET_CNF, CMD_Status_Success, false))
         {
             uint16_t length = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8);
             memcpy(ResponseP, &RxPacket[CMD_POSITION_DATA + 1], length - 1); /* First Data byte is status, following bytes response*/
@@ -1330,13 +1268,14 @@ ProteusI_GetState(ProteusI_BLE_Role_t *BLE_roleP, ProteusI_BLE_Action_t *BLE_act
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
         askedForState = true;
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true))
+        if (Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false))
         {
             uint16_t length = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8);
             *BLE_roleP = RxPacket[CMD_POSITION_DATA];
@@ -1379,13 +1318,14 @@ ProteusI_Scanstart()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_SCANSTART_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_SCANSTART_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1407,13 +1347,14 @@ ProteusI_Scanstop()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_SCANSTOP_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_SCANSTOP_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1444,13 +1385,14 @@ ProteusI_GetDevices(ProteusI_GetDevices_t* devicesP)
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETDEVICES_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_GETDEVICES_CNF, CMD_Status_Success, false);
     }
 
     ProteusI_GetDevicesP = NULL;
@@ -1478,13 +1420,14 @@ bool ProteusI_Connect(uint8_t *btmac)
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
     memcpy(&CMD_Array[CMD_POSITION_DATA], btmac, 6);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(3000, ProteusI_CMD_CONNECT_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(3000, ProteusI_CMD_CONNECT_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1509,13 +1452,14 @@ bool ProteusI_Passkey(uint8_t* passkey)
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
     memcpy(&CMD_Array[CMD_POSITION_DATA], passkey, 6);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_PASSKEY_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusI_CMD_PASSKEY_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
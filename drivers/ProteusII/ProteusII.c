@@ -151,41 +151,55 @@ typedef struct
  *     Static function declarations   *
  **************************************/
 
-static void HandleRxPacket(uint8_t*RxBuffer);                                                      /* RX packet interpreter */
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                     /* RX packet interpreter */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);
-static bool FillChecksum(uint8_t* array, uint16_t length);                                           /* add the CS needed to finalize the command */
+static void ClearCNF();
+static bool MessagesEnabled();                                                                      /* DATA_IND passed to the fragmenter */
+static bool SendSegment(void *contextP, uint8_t *payloadP, uint16_t length);                        /* segment of a message to the channel */
+static void MessageReceived(uint8_t *messageP, uint32_t length, void *contextP);                    /* reassembled message of the channel */
 static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint8_t*,int8_t),void(*Ccb)(uint8_t*),void(*DCcb)(),void(*COcb)(uint8_t*,uint16_t),void(*Scb)(uint8_t*,ProteusII_Security_t),void(*PKcb)(uint8_t*),void(*PUcb)(uint8_t*,uint8_t,uint8_t));
 
 /**************************************
  *          Static variables          *
  **************************************/
+
+/* command frames of the module: STX, CMD, 16 bit LEN (LSB first), DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 2, HandleRxPacket };
 static uint8_t CMD_Array[MAX_CMD_LENGTH]; /* for UART TX to module*/
 static uint8_t RxPacket[MAX_CMD_LENGTH];
 
-bool AbortUartRxThread;                     /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                     /* boolean to reset the UART RX thread */
+static int rxThreadEvent = -1;                  /* eventfd to reset or abort the UART RX thread */
 
-pthread_t thread_read;
+static pthread_t thread_read;
 
 #define CMDCONFIRMATIONARRAY_LENGTH 2
 
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
+static CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
+static pthread_mutex_t cmdConfirmation_mutex = PTHREAD_MUTEX_INITIALIZER;  /* protects cmdConfirmation_array */
+static pthread_cond_t cmdConfirmation_cond = PTHREAD_COND_INITIALIZER;     /* signalled when a confirmation was stored */
 
 static ProteusII_GetDevices_t* ProteusII_GetDevicesP = NULL;
 static ProteusII_States_t ble_state;
 static bool askedForState;
 
-int reset_pin = 0;                              /* reset pin number */
-int wakeup_pin = 0;                             /* wakeup pin number */
-int boot_pin = 0;                               /* boot pin number */
+static int reset_pin = 0;                       /* reset pin number */
+static int wakeup_pin = 0;                      /* wakeup pin number */
+static int boot_pin = 0;                        /* boot pin number */
+
+static void(*RXcallback)(uint8_t*,uint16_t,uint8_t*,int8_t); /* callback function */
+static void(*Connectcallback)(uint8_t*);
+static void(*Securitycallback)(uint8_t*,ProteusII_Security_t);
+static void(*Passkeycallback)(uint8_t*);
+static void(*Disconnectcallback)();
+static void(*Channelopencallback)(uint8_t*, uint16_t);
+static void(*Phyupdatecallback)(uint8_t*, uint8_t, uint8_t);
 
-void(*RXcallback)(uint8_t*,uint16_t,uint8_t*,int8_t);       /* callback function */
-void(*Connectcallback)(uint8_t*);
-void(*Securitycallback)(uint8_t*,ProteusII_Security_t);
-void(*Passkeycallback)(uint8_t*);
-void(*Disconnectcallback)();
-void(*Channelopencallback)(uint8_t*, uint16_t);
-void(*Phyupdatecallback)(uint8_t*, uint8_t, uint8_t);
+static pthread_mutex_t messageMutex = PTHREAD_MUTEX_INITIALIZER; /* protects the message callback and the state of the fragmenter */
+static Fragmenter_t fragmenter;                 /* messages over the channel, see ProteusII_SetMessageCallback */
+static bool fragmenterReady = false;            /* fragmenter initialized, it stays until ProteusII_Deinit */
+static ProteusII_MessageCallback messageCb = NULL; /* DATA_IND carry segments of messages while set */
+static void *messageContextP = NULL;
+static uint16_t channelMaxPayload = 0;          /* max payload of the open channel, 0 if no channel is open */
 
 
 /**************************************
@@ -193,100 +207,16 @@ void(*Phyupdatecallback)(uint8_t*, uint8_t, uint8_t);
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint16_t RxByteCounter = 0;
-    uint16_t BytesToReceive = 0;
-    uint8_t readBuffer;
     static uint8_t RxBuffer[MAX_CMD_LENGTH]; /* For UART RX from module */
-
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    FrameCodec_t codec;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
-    while(1)
-    {
-        /* wait for 1ms, then check if new RX data is available */
-        delay (1);
-
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
-
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
-
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
 
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for start byte of frame */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field lsb */
-                    RxByteCounter++;
-                    BytesToReceive = (uint16_t)(RxBuffer[RxByteCounter - 1]);
-                    break;
-
-                case 3:
-                    /* length field msb */
-                    RxByteCounter++;
-                    BytesToReceive += (((uint16_t)RxBuffer[RxByteCounter - 1]<<8) + LENGTH_CMD_OVERHEAD); /* len_msb + len_lsb + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
-    }
+    FrameCodec_Init(&codec, &frameProtocol, RxBuffer, sizeof(RxBuffer), NULL);
+    FrameCodec_RxLoop(&codec, GetDefaultTransport(), rxThreadEvent);
     return 0;
 }
 
@@ -319,20 +249,35 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint8_t*,int8_t),void(*Ccb)
     ble_state = ProteusII_State_BLE_Invalid;
     ProteusII_GetDevicesP = NULL;
 
+    /* confirmations are waited for with CLOCK_MONOTONIC deadlines */
+    if(!InitMonotonicCond(&cmdConfirmation_cond))
+    {
+        fprintf(stdout, "Failed to initialize confirmation condition\n");
+        ProteusII_Deinit();
+        return false;
+    }
+
+    /* create the event to reset and abort the RX thread */
+    rxThreadEvent = RxThreadEvent_Create();
+    if(rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        ProteusII_Deinit();
+        return false;
+    }
+
     /* start RX thread */
     if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
     {
         fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
         ProteusII_Deinit();
         return false;
     }
 
-    /* reset module*/
-    if(ProteusII_PinReset())
-    {
-        delay(300);
-    }
-    else
+    /* reset module, it accepts requests as soon as it sent its GETSTATE_CNF */
+    if(false == ProteusII_PinReset())
     {
         fprintf(stdout, "Pin Reset failed\n");
         ProteusII_Deinit();
@@ -344,20 +289,17 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint8_t*,int8_t),void(*Ccb)
     {
         fprintf (stdout, COLOR_CYAN "ProteusII driver version %d.%d.%d\n" COLOR_RESET,driver_version[0],driver_version[1],driver_version[2]);
     }
-    delay(100);
-
 
     uint8_t firmware_version[3];
     if(ProteusII_GetFWVersion(firmware_version))
     {
         fprintf (stdout, COLOR_CYAN "Firmware version %d.%d.%d\n" COLOR_RESET,firmware_version[2],firmware_version[1],firmware_version[0]);
     }
-    delay(100);
 
     return true;
 }
 
-static void HandleRxPacket(uint8_t * pRxBuffer)
+static void HandleRxPacket(void *contextP, uint8_t *pRxBuffer)
 {
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
@@ -505,6 +447,9 @@ static void HandleRxPacket(uint8_t * pRxBuffer)
         {
             /* Payload of CHANNELOPEN_RSP: Status (1 byte), BTMACH (6 byte), Max Payload (1byte)*/
             ble_state = ProteusII_State_BLE_Channel_Open;
+            pthread_mutex_lock(&messageMutex);
+            channelMaxPayload = RxPacket[CMD_POSITION_DATA + 7];
+            pthread_mutex_unlock(&messageMutex);
             if(Channelopencallback != NULL)
             {
                 Channelopencallback(&RxPacket[CMD_POSITION_DATA], (uint16_t)RxPacket[CMD_POSITION_DATA + 7]);
@@ -525,15 +470,29 @@ static void HandleRxPacket(uint8_t * pRxBuffer)
         case ProteusII_CMD_DISCONNECT_IND:
         {
             ble_state = ProteusII_State_Uart_Open;
+            pthread_mutex_lock(&messageMutex);
+            channelMaxPayload = 0;
+            bool reset = fragmenterReady;
+            pthread_mutex_unlock(&messageMutex);
+            if(reset)
+            {
+                /* the rest of the message being reassembled will not arrive anymore */
+                Fragmenter_Reset(&fragmenter);
+            }
             Disconnectcallback();
             break;
         }
 
         case ProteusII_CMD_DATA_IND:
         {
-            if(RXcallback != NULL)
+            uint16_t payload_length = ((((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) | ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8))) - 7;
+            if(MessagesEnabled())
+            {
+                /* segment of a message, see ProteusII_SetMessageCallback */
+                Fragmenter_Receive(&fragmenter, &RxPacket[CMD_POSITION_DATA + 7], payload_length);
+            }
+            else if(RXcallback != NULL)
             {
-                uint16_t payload_length = ((((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) | ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8))) - 7;
                 RXcallback(&RxPacket[CMD_POSITION_DATA + 7] , payload_length, &RxPacket[CMD_POSITION_DATA], RxPacket[CMD_POSITION_DATA + 6]);
             }
             break;
@@ -574,25 +533,30 @@ static void HandleRxPacket(uint8_t * pRxBuffer)
     }
 
     int i = 0;
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
         if(cmdConfirmation_array[i].cmd == CNFINVALID)
         {
             cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
             cmdConfirmation_array[i].status = cmdConfirmation.status;
+            pthread_cond_broadcast(&cmdConfirmation_cond);
             break;
         }
     }
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 /* function that waits for the return value of ProteusII (*_CNF), when a command (*_REQ) was sent before */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
+    struct timespec deadline;
+    int waitResult = 0;
     int i = 0;
 
+    GetDeadline(&deadline, max_time_ms);
+
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     if(reset_confirmstate)
     {
         for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
@@ -606,44 +570,66 @@ static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Statu
         {
             if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
             {
-                return (cmdConfirmation_array[i].status == expectedStatus);
+                bool ret = (cmdConfirmation_array[i].status == expectedStatus);
+                pthread_mutex_unlock(&cmdConfirmation_mutex);
+                return ret;
             }
         }
 
-        if (count >= max_count)
+        if (waitResult == ETIMEDOUT)
         {
             /* received no correct response within timeout */
+            pthread_mutex_unlock(&cmdConfirmation_mutex);
             return false;
         }
 
-        /* wait */
-        count++;
-        delay(time_step_ms);
+        /* sleep until HandleRxPacket stored a confirmation */
+        waitResult = pthread_cond_timedwait(&cmdConfirmation_cond, &cmdConfirmation_mutex, &deadline);
     }
     return true;
 }
 
-/* function to add the checksum at the end of the data packet */
-static bool
-FillChecksum(uint8_t* pArray, uint16_t length)
+/* function that discards all received confirmations, call it before the request is sent
+ * so that a fast confirmation can not be discarded by Wait4CNF */
+/* function to check whether the DATA_IND are passed to the fragmenter, see ProteusII_SetMessageCallback */
+static bool MessagesEnabled()
 {
-    bool ret = false;
+    pthread_mutex_lock(&messageMutex);
+    bool enabled = (messageCb != NULL);
+    pthread_mutex_unlock(&messageMutex);
+    return enabled;
+}
 
-    if ((length >= LENGTH_CMD_OVERHEAD) && (pArray[0] == CMD_STX))
+/* function called by the fragmenter to send a segment of a message */
+static bool SendSegment(void *contextP, uint8_t *payloadP, uint16_t length)
+{
+    return ProteusII_Transmit(payloadP, length);
+}
+
+/* function called by the fragmenter in the RX thread with a reassembled message */
+static void MessageReceived(uint8_t *messageP, uint32_t length, void *contextP)
+{
+    pthread_mutex_lock(&messageMutex);
+    ProteusII_MessageCallback cb = messageCb;
+    void *cbContextP = messageContextP;
+    pthread_mutex_unlock(&messageMutex);
+    if(cb != NULL)
     {
-        uint8_t checksum = (uint8_t)0;
-        uint16_t payload_length = (uint16_t) (pArray[CMD_POSITION_LENGTH_MSB] << 8) + pArray[CMD_POSITION_LENGTH_LSB];
-        uint16_t i = 0;
-        for (i = 0;
-            i < (payload_length + LENGTH_CMD_OVERHEAD_WITHOUT_CRC);
-            i++)
-        {
-            checksum ^= pArray[i];
-        }
-        pArray[payload_length + LENGTH_CMD_OVERHEAD_WITHOUT_CRC] = checksum;
-        ret = true;
+        cb(messageP, length, cbContextP);
     }
-    return ret;
+}
+
+static void ClearCNF()
+{
+    int i = 0;
+
+    pthread_mutex_lock(&cmdConfirmation_mutex);
+    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+    {
+        cmdConfirmation_array[i].status = CMD_Status_Invalid;
+        cmdConfirmation_array[i].cmd = CNFINVALID;
+    }
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 
@@ -708,7 +694,6 @@ bool ProteusII_Init(int baudrate, int rp,  int wp, int bp, void(*RXcb)(uint8_t*,
      */
     reset_pin = rp;
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
 
 	/* empty the UART buffers */
     FlushSerial();
@@ -730,7 +715,13 @@ bool ProteusII_Deinit()
     DeinitSerial();
 
     /* abort RX thread */
-    AbortUartRxThread = true;
+    if(rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(thread_read, NULL);
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
+    }
 
     /* deinit pins */
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
@@ -747,6 +738,18 @@ bool ProteusII_Deinit()
     Channelopencallback = NULL;
     Phyupdatecallback = NULL;
 
+    /* the RX thread is gone, nothing passes segments to the fragmenter anymore */
+    pthread_mutex_lock(&messageMutex);
+    if(fragmenterReady)
+    {
+        Fragmenter_Deinit(&fragmenter);
+        fragmenterReady = false;
+    }
+    messageCb = NULL;
+    messageContextP = NULL;
+    channelMaxPayload = 0;
+    pthread_mutex_unlock(&messageMutex);
+
     return true;
 }
 
@@ -758,15 +761,9 @@ bool ProteusII_Deinit()
  */
 bool ProteusII_PinWakeup()
 {
-    int i = 0;
-
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
     delay (5);
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-    {
-        cmdConfirmation_array[i].status = CMD_Status_Invalid;
-        cmdConfirmation_array[i].cmd = CNFINVALID;
-    }
+    ClearCNF();
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
 
     /* wait for cnf */
@@ -786,7 +783,8 @@ bool ProteusII_PinReset()
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
     FlushSerial();
-    ResetUartRxThread = true;
+    RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_RESET);
+    ClearCNF();
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
 
@@ -794,7 +792,7 @@ bool ProteusII_PinReset()
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
+    return Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false);
 }
 
 /*
@@ -813,13 +811,14 @@ bool ProteusII_Reset()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-		return Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
+		return Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false);
     }
     return ret;
 }
@@ -840,13 +839,14 @@ ProteusII_Disconnect()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* Confirmation is sent before perfoming the disconnect. After disconnect, module sends dicsonnect indication */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_DISCONNECT_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_DISCONNECT_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -867,13 +867,14 @@ ProteusII_Sleep()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes( CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_SLEEP_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_SLEEP_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -901,16 +902,91 @@ ProteusII_Transmit(uint8_t *PayloadP, uint16_t length)
 
         memcpy(&CMD_Array[CMD_POSITION_DATA], PayloadP, length);
 
-        if (FillChecksum(&CMD_Array[0], (length + LENGTH_CMD_OVERHEAD)))
+        if (FrameCodec_FillChecksum(&frameProtocol, &CMD_Array[0], (length + LENGTH_CMD_OVERHEAD)))
         {
+            ClearCNF();
             SendBytes( CMD_Array, (length + LENGTH_CMD_OVERHEAD));
-            ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_TXCOMPLETE_RSP, CMD_Status_Success, true);
+            ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_TXCOMPLETE_RSP, CMD_Status_Success, false);
         }
     }
 
     return ret;
 }
 
+/*
+ *Receive messages of any length over the channel
+ *
+ *While a callback is set, each DATA_IND carries a segment of a message sent by
+ *ProteusII_SendMessage of the connected device instead of data for the RX callback.
+ *The segments are reassembled in the RX thread, a message missing a segment
+ *is dropped, as is the message being reassembled on disconnect.
+ *
+ *input:
+ * -maxMessageLength: longest message received, fixed by the first call with a callback
+ * -messageCb: called by the RX thread with each message, valid during the call;
+ *             it must not call functions of the driver that wait for the module;
+ *             NULL passes the DATA_IND to the RX callback again
+ * -contextP: passed to the callback
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool ProteusII_SetMessageCallback(uint32_t maxMessageLength, ProteusII_MessageCallback cb, void *contextP)
+{
+    bool ret = true;
+
+    pthread_mutex_lock(&messageMutex);
+    if(!fragmenterReady && (cb != NULL))
+    {
+        /* the segments are sized by the channel in ProteusII_SendMessage, but no longer than
+         * the DATA_IND of the peer can carry, it adds the BTMAC and RSSI (7 bytes) */
+        fragmenterReady = Fragmenter_Init(&fragmenter, SendSegment, NULL, MAX_PAYLOAD_LENGTH - 7,
+                                          maxMessageLength, MessageReceived, NULL);
+        ret = fragmenterReady;
+    }
+    if(ret)
+    {
+        messageCb = cb;
+        messageContextP = contextP;
+    }
+    pthread_mutex_unlock(&messageMutex);
+    return ret;
+}
+
+/*
+ *Send a message of any length over the open channel
+ *
+ *The message is split into packets as long as the max payload of the channel
+ *allows, each sent by ProteusII_Transmit, which the connected device
+ *reassembles, see ProteusII_SetMessageCallback.
+ *
+ *input:
+ * -messageP: pointer to the message
+ * -length:   length of the message
+ *
+ *return true if all packets of the message were transmitted
+ *       false otherwise, the connected device drops the incomplete message
+ */
+bool ProteusII_SendMessage(uint8_t *messageP, uint32_t length)
+{
+    pthread_mutex_lock(&messageMutex);
+    bool ready = fragmenterReady;
+    uint16_t maxPayload = channelMaxPayload;
+    pthread_mutex_unlock(&messageMutex);
+    if(!ready || (maxPayload == 0))
+    {
+        /* no callback set yet or no channel open */
+        return false;
+    }
+
+    if(!Fragmenter_SetMaxPayload(&fragmenter, maxPayload))
+    {
+        fprintf(stdout, "Max payload %u of the channel too small for messages\n", maxPayload);
+        return false;
+    }
+    return Fragmenter_Send(&fragmenter, messageP, length);
+}
+
 
 /*
  *Factory reset the module
@@ -928,13 +1004,14 @@ ProteusII_FactoryReset()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for reset after factory reset */
-		return Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
+		return Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false);
     }
     return ret;
 
@@ -967,13 +1044,14 @@ ProteusII_Set(ProteusII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t len
     CMD_Array[CMD_POSITION_DATA] = userSetting;
     memcpy(&CMD_Array[CMD_POSITION_DATA + 1], ValueP, length);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-		return Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_SET_CNF, CMD_Status_Success, true);
+		return Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_SET_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1169,13 +1247,14 @@ ProteusII_Get(ProteusII_UserSettings_t userSetting, uint8_t *ResponseP, uint16_t
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_DATA] = userSetting;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GET_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GET_CNF, CMD_Status_Success, false))
         {
             uint16_t length = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8);
             memcpy(ResponseP, &RxPacket[CMD_POSITION_DATA + 1], length - 1); /* First Data byte is status, following bytes response*/
@@ -1396,13 +1475,14 @@ ProteusII_GetState(ProteusII_BLE_Role_t *BLE_roleP, ProteusII_BLE_Action_t *BLE_
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
         askedForState = true;
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true))
+        if (Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false))
         {
             uint16_t length = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8);
             *BLE_roleP = RxPacket[CMD_POSITION_DATA];
@@ -1445,13 +1525,14 @@ ProteusII_Scanstart()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_SCANSTART_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_SCANSTART_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1473,13 +1554,14 @@ ProteusII_Scanstop()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_SCANSTOP_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_SCANSTOP_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1510,13 +1592,14 @@ ProteusII_GetDevices(ProteusII_GetDevices_t* devicesP)
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETDEVICES_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_GETDEVICES_CNF, CMD_Status_Success, false);
     }
 
     ProteusII_GetDevicesP = NULL;
@@ -1544,13 +1627,14 @@ bool ProteusII_Connect(uint8_t *btmac)
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
     memcpy(&CMD_Array[CMD_POSITION_DATA], btmac, 6);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(3000, ProteusII_CMD_CONNECT_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(3000, ProteusII_CMD_CONNECT_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1575,13 +1659,14 @@ bool ProteusII_Passkey(uint8_t* passkey)
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
     memcpy(&CMD_Array[CMD_POSITION_DATA], passkey, 6);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_PASSKEY_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_PASSKEY_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1609,13 +1694,14 @@ bool ProteusII_PhyUpdate(uint8_t phy)
 		CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 		CMD_Array[CMD_POSITION_DATA]= phy;
 
-		if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+		if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
 		{
+			ClearCNF();
 			/* now send CMD_ARRAY */
 			SendBytes(CMD_Array, CMD_ARRAY_SIZE());
 
 			/* wait for cnf */
-			ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_PHYUPDATE_CNF, CMD_Status_Success, true);
+			ret = Wait4CNF(CMD_WAIT_TIME, ProteusII_CMD_PHYUPDATE_CNF, CMD_Status_Success, false);
 		}
 	}
     return ret;
@@ -55,6 +55,10 @@ typedef struct ProteusII_GetDevices_t {
     ProteusII_Device_t devices[MAX_NUMBER_OF_DEVICES];
 } ProteusII_GetDevices_t;
 
+/* message of the connected device reassembled from its DATA_IND, messageP is valid
+ * until the callback returns, see ProteusII_SetMessageCallback */
+typedef void (*ProteusII_MessageCallback)(uint8_t* messageP, uint32_t length, void* contextP);
+
 typedef enum ProteusII_States_t {
     ProteusII_State_BLE_Invalid =         (uint8_t)0x00,
     ProteusII_State_BLE_Connected =       (uint8_t)0x01,
@@ -170,6 +174,8 @@ extern bool ProteusII_Scanstop();
 extern bool ProteusII_GetDevices(ProteusII_GetDevices_t* devicesP);
 
 extern bool ProteusII_Transmit(uint8_t* PayloadP, uint16_t length);
+extern bool ProteusII_SetMessageCallback(uint32_t maxMessageLength, ProteusII_MessageCallback messageCb, void *contextP);
+extern bool ProteusII_SendMessage(uint8_t *messageP, uint32_t length);
 
 extern bool ProteusII_Passkey(uint8_t* passkeyP);
 
@@ -168,8 +168,6 @@
 #define ProteusIII_CMD_GPIO_REMOTE_READ_REQ (ProteusIII_CMD_GPIO_REMOTE_READ | ProteusIII_CMD_TYPE_REQ)
 #define ProteusIII_CMD_GPIO_REMOTE_READ_CNF (ProteusIII_CMD_GPIO_REMOTE_READ | ProteusIII_CMD_TYPE_CNF)
 
-#define CMD_ARRAY_SIZE() ((((uint16_t)CMD_Array[CMD_POSITION_LENGTH_LSB] << 0) | ((uint16_t)CMD_Array[CMD_POSITION_LENGTH_MSB] << 8)) + LENGTH_CMD_OVERHEAD)
-
 
 /* type used to check the response, when a command was sent to the ProteusIII */
 typedef enum CMD_Status_t
@@ -187,139 +185,155 @@ typedef struct
     CMD_Status_t status; /* variable used to check the response (*_CNF), when a request (*_REQ) was sent to the ProteusIII */
 } CMD_Confirmation_t;
 
+/* asynchronous command, stored as the context of its request, see SendCommandAsync */
+typedef struct
+{
+    ProteusIII_CommandCallback callback;
+    void *contextP;
+    CMD_Status_t expectedStatus;
+    uint16_t dataOffset; /* first byte of the DATA of the answer passed to the callback */
+} AsyncCommand_t;
+
+/* slot of the scan index, see ProteusIII_ScanStreamStartEx */
+typedef struct
+{
+    ProteusIII_ScanDevice_t device;
+    int16_t rssiAverage; /* mean of the RSSI in 1/16 dBm */
+    uint64_t lastSeen_ms; /* CLOCK_MONOTONIC of the last scan result */
+    bool used;
+} ScanEntry_t;
+
+/* cached value of a pin, see ProteusIII_SetGPIOCacheEx */
+typedef struct
+{
+    uint8_t value;
+    bool valid;
+    uint64_t updated_ms; /* CLOCK_MONOTONIC of the last update */
+    uint32_t generation; /* gpioGeneration of the last update by an indication, write or invalidation */
+    uint8_t reported; /* value last known to the application, see GPIOCache_Report */
+    bool known;
+} GPIOCacheEntry_t;
+
 /**************************************
  *     Static function declarations   *
  **************************************/
 
-static void HandleRxPacket(uint8_t*RxBuffer);                                                      /* RX packet interpreter */
-static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);
-static bool FillChecksum(uint8_t* array, uint16_t length);                                           /* add the CS needed to finalize the command */
-static bool InitDriver(ProteusIII_CallbackConfig_t callbackConfig);
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                                                   /* RX packet interpreter */
+static void PostCallback(ProteusIII_Handle_t *handleP, uint8_t *pRxBuffer);                                                      /* pass an indication to the callback thread */
+static void ExecuteCallback(void *contextP, uint8_t *pRxBuffer);                                                                 /* call the callback of an indication */
+static bool Wait4CNF(ProteusIII_Handle_t *handleP, CommandQueue_Request_t *requestP, int max_time_ms, CMD_Status_t expectedStatus);
+static bool SendCommand(ProteusIII_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length, CommandQueue_Request_t *requestP); /* send a command without copying its payload */
+static uint8_t *ReserveFrame(ProteusIII_Handle_t *handleP);                                                                      /* take a TX frame to fill in place */
+static bool SubmitFrame(ProteusIII_Handle_t *handleP, uint8_t *frameP, CommandQueue_Request_t *requestP);                        /* send a filled TX frame and give it back */
+static bool SendCommandAsync(ProteusIII_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length,
+                             uint8_t confirmation, CMD_Status_t expectedStatus, uint16_t dataOffset, ProteusIII_CommandCallback cb, void* contextP); /* send a command without waiting for its answer */
+static void StreamPacketDone(CommandQueue_Request_t *requestP, bool answered);                                                    /* DATA_CNF of a stream packet */
+static void StreamRelease(ProteusIII_Handle_t *handleP, uint16_t count, bool success);                                            /* give credits of the stream back */
+static bool StreamBusy(ProteusIII_Handle_t *handleP);                                                                             /* packets of the stream in flight */
+static bool MessagesEnabled(ProteusIII_Handle_t *handleP);                                                                        /* DATA_IND carry segments of messages */
+static bool SendSegment(void *contextP, uint8_t *payloadP, uint16_t length);                                                      /* send a segment of a message as stream packet */
+static void MessageReceived(uint8_t *messageP, uint32_t length, void *contextP);                                                  /* call the message callback with a reassembled message */
+static uint8_t DeviceCount(const uint8_t *frameP);                                                                                /* devices listed in a GETDEVICES_CNF */
+static bool ParseDevice(const uint8_t *frameP, uint16_t *positionP, ProteusIII_Device_t *deviceP);                                /* read the next device of a GETDEVICES_CNF */
+static void ScanIndex_Ingest(ProteusIII_Handle_t *handleP, const uint8_t *frameP);                                                /* add the devices of a GETDEVICES_CNF to the scan index */
+static ScanEntry_t *ScanIndex_Insert(ProteusIII_Handle_t *handleP, const uint8_t *btmacP);                                        /* find or add the slot of a device */
+static uint32_t ScanIndex_Find(ProteusIII_Handle_t *handleP, const uint8_t *btmacP);                                              /* slot of a device */
+static bool ScanIndex_Grow(ProteusIII_Handle_t *handleP);                                                                         /* double the slots of the scan index */
+static void ScanIndex_Remove(ProteusIII_Handle_t *handleP, uint32_t slot);                                                        /* remove a device and close the gap */
+static bool GPIOCache_Indicate(ProteusIII_Handle_t *handleP, bool remote, const uint8_t *frameP);                                  /* store the pins of a GPIO write indication */
+static void GPIOCache_Report(ProteusIII_Handle_t *handleP, bool remote, const uint8_t *frameP);                                    /* call the GPIO change callback for an indication */
+static void GPIOCache_Invalidate(ProteusIII_Handle_t *handleP, bool remote, uint8_t GPIO_ID);                                      /* forget the value of a pin, or of all pins */
+static bool GPIORead(ProteusIII_Handle_t *handleP, bool remote, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP);
+static bool InitDriver(ProteusIII_Handle_t *handleP, ProteusIII_CallbackConfig_t callbackConfig);
+static bool InitModule(ProteusIII_Handle_t *handleP, int baudrate, int rp, int wp, int bp, ProteusIII_CallbackConfig_t callbackConfig);
 
 /**************************************
  *          Static variables          *
  **************************************/
-static uint8_t CMD_Array[MAX_CMD_LENGTH]; /* for UART TX to module*/
-static uint8_t RxPacket[MAX_CMD_LENGTH];
-
-bool AbortUartRxThread;                     /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                     /* boolean to reset the UART RX thread */
-
-pthread_t thread_read;
-
-#define CMDCONFIRMATIONARRAY_LENGTH 2
-
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
-
-static ProteusIII_GetDevices_t* ProteusIII_GetDevicesP = NULL;
-static ProteusIII_States_t ble_state;
-static bool askedForState;
-
-int reset_pin = 0;                              /* reset pin number */
-int wakeup_pin = 0;                             /* wakeup pin number */
-int boot_pin = 0;                               /* boot pin number */
 
+/* command frames of the module: STX, CMD, 16 bit LEN (LSB first), DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 2, HandleRxPacket };
+
+#define CMDQUEUE_DEPTH 1                        /* requests in flight, see ProteusIII_SetPipelineDepthEx */
+#define RXPOOL_LENGTH 8                         /* RX frames the application can hold without allocations */
+#define RXPOOL_MAX_ALLOCATED 56                 /* further RX frames the application can hold, the RX thread drops frames beyond */
+#define TXPOOL_LENGTH 4                         /* requests built concurrently without allocations */
+#define TXPOOL_MAX_ALLOCATED 12                 /* further requests built concurrently, requests beyond fail */
+#define STREAM_WINDOW 1                         /* data packets in flight, see ProteusIII_SetStreamWindowEx */
+#define SCANINDEX_MIN_CAPACITY 64               /* slots of the scan index when created, a power of two */
+#define SCANINDEX_MAX_CAPACITY 65536            /* slots the scan index grows to at most, a power of two */
+#define SCANINDEX_RSSI_WEIGHT 4                 /* a new RSSI moves the mean of a device by 1/SCANINDEX_RSSI_WEIGHT of the difference */
+#define SCANINDEX_NO_SLOT UINT32_MAX
+
+/* state of one driver instance */
+struct ProteusIII_Handle_t
+{
+    Transport_t *transportP;                    /* communication interface to the module */
+    FramePool_t *txPoolP;                       /* frames for UART TX to module, see ReserveFrame */
+    int rxThreadEvent;                          /* eventfd to reset or abort the UART RX thread */
+    pthread_t thread_read;
+    CommandQueue_t cmdQueue;                    /* requests waiting for their confirmation */
+    ProteusIII_States_t ble_state;
+    bool askedForState;
+    int reset_pin;                              /* reset pin number */
+    int wakeup_pin;                             /* wakeup pin number */
+    int boot_pin;                               /* boot pin number */
+    ProteusIII_CallbackConfig_t callbacks;
+    ProteusIII_RxBufferCallback rxBufferCb;     /* replaces callbacks.rxCb, if set */
+    FramePool_t *rxPoolP;                       /* buffers for UART RX from module */
+    CallbackExecutor_t callbackExecutor;        /* runs the callbacks apart from the RX thread */
+    pthread_mutex_t streamMutex;                /* protects the stream credits, see ProteusIII_StreamTransmitEx */
+    pthread_cond_t streamCond;                  /* signalled when a credit was released */
+    uint16_t streamWindow;                      /* data packets allowed in flight */
+    uint16_t streamInFlight;                    /* data packets sent, but not yet confirmed by TXCOMPLETE_RSP */
+    uint32_t streamFailed;                      /* data packets lost since the last ProteusIII_StreamFlushEx */
+    pthread_mutex_t scanMutex;                  /* protects the scan index and the state of the scan thread */
+    pthread_cond_t scanCond;                    /* signalled to stop the scan thread */
+    ScanEntry_t *scanTableP;                    /* scan index, open addressing by BTMAC, NULL until the first scan stream */
+    uint32_t scanCapacity;                      /* slots of scanTableP */
+    uint32_t scanCount;                         /* devices in scanTableP */
+    pthread_t thread_scan;                      /* polls the scan results, see ProteusIII_ScanStreamStartEx */
+    bool scanRunning;
+    bool scanStop;
+    uint16_t scanInterval_ms;                   /* time between two GETDEVICES_REQ of the scan thread */
+    uint32_t scanMaxAge_ms;                     /* devices not seen for this time are removed by the scan thread, 0 to keep them */
+    pthread_mutex_t gpioMutex;                  /* protects the GPIO cache and its callback */
+    GPIOCacheEntry_t gpioCache[2][ProteusIII_AMOUNT_GPIO_PINS]; /* pins by local (0) or remote (1) and GPIO_ID - 1 */
+    uint32_t gpioGeneration;                    /* increased by each indication, write and invalidation, so that an older read cannot overwrite them */
+    uint32_t gpioMaxAge_ms;                     /* cached values younger than this are read without request, 0 requests every read */
+    ProteusIII_GPIOChangeCallback gpioChangeCb; /* called for pins changed by the module or the connected device */
+    void *gpioChangeContextP;
+    pthread_mutex_t messageMutex;               /* protects the message callback and the state of the fragmenter */
+    Fragmenter_t fragmenter;                    /* messages over the channel, see ProteusIII_SetMessageCallbackEx */
+    bool fragmenterReady;                       /* fragmenter initialized, it stays until the instance is freed */
+    ProteusIII_MessageCallback messageCb;       /* DATA_IND carry segments of messages while set */
+    void *messageContextP;
+    uint16_t channelMaxPayload;                 /* max payload of the open channel, 0 if no channel is open */
+};
+
+/* instance whose callback thread is executing the current callback */
+static __thread ProteusIII_Handle_t *callbackHandleP = NULL;
 
-ProteusIII_CallbackConfig_t callbacks;
 /**************************************
  *         Static functions           *
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint16_t RxByteCounter = 0;
-    uint16_t BytesToReceive = 0;
-    uint8_t readBuffer;
-    static uint8_t RxBuffer[MAX_CMD_LENGTH]; /* For UART RX from module */
-
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    ProteusIII_Handle_t *handleP = argP;
+    FrameCodec_t codec;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
-    while(1)
-    {
-        /* wait for 1ms, then check if new RX data is available */
-        delay (1);
-
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
-
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
-
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
 
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for start byte of frame */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field lsb */
-                    RxByteCounter++;
-                    BytesToReceive = (uint16_t)(RxBuffer[RxByteCounter - 1]);
-                    break;
-
-                case 3:
-                    /* length field msb */
-                    RxByteCounter++;
-                    BytesToReceive += (((uint16_t)RxBuffer[RxByteCounter - 1]<<8) + LENGTH_CMD_OVERHEAD); /* len_msb + len_lsb + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
+    if(!FrameCodec_InitPool(&codec, &frameProtocol, handleP->rxPoolP, handleP))
+    {
+        fprintf(stdout, "Failed to allocate RX buffer\n");
+        return 0;
     }
+    FrameCodec_RxLoop(&codec, handleP->transportP, handleP->rxThreadEvent);
+    FrameCodec_Deinit(&codec);
     return 0;
 }
 
@@ -338,38 +352,41 @@ void *rx_thread()
  *return true if initialization succeeded
  *       false otherwise
  */
-static bool InitDriver(ProteusIII_CallbackConfig_t callbackConfig)
+static bool InitDriver(ProteusIII_Handle_t *handleP, ProteusIII_CallbackConfig_t callbackConfig)
 {
     /* set RX callback function */
-    callbacks.rxCb = callbackConfig.rxCb;
-    callbacks.connectCp = callbackConfig.connectCp;
-    callbacks.securityCb = callbackConfig.securityCb;
-    callbacks.passkeyCb = callbackConfig.passkeyCb;
-    callbacks.disconnectCb = callbackConfig.disconnectCb;
-    callbacks.channelOpenCb = callbackConfig.channelOpenCb;
-    callbacks.phyUpdateCb = callbackConfig.phyUpdateCb;
-
-    askedForState = false;
-    ble_state = ProteusIII_State_BLE_Invalid;
-    ProteusIII_GetDevicesP = NULL;
+    handleP->callbacks.rxCb = callbackConfig.rxCb;
+    handleP->callbacks.connectCp = callbackConfig.connectCp;
+    handleP->callbacks.securityCb = callbackConfig.securityCb;
+    handleP->callbacks.passkeyCb = callbackConfig.passkeyCb;
+    handleP->callbacks.disconnectCb = callbackConfig.disconnectCb;
+    handleP->callbacks.channelOpenCb = callbackConfig.channelOpenCb;
+    handleP->callbacks.phyUpdateCb = callbackConfig.phyUpdateCb;
+
+    handleP->askedForState = false;
+    handleP->ble_state = ProteusIII_State_BLE_Invalid;
+
+    /* create the event to reset and abort the RX thread */
+    handleP->rxThreadEvent = RxThreadEvent_Create();
+    if(handleP->rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        return false;
+    }
 
     /* start RX thread */
-    if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
+    if(pthread_create(&handleP->thread_read, NULL, &rx_thread, handleP))
     {
         fprintf(stdout, "Failed to start rx_Thread\n");
-        ProteusIII_Deinit();
+        RxThreadEvent_Destroy(handleP->rxThreadEvent);
+        handleP->rxThreadEvent = -1;
         return false;
     }
 
-    /* reset module*/
-    if(ProteusIII_PinReset())
-    {
-        delay(300);
-    }
-    else
+    /* reset module, it accepts requests as soon as it sent its GETSTATE_CNF */
+    if(false == ProteusIII_PinResetEx(handleP))
     {
         fprintf(stdout, "Pin Reset failed\n");
-        ProteusIII_Deinit();
         return false;
     }
 
@@ -378,285 +395,354 @@ static bool InitDriver(ProteusIII_CallbackConfig_t callbackConfig)
     {
         fprintf (stdout, COLOR_CYAN "ProteusIII driver version %d.%d.%d\n" COLOR_RESET,driver_version[0],driver_version[1],driver_version[2]);
     }
-    delay(100);
-
 
     uint8_t firmware_version[3];
-    if(ProteusIII_GetFWVersion(firmware_version))
+    if(ProteusIII_GetFWVersionEx(handleP, firmware_version))
     {
         fprintf (stdout, COLOR_CYAN "Firmware version %d.%d.%d\n" COLOR_RESET,firmware_version[2],firmware_version[1],firmware_version[0]);
     }
-    delay(100);
 
     return true;
 }
 
-static void HandleRxPacket(uint8_t * pRxBuffer)
+/* open the interface, set up the pins and start the driver */
+static bool InitModule(ProteusIII_Handle_t *handleP, int baudrate, int rp, int wp, int bp, ProteusIII_CallbackConfig_t callbackConfig)
+{
+    if (false == Transport_Open(handleP->transportP, baudrate, Serial_ParityBit_NONE))
+    {
+        /* error */
+        return false ;
+    }
+    /* let the timeouts of the commands adapt to the answer times of the module */
+    CommandQueue_SetLineRate(&handleP->cmdQueue, baudrate);
+
+    /* initialize the boot pin */
+    if (false == Transport_InitPin(handleP->transportP, bp))
+    {
+        /* error */
+        return false ;
+    }
+    handleP->boot_pin = bp;
+    Transport_SetPin(handleP->transportP, handleP->boot_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+
+    /* initialize the wakeup pin */
+    if (false == Transport_InitPin(handleP->transportP, wp))
+    {
+        /* error */
+        return false ;
+    }
+    handleP->wakeup_pin = wp;
+    Transport_SetPin(handleP->transportP, handleP->wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+
+    /* initialize the reset pin,
+     * we have to define it as input/pull-up such that the reset button
+     * can pull the pin level down if the button is pressed
+     */
+    if (false == Transport_InitPin(handleP->transportP, rp))
+    {
+        /* error */
+        return false ;
+    }
+    handleP->reset_pin = rp;
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
+
+    /* empty the UART buffers */
+    Transport_Flush(handleP->transportP);
+
+    /* init the driver and module*/
+    return InitDriver(handleP, callbackConfig);
+}
+
+static void HandleRxPacket(void *contextP, uint8_t *pRxBuffer)
 {
+    ProteusIII_Handle_t *handleP = contextP;
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
     cmdConfirmation.status = CMD_Status_Invalid;
 
-    uint16_t cmd_length = (uint16_t)(pRxBuffer[CMD_POSITION_LENGTH_LSB]+(pRxBuffer[CMD_POSITION_LENGTH_MSB]<<8));
-    memcpy(&RxPacket[0], pRxBuffer, cmd_length + LENGTH_CMD_OVERHEAD);
-
-    switch (RxPacket[CMD_POSITION_CMD])
+    switch (pRxBuffer[CMD_POSITION_CMD])
     {
     case ProteusIII_CMD_RESET_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_SCANSTART_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_SCANSTOP_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GETDEVICES_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
-        if((cmdConfirmation.status == CMD_Status_Success)&&(ProteusIII_GetDevicesP != NULL))
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
+        if(cmdConfirmation.status == CMD_Status_Success)
         {
-            uint8_t size = RxPacket[CMD_POSITION_DATA+1];
-
-            if (size >= MAX_NUMBER_OF_DEVICES)
-            {
-                size = MAX_NUMBER_OF_DEVICES;
-            }
-            ProteusIII_GetDevicesP->numberofdevices = size;
-
-            int i;
-            int len = CMD_POSITION_DATA+2;
-            for(i=0; i<ProteusIII_GetDevicesP->numberofdevices; i++)
-            {
-                memcpy(&ProteusIII_GetDevicesP->devices[i].btmac[0],&RxPacket[len],6);
-                ProteusIII_GetDevicesP->devices[i].rssi = RxPacket[len+6];
-                ProteusIII_GetDevicesP->devices[i].txpower = RxPacket[len+7];
-                ProteusIII_GetDevicesP->devices[i].devicenamelength = RxPacket[len+8];
-                memcpy(&ProteusIII_GetDevicesP->devices[i].devicename[0],&RxPacket[len+9],ProteusIII_GetDevicesP->devices[i].devicenamelength);
-                len += (9+ProteusIII_GetDevicesP->devices[i].devicenamelength);
-            }
+            /* every scan result feeds the scan index, whoever requested it */
+            ScanIndex_Ingest(handleP, pRxBuffer);
         }
         break;
     }
 
     case ProteusIII_CMD_GET_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_SET_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_PASSKEY_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_PHYUPDATE_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GETSTATE_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
         cmdConfirmation.status = CMD_Status_NoStatus;
         break;
     }
 
     case ProteusIII_CMD_CONNECT_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_DATA_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_DISCONNECT_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_FACTORYRESET_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_SLEEP_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GPIO_LOCAL_WRITECONFIG_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GPIO_LOCAL_READCONFIG_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GPIO_LOCAL_WRITE_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GPIO_LOCAL_READ_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GPIO_REMOTE_WRITECONFIG_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GPIO_REMOTE_READCONFIG_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GPIO_REMOTE_WRITE_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_GPIO_REMOTE_READ_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_TXCOMPLETE_RSP:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        /* the module sends buffered packets in order, so that the oldest packet of the stream was transmitted */
+        pthread_mutex_lock(&handleP->streamMutex);
+        bool streamed = (handleP->streamInFlight > 0);
+        pthread_mutex_unlock(&handleP->streamMutex);
+        if(streamed)
+        {
+            StreamRelease(handleP, 1, pRxBuffer[CMD_POSITION_DATA] == CMD_Status_Success);
+            break;
+        }
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ProteusIII_CMD_CHANNELOPEN_RSP:
     {
         /* Payload of CHANNELOPEN_RSP: Status (1 byte), BTMACH (6 byte), Max Payload (1byte)*/
-        ble_state = ProteusIII_State_BLE_Channel_Open;
-        if(callbacks.channelOpenCb != NULL)
+        handleP->ble_state = ProteusIII_State_BLE_Channel_Open;
+        /* size of the segments of the messages sent from now on */
+        pthread_mutex_lock(&handleP->messageMutex);
+        handleP->channelMaxPayload = pRxBuffer[CMD_POSITION_DATA + 7];
+        pthread_mutex_unlock(&handleP->messageMutex);
+        if(handleP->callbacks.channelOpenCb != NULL)
         {
-            callbacks.channelOpenCb(&RxPacket[CMD_POSITION_DATA+1], (uint16_t)RxPacket[CMD_POSITION_DATA + 7]);
+            PostCallback(handleP, pRxBuffer);
         }
         break;
     }
 
     case ProteusIII_CMD_CONNECT_IND:
     {
-        ble_state = ProteusIII_State_BLE_Connected;
-        if(callbacks.connectCp != NULL)
+        handleP->ble_state = ProteusIII_State_BLE_Connected;
+        if(handleP->callbacks.connectCp != NULL)
         {
-            callbacks.connectCp(&RxPacket[CMD_POSITION_DATA+1]);
+            PostCallback(handleP, pRxBuffer);
         }
         break;
     }
 
     case ProteusIII_CMD_DISCONNECT_IND:
     {
-        if(callbacks.disconnectCb != NULL)
+        /* packets of the stream still buffered by the module are not transmitted anymore */
+        pthread_mutex_lock(&handleP->streamMutex);
+        uint16_t lost = handleP->streamInFlight;
+        pthread_mutex_unlock(&handleP->streamMutex);
+        StreamRelease(handleP, lost, false);
+        /* the pins of the next remote device are unknown */
+        GPIOCache_Invalidate(handleP, true, 0);
+        pthread_mutex_lock(&handleP->messageMutex);
+        handleP->channelMaxPayload = 0;
+        bool fragmenterReady = handleP->fragmenterReady;
+        pthread_mutex_unlock(&handleP->messageMutex);
+        /* the callback thread drops the message being reassembled */
+        if((handleP->callbacks.disconnectCb != NULL) || fragmenterReady)
         {
-            callbacks.disconnectCb();
+            PostCallback(handleP, pRxBuffer);
         }
         break;
     }
 
     case ProteusIII_CMD_DATA_IND:
     {
-        if(callbacks.rxCb != NULL)
+        if((handleP->rxBufferCb != NULL) || (handleP->callbacks.rxCb != NULL) || MessagesEnabled(handleP))
         {
-            uint16_t payload_length = ((((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) | ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8))) - 7;
-            callbacks.rxCb(&RxPacket[CMD_POSITION_DATA + 7], payload_length, &RxPacket[CMD_POSITION_DATA], RxPacket[CMD_POSITION_DATA + 6]);
+            PostCallback(handleP, pRxBuffer);
         }
         break;
     }
 
     case ProteusIII_CMD_SECURITY_IND:
     {
-        if(callbacks.securityCb != NULL)
+        if(handleP->callbacks.securityCb != NULL)
         {
-            callbacks.securityCb(&RxPacket[CMD_POSITION_DATA+1],RxPacket[CMD_POSITION_DATA]);
+            PostCallback(handleP, pRxBuffer);
         }
         break;
     }
 
     case ProteusIII_CMD_PASSKEY_IND:
     {
-        if(callbacks.passkeyCb != NULL)
+        if(handleP->callbacks.passkeyCb != NULL)
         {
-            callbacks.passkeyCb(&RxPacket[CMD_POSITION_DATA+1]);
+            PostCallback(handleP, pRxBuffer);
         }
         break;
     }
 
     case ProteusIII_CMD_DISPLAY_PASSKEY_IND:
     {
-        if(callbacks.displayPasskeyCb != NULL)
+        if(handleP->callbacks.displayPasskeyCb != NULL)
         {
-            callbacks.displayPasskeyCb((ProteusIII_DisplayPasskeyAction_t)RxPacket[CMD_POSITION_DATA],&RxPacket[CMD_POSITION_DATA+1],&RxPacket[CMD_POSITION_DATA+7]);
+            PostCallback(handleP, pRxBuffer);
         }
         break;
     }
 
     case ProteusIII_CMD_PHYUPDATE_IND:
     {
-        if(callbacks.phyUpdateCb != NULL)
+        if(handleP->callbacks.phyUpdateCb != NULL)
+        {
+            PostCallback(handleP, pRxBuffer);
+        }
+        break;
+    }
+
+    case ProteusIII_CMD_GPIO_LOCAL_WRITE_IND:
+    {
+        /* the connected device wrote local pins */
+        if(GPIOCache_Indicate(handleP, false, pRxBuffer))
+        {
+            PostCallback(handleP, pRxBuffer);
+        }
+        break;
+    }
+
+    case ProteusIII_CMD_GPIO_REMOTE_WRITE_IND:
+    {
+        if(GPIOCache_Indicate(handleP, true, pRxBuffer))
         {
-            callbacks.phyUpdateCb(&RxPacket[CMD_POSITION_DATA+3],(ProteusIII_Phy_t)RxPacket[CMD_POSITION_DATA+1],(ProteusIII_Phy_t)RxPacket[CMD_POSITION_DATA+2]);
+            PostCallback(handleP, pRxBuffer);
         }
         break;
     }
@@ -668,1417 +754,3530 @@ static void HandleRxPacket(uint8_t * pRxBuffer)
     }
     }
 
-    int i = 0;
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+    if(cmdConfirmation.cmd != CNFINVALID)
     {
-        if(cmdConfirmation_array[i].cmd == CNFINVALID)
-        {
-            cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
-            cmdConfirmation_array[i].status = cmdConfirmation.status;
-            break;
-        }
+        /* indications are passed on in place, only answers are copied for the command waiting for them */
+        uint16_t cmd_length = (uint16_t)(pRxBuffer[CMD_POSITION_LENGTH_LSB]+(pRxBuffer[CMD_POSITION_LENGTH_MSB]<<8));
+        CommandQueue_Confirm(&handleP->cmdQueue, cmdConfirmation.cmd, cmdConfirmation.status, pRxBuffer, cmd_length + LENGTH_CMD_OVERHEAD);
     }
 }
 
-/* function that waits for the return value of ProteusIII (*_CNF), when a command (*_REQ) was sent before */
-static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
+/* function to pass an indication to the callback thread, the RX thread does not wait for the callback */
+static void PostCallback(ProteusIII_Handle_t *handleP, uint8_t *pRxBuffer)
+{
+    if(!CallbackExecutor_Post(&handleP->callbackExecutor, ExecuteCallback, handleP, pRxBuffer))
+    {
+        fprintf(stdout, "Failed to queue callback, indication dropped\n");
+    }
+}
+
+/* function executed by the callback thread for each indication passed by PostCallback,
+ * callbacks may send commands, their confirmations are received by the RX thread meanwhile */
+static void ExecuteCallback(void *contextP, uint8_t *pRxBuffer)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
-    int i = 0;
+    ProteusIII_Handle_t *handleP = contextP;
 
-    if(reset_confirmstate)
+    /* callbacks can ask which instance they belong to */
+    callbackHandleP = handleP;
+
+    switch (pRxBuffer[CMD_POSITION_CMD])
     {
-        for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-        {
-            cmdConfirmation_array[i].cmd = CNFINVALID;
-        }
+    case ProteusIII_CMD_CHANNELOPEN_RSP:
+    {
+        /* Payload of CHANNELOPEN_RSP: Status (1 byte), BTMACH (6 byte), Max Payload (1byte)*/
+        handleP->callbacks.channelOpenCb(&pRxBuffer[CMD_POSITION_DATA+1], (uint16_t)pRxBuffer[CMD_POSITION_DATA + 7]);
+        break;
+    }
+
+    case ProteusIII_CMD_CONNECT_IND:
+    {
+        handleP->callbacks.connectCp(&pRxBuffer[CMD_POSITION_DATA+1]);
+        break;
     }
-    while (1)
+
+    case ProteusIII_CMD_DISCONNECT_IND:
     {
-        for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+        pthread_mutex_lock(&handleP->messageMutex);
+        bool fragmenterReady = handleP->fragmenterReady;
+        pthread_mutex_unlock(&handleP->messageMutex);
+        if(fragmenterReady)
         {
-            if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
-            {
-                return (cmdConfirmation_array[i].status == expectedStatus);
-            }
+            /* the rest of the message being reassembled will not arrive anymore */
+            Fragmenter_Reset(&handleP->fragmenter);
         }
-
-        if (count >= max_count)
+        if(handleP->callbacks.disconnectCb != NULL)
         {
-            /* received no correct response within timeout */
-            return false;
+            handleP->callbacks.disconnectCb();
         }
-
-        /* wait */
-        count++;
-        delay(time_step_ms);
+        break;
     }
-    return true;
-}
 
-/* function to add the checksum at the end of the data packet */
-static bool
-FillChecksum(uint8_t* pArray, uint16_t length)
-{
-    bool ret = false;
-
-    if ((length >= LENGTH_CMD_OVERHEAD) && (pArray[0] == CMD_STX))
+    case ProteusIII_CMD_DATA_IND:
     {
-        uint8_t checksum = (uint8_t)0;
-        uint16_t payload_length = (uint16_t) (pArray[CMD_POSITION_LENGTH_MSB] << 8) + pArray[CMD_POSITION_LENGTH_LSB];
-        uint16_t i = 0;
-        for (i = 0;
-                i < (payload_length + LENGTH_CMD_OVERHEAD_WITHOUT_CRC);
-                i++)
+        uint16_t payload_length = ((((uint16_t) pRxBuffer[CMD_POSITION_LENGTH_LSB] << 0) | ((uint16_t) pRxBuffer[CMD_POSITION_LENGTH_MSB] << 8))) - 7;
+        if(MessagesEnabled(handleP))
         {
-            checksum ^= pArray[i];
+            /* segment of a message, see ProteusIII_SetMessageCallbackEx */
+            Fragmenter_Receive(&handleP->fragmenter, &pRxBuffer[CMD_POSITION_DATA + 7], payload_length);
         }
-        pArray[payload_length + LENGTH_CMD_OVERHEAD_WITHOUT_CRC] = checksum;
-        ret = true;
+        else if(handleP->rxBufferCb != NULL)
+        {
+            handleP->rxBufferCb(FrameBuffer_Of(pRxBuffer), &pRxBuffer[CMD_POSITION_DATA + 7], payload_length, &pRxBuffer[CMD_POSITION_DATA], pRxBuffer[CMD_POSITION_DATA + 6]);
+        }
+        else if(handleP->callbacks.rxCb != NULL)
+        {
+            handleP->callbacks.rxCb(&pRxBuffer[CMD_POSITION_DATA + 7], payload_length, &pRxBuffer[CMD_POSITION_DATA], pRxBuffer[CMD_POSITION_DATA + 6]);
+        }
+        break;
     }
-    return ret;
-}
-
-
-/**************************************
- *         Global functions           *
- **************************************/
 
-/*
- *Initialize the ProteusIII interface for serial interface
- *
- *input:
- * -baudrate:       baudrate of the interface
- * -rp:             Reset Pin
- * -wp:             Wake-up Pin
- * -bp:             Boot Pin
- * -callbackConfig  Function pointers for callbacks
- *
- *Caution: the parameter baudrate must match the configured UserSettings of the ProteusIII
- *         -the baudrate parameter must match to perform a successful FTDI communication
- *          *updating this parameter during runtime may lead to communication errors
- *
- *return true if initialization succeeded
- *       false otherwise
- */
-bool ProteusIII_Init(int baudrate, int rp, int wp, int bp, ProteusIII_CallbackConfig_t callbackConfig)
-{
-    if (false == InitSerial())
+    case ProteusIII_CMD_SECURITY_IND:
     {
-        /* error */
-        return false ;
+        handleP->callbacks.securityCb(&pRxBuffer[CMD_POSITION_DATA+1],pRxBuffer[CMD_POSITION_DATA]);
+        break;
     }
 
-    if (false == OpenSerial(baudrate))
+    case ProteusIII_CMD_PASSKEY_IND:
     {
-        /* error */
-        return false ;
+        handleP->callbacks.passkeyCb(&pRxBuffer[CMD_POSITION_DATA+1]);
+        break;
     }
 
-    /* initialize the boot pin */
-    if (false == InitPin(bp))
+    case ProteusIII_CMD_DISPLAY_PASSKEY_IND:
     {
-        /* error */
-        return false ;
+        handleP->callbacks.displayPasskeyCb((ProteusIII_DisplayPasskeyAction_t)pRxBuffer[CMD_POSITION_DATA],&pRxBuffer[CMD_POSITION_DATA+1],&pRxBuffer[CMD_POSITION_DATA+7]);
+        break;
     }
-    boot_pin = bp;
-    SetPin(boot_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
 
-    /* initialize the wakeup pin */
-    if (false == InitPin(wp))
+    case ProteusIII_CMD_PHYUPDATE_IND:
     {
-        /* error */
-        return false ;
+        handleP->callbacks.phyUpdateCb(&pRxBuffer[CMD_POSITION_DATA+3],(ProteusIII_Phy_t)pRxBuffer[CMD_POSITION_DATA+1],(ProteusIII_Phy_t)pRxBuffer[CMD_POSITION_DATA+2]);
+        break;
     }
-    wakeup_pin = wp;
-    SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
 
-    /* initialize the reset pin,
-     * we have to define it as input/pull-up such that the reset button
-     * can pull the pin level down if the button is pressed
-     */
-    if (false == InitPin(rp))
+    case ProteusIII_CMD_GPIO_LOCAL_WRITE_IND:
     {
-        /* error */
-        return false ;
+        GPIOCache_Report(handleP, false, pRxBuffer);
+        break;
     }
-    reset_pin = rp;
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
 
-    /* empty the UART buffers */
-    FlushSerial();
+    case ProteusIII_CMD_GPIO_REMOTE_WRITE_IND:
+    {
+        GPIOCache_Report(handleP, true, pRxBuffer);
+        break;
+    }
 
-    /* init the driver and module*/
-    return InitDriver(callbackConfig);
+    default:
+    {
+        break;
+    }
+    }
 }
 
-/*
- *Deinitialize the ProteusIII interface
- *
- *return true if deinitialization succeeded
- *       false otherwise
- */
-bool ProteusIII_Deinit()
+/* function that waits for the return value of ProteusIII (*_CNF), when a command (*_REQ) was sent before */
+static bool Wait4CNF(ProteusIII_Handle_t *handleP, CommandQueue_Request_t *requestP, int max_time_ms, CMD_Status_t expectedStatus)
 {
-    /* close the communication interface to the module */
-    CloseSerial();
-    DeinitSerial();
-
-    /* abort RX thread */
-    AbortUartRxThread = true;
+    return CommandQueue_Wait(&handleP->cmdQueue, requestP, max_time_ms) && (requestP->status == expectedStatus);
+}
 
-    /* deinit pins */
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
-    DeinitPin(reset_pin);
-    SetPin(wakeup_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
-    DeinitPin(wakeup_pin);
-    SetPin(boot_pin, SetPin_InputOutput_Input, SetPin_Pull_Down, SetPin_Out_High);
-    DeinitPin(boot_pin);
-
-    /* reset callbacks */
-    callbacks.rxCb = NULL;
-    callbacks.connectCp = NULL;
-    callbacks.securityCb = NULL;
-    callbacks.passkeyCb = NULL;
-    callbacks.disconnectCb = NULL;
-    callbacks.channelOpenCb = NULL;
-    callbacks.phyUpdateCb = NULL;
+/* function to send a command with its payload in place, i.e. without copying the payload
+ * behind the header first; the length field of the header has to be filled already */
+static bool
+SendCommand(ProteusIII_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length, CommandQueue_Request_t *requestP)
+{
+    uint8_t checksum = FrameCodec_Checksum(FrameCodec_Checksum(0, header, header_length), payload, payload_length);
 
-    return true;
+    struct iovec frame[3] =
+    {
+        { .iov_base = header,    .iov_len = header_length },
+        { .iov_base = payload,   .iov_len = payload_length },
+        { .iov_base = &checksum, .iov_len = 1 },
+    };
+    return CommandQueue_Submit(&handleP->cmdQueue, requestP, handleP->transportP, frame, 3, CMD_WAIT_TIME);
 }
 
-/*
- *Wakeup the ProteusIII from sleep by pin
- *
- *return true if wakeup succeeded
- *       false otherwise
- */
-bool ProteusIII_PinWakeup()
+/* function to take a TX frame of the instance, the request is written into it in place, so that
+ * several threads can build their requests at the same time; give it back by SubmitFrame */
+static uint8_t *
+ReserveFrame(ProteusIII_Handle_t *handleP)
 {
-    int i = 0;
-
-    SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
-    delay (5);
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+    FrameBuffer_t *bufferP = FramePool_Get(handleP->txPoolP);
+    if(bufferP == NULL)
     {
-        cmdConfirmation_array[i].status = CMD_Status_Invalid;
-        cmdConfirmation_array[i].cmd = CNFINVALID;
+        fprintf(stdout, "No TX frame available\n");
+        return NULL;
     }
-    SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
-
-    /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, false);
+    return bufferP->data;
 }
 
-/*
- *Reset the ProteusIII by pin
- *
- *return true if reset succeeded
- *       false otherwise
- */
-bool ProteusIII_PinReset()
+/* function to add the checksum to a frame taken by ReserveFrame and send it as the request
+ * waiting for requestP, the frame is given back to the pool in any case */
+static bool
+SubmitFrame(ProteusIII_Handle_t *handleP, uint8_t *frameP, CommandQueue_Request_t *requestP)
 {
-    /* set to output mode */
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
-    delay (5);
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
-    FlushSerial();
-    ResetUartRxThread = true;
-    delay (5);
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
-
-    /* set to input mode again */
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
+    struct iovec frame =
+    {
+        .iov_base = frameP,
+        .iov_len = LENGTH_CMD_OVERHEAD + (((uint16_t)frameP[CMD_POSITION_LENGTH_MSB] << 8) | frameP[CMD_POSITION_LENGTH_LSB])
+    };
+    bool ret = FrameCodec_FillChecksum(&frameProtocol, frameP, MAX_CMD_LENGTH) &&
+               CommandQueue_Submit(&handleP->cmdQueue, requestP, handleP->transportP, &frame, 1, CMD_WAIT_TIME);
 
-    /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
+    FrameBuffer_Release(FrameBuffer_Of(frameP));
+    return ret;
 }
 
-/*
- *Reset the ProteusIII by command
- *
- *return true if reset succeeded
- *       false otherwise
- */
-bool ProteusIII_Reset()
+/* function called by the dispatcher of the command queue when an asynchronous command was answered or timed out */
+static void
+AsyncCommandDone(CommandQueue_Request_t *requestP, bool answered)
 {
-    bool ret = false;
-
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_RESET_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    AsyncCommand_t *commandP = requestP->contextP;
+    uint8_t *responseP = requestP->responseP;
+    bool success = answered && (requestP->status == commandP->expectedStatus);
+    uint16_t length = 0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if(success)
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        return Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
+        length = ((uint16_t)responseP[CMD_POSITION_LENGTH_MSB] << 8) | responseP[CMD_POSITION_LENGTH_LSB];
+        length = (length > commandP->dataOffset) ? (length - commandP->dataOffset) : 0;
     }
-    return ret;
+    commandP->callback(success, &responseP[CMD_POSITION_DATA + commandP->dataOffset], length, commandP->contextP);
 }
 
-/*
- *Disconnect the ProteusIII connection if open
- *
+/* function to send a command like SendCommand, but to return without waiting for its answer;
+ * the frame is copied and the answer is passed to cb from DATA[dataOffset] on */
+static bool
+SendCommandAsync(ProteusIII_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length,
+                 uint8_t confirmation, CMD_Status_t expectedStatus, uint16_t dataOffset, ProteusIII_CommandCallback cb, void* contextP)
+{
+    uint8_t checksum = FrameCodec_Checksum(FrameCodec_Checksum(0, header, header_length), payload, payload_length);
+
+    struct iovec frame[3] =
+    {
+        { .iov_base = header,    .iov_len = header_length },
+        { .iov_base = payload,   .iov_len = payload_length },
+        { .iov_base = &checksum, .iov_len = 1 },
+    };
+
+    if(cb == NULL)
+    {
+        return false;
+    }
+
+    CommandQueue_Request_t *requestP = CommandQueue_NewRequest(confirmation, frame, 3, MAX_CMD_LENGTH, sizeof(AsyncCommand_t));
+    if(requestP == NULL)
+    {
+        return false;
+    }
+    if(confirmation == ProteusIII_CMD_TXCOMPLETE_RSP)
+    {
+        /* answered once the data was sent over the air */
+        CommandQueue_SetFixedTimeout(requestP);
+    }
+    AsyncCommand_t *commandP = requestP->contextP;
+    commandP->callback = cb;
+    commandP->contextP = contextP;
+    commandP->expectedStatus = expectedStatus;
+    commandP->dataOffset = dataOffset;
+
+    return CommandQueue_SubmitAsync(&handleP->cmdQueue, requestP, handleP->transportP, CMD_WAIT_TIME, AsyncCommandDone);
+}
+
+/* function to give 'count' credits of the stream back and to wake up the producer waiting for them */
+static void
+StreamRelease(ProteusIII_Handle_t *handleP, uint16_t count, bool success)
+{
+    pthread_mutex_lock(&handleP->streamMutex);
+    if(count > handleP->streamInFlight)
+    {
+        count = handleP->streamInFlight;
+    }
+    handleP->streamInFlight -= count;
+    if(!success)
+    {
+        handleP->streamFailed += count;
+    }
+    pthread_cond_broadcast(&handleP->streamCond);
+    pthread_mutex_unlock(&handleP->streamMutex);
+}
+
+/* function to check whether packets of the stream are in flight, their TXCOMPLETE_RSP
+ * cannot be told apart from the one of ProteusIII_TransmitEx */
+static bool
+StreamBusy(ProteusIII_Handle_t *handleP)
+{
+    pthread_mutex_lock(&handleP->streamMutex);
+    bool busy = (handleP->streamInFlight > 0);
+    pthread_mutex_unlock(&handleP->streamMutex);
+    return busy;
+}
+
+/* function called by the dispatcher of the command queue when the module accepted or rejected
+ * a packet of the stream (DATA_CNF), or its DATA_CNF timed out; an accepted packet keeps its
+ * credit until its TXCOMPLETE_RSP, see HandleRxPacket; a packet without DATA_CNF keeps it as
+ * well, its TXCOMPLETE_RSP may still come, otherwise ProteusIII_StreamFlushEx counts it as lost */
+static void
+StreamPacketDone(CommandQueue_Request_t *requestP, bool answered)
+{
+    ProteusIII_Handle_t *handleP = *(ProteusIII_Handle_t**)requestP->contextP;
+
+    if(answered && (requestP->status != CMD_Status_Success))
+    {
+        StreamRelease(handleP, 1, false);
+    }
+}
+
+/* function to check whether the DATA_IND are passed to the fragmenter, see ProteusIII_SetMessageCallbackEx */
+static bool
+MessagesEnabled(ProteusIII_Handle_t *handleP)
+{
+    pthread_mutex_lock(&handleP->messageMutex);
+    bool enabled = (handleP->messageCb != NULL);
+    pthread_mutex_unlock(&handleP->messageMutex);
+    return enabled;
+}
+
+/* function called by the fragmenter to send a segment of a message as packet of the stream */
+static bool
+SendSegment(void *contextP, uint8_t *payloadP, uint16_t length)
+{
+    return ProteusIII_StreamTransmitEx((ProteusIII_Handle_t*)contextP, payloadP, length);
+}
+
+/* function called by the fragmenter in the callback thread with a reassembled message */
+static void
+MessageReceived(uint8_t *messageP, uint32_t length, void *contextP)
+{
+    ProteusIII_Handle_t *handleP = (ProteusIII_Handle_t*)contextP;
+
+    pthread_mutex_lock(&handleP->messageMutex);
+    ProteusIII_MessageCallback messageCb = handleP->messageCb;
+    void *messageContextP = handleP->messageContextP;
+    pthread_mutex_unlock(&handleP->messageMutex);
+    if(messageCb != NULL)
+    {
+        messageCb(messageP, length, messageContextP);
+    }
+}
+
+/* function to read the number of devices listed in a GETDEVICES_CNF */
+static uint8_t
+DeviceCount(const uint8_t *frameP)
+{
+    uint16_t length = ((uint16_t)frameP[CMD_POSITION_LENGTH_MSB] << 8) | frameP[CMD_POSITION_LENGTH_LSB];
+    return (length >= 2) ? frameP[CMD_POSITION_DATA + 1] : 0;
+}
+
+/* function to read the device at *positionP of a GETDEVICES_CNF and to move *positionP
+ * to the next one, returns false if the entry exceeds the frame */
+static bool
+ParseDevice(const uint8_t *frameP, uint16_t *positionP, ProteusIII_Device_t *deviceP)
+{
+    uint16_t end = CMD_POSITION_DATA + (((uint16_t)frameP[CMD_POSITION_LENGTH_MSB] << 8) | frameP[CMD_POSITION_LENGTH_LSB]);
+    uint16_t position = *positionP;
+
+    /* BTMAC, RSSI, TX power, name length and name */
+    if ((position + 9 > end) || (frameP[position + 8] > sizeof(deviceP->devicename)) ||
+        (position + 9 + frameP[position + 8] > end))
+    {
+        return false;
+    }
+    memcpy(&deviceP->btmac[0], &frameP[position], 6);
+    deviceP->rssi = (int8_t)frameP[position + 6];
+    deviceP->txpower = (int8_t)frameP[position + 7];
+    deviceP->devicenamelength = frameP[position + 8];
+    memcpy(&deviceP->devicename[0], &frameP[position + 9], deviceP->devicenamelength);
+    *positionP = position + 9 + deviceP->devicenamelength;
+    return true;
+}
+
+/* function to read CLOCK_MONOTONIC in ms */
+static uint64_t
+ScanIndex_Now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)(now.tv_nsec / 1000000);
+}
+
+/* function to get the home slot of a BTMAC (FNV-1a), the capacity is a power of two */
+static uint32_t
+ScanIndex_Hash(const uint8_t *btmacP, uint32_t capacity)
+{
+    uint32_t hash = 2166136261u;
+    int i;
+
+    for(i = 0; i < 6; i++)
+    {
+        hash = (hash ^ btmacP[i]) * 16777619u;
+    }
+    return hash & (capacity - 1);
+}
+
+/* function to look up the slot of a device, SCANINDEX_NO_SLOT if it is not indexed;
+ * the scan mutex has to be held */
+static uint32_t
+ScanIndex_Find(ProteusIII_Handle_t *handleP, const uint8_t *btmacP)
+{
+    uint32_t slot;
+
+    if (handleP->scanTableP == NULL)
+    {
+        return SCANINDEX_NO_SLOT;
+    }
+
+    /* linear probing, at least one slot is always free */
+    for (slot = ScanIndex_Hash(btmacP, handleP->scanCapacity); handleP->scanTableP[slot].used; slot = (slot + 1) & (handleP->scanCapacity - 1))
+    {
+        if (0 == memcmp(handleP->scanTableP[slot].device.btmac, btmacP, 6))
+        {
+            return slot;
+        }
+    }
+    return SCANINDEX_NO_SLOT;
+}
+
+/* function to double the slots of the scan index, or to create it;
+ * the scan mutex has to be held */
+static bool
+ScanIndex_Grow(ProteusIII_Handle_t *handleP)
+{
+    uint32_t capacity = (handleP->scanTableP == NULL) ? SCANINDEX_MIN_CAPACITY : 2 * handleP->scanCapacity;
+    ScanEntry_t *tableP;
+    uint32_t i;
+
+    if (capacity > SCANINDEX_MAX_CAPACITY)
+    {
+        return false;
+    }
+    tableP = calloc(capacity, sizeof(ScanEntry_t));
+    if (tableP == NULL)
+    {
+        return false;
+    }
+    for (i = 0; i < handleP->scanCapacity; i++)
+    {
+        if (handleP->scanTableP[i].used)
+        {
+            uint32_t slot = ScanIndex_Hash(handleP->scanTableP[i].device.btmac, capacity);
+            while (tableP[slot].used)
+            {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            tableP[slot] = handleP->scanTableP[i];
+        }
+    }
+    free(handleP->scanTableP);
+    handleP->scanTableP = tableP;
+    handleP->scanCapacity = capacity;
+    return true;
+}
+
+/* function to get the slot of a device, a new device gets a cleared slot;
+ * returns NULL if the index is full; the scan mutex has to be held */
+static ScanEntry_t *
+ScanIndex_Insert(ProteusIII_Handle_t *handleP, const uint8_t *btmacP)
+{
+    uint32_t slot = ScanIndex_Find(handleP, btmacP);
+
+    if (slot != SCANINDEX_NO_SLOT)
+    {
+        return &handleP->scanTableP[slot];
+    }
+
+    /* keep the load below 3/4, so that the probe sequences stay short */
+    if (4 * (handleP->scanCount + 1) > 3 * handleP->scanCapacity)
+    {
+        if (!ScanIndex_Grow(handleP) && (handleP->scanCount + 1 >= handleP->scanCapacity))
+        {
+            return NULL;
+        }
+    }
+
+    slot = ScanIndex_Hash(btmacP, handleP->scanCapacity);
+    while (handleP->scanTableP[slot].used)
+    {
+        slot = (slot + 1) & (handleP->scanCapacity - 1);
+    }
+    memset(&handleP->scanTableP[slot], 0, sizeof(ScanEntry_t));
+    memcpy(handleP->scanTableP[slot].device.btmac, btmacP, 6);
+    handleP->scanTableP[slot].used = true;
+    handleP->scanCount++;
+    return &handleP->scanTableP[slot];
+}
+
+/* function to remove the device in a slot; the devices behind it in the same probe
+ * sequence are moved forward instead of leaving a marker, so that lookups never
+ * probe removed slots; a device behind the slot may be moved into it;
+ * the scan mutex has to be held */
+static void
+ScanIndex_Remove(ProteusIII_Handle_t *handleP, uint32_t slot)
+{
+    uint32_t mask = handleP->scanCapacity - 1;
+    uint32_t next = slot;
+
+    handleP->scanTableP[slot].used = false;
+    handleP->scanCount--;
+    for (;;)
+    {
+        next = (next + 1) & mask;
+        if (!handleP->scanTableP[next].used)
+        {
+            return;
+        }
+
+        /* the device in 'next' may stay if its home slot lies cyclically in (slot, next] */
+        uint32_t home = ScanIndex_Hash(handleP->scanTableP[next].device.btmac, handleP->scanCapacity);
+        if ((slot <= next) ? ((slot < home) && (home <= next)) : ((slot < home) || (home <= next)))
+        {
+            continue;
+        }
+        handleP->scanTableP[slot] = handleP->scanTableP[next];
+        handleP->scanTableP[next].used = false;
+        slot = next;
+    }
+}
+
+/* function to copy a device of the scan index for the application */
+static void
+ScanIndex_Copy(const ScanEntry_t *entryP, uint64_t now_ms, ProteusIII_ScanDevice_t *deviceP)
+{
+    *deviceP = entryP->device;
+    deviceP->age_ms = (now_ms > entryP->lastSeen_ms) ? (uint32_t)(now_ms - entryP->lastSeen_ms) : 0;
+}
+
+/* function to add the devices of a GETDEVICES_CNF to the scan index, called by the RX thread */
+static void
+ScanIndex_Ingest(ProteusIII_Handle_t *handleP, const uint8_t *frameP)
+{
+    uint8_t count = DeviceCount(frameP);
+    uint16_t position = CMD_POSITION_DATA + 2;
+    uint64_t now = ScanIndex_Now();
+    ProteusIII_Device_t device;
+    uint8_t i;
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    for (i = 0; (handleP->scanTableP != NULL) && (i < count) && ParseDevice(frameP, &position, &device); i++)
+    {
+        ScanEntry_t *entryP = ScanIndex_Insert(handleP, device.btmac);
+        if (entryP == NULL)
+        {
+            /* index full, new devices are dropped until old ones aged out */
+            continue;
+        }
+
+        if (entryP->device.results == 0)
+        {
+            entryP->rssiAverage = (int16_t)device.rssi * 16;
+        }
+        else
+        {
+            entryP->rssiAverage += ((int16_t)device.rssi * 16 - entryP->rssiAverage) / SCANINDEX_RSSI_WEIGHT;
+        }
+        entryP->device.rssi = device.rssi;
+        entryP->device.rssiAverage = (int8_t)((entryP->rssiAverage + ((entryP->rssiAverage < 0) ? -8 : 8)) / 16);
+        entryP->device.txpower = device.txpower;
+        if (device.devicenamelength > 0)
+        {
+            /* advertising packets without name keep the last known one */
+            entryP->device.devicenamelength = device.devicenamelength;
+            memcpy(entryP->device.devicename, device.devicename, device.devicenamelength);
+        }
+        entryP->device.results++;
+        entryP->lastSeen_ms = now;
+    }
+    pthread_mutex_unlock(&handleP->scanMutex);
+}
+
+/* function to restore the order of the min-heap of the strongest devices below 'i' */
+static void
+ScanIndex_SiftDown(ProteusIII_ScanDevice_t *heapP, uint32_t count, uint32_t i)
+{
+    for (;;)
+    {
+        uint32_t weakest = i;
+        uint32_t child = 2 * i + 1;
+
+        if ((child < count) && (heapP[child].rssiAverage < heapP[weakest].rssiAverage))
+        {
+            weakest = child;
+        }
+        if ((child + 1 < count) && (heapP[child + 1].rssiAverage < heapP[weakest].rssiAverage))
+        {
+            weakest = child + 1;
+        }
+        if (weakest == i)
+        {
+            return;
+        }
+        ProteusIII_ScanDevice_t device = heapP[i];
+        heapP[i] = heapP[weakest];
+        heapP[weakest] = device;
+        i = weakest;
+    }
+}
+
+/* thread function to poll the scan results of the module, they are added to the
+ * scan index by the RX thread when the GETDEVICES_CNF arrives */
+static void *scan_thread(void *argP)
+{
+    ProteusIII_Handle_t *handleP = argP;
+    struct timespec deadline;
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    while (!handleP->scanStop)
+    {
+        pthread_mutex_unlock(&handleP->scanMutex);
+        ProteusIII_GetDevicesEx(handleP, NULL);
+        if (handleP->scanMaxAge_ms > 0)
+        {
+            ProteusIII_ScanAgeOutEx(handleP, handleP->scanMaxAge_ms);
+        }
+
+        GetDeadline(&deadline, handleP->scanInterval_ms);
+        pthread_mutex_lock(&handleP->scanMutex);
+        while (!handleP->scanStop &&
+               (pthread_cond_timedwait(&handleP->scanCond, &handleP->scanMutex, &deadline) != ETIMEDOUT))
+        {
+        }
+    }
+    pthread_mutex_unlock(&handleP->scanMutex);
+    return 0;
+}
+
+/* function to read the block at *positionP of GPIO control or configuration blocks and to
+ * move *positionP to the next one, returns false if the block exceeds the blocks */
+static bool
+ParseGPIOBlock(const uint8_t *blocksP, uint16_t length, uint16_t *positionP, uint8_t *GPIO_IDP, uint8_t *valueP)
+{
+    uint16_t position = *positionP;
+
+    /* length of the block, GPIO_ID and value */
+    if ((position + 1 > length) || (blocksP[position] < 2) || (position + 1 + blocksP[position] > length))
+    {
+        return false;
+    }
+    *GPIO_IDP = blocksP[position + 1];
+    *valueP = blocksP[position + 2];
+    *positionP = position + 1 + blocksP[position];
+    return true;
+}
+
+/* function to get the cache entry of a pin, NULL for an unknown GPIO_ID */
+static GPIOCacheEntry_t *
+GPIOCache_Entry(ProteusIII_Handle_t *handleP, bool remote, uint8_t GPIO_ID)
+{
+    if ((GPIO_ID < ProteusIII_GPIO_1) || (GPIO_ID > ProteusIII_AMOUNT_GPIO_PINS))
+    {
+        return NULL;
+    }
+    return &handleP->gpioCache[remote ? 1 : 0][GPIO_ID - 1];
+}
+
+/* function to get the generation of the GPIO cache before a request is sent, see GPIOCache_Store */
+static uint32_t
+GPIOCache_Generation(ProteusIII_Handle_t *handleP)
+{
+    pthread_mutex_lock(&handleP->gpioMutex);
+    uint32_t generation = handleP->gpioGeneration;
+    pthread_mutex_unlock(&handleP->gpioMutex);
+    return generation;
+}
+
+/* function to store the pins of control blocks read or written by the application, generation
+ * is the generation of the cache when the request was sent; pins updated meanwhile by an
+ * indication, write or invalidation keep their newer state */
+static void
+GPIOCache_Store(ProteusIII_Handle_t *handleP, bool remote, const uint8_t *blocksP, uint16_t length, uint32_t generation, bool written)
+{
+    uint64_t now = ScanIndex_Now();
+    uint16_t position = 0;
+    uint8_t GPIO_ID, value;
+
+    pthread_mutex_lock(&handleP->gpioMutex);
+    if (written)
+    {
+        /* a read sent before the write must not restore the old value */
+        handleP->gpioGeneration++;
+    }
+    while (ParseGPIOBlock(blocksP, length, &position, &GPIO_ID, &value))
+    {
+        GPIOCacheEntry_t *entryP = GPIOCache_Entry(handleP, remote, GPIO_ID);
+        if ((entryP == NULL) || ((int32_t)(entryP->generation - generation) > 0))
+        {
+            continue;
+        }
+        entryP->value = value;
+        entryP->valid = true;
+        entryP->updated_ms = now;
+        entryP->reported = value;
+        entryP->known = true;
+        if (written)
+        {
+            entryP->generation = handleP->gpioGeneration;
+        }
+    }
+    pthread_mutex_unlock(&handleP->gpioMutex);
+}
+
+/* function to store the pins of a GPIO write indication, executed by the RX thread;
+ * returns true if the indication has to be passed to the GPIO change callback */
+static bool
+GPIOCache_Indicate(ProteusIII_Handle_t *handleP, bool remote, const uint8_t *frameP)
+{
+    uint16_t length = ((uint16_t)frameP[CMD_POSITION_LENGTH_MSB] << 8) | frameP[CMD_POSITION_LENGTH_LSB];
+    uint64_t now = ScanIndex_Now();
+    uint16_t position = 0;
+    uint8_t GPIO_ID, value;
+
+    pthread_mutex_lock(&handleP->gpioMutex);
+    handleP->gpioGeneration++;
+    while (ParseGPIOBlock(&frameP[CMD_POSITION_DATA], length, &position, &GPIO_ID, &value))
+    {
+        GPIOCacheEntry_t *entryP = GPIOCache_Entry(handleP, remote, GPIO_ID);
+        if (entryP != NULL)
+        {
+            entryP->value = value;
+            entryP->valid = true;
+            entryP->updated_ms = now;
+            entryP->generation = handleP->gpioGeneration;
+        }
+    }
+    bool subscribed = (handleP->gpioChangeCb != NULL);
+    pthread_mutex_unlock(&handleP->gpioMutex);
+    return subscribed;
+}
+
+/* function to call the GPIO change callback for the pins of an indication whose value differs
+ * from the value last known to the application, i.e. last reported, read or written by it;
+ * executed by the callback thread, so that the callback may read the pins itself */
+static void
+GPIOCache_Report(ProteusIII_Handle_t *handleP, bool remote, const uint8_t *frameP)
+{
+    uint16_t length = ((uint16_t)frameP[CMD_POSITION_LENGTH_MSB] << 8) | frameP[CMD_POSITION_LENGTH_LSB];
+    int16_t changed[ProteusIII_AMOUNT_GPIO_PINS];
+    uint16_t position = 0;
+    uint8_t GPIO_ID, value;
+    int i;
+
+    for (i = 0; i < ProteusIII_AMOUNT_GPIO_PINS; i++)
+    {
+        changed[i] = -1;
+    }
+
+    pthread_mutex_lock(&handleP->gpioMutex);
+    ProteusIII_GPIOChangeCallback cb = handleP->gpioChangeCb;
+    void *contextP = handleP->gpioChangeContextP;
+    while (ParseGPIOBlock(&frameP[CMD_POSITION_DATA], length, &position, &GPIO_ID, &value))
+    {
+        GPIOCacheEntry_t *entryP = GPIOCache_Entry(handleP, remote, GPIO_ID);
+        if ((entryP != NULL) && (!entryP->known || (entryP->reported != value)))
+        {
+            entryP->reported = value;
+            entryP->known = true;
+            changed[GPIO_ID - 1] = value;
+        }
+    }
+    pthread_mutex_unlock(&handleP->gpioMutex);
+
+    if (cb == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < ProteusIII_AMOUNT_GPIO_PINS; i++)
+    {
+        if (changed[i] >= 0)
+        {
+            cb(remote, (ProteusIII_GPIO_t)(i + 1), (uint8_t)changed[i], contextP);
+        }
+    }
+}
+
+/* function to forget the value of a pin, or of all local or remote pins if GPIO_ID is 0 */
+static void
+GPIOCache_Invalidate(ProteusIII_Handle_t *handleP, bool remote, uint8_t GPIO_ID)
+{
+    int i;
+
+    pthread_mutex_lock(&handleP->gpioMutex);
+    handleP->gpioGeneration++;
+    for (i = 0; i < ProteusIII_AMOUNT_GPIO_PINS; i++)
+    {
+        if ((GPIO_ID == 0) || (GPIO_ID == i + 1))
+        {
+            GPIOCacheEntry_t *entryP = &handleP->gpioCache[remote ? 1 : 0][i];
+            entryP->valid = false;
+            entryP->known = false;
+            entryP->generation = handleP->gpioGeneration;
+        }
+    }
+    pthread_mutex_unlock(&handleP->gpioMutex);
+}
+
+/* function to request the values of local or remote pins from the module, response has
+ * to hold MAX_CMD_LENGTH bytes */
+static bool
+GPIORequest(ProteusIII_Handle_t *handleP, bool remote, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, uint8_t *response)
+{
+    bool ret = false;
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = remote ? ProteusIII_CMD_GPIO_REMOTE_READ_REQ : ProteusIII_CMD_GPIO_LOCAL_READ_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB]= amountGPIOToRead + 1;
+    frameP[CMD_POSITION_LENGTH_MSB]= 0;
+    frameP[CMD_POSITION_DATA] = amountGPIOToRead;
+    memcpy(&frameP[CMD_POSITION_DATA + 1], GPIOToReadP, amountGPIOToRead);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, remote ? ProteusIII_CMD_GPIO_REMOTE_READ_CNF : ProteusIII_CMD_GPIO_LOCAL_READ_CNF, response, MAX_CMD_LENGTH);
+    if(remote)
+    {
+        /* answered by the remote device over the air */
+        CommandQueue_SetFixedTimeout(&request);
+    }
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
+
+    return ret;
+}
+
+/* function to read local or remote pins, pins cached for less than gpioMaxAge_ms are taken
+ * from the cache and only the others are requested from the module */
+static bool
+GPIORead(ProteusIII_Handle_t *handleP, bool remote, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP)
+{
+    uint8_t values[UINT8_MAX];
+    bool cached[UINT8_MAX];
+    uint8_t stale[UINT8_MAX];
+    uint8_t staleCount = 0;
+    uint64_t now = ScanIndex_Now();
+    int i;
+
+    pthread_mutex_lock(&handleP->gpioMutex);
+    uint32_t generation = handleP->gpioGeneration;
+    for (i = 0; i < amountGPIOToRead; i++)
+    {
+        GPIOCacheEntry_t *entryP = GPIOCache_Entry(handleP, remote, GPIOToReadP[i]);
+        cached[i] = (entryP != NULL) && entryP->valid && (now - entryP->updated_ms < handleP->gpioMaxAge_ms);
+        if (cached[i])
+        {
+            values[i] = entryP->value;
+            /* the application knows the value now */
+            entryP->reported = entryP->value;
+            entryP->known = true;
+        }
+        else
+        {
+            stale[staleCount++] = GPIOToReadP[i];
+        }
+    }
+    pthread_mutex_unlock(&handleP->gpioMutex);
+
+    if (staleCount > 0)
+    {
+        uint8_t response[MAX_CMD_LENGTH];
+        if (!GPIORequest(handleP, remote, stale, staleCount, response))
+        {
+            return false;
+        }
+
+        /* control blocks follow the status byte */
+        uint16_t length = ((uint16_t)response[CMD_POSITION_LENGTH_MSB] << 8) | response[CMD_POSITION_LENGTH_LSB];
+        length = (length > 0) ? length - 1 : 0;
+        GPIOCache_Store(handleP, remote, &response[CMD_POSITION_DATA + 1], length, generation, false);
+
+        if (staleCount == amountGPIOToRead)
+        {
+            /* nothing taken from the cache, pass the answer on as it is */
+            *controlLengthP = length;
+            memcpy(controlP, &response[CMD_POSITION_DATA + 1], length);
+            return true;
+        }
+
+        for (i = 0; i < amountGPIOToRead; i++)
+        {
+            uint16_t position = 0;
+            uint8_t GPIO_ID, value;
+
+            while (!cached[i] && ParseGPIOBlock(&response[CMD_POSITION_DATA + 1], length, &position, &GPIO_ID, &value))
+            {
+                if (GPIO_ID == GPIOToReadP[i])
+                {
+                    values[i] = value;
+                    cached[i] = true;
+                }
+            }
+            if (!cached[i])
+            {
+                /* the module did not report the pin */
+                return false;
+            }
+        }
+    }
+
+    for (i = 0; i < amountGPIOToRead; i++)
+    {
+        controlP[i].length = 2;
+        controlP[i].GPIO_ID = GPIOToReadP[i];
+        controlP[i].value = values[i];
+    }
+    *controlLengthP = amountGPIOToRead * sizeof(ProteusIII_GPIOControlBlock_t);
+    return true;
+}
+
+/**************************************
+ *         Global functions           *
+ **************************************/
+
+/*
+ *Initialize the ProteusIII interface for serial interface
+ *
+ *input:
+ * -transportP:     interface to the module, see SerialTransport_Create and FTDITransport_Create
+ * -baudrate:       baudrate of the interface
+ * -rp:             Reset Pin
+ * -wp:             Wake-up Pin
+ * -bp:             Boot Pin
+ * -callbackConfig  Function pointers for callbacks
+ *
+ *Caution: the parameter baudrate must match the configured UserSettings of the ProteusIII
+ *         -the baudrate parameter must match to perform a successful FTDI communication
+ *          *updating this parameter during runtime may lead to communication errors
+ *
+ *return driver instance if initialization succeeded
+ *       NULL otherwise
+ */
+ProteusIII_Handle_t *ProteusIII_InitEx(Transport_t *transportP, int baudrate, int rp, int wp, int bp, ProteusIII_CallbackConfig_t callbackConfig)
+{
+    ProteusIII_Handle_t *handleP;
+
+    if(transportP == NULL)
+    {
+        return NULL;
+    }
+
+    handleP = calloc(1, sizeof(ProteusIII_Handle_t));
+    if(handleP == NULL)
+    {
+        return NULL;
+    }
+    handleP->transportP = transportP;
+    handleP->rxThreadEvent = -1;
+
+    if(!CommandQueue_Init(&handleP->cmdQueue, CMDQUEUE_DEPTH))
+    {
+        fprintf(stdout, "Failed to initialize command queue\n");
+        free(handleP);
+        return NULL;
+    }
+    if((pthread_mutex_init(&handleP->streamMutex, NULL) != 0) || !InitMonotonicCond(&handleP->streamCond))
+    {
+        fprintf(stdout, "Failed to initialize stream\n");
+        CommandQueue_Deinit(&handleP->cmdQueue);
+        free(handleP);
+        return NULL;
+    }
+    if((pthread_mutex_init(&handleP->scanMutex, NULL) != 0) || !InitMonotonicCond(&handleP->scanCond))
+    {
+        fprintf(stdout, "Failed to initialize scan index\n");
+        pthread_cond_destroy(&handleP->streamCond);
+        pthread_mutex_destroy(&handleP->streamMutex);
+        CommandQueue_Deinit(&handleP->cmdQueue);
+        free(handleP);
+        return NULL;
+    }
+    if(pthread_mutex_init(&handleP->gpioMutex, NULL) != 0)
+    {
+        fprintf(stdout, "Failed to initialize GPIO cache\n");
+        pthread_cond_destroy(&handleP->scanCond);
+        pthread_mutex_destroy(&handleP->scanMutex);
+        pthread_cond_destroy(&handleP->streamCond);
+        pthread_mutex_destroy(&handleP->streamMutex);
+        CommandQueue_Deinit(&handleP->cmdQueue);
+        free(handleP);
+        return NULL;
+    }
+    if(pthread_mutex_init(&handleP->messageMutex, NULL) != 0)
+    {
+        fprintf(stdout, "Failed to initialize messages\n");
+        pthread_mutex_destroy(&handleP->gpioMutex);
+        pthread_cond_destroy(&handleP->scanCond);
+        pthread_mutex_destroy(&handleP->scanMutex);
+        pthread_cond_destroy(&handleP->streamCond);
+        pthread_mutex_destroy(&handleP->streamMutex);
+        CommandQueue_Deinit(&handleP->cmdQueue);
+        free(handleP);
+        return NULL;
+    }
+    handleP->streamWindow = STREAM_WINDOW;
+
+    handleP->rxPoolP = FramePool_Create(RXPOOL_LENGTH, RXPOOL_MAX_ALLOCATED, MAX_CMD_LENGTH);
+    handleP->txPoolP = FramePool_Create(TXPOOL_LENGTH, TXPOOL_MAX_ALLOCATED, MAX_CMD_LENGTH);
+    if((handleP->rxPoolP == NULL) || (handleP->txPoolP == NULL) ||
+       (false == CallbackExecutor_Init(&handleP->callbackExecutor)) ||
+       (false == InitModule(handleP, baudrate, rp, wp, bp, callbackConfig)))
+    {
+        ProteusIII_DeinitEx(handleP);
+        return NULL;
+    }
+
+    return handleP;
+}
+
+/*
+ *Deinitialize the ProteusIII interface
+ *
+ *note: the transport is closed, but not destroyed
+ *
+ *input:
+ * -handleP: driver instance, freed by this function
+ *
+ *return true if deinitialization succeeded
+ *       false otherwise
+ */
+bool ProteusIII_DeinitEx(ProteusIII_Handle_t *handleP)
+{
+    if(handleP == NULL)
+    {
+        return false;
+    }
+
+    /* stop polling the scan results, while requests can still be answered */
+    pthread_mutex_lock(&handleP->scanMutex);
+    bool scanRunning = handleP->scanRunning;
+    handleP->scanStop = true;
+    pthread_cond_broadcast(&handleP->scanCond);
+    pthread_mutex_unlock(&handleP->scanMutex);
+    if(scanRunning)
+    {
+        pthread_join(handleP->thread_scan, NULL);
+    }
+
+    /* close the communication interface to the module */
+    Transport_Close(handleP->transportP);
+
+    /* abort RX thread */
+    if(handleP->rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(handleP->rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(handleP->thread_read, NULL);
+        RxThreadEvent_Destroy(handleP->rxThreadEvent);
+        handleP->rxThreadEvent = -1;
+    }
+
+    /* stop the callback thread, once the RX thread does not post anymore */
+    CallbackExecutor_Deinit(&handleP->callbackExecutor);
+
+    /* deinit pins */
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
+    Transport_DeinitPin(handleP->transportP, handleP->reset_pin);
+    Transport_SetPin(handleP->transportP, handleP->wakeup_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
+    Transport_DeinitPin(handleP->transportP, handleP->wakeup_pin);
+    Transport_SetPin(handleP->transportP, handleP->boot_pin, SetPin_InputOutput_Input, SetPin_Pull_Down, SetPin_Out_High);
+    Transport_DeinitPin(handleP->transportP, handleP->boot_pin);
+
+    /* frames still held by the application keep the pool alive */
+    FramePool_Destroy(handleP->rxPoolP);
+    FramePool_Destroy(handleP->txPoolP);
+
+    CommandQueue_Deinit(&handleP->cmdQueue);
+    pthread_cond_destroy(&handleP->streamCond);
+    pthread_mutex_destroy(&handleP->streamMutex);
+    free(handleP->scanTableP);
+    pthread_cond_destroy(&handleP->scanCond);
+    pthread_mutex_destroy(&handleP->scanMutex);
+    pthread_mutex_destroy(&handleP->gpioMutex);
+    if(handleP->fragmenterReady)
+    {
+        Fragmenter_Deinit(&handleP->fragmenter);
+    }
+    pthread_mutex_destroy(&handleP->messageMutex);
+    free(handleP);
+
+    return true;
+}
+
+/*
+ *Wakeup the ProteusIII from sleep by pin
+ *
+ *return true if wakeup succeeded
+ *       false otherwise
+ */
+bool ProteusIII_PinWakeupEx(ProteusIII_Handle_t *handleP)
+{
+    Transport_SetPin(handleP->transportP, handleP->wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
+    delay (5);
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GETSTATE_CNF, NULL, 0);
+    if(!CommandQueue_Submit(&handleP->cmdQueue, &request, handleP->transportP, NULL, 0, CMD_WAIT_TIME))
+    {
+        return false;
+    }
+    Transport_SetPin(handleP->transportP, handleP->wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+
+    /* wait for cnf */
+    return Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_NoStatus);
+}
+
+/*
+ *Reset the ProteusIII by pin
+ *
+ *return true if reset succeeded
+ *       false otherwise
+ */
+bool ProteusIII_PinResetEx(ProteusIII_Handle_t *handleP)
+{
+    /* the pins return to their defaults */
+    GPIOCache_Invalidate(handleP, false, 0);
+    GPIOCache_Invalidate(handleP, true, 0);
+
+    /* set to output mode */
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
+    delay (5);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+    Transport_Flush(handleP->transportP);
+    RxThreadEvent_Signal(handleP->rxThreadEvent, RXTHREAD_EVENT_RESET);
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GETSTATE_CNF, NULL, 0);
+    if(!CommandQueue_Submit(&handleP->cmdQueue, &request, handleP->transportP, NULL, 0, CMD_WAIT_TIME))
+    {
+        return false;
+    }
+    delay (5);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
+
+    /* set to input mode again */
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
+
+    /* wait for cnf */
+    return Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_NoStatus);
+}
+
+/*
+ *Reset the ProteusIII by command
+ *
+ *return true if reset succeeded
+ *       false otherwise
+ */
+bool ProteusIII_ResetEx(ProteusIII_Handle_t *handleP)
+{
+    bool ret = false;
+
+    /* the pins return to their defaults */
+    GPIOCache_Invalidate(handleP, false, 0);
+    GPIOCache_Invalidate(handleP, true, 0);
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_RESET_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GETSTATE_CNF, NULL, 0);
+    /* answered once the module restarted */
+    CommandQueue_SetFixedTimeout(&request);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        return Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_NoStatus);
+    }
+    return ret;
+}
+
+/*
+ *Disconnect the ProteusIII connection if open
+ *
  *return true if disconnection succeeded
  *       false otherwise
  */
 bool
-ProteusIII_Disconnect()
+ProteusIII_DisconnectEx(ProteusIII_Handle_t *handleP)
+{
+    bool ret = false;
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_DISCONNECT_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_DISCONNECT_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* Confirmation is sent before perfoming the disconnect. After disconnect, module sends dicsonnect indication */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
+    return ret;
+}
+
+/*
+ *Put the ProteusIII into sleep mode
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SleepEx(ProteusIII_Handle_t *handleP)
+{
+    bool ret = false;
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_SLEEP_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_SLEEP_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
+    return ret;
+}
+
+/*
+ *Transmit data if a connection is open
+ *
+ *input:
+ * -PayloadP: pointer to the data to transmit
+ * -length:   length of the data to transmit
+ *
+ *note: fails while packets of ProteusIII_StreamTransmitEx are in flight
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_TransmitEx(ProteusIII_Handle_t *handleP, uint8_t *PayloadP, uint16_t length)
+{
+    bool ret = false;
+    if ((length < MAX_PAYLOAD_LENGTH)&&(ProteusIII_State_BLE_Channel_Open == ProteusIII_GetDriverStateEx(handleP))&&!StreamBusy(handleP))
+    {
+        uint8_t header[CMD_POSITION_DATA];
+        header[CMD_POSITION_STX] = CMD_STX;
+        header[CMD_POSITION_CMD] = ProteusIII_CMD_DATA_REQ;
+        header[CMD_POSITION_LENGTH_LSB] = (uint8_t) (length >> 0);
+        header[CMD_POSITION_LENGTH_MSB] = (uint8_t) (length >> 8);
+
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ProteusIII_CMD_TXCOMPLETE_RSP, NULL, 0);
+        /* answered once the data was sent over the air */
+        CommandQueue_SetFixedTimeout(&request);
+        /* the payload is sent from the buffer of the caller */
+        if (SendCommand(handleP, header, sizeof(header), PayloadP, length, &request))
+        {
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
+    }
+    return ret;
+}
+
+/*
+ *Transmit data if a connection is open, without waiting until it was transmitted
+ *
+ *input:
+ * -PayloadP:  pointer to the data to transmit, copied before returning
+ * -length:    length of the data to transmit
+ * -cb:        called with success = true when the data was transmitted,
+ *             with success = false if it failed or was not confirmed in time
+ * -contextP:  passed to cb
+ *
+ *note: cb is called by a thread of the driver instance, it must not block for long
+ *
+ *note: fails while packets of ProteusIII_StreamTransmitEx are in flight
+ *
+ *return true if the data was queued, cb is called exactly once then
+ *       false otherwise
+ */
+bool
+ProteusIII_TransmitAsyncEx(ProteusIII_Handle_t *handleP, uint8_t *PayloadP, uint16_t length, ProteusIII_CommandCallback cb, void* contextP)
+{
+    if ((length < MAX_PAYLOAD_LENGTH)&&(ProteusIII_State_BLE_Channel_Open == ProteusIII_GetDriverStateEx(handleP))&&!StreamBusy(handleP))
+    {
+        uint8_t header[CMD_POSITION_DATA];
+        header[CMD_POSITION_STX] = CMD_STX;
+        header[CMD_POSITION_CMD] = ProteusIII_CMD_DATA_REQ;
+        header[CMD_POSITION_LENGTH_LSB] = (uint8_t) (length >> 0);
+        header[CMD_POSITION_LENGTH_MSB] = (uint8_t) (length >> 8);
+
+        return SendCommandAsync(handleP, header, sizeof(header), PayloadP, length,
+                                ProteusIII_CMD_TXCOMPLETE_RSP, CMD_Status_Success, 1, cb, contextP);
+    }
+    return false;
+}
+
+/*
+ *Transmit data as part of a stream if a connection is open
+ *
+ *Up to the stream window (see ProteusIII_SetStreamWindowEx) packets are passed to
+ *the module before the first of them was transmitted, so that the module always
+ *has the next packet at hand. Each TXCOMPLETE_RSP gives a credit back. If the
+ *window is full, the function blocks until a credit is available.
+ *
+ *input:
+ * -PayloadP: pointer to the data to transmit, copied before returning
+ * -length:   length of the data to transmit
+ *
+ *note: ProteusIII_TransmitEx and ProteusIII_TransmitAsyncEx fail while packets of the
+ *      stream are in flight, their TXCOMPLETE_RSP could not be told apart; use
+ *      ProteusIII_StreamFlushEx to wait until the stream was transmitted, and do not
+ *      start a stream while a packet of them is in flight
+ *
+ *note: the function returns once the DATA_REQ was queued for transmission, before the module
+ *      answered it; a DATA_REQ rejected by the module or a packet not transmitted is only
+ *      reported by ProteusIII_StreamFlushEx
+ *
+ *return true if the data was queued for transmission
+ *       false if no credit became available in time or the request could not be queued
+ */
+bool
+ProteusIII_StreamTransmitEx(ProteusIII_Handle_t *handleP, uint8_t *PayloadP, uint16_t length)
+{
+    if ((length >= MAX_PAYLOAD_LENGTH)||(ProteusIII_State_BLE_Channel_Open != ProteusIII_GetDriverStateEx(handleP)))
+    {
+        return false;
+    }
+
+    /* push back while the window is full */
+    struct timespec deadline;
+    GetDeadline(&deadline, CMD_WAIT_TIME);
+    pthread_mutex_lock(&handleP->streamMutex);
+    while(handleP->streamInFlight >= handleP->streamWindow)
+    {
+        if(pthread_cond_timedwait(&handleP->streamCond, &handleP->streamMutex, &deadline) == ETIMEDOUT)
+        {
+            pthread_mutex_unlock(&handleP->streamMutex);
+            return false;
+        }
+    }
+    handleP->streamInFlight++;
+    pthread_mutex_unlock(&handleP->streamMutex);
+
+    uint8_t header[CMD_POSITION_DATA];
+    header[CMD_POSITION_STX] = CMD_STX;
+    header[CMD_POSITION_CMD] = ProteusIII_CMD_DATA_REQ;
+    header[CMD_POSITION_LENGTH_LSB] = (uint8_t) (length >> 0);
+    header[CMD_POSITION_LENGTH_MSB] = (uint8_t) (length >> 8);
+    uint8_t checksum = FrameCodec_Checksum(FrameCodec_Checksum(0, header, sizeof(header)), PayloadP, length);
+
+    struct iovec frame[3] =
+    {
+        { .iov_base = header,    .iov_len = sizeof(header) },
+        { .iov_base = PayloadP,  .iov_len = length },
+        { .iov_base = &checksum, .iov_len = 1 },
+    };
+
+    /* the request is done once the module accepted the data, the credit is kept until it was transmitted;
+     * a full buffer of the module delays the DATA_CNF, so its timeout is not adapted to the answer times */
+    CommandQueue_Request_t *requestP = CommandQueue_NewRequest(ProteusIII_CMD_DATA_CNF, frame, 3, 0, sizeof(ProteusIII_Handle_t*));
+    if(requestP != NULL)
+    {
+        CommandQueue_SetFixedTimeout(requestP);
+        *(ProteusIII_Handle_t**)requestP->contextP = handleP;
+    }
+    if((requestP == NULL) ||
+       !CommandQueue_SubmitAsync(&handleP->cmdQueue, requestP, handleP->transportP, CMD_WAIT_TIME, StreamPacketDone))
+    {
+        pthread_mutex_lock(&handleP->streamMutex);
+        handleP->streamInFlight--;
+        pthread_cond_broadcast(&handleP->streamCond);
+        pthread_mutex_unlock(&handleP->streamMutex);
+        return false;
+    }
+    return true;
+}
+
+/*
+ *Wait until all packets of the stream were transmitted
+ *
+ *The wait is aborted if no packet was transmitted within the command timeout,
+ *the packets still in flight are counted as lost then.
+ *
+ *return true if all packets passed to ProteusIII_StreamTransmitEx since the last flush were transmitted
+ *       false otherwise
+ */
+bool
+ProteusIII_StreamFlushEx(ProteusIII_Handle_t *handleP)
+{
+    struct timespec deadline;
+    uint16_t inFlight;
+    bool ret;
+
+    pthread_mutex_lock(&handleP->streamMutex);
+    inFlight = handleP->streamInFlight;
+    GetDeadline(&deadline, CMD_WAIT_TIME);
+    while(handleP->streamInFlight > 0)
+    {
+        if(handleP->streamInFlight < inFlight)
+        {
+            /* progress, give the remaining packets time again */
+            inFlight = handleP->streamInFlight;
+            GetDeadline(&deadline, CMD_WAIT_TIME);
+        }
+        if(pthread_cond_timedwait(&handleP->streamCond, &handleP->streamMutex, &deadline) == ETIMEDOUT)
+        {
+            if(handleP->streamInFlight >= inFlight)
+            {
+                handleP->streamFailed += handleP->streamInFlight;
+                handleP->streamInFlight = 0;
+                pthread_cond_broadcast(&handleP->streamCond);
+            }
+        }
+    }
+    ret = (handleP->streamFailed == 0);
+    handleP->streamFailed = 0;
+    pthread_mutex_unlock(&handleP->streamMutex);
+    return ret;
+}
+
+/*
+ *Receive messages of any length over the channel
+ *
+ *While a callback is set, each DATA_IND carries a segment of a message sent by
+ *ProteusIII_SendMessageEx of the connected device instead of data for the RX callback.
+ *The segments are reassembled in the callback thread, a message missing a segment
+ *is dropped, as is the message being reassembled on disconnect.
+ *
+ *input:
+ * -maxMessageLength: longest message received, fixed by the first call with a callback
+ * -messageCb: called by the callback thread with each message, valid during the call;
+ *             NULL passes the DATA_IND to the RX callback again
+ * -contextP: passed to the callback
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool ProteusIII_SetMessageCallbackEx(ProteusIII_Handle_t *handleP, uint32_t maxMessageLength, ProteusIII_MessageCallback messageCb, void *contextP)
+{
+    bool ret = true;
+
+    if(handleP == NULL)
+    {
+        return false;
+    }
+    pthread_mutex_lock(&handleP->messageMutex);
+    if(!handleP->fragmenterReady && (messageCb != NULL))
+    {
+        /* the segments are sized by the channel in ProteusIII_SendMessageEx */
+        handleP->fragmenterReady = Fragmenter_Init(&handleP->fragmenter, SendSegment, handleP, MAX_PAYLOAD_LENGTH - 1,
+                                                   maxMessageLength, MessageReceived, handleP);
+        ret = handleP->fragmenterReady;
+    }
+    if(ret)
+    {
+        handleP->messageCb = messageCb;
+        handleP->messageContextP = contextP;
+    }
+    pthread_mutex_unlock(&handleP->messageMutex);
+    return ret;
+}
+
+/*
+ *Send a message of any length over the open channel
+ *
+ *The message is split into packets of the stream as long as the max payload of
+ *the channel allows (see ProteusIII_StreamTransmitEx), which the connected device
+ *reassembles, see ProteusIII_SetMessageCallbackEx.
+ *
+ *input:
+ * -messageP: pointer to the message
+ * -length:   length of the message
+ *
+ *note: the function waits until all packets of the stream were transmitted,
+ *      see ProteusIII_StreamFlushEx
+ *
+ *return true if all packets of the message were transmitted
+ *       false otherwise, the connected device drops the incomplete message
+ */
+bool ProteusIII_SendMessageEx(ProteusIII_Handle_t *handleP, uint8_t *messageP, uint32_t length)
+{
+    bool ret;
+
+    if(handleP == NULL)
+    {
+        return false;
+    }
+    pthread_mutex_lock(&handleP->messageMutex);
+    bool fragmenterReady = handleP->fragmenterReady;
+    uint16_t maxPayload = handleP->channelMaxPayload;
+    pthread_mutex_unlock(&handleP->messageMutex);
+    if(!fragmenterReady || (maxPayload == 0))
+    {
+        /* no callback set yet or no channel open */
+        return false;
+    }
+
+    /* not done by the RX thread, a running send could be waiting there for a credit */
+    if(!Fragmenter_SetMaxPayload(&handleP->fragmenter, maxPayload))
+    {
+        fprintf(stdout, "Max payload %u of the channel too small for messages\n", maxPayload);
+        return false;
+    }
+    ret = Fragmenter_Send(&handleP->fragmenter, messageP, length);
+    ret = ProteusIII_StreamFlushEx(handleP) && ret;
+    return ret;
+}
+
+
+/*
+ *Factory reset the module
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_FactoryResetEx(ProteusIII_Handle_t *handleP)
+{
+    bool ret = false;
+
+    /* the pins return to their defaults */
+    GPIOCache_Invalidate(handleP, false, 0);
+    GPIOCache_Invalidate(handleP, true, 0);
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_FACTORYRESET_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GETSTATE_CNF, NULL, 0);
+    /* answered once the module restarted */
+    CommandQueue_SetFixedTimeout(&request);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for reset after factory reset */
+        return Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_NoStatus);
+    }
+    return ret;
+}
+
+/*
+ *Set a special user setting
+ *
+ *input:
+ * -us:     user setting to be updated
+ * -value:  pointer to the new settings value
+ * -length: length of the value
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetEx(ProteusIII_Handle_t *handleP, ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length)
 {
     bool ret = false;
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_DISCONNECT_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_SET_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t) (1 + length);
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    frameP[CMD_POSITION_DATA] = userSetting;
+    memcpy(&frameP[CMD_POSITION_DATA + 1], ValueP, length);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_SET_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+        /* wait for cnf */
+        return Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
+    return ret;
+}
 
-        /* Confirmation is sent before perfoming the disconnect. After disconnect, module sends dicsonnect indication */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_DISCONNECT_CNF, CMD_Status_Success, true);
+/*
+ *Set a special user setting, without waiting for the confirmation
+ *
+ *input:
+ * -us:       user setting to be updated
+ * -value:    pointer to the new settings value, copied before returning
+ * -length:   length of the value
+ * -cb:       called with the result of the request
+ * -contextP: passed to cb
+ *
+ *note: cb is called by a thread of the driver instance, it must not block for long
+ *
+ *return true if the request was queued, cb is called exactly once then
+ *       false otherwise
+ */
+bool
+ProteusIII_SetAsyncEx(ProteusIII_Handle_t *handleP, ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length, ProteusIII_CommandCallback cb, void* contextP)
+{
+    uint8_t header[CMD_POSITION_DATA + 1];
+    header[CMD_POSITION_STX] = CMD_STX;
+    header[CMD_POSITION_CMD] = ProteusIII_CMD_SET_REQ;
+    header[CMD_POSITION_LENGTH_LSB] = (uint8_t) (1 + length);
+    header[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    header[CMD_POSITION_DATA] = userSetting;
+
+    return SendCommandAsync(handleP, header, sizeof(header), ValueP, length,
+                            ProteusIII_CMD_SET_CNF, CMD_Status_Success, 1, cb, contextP);
+}
+
+/*
+ *Set the BLE device name
+ *
+ *input:
+ * -deviceNameP: pointer to the device name
+ * -nameLength:  length of the device name
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetDeviceNameEx(ProteusIII_Handle_t *handleP, uint8_t *deviceNameP, uint8_t nameLength)
+{
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_DEVICE_NAME, deviceNameP, nameLength);
+}
+
+/*
+ *Set the BLE advertising timeout
+ *
+ *input:
+ * -advTimeout: advertising timeout
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetAdvertisingTimeoutEx(ProteusIII_Handle_t *handleP, uint16_t advTimeout)
+{
+    uint8_t help[2];
+    memcpy(help,(uint8_t*)&advTimeout,2);
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_ADVERTISING_TIMEOUT, help, 2);
+}
+
+/*
+ *Set the CFG flags
+ *
+ *input:
+ * -cfgflags: CFG flags
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetCFGFlagsEx(ProteusIII_Handle_t *handleP, uint16_t cfgflags)
+{
+    uint8_t help[2];
+    memcpy(help,(uint8_t*)&cfgflags,2);
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_CFGFLAGS, help, 2);
+}
+
+/*
+ *Set the BLE connection timing
+ *
+ *input:
+ * -connectionTiming: connection timing
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetConnectionTimingEx(ProteusIII_Handle_t *handleP, ProteusIII_ConnectionTiming_t connectionTiming)
+{
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_CONNECTION_TIMING, (uint8_t*)&connectionTiming, 1);
+}
+
+/*
+ *Set the BLE scan timing
+ *
+ *input:
+ * -scanTiming: scan timing
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetScanTimingEx(ProteusIII_Handle_t *handleP, ProteusIII_ScanTiming_t scanTiming)
+{
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_SCAN_TIMING, (uint8_t*)&scanTiming, 1);
+}
+
+/*
+ *Set the BLE TX power
+ *
+ *input:
+ * -txpower: TX power
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetTXPowerEx(ProteusIII_Handle_t *handleP, ProteusIII_TXPower_t txpower)
+{
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_TX_POWER, (uint8_t*)&txpower, 1);
+}
+
+/*
+ *Set the BLE security flags
+ *
+ *input:
+ * -secflags: security flags
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetSecFlagsEx(ProteusIII_Handle_t *handleP, ProteusIII_SecFlags_t secflags)
+{
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_SEC_FLAGS, (uint8_t*)&secflags, 1);
+}
+
+/*
+ *Set the UART baudrate index
+ *
+ *input:
+ * -baudrate: UART baudrate
+ * -parity: parity bit
+ * -flowcontrolEnable: enable/disable flow conrol
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool ProteusIII_SetBaudrateIndexEx(ProteusIII_Handle_t *handleP, ProteusIII_BaudRate_t baudrate, ProteusIII_UartParity_t parity, bool flowcontrolEnable)
+{
+    uint8_t baudrateIndex = (uint8_t)baudrate;
+
+    /* If flowcontrol is to be enabled UART index has to be increased by one in regard to base value */
+    if(flowcontrolEnable)
+    {
+        baudrateIndex++;
+    }
+
+    /* If parity bit is even, UART index has to be increased by 64 in regard of base value*/
+    if(ProteusIII_UartParity_Even == parity)
+    {
+        baudrateIndex += 64;
+    }
+
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_UART_CONFIG_INDEX, (uint8_t*)&baudrateIndex, 1);
+}
+
+/*
+ *Set the BLE static passkey
+ *
+ *input:
+ * -staticPasskeyP: pointer to the static passkey
+ *
+ *note: reset the module after the adaption of the setting such that it can take effect
+ *note: use this function only in rare case, since flash can be updated only a limited number times
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_SetStaticPasskeyEx(ProteusIII_Handle_t *handleP, uint8_t *staticPasskeyP)
+{
+    return ProteusIII_SetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_STATIC_PASSKEY, staticPasskeyP, 6);
+}
+
+/*
+ *Request the current user settings
+ *
+ *input:
+ * -userSetting: user setting to be requested
+ *
+ *output:
+ * -responseP: pointer of the memory to put the requested content
+ * -response_lengthP: length of the requested content
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_GetEx(ProteusIII_Handle_t *handleP, ProteusIII_UserSettings_t userSetting, uint8_t *ResponseP, uint16_t *Response_LengthP)
+{
+    bool ret = false;
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GET_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)1;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    frameP[CMD_POSITION_DATA] = userSetting;
+
+    uint8_t response[MAX_CMD_LENGTH];
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GET_CNF, response, sizeof(response));
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        if (Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success))
+        {
+            uint16_t length = ((uint16_t) response[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) response[CMD_POSITION_LENGTH_MSB] << 8);
+            memcpy(ResponseP, &response[CMD_POSITION_DATA + 1], length - 1); /* First Data byte is status, following bytes response*/
+            *Response_LengthP = length - 1;
+            ret = true;
+        }
     }
     return ret;
 }
 
 /*
- *Put the ProteusIII into sleep mode
+ *Request the current user settings, without waiting for the confirmation
+ *
+ *input:
+ * -userSetting: user setting to be requested
+ * -cb:          called with the value of the setting in dataP
+ * -contextP:    passed to cb
+ *
+ *note: cb is called by a thread of the driver instance, it must not block for long
+ *
+ *return true if the request was queued, cb is called exactly once then
+ *       false otherwise
+ */
+bool
+ProteusIII_GetAsyncEx(ProteusIII_Handle_t *handleP, ProteusIII_UserSettings_t userSetting, ProteusIII_CommandCallback cb, void* contextP)
+{
+    uint8_t header[CMD_POSITION_DATA + 1];
+    header[CMD_POSITION_STX] = CMD_STX;
+    header[CMD_POSITION_CMD] = ProteusIII_CMD_GET_REQ;
+    header[CMD_POSITION_LENGTH_LSB] = (uint8_t)1;
+    header[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    header[CMD_POSITION_DATA] = userSetting;
+
+    /* First Data byte is status, following bytes response */
+    return SendCommandAsync(handleP, header, sizeof(header), NULL, 0,
+                            ProteusIII_CMD_GET_CNF, CMD_Status_Success, 1, cb, contextP);
+}
+
+/*
+ *Request the 3 byte firmware version
+ *
+ *output:
+ * -versionP: pointer to the 3 byte firmware version
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_GetFWVersionEx(ProteusIII_Handle_t *handleP, uint8_t *versionP)
+{
+    uint16_t length;
+    return ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_FS_FWVersion, versionP, &length);
+}
+
+/*
+ *Request the current BLE device name
+ *
+ *output:
+ * -deviceNameP: pointer to device name
+ * -nameLengthP: pointer to the length of the device name
+ *
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool
+ProteusIII_GetDeviceNameEx(ProteusIII_Handle_t *handleP, uint8_t *deviceNameP, uint16_t *nameLengthP)
+{
+    return ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_DEVICE_NAME, deviceNameP, nameLengthP);
+}
+
+/*
+ *Request the 8 digit MAC
+ *
+ *output:
+ * -macP: pointer to the MAC
  *
- *return true if succeeded
+ *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_Sleep()
+ProteusIII_GetMACEx(ProteusIII_Handle_t *handleP, uint8_t *MacP)
 {
-    bool ret = false;
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_SLEEP_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes( CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_SLEEP_CNF, CMD_Status_Success, true);
-    }
-    return ret;
+    uint16_t length;
+    return ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_FS_MAC, MacP, &length);
 }
 
 /*
- *Transmit data if a connection is open
+ *Request the 6 digit Bluetooth MAC
  *
- *input:
- * -PayloadP: pointer to the data to transmit
- * -length:   length of the data to transmit
+ *output:
+ * -BTMacP: pointer to the Bluetooth MAC
  *
- *return true if succeeded
+ *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_Transmit(uint8_t *PayloadP, uint16_t length)
+ProteusIII_GetBTMACEx(ProteusIII_Handle_t *handleP, uint8_t *BTMacP)
 {
-    bool ret = false;
-    if ((length < MAX_PAYLOAD_LENGTH)&&(ProteusIII_State_BLE_Channel_Open == ProteusIII_GetDriverState()))
-    {
-        CMD_Array[CMD_POSITION_STX] = CMD_STX;
-        CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_DATA_REQ;
-        CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t) (length >> 0);
-        CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t) (length >> 8);
-
-        memcpy(&CMD_Array[CMD_POSITION_DATA], PayloadP, length);
-
-        if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-        {
-            SendBytes( CMD_Array, CMD_ARRAY_SIZE());
-            ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_TXCOMPLETE_RSP, CMD_Status_Success, true);
-        }
-    }
-    return ret;
+    uint16_t length;
+    return ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_FS_BTMAC, BTMacP, &length);
 }
 
-
 /*
- *Factory reset the module
+ *Request the advertising timeout
  *
- *return true if succeeded
+ *output:
+ * -advTimeoutP: pointer to the advertising timeout
+ *
+ *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_FactoryReset()
+ProteusIII_GetAdvertisingTimeoutEx(ProteusIII_Handle_t *handleP, uint16_t *advTimeoutP)
 {
+    uint16_t length;
     bool ret = false;
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_FACTORYRESET_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    uint8_t help[2];
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+    ret = ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_ADVERTISING_TIMEOUT, help, &length);
+    memcpy((uint8_t*)advTimeoutP,help,2);
 
-        /* wait for reset after factory reset */
-        return Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true);
-    }
     return ret;
 }
 
 /*
- *Set a special user setting
- *
- *input:
- * -us:     user setting to be updated
- * -value:  pointer to the new settings value
- * -length: length of the value
+ *Request the connection timing
  *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *output:
+ * -connectionTimingP: pointer to the  connection timing
  *
  *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_Set(ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length)
+ProteusIII_GetConnectionTimingEx(ProteusIII_Handle_t *handleP, ProteusIII_ConnectionTiming_t *connectionTimingP)
 {
-    bool ret = false;
-
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_SET_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t) (1 + length);
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_DATA] = userSetting;
-    memcpy(&CMD_Array[CMD_POSITION_DATA + 1], ValueP, length);
+    uint16_t length;
+    uint8_t value;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    /* the setting is a single byte, the enum is wider */
+    if(!ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_CONNECTION_TIMING, &value, &length))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        return Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_SET_CNF, CMD_Status_Success, true);
+        return false;
     }
-    return ret;
+    *connectionTimingP = (ProteusIII_ConnectionTiming_t)value;
+    return true;
 }
 
 /*
- *Set the BLE device name
- *
- *input:
- * -deviceNameP: pointer to the device name
- * -nameLength:  length of the device name
+ *Request the scan timing
  *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *output:
+ * -scanTimingP: pointer to the  scan timing
  *
  *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_SetDeviceName(uint8_t *deviceNameP, uint8_t nameLength)
+ProteusIII_GetScanTimingEx(ProteusIII_Handle_t *handleP, ProteusIII_ScanTiming_t *scanTimingP)
 {
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_DEVICE_NAME, deviceNameP, nameLength);
+    uint16_t length;
+    uint8_t value;
+
+    /* the setting is a single byte, the enum is wider */
+    if(!ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_SCAN_TIMING, &value, &length))
+    {
+        return false;
+    }
+    *scanTimingP = (ProteusIII_ScanTiming_t)value;
+    return true;
 }
 
 /*
- *Set the BLE advertising timeout
- *
- *input:
- * -advTimeout: advertising timeout
+ *Request the TX power
  *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *output:
+ * -txpowerP: pointer to the TX power
  *
  *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_SetAdvertisingTimeout(uint16_t advTimeout)
+ProteusIII_GetTXPowerEx(ProteusIII_Handle_t *handleP, ProteusIII_TXPower_t *txpowerP)
 {
-    uint8_t help[2];
-    memcpy(help,(uint8_t*)&advTimeout,2);
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_ADVERTISING_TIMEOUT, help, 2);
+    uint16_t length;
+    uint8_t value;
+
+    /* the setting is a single byte, the enum is wider */
+    if(!ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_TX_POWER, &value, &length))
+    {
+        return false;
+    }
+    *txpowerP = (ProteusIII_TXPower_t)(int8_t)value;
+    return true;
 }
 
 /*
- *Set the CFG flags
- *
- *input:
- * -cfgflags: CFG flags
+ *Request the security flags
  *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *output:
+ * -secflagsP: pointer to the security flags
  *
  *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_SetCFGFlags(uint16_t cfgflags)
+ProteusIII_GetSecFlagsEx(ProteusIII_Handle_t *handleP, ProteusIII_SecFlags_t *secflagsP)
 {
-    uint8_t help[2];
-    memcpy(help,(uint8_t*)&cfgflags,2);
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_CFGFLAGS, help, 2);
+    uint16_t length;
+    uint8_t value;
+
+    /* the setting is a single byte, the enum is wider */
+    if(!ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_SEC_FLAGS, &value, &length))
+    {
+        return false;
+    }
+    *secflagsP = (ProteusIII_SecFlags_t)value;
+    return true;
 }
 
 /*
- *Set the BLE connection timing
- *
- *input:
- * -connectionTiming: connection timing
+ *Request the UART baudrate index
  *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *output:
+ * -baudrateIndexP: pointer to the UART baudrate index
  *
  *return true if request succeeded
- *       false otherwise
- */
-bool
-ProteusIII_SetConnectionTiming(ProteusIII_ConnectionTiming_t connectionTiming)
+*       false otherwise
+*/
+bool ProteusIII_GetBaudrateIndexEx(ProteusIII_Handle_t *handleP, ProteusIII_BaudRate_t *baudrateP, ProteusIII_UartParity_t *parityP, bool *flowcontrolEnableP)
 {
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_CONNECTION_TIMING, (uint8_t*)&connectionTiming, 1);
+    bool ret = false;
+    uint16_t length;
+    uint8_t uartIndex;
+
+    if(ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_UART_CONFIG_INDEX, (uint8_t*)&uartIndex, &length))
+    {
+        /* if index is even, flow control is off.
+         * If flow control is on, decrease index by one to later determin the base baudrate */
+        if(0x01 == (uartIndex & 0x01))
+        {
+            /* odd */
+            *flowcontrolEnableP = true;
+            uartIndex--;
+        }
+        else
+        {
+            /* even */
+            *flowcontrolEnableP = false;
+        }
+
+        /* If baudrate index is greater than or equal to 64, parity bit is even*/
+        if(uartIndex < 64)
+        {
+            *parityP = ProteusIII_UartParity_None;
+        }
+        else
+        {
+
+            *parityP = ProteusIII_UartParity_Even;
+            uartIndex -= 64;
+        }
+
+        *baudrateP = (ProteusIII_BaudRate_t)uartIndex;
+        ret = true;
+    }
+
+    return ret;
 }
 
 /*
- *Set the BLE scan timing
- *
- *input:
- * -scanTiming: scan timing
+ *Request the CFG flags
  *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *output:
+ * -cfgflags: pointer to the CFG flags
  *
  *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_SetScanTiming(ProteusIII_ScanTiming_t scanTiming)
+ProteusIII_GetCFGFlagsEx(ProteusIII_Handle_t *handleP, uint16_t *cfgflags)
 {
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_SCAN_TIMING, (uint8_t*)&scanTiming, 1);
+    uint16_t length;
+    bool ret = false;
+    uint8_t help[2];
+
+    ret = ProteusIII_GetEx(handleP, ProteusIII_USERSETTING_POSITION_RF_CFGFLAGS, help, &length);
+    memcpy((uint8_t*)cfgflags,help,2);
+
+    return ret;
 }
 
 /*
- *Set the BLE TX power
- *
- *input:
- * -txpower: TX power
+ *Request the module state
  *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *output:
+ * -BLE_roleP:   pointer to the BLE role of the module
+ * -BLE_actionP: pointer to the BLE action of the module
+ * -InfoP:       pointer to the state info of the module
+ * -LengthP:     pointer to the length of the state info of the module
  *
  *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_SetTXPower(ProteusIII_TXPower_t txpower)
+ProteusIII_GetStateEx(ProteusIII_Handle_t *handleP, ProteusIII_BLE_Role_t *BLE_roleP, ProteusIII_BLE_Action_t *BLE_actionP, uint8_t *InfoP, uint8_t *LengthP)
 {
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_TX_POWER, (uint8_t*)&txpower, 1);
+    bool ret = false;
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GETSTATE_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+
+    uint8_t response[MAX_CMD_LENGTH];
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GETSTATE_CNF, response, sizeof(response));
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        handleP->askedForState = true;
+        /* wait for cnf */
+        if (Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_NoStatus))
+        {
+            uint16_t length = ((uint16_t) response[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) response[CMD_POSITION_LENGTH_MSB] << 8);
+            *BLE_roleP = response[CMD_POSITION_DATA];
+            *BLE_actionP = response[CMD_POSITION_DATA + 1];
+            memcpy(InfoP, &response[CMD_POSITION_DATA + 2], length - 2);
+
+            *LengthP = length-2;
+            ret = true;
+        }
+    }
+    handleP->askedForState = false;
+    return ret;
 }
 
 /*
- *Set the BLE security flags
- *
- *input:
- * -secflags: security flags
+ *Request the current state of the driver
  *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
  *
- *return true if request succeeded
- *       false otherwise
+ *return driver state
  */
-bool
-ProteusIII_SetSecFlags(ProteusIII_SecFlags_t secflags)
+ProteusIII_States_t ProteusIII_GetDriverStateEx(ProteusIII_Handle_t *handleP)
 {
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_SEC_FLAGS, (uint8_t*)&secflags, 1);
+    return handleP->ble_state;
 }
 
 /*
- *Set the UART baudrate index
- *
- *input:
- * -baudrate: UART baudrate
- * -parity: parity bit
- * -flowcontrolEnable: enable/disable flow conrol
- *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *Start scan
  *
  *return true if request succeeded
  *       false otherwise
  */
-bool ProteusIII_SetBaudrateIndex(ProteusIII_BaudRate_t baudrate, ProteusIII_UartParity_t parity, bool flowcontrolEnable)
+bool
+ProteusIII_ScanstartEx(ProteusIII_Handle_t *handleP)
 {
-    uint8_t baudrateIndex = (uint8_t)baudrate;
+    bool ret = false;
 
-    /* If flowcontrol is to be enabled UART index has to be increased by one in regard to base value */
-    if(flowcontrolEnable)
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
     {
-        baudrateIndex++;
+        return false;
     }
-
-    /* If parity bit is even, UART index has to be increased by 64 in regard of base value*/
-    if(ProteusIII_UartParity_Even == parity)
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_SCANSTART_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_SCANSTART_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
     {
-        baudrateIndex += 64;
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
     }
-
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_UART_CONFIG_INDEX, (uint8_t*)&baudrateIndex, 1);
+    return ret;
 }
 
 /*
- *Set the BLE static passkey
- *
- *input:
- * -staticPasskeyP: pointer to the static passkey
- *
- *note: reset the module after the adaption of the setting such that it can take effect
- *note: use this function only in rare case, since flash can be updated only a limited number times
+ *Stop a scan
  *
  *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_SetStaticPasskey(uint8_t *staticPasskeyP)
+ProteusIII_ScanstopEx(ProteusIII_Handle_t *handleP)
 {
-    return ProteusIII_Set(ProteusIII_USERSETTING_POSITION_RF_STATIC_PASSKEY, staticPasskeyP, 6);
+    bool ret = false;
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_SCANSTOP_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_SCANSTOP_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
+    return ret;
 }
 
 /*
- *Request the current user settings
- *
- *input:
- * -userSetting: user setting to be requested
+ *Request the scan results
  *
  *output:
- * -responseP: pointer of the memory to put the requested content
- * -response_lengthP: length of the requested content
+ * -devicesP: pointer to scan result struct, up to MAX_NUMBER_OF_DEVICES devices; may be NULL
+ *            if only the scan index shall be updated, see ProteusIII_ScanStreamStartEx
  *
  *return true if request succeeded
  *       false otherwise
  */
 bool
-ProteusIII_Get(ProteusIII_UserSettings_t userSetting, uint8_t *ResponseP, uint16_t *Response_LengthP)
+ProteusIII_GetDevicesEx(ProteusIII_Handle_t *handleP, ProteusIII_GetDevices_t* devicesP)
 {
     bool ret = false;
 
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GET_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)1;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_DATA] = userSetting;
-
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (devicesP != NULL)
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+        devicesP->numberofdevices = 0;
+    }
 
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GETDEVICES_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+
+    uint8_t response[MAX_CMD_LENGTH];
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GETDEVICES_CNF, response, sizeof(response));
+    if (SubmitFrame(handleP, frameP, &request))
+    {
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GET_CNF, CMD_Status_Success, true))
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        if (ret && (devicesP != NULL))
         {
-            uint16_t length = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8);
-            memcpy(ResponseP, &RxPacket[CMD_POSITION_DATA + 1], length - 1); /* First Data byte is status, following bytes response*/
-            *Response_LengthP = length - 1;
-            ret = true;
+            uint8_t size = DeviceCount(response);
+            uint16_t position = CMD_POSITION_DATA + 2;
+
+            if (size >= MAX_NUMBER_OF_DEVICES)
+            {
+                size = MAX_NUMBER_OF_DEVICES;
+            }
+            while ((devicesP->numberofdevices < size) &&
+                   ParseDevice(response, &position, &devicesP->devices[devicesP->numberofdevices]))
+            {
+                devicesP->numberofdevices++;
+            }
         }
     }
+
     return ret;
 }
 
 /*
- *Request the 3 byte firmware version
+ *Start a continuous scan that collects the devices in the scan index
  *
- *output:
- * -versionP: pointer to the 3 byte firmware version
+ *The module is set to scan and its scan results are requested periodically. Each
+ *result updates the entry of its device in the scan index, keyed by BTMAC: last
+ *RSSI, mean RSSI, TX power, name and the time it was last seen. Unlike the snapshots
+ *of ProteusIII_GetDevicesEx, the index keeps all devices seen since it was cleared,
+ *up to several thousands, and can be queried at any time by ProteusIII_ScanFindEx,
+ *ProteusIII_ScanTopEx and ProteusIII_ScanCountEx.
  *
- *return true if request succeeded
- *       false otherwise
+ *input:
+ * -interval_ms: time between two requests of the scan results, 0 to request them back to back
+ * -maxAge_ms:   devices not seen for this time are removed from the index, 0 to keep them
+ *
+ *note: the scan results of ProteusIII_GetDevicesEx calls of the application are added
+ *      to the index as well, once it was created by this function
+ *
+ *return true if the scan was started
+ *       false otherwise, e.g. if a scan stream is running already
  */
 bool
-ProteusIII_GetFWVersion(uint8_t *versionP)
+ProteusIII_ScanStreamStartEx(ProteusIII_Handle_t *handleP, uint16_t interval_ms, uint32_t maxAge_ms)
 {
-    uint16_t length;
-    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_FS_FWVersion, versionP, &length);
+    if (handleP == NULL)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    if (handleP->scanRunning || ((handleP->scanTableP == NULL) && !ScanIndex_Grow(handleP)))
+    {
+        pthread_mutex_unlock(&handleP->scanMutex);
+        return false;
+    }
+    handleP->scanRunning = true;
+    handleP->scanStop = false;
+    handleP->scanInterval_ms = interval_ms;
+    handleP->scanMaxAge_ms = maxAge_ms;
+    pthread_mutex_unlock(&handleP->scanMutex);
+
+    if (ProteusIII_ScanstartEx(handleP))
+    {
+        if (0 == pthread_create(&handleP->thread_scan, NULL, &scan_thread, handleP))
+        {
+            return true;
+        }
+        fprintf(stdout, "Failed to start scan thread\n");
+        ProteusIII_ScanstopEx(handleP);
+    }
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    handleP->scanRunning = false;
+    pthread_mutex_unlock(&handleP->scanMutex);
+    return false;
 }
 
 /*
- *Request the current BLE device name
- *
- *output:
- * -deviceNameP: pointer to device name
- * -nameLengthP: pointer to the length of the device name
+ *Stop the continuous scan, the scan index is kept
  *
- *return true if request succeeded
+ *return true if the module stopped scanning
  *       false otherwise
  */
 bool
-ProteusIII_GetDeviceName(uint8_t *deviceNameP, uint16_t *nameLengthP)
+ProteusIII_ScanStreamStopEx(ProteusIII_Handle_t *handleP)
 {
-    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_RF_DEVICE_NAME, deviceNameP, nameLengthP);
+    if (handleP == NULL)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    if (!handleP->scanRunning)
+    {
+        pthread_mutex_unlock(&handleP->scanMutex);
+        return false;
+    }
+    handleP->scanStop = true;
+    pthread_cond_broadcast(&handleP->scanCond);
+    pthread_mutex_unlock(&handleP->scanMutex);
+
+    pthread_join(handleP->thread_scan, NULL);
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    handleP->scanRunning = false;
+    pthread_mutex_unlock(&handleP->scanMutex);
+
+    return ProteusIII_ScanstopEx(handleP);
 }
 
 /*
- *Request the 8 digit MAC
+ *Look up a device in the scan index
+ *
+ *input:
+ * -btmacP: BTMAC of the device
  *
  *output:
- * -macP: pointer to the MAC
+ * -deviceP: device as last seen
  *
- *return true if request succeeded
+ *return true if the device is in the index
  *       false otherwise
  */
 bool
-ProteusIII_GetMAC(uint8_t *MacP)
+ProteusIII_ScanFindEx(ProteusIII_Handle_t *handleP, uint8_t *btmacP, ProteusIII_ScanDevice_t *deviceP)
 {
-    uint16_t length;
-    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_FS_MAC, MacP, &length);
+    bool ret = false;
+
+    if ((handleP == NULL) || (btmacP == NULL) || (deviceP == NULL))
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    uint32_t slot = ScanIndex_Find(handleP, btmacP);
+    if (slot != SCANINDEX_NO_SLOT)
+    {
+        ScanIndex_Copy(&handleP->scanTableP[slot], ScanIndex_Now(), deviceP);
+        ret = true;
+    }
+    pthread_mutex_unlock(&handleP->scanMutex);
+    return ret;
 }
 
 /*
- *Request the 6 digit Bluetooth MAC
+ *Read the devices of the scan index with the strongest mean RSSI
+ *
+ *input:
+ * -count: maximum number of devices to read
  *
  *output:
- * -BTMacP: pointer to the Bluetooth MAC
+ * -devicesP: array of 'count' devices, filled strongest first
  *
- *return true if request succeeded
- *       false otherwise
+ *return number of devices filled in, less than count if the index holds fewer devices
  */
-bool
-ProteusIII_GetBTMAC(uint8_t *BTMacP)
+uint32_t
+ProteusIII_ScanTopEx(ProteusIII_Handle_t *handleP, ProteusIII_ScanDevice_t *devicesP, uint32_t count)
 {
-    uint16_t length;
-    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_FS_BTMAC, BTMacP, &length);
+    uint32_t filled = 0;
+    uint32_t i;
+
+    if ((handleP == NULL) || (devicesP == NULL) || (count == 0))
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    uint64_t now = ScanIndex_Now();
+    for (i = 0; i < handleP->scanCapacity; i++)
+    {
+        ScanEntry_t *entryP = &handleP->scanTableP[i];
+        if (!entryP->used)
+        {
+            continue;
+        }
+        if (filled < count)
+        {
+            /* collect the first devices, then keep them as a min-heap with the weakest on top */
+            ScanIndex_Copy(entryP, now, &devicesP[filled++]);
+            if (filled == count)
+            {
+                uint32_t j;
+                for (j = count / 2; j-- > 0;)
+                {
+                    ScanIndex_SiftDown(devicesP, count, j);
+                }
+            }
+        }
+        else if (entryP->device.rssiAverage > devicesP[0].rssiAverage)
+        {
+            ScanIndex_Copy(entryP, now, &devicesP[0]);
+            ScanIndex_SiftDown(devicesP, count, 0);
+        }
+    }
+    pthread_mutex_unlock(&handleP->scanMutex);
+
+    /* sort strongest first: build the heap if it was not filled, then move the weakest to the end */
+    if (filled < count)
+    {
+        for (i = filled / 2; i-- > 0;)
+        {
+            ScanIndex_SiftDown(devicesP, filled, i);
+        }
+    }
+    for (i = filled; i-- > 1;)
+    {
+        ProteusIII_ScanDevice_t device = devicesP[0];
+        devicesP[0] = devicesP[i];
+        devicesP[i] = device;
+        ScanIndex_SiftDown(devicesP, i, 0);
+    }
+    return filled;
 }
 
 /*
- *Request the advertising timeout
+ *Remove the devices from the scan index that were not seen for some time
  *
- *output:
- * -advTimeoutP: pointer to the advertising timeout
+ *input:
+ * -maxAge_ms: devices whose last scan result is older are removed
  *
- *return true if request succeeded
- *       false otherwise
+ *return number of devices removed
  */
-bool
-ProteusIII_GetAdvertisingTimeout(uint16_t *advTimeoutP)
+uint32_t
+ProteusIII_ScanAgeOutEx(ProteusIII_Handle_t *handleP, uint32_t maxAge_ms)
 {
-    uint16_t length;
-    bool ret = false;
-    uint8_t help[2];
+    uint32_t removed = 0;
+    uint32_t i = 0;
 
-    ret = ProteusIII_Get(ProteusIII_USERSETTING_POSITION_RF_ADVERTISING_TIMEOUT, help, &length);
-    memcpy((uint8_t*)advTimeoutP,help,2);
+    if (handleP == NULL)
+    {
+        return 0;
+    }
 
-    return ret;
+    pthread_mutex_lock(&handleP->scanMutex);
+    uint64_t now = ScanIndex_Now();
+    while (i < handleP->scanCapacity)
+    {
+        ScanEntry_t *entryP = &handleP->scanTableP[i];
+        if (entryP->used && (now - entryP->lastSeen_ms > maxAge_ms))
+        {
+            /* a device behind may have been moved into this slot, check it again */
+            ScanIndex_Remove(handleP, i);
+            removed++;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    pthread_mutex_unlock(&handleP->scanMutex);
+    return removed;
 }
 
 /*
- *Request the connection timing
+ *Read the number of devices in the scan index
  *
- *output:
- * -connectionTimingP: pointer to the  connection timing
+ *return number of devices
+ */
+uint32_t
+ProteusIII_ScanCountEx(ProteusIII_Handle_t *handleP)
+{
+    uint32_t count;
+
+    if (handleP == NULL)
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    count = handleP->scanCount;
+    pthread_mutex_unlock(&handleP->scanMutex);
+    return count;
+}
+
+/*
+ *Remove all devices from the scan index
  *
- *return true if request succeeded
+ *return true if succeeded
  *       false otherwise
  */
 bool
-ProteusIII_GetConnectionTiming(ProteusIII_ConnectionTiming_t *connectionTimingP)
+ProteusIII_ScanClearEx(ProteusIII_Handle_t *handleP)
 {
-    uint16_t length;
-    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_RF_CONNECTION_TIMING, (uint8_t*)connectionTimingP, &length);
+    if (handleP == NULL)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&handleP->scanMutex);
+    if (handleP->scanTableP != NULL)
+    {
+        memset(handleP->scanTableP, 0, handleP->scanCapacity * sizeof(ScanEntry_t));
+    }
+    handleP->scanCount = 0;
+    pthread_mutex_unlock(&handleP->scanMutex);
+    return true;
 }
 
 /*
- *Request the scan timing
+ *Connect to the BLE device with the corresponding BTMAC
  *
- *output:
- * -scanTimingP: pointer to the  scan timing
+ *input:
+ * -btmac: pointer to btmac
  *
  *return true if request succeeded
  *       false otherwise
  */
-bool
-ProteusIII_GetScanTiming(ProteusIII_ScanTiming_t *scanTimingP)
+bool ProteusIII_ConnectEx(ProteusIII_Handle_t *handleP, uint8_t *btmac)
 {
-    uint16_t length;
-    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_RF_SCAN_TIMING, (uint8_t*)scanTimingP, &length);
+    bool ret = false;
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_CONNECT_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)6;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    memcpy(&frameP[CMD_POSITION_DATA], btmac, 6);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_CONNECT_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, 3000, CMD_Status_Success);
+    }
+    return ret;
 }
 
 /*
- *Request the TX power
+ *Answer on a passkey request with a passkey to setup a connection
  *
- *output:
- * -txpowerP: pointer to the TX power
+ *input:
+ * -passkey: pointer to passkey
  *
  *return true if request succeeded
  *       false otherwise
  */
-bool
-ProteusIII_GetTXPower(ProteusIII_TXPower_t *txpowerP)
+bool ProteusIII_PasskeyEx(ProteusIII_Handle_t *handleP, uint8_t* passkey)
 {
-    uint16_t length;
-    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_RF_TX_POWER, (uint8_t*)txpowerP, &length);
+    bool ret = false;
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_PASSKEY_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)6;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    memcpy(&frameP[CMD_POSITION_DATA], passkey, 6);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_PASSKEY_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
+    return ret;
 }
 
 /*
- *Request the security flags
+ *Answer on a numeric comparison request
  *
- *output:
- * -secflagsP: pointer to the security flags
+ *input:
+ * -keyIsOk: boolean to confirm if the key shown is correct
  *
  *return true if request succeeded
  *       false otherwise
  */
-bool
-ProteusIII_GetSecFlags(ProteusIII_SecFlags_t *secflagsP)
+bool ProteusIII_NumericCompareConfirmEx(ProteusIII_Handle_t *handleP, bool keyIsOk)
 {
-    uint16_t length;
-    return ProteusIII_Get(ProteusIII_USERSETTING_POSITION_RF_SEC_FLAGS, (uint8_t*)secflagsP, &length);
+    bool ret = false;
+    uint8_t lescStatus;
+
+    /* If key is ok, status byte is "0x00"
+        ohterwise it's "0x01" */
+    if(keyIsOk)
+    {
+        lescStatus = 0x00;
+    }
+    else
+    {
+        lescStatus = 0x01;
+    }
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_NUMERIC_COMP_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)1;
+    frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+    frameP[CMD_POSITION_DATA] = lescStatus;
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_NUMERIC_COMP_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
+    return ret;
 }
 
 /*
- *Request the UART baudrate index
+ *Update the phy during an open connection
  *
- *output:
- * -baudrateIndexP: pointer to the UART baudrate index
+ *input:
+ * -phy: new phy
  *
  *return true if request succeeded
-*       false otherwise
-*/
-bool ProteusIII_GetBaudrateIndex(ProteusIII_BaudRate_t *baudrateP, ProteusIII_UartParity_t *parityP, bool *flowcontrolEnableP)
+ *       false otherwise
+ */
+bool ProteusIII_PhyUpdateEx(ProteusIII_Handle_t *handleP, ProteusIII_Phy_t phy)
 {
     bool ret = false;
-    uint16_t length;
-    uint8_t uartIndex;
 
-    if(ProteusIII_Get(ProteusIII_USERSETTING_POSITION_UART_CONFIG_INDEX, (uint8_t*)&uartIndex, &length))
+    if (ProteusIII_State_BLE_Channel_Open == ProteusIII_GetDriverStateEx(handleP))
     {
-        /* if index is even, flow control is off.
-         * If flow control is on, decrease index by one to later determin the base baudrate */
-        if(0x01 == (uartIndex & 0x01))
+        /* fill a TX frame of the pool in place */
+        uint8_t *frameP = ReserveFrame(handleP);
+        if(frameP == NULL)
         {
-            /* odd */
-            *flowcontrolEnableP = true;
-            uartIndex--;
+            return false;
         }
-        else
+        frameP[CMD_POSITION_STX] = CMD_STX;
+        frameP[CMD_POSITION_CMD] = ProteusIII_CMD_PHYUPDATE_REQ;
+        frameP[CMD_POSITION_LENGTH_LSB] = (uint8_t)1;
+        frameP[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
+        frameP[CMD_POSITION_DATA] = (uint8_t)phy;
+
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ProteusIII_CMD_PHYUPDATE_CNF, NULL, 0);
+        if (SubmitFrame(handleP, frameP, &request))
         {
-            /* even */
-            *flowcontrolEnableP = false;
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
         }
+    }
+    return ret;
+}
 
-        /* If baudrate index is greater than or equal to 64, parity bit is even*/
-        if(uartIndex < 64)
-        {
-            *parityP = ProteusIII_UartParity_None;
-        }
-        else
-        {
+/*
+ *Configure the local GPIO of the module
+ *
+ *input:
+ * -configP: pointer to one or more pin configurations
+ * -configLength: length of data configP points to
+ *return true if request succeeded
+ *       false otherwise
+ */
+bool ProteusIII_GPIOLocalWriteConfigEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOConfigBlock_t* configP, uint16_t configLength)
+{
+    bool ret = false;
 
-            *parityP = ProteusIII_UartParity_Even;
-            uartIndex -= 64;
-        }
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_LOCAL_WRITECONFIG_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB]= (configLength & 0x00FF);
+    frameP[CMD_POSITION_LENGTH_MSB]= (configLength & 0xFF00) >> 8;
+    memcpy(&frameP[CMD_POSITION_DATA], configP, configLength);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GPIO_LOCAL_WRITECONFIG_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
 
-        *baudrateP = (ProteusIII_BaudRate_t)uartIndex;
-        ret = true;
+    /* the configuration sets the pins anew */
+    uint16_t position = 0;
+    uint8_t GPIO_ID, value;
+    while (ParseGPIOBlock((uint8_t*)configP, configLength, &position, &GPIO_ID, &value))
+    {
+        GPIOCache_Invalidate(handleP, false, GPIO_ID);
     }
 
     return ret;
 }
 
 /*
- *Request the CFG flags
+ *Read the local GPIO configuration of the module
  *
  *output:
- * -cfgflags: pointer to the CFG flags
- *
+ * -configP: pointer to one or more pin configurations
+ * -configLengthP: length of data configP points to
  *return true if request succeeded
  *       false otherwise
  */
-bool
-ProteusIII_GetCFGFlags(uint16_t *cfgflags)
+bool ProteusIII_GPIOLocalReadConfigEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOConfigBlock_t* configP, uint16_t *configLengthP)
 {
-    uint16_t length;
     bool ret = false;
-    uint8_t help[2];
 
-    ret = ProteusIII_Get(ProteusIII_USERSETTING_POSITION_RF_CFGFLAGS, help, &length);
-    memcpy((uint8_t*)cfgflags,help,2);
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_LOCAL_READCONFIG_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB]= 0;
+    frameP[CMD_POSITION_LENGTH_MSB]= 0;
+
+    uint8_t response[MAX_CMD_LENGTH];
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GPIO_LOCAL_READCONFIG_CNF, response, sizeof(response));
+    if (SubmitFrame(handleP, frameP, &request))
+    {
+        /* wait for cnf */
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        if(ret)
+        {
+            /* config length is packetlength - 1 (status byte)*/
+            *configLengthP = ((uint16_t) response[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) response[CMD_POSITION_LENGTH_MSB] << 8) - 1;
+            memcpy(configP, &response[CMD_POSITION_DATA+1], *configLengthP);
+        }
+    }
 
     return ret;
 }
 
 /*
- *Request the module state
- *
- *output:
- * -BLE_roleP:   pointer to the BLE role of the module
- * -BLE_actionP: pointer to the BLE action of the module
- * -InfoP:       pointer to the state info of the module
- * -LengthP:     pointer to the length of the state info of the module
+ *Set the output value of the local pin. Pin has to be configured first.
+ *See ProteusIII_GPIOLocalWriteConfig
  *
+ *input:
+ * -controlP: pointer to one or more pin controls
+ * -configLength: length of data configP controlP to
  *return true if request succeeded
  *       false otherwise
  */
-bool
-ProteusIII_GetState(ProteusIII_BLE_Role_t *BLE_roleP, ProteusIII_BLE_Action_t *BLE_actionP, uint8_t *InfoP, uint8_t *LengthP)
+bool ProteusIII_GPIOLocalWriteEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOControlBlock_t* controlP, uint16_t controlLength)
 {
     bool ret = false;
+    uint32_t generation = GPIOCache_Generation(handleP);
 
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GETSTATE_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_LOCAL_WRITE_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB]= (controlLength & 0x00FF);
+    frameP[CMD_POSITION_LENGTH_MSB]= (controlLength & 0xFF00) >> 8;
+    memcpy(&frameP[CMD_POSITION_DATA], controlP, controlLength);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GPIO_LOCAL_WRITE_CNF, NULL, 0);
+    if (SubmitFrame(handleP, frameP, &request))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-        askedForState = true;
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GETSTATE_CNF, CMD_Status_NoStatus, true))
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        if(ret)
         {
-            uint16_t length = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8);
-            *BLE_roleP = RxPacket[CMD_POSITION_DATA];
-            *BLE_actionP = RxPacket[CMD_POSITION_DATA + 1];
-            memcpy(InfoP, &RxPacket[CMD_POSITION_DATA + 2], length - 2);
-
-            *LengthP = length-2;
-            ret = true;
+            GPIOCache_Store(handleP, false, (uint8_t*)controlP, controlLength, generation, true);
         }
     }
-    askedForState = false;
+
     return ret;
 }
 
 /*
- *Request the current state of the driver
+ *Read the input of the pin. Pin has to be configured first.
+ *See ProteusIII_GPIOLocalWriteConfig
  *
+ *input:
+ * -GPIOToReadP: One or more pins to read.
+ * -amountGPIOToRead: amount of pins to read and therefore length of GPIOToRead
+ *output:
+ * -controlP: Pointer to controlBlock
+ * -controlLengthP: length of controlP
  *
- *return driver state
+ *note: pins cached by the GPIO cache are not requested, see ProteusIII_SetGPIOCacheEx
+ *
+ *return true if request succeeded
+ *       false otherwise
  */
-ProteusIII_States_t ProteusIII_GetDriverState()
+bool ProteusIII_GPIOLocalReadEx(ProteusIII_Handle_t *handleP, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP)
 {
-    return ble_state;
+    return GPIORead(handleP, false, GPIOToReadP, amountGPIOToRead, controlP, controlLengthP);
 }
 
 /*
- *Start scan
+ *Configure the remote GPIO of the module
  *
+ *input:
+ * -configP: pointer to one or more pin configurations
+ * -configLength: length of data configP points to
  *return true if request succeeded
  *       false otherwise
  */
-bool
-ProteusIII_Scanstart()
+bool ProteusIII_GPIORemoteWriteConfigEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOConfigBlock_t* configP, uint16_t configLength)
 {
     bool ret = false;
 
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_SCANSTART_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_REMOTE_WRITECONFIG_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB]= (configLength & 0x00FF);
+    frameP[CMD_POSITION_LENGTH_MSB]= (configLength & 0xFF00) >> 8;
+    memcpy(&frameP[CMD_POSITION_DATA], configP, configLength);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GPIO_REMOTE_WRITECONFIG_CNF, NULL, 0);
+    /* answered by the remote device over the air */
+    CommandQueue_SetFixedTimeout(&request);
+    if (SubmitFrame(handleP, frameP, &request))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_SCANSTART_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+    }
+
+    /* the configuration sets the pins anew */
+    uint16_t position = 0;
+    uint8_t GPIO_ID, value;
+    while (ParseGPIOBlock((uint8_t*)configP, configLength, &position, &GPIO_ID, &value))
+    {
+        GPIOCache_Invalidate(handleP, true, GPIO_ID);
     }
+
     return ret;
 }
 
 /*
- *Stop a scan
+ *Read the remote GPIO configuration of the module
  *
+ *output:
+ * -configP: pointer to one or more pin configurations
+ * -configLengthP: length of data configP points to
  *return true if request succeeded
  *       false otherwise
  */
-bool
-ProteusIII_Scanstop()
+bool ProteusIII_GPIORemoteReadConfigEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOConfigBlock_t* configP, uint16_t *configLengthP)
 {
     bool ret = false;
 
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_SCANSTOP_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_REMOTE_READCONFIG_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB]= 0;
+    frameP[CMD_POSITION_LENGTH_MSB]= 0;
+
+    uint8_t response[MAX_CMD_LENGTH];
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GPIO_REMOTE_READCONFIG_CNF, response, sizeof(response));
+    /* answered by the remote device over the air */
+    CommandQueue_SetFixedTimeout(&request);
+    if (SubmitFrame(handleP, frameP, &request))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_SCANSTOP_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        if(ret)
+        {
+            /* config length is packetlength - 1 (status byte)*/
+            *configLengthP = ((uint16_t) response[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) response[CMD_POSITION_LENGTH_MSB] << 8) - 1;
+            memcpy(configP, &response[CMD_POSITION_DATA+1], *configLengthP);
+        }
     }
+
     return ret;
 }
 
 /*
- *Request the scan results
- *
- *output:
- * -devicesP: pointer to scan result struct
+ *Set the output value of the remote pin. Pin has to be configured first.
+ *See ProteusIII_GPIORemoteWriteConfig
  *
+ *input:
+ * -controlP: pointer to one or more pin controls
+ * -configLength: length of data configP controlP to
  *return true if request succeeded
  *       false otherwise
  */
-bool
-ProteusIII_GetDevices(ProteusIII_GetDevices_t* devicesP)
+bool ProteusIII_GPIORemoteWriteEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOControlBlock_t* controlP, uint16_t controlLength)
 {
     bool ret = false;
+    uint32_t generation = GPIOCache_Generation(handleP);
 
-    ProteusIII_GetDevicesP = devicesP;
-    if (ProteusIII_GetDevicesP != NULL)
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
     {
-        ProteusIII_GetDevicesP->numberofdevices = 0;
+        return false;
     }
-
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GETDEVICES_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    frameP[CMD_POSITION_STX] = CMD_STX;
+    frameP[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_REMOTE_WRITE_REQ;
+    frameP[CMD_POSITION_LENGTH_LSB]= (controlLength & 0x00FF);
+    frameP[CMD_POSITION_LENGTH_MSB]= (controlLength & 0xFF00) >> 8;
+    memcpy(&frameP[CMD_POSITION_DATA], controlP, controlLength);
+
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ProteusIII_CMD_GPIO_REMOTE_WRITE_CNF, NULL, 0);
+    /* answered by the remote device over the air */
+    CommandQueue_SetFixedTimeout(&request);
+    if (SubmitFrame(handleP, frameP, &request))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GETDEVICES_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        if(ret)
+        {
+            GPIOCache_Store(handleP, true, (uint8_t*)controlP, controlLength, generation, true);
+        }
     }
 
-    ProteusIII_GetDevicesP = NULL;
-
     return ret;
 }
 
 /*
- *Connect to the BLE device with the corresponding BTMAC
+ *Read the input of the pins. Pin has to be configured first.
+ *See ProteusIII_GPIORemoteWriteConfig
  *
  *input:
- * -btmac: pointer to btmac
+ * -GPIOToReadP: One or more pins to read.
+ * -amountGPIOToRead: amount of pins to read and therefore length of GPIOToReadP
+ *output:
+ * -controlP: Pointer to controlBlock
+ * -controlLengthP: length of controlP
+ *
+ *note: pins cached by the GPIO cache are not requested, see ProteusIII_SetGPIOCacheEx
  *
  *return true if request succeeded
  *       false otherwise
  */
-bool ProteusIII_Connect(uint8_t *btmac)
+bool ProteusIII_GPIORemoteReadEx(ProteusIII_Handle_t *handleP, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP)
 {
-    bool ret = false;
+    return GPIORead(handleP, true, GPIOToReadP, amountGPIOToRead, controlP, controlLengthP);
+}
 
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_CONNECT_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)6;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-    memcpy(&CMD_Array[CMD_POSITION_DATA], btmac, 6);
+/*
+ *Request the instance whose callback is currently executed,
+ *callbacks use it to tell which module an event belongs to
+ *
+ *return driver instance, if called from a callback
+ *       NULL otherwise
+ */
+ProteusIII_Handle_t *ProteusIII_GetCallbackHandle()
+{
+    return callbackHandleP;
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+/*
+ *Set the callback receiving DATA_IND in the RX buffer of the driver, it replaces
+ *the RX callback of the callback configuration
+ *
+ *The payload stays valid after the callback returned, if the callback takes a
+ *reference to the buffer by FrameBuffer_Retain, release it by FrameBuffer_Release.
+ *
+ *input:
+ * -rxBufferCb: callback, NULL to use the RX callback of the callback configuration again
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool ProteusIII_SetRxBufferCallbackEx(ProteusIII_Handle_t *handleP, ProteusIII_RxBufferCallback rxBufferCb)
+{
+    if(handleP == NULL)
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(3000, ProteusIII_CMD_CONNECT_CNF, CMD_Status_Success, true);
+        return false;
     }
-    return ret;
+    handleP->rxBufferCb = rxBufferCb;
+    return true;
 }
 
 /*
- *Answer on a passkey request with a passkey to setup a connection
+ *Set the number of requests sent to the module before the first of them is confirmed
+ *
+ *Commands called concurrently, e.g. by several threads, are sent back to back up to
+ *this number, so that their round trips overlap. Confirmations are matched to the
+ *requests in the order of sending.
  *
  *input:
- * -passkey: pointer to passkey
+ * -depth: requests in flight, 1 (default) waits for each confirmation before the next request is sent
  *
- *return true if request succeeded
+ *note: use a depth above 1 only with a firmware that accepts requests while a
+ *      previous request is processed
+ *
+ *return true if succeeded
  *       false otherwise
  */
-bool ProteusIII_Passkey(uint8_t* passkey)
+bool ProteusIII_SetPipelineDepthEx(ProteusIII_Handle_t *handleP, uint8_t depth)
 {
-    bool ret = false;
-
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_PASSKEY_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)6;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-    memcpy(&CMD_Array[CMD_POSITION_DATA], passkey, 6);
+    if((handleP == NULL) || (depth == 0))
+    {
+        return false;
+    }
+    CommandQueue_SetDepth(&handleP->cmdQueue, depth);
+    return true;
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+/*
+ *Set the number of packets ProteusIII_StreamTransmitEx may pass to the module before
+ *the first of them was transmitted (default 1)
+ *
+ *note: use a window above 1 only with a firmware that buffers several data packets,
+ *      the window should not exceed the number of packets the module can buffer;
+ *      each packet waits for its DATA_CNF within the pipeline depth, see ProteusIII_SetPipelineDepthEx
+ *
+ *input:
+ * -window: data packets in flight, at least 1
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool ProteusIII_SetStreamWindowEx(ProteusIII_Handle_t *handleP, uint8_t window)
+{
+    if((handleP == NULL) || (window == 0))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+        return false;
+    }
+    pthread_mutex_lock(&handleP->streamMutex);
+    handleP->streamWindow = window;
+    pthread_cond_broadcast(&handleP->streamCond);
+    pthread_mutex_unlock(&handleP->streamMutex);
+    return true;
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_PASSKEY_CNF, CMD_Status_Success, true);
+/*
+ *Serve GPIO reads from the values of the pins the driver knows already
+ *
+ *The driver keeps the value of each local and remote pin read, written or indicated
+ *by GPIO_LOCAL_WRITE_IND and GPIO_REMOTE_WRITE_IND. ProteusIII_GPIOLocalReadEx and
+ *ProteusIII_GPIORemoteReadEx return the values younger than maxAge_ms without request
+ *and request only the other pins. Configuring a pin, a reset and, for the remote pins,
+ *a disconnection forget the values.
+ *
+ *note: inputs changed by the hardware are not indicated, their value is
+ *      up to maxAge_ms old
+ *
+ *input:
+ * -maxAge_ms: age up to which a value is read from the cache, 0 (default) requests every read
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool ProteusIII_SetGPIOCacheEx(ProteusIII_Handle_t *handleP, uint32_t maxAge_ms)
+{
+    if(handleP == NULL)
+    {
+        return false;
     }
-    return ret;
+    pthread_mutex_lock(&handleP->gpioMutex);
+    handleP->gpioMaxAge_ms = maxAge_ms;
+    pthread_mutex_unlock(&handleP->gpioMutex);
+    return true;
 }
 
 /*
- *Answer on a numeric comparison request
+ *Set the callback called when the module indicates a new value of a pin
+ *
+ *The callback is called by the callback thread for each pin of a GPIO_LOCAL_WRITE_IND
+ *or GPIO_REMOTE_WRITE_IND whose value differs from the value last reported, read or
+ *written, i.e. not for the writes of the application itself.
  *
  *input:
- * -keyIsOk: boolean to confirm if the key shown is correct
+ * -gpioChangeCb: callback, NULL to unsubscribe
+ * -contextP: passed to the callback
  *
- *return true if request succeeded
+ *return true if succeeded
  *       false otherwise
  */
-bool ProteusIII_NumericCompareConfirm(bool keyIsOk)
+bool ProteusIII_SetGPIOChangeCallbackEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOChangeCallback gpioChangeCb, void *contextP)
+{
+    if(handleP == NULL)
+    {
+        return false;
+    }
+    pthread_mutex_lock(&handleP->gpioMutex);
+    handleP->gpioChangeCb = gpioChangeCb;
+    handleP->gpioChangeContextP = contextP;
+    pthread_mutex_unlock(&handleP->gpioMutex);
+    return true;
+}
+
+#ifndef GLOBAL_NO_DEFAULT_TRANSPORT
+
+/**************************************
+ *   Functions of the default driver  *
+ *   instance, see ProteusIII_Init   *
+ **************************************/
+
+static ProteusIII_Handle_t *defaultHandleP = NULL;
+
+bool ProteusIII_Init(int baudrate, int rp, int wp, int bp, ProteusIII_CallbackConfig_t callbackConfig)
+{
+    if(defaultHandleP != NULL)
+    {
+        /* already initialized */
+        return false;
+    }
+
+    defaultHandleP = ProteusIII_InitEx(GetDefaultTransport(), baudrate, rp, wp, bp, callbackConfig);
+    return (defaultHandleP != NULL);
+}
+
+bool ProteusIII_Deinit(void)
+{
+    bool ret = ProteusIII_DeinitEx(defaultHandleP);
+    defaultHandleP = NULL;
+    return ret;
+}
+
+bool ProteusIII_SetRxBufferCallback(ProteusIII_RxBufferCallback rxBufferCb)
+{
+    return ProteusIII_SetRxBufferCallbackEx(defaultHandleP, rxBufferCb);
+}
+
+bool ProteusIII_SetPipelineDepth(uint8_t depth)
+{
+    return ProteusIII_SetPipelineDepthEx(defaultHandleP, depth);
+}
+
+bool ProteusIII_SetStreamWindow(uint8_t window)
+{
+    return ProteusIII_SetStreamWindowEx(defaultHandleP, window);
+}
+
+bool ProteusIII_SetGPIOCache(uint32_t maxAge_ms)
+{
+    return ProteusIII_SetGPIOCacheEx(defaultHandleP, maxAge_ms);
+}
+
+bool ProteusIII_SetGPIOChangeCallback(ProteusIII_GPIOChangeCallback gpioChangeCb, void *contextP)
+{
+    return ProteusIII_SetGPIOChangeCallbackEx(defaultHandleP, gpioChangeCb, contextP);
+}
+
+bool ProteusIII_PinReset(void)
+{
+    return (defaultHandleP != NULL) && ProteusIII_PinResetEx(defaultHandleP);
+}
+
+bool ProteusIII_Reset(void)
+{
+    return (defaultHandleP != NULL) && ProteusIII_ResetEx(defaultHandleP);
+}
+
+bool ProteusIII_Sleep()
+{
+    return (defaultHandleP != NULL) && ProteusIII_SleepEx(defaultHandleP);
+}
+
+bool ProteusIII_PinWakeup()
+{
+    return (defaultHandleP != NULL) && ProteusIII_PinWakeupEx(defaultHandleP);
+}
+
+bool ProteusIII_Connect(uint8_t *btmacP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_ConnectEx(defaultHandleP, btmacP);
+}
+
+bool ProteusIII_Disconnect()
+{
+    return (defaultHandleP != NULL) && ProteusIII_DisconnectEx(defaultHandleP);
+}
+
+bool ProteusIII_Scanstart()
+{
+    return (defaultHandleP != NULL) && ProteusIII_ScanstartEx(defaultHandleP);
+}
+
+bool ProteusIII_Scanstop()
+{
+    return (defaultHandleP != NULL) && ProteusIII_ScanstopEx(defaultHandleP);
+}
+
+bool ProteusIII_GetDevices(ProteusIII_GetDevices_t* devicesP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetDevicesEx(defaultHandleP, devicesP);
+}
+
+bool ProteusIII_ScanStreamStart(uint16_t interval_ms, uint32_t maxAge_ms)
 {
-    bool ret = false;
-    uint8_t lescStatus;
+    return ProteusIII_ScanStreamStartEx(defaultHandleP, interval_ms, maxAge_ms);
+}
 
-    /* If key is ok, status byte is "0x00"
-        ohterwise it's "0x01" */
-    if(keyIsOk)
-    {
-        lescStatus = 0x00;
-    }
-    else
-    {
-        lescStatus = 0x01;
-    }
+bool ProteusIII_ScanStreamStop(void)
+{
+    return ProteusIII_ScanStreamStopEx(defaultHandleP);
+}
 
-    /* fill CMD_ARRAY packet */
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_NUMERIC_COMP_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)1;
-    CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-    CMD_Array[CMD_POSITION_DATA] = lescStatus;
+bool ProteusIII_ScanFind(uint8_t *btmacP, ProteusIII_ScanDevice_t *deviceP)
+{
+    return ProteusIII_ScanFindEx(defaultHandleP, btmacP, deviceP);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+uint32_t ProteusIII_ScanTop(ProteusIII_ScanDevice_t *devicesP, uint32_t count)
+{
+    return ProteusIII_ScanTopEx(defaultHandleP, devicesP, count);
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_NUMERIC_COMP_CNF, CMD_Status_Success, true);
-    }
-    return ret;
+uint32_t ProteusIII_ScanAgeOut(uint32_t maxAge_ms)
+{
+    return ProteusIII_ScanAgeOutEx(defaultHandleP, maxAge_ms);
 }
 
-/*
- *Update the phy during an open connection
- *
- *input:
- * -phy: new phy
- *
- *return true if request succeeded
- *       false otherwise
- */
-bool ProteusIII_PhyUpdate(ProteusIII_Phy_t phy)
+uint32_t ProteusIII_ScanCount(void)
 {
-    bool ret = false;
+    return ProteusIII_ScanCountEx(defaultHandleP);
+}
 
-    if (ProteusIII_State_BLE_Channel_Open == ProteusIII_GetDriverState())
-    {
-        /* fill CMD_ARRAY packet */
-        CMD_Array[CMD_POSITION_STX] = CMD_STX;
-        CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_PHYUPDATE_REQ;
-        CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)1;
-        CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
-        CMD_Array[CMD_POSITION_DATA] = (uint8_t)phy;
+bool ProteusIII_ScanClear(void)
+{
+    return ProteusIII_ScanClearEx(defaultHandleP);
+}
 
-        if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-        {
-            /* now send CMD_ARRAY */
-            SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+bool ProteusIII_Transmit(uint8_t* PayloadP, uint16_t length)
+{
+    return (defaultHandleP != NULL) && ProteusIII_TransmitEx(defaultHandleP, PayloadP, length);
+}
 
-            /* wait for cnf */
-            ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_PHYUPDATE_CNF, CMD_Status_Success, true);
-        }
-    }
-    return ret;
+bool ProteusIII_TransmitAsync(uint8_t* PayloadP, uint16_t length, ProteusIII_CommandCallback cb, void* contextP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_TransmitAsyncEx(defaultHandleP, PayloadP, length, cb, contextP);
 }
 
-/*
- *Configure the local GPIO of the module
- *
- *input:
- * -configP: pointer to one or more pin configurations
- * -configLength: length of data configP points to
- *return true if request succeeded
- *       false otherwise
- */
-bool ProteusIII_GPIOLocalWriteConfig(ProteusIII_GPIOConfigBlock_t* configP, uint16_t configLength)
+bool ProteusIII_StreamTransmit(uint8_t* PayloadP, uint16_t length)
 {
-    bool ret = false;
+    return (defaultHandleP != NULL) && ProteusIII_StreamTransmitEx(defaultHandleP, PayloadP, length);
+}
 
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_LOCAL_WRITECONFIG_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB]= (configLength & 0x00FF);
-    CMD_Array[CMD_POSITION_LENGTH_MSB]= (configLength & 0xFF00) >> 8;
-    memcpy(&CMD_Array[CMD_POSITION_DATA], configP, configLength);
+bool ProteusIII_StreamFlush(void)
+{
+    return (defaultHandleP != NULL) && ProteusIII_StreamFlushEx(defaultHandleP);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+bool ProteusIII_SetMessageCallback(uint32_t maxMessageLength, ProteusIII_MessageCallback messageCb, void *contextP)
+{
+    return ProteusIII_SetMessageCallbackEx(defaultHandleP, maxMessageLength, messageCb, contextP);
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GPIO_LOCAL_WRITECONFIG_CNF, CMD_Status_Success, true);
-    }
+bool ProteusIII_SendMessage(uint8_t *messageP, uint32_t length)
+{
+    return ProteusIII_SendMessageEx(defaultHandleP, messageP, length);
+}
 
-    return ret;
+bool ProteusIII_Passkey(uint8_t* passkeyP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_PasskeyEx(defaultHandleP, passkeyP);
 }
 
-/*
- *Read the local GPIO configuration of the module
- *
- *output:
- * -configP: pointer to one or more pin configurations
- * -configLengthP: length of data configP points to
- *return true if request succeeded
- *       false otherwise
- */
-bool ProteusIII_GPIOLocalReadConfig(ProteusIII_GPIOConfigBlock_t* configP, uint16_t *configLengthP)
+bool ProteusIII_NumericCompareConfirm(bool keyIsOk)
 {
-    bool ret = false;
+    return (defaultHandleP != NULL) && ProteusIII_NumericCompareConfirmEx(defaultHandleP, keyIsOk);
+}
 
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_LOCAL_READCONFIG_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB]= 0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB]= 0;
+bool ProteusIII_PhyUpdate(ProteusIII_Phy_t phy)
+{
+    return (defaultHandleP != NULL) && ProteusIII_PhyUpdateEx(defaultHandleP, phy);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+ProteusIII_States_t ProteusIII_GetDriverState()
+{
+    return (defaultHandleP != NULL) ? ProteusIII_GetDriverStateEx(defaultHandleP) : ProteusIII_State_BLE_Invalid;
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GPIO_LOCAL_READCONFIG_CNF, CMD_Status_Success, true);
-        /* config length is packetlength - 1 (status byte)*/
-        *configLengthP = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1;
-        memcpy(configP, &RxPacket[CMD_POSITION_DATA+1], *configLengthP);
-    }
+bool ProteusIII_GPIOLocalWriteConfig(ProteusIII_GPIOConfigBlock_t* configP, uint16_t configLength)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GPIOLocalWriteConfigEx(defaultHandleP, configP, configLength);
+}
 
-    return ret;
+bool ProteusIII_GPIOLocalReadConfig(ProteusIII_GPIOConfigBlock_t* configP, uint16_t* configLengthP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GPIOLocalReadConfigEx(defaultHandleP, configP, configLengthP);
 }
 
-/*
- *Set the output value of the local pin. Pin has to be configured first.
- *See ProteusIII_GPIOLocalWriteConfig
- *
- *input:
- * -controlP: pointer to one or more pin controls
- * -configLength: length of data configP controlP to
- *return true if request succeeded
- *       false otherwise
- */
 bool ProteusIII_GPIOLocalWrite(ProteusIII_GPIOControlBlock_t* controlP, uint16_t controlLength)
 {
-    bool ret = false;
+    return (defaultHandleP != NULL) && ProteusIII_GPIOLocalWriteEx(defaultHandleP, controlP, controlLength);
+}
 
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_LOCAL_WRITE_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB]= (controlLength & 0x00FF);
-    CMD_Array[CMD_POSITION_LENGTH_MSB]= (controlLength & 0xFF00) >> 8;
-    memcpy(&CMD_Array[CMD_POSITION_DATA], controlP, controlLength);
+bool ProteusIII_GPIOLocalRead(uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GPIOLocalReadEx(defaultHandleP, GPIOToReadP, amountGPIOToRead, controlP, controlLengthP);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+bool ProteusIII_GPIORemoteWriteConfig(ProteusIII_GPIOConfigBlock_t* configP, uint16_t configLength)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GPIORemoteWriteConfigEx(defaultHandleP, configP, configLength);
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GPIO_LOCAL_WRITE_CNF, CMD_Status_Success, true);
-    }
+bool ProteusIII_GPIORemoteReadConfig(ProteusIII_GPIOConfigBlock_t* configP, uint16_t* configLengthP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GPIORemoteReadConfigEx(defaultHandleP, configP, configLengthP);
+}
 
-    return ret;
+bool ProteusIII_GPIORemoteWrite(ProteusIII_GPIOControlBlock_t* controlP, uint16_t controlLength)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GPIORemoteWriteEx(defaultHandleP, controlP, controlLength);
 }
 
-/*
- *Read the input of the pin. Pin has to be configured first.
- *See ProteusIII_GPIOLocalWriteConfig
- *
- *input:
- * -GPIOToReadP: One or more pins to read.
- * -amountGPIOToRead: amount of pins to read and therefore length of GPIOToRead
- *output:
- * -controlP: Pointer to controlBlock
- * -controlLengthP: length of controlP
- *return true if request succeeded
- *       false otherwise
- */
-bool ProteusIII_GPIOLocalRead(uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP)
+bool ProteusIII_GPIORemoteRead(uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP)
 {
-    bool ret = false;
+    return (defaultHandleP != NULL) && ProteusIII_GPIORemoteReadEx(defaultHandleP, GPIOToReadP, amountGPIOToRead, controlP, controlLengthP);
+}
 
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_LOCAL_READ_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB]= amountGPIOToRead + 1;
-    CMD_Array[CMD_POSITION_LENGTH_MSB]= 0;
-    CMD_Array[CMD_POSITION_DATA] = amountGPIOToRead;
-    memcpy(&CMD_Array[CMD_POSITION_DATA + 1], GPIOToReadP, amountGPIOToRead);
+bool ProteusIII_FactoryReset()
+{
+    return (defaultHandleP != NULL) && ProteusIII_FactoryResetEx(defaultHandleP);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+bool ProteusIII_Set(ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetEx(defaultHandleP, userSetting, ValueP, length);
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GPIO_LOCAL_READ_CNF, CMD_Status_Success, true);
-        /* config length is packetlength - 1 (status byte)*/
-        *controlLengthP = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1;
-        memcpy(controlP, &RxPacket[CMD_POSITION_DATA+1], *controlLengthP);
-    }
+bool ProteusIII_SetAsync(ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length, ProteusIII_CommandCallback cb, void* contextP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetAsyncEx(defaultHandleP, userSetting, ValueP, length, cb, contextP);
+}
 
-    return ret;
+bool ProteusIII_SetDeviceName(uint8_t *deviceNameP, uint8_t nameLength)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetDeviceNameEx(defaultHandleP, deviceNameP, nameLength);
 }
 
-/*
- *Configure the remote GPIO of the module
- *
- *input:
- * -configP: pointer to one or more pin configurations
- * -configLength: length of data configP points to
- *return true if request succeeded
- *       false otherwise
- */
-bool ProteusIII_GPIORemoteWriteConfig(ProteusIII_GPIOConfigBlock_t* configP, uint16_t configLength)
+bool ProteusIII_SetAdvertisingTimeout(uint16_t advTimeout)
 {
-    bool ret = false;
+    return (defaultHandleP != NULL) && ProteusIII_SetAdvertisingTimeoutEx(defaultHandleP, advTimeout);
+}
 
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_REMOTE_WRITECONFIG_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB]= (configLength & 0x00FF);
-    CMD_Array[CMD_POSITION_LENGTH_MSB]= (configLength & 0xFF00) >> 8;
-    memcpy(&CMD_Array[CMD_POSITION_DATA], configP, configLength);
+bool ProteusIII_SetCFGFlags(uint16_t cfgflags)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetCFGFlagsEx(defaultHandleP, cfgflags);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+bool ProteusIII_SetConnectionTiming(ProteusIII_ConnectionTiming_t connectionTiming)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetConnectionTimingEx(defaultHandleP, connectionTiming);
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GPIO_REMOTE_WRITECONFIG_CNF, CMD_Status_Success, true);
-    }
+bool ProteusIII_SetScanTiming(ProteusIII_ScanTiming_t scanTiming)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetScanTimingEx(defaultHandleP, scanTiming);
+}
 
-    return ret;
+bool ProteusIII_SetTXPower(ProteusIII_TXPower_t txpower)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetTXPowerEx(defaultHandleP, txpower);
 }
 
-/*
- *Read the remote GPIO configuration of the module
- *
- *output:
- * -configP: pointer to one or more pin configurations
- * -configLengthP: length of data configP points to
- *return true if request succeeded
- *       false otherwise
- */
-bool ProteusIII_GPIORemoteReadConfig(ProteusIII_GPIOConfigBlock_t* configP, uint16_t *configLengthP)
+bool ProteusIII_SetSecFlags(ProteusIII_SecFlags_t secflags)
 {
-    bool ret = false;
+    return (defaultHandleP != NULL) && ProteusIII_SetSecFlagsEx(defaultHandleP, secflags);
+}
 
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_REMOTE_READCONFIG_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB]= 0;
-    CMD_Array[CMD_POSITION_LENGTH_MSB]= 0;
+bool ProteusIII_SetBaudrateIndex(ProteusIII_BaudRate_t baudrate, ProteusIII_UartParity_t parity, bool flowcontrolEnable)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetBaudrateIndexEx(defaultHandleP, baudrate, parity, flowcontrolEnable);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+bool ProteusIII_SetStaticPasskey(uint8_t *staticPasskeyP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_SetStaticPasskeyEx(defaultHandleP, staticPasskeyP);
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GPIO_REMOTE_READCONFIG_CNF, CMD_Status_Success, true);
-        /* config length is packetlength - 1 (status byte)*/
-        *configLengthP = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1;
-        memcpy(configP, &RxPacket[CMD_POSITION_DATA+1], *configLengthP);
-    }
+bool ProteusIII_Get(ProteusIII_UserSettings_t userSetting, uint8_t *ResponseP, uint16_t *Response_LengthP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetEx(defaultHandleP, userSetting, ResponseP, Response_LengthP);
+}
 
-    return ret;
+bool ProteusIII_GetAsync(ProteusIII_UserSettings_t userSetting, ProteusIII_CommandCallback cb, void* contextP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetAsyncEx(defaultHandleP, userSetting, cb, contextP);
 }
 
-/*
- *Set the output value of the remote pin. Pin has to be configured first.
- *See ProteusIII_GPIORemoteWriteConfig
- *
- *input:
- * -controlP: pointer to one or more pin controls
- * -configLength: length of data configP controlP to
- *return true if request succeeded
- *       false otherwise
- */
-bool ProteusIII_GPIORemoteWrite(ProteusIII_GPIOControlBlock_t* controlP, uint16_t controlLength)
+bool ProteusIII_GetFWVersion(uint8_t *versionP)
 {
-    bool ret = false;
+    return (defaultHandleP != NULL) && ProteusIII_GetFWVersionEx(defaultHandleP, versionP);
+}
 
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_REMOTE_WRITE_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB]= (controlLength & 0x00FF);
-    CMD_Array[CMD_POSITION_LENGTH_MSB]= (controlLength & 0xFF00) >> 8;
-    memcpy(&CMD_Array[CMD_POSITION_DATA], controlP, controlLength);
+bool ProteusIII_GetDeviceName(uint8_t *deviceNameP, uint16_t *nameLengthP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetDeviceNameEx(defaultHandleP, deviceNameP, nameLengthP);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+bool ProteusIII_GetMAC(uint8_t *MacP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetMACEx(defaultHandleP, MacP);
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GPIO_REMOTE_WRITE_CNF, CMD_Status_Success, true);
-    }
+bool ProteusIII_GetBTMAC(uint8_t *BTMacP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetBTMACEx(defaultHandleP, BTMacP);
+}
 
-    return ret;
+bool ProteusIII_GetAdvertisingTimeout(uint16_t *advTimeoutP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetAdvertisingTimeoutEx(defaultHandleP, advTimeoutP);
 }
 
-/*
- *Read the input of the pins. Pin has to be configured first.
- *See ProteusIII_GPIORemoteWriteConfig
- *
- *input:
- * -GPIOToReadP: One or more pins to read.
- * -amountGPIOToRead: amount of pins to read and therefore length of GPIOToReadP
- *output:
- * -controlP: Pointer to controlBlock
- * -controlLengthP: length of controlP
- *return true if request succeeded
- *       false otherwise
- */
-bool ProteusIII_GPIORemoteRead(uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP)
+bool ProteusIII_GetCFGFlags(uint16_t *cfgflags)
 {
-    bool ret = false;
+    return (defaultHandleP != NULL) && ProteusIII_GetCFGFlagsEx(defaultHandleP, cfgflags);
+}
+
+bool ProteusIII_GetConnectionTiming(ProteusIII_ConnectionTiming_t *connectionTimingP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetConnectionTimingEx(defaultHandleP, connectionTimingP);
+}
 
-    CMD_Array[CMD_POSITION_STX] = CMD_STX;
-    CMD_Array[CMD_POSITION_CMD] = ProteusIII_CMD_GPIO_REMOTE_READ_REQ;
-    CMD_Array[CMD_POSITION_LENGTH_LSB]= amountGPIOToRead + 1;
-    CMD_Array[CMD_POSITION_LENGTH_MSB]= 0;
-    CMD_Array[CMD_POSITION_DATA] = amountGPIOToRead;
-    memcpy(&CMD_Array[CMD_POSITION_DATA + 1], GPIOToReadP, amountGPIOToRead);
+bool ProteusIII_GetScanTiming(ProteusIII_ScanTiming_t *scanTimingP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetScanTimingEx(defaultHandleP, scanTimingP);
+}
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
+bool ProteusIII_GetTXPower(ProteusIII_TXPower_t *txpowerP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetTXPowerEx(defaultHandleP, txpowerP);
+}
 
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ProteusIII_CMD_GPIO_REMOTE_READ_CNF, CMD_Status_Success, true);
-        /* config length is packetlength - 1 (status byte)*/
-        *controlLengthP = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1;
-        memcpy(controlP, &RxPacket[CMD_POSITION_DATA+1], *controlLengthP);
-    }
+bool ProteusIII_GetSecFlags(ProteusIII_SecFlags_t *secflagsP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetSecFlagsEx(defaultHandleP, secflagsP);
+}
 
-    return ret;
+bool ProteusIII_GetBaudrateIndex(ProteusIII_BaudRate_t *baudrateP, ProteusIII_UartParity_t *parityP, bool *flowcontrolEnableP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetBaudrateIndexEx(defaultHandleP, baudrateP, parityP, flowcontrolEnableP);
+}
+
+bool ProteusIII_GetState(ProteusIII_BLE_Role_t *BLE_roleP, ProteusIII_BLE_Action_t *BLE_actionP, uint8_t *InfoP, uint8_t *LengthP)
+{
+    return (defaultHandleP != NULL) && ProteusIII_GetStateEx(defaultHandleP, BLE_roleP, BLE_actionP, InfoP, LengthP);
 }
 
+#endif // GLOBAL_NO_DEFAULT_TRANSPORT
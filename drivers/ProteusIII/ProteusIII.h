@@ -55,6 +55,18 @@ typedef struct ProteusIII_GetDevices_t {
     ProteusIII_Device_t devices[MAX_NUMBER_OF_DEVICES];
 } ProteusIII_GetDevices_t;
 
+/* device of the scan index, see ProteusIII_ScanStreamStart */
+typedef struct ProteusIII_ScanDevice_t {
+    uint8_t btmac[6];
+    int8_t rssi;                /* RSSI of the last scan result */
+    int8_t rssiAverage;         /* exponentially weighted mean of the RSSI */
+    int8_t txpower;
+    uint8_t devicenamelength;
+    uint8_t devicename[32];     /* last name advertised */
+    uint32_t age_ms;            /* time since the last scan result, when the device was read */
+    uint32_t results;           /* scan results of the device */
+} ProteusIII_ScanDevice_t;
+
 typedef enum ProteusIII_DisplayPasskeyAction_t{
     ProteusIII_DisplayPasskeyAction_NoAction      = (uint8_t)0x00,
     ProteusIII_DisplayPasskeyAction_PleaseConfirm = (uint8_t)0x01
@@ -249,7 +261,9 @@ typedef enum ProteusIII_Phy_t
 	ProteusIII_Phy_125kBit_LECoded = 0x04,
 } ProteusIII_Phy_t;
 
-/* Callback definition */
+/* Callback definition
+ * The callbacks are called by a callback thread of the driver instance, not by its RX thread,
+ * so they may use the functions of the driver, e.g. ProteusIII_Passkey in the PasskeyCallback */
 
 typedef void (*RxCallback)(uint8_t* payload, uint16_t payload_length, uint8_t* BTMAC, int8_t rssi);
 typedef void (*ConnectCallback)(uint8_t* BTMAC);
@@ -260,6 +274,23 @@ typedef void (*DisconnectCallback)();
 typedef void (*ChannelopenCallback)(uint8_t* BTMAC, uint16_t max_payload);
 typedef void (*PhyupdateCallback)(uint8_t* BTMAC, uint8_t phy_rx, uint8_t phy_tx);
 
+/* DATA_IND without copy: payload and BTMAC point into bufferP, a struct FrameBuffer_t
+ * of global.h, take a reference by FrameBuffer_Retain to keep them after returning */
+struct FrameBuffer_t;
+typedef void (*ProteusIII_RxBufferCallback)(struct FrameBuffer_t *bufferP, uint8_t* payload, uint16_t payload_length, uint8_t* BTMAC, int8_t rssi);
+
+/* completion of an asynchronous command (*Async functions), dataP holds the data of the answer,
+ * e.g. the value of a user setting, and is valid until the callback returns */
+typedef void (*ProteusIII_CommandCallback)(bool success, uint8_t* dataP, uint16_t length, void* contextP);
+
+/* new value of a pin indicated by the module, remote is true for the pins of the
+ * connected device, see ProteusIII_SetGPIOChangeCallbackEx */
+typedef void (*ProteusIII_GPIOChangeCallback)(bool remote, ProteusIII_GPIO_t GPIO_ID, uint8_t value, void* contextP);
+
+/* message of the connected device reassembled from its DATA_IND, messageP is valid
+ * until the callback returns, see ProteusIII_SetMessageCallbackEx */
+typedef void (*ProteusIII_MessageCallback)(uint8_t* messageP, uint32_t length, void* contextP);
+
 typedef struct ProteusIII_CallbackConfig_t {
     RxCallback              rxCb;
     ConnectCallback         connectCp;
@@ -271,9 +302,16 @@ typedef struct ProteusIII_CallbackConfig_t {
     PhyupdateCallback       phyUpdateCb;
 } ProteusIII_CallbackConfig_t;
 
+/* driver instance, see ProteusIII_InitEx */
+typedef struct ProteusIII_Handle_t ProteusIII_Handle_t;
+struct Transport_t;
+
 
 extern bool ProteusIII_Init(int baudrate, int rp, int wp, int bp, ProteusIII_CallbackConfig_t callbackConfig);
 extern bool ProteusIII_Deinit(void);
+extern bool ProteusIII_SetRxBufferCallback(ProteusIII_RxBufferCallback rxBufferCb);
+extern bool ProteusIII_SetPipelineDepth(uint8_t depth);
+extern bool ProteusIII_SetStreamWindow(uint8_t window);
 
 extern bool ProteusIII_PinReset(void);
 extern bool ProteusIII_Reset(void);
@@ -288,7 +326,21 @@ extern bool ProteusIII_Scanstart();
 extern bool ProteusIII_Scanstop();
 extern bool ProteusIII_GetDevices(ProteusIII_GetDevices_t* devicesP);
 
+/* continuous scan collecting the devices in an index keyed by BTMAC */
+extern bool ProteusIII_ScanStreamStart(uint16_t interval_ms, uint32_t maxAge_ms);
+extern bool ProteusIII_ScanStreamStop(void);
+extern bool ProteusIII_ScanFind(uint8_t *btmacP, ProteusIII_ScanDevice_t *deviceP);
+extern uint32_t ProteusIII_ScanTop(ProteusIII_ScanDevice_t *devicesP, uint32_t count);
+extern uint32_t ProteusIII_ScanAgeOut(uint32_t maxAge_ms);
+extern uint32_t ProteusIII_ScanCount(void);
+extern bool ProteusIII_ScanClear(void);
+
 extern bool ProteusIII_Transmit(uint8_t* PayloadP, uint16_t length);
+extern bool ProteusIII_TransmitAsync(uint8_t* PayloadP, uint16_t length, ProteusIII_CommandCallback cb, void* contextP);
+extern bool ProteusIII_StreamTransmit(uint8_t* PayloadP, uint16_t length);
+extern bool ProteusIII_StreamFlush(void);
+extern bool ProteusIII_SetMessageCallback(uint32_t maxMessageLength, ProteusIII_MessageCallback messageCb, void *contextP);
+extern bool ProteusIII_SendMessage(uint8_t *messageP, uint32_t length);
 
 extern bool ProteusIII_Passkey(uint8_t* passkeyP);
 extern bool ProteusIII_NumericCompareConfirm(bool keyIsOk);
@@ -308,12 +360,17 @@ extern bool ProteusIII_GPIORemoteReadConfig(ProteusIII_GPIOConfigBlock_t* config
 extern bool ProteusIII_GPIORemoteWrite(ProteusIII_GPIOControlBlock_t* controlP, uint16_t controlLength);
 extern bool ProteusIII_GPIORemoteRead(uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP);
 
+/* cache of the pins serving the reads above, and notification of indicated pin changes */
+extern bool ProteusIII_SetGPIOCache(uint32_t maxAge_ms);
+extern bool ProteusIII_SetGPIOChangeCallback(ProteusIII_GPIOChangeCallback gpioChangeCb, void *contextP);
+
 /* functions that write the non-volatile settings in the flash,
  * after modification of any non-volatile setting, the module must be reset such that the update takes effect
  * IMPORTANT: use them only in rare cases, since flash can be updated only a limited number times
  */
 extern bool ProteusIII_FactoryReset();
 extern bool ProteusIII_Set(ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length);
+extern bool ProteusIII_SetAsync(ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length, ProteusIII_CommandCallback cb, void* contextP);
 extern bool ProteusIII_SetDeviceName(uint8_t *deviceNameP, uint8_t nameLength);
 extern bool ProteusIII_SetAdvertisingTimeout(uint16_t advTimeout);
 extern bool ProteusIII_SetCFGFlags(uint16_t cfgflags);
@@ -326,6 +383,7 @@ extern bool ProteusIII_SetStaticPasskey(uint8_t *staticPasskeyP);
 
 /* read the non-volatile settings */
 extern bool ProteusIII_Get(ProteusIII_UserSettings_t userSetting, uint8_t *ResponseP, uint16_t *Response_LengthP);
+extern bool ProteusIII_GetAsync(ProteusIII_UserSettings_t userSetting, ProteusIII_CommandCallback cb, void* contextP);
 extern bool ProteusIII_GetFWVersion(uint8_t *versionP);
 extern bool ProteusIII_GetDeviceName(uint8_t *deviceNameP, uint16_t *nameLengthP);
 extern bool ProteusIII_GetMAC(uint8_t *MacP);
@@ -340,6 +398,91 @@ extern bool ProteusIII_GetBaudrateIndex(ProteusIII_BaudRate_t *baudrateP, Proteu
 extern bool ProteusIII_GetStaticPasskey(uint8_t *staticPasskeyP);
 extern bool ProteusIII_GetState(ProteusIII_BLE_Role_t *BLE_roleP, ProteusIII_BLE_Action_t *BLE_actionP, uint8_t *InfoP, uint8_t *LengthP);
 
+/* the functions above act on the default driver instance created by ProteusIII_Init,
+ * the functions below act on the driver instance given by handleP, so that several
+ * modules can be used side by side on different transports */
+extern ProteusIII_Handle_t *ProteusIII_InitEx(struct Transport_t *transportP, int baudrate, int rp, int wp, int bp, ProteusIII_CallbackConfig_t callbackConfig);
+extern bool ProteusIII_DeinitEx(ProteusIII_Handle_t *handleP);
+extern ProteusIII_Handle_t *ProteusIII_GetCallbackHandle();
+extern bool ProteusIII_SetRxBufferCallbackEx(ProteusIII_Handle_t *handleP, ProteusIII_RxBufferCallback rxBufferCb);
+extern bool ProteusIII_SetPipelineDepthEx(ProteusIII_Handle_t *handleP, uint8_t depth);
+extern bool ProteusIII_SetStreamWindowEx(ProteusIII_Handle_t *handleP, uint8_t window);
+
+extern bool ProteusIII_PinResetEx(ProteusIII_Handle_t *handleP);
+extern bool ProteusIII_ResetEx(ProteusIII_Handle_t *handleP);
+
+extern bool ProteusIII_SleepEx(ProteusIII_Handle_t *handleP);
+extern bool ProteusIII_PinWakeupEx(ProteusIII_Handle_t *handleP);
+
+extern bool ProteusIII_ConnectEx(ProteusIII_Handle_t *handleP, uint8_t *btmacP);
+extern bool ProteusIII_DisconnectEx(ProteusIII_Handle_t *handleP);
+
+extern bool ProteusIII_ScanstartEx(ProteusIII_Handle_t *handleP);
+extern bool ProteusIII_ScanstopEx(ProteusIII_Handle_t *handleP);
+extern bool ProteusIII_GetDevicesEx(ProteusIII_Handle_t *handleP, ProteusIII_GetDevices_t* devicesP);
+
+extern bool ProteusIII_ScanStreamStartEx(ProteusIII_Handle_t *handleP, uint16_t interval_ms, uint32_t maxAge_ms);
+extern bool ProteusIII_ScanStreamStopEx(ProteusIII_Handle_t *handleP);
+extern bool ProteusIII_ScanFindEx(ProteusIII_Handle_t *handleP, uint8_t *btmacP, ProteusIII_ScanDevice_t *deviceP);
+extern uint32_t ProteusIII_ScanTopEx(ProteusIII_Handle_t *handleP, ProteusIII_ScanDevice_t *devicesP, uint32_t count);
+extern uint32_t ProteusIII_ScanAgeOutEx(ProteusIII_Handle_t *handleP, uint32_t maxAge_ms);
+extern uint32_t ProteusIII_ScanCountEx(ProteusIII_Handle_t *handleP);
+extern bool ProteusIII_ScanClearEx(ProteusIII_Handle_t *handleP);
+
+extern bool ProteusIII_TransmitEx(ProteusIII_Handle_t *handleP, uint8_t* PayloadP, uint16_t length);
+extern bool ProteusIII_TransmitAsyncEx(ProteusIII_Handle_t *handleP, uint8_t* PayloadP, uint16_t length, ProteusIII_CommandCallback cb, void* contextP);
+extern bool ProteusIII_StreamTransmitEx(ProteusIII_Handle_t *handleP, uint8_t* PayloadP, uint16_t length);
+extern bool ProteusIII_StreamFlushEx(ProteusIII_Handle_t *handleP);
+extern bool ProteusIII_SetMessageCallbackEx(ProteusIII_Handle_t *handleP, uint32_t maxMessageLength, ProteusIII_MessageCallback messageCb, void *contextP);
+extern bool ProteusIII_SendMessageEx(ProteusIII_Handle_t *handleP, uint8_t *messageP, uint32_t length);
+
+extern bool ProteusIII_PasskeyEx(ProteusIII_Handle_t *handleP, uint8_t* passkeyP);
+extern bool ProteusIII_NumericCompareConfirmEx(ProteusIII_Handle_t *handleP, bool keyIsOk);
+
+extern bool ProteusIII_PhyUpdateEx(ProteusIII_Handle_t *handleP, ProteusIII_Phy_t phy);
+
+extern ProteusIII_States_t ProteusIII_GetDriverStateEx(ProteusIII_Handle_t *handleP);
+
+extern bool ProteusIII_GPIOLocalWriteConfigEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOConfigBlock_t* configP, uint16_t configLength);
+extern bool ProteusIII_GPIOLocalReadConfigEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOConfigBlock_t* configP, uint16_t* configLengthP);
+extern bool ProteusIII_GPIOLocalWriteEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOControlBlock_t* controlP, uint16_t controlLength);
+extern bool ProteusIII_GPIOLocalReadEx(ProteusIII_Handle_t *handleP, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP);
+
+extern bool ProteusIII_GPIORemoteWriteConfigEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOConfigBlock_t* configP, uint16_t configLength);
+extern bool ProteusIII_GPIORemoteReadConfigEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOConfigBlock_t* configP, uint16_t* configLengthP);
+extern bool ProteusIII_GPIORemoteWriteEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOControlBlock_t* controlP, uint16_t controlLength);
+extern bool ProteusIII_GPIORemoteReadEx(ProteusIII_Handle_t *handleP, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ProteusIII_GPIOControlBlock_t* controlP, uint16_t* controlLengthP);
+extern bool ProteusIII_SetGPIOCacheEx(ProteusIII_Handle_t *handleP, uint32_t maxAge_ms);
+extern bool ProteusIII_SetGPIOChangeCallbackEx(ProteusIII_Handle_t *handleP, ProteusIII_GPIOChangeCallback gpioChangeCb, void *contextP);
+
+extern bool ProteusIII_FactoryResetEx(ProteusIII_Handle_t *handleP);
+extern bool ProteusIII_SetEx(ProteusIII_Handle_t *handleP, ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length);
+extern bool ProteusIII_SetAsyncEx(ProteusIII_Handle_t *handleP, ProteusIII_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length, ProteusIII_CommandCallback cb, void* contextP);
+extern bool ProteusIII_SetDeviceNameEx(ProteusIII_Handle_t *handleP, uint8_t *deviceNameP, uint8_t nameLength);
+extern bool ProteusIII_SetAdvertisingTimeoutEx(ProteusIII_Handle_t *handleP, uint16_t advTimeout);
+extern bool ProteusIII_SetCFGFlagsEx(ProteusIII_Handle_t *handleP, uint16_t cfgflags);
+extern bool ProteusIII_SetConnectionTimingEx(ProteusIII_Handle_t *handleP, ProteusIII_ConnectionTiming_t connectionTiming);
+extern bool ProteusIII_SetScanTimingEx(ProteusIII_Handle_t *handleP, ProteusIII_ScanTiming_t scanTiming);
+extern bool ProteusIII_SetTXPowerEx(ProteusIII_Handle_t *handleP, ProteusIII_TXPower_t txpower);
+extern bool ProteusIII_SetSecFlagsEx(ProteusIII_Handle_t *handleP, ProteusIII_SecFlags_t secflags);
+extern bool ProteusIII_SetBaudrateIndexEx(ProteusIII_Handle_t *handleP, ProteusIII_BaudRate_t baudrate, ProteusIII_UartParity_t parity, bool flowcontrolEnable);
+extern bool ProteusIII_SetStaticPasskeyEx(ProteusIII_Handle_t *handleP, uint8_t *staticPasskeyP);
+
+extern bool ProteusIII_GetEx(ProteusIII_Handle_t *handleP, ProteusIII_UserSettings_t userSetting, uint8_t *ResponseP, uint16_t *Response_LengthP);
+extern bool ProteusIII_GetAsyncEx(ProteusIII_Handle_t *handleP, ProteusIII_UserSettings_t userSetting, ProteusIII_CommandCallback cb, void* contextP);
+extern bool ProteusIII_GetFWVersionEx(ProteusIII_Handle_t *handleP, uint8_t *versionP);
+extern bool ProteusIII_GetDeviceNameEx(ProteusIII_Handle_t *handleP, uint8_t *deviceNameP, uint16_t *nameLengthP);
+extern bool ProteusIII_GetMACEx(ProteusIII_Handle_t *handleP, uint8_t *MacP);
+extern bool ProteusIII_GetBTMACEx(ProteusIII_Handle_t *handleP, uint8_t *BTMacP);
+extern bool ProteusIII_GetAdvertisingTimeoutEx(ProteusIII_Handle_t *handleP, uint16_t *advTimeoutP);
+extern bool ProteusIII_GetCFGFlagsEx(ProteusIII_Handle_t *handleP, uint16_t *cfgflags);
+extern bool ProteusIII_GetConnectionTimingEx(ProteusIII_Handle_t *handleP, ProteusIII_ConnectionTiming_t *connectionTimingP);
+extern bool ProteusIII_GetScanTimingEx(ProteusIII_Handle_t *handleP, ProteusIII_ScanTiming_t *scanTimingP);
+extern bool ProteusIII_GetTXPowerEx(ProteusIII_Handle_t *handleP, ProteusIII_TXPower_t *txpowerP);
+extern bool ProteusIII_GetSecFlagsEx(ProteusIII_Handle_t *handleP, ProteusIII_SecFlags_t *secflagsP);
+extern bool ProteusIII_GetBaudrateIndexEx(ProteusIII_Handle_t *handleP, ProteusIII_BaudRate_t *baudrateP, ProteusIII_UartParity_t *parityP, bool *flowcontrolEnableP);
+extern bool ProteusIII_GetStateEx(ProteusIII_Handle_t *handleP, ProteusIII_BLE_Role_t *BLE_roleP, ProteusIII_BLE_Action_t *BLE_actionP, uint8_t *InfoP, uint8_t *LengthP);
+
 #endif // _ProteusIII_defined
 #ifdef __cplusplus
 }
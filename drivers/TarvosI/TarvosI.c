@@ -37,6 +37,7 @@
 
 #define CMD_WAIT_TIME 500
 #define MAX_PAYLOAD_LENGTH 128
+#define MAX_GETMULTIPLE_LENGTH (MAX_PAYLOAD_LENGTH - 2)  /* the GET_CNF starts with memory position and length */
 #define MAX_DATA_BUFFER 255
 #define CHANNELINVALID -1
 #define RSSIINVALID -128
@@ -138,9 +139,10 @@ typedef struct
  *     Static function declarations   *
  **************************************/
 
-static void HandleRxPacket(uint8_t* RxBuffer);                                                                                  /* RX packet interpreter */
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                                                  /* RX packet interpreter */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);   /* wait for response, when a command was sent to the TarvosI */
-static bool FillChecksum(uint8_t* array, uint8_t length);                                                                       /* add the CS needed to finalize the command */
+static void ClearCNF();
+static bool CompareConfiguration(TarvosI_Configuration_t* config, uint8_t config_length, bool* changed); /* find the settings to be written */
 static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosI_AddressMode_t addrmode);
 static int8_t CalculateRSSIValue(uint8_t rxLevel);
 
@@ -148,22 +150,26 @@ static int8_t CalculateRSSIValue(uint8_t rxLevel);
  *          Static variables          *
  **************************************/
 
-CMD_Frame_t RxPacket;                       /* data buffer for RX */
-bool AbortUartRxThread;                     /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                     /* boolean to reset the UART RX thread */
+/* command frames of the module: STX, CMD, 8 bit LEN, DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 1, HandleRxPacket };
 
-pthread_t thread_read;
+static CMD_Frame_t RxPacket;                /* data buffer for RX */
+static int rxThreadEvent = -1;                  /* eventfd to reset or abort the UART RX thread */
+
+static pthread_t thread_read;
 
 #define CMDCONFIRMATIONARRAY_LENGTH 2
 
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
-US_Confirmation_t usConfirmation;           /* variable used to check if GET function was successfull */
-uint8_t channelVolatile = CHANNELINVALID;   /* variable used to check if setting the channel was successfull */
+static CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
+static pthread_mutex_t cmdConfirmation_mutex = PTHREAD_MUTEX_INITIALIZER;  /* protects cmdConfirmation_array */
+static pthread_cond_t cmdConfirmation_cond = PTHREAD_COND_INITIALIZER;     /* signalled when a confirmation was stored */
+static US_Confirmation_t usConfirmation;    /* variable used to check if GET function was successfull */
+static uint8_t channelVolatile = CHANNELINVALID; /* variable used to check if setting the channel was successfull */
 
-int reset_pin;                              /* reset pin number */
+static int reset_pin;                       /* reset pin number */
 
-void(*RXcallback)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t);       /* callback function */
-TarvosI_AddressMode_t addressmode = AddressMode_0;                        /* initial address mode */
+static void(*RXcallback)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t); /* callback function */
+static TarvosI_AddressMode_t addressmode = AddressMode_0;                 /* initial address mode */
 
 
 /**************************************
@@ -171,94 +177,16 @@ TarvosI_AddressMode_t addressmode = AddressMode_0;                        /* ini
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint8_t RxByteCounter = 0;
-    uint8_t BytesToReceive = 0;
-    uint8_t readBuffer;
     static uint8_t RxBuffer[sizeof(CMD_Frame_t)]; /* data buffer for RX */
-
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    FrameCodec_t codec;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
-    while(1)
-    {
-        /* wait for 10ms, then check if new RX data is available */
-        delay (10);
-
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
-
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
-
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
 
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for start byte of frame */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field */
-                    RxByteCounter++;
-                    BytesToReceive = (RxBuffer[RxByteCounter - 1] + 4); /* len + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
-    }
+    FrameCodec_Init(&codec, &frameProtocol, RxBuffer, sizeof(RxBuffer), NULL);
+    FrameCodec_RxLoop(&codec, GetDefaultTransport(), rxThreadEvent);
     return 0;
 }
 
@@ -283,20 +211,35 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8
     /* set RX callback function */
     RXcallback = RXcb;
 
+    /* confirmations are waited for with CLOCK_MONOTONIC deadlines */
+    if(!InitMonotonicCond(&cmdConfirmation_cond))
+    {
+        fprintf(stdout, "Failed to initialize confirmation condition\n");
+        TarvosI_Deinit();
+        return false;
+    }
+
+    /* create the event to reset and abort the RX thread */
+    rxThreadEvent = RxThreadEvent_Create();
+    if(rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        TarvosI_Deinit();
+        return false;
+    }
+
     /* start RX thread */
     if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
     {
         fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
         TarvosI_Deinit();
         return false;
     }
 
-    /* reset module*/
-    if(TarvosI_PinReset())
-    {
-        delay(300);
-    }
-    else
+    /* reset module, it accepts requests as soon as it sent its SETMODE_CNF */
+    if(false == TarvosI_PinReset())
     {
         fprintf(stdout, "Pin Reset failed\n");
         TarvosI_Deinit();
@@ -321,7 +264,7 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8
 
 
 /* interprete the valid received data packet */
-static void HandleRxPacket(uint8_t*RxBuffer)
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer)
 {
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
@@ -532,25 +475,30 @@ static void HandleRxPacket(uint8_t*RxBuffer)
     }
 
     int i = 0;
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
         if(cmdConfirmation_array[i].cmd == CNFINVALID)
         {
             cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
             cmdConfirmation_array[i].status = cmdConfirmation.status;
+            pthread_cond_broadcast(&cmdConfirmation_cond);
             break;
         }
     }
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 /* function that waits for the return value of TarvosI (*_CNF), when a command (*_REQ) was sent before */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
+    struct timespec deadline;
+    int waitResult = 0;
     int i = 0;
 
+    GetDeadline(&deadline, max_time_ms);
+
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     if(reset_confirmstate)
     {
         for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
@@ -564,43 +512,38 @@ static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Statu
         {
             if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
             {
-                return (cmdConfirmation_array[i].status == expectedStatus);
+                bool ret = (cmdConfirmation_array[i].status == expectedStatus);
+                pthread_mutex_unlock(&cmdConfirmation_mutex);
+                return ret;
             }
         }
 
-        if (count >= max_count)
+        if (waitResult == ETIMEDOUT)
         {
             /* received no correct response within timeout */
+            pthread_mutex_unlock(&cmdConfirmation_mutex);
             return false;
         }
 
-        /* wait */
-        count++;
-        delay(time_step_ms);
+        /* sleep until HandleRxPacket stored a confirmation */
+        waitResult = pthread_cond_timedwait(&cmdConfirmation_cond, &cmdConfirmation_mutex, &deadline);
     }
     return true;
 }
 
-/* function to add the checksum at the end of the data packet */
-static bool FillChecksum(uint8_t* array, uint8_t length)
+/* function that discards all received confirmations, call it before the request is sent
+ * so that a fast confirmation can not be discarded by Wait4CNF */
+static void ClearCNF()
 {
-    bool ret = false;
+    int i = 0;
 
-    if ((length >= 4) && (array[0] == CMD_STX))
+    pthread_mutex_lock(&cmdConfirmation_mutex);
+    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
-        uint8_t checksum = 0;
-        uint8_t payload_length = array[2];
-        int i = 0;
-        for (i = 0;
-                i < payload_length + 3;
-                i++)
-        {
-            checksum ^= array[i];
-        }
-        array[payload_length + 3] = checksum;
-        ret = true;
+        cmdConfirmation_array[i].status = CMD_Status_Invalid;
+        cmdConfirmation_array[i].cmd = CNFINVALID;
     }
-    return ret;
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 /* function to calculate the rssi value from the rx level */
@@ -669,7 +612,6 @@ bool TarvosI_Init(int baudrate, int rp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uin
      */
     reset_pin = rp;
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
 
 	/* empty the UART buffers */
     FlushSerial();
@@ -691,7 +633,13 @@ bool TarvosI_Deinit()
     DeinitSerial();
 
     /* abort RX thread */
-    AbortUartRxThread = true;
+    if(rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(thread_read, NULL);
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
+    }
 
     /* deinit pins */
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
@@ -717,7 +665,8 @@ bool TarvosI_PinReset()
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
     FlushSerial();
-    ResetUartRxThread = true;
+    RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_RESET);
+    ClearCNF();
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
 
@@ -725,7 +674,7 @@ bool TarvosI_PinReset()
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SETMODE_CNF, CMD_Status_Success, true);
+    return Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SETMODE_CNF, CMD_Status_Success, false);
 }
 
 /*
@@ -743,13 +692,14 @@ bool TarvosI_Reset()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TarvosI_CMD_RESET_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SETMODE_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SETMODE_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -801,16 +751,17 @@ bool TarvosI_Get(TarvosI_UserSettings_t us, uint8_t* response, uint8_t* response
     }
     break;
     }
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         usConfirmation.memoryPosition = us;
         usConfirmation.lengthGetRequest = CMD_ARRAY[4];
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_GET_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_GET_CNF, CMD_Status_Success, false))
         {
             int length = RxPacket.Length - 2;
             memcpy(response,&RxPacket.Data[2],length);
@@ -848,16 +799,17 @@ bool TarvosI_GetMultiple(uint8_t startAddress, uint8_t lengthToRead, uint8_t *re
     CMD_ARRAY[3] = startAddress;
     CMD_ARRAY[4] = lengthToRead;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         usConfirmation.memoryPosition = startAddress;
         usConfirmation.lengthGetRequest = CMD_ARRAY[4];
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_GET_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_GET_CNF, CMD_Status_Success, false))
         {
             int length = RxPacket.Length - 2;
             memcpy(response,&RxPacket.Data[2],length);
@@ -896,13 +848,14 @@ bool TarvosI_Set(TarvosI_UserSettings_t us, uint8_t* value, uint8_t length)
     CMD_ARRAY[3] = us;
     CMD_ARRAY[4] = length;
     memcpy(&CMD_ARRAY[5],value,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SET_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -923,13 +876,14 @@ bool TarvosI_GetFirmwareVersion(uint8_t* fw)
     CMD_ARRAY[1] = TarvosI_CMD_GET_FWRELEASE_REQ;
     CMD_ARRAY[2] = 0;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_GET_FWRELEASE_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_GET_FWRELEASE_CNF, CMD_Status_Success, false))
         {
             memcpy(fw,&RxPacket.Data[0],RxPacket.Length);
             return true;
@@ -954,13 +908,14 @@ bool TarvosI_GetSerialNumber(uint8_t* sn)
     CMD_ARRAY[1] = TarvosI_CMD_GET_SERIALNO_REQ;
     CMD_ARRAY[2] = 0;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_GET_SERIALNO_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_GET_SERIALNO_CNF, CMD_Status_Success, false))
         {
             memcpy(sn,&RxPacket.Data[0],RxPacket.Length);
             return true;
@@ -1263,7 +1218,7 @@ bool TarvosI_SetVolatile_Channel(uint8_t channel)
     CMD_ARRAY[1] = TarvosI_CMD_SET_CHANNEL_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = channel;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         /*
         *  module sends set value as response
@@ -1271,11 +1226,12 @@ bool TarvosI_SetVolatile_Channel(uint8_t channel)
         */
         channelVolatile = channel;
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SET_CHANNEL_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SET_CHANNEL_CNF, CMD_Status_Success, false);
         channelVolatile = CHANNELINVALID;
     }
     return ret;
@@ -1303,13 +1259,14 @@ bool TarvosI_SetVolatile_DestNetID(uint8_t destnetid)
     CMD_ARRAY[1] = TarvosI_CMD_SET_DESTNETID_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = destnetid;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SET_DESTNETID_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SET_DESTNETID_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1346,7 +1303,7 @@ bool TarvosI_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
         CMD_ARRAY[1] = TarvosI_CMD_SET_DESTADDR_REQ;
         CMD_ARRAY[2] = 0x01;
         CMD_ARRAY[3] = destaddr_lsb;
-        ret = FillChecksum(CMD_ARRAY,5);
+        ret = FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,5);
     }
     break;
 
@@ -1357,11 +1314,12 @@ bool TarvosI_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
 
     if(ret == true)
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SET_DESTADDR_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_SET_DESTADDR_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1394,11 +1352,12 @@ bool TarvosI_Transmit(uint8_t* payload, uint8_t length)
     CMD_ARRAY[1] = TarvosI_CMD_DATA_REQ;
     CMD_ARRAY[2] = length;
     memcpy(&CMD_ARRAY[3],payload,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         /* check for value if numretries - if value == 0 no ack is expected */
         TarvosI_Get(TarvosI_USERSETTING_MEMPOSITION_NUMRETRYS, &numretries, &responseLength);
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
@@ -1406,12 +1365,12 @@ bool TarvosI_Transmit(uint8_t* payload, uint8_t length)
         if(numretries > 0)
         {
             /* ack will be requested from receiver module. Once ack is received CMD_Status_Success will be sent */
-            ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_DATA_CNF, CMD_Status_Success, true);
+            ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_DATA_CNF, CMD_Status_Success, false);
         }
         else
         {
             /* no ack will be requested from receiver module - In this case CMD_Status_Failed is sent immediately after transmission */
-            ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_DATA_CNF, CMD_Status_Failed, true);
+            ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_DATA_CNF, CMD_Status_Failed, false);
         }
     }
     return ret;
@@ -1497,11 +1456,12 @@ bool TarvosI_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t channel
         return false;
     }
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         /* check for value if numretries - if value == 0 no ack is expected */
         TarvosI_Get(TarvosI_USERSETTING_MEMPOSITION_NUMRETRYS, &numretries, &responseLength);
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
@@ -1509,66 +1469,141 @@ bool TarvosI_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t channel
         if(numretries > 0)
         {
             /* ack will be requested from receiver module. Once ack is received CMD_Status_Success will be sent */
-            ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_DATA_CNF, CMD_Status_Success, true);
+            ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_DATA_CNF, CMD_Status_Success, false);
         }
         else
         {
             /* no ack will be requested from receiver module - In this case CMD_Status_Failed is sent immediately after transmission */
-            ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_DATA_CNF, CMD_Status_Failed, true);
+            ret = Wait4CNF(CMD_WAIT_TIME, TarvosI_CMD_DATA_CNF, CMD_Status_Failed, false);
         }
     }
     return ret;
 }
 
 /*
- *Configure the TarvosI
+ *Read the settings of a configuration with as few GET requests as possible and compare them locally
  *
  *input:
  * -config: pointer to the configuration struct
  * -config_length: length of the configuration struct
  *
- *return true if request succeeded
+ *output:
+ * -changed: true for each setting whose value differs from the configuration
+ *
+ *return true if all settings were read
  *       false otherwise
-*/
-bool TarvosI_Configure(TarvosI_Configuration_t* config, uint8_t config_length)
+ */
+static bool CompareConfiguration(TarvosI_Configuration_t* config, uint8_t config_length, bool* changed)
 {
-    int i = 0;
-    uint8_t help_length;
-    uint8_t help[MAX_USERSETTING_LENGTH];
+    bool read[UINT8_MAX];
+    uint8_t response[MAX_GETMULTIPLE_LENGTH];
+    uint8_t response_length;
+    int i;
 
-    /* now check all settings and update them if necessary */
     for(i=0; i<config_length; i++)
     {
-        /* read current value */
-        if(false == TarvosI_Get(config[i].usersetting, help, &help_length))
+        if((config[i].value_length == 0) || (config[i].value_length > MAX_USERSETTING_LENGTH))
         {
-            /* error */
+            /* error, invalid length */
             return false;
         }
-        delay(200);
+        read[i] = false;
+    }
 
-        /* check the value read out */
-        if(help_length != config[i].value_length)
+    while(true)
+    {
+        int first = -1;
+        int end = 0;
+
+        /* the next request starts at the lowest memory position not read yet */
+        for(i=0; i<config_length; i++)
+        {
+            if(!read[i] && ((first < 0) || (config[i].usersetting < config[first].usersetting)))
+            {
+                first = i;
+            }
+        }
+        if(first < 0)
+        {
+            /* all settings read */
+            return true;
+        }
+
+        /* and covers all further settings that fit into its answer */
+        for(i=0; i<config_length; i++)
+        {
+            if(!read[i] && (config[i].usersetting >= config[first].usersetting) && (config[i].usersetting + config[i].value_length <= config[first].usersetting + MAX_GETMULTIPLE_LENGTH))
+            {
+                read[i] = true;
+                if(config[i].usersetting + config[i].value_length > end)
+                {
+                    end = config[i].usersetting + config[i].value_length;
+                }
+            }
+        }
+        if((false == TarvosI_GetMultiple(config[first].usersetting, end - config[first].usersetting, response, &response_length)) ||
+           (response_length != end - config[first].usersetting))
         {
-            /* error, length does not match */
+            /* error */
             return false;
         }
-        if(memcmp(help,config[i].value,config[i].value_length) != 0)
+
+        for(i=0; i<config_length; i++)
+        {
+            if(read[i] && (config[i].usersetting >= config[first].usersetting) && (config[i].usersetting + config[i].value_length <= end))
+            {
+                changed[i] = (memcmp(&response[config[i].usersetting - config[first].usersetting], config[i].value, config[i].value_length) != 0);
+            }
+        }
+    }
+}
+
+/*
+ *Configure the TarvosI
+ *
+ *input:
+ * -config: pointer to the configuration struct
+ * -config_length: length of the configuration struct
+ *
+ *note: only the settings whose values differ are written, the module is reset only if a setting was written
+ *
+ *return true if request succeeded
+ *       false otherwise
+*/
+bool TarvosI_Configure(TarvosI_Configuration_t* config, uint8_t config_length)
+{
+    int i = 0;
+    bool changed[UINT8_MAX];
+    bool update = false;
+
+    /* now check all settings */
+    if(false == CompareConfiguration(config, config_length, changed))
+    {
+        /* error */
+        return false;
+    }
+
+    /* and update those that are not up to date */
+    for(i=0; i<config_length; i++)
+    {
+        if(changed[i])
         {
-            /* read value is not up to date, thus write the new value */
             if(false == TarvosI_Set(config[i].usersetting, config[i].value, config[i].value_length))
             {
                 /* error */
                 return false;
             }
+            update = true;
         }
-        delay(200);
     }
 
-    /* reset to take effect of the updated parameters */
-    if(false == TarvosI_PinReset())
+    if(update)
     {
-        return false;
+        /* reset to take effect of the updated parameters */
+        if(false == TarvosI_PinReset())
+        {
+            return false;
+        }
     }
     return true;
 }
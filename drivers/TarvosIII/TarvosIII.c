@@ -138,151 +138,132 @@ typedef struct
     CMD_Status_t status;         /* variable used to check the response (*_CNF), when a request (*_REQ) was sent to the TarvosIII */
 } CMD_Confirmation_t;
 
+/* asynchronous command, stored as the context of its request, see SendCommandAsync */
+typedef struct
+{
+    TarvosIII_CommandCallback callback;
+    void *contextP;
+    CMD_Status_t expectedStatus;
+    uint8_t dataOffset;          /* first byte of the data of the answer passed to the callback */
+} AsyncCommand_t;
+
 /**************************************
  *     Static function declarations   *
  **************************************/
 
-static void HandleRxPacket(uint8_t*RxBuffer);                                                      /* RX packet interpreter */
-static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);
-static bool FillChecksum(uint8_t* array, uint8_t length);                                           /* add the CS needed to finalize the command */
-static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode);
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                                                  /* RX packet interpreter */
+static bool Wait4CNF(TarvosIII_Handle_t *handleP, CommandQueue_Request_t *requestP, int max_time_ms, CMD_Status_t expectedStatus);
+static bool SendCommand(TarvosIII_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length, CommandQueue_Request_t *requestP); /* send a command without copying its payload */
+static uint8_t *ReserveFrame(TarvosIII_Handle_t *handleP);                                                                               /* take a TX frame to fill in place */
+static bool SubmitFrame(TarvosIII_Handle_t *handleP, uint8_t *frameP, CommandQueue_Request_t *requestP);                                 /* send a filled TX frame and give it back */
+static bool SendRequest(TarvosIII_Handle_t *handleP, uint8_t *frameP, uint16_t length, CommandQueue_Request_t *requestP);                /* send a complete request frame */
+static bool SendCommandAsync(TarvosIII_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length,
+                             uint8_t confirmation, uint8_t dataOffset, TarvosIII_CommandCallback cb, void* contextP);                  /* send a command without waiting for its answer */
+static bool FactoryReset(TarvosIII_Handle_t *handleP, bool waitForStartup);                                                             /* factory reset, optionally until the module restarted */
+static bool InitDriver(TarvosIII_Handle_t *handleP, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode);
+static bool InitModule(TarvosIII_Handle_t *handleP, int baudrate, int rp, int wp, int bp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode);
 
 /**************************************
  *          Static variables          *
  **************************************/
 
-int reset_pin;                             /* reset pin number */
-int wakeup_pin;                            /* wakeup pin number */
-int boot_pin;                              /* boot pin number */
-CMD_Frame_t RxPacket;                      /* data buffer for RX */
-bool AbortUartRxThread;                    /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                    /* boolean to reset the UART RX thread */
-
-pthread_t thread_read;
+/* command frames of the module: STX, CMD, 8 bit LEN, DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 1, HandleRxPacket };
 
-void(*RXcallback)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t); /* callback function */
-
-#define CMDCONFIRMATIONARRAY_LENGTH 2
-
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
-uint8_t channelVolatile = CHANNELINVALID;           /* variable used to check if setting the channel was successfull */
-uint8_t powerVolatile = TXPOWERINVALID;             /* variable used to check if setting the TXPower was successfull */
-TarvosIII_AddressMode_t addressmode = AddressMode_0;  /* initial address mode */
+#define CMDQUEUE_DEPTH 1                        /* requests in flight, see TarvosIII_SetPipelineDepthEx */
+#define TXPOOL_LENGTH 4                         /* requests built concurrently without allocations */
+#define TXPOOL_MAX_ALLOCATED 12                 /* further requests built concurrently, requests beyond fail */
 
+/* state of one driver instance */
+struct TarvosIII_Handle_t
+{
+    Transport_t *transportP;                    /* communication interface to the module */
+    FramePool_t *txPoolP;                       /* frames for UART TX to module, see ReserveFrame */
+    int reset_pin;                              /* reset pin number */
+    int wakeup_pin;                             /* wakeup pin number */
+    int boot_pin;                               /* boot pin number */
+    int rxThreadEvent;                          /* eventfd to reset or abort the UART RX thread */
+    pthread_t thread_read;
+    void(*RXcallback)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t); /* callback function */
+    CommandQueue_t cmdQueue;                    /* requests waiting for their confirmation */
+    uint8_t channelVolatile;                    /* variable used to check if setting the channel was successfull */
+    uint8_t powerVolatile;                      /* variable used to check if setting the TXPower was successfull */
+    TarvosIII_AddressMode_t addressmode;        /* initial address mode */
+    uint8_t RxBuffer[sizeof(CMD_Frame_t)];      /* data buffer for RX */
+};
+
+/* instance whose RX thread is executing the current callback */
+static __thread TarvosIII_Handle_t *callbackHandleP = NULL;
 
 /**************************************
  *         Static functions           *
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint8_t RxByteCounter = 0;
-    uint8_t BytesToReceive = 0;
-    uint8_t readBuffer;
-    static uint8_t RxBuffer[sizeof(CMD_Frame_t)]; /* data buffer for RX */
+    TarvosIII_Handle_t *handleP = argP;
+    FrameCodec_t codec;
 
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    /* callbacks can ask which instance they belong to */
+    callbackHandleP = handleP;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
 
-    while(1)
-    {
-        /* wait for 1ms, then check if new RX data is available */
-        delay (1) ;
+    FrameCodec_Init(&codec, &frameProtocol, handleP->RxBuffer, sizeof(handleP->RxBuffer), handleP);
+    FrameCodec_RxLoop(&codec, handleP->transportP, handleP->rxThreadEvent);
+    return 0;
+}
 
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
+/* function to take a TX frame of the instance, the request is written into it in place, so that
+ * several threads can build their requests at the same time; give it back by SubmitFrame */
+static uint8_t *ReserveFrame(TarvosIII_Handle_t *handleP)
+{
+    FrameBuffer_t *bufferP = FramePool_Get(handleP->txPoolP);
+    if(bufferP == NULL)
+    {
+        fprintf(stdout, "No TX frame available\n");
+        return NULL;
+    }
+    return bufferP->data;
+}
 
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
+/* function to send a complete request frame as the request waiting for requestP */
+static bool SendRequest(TarvosIII_Handle_t *handleP, uint8_t *frameP, uint16_t length, CommandQueue_Request_t *requestP)
+{
+    struct iovec frame = { .iov_base = frameP, .iov_len = length };
+    return CommandQueue_Submit(&handleP->cmdQueue, requestP, handleP->transportP, &frame, 1, CMD_WAIT_TIME);
+}
 
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
+/* function to add the checksum to a frame taken by ReserveFrame and send it as the request
+ * waiting for requestP, the frame is given back to the pool in any case */
+static bool SubmitFrame(TarvosIII_Handle_t *handleP, uint8_t *frameP, CommandQueue_Request_t *requestP)
+{
+    bool ret = FrameCodec_FillChecksum(&frameProtocol, frameP, sizeof(CMD_Frame_t)) &&
+               SendRequest(handleP, frameP, frameP[2] + 4, requestP);
 
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for start byte of frame */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field */
-                    RxByteCounter++;
-                    BytesToReceive = (RxBuffer[RxByteCounter - 1] + 4); /* len + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
-    }
-    return 0;
+    FrameBuffer_Release(FrameBuffer_Of(frameP));
+    return ret;
 }
 
 /* interprete the valid received UART data packet */
-static void HandleRxPacket(uint8_t*RxBuffer)
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer)
 {
+    TarvosIII_Handle_t *handleP = contextP;
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
     cmdConfirmation.status = CMD_Status_Invalid;
 
     uint cmd_length = RxBuffer[2];
-    memcpy((uint8_t*)&RxPacket,RxBuffer,cmd_length + 4);
+    CMD_Frame_t *packetP = (CMD_Frame_t*)RxBuffer;
 
-    switch (RxPacket.Cmd)
+    switch (packetP->Cmd)
     {
     case TarvosIII_CMD_FACTORY_RESET_CNF:
     {
         /* check whether the module returns success */
-        if ((RxPacket.Data[0] == 0x00))
+        if ((packetP->Data[0] == 0x00))
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -290,14 +271,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_RESET_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -305,7 +286,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
@@ -326,7 +307,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
     case TarvosIII_CMD_SHUTDOWN_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -334,14 +315,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_STANDBY_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -349,14 +330,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_DATA_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             /* transmission success, ACK received if enabled */
             cmdConfirmation.status = CMD_Status_Success;
@@ -366,14 +347,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
             /* transmission failed, no ACK received if enabled */
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_GET_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -381,14 +362,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_SET_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -396,38 +377,38 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_DATAEX_IND:
     {
         /* data received, give it to the RXcallback function */
-        if (RXcallback != NULL)
+        if (handleP->RXcallback != NULL)
         {
-            switch (addressmode)
+            switch (handleP->addressmode)
             {
             case AddressMode_0:
             {
-                RXcallback(&RxPacket.Data[0], RxPacket.Length - 1, TarvosIII_BROADCASTADDRESS, TarvosIII_BROADCASTADDRESS, TarvosIII_BROADCASTADDRESS, (int8_t)RxPacket.Data[RxPacket.Length-1]);
+                handleP->RXcallback(&packetP->Data[0], packetP->Length - 1, TarvosIII_BROADCASTADDRESS, TarvosIII_BROADCASTADDRESS, TarvosIII_BROADCASTADDRESS, (int8_t)packetP->Data[packetP->Length-1]);
             }
             break;
 
             case AddressMode_1:
             {
-                RXcallback(&RxPacket.Data[1], RxPacket.Length - 2, TarvosIII_BROADCASTADDRESS, RxPacket.Data[0], TarvosIII_BROADCASTADDRESS, (int8_t)RxPacket.Data[RxPacket.Length-1]);
+                handleP->RXcallback(&packetP->Data[1], packetP->Length - 2, TarvosIII_BROADCASTADDRESS, packetP->Data[0], TarvosIII_BROADCASTADDRESS, (int8_t)packetP->Data[packetP->Length-1]);
             }
             break;
 
             case AddressMode_2:
             {
-                RXcallback(&RxPacket.Data[2], RxPacket.Length - 3, RxPacket.Data[0], RxPacket.Data[1], TarvosIII_BROADCASTADDRESS, (int8_t)RxPacket.Data[RxPacket.Length-1]);
+                handleP->RXcallback(&packetP->Data[2], packetP->Length - 3, packetP->Data[0], packetP->Data[1], TarvosIII_BROADCASTADDRESS, (int8_t)packetP->Data[packetP->Length-1]);
             }
             break;
 
             case AddressMode_3:
             {
-                RXcallback(&RxPacket.Data[3], RxPacket.Length - 4, RxPacket.Data[0], RxPacket.Data[1], RxPacket.Data[2], (int8_t)RxPacket.Data[RxPacket.Length-1]);
+                handleP->RXcallback(&packetP->Data[3], packetP->Length - 4, packetP->Data[0], packetP->Data[1], packetP->Data[2], (int8_t)packetP->Data[packetP->Length-1]);
             }
             break;
 
@@ -442,7 +423,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
     case TarvosIII_CMD_SET_CHANNEL_CNF:
     {
         /* check whether the module set value of channel as requested */
-        if(RxPacket.Data[0] == channelVolatile)
+        if(packetP->Data[0] == handleP->channelVolatile)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -450,14 +431,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_SET_DESTADDR_CNF:
     {
         /* check whether the module returns success */
-        if (RxPacket.Data[0] == 0x00)
+        if (packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -465,14 +446,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_SET_DESTNETID_CNF:
     {
         /* check whether the module returns success */
-        if(RxPacket.Data[0] == 0x00)
+        if(packetP->Data[0] == 0x00)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -480,14 +461,14 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
     case TarvosIII_CMD_SET_PAPOWER_CNF:
     {
         /* check whether the module set value of power output as requested */
-        if(RxPacket.Data[0] == powerVolatile)
+        if(packetP->Data[0] == handleP->powerVolatile)
         {
             cmdConfirmation.status = CMD_Status_Success;
         }
@@ -495,7 +476,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         {
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
@@ -503,7 +484,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
     case TarvosIII_CMD_PINGDUT_CNF:
     {
         /* check the received packets */
-        if(RxPacket.Data[4] == 0x0A)
+        if(packetP->Data[4] == 0x0A)
         {
             /* 10 packets received */
             cmdConfirmation.status = CMD_Status_Success;
@@ -513,7 +494,7 @@ static void HandleRxPacket(uint8_t*RxBuffer)
             /* no 10 packets received */
             cmdConfirmation.status = CMD_Status_Failed;
         }
-        cmdConfirmation.cmd = RxPacket.Cmd;
+        cmdConfirmation.cmd = packetP->Cmd;
     }
     break;
 
@@ -521,74 +502,126 @@ static void HandleRxPacket(uint8_t*RxBuffer)
         break;
     }
 
-    int i = 0;
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+    if(cmdConfirmation.cmd != CNFINVALID)
     {
-        if(cmdConfirmation_array[i].cmd == CNFINVALID)
-        {
-            cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
-            cmdConfirmation_array[i].status = cmdConfirmation.status;
-            break;
-        }
+        /* the confirmation is copied for the command waiting for it */
+        CommandQueue_Confirm(&handleP->cmdQueue, cmdConfirmation.cmd, cmdConfirmation.status, RxBuffer, cmd_length + 4);
     }
 }
 
 /* function that waits for the return value of TarvosIII (*_CNF), when a command (*_REQ) was sent before */
-static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
+static bool Wait4CNF(TarvosIII_Handle_t *handleP, CommandQueue_Request_t *requestP, int max_time_ms, CMD_Status_t expectedStatus)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
-    int i = 0;
+    return CommandQueue_Wait(&handleP->cmdQueue, requestP, max_time_ms) && (requestP->status == expectedStatus);
+}
 
-    if(reset_confirmstate)
+/* function to send a command with its payload in place, i.e. without copying the payload
+ * behind the header first; the length field of the header has to be filled already */
+static bool SendCommand(TarvosIII_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length, CommandQueue_Request_t *requestP)
+{
+    uint8_t checksum = FrameCodec_Checksum(FrameCodec_Checksum(0, header, header_length), payload, payload_length);
+
+    struct iovec frame[3] =
     {
-        for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-        {
-            cmdConfirmation_array[i].cmd = CNFINVALID;
-        }
+        { .iov_base = header,    .iov_len = header_length },
+        { .iov_base = payload,   .iov_len = payload_length },
+        { .iov_base = &checksum, .iov_len = 1 },
+    };
+    return CommandQueue_Submit(&handleP->cmdQueue, requestP, handleP->transportP, frame, 3, CMD_WAIT_TIME);
+}
+
+/* function called by the dispatcher of the command queue when an asynchronous command was answered or timed out */
+static void AsyncCommandDone(CommandQueue_Request_t *requestP, bool answered)
+{
+    AsyncCommand_t *commandP = requestP->contextP;
+    CMD_Frame_t *packetP = (CMD_Frame_t*)requestP->responseP;
+    bool success = answered && (requestP->status == commandP->expectedStatus);
+    uint8_t length = 0;
+
+    if(success && (packetP->Length > commandP->dataOffset))
+    {
+        length = packetP->Length - commandP->dataOffset;
     }
-    while (1)
+    commandP->callback(success, &packetP->Data[commandP->dataOffset], length, commandP->contextP);
+}
+
+/* function to send a command like SendCommand, but to return without waiting for its answer;
+ * the frame is copied and the answer is passed to cb from Data[dataOffset] on */
+static bool SendCommandAsync(TarvosIII_Handle_t *handleP, uint8_t* header, uint8_t header_length, uint8_t* payload, uint16_t payload_length,
+                             uint8_t confirmation, uint8_t dataOffset, TarvosIII_CommandCallback cb, void* contextP)
+{
+    uint8_t checksum = FrameCodec_Checksum(FrameCodec_Checksum(0, header, header_length), payload, payload_length);
+
+    struct iovec frame[3] =
     {
-        for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-        {
-            if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
-            {
-                return (cmdConfirmation_array[i].status == expectedStatus);
-            }
-        }
+        { .iov_base = header,    .iov_len = header_length },
+        { .iov_base = payload,   .iov_len = payload_length },
+        { .iov_base = &checksum, .iov_len = 1 },
+    };
 
-        if (count >= max_count)
-        {
-            /* received no correct response within timeout */
-            return false;
-        }
+    if(cb == NULL)
+    {
+        return false;
+    }
 
-        /* wait */
-        count++;
-        delay(time_step_ms);
+    CommandQueue_Request_t *requestP = CommandQueue_NewRequest(confirmation, frame, 3, sizeof(CMD_Frame_t), sizeof(AsyncCommand_t));
+    if(requestP == NULL)
+    {
+        return false;
     }
-    return true;
+    if(confirmation == TarvosIII_CMD_DATA_CNF)
+    {
+        /* answered once the data was sent over the air */
+        CommandQueue_SetFixedTimeout(requestP);
+    }
+    AsyncCommand_t *commandP = requestP->contextP;
+    commandP->callback = cb;
+    commandP->contextP = contextP;
+    commandP->expectedStatus = CMD_Status_Success;
+    commandP->dataOffset = dataOffset;
+
+    return CommandQueue_SubmitAsync(&handleP->cmdQueue, requestP, handleP->transportP, CMD_WAIT_TIME, AsyncCommandDone);
 }
 
-/* function to add the checksum at the end of the data packet */
-static bool FillChecksum(uint8_t* array, uint8_t length)
+/* factory reset the module, and if waitForStartup is set, also wait for the RESET_IND it sends when
+ * it restarted with the default settings; its request is queued before the FACTORY_RESET_REQ is sent,
+ * as the RESET_IND may directly follow the FACTORY_RESET_CNF */
+static bool FactoryReset(TarvosIII_Handle_t *handleP, bool waitForStartup)
 {
     bool ret = false;
 
-    if ((length >= 4) && (array[0] == CMD_STX))
-    {
-        uint8_t checksum = 0;
-        uint8_t payload_length = array[2];
-        int i = 0;
-        for (i = 0;
-                i < payload_length + 3;
-                i++)
+    /* fill CMD_ARRAY packet */
+    uint8_t CMD_ARRAY[4];
+    CMD_ARRAY[0] = CMD_STX;
+    CMD_ARRAY[1] = TarvosIII_CMD_FACTORY_RESET_REQ;
+    CMD_ARRAY[2] = 0x00;
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
+    {
+        struct iovec frame = { .iov_base = CMD_ARRAY, .iov_len = sizeof(CMD_ARRAY) };
+        CommandQueue_Request_t request;
+        CommandQueue_Request_t startup;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_FACTORY_RESET_CNF, NULL, 0);
+        /* answered once the settings were restored in flash */
+        CommandQueue_SetFixedTimeout(&request);
+        CommandQueue_InitRequest(&startup, TarvosIII_CMD_RESET_IND, NULL, 0);
+        /* now send CMD_ARRAY */
+        if(CommandQueue_SubmitFollowUp(&handleP->cmdQueue, &request, waitForStartup ? &startup : NULL, handleP->transportP, &frame, 1, CMD_WAIT_TIME))
         {
-            checksum ^= array[i];
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, 1500, CMD_Status_Success);
+            if(waitForStartup)
+            {
+                if(ret)
+                {
+                    /* wait for the restart */
+                    ret = Wait4CNF(handleP, &startup, CMD_WAIT_TIME, CMD_Status_Success);
+                }
+                else
+                {
+                    CommandQueue_Cancel(&handleP->cmdQueue, &startup);
+                }
+            }
         }
-        array[payload_length + 3] = checksum;
-        ret = true;
     }
     return ret;
 }
@@ -606,50 +639,91 @@ static bool FillChecksum(uint8_t* array, uint8_t length)
  *return true if initialization succeeded
  *       false otherwise
  */
-static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode)
+static bool InitDriver(TarvosIII_Handle_t *handleP, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode)
 {
     /* set address mode */
-    addressmode = addrmode;
+    handleP->addressmode = addrmode;
 
     /* set RX callback function */
-    RXcallback = RXcb;
+    handleP->RXcallback = RXcb;
 
-    /* start RX thread */
-    if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
+    /* create the event to reset and abort the RX thread */
+    handleP->rxThreadEvent = RxThreadEvent_Create();
+    if(handleP->rxThreadEvent < 0)
     {
-        fprintf(stdout, "Failed to start rx_Thread\n");
-        TarvosIII_Deinit();
+        fprintf(stdout, "Failed to create rx_Thread event\n");
         return false;
     }
 
-    /* reset module*/
-    if(TarvosIII_PinReset())
+    /* start RX thread */
+    if(pthread_create(&handleP->thread_read, NULL, &rx_thread, handleP))
     {
-        delay(300);
+        fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(handleP->rxThreadEvent);
+        handleP->rxThreadEvent = -1;
+        return false;
     }
-    else
+
+    /* reset module, it accepts requests as soon as it sent its RESET_IND */
+    if(false == TarvosIII_PinResetEx(handleP))
     {
         fprintf(stdout, "Pin Reset failed\n");
-        TarvosIII_Deinit();
         return false;
     }
 
     /* Read out the firmware version of the connected AMBER module */
     uint8_t response[3];
 
-    if(TarvosIII_GetFirmwareVersion(response))
+    if(TarvosIII_GetFirmwareVersionEx(handleP, response))
     {
         fprintf (stdout, "Firmware version %d.%d.%d detected\n",response[0],response[1],response[2]);
     }
     else
     {
         fprintf (stdout, "Readout of the firmware version failed.\nProbably invalid UART configuration or module is shut down.\n");
-        TarvosIII_Deinit();
         return false;
     }
     return true;
 }
 
+/* open the interface, set up the pins and start the driver */
+static bool InitModule(TarvosIII_Handle_t *handleP, int baudrate, int rp, int wp, int bp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode)
+{
+
+    if (false == Transport_InitPin(handleP->transportP, rp))
+    {
+        /* error */
+        return false ;
+    }
+
+    if (false == Transport_Open(handleP->transportP, baudrate, Serial_ParityBit_NONE))
+    {
+        /* error */
+        return false ;
+    }
+    /* let the timeouts of the commands adapt to the answer times of the module */
+    CommandQueue_SetLineRate(&handleP->cmdQueue, baudrate);
+
+    /* initialize the boot pin */
+    handleP->boot_pin = bp;
+    Transport_SetPin(handleP->transportP, handleP->boot_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+
+    /* initialize the wakeup pin */
+    handleP->wakeup_pin = wp;
+    Transport_SetPin(handleP->transportP, handleP->wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+
+    /* initialize the reset pin,
+     * we have to define it as input/pull-up such that the reset button
+     * on the base PCB can pull the pin level down if the button is pressed */
+    handleP->reset_pin = rp;
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
+
+    /* empty the UART buffers */
+    Transport_Flush(handleP->transportP);
+
+    return InitDriver(handleP, RXcb, addrmode);
+}
+
 
 /**************************************
  *         Global functions           *
@@ -659,6 +733,7 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8
  *Initialize the TarvosIII for serial interface
  *
  *input:
+ * -transportP:     interface to the module, see SerialTransport_Create and FTDITransport_Create
  * -baudrate: baudrate of the serial interface
  * -rp:       reset pin number
  * -wp:       wakeup pin number
@@ -672,77 +747,86 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8
  *         -the addrmode must match when RF packet transmission or reception is performed
  *          *this parameter can be updated to the correct value (used in TarvosIII_Init function) as soon as no RF packet transmission or reception was performed
  *
- *return true if initialization succeeded
- *       false otherwise
+ *return driver instance if initialization succeeded
+ *       NULL otherwise
  */
-bool TarvosIII_Init(int baudrate, int rp, int wp, int bp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode)
+TarvosIII_Handle_t *TarvosIII_InitEx(Transport_t *transportP, int baudrate, int rp, int wp, int bp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode)
 {
+    TarvosIII_Handle_t *handleP;
 
-    if (false == InitPin(rp))
+    if(transportP == NULL)
     {
-        /* error */
-        return false ;
+        return NULL;
     }
 
-    if (false == InitSerial())
+    handleP = calloc(1, sizeof(TarvosIII_Handle_t));
+    if(handleP == NULL)
     {
-        /* error */
-        return false ;
+        return NULL;
     }
+    handleP->transportP = transportP;
+    handleP->rxThreadEvent = -1;
+    handleP->channelVolatile = CHANNELINVALID;
+    handleP->powerVolatile = TXPOWERINVALID;
+    handleP->addressmode = AddressMode_0;
 
-    if (false == OpenSerial(baudrate))
+    if(!CommandQueue_Init(&handleP->cmdQueue, CMDQUEUE_DEPTH))
     {
-        /* error */
-        return false ;
+        fprintf(stdout, "Failed to initialize command queue\n");
+        free(handleP);
+        return NULL;
     }
 
-    /* initialize the boot pin */
-    boot_pin = bp;
-    SetPin(boot_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
-    delay(10);
-
-    /* initialize the wakeup pin */
-    wakeup_pin = wp;
-    SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
-    delay(10);
-
-    /* initialize the reset pin,
-     * we have to define it as input/pull-up such that the reset button
-     * on the base PCB can pull the pin level down if the button is pressed */
-    reset_pin = rp;
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
-
-    /* empty the UART buffers */
-    FlushSerial();
+    handleP->txPoolP = FramePool_Create(TXPOOL_LENGTH, TXPOOL_MAX_ALLOCATED, sizeof(CMD_Frame_t));
+    if((handleP->txPoolP == NULL) || (false == InitModule(handleP, baudrate, rp, wp, bp, RXcb, addrmode)))
+    {
+        TarvosIII_DeinitEx(handleP);
+        return NULL;
+    }
 
-    return InitDriver(RXcb, addrmode);
+    return handleP;
 }
 
 /*
  *Deinitialize the TarvosIII interface
  *
+ *note: the transport is closed, but not destroyed
+ *
+ *input:
+ * -handleP: driver instance, freed by this function
+ *
  *return true if deinitialization succeeded
  *       false otherwise
  */
-bool TarvosIII_Deinit()
+bool TarvosIII_DeinitEx(TarvosIII_Handle_t *handleP)
 {
+    if(handleP == NULL)
+    {
+        return false;
+    }
+
     /* close the communication interface to the module */
-    CloseSerial();
-    DeinitSerial();
+    Transport_Close(handleP->transportP);
 
     /* abort RX thread */
-    AbortUartRxThread = true;
+    if(handleP->rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(handleP->rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(handleP->thread_read, NULL);
+        RxThreadEvent_Destroy(handleP->rxThreadEvent);
+        handleP->rxThreadEvent = -1;
+    }
 
     /* deinit pins */
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
-    SetPin(wakeup_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
-    SetPin(boot_pin, SetPin_InputOutput_Input, SetPin_Pull_Down, SetPin_Out_High);
-    DeinitPin(reset_pin);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->wakeup_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->boot_pin, SetPin_InputOutput_Input, SetPin_Pull_Down, SetPin_Out_High);
+    Transport_DeinitPin(handleP->transportP, handleP->reset_pin);
+
+    FramePool_Destroy(handleP->txPoolP);
 
-    /* deinit RX callback and address mode */
-    RXcallback = NULL;
-    addressmode = AddressMode_0;
+    CommandQueue_Deinit(&handleP->cmdQueue);
+    free(handleP);
 
     return true;
 }
@@ -753,20 +837,20 @@ bool TarvosIII_Deinit()
  *return true if wakeup succeeded
  *       false otherwise
  */
-bool TarvosIII_PinWakeup()
+bool TarvosIII_PinWakeupEx(TarvosIII_Handle_t *handleP)
 {
-    int i = 0;
-    SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
     delay (5);
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, TarvosIII_CMD_RESET_IND, NULL, 0);
+    if(!CommandQueue_Submit(&handleP->cmdQueue, &request, handleP->transportP, NULL, 0, CMD_WAIT_TIME))
     {
-        cmdConfirmation_array[i].status = CMD_Status_Invalid;
-        cmdConfirmation_array[i].cmd = CNFINVALID;
+        return false;
     }
-    SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+    Transport_SetPin(handleP->transportP, handleP->wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_RESET_IND, CMD_Status_Success, false);
+    return Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
 }
 
 /*
@@ -775,22 +859,28 @@ bool TarvosIII_PinWakeup()
  *return true if reset succeeded
  *       false otherwise
  */
-bool TarvosIII_PinReset()
+bool TarvosIII_PinResetEx(TarvosIII_Handle_t *handleP)
 {
     /* set to output mode */
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
     delay (5);
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
-    FlushSerial();
-    ResetUartRxThread = true;
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
+    Transport_Flush(handleP->transportP);
+    RxThreadEvent_Signal(handleP->rxThreadEvent, RXTHREAD_EVENT_RESET);
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, TarvosIII_CMD_RESET_IND, NULL, 0);
+    if(!CommandQueue_Submit(&handleP->cmdQueue, &request, handleP->transportP, NULL, 0, CMD_WAIT_TIME))
+    {
+        return false;
+    }
     delay (5);
-    SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
 
     /* set to input mode again */
-    SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
+    Transport_SetPin(handleP->transportP, handleP->reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_RESET_IND, CMD_Status_Success, true);
+    return Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
 }
 
 /*
@@ -799,7 +889,7 @@ bool TarvosIII_PinReset()
  *return true if reset succeeded
  *       false otherwise
  */
-bool TarvosIII_Reset()
+bool TarvosIII_ResetEx(TarvosIII_Handle_t *handleP)
 {
     bool ret = false;
 
@@ -808,13 +898,16 @@ bool TarvosIII_Reset()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TarvosIII_CMD_RESET_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_RESET_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_RESET_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -827,24 +920,9 @@ bool TarvosIII_Reset()
  *return true if factory reset succeeded
  *       false otherwise
  */
-bool TarvosIII_FactoryReset()
+bool TarvosIII_FactoryResetEx(TarvosIII_Handle_t *handleP)
 {
-    bool ret = false;
-
-    /* fill CMD_ARRAY packet */
-    uint8_t CMD_ARRAY[4];
-    CMD_ARRAY[0] = CMD_STX;
-    CMD_ARRAY[1] = TarvosIII_CMD_FACTORY_RESET_REQ;
-    CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
-    {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(1500, TarvosIII_CMD_FACTORY_RESET_CNF, CMD_Status_Success, true);
-    }
-    return ret;
+    return FactoryReset(handleP, false);
 }
 
 /*
@@ -853,7 +931,7 @@ bool TarvosIII_FactoryReset()
  *return true if switching succeeded
  *       false otherwise
  */
-bool TarvosIII_Standby()
+bool TarvosIII_StandbyEx(TarvosIII_Handle_t *handleP)
 {
     bool ret = false;
 
@@ -862,13 +940,16 @@ bool TarvosIII_Standby()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TarvosIII_CMD_STANDBY_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_STANDBY_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_STANDBY_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -879,7 +960,7 @@ bool TarvosIII_Standby()
  *return true if switching succeeded
  *       false otherwise
  */
-bool TarvosIII_Shutdown()
+bool TarvosIII_ShutdownEx(TarvosIII_Handle_t *handleP)
 {
     bool ret = false;
 
@@ -888,13 +969,16 @@ bool TarvosIII_Shutdown()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TarvosIII_CMD_SHUTDOWN_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_SHUTDOWN_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_SHUTDOWN_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -912,7 +996,7 @@ bool TarvosIII_Shutdown()
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_Get(TarvosIII_UserSettings_t us, uint8_t* response, uint8_t* response_length)
+bool TarvosIII_GetEx(TarvosIII_Handle_t *handleP, TarvosIII_UserSettings_t us, uint8_t* response, uint8_t* response_length)
 {
     bool ret = false;
 
@@ -923,23 +1007,52 @@ bool TarvosIII_Get(TarvosIII_UserSettings_t us, uint8_t* response, uint8_t* resp
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = us;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CMD_Frame_t cnfPacket;
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_GET_CNF, (uint8_t*)&cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_GET_CNF, CMD_Status_Success, true))
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
         {
-            int length = RxPacket.Length - 1;
-            memcpy(response,&RxPacket.Data[1],length);
-            *response_length = length;
-            ret = true;
+            /* wait for cnf */
+            if (Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success))
+            {
+                int length = cnfPacket.Length - 1;
+                memcpy(response,&cnfPacket.Data[1],length);
+                *response_length = length;
+                ret = true;
+            }
         }
     }
     return ret;
 }
 
+/*
+ *Request the current TarvosIII settings without waiting for the confirmation
+ *
+ *input:
+ * -us:       user setting to be requested
+ * -cb:       called with the value of the setting in dataP
+ * -contextP: passed to cb
+ *
+ *note: cb is called by a thread of the driver instance, it must not block for long
+ *
+ *return true if the request was queued, cb is called exactly once then
+ *       false otherwise
+ */
+bool TarvosIII_GetAsyncEx(TarvosIII_Handle_t *handleP, TarvosIII_UserSettings_t us, TarvosIII_CommandCallback cb, void* contextP)
+{
+    uint8_t header[4];
+    header[0] = CMD_STX;
+    header[1] = TarvosIII_CMD_GET_REQ;
+    header[2] = 0x01;
+    header[3] = us;
+
+    /* first data byte is the status */
+    return SendCommandAsync(handleP, header, sizeof(header), NULL, 0, TarvosIII_CMD_GET_CNF, 1, cb, contextP);
+}
+
 /*
  *Set a special TarvosIII setting
  *
@@ -954,28 +1067,70 @@ bool TarvosIII_Get(TarvosIII_UserSettings_t us, uint8_t* response, uint8_t* resp
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_Set(TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length)
+bool TarvosIII_SetEx(TarvosIII_Handle_t *handleP, TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length)
 {
     bool ret = false;
 
-    /* fill CMD_ARRAY packet */
-    uint8_t CMD_ARRAY[length + 5];
-    CMD_ARRAY[0] = CMD_STX;
-    CMD_ARRAY[1] = TarvosIII_CMD_SET_REQ;
-    CMD_ARRAY[2] = (1 + length);
-    CMD_ARRAY[3] = us;
-    memcpy(&CMD_ARRAY[4],value,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(length > UINT8_MAX - 1)
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
+        /* does not fit into the length field */
+        return false;
+    }
+
+    /* fill a TX frame of the pool in place */
+    uint8_t *frameP = ReserveFrame(handleP);
+    if(frameP == NULL)
+    {
+        return false;
+    }
+    frameP[0] = CMD_STX;
+    frameP[1] = TarvosIII_CMD_SET_REQ;
+    frameP[2] = (1 + length);
+    frameP[3] = us;
+    memcpy(&frameP[4],value,length);
 
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, TarvosIII_CMD_SET_CNF, NULL, 0);
+    if(SubmitFrame(handleP, frameP, &request))
+    {
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_SET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
     }
     return ret;
 }
 
+/*
+ *Set a special TarvosIII setting without waiting for the confirmation
+ *
+ *input:
+ * -us:       user setting to be updated
+ * -value:    pointer to the new settings value, copied before returning
+ * -length:   length of the value
+ * -cb:       called with the result of the request
+ * -contextP: passed to cb
+ *
+ *note: cb is called by a thread of the driver instance, it must not block for long
+ *
+ *return true if the request was queued, cb is called exactly once then
+ *       false otherwise
+ */
+bool TarvosIII_SetAsyncEx(TarvosIII_Handle_t *handleP, TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length, TarvosIII_CommandCallback cb, void* contextP)
+{
+    if(length > UINT8_MAX - 1)
+    {
+        /* does not fit into the length field */
+        return false;
+    }
+
+    uint8_t header[4];
+    header[0] = CMD_STX;
+    header[1] = TarvosIII_CMD_SET_REQ;
+    header[2] = (1 + length);
+    header[3] = us;
+
+    return SendCommandAsync(handleP, header, sizeof(header), value, length, TarvosIII_CMD_SET_CNF, 1, cb, contextP);
+}
+
 
 /*
  *Request the 3 byte firmware version
@@ -986,12 +1141,12 @@ bool TarvosIII_Set(TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetFirmwareVersion(uint8_t* fw)
+bool TarvosIII_GetFirmwareVersionEx(TarvosIII_Handle_t *handleP, uint8_t* fw)
 {
     uint8_t help[3];
     uint8_t help_length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_FWVERSION, help, &help_length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_FWVERSION, help, &help_length))
     {
         fw[0] = help[2];
         fw[1] = help[1];
@@ -1013,12 +1168,12 @@ bool TarvosIII_GetFirmwareVersion(uint8_t* fw)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetSerialNumber(uint8_t* sn)
+bool TarvosIII_GetSerialNumberEx(TarvosIII_Handle_t *handleP, uint8_t* sn)
 {
     uint8_t help[8];
     uint8_t help_length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_FACTORYSETTINGS, help, &help_length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_FACTORYSETTINGS, help, &help_length))
     {
         sn[0] = help[3];
         sn[1] = help[2];
@@ -1041,11 +1196,11 @@ bool TarvosIII_GetSerialNumber(uint8_t* sn)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetDefaultTXPower(uint8_t* txpower)
+bool TarvosIII_GetDefaultTXPowerEx(TarvosIII_Handle_t *handleP, uint8_t* txpower)
 {
     uint8_t length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_DEFAULTRFTXPOWER, txpower, &length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTRFTXPOWER, txpower, &length))
     {
         return true;
     }
@@ -1066,13 +1221,13 @@ bool TarvosIII_GetDefaultTXPower(uint8_t* txpower)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetDefaultDestAddr(uint8_t* destaddr_lsb, uint8_t* destaddr_msb)
+bool TarvosIII_GetDefaultDestAddrEx(TarvosIII_Handle_t *handleP, uint8_t* destaddr_lsb, uint8_t* destaddr_msb)
 {
     /* helper array */
     uint8_t help[2];
     uint8_t length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_DEFAULTDESTADDR, help, &length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTDESTADDR, help, &length))
     {
         *destaddr_lsb = help[0];
         *destaddr_msb = help[1];
@@ -1093,11 +1248,11 @@ bool TarvosIII_GetDefaultDestAddr(uint8_t* destaddr_lsb, uint8_t* destaddr_msb)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetDefaultDestNetID(uint8_t* destnetid)
+bool TarvosIII_GetDefaultDestNetIDEx(TarvosIII_Handle_t *handleP, uint8_t* destnetid)
 {
     uint8_t length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_DEFAULTDESTNETID, destnetid, &length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTDESTNETID, destnetid, &length))
     {
         return true;
     }
@@ -1117,13 +1272,13 @@ bool TarvosIII_GetDefaultDestNetID(uint8_t* destnetid)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetSourceAddr(uint8_t* srcaddr_lsb, uint8_t *srcaddr_msb)
+bool TarvosIII_GetSourceAddrEx(TarvosIII_Handle_t *handleP, uint8_t* srcaddr_lsb, uint8_t *srcaddr_msb)
 {
     /* helper array */
     uint8_t help[2];
     uint8_t length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_SOURCEADDR, help, &length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_SOURCEADDR, help, &length))
     {
         *srcaddr_lsb = help[0];
         *srcaddr_msb = help[1];
@@ -1144,11 +1299,11 @@ bool TarvosIII_GetSourceAddr(uint8_t* srcaddr_lsb, uint8_t *srcaddr_msb)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetSourceNetID(uint8_t* srcnetid)
+bool TarvosIII_GetSourceNetIDEx(TarvosIII_Handle_t *handleP, uint8_t* srcnetid)
 {
     uint8_t length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_SOURCENETID, srcnetid, &length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_SOURCENETID, srcnetid, &length))
     {
         return true;
     }
@@ -1167,11 +1322,11 @@ bool TarvosIII_GetSourceNetID(uint8_t* srcnetid)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetDefaultRFChannel(uint8_t* channel)
+bool TarvosIII_GetDefaultRFChannelEx(TarvosIII_Handle_t *handleP, uint8_t* channel)
 {
     uint8_t length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_DEFAULTRFCHANNEL, channel, &length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTRFCHANNEL, channel, &length))
     {
         return true;
     }
@@ -1190,11 +1345,11 @@ bool TarvosIII_GetDefaultRFChannel(uint8_t* channel)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_GetDefaultRFProfile(uint8_t* profile)
+bool TarvosIII_GetDefaultRFProfileEx(TarvosIII_Handle_t *handleP, uint8_t* profile)
 {
     uint8_t length;
 
-    if(TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_DEFAULTRFPROFILE, profile, &length))
+    if(TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTRFPROFILE, profile, &length))
     {
         return true;
     }
@@ -1217,7 +1372,7 @@ bool TarvosIII_GetDefaultRFProfile(uint8_t* profile)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetDefaultTXPower(uint8_t txpower)
+bool TarvosIII_SetDefaultTXPowerEx(TarvosIII_Handle_t *handleP, uint8_t txpower)
 {
     /* check for invalid power */
     if((txpower < -11)||(txpower > 15))
@@ -1225,7 +1380,7 @@ bool TarvosIII_SetDefaultTXPower(uint8_t txpower)
         /*invalid power*/
         return false;
     }
-    return TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_DEFAULTRFTXPOWER, &txpower, 1);
+    return TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTRFTXPOWER, &txpower, 1);
 }
 
 /*
@@ -1242,7 +1397,7 @@ bool TarvosIII_SetDefaultTXPower(uint8_t txpower)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetDefaultDestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
+bool TarvosIII_SetDefaultDestAddrEx(TarvosIII_Handle_t *handleP, uint8_t destaddr_lsb, uint8_t destaddr_msb)
 {
 
     if((destaddr_lsb < 0)||(destaddr_lsb > 255))
@@ -1254,7 +1409,7 @@ bool TarvosIII_SetDefaultDestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
     uint8_t help[2];
     help[0] = destaddr_lsb;
     help[1] = destaddr_msb;
-    return TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_DEFAULTDESTADDR, help, 2);
+    return TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTDESTADDR, help, 2);
 }
 
 /*
@@ -1270,7 +1425,7 @@ bool TarvosIII_SetDefaultDestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetDefaultDestNetID(uint8_t destnetid)
+bool TarvosIII_SetDefaultDestNetIDEx(TarvosIII_Handle_t *handleP, uint8_t destnetid)
 {
     /* check for valid destnetid */
     if((destnetid < 0)||(destnetid > 255))
@@ -1278,7 +1433,7 @@ bool TarvosIII_SetDefaultDestNetID(uint8_t destnetid)
         /* invalid destnetid */
         return false;
     }
-    return TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_DEFAULTDESTNETID, &destnetid, 1);
+    return TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTDESTNETID, &destnetid, 1);
 }
 
 /*
@@ -1294,7 +1449,7 @@ bool TarvosIII_SetDefaultDestNetID(uint8_t destnetid)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetSourceAddr(uint8_t srcaddr_lsb, uint8_t srcaddr_msb)
+bool TarvosIII_SetSourceAddrEx(TarvosIII_Handle_t *handleP, uint8_t srcaddr_lsb, uint8_t srcaddr_msb)
 {
     if((srcaddr_lsb < 0)||(srcaddr_lsb > 255))
     {
@@ -1304,7 +1459,7 @@ bool TarvosIII_SetSourceAddr(uint8_t srcaddr_lsb, uint8_t srcaddr_msb)
     uint8_t help[2];
     help[0] = srcaddr_lsb;
     help[1] = srcaddr_msb;
-    return TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_SOURCEADDR, help, 2);
+    return TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_SOURCEADDR, help, 2);
 }
 
 /*
@@ -1319,7 +1474,7 @@ bool TarvosIII_SetSourceAddr(uint8_t srcaddr_lsb, uint8_t srcaddr_msb)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetSourceNetID(uint8_t srcnetid)
+bool TarvosIII_SetSourceNetIDEx(TarvosIII_Handle_t *handleP, uint8_t srcnetid)
 {
     /* check for invalid srcnetid */
     if((srcnetid < 0)||(srcnetid > 254))
@@ -1327,7 +1482,7 @@ bool TarvosIII_SetSourceNetID(uint8_t srcnetid)
         /* invalid destnetid */
         return false;
     }
-    return TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_SOURCENETID, &srcnetid, 1);
+    return TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_SOURCENETID, &srcnetid, 1);
 }
 
 /*
@@ -1343,7 +1498,7 @@ bool TarvosIII_SetSourceNetID(uint8_t srcnetid)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetDefaultRFChannel(uint8_t channel)
+bool TarvosIII_SetDefaultRFChannelEx(TarvosIII_Handle_t *handleP, uint8_t channel)
 {
 
     /* check for valid channel */
@@ -1352,7 +1507,7 @@ bool TarvosIII_SetDefaultRFChannel(uint8_t channel)
         /* invalid channel */
         return false;
     }
-    return TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_DEFAULTRFCHANNEL, &channel, 1);
+    return TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTRFCHANNEL, &channel, 1);
 }
 
 /*
@@ -1367,9 +1522,9 @@ bool TarvosIII_SetDefaultRFChannel(uint8_t channel)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetDefaultRFProfile(uint8_t profile)
+bool TarvosIII_SetDefaultRFProfileEx(TarvosIII_Handle_t *handleP, uint8_t profile)
 {
-    return TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_DEFAULTRFPROFILE, &profile, 1);
+    return TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_DEFAULTRFPROFILE, &profile, 1);
 }
 
 /*
@@ -1381,7 +1536,7 @@ bool TarvosIII_SetDefaultRFProfile(uint8_t profile)
  *
  *return true if request succeeded
  */
-bool TarvosIII_EnableSnifferMode()
+bool TarvosIII_EnableSnifferModeEx(TarvosIII_Handle_t *handleP)
 {
     bool ret = false;
 
@@ -1389,14 +1544,14 @@ bool TarvosIII_EnableSnifferMode()
     uint16_t cfgFlags;
     uint8_t length;
 
-	ret = TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_CFG_FLAGS, (uint8_t*)&cfgFlags, &length);
+	ret = TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_CFG_FLAGS, (uint8_t*)&cfgFlags, &length);
     if(ret == true)
 	{
 		/* set sniffer mode if not set already */
 		if(TarvosIII_CFGFLAGS_SNIFFERMODEENABLE != (cfgFlags & TarvosIII_CFGFLAGS_SNIFFERMODEENABLE))
 		{
 			cfgFlags |= TarvosIII_CFGFLAGS_SNIFFERMODEENABLE;
-			ret = TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_CFG_FLAGS, (uint8_t*)&cfgFlags, 2);
+			ret = TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_CFG_FLAGS, (uint8_t*)&cfgFlags, 2);
 		}
 		else
 		{
@@ -1406,13 +1561,13 @@ bool TarvosIII_EnableSnifferMode()
 		if(ret == true)
 		{
 			/* Make sure repeater mode is disabled once sniffer mode is active. Sniffer mode and repeater mode can not be used simultaneously */
-			ret = TarvosIII_Get(TarvosIII_CMD_SETGET_OPTION_RP_FLAGS, (uint8_t*)&rpFlags, &length);
+			ret = TarvosIII_GetEx(handleP, TarvosIII_CMD_SETGET_OPTION_RP_FLAGS, (uint8_t*)&rpFlags, &length);
 			if(ret == true)
 			{
 				if(TarvosIII_RPFLAGS_REPEATERENABLE == (rpFlags & TarvosIII_RPFLAGS_REPEATERENABLE))
 				{
 					rpFlags &= ~TarvosIII_RPFLAGS_REPEATERENABLE;
-					ret &= TarvosIII_Set(TarvosIII_CMD_SETGET_OPTION_RP_FLAGS, (uint8_t*)&rpFlags, 2);
+					ret &= TarvosIII_SetEx(handleP, TarvosIII_CMD_SETGET_OPTION_RP_FLAGS, (uint8_t*)&rpFlags, 2);
 				}
 				else
 				{
@@ -1433,7 +1588,7 @@ bool TarvosIII_EnableSnifferMode()
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetVolatile_TXPower(uint8_t power)
+bool TarvosIII_SetVolatile_TXPowerEx(TarvosIII_Handle_t *handleP, uint8_t power)
 {
     bool ret = false;
 
@@ -1450,15 +1605,18 @@ bool TarvosIII_SetVolatile_TXPower(uint8_t power)
     CMD_ARRAY[1] = TarvosIII_CMD_SET_PAPOWER_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = power;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
-        powerVolatile = power;
+        handleP->powerVolatile = power;
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_SET_PAPOWER_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_SET_PAPOWER_CNF, CMD_Status_Success, true);
-        powerVolatile = TXPOWERINVALID;
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
+        handleP->powerVolatile = TXPOWERINVALID;
     }
     return ret;
 }
@@ -1472,7 +1630,7 @@ bool TarvosIII_SetVolatile_TXPower(uint8_t power)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetVolatile_Channel(uint8_t channel)
+bool TarvosIII_SetVolatile_ChannelEx(TarvosIII_Handle_t *handleP, uint8_t channel)
 {
     bool ret = false;
 
@@ -1489,15 +1647,18 @@ bool TarvosIII_SetVolatile_Channel(uint8_t channel)
     CMD_ARRAY[1] = TarvosIII_CMD_SET_CHANNEL_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = channel;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
-        channelVolatile = channel;
+        handleP->channelVolatile = channel;
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_SET_CHANNEL_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_SET_CHANNEL_CNF, CMD_Status_Success, true);
-        channelVolatile = CHANNELINVALID;
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
+        handleP->channelVolatile = CHANNELINVALID;
     }
     return ret;
 }
@@ -1511,7 +1672,7 @@ bool TarvosIII_SetVolatile_Channel(uint8_t channel)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetVolatile_DestNetID(uint8_t destnetid)
+bool TarvosIII_SetVolatile_DestNetIDEx(TarvosIII_Handle_t *handleP, uint8_t destnetid)
 {
     bool ret = false;
 
@@ -1528,13 +1689,16 @@ bool TarvosIII_SetVolatile_DestNetID(uint8_t destnetid)
     CMD_ARRAY[1] = TarvosIII_CMD_SET_DESTNETID_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = destnetid;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_SET_DESTNETID_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_SET_DESTNETID_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -1549,7 +1713,7 @@ bool TarvosIII_SetVolatile_DestNetID(uint8_t destnetid)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
+bool TarvosIII_SetVolatile_DestAddrEx(TarvosIII_Handle_t *handleP, uint8_t destaddr_lsb, uint8_t destaddr_msb)
 {
     bool ret = false;
 
@@ -1566,7 +1730,7 @@ bool TarvosIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
     uint8_t CMD_ARRAY[6];
 
     /* fill CMD_ARRAY packet */
-    switch (addressmode)
+    switch (handleP->addressmode)
     {
     case AddressMode_0:
     case AddressMode_1:
@@ -1576,7 +1740,7 @@ bool TarvosIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
         CMD_ARRAY[1] = TarvosIII_CMD_SET_DESTADDR_REQ;
         CMD_ARRAY[2] = 0x01;
         CMD_ARRAY[3] = destaddr_lsb;
-        ret = FillChecksum(CMD_ARRAY,5);
+        ret = FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,5);
     }
     break;
     case AddressMode_3:
@@ -1586,7 +1750,7 @@ bool TarvosIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
         CMD_ARRAY[2] = 0x02;
         CMD_ARRAY[3] = destaddr_lsb;
         CMD_ARRAY[4] = destaddr_msb;
-        ret = FillChecksum(CMD_ARRAY,6);
+        ret = FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,6);
     }
     break;
     default:
@@ -1595,11 +1759,14 @@ bool TarvosIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
 
     if(ret == true)
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, TarvosIII_CMD_SET_DESTADDR_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_SET_DESTADDR_CNF, CMD_Status_Success, true);
+        if(SendRequest(handleP, CMD_ARRAY, sizeof(CMD_ARRAY), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -1614,7 +1781,7 @@ bool TarvosIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_Transmit(uint8_t* payload, uint8_t length)
+bool TarvosIII_TransmitEx(TarvosIII_Handle_t *handleP, uint8_t* payload, uint8_t length)
 {
     bool ret = false;
 
@@ -1624,24 +1791,54 @@ bool TarvosIII_Transmit(uint8_t* payload, uint8_t length)
         return false;
     }
 
-    /* fill CMD_ARRAY packet */
-    uint8_t CMD_ARRAY[length + 4];
-    CMD_ARRAY[0] = CMD_STX;
-    CMD_ARRAY[1] = TarvosIII_CMD_DATA_REQ;
-    CMD_ARRAY[2] = length;
-    memcpy(&CMD_ARRAY[3],payload,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
-    {
-
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
+    /* fill header, the payload is sent from the buffer of the caller */
+    uint8_t header[3];
+    header[0] = CMD_STX;
+    header[1] = TarvosIII_CMD_DATA_REQ;
+    header[2] = length;
 
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, TarvosIII_CMD_DATA_CNF, NULL, 0);
+    /* answered once the data was sent over the air */
+    CommandQueue_SetFixedTimeout(&request);
+    if(SendCommand(handleP, header, sizeof(header), payload, length, &request))
+    {
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_DATA_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
     }
     return ret;
 }
 
+/*
+ *Transmit data without waiting for the confirmation
+ *
+ *input:
+ * -payload:  pointer to the data, copied before returning
+ * -length:   length of the data
+ * -cb:       called with the result of the request
+ * -contextP: passed to cb
+ *
+ *note: cb is called by a thread of the driver instance, it must not block for long
+ *
+ *return true if the request was queued, cb is called exactly once then
+ *       false otherwise
+ */
+bool TarvosIII_TransmitAsyncEx(TarvosIII_Handle_t *handleP, uint8_t* payload, uint8_t length, TarvosIII_CommandCallback cb, void* contextP)
+{
+    if(length > MAX_PAYLOAD_LENGTH)
+    {
+        fprintf(stdout, "Data exceeds maximal payload length\n");
+        return false;
+    }
+
+    uint8_t header[3];
+    header[0] = CMD_STX;
+    header[1] = TarvosIII_CMD_DATA_REQ;
+    header[2] = length;
+
+    return SendCommandAsync(handleP, header, sizeof(header), payload, length, TarvosIII_CMD_DATA_CNF, 1, cb, contextP);
+}
+
 /*
  *Transmit data
  *
@@ -1656,7 +1853,7 @@ bool TarvosIII_Transmit(uint8_t* payload, uint8_t length)
  *return true if request succeeded
  *       false otherwise
  */
-bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t channel, uint8_t dest_network_id, uint8_t dest_address_lsb, uint8_t dest_address_msb)
+bool TarvosIII_Transmit_ExtendedEx(TarvosIII_Handle_t *handleP, uint8_t* payload, uint8_t length, uint8_t channel, uint8_t dest_network_id, uint8_t dest_address_lsb, uint8_t dest_address_msb)
 {
     bool ret = false;
 
@@ -1666,18 +1863,17 @@ bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t chann
         return false;
     }
 
-    /* fill CMD_ARRAY packet */
-    uint8_t CMD_ARRAY[length + addressmode + 4 + 1];
+    /* fill header, the payload is sent from the buffer of the caller */
+    uint8_t CMD_ARRAY[7];
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TarvosIII_CMD_DATAEX_REQ;
 
-    switch (addressmode)
+    switch (handleP->addressmode)
     {
     case AddressMode_0:
     {
         CMD_ARRAY[2] = (length + 1);
         CMD_ARRAY[3] = channel;
-        memcpy(&CMD_ARRAY[4],payload,length);
     }
     break;
 
@@ -1686,7 +1882,6 @@ bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t chann
         CMD_ARRAY[2] = (length + 2);
         CMD_ARRAY[3] = channel;
         CMD_ARRAY[4] = dest_address_lsb;
-        memcpy(&CMD_ARRAY[5],payload,length);
     }
     break;
 
@@ -1696,7 +1891,6 @@ bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t chann
         CMD_ARRAY[3] = channel;
         CMD_ARRAY[4] = dest_network_id;
         CMD_ARRAY[5] = dest_address_lsb;
-        memcpy(&CMD_ARRAY[6],payload,length);
     }
     break;
 
@@ -1707,7 +1901,6 @@ bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t chann
         CMD_ARRAY[4] = dest_network_id;
         CMD_ARRAY[5] = dest_address_lsb;
         CMD_ARRAY[6] = dest_address_msb;
-        memcpy(&CMD_ARRAY[7],payload,length);
     }
     break;
 
@@ -1716,13 +1909,14 @@ bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t chann
         return false;
     }
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, TarvosIII_CMD_DATA_CNF, NULL, 0);
+    /* answered once the data was sent over the air */
+    CommandQueue_SetFixedTimeout(&request);
+    if(SendCommand(handleP, CMD_ARRAY, 4 + handleP->addressmode, payload, length, &request))
     {
-        /* now send CMD_ARRAY */
-        SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
-
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TarvosIII_CMD_DATA_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(handleP, &request, CMD_WAIT_TIME, CMD_Status_Success);
     }
     return ret;
 }
@@ -1737,16 +1931,22 @@ bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t chann
  *return true if request succeeded
  *       false otherwise
 */
-bool TarvosIII_Ping()
+bool TarvosIII_PingEx(TarvosIII_Handle_t *handleP)
 {
     /* rf-profil 5, ch134, +14dbm, 10 packets */
     uint8_t ping_command[] = {0x02,0x1F,0x08,0x20,0x05,0x86,0x0E,0x0A,0xFF,0xFF,0xFF,0x4D};
 
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, TarvosIII_CMD_PINGDUT_CNF, NULL, 0);
+    /* answered once the ping test finished */
+    CommandQueue_SetFixedTimeout(&request);
     /* now send the data */
-    SendBytes(ping_command,sizeof(ping_command));
-
-    /* wait for cnf */
-    return Wait4CNF(10000 /*10s*/, TarvosIII_CMD_PINGDUT_CNF, CMD_Status_Success, true);
+    if(SendRequest(handleP, ping_command, sizeof(ping_command), &request))
+    {
+        /* wait for cnf */
+        return Wait4CNF(handleP, &request, 10000 /*10s*/, CMD_Status_Success);
+    }
+    return false;
 }
 
 /*
@@ -1757,36 +1957,38 @@ bool TarvosIII_Ping()
  * -config_length: length of the configuration struct
  * -factory_reset: apply a factory reset before or not
  *
+ *note: only the settings whose values differ are written, the module is reset only if a setting was written
+ *
  *return true if request succeeded
  *       false otherwise
 */
-bool TarvosIII_Configure(TarvosIII_Configuration_t* config, uint8_t config_length, bool factory_reset)
+bool TarvosIII_ConfigureEx(TarvosIII_Handle_t *handleP, TarvosIII_Configuration_t* config, uint8_t config_length, bool factory_reset)
 {
     int i = 0;
     uint8_t help_length;
     uint8_t help[MAX_USERSETTING_LENGTH];
+    bool changed[UINT8_MAX];
+    bool update = false;
 
     if(factory_reset)
     {
-        /* perform a factory reset */
-        if(false == TarvosIII_FactoryReset())
+        /* perform a factory reset, the module restarts with the default settings */
+        if(false == FactoryReset(handleP, true))
         {
             /* error */
             return false;
         }
     }
-    delay(500);
 
-    /* now check all settings and update them if necessary */
+    /* now check all settings, the module has no request to read several of them at once */
     for(i=0; i<config_length; i++)
     {
         /* read current value */
-        if(false == TarvosIII_Get(config[i].usersetting, help, &help_length))
+        if(false == TarvosIII_GetEx(handleP, config[i].usersetting, help, &help_length))
         {
             /* error */
             return false;
         }
-        delay(200);
 
         /* check the value read out */
         if(help_length != config[i].value_length)
@@ -1794,22 +1996,283 @@ bool TarvosIII_Configure(TarvosIII_Configuration_t* config, uint8_t config_lengt
             /* error, length does not match */
             return false;
         }
-        if(memcmp(help,config[i].value,config[i].value_length) != 0)
+        changed[i] = (memcmp(help,config[i].value,config[i].value_length) != 0);
+    }
+
+    /* and update those that are not up to date */
+    for(i=0; i<config_length; i++)
+    {
+        if(changed[i])
         {
-            /* read value is not up to date, thus write the new value */
-            if(false == TarvosIII_Set(config[i].usersetting, config[i].value, config[i].value_length))
+            if(false == TarvosIII_SetEx(handleP, config[i].usersetting, config[i].value, config[i].value_length))
             {
                 /* error */
                 return false;
             }
+            update = true;
+        }
+    }
+
+    if(update)
+    {
+        /* reset to take effect of the updated parameters */
+        if(false == TarvosIII_PinResetEx(handleP))
+        {
+            return false;
         }
-        delay(200);
     }
+    return true;
+}
 
-    /* reset to take effect of the updated parameters */
-    if(false == TarvosIII_PinReset())
+/*
+ *Request the instance whose callback is currently executed,
+ *callbacks use it to tell which module an event belongs to
+ *
+ *return driver instance, if called from a callback
+ *       NULL otherwise
+ */
+TarvosIII_Handle_t *TarvosIII_GetCallbackHandle()
+{
+    return callbackHandleP;
+}
+
+/*
+ *Set the number of requests sent to the module before the first of them is confirmed
+ *
+ *Commands called concurrently, e.g. by several threads, are sent back to back up to
+ *this number, so that their round trips overlap. Confirmations are matched to the
+ *requests in the order of sending.
+ *
+ *input:
+ * -depth: requests in flight, 1 (default) waits for each confirmation before the next request is sent
+ *
+ *note: use a depth above 1 only with a firmware that accepts requests while a
+ *      previous request is processed
+ *
+ *return true if succeeded
+ *       false otherwise
+ */
+bool TarvosIII_SetPipelineDepthEx(TarvosIII_Handle_t *handleP, uint8_t depth)
+{
+    if((handleP == NULL) || (depth == 0))
     {
         return false;
     }
+    CommandQueue_SetDepth(&handleP->cmdQueue, depth);
     return true;
 }
+
+#ifndef GLOBAL_NO_DEFAULT_TRANSPORT
+
+/**************************************
+ *   Functions of the default driver  *
+ *   instance, see TarvosIII_Init    *
+ **************************************/
+
+static TarvosIII_Handle_t *defaultHandleP = NULL;
+
+bool TarvosIII_Init(int baudrate, int rp, int wp, int bp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode)
+{
+    if(defaultHandleP != NULL)
+    {
+        /* already initialized */
+        return false;
+    }
+
+    defaultHandleP = TarvosIII_InitEx(GetDefaultTransport(), baudrate, rp, wp, bp, RXcb, addrmode);
+    return (defaultHandleP != NULL);
+}
+
+bool TarvosIII_Deinit(void)
+{
+    bool ret = TarvosIII_DeinitEx(defaultHandleP);
+    defaultHandleP = NULL;
+    return ret;
+}
+
+bool TarvosIII_SetPipelineDepth(uint8_t depth)
+{
+    return TarvosIII_SetPipelineDepthEx(defaultHandleP, depth);
+}
+
+bool TarvosIII_PinReset(void)
+{
+    return (defaultHandleP != NULL) && TarvosIII_PinResetEx(defaultHandleP);
+}
+
+bool TarvosIII_Reset(void)
+{
+    return (defaultHandleP != NULL) && TarvosIII_ResetEx(defaultHandleP);
+}
+
+bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t channel, uint8_t dest_network_id, uint8_t dest_address_lsb, uint8_t dest_address_msb)
+{
+    return (defaultHandleP != NULL) && TarvosIII_Transmit_ExtendedEx(defaultHandleP, payload, length, channel, dest_network_id, dest_address_lsb, dest_address_msb);
+}
+
+bool TarvosIII_Transmit(uint8_t* payload, uint8_t length)
+{
+    return (defaultHandleP != NULL) && TarvosIII_TransmitEx(defaultHandleP, payload, length);
+}
+
+bool TarvosIII_TransmitAsync(uint8_t* payload, uint8_t length, TarvosIII_CommandCallback cb, void* contextP)
+{
+    return (defaultHandleP != NULL) && TarvosIII_TransmitAsyncEx(defaultHandleP, payload, length, cb, contextP);
+}
+
+bool TarvosIII_Shutdown(void)
+{
+    return (defaultHandleP != NULL) && TarvosIII_ShutdownEx(defaultHandleP);
+}
+
+bool TarvosIII_Standby(void)
+{
+    return (defaultHandleP != NULL) && TarvosIII_StandbyEx(defaultHandleP);
+}
+
+bool TarvosIII_PinWakeup()
+{
+    return (defaultHandleP != NULL) && TarvosIII_PinWakeupEx(defaultHandleP);
+}
+
+bool TarvosIII_Get(TarvosIII_UserSettings_t us, uint8_t* response, uint8_t* response_length)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetEx(defaultHandleP, us, response, response_length);
+}
+
+bool TarvosIII_GetAsync(TarvosIII_UserSettings_t us, TarvosIII_CommandCallback cb, void* contextP)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetAsyncEx(defaultHandleP, us, cb, contextP);
+}
+
+bool TarvosIII_GetFirmwareVersion(uint8_t* fw)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetFirmwareVersionEx(defaultHandleP, fw);
+}
+
+bool TarvosIII_GetSerialNumber(uint8_t* sn)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetSerialNumberEx(defaultHandleP, sn);
+}
+
+bool TarvosIII_GetDefaultTXPower(uint8_t* txpower)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetDefaultTXPowerEx(defaultHandleP, txpower);
+}
+
+bool TarvosIII_GetSourceAddr(uint8_t* srcaddr_lsb, uint8_t* srcaddr_msb)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetSourceAddrEx(defaultHandleP, srcaddr_lsb, srcaddr_msb);
+}
+
+bool TarvosIII_GetSourceNetID(uint8_t* srcnetid)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetSourceNetIDEx(defaultHandleP, srcnetid);
+}
+
+bool TarvosIII_GetDefaultDestAddr(uint8_t* destaddr_lsb, uint8_t* srcaddr_msb)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetDefaultDestAddrEx(defaultHandleP, destaddr_lsb, srcaddr_msb);
+}
+
+bool TarvosIII_GetDefaultDestNetID(uint8_t* destnetid)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetDefaultDestNetIDEx(defaultHandleP, destnetid);
+}
+
+bool TarvosIII_GetDefaultRFChannel(uint8_t* channel)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetDefaultRFChannelEx(defaultHandleP, channel);
+}
+
+bool TarvosIII_GetDefaultRFProfile(uint8_t* profile)
+{
+    return (defaultHandleP != NULL) && TarvosIII_GetDefaultRFProfileEx(defaultHandleP, profile);
+}
+
+bool TarvosIII_FactoryReset(void)
+{
+    return (defaultHandleP != NULL) && TarvosIII_FactoryResetEx(defaultHandleP);
+}
+
+bool TarvosIII_Set(TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetEx(defaultHandleP, us, value, length);
+}
+
+bool TarvosIII_SetAsync(TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length, TarvosIII_CommandCallback cb, void* contextP)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetAsyncEx(defaultHandleP, us, value, length, cb, contextP);
+}
+
+bool TarvosIII_Configure(TarvosIII_Configuration_t* config, uint8_t config_length, bool factory_reset)
+{
+    return (defaultHandleP != NULL) && TarvosIII_ConfigureEx(defaultHandleP, config, config_length, factory_reset);
+}
+
+bool TarvosIII_SetDefaultTXPower(uint8_t txpower)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetDefaultTXPowerEx(defaultHandleP, txpower);
+}
+
+bool TarvosIII_SetSourceAddr(uint8_t srcaddr_lsb, uint8_t srcaddr_msb)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetSourceAddrEx(defaultHandleP, srcaddr_lsb, srcaddr_msb);
+}
+
+bool TarvosIII_SetSourceNetID(uint8_t srcnetid)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetSourceNetIDEx(defaultHandleP, srcnetid);
+}
+
+bool TarvosIII_SetDefaultDestAddr(uint8_t destaddr_lsb, uint8_t srcaddr_msb)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetDefaultDestAddrEx(defaultHandleP, destaddr_lsb, srcaddr_msb);
+}
+
+bool TarvosIII_SetDefaultDestNetID(uint8_t destnetid)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetDefaultDestNetIDEx(defaultHandleP, destnetid);
+}
+
+bool TarvosIII_SetDefaultRFChannel(uint8_t channel)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetDefaultRFChannelEx(defaultHandleP, channel);
+}
+
+bool TarvosIII_SetDefaultRFProfile(uint8_t profile)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetDefaultRFProfileEx(defaultHandleP, profile);
+}
+
+bool TarvosIII_EnableSnifferMode()
+{
+    return (defaultHandleP != NULL) && TarvosIII_EnableSnifferModeEx(defaultHandleP);
+}
+
+bool TarvosIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetVolatile_DestAddrEx(defaultHandleP, destaddr_lsb, destaddr_msb);
+}
+
+bool TarvosIII_SetVolatile_DestNetID(uint8_t destnetid)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetVolatile_DestNetIDEx(defaultHandleP, destnetid);
+}
+
+bool TarvosIII_SetVolatile_TXPower(uint8_t power)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetVolatile_TXPowerEx(defaultHandleP, power);
+}
+
+bool TarvosIII_SetVolatile_Channel(uint8_t channel)
+{
+    return (defaultHandleP != NULL) && TarvosIII_SetVolatile_ChannelEx(defaultHandleP, channel);
+}
+
+bool TarvosIII_Ping()
+{
+    return (defaultHandleP != NULL) && TarvosIII_PingEx(defaultHandleP);
+}
+
+#endif // GLOBAL_NO_DEFAULT_TRANSPORT
@@ -87,15 +87,25 @@ typedef struct TarvosIII_Configuration_t
    uint8_t value_length;
 } TarvosIII_Configuration_t;
 
+/* driver instance, see TarvosIII_InitEx */
+typedef struct TarvosIII_Handle_t TarvosIII_Handle_t;
+struct Transport_t;
+
+/* completion of an asynchronous command (*Async functions), dataP holds the data of the answer,
+ * e.g. the value of a user setting, and is valid until the callback returns */
+typedef void (*TarvosIII_CommandCallback)(bool success, uint8_t* dataP, uint8_t length, void* contextP);
+
 
 extern bool TarvosIII_Init(int baudrate, int rp, int wp, int bp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode);
 extern bool TarvosIII_Deinit(void);
+extern bool TarvosIII_SetPipelineDepth(uint8_t depth);
 
 extern bool TarvosIII_PinReset(void);
 extern bool TarvosIII_Reset(void);
 
 extern bool TarvosIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t channel, uint8_t dest_network_id, uint8_t dest_address_lsb, uint8_t dest_address_msb);
 extern bool TarvosIII_Transmit(uint8_t* payload, uint8_t length);
+extern bool TarvosIII_TransmitAsync(uint8_t* payload, uint8_t length, TarvosIII_CommandCallback cb, void* contextP);
 
 extern bool TarvosIII_Shutdown(void);
 extern bool TarvosIII_Standby(void);
@@ -103,6 +113,7 @@ extern bool TarvosIII_PinWakeup();
 
 /* read the non-volatile settings */
 extern bool TarvosIII_Get(TarvosIII_UserSettings_t us, uint8_t* response, uint8_t* response_length);
+extern bool TarvosIII_GetAsync(TarvosIII_UserSettings_t us, TarvosIII_CommandCallback cb, void* contextP);
 extern bool TarvosIII_GetFirmwareVersion(uint8_t* fw);
 extern bool TarvosIII_GetSerialNumber(uint8_t* sn);
 extern bool TarvosIII_GetDefaultTXPower(uint8_t* txpower);
@@ -119,6 +130,7 @@ extern bool TarvosIII_GetDefaultRFProfile(uint8_t* profile);
  */
 extern bool TarvosIII_FactoryReset(void);
 extern bool TarvosIII_Set(TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length);
+extern bool TarvosIII_SetAsync(TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length, TarvosIII_CommandCallback cb, void* contextP);
 extern bool TarvosIII_Configure(TarvosIII_Configuration_t* config, uint8_t config_length, bool factory_reset);
 extern bool TarvosIII_SetDefaultTXPower(uint8_t txpower);
 extern bool TarvosIII_SetSourceAddr(uint8_t srcaddr_lsb, uint8_t srcaddr_msb);
@@ -137,6 +149,57 @@ extern bool TarvosIII_SetVolatile_Channel(uint8_t channel);
 
 extern bool TarvosIII_Ping();
 
+/* the functions above act on the default driver instance created by TarvosIII_Init,
+ * the functions below act on the driver instance given by handleP, so that several
+ * modules can be used side by side on different transports */
+extern TarvosIII_Handle_t *TarvosIII_InitEx(struct Transport_t *transportP, int baudrate, int rp, int wp, int bp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TarvosIII_AddressMode_t addrmode);
+extern bool TarvosIII_DeinitEx(TarvosIII_Handle_t *handleP);
+extern TarvosIII_Handle_t *TarvosIII_GetCallbackHandle();
+extern bool TarvosIII_SetPipelineDepthEx(TarvosIII_Handle_t *handleP, uint8_t depth);
+
+extern bool TarvosIII_PinResetEx(TarvosIII_Handle_t *handleP);
+extern bool TarvosIII_ResetEx(TarvosIII_Handle_t *handleP);
+
+extern bool TarvosIII_Transmit_ExtendedEx(TarvosIII_Handle_t *handleP, uint8_t* payload, uint8_t length, uint8_t channel, uint8_t dest_network_id, uint8_t dest_address_lsb, uint8_t dest_address_msb);
+extern bool TarvosIII_TransmitEx(TarvosIII_Handle_t *handleP, uint8_t* payload, uint8_t length);
+extern bool TarvosIII_TransmitAsyncEx(TarvosIII_Handle_t *handleP, uint8_t* payload, uint8_t length, TarvosIII_CommandCallback cb, void* contextP);
+
+extern bool TarvosIII_ShutdownEx(TarvosIII_Handle_t *handleP);
+extern bool TarvosIII_StandbyEx(TarvosIII_Handle_t *handleP);
+extern bool TarvosIII_PinWakeupEx(TarvosIII_Handle_t *handleP);
+
+extern bool TarvosIII_GetEx(TarvosIII_Handle_t *handleP, TarvosIII_UserSettings_t us, uint8_t* response, uint8_t* response_length);
+extern bool TarvosIII_GetAsyncEx(TarvosIII_Handle_t *handleP, TarvosIII_UserSettings_t us, TarvosIII_CommandCallback cb, void* contextP);
+extern bool TarvosIII_GetFirmwareVersionEx(TarvosIII_Handle_t *handleP, uint8_t* fw);
+extern bool TarvosIII_GetSerialNumberEx(TarvosIII_Handle_t *handleP, uint8_t* sn);
+extern bool TarvosIII_GetDefaultTXPowerEx(TarvosIII_Handle_t *handleP, uint8_t* txpower);
+extern bool TarvosIII_GetSourceAddrEx(TarvosIII_Handle_t *handleP, uint8_t* srcaddr_lsb, uint8_t* srcaddr_msb);
+extern bool TarvosIII_GetSourceNetIDEx(TarvosIII_Handle_t *handleP, uint8_t* srcnetid);
+extern bool TarvosIII_GetDefaultDestAddrEx(TarvosIII_Handle_t *handleP, uint8_t* destaddr_lsb, uint8_t* srcaddr_msb);
+extern bool TarvosIII_GetDefaultDestNetIDEx(TarvosIII_Handle_t *handleP, uint8_t* destnetid);
+extern bool TarvosIII_GetDefaultRFChannelEx(TarvosIII_Handle_t *handleP, uint8_t* channel);
+extern bool TarvosIII_GetDefaultRFProfileEx(TarvosIII_Handle_t *handleP, uint8_t* profile);
+
+extern bool TarvosIII_FactoryResetEx(TarvosIII_Handle_t *handleP);
+extern bool TarvosIII_SetEx(TarvosIII_Handle_t *handleP, TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length);
+extern bool TarvosIII_SetAsyncEx(TarvosIII_Handle_t *handleP, TarvosIII_UserSettings_t us, uint8_t* value, uint8_t length, TarvosIII_CommandCallback cb, void* contextP);
+extern bool TarvosIII_ConfigureEx(TarvosIII_Handle_t *handleP, TarvosIII_Configuration_t* config, uint8_t config_length, bool factory_reset);
+extern bool TarvosIII_SetDefaultTXPowerEx(TarvosIII_Handle_t *handleP, uint8_t txpower);
+extern bool TarvosIII_SetSourceAddrEx(TarvosIII_Handle_t *handleP, uint8_t srcaddr_lsb, uint8_t srcaddr_msb);
+extern bool TarvosIII_SetSourceNetIDEx(TarvosIII_Handle_t *handleP, uint8_t srcnetid);
+extern bool TarvosIII_SetDefaultDestAddrEx(TarvosIII_Handle_t *handleP, uint8_t destaddr_lsb, uint8_t srcaddr_msb);
+extern bool TarvosIII_SetDefaultDestNetIDEx(TarvosIII_Handle_t *handleP, uint8_t destnetid);
+extern bool TarvosIII_SetDefaultRFChannelEx(TarvosIII_Handle_t *handleP, uint8_t channel);
+extern bool TarvosIII_SetDefaultRFProfileEx(TarvosIII_Handle_t *handleP, uint8_t profile);
+extern bool TarvosIII_EnableSnifferModeEx(TarvosIII_Handle_t *handleP);
+
+extern bool TarvosIII_SetVolatile_DestAddrEx(TarvosIII_Handle_t *handleP, uint8_t destaddr_lsb, uint8_t destaddr_msb);
+extern bool TarvosIII_SetVolatile_DestNetIDEx(TarvosIII_Handle_t *handleP, uint8_t destnetid);
+extern bool TarvosIII_SetVolatile_TXPowerEx(TarvosIII_Handle_t *handleP, uint8_t power);
+extern bool TarvosIII_SetVolatile_ChannelEx(TarvosIII_Handle_t *handleP, uint8_t channel);
+
+extern bool TarvosIII_PingEx(TarvosIII_Handle_t *handleP);
+
 #endif // _TarvosIII_defined
 #ifdef __cplusplus
 }
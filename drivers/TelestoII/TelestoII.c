@@ -37,6 +37,7 @@
 
 #define CMD_WAIT_TIME 500
 #define MAX_PAYLOAD_LENGTH 128
+#define MAX_GETMULTIPLE_LENGTH (MAX_PAYLOAD_LENGTH - 2)  /* the GET_CNF starts with memory position and length */
 #define MAX_DATA_BUFFER 255
 #define TXPOWERINVALID -128
 #define CHANNELINVALID -1
@@ -146,9 +147,10 @@ typedef struct
  *     Static function declarations   *
  **************************************/
 
-static void HandleRxPacket(uint8_t* RxBuffer);                                                                                  /* RX packet interpreter */
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                                                  /* RX packet interpreter */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);   /* wait for response, when a command was sent to the TelestoII */
-static bool FillChecksum(uint8_t* array, uint8_t length);                                       /* add the CS needed to finalize the command */
+static void ClearCNF();
+static bool CompareConfiguration(TelestoII_Configuration_t* config, uint8_t config_length, bool* changed); /* find the settings to be written */
 static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TelestoII_AddressMode_t addrmode);
 
 
@@ -156,22 +158,26 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8
  *          Static variables          *
  **************************************/
 
-CMD_Frame_t RxPacket;                       /* data buffer for RX */
-bool AbortUartRxThread;                     /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                     /* boolean to reset the UART RX thread */
+/* command frames of the module: STX, CMD, 8 bit LEN, DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 1, HandleRxPacket };
 
-pthread_t thread_read;
+static CMD_Frame_t RxPacket;                /* data buffer for RX */
+static int rxThreadEvent = -1;                  /* eventfd to reset or abort the UART RX thread */
+
+static pthread_t thread_read;
 
 #define CMDCONFIRMATIONARRAY_LENGTH 2
 
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
-US_Confirmation_t usConfirmation;           /* variable used to check if GET function was successfull */
-uint8_t powerVolatile = TXPOWERINVALID;     /* variable used to check if setting the TXPower was successfull */
+static CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
+static pthread_mutex_t cmdConfirmation_mutex = PTHREAD_MUTEX_INITIALIZER;  /* protects cmdConfirmation_array */
+static pthread_cond_t cmdConfirmation_cond = PTHREAD_COND_INITIALIZER;     /* signalled when a confirmation was stored */
+static US_Confirmation_t usConfirmation;    /* variable used to check if GET function was successfull */
+static uint8_t powerVolatile = TXPOWERINVALID; /* variable used to check if setting the TXPower was successfull */
 
-int reset_pin;                              /* reset pin number */
+static int reset_pin;                       /* reset pin number */
 
-void(*RXcallback)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t);       /* callback function */
-TelestoII_AddressMode_t addressmode = AddressMode_0;                        /* initial address mode */
+static void(*RXcallback)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t); /* callback function */
+static TelestoII_AddressMode_t addressmode = AddressMode_0;                 /* initial address mode */
 
 
 /**************************************
@@ -179,94 +185,16 @@ TelestoII_AddressMode_t addressmode = AddressMode_0;                        /* i
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint8_t RxByteCounter = 0;
-    uint8_t BytesToReceive = 0;
-    uint8_t readBuffer;
     static uint8_t RxBuffer[sizeof(CMD_Frame_t)]; /* data buffer for RX */
-
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    FrameCodec_t codec;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
-    while(1)
-    {
-        /* wait for 10ms, then check if new RX data is available */
-        delay (10);
-
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
 
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
-
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
-
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for start byte of frame */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field */
-                    RxByteCounter++;
-                    BytesToReceive = (RxBuffer[RxByteCounter - 1] + 4); /* len + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
-    }
+    FrameCodec_Init(&codec, &frameProtocol, RxBuffer, sizeof(RxBuffer), NULL);
+    FrameCodec_RxLoop(&codec, GetDefaultTransport(), rxThreadEvent);
     return 0;
 }
 
@@ -291,20 +219,35 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8
     /* set RX callback function */
     RXcallback = RXcb;
 
+    /* confirmations are waited for with CLOCK_MONOTONIC deadlines */
+    if(!InitMonotonicCond(&cmdConfirmation_cond))
+    {
+        fprintf(stdout, "Failed to initialize confirmation condition\n");
+        TelestoII_Deinit();
+        return false;
+    }
+
+    /* create the event to reset and abort the RX thread */
+    rxThreadEvent = RxThreadEvent_Create();
+    if(rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        TelestoII_Deinit();
+        return false;
+    }
+
     /* start RX thread */
     if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
     {
         fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
         TelestoII_Deinit();
         return false;
     }
 
-    /* reset module*/
-    if(TelestoII_PinReset())
-    {
-        delay(300);
-    }
-    else
+    /* reset module, it accepts requests as soon as it sent its SETMODE_CNF */
+    if(false == TelestoII_PinReset())
     {
         fprintf(stdout, "Pin Reset failed\n");
         TelestoII_Deinit();
@@ -329,7 +272,7 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8
 
 
 /* interprete the valid received data packet */
-static void HandleRxPacket(uint8_t*RxBuffer)
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer)
 {
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
@@ -546,25 +489,30 @@ static void HandleRxPacket(uint8_t*RxBuffer)
     }
 
     int i = 0;
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
         if(cmdConfirmation_array[i].cmd == CNFINVALID)
         {
             cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
             cmdConfirmation_array[i].status = cmdConfirmation.status;
+            pthread_cond_broadcast(&cmdConfirmation_cond);
             break;
         }
     }
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 /* function that waits for the return value of TelestoII (*_CNF), when a command (*_REQ) was sent before */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
+    struct timespec deadline;
+    int waitResult = 0;
     int i = 0;
 
+    GetDeadline(&deadline, max_time_ms);
+
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     if(reset_confirmstate)
     {
         for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
@@ -578,43 +526,38 @@ static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Statu
         {
             if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
             {
-                return (cmdConfirmation_array[i].status == expectedStatus);
+                bool ret = (cmdConfirmation_array[i].status == expectedStatus);
+                pthread_mutex_unlock(&cmdConfirmation_mutex);
+                return ret;
             }
         }
 
-        if (count >= max_count)
+        if (waitResult == ETIMEDOUT)
         {
             /* received no correct response within timeout */
+            pthread_mutex_unlock(&cmdConfirmation_mutex);
             return false;
         }
 
-        /* wait */
-        count++;
-        delay(time_step_ms);
+        /* sleep until HandleRxPacket stored a confirmation */
+        waitResult = pthread_cond_timedwait(&cmdConfirmation_cond, &cmdConfirmation_mutex, &deadline);
     }
     return true;
 }
 
-/* function to add the checksum at the end of the data packet */
-static bool FillChecksum(uint8_t* array, uint8_t length)
+/* function that discards all received confirmations, call it before the request is sent
+ * so that a fast confirmation can not be discarded by Wait4CNF */
+static void ClearCNF()
 {
-    bool ret = false;
+    int i = 0;
 
-    if ((length >= 4) && (array[0] == CMD_STX))
+    pthread_mutex_lock(&cmdConfirmation_mutex);
+    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
-        uint8_t checksum = 0;
-        uint8_t payload_length = array[2];
-        int i = 0;
-        for (i = 0;
-                i < payload_length + 3;
-                i++)
-        {
-            checksum ^= array[i];
-        }
-        array[payload_length + 3] = checksum;
-        ret = true;
+        cmdConfirmation_array[i].status = CMD_Status_Invalid;
+        cmdConfirmation_array[i].cmd = CNFINVALID;
     }
-    return ret;
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 /**************************************
@@ -665,7 +608,6 @@ bool TelestoII_Init(int baudrate, int rp, void(*RXcb)(uint8_t*,uint8_t,uint8_t,u
      */
     reset_pin = rp;
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
 
 	/* empty the UART buffers */
     FlushSerial();
@@ -687,7 +629,13 @@ bool TelestoII_Deinit()
     DeinitSerial();
 
     /* abort RX thread */
-    AbortUartRxThread = true;
+    if(rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(thread_read, NULL);
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
+    }
 
     /* deinit pins */
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
@@ -713,7 +661,8 @@ bool TelestoII_PinReset()
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
     FlushSerial();
-    ResetUartRxThread = true;
+    RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_RESET);
+    ClearCNF();
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
 
@@ -721,7 +670,7 @@ bool TelestoII_PinReset()
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SETMODE_CNF, CMD_Status_Success, true);
+    return Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SETMODE_CNF, CMD_Status_Success, false);
 }
 
 /*
@@ -739,13 +688,14 @@ bool TelestoII_Reset()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TelestoII_CMD_RESET_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_RESET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_RESET_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -769,13 +719,14 @@ bool TelestoII_FactoryReset()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TelestoII_CMD_FACTORY_RESET_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_FACTORY_RESET_CNF CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_FACTORY_RESET_CNF CMD_Status_Success, false);
     }
     return ret;
 #else
@@ -838,16 +789,17 @@ bool TelestoII_Get(TelestoII_UserSettings_t us, uint8_t* response, uint8_t* resp
         break;
     }
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         usConfirmation.memoryPosition = us;
         usConfirmation.lengthGetRequest = CMD_ARRAY[4];
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_GET_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_GET_CNF, CMD_Status_Success, false))
         {
             int length = RxPacket.Length - 2;
             memcpy(response,&RxPacket.Data[2],length);
@@ -885,16 +837,17 @@ bool TelestoII_GetMultiple(uint8_t startAddress, uint8_t lengthToRead, uint8_t *
     CMD_ARRAY[3] = startAddress;
     CMD_ARRAY[4] = lengthToRead;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         usConfirmation.memoryPosition = startAddress;
         usConfirmation.lengthGetRequest = CMD_ARRAY[4];
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_GET_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_GET_CNF, CMD_Status_Success, false))
         {
             int length = RxPacket.Length - 2;
             memcpy(response,&RxPacket.Data[2],length);
@@ -933,13 +886,14 @@ bool TelestoII_Set(TelestoII_UserSettings_t us, uint8_t* value, uint8_t length)
     CMD_ARRAY[3] = us;
     CMD_ARRAY[4] = length;
     memcpy(&CMD_ARRAY[5],value,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SET_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -961,13 +915,14 @@ bool TelestoII_GetFirmwareVersion(uint8_t* fw)
     CMD_ARRAY[2] = 0;
 
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_GET_FWRELEASE_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_GET_FWRELEASE_CNF, CMD_Status_Success, false))
         {
             memcpy(fw,&RxPacket.Data[0],RxPacket.Length);
             return true;
@@ -992,13 +947,14 @@ bool TelestoII_GetSerialNumber(uint8_t* sn)
     CMD_ARRAY[1] = TelestoII_CMD_GET_SERIALNO_REQ;
     CMD_ARRAY[2] = 0;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_GET_SERIALNO_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_GET_SERIALNO_CNF, CMD_Status_Success, false))
         {
             memcpy(sn,&RxPacket.Data[0],RxPacket.Length);
             return true;
@@ -1278,7 +1234,7 @@ bool TelestoII_SetVolatile_TXPower(int8_t power)
     CMD_ARRAY[1] = TelestoII_CMD_SET_PAPOWER_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = power;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
 
         /*
@@ -1287,11 +1243,12 @@ bool TelestoII_SetVolatile_TXPower(int8_t power)
          */
         powerVolatile = power;
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SET_PAPOWER_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SET_PAPOWER_CNF, CMD_Status_Success, false);
         powerVolatile = -1;
     }
     return ret;
@@ -1319,13 +1276,14 @@ bool TelestoII_SetVolatile_DestNetID(uint8_t destnetid)
     CMD_ARRAY[1] = TelestoII_CMD_SET_DESTNETID_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = destnetid;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SET_DESTNETID_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SET_DESTNETID_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1362,7 +1320,7 @@ bool TelestoII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
         CMD_ARRAY[1] = TelestoII_CMD_SET_DESTADDR_REQ;
         CMD_ARRAY[2] = 0x01;
         CMD_ARRAY[3] = destaddr_lsb;
-        ret = FillChecksum(CMD_ARRAY,5);
+        ret = FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,5);
     }
     break;
 
@@ -1373,11 +1331,12 @@ bool TelestoII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
 
     if(ret == true)
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SET_DESTADDR_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SET_DESTADDR_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1408,13 +1367,14 @@ bool TelestoII_Transmit(uint8_t* payload, uint8_t length)
     CMD_ARRAY[1] = TelestoII_CMD_DATA_REQ;
     CMD_ARRAY[2] = length;
     memcpy(&CMD_ARRAY[3],payload,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_DATA_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_DATA_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1481,17 +1441,96 @@ bool TelestoII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t dest_
         return false;
     }
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_DATA_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_DATA_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
 
+/*
+ *Read the settings of a configuration with as few GET requests as possible and compare them locally
+ *
+ *input:
+ * -config: pointer to the configuration struct
+ * -config_length: length of the configuration struct
+ *
+ *output:
+ * -changed: true for each setting whose value differs from the configuration
+ *
+ *return true if all settings were read
+ *       false otherwise
+ */
+static bool CompareConfiguration(TelestoII_Configuration_t* config, uint8_t config_length, bool* changed)
+{
+    bool read[UINT8_MAX];
+    uint8_t response[MAX_GETMULTIPLE_LENGTH];
+    uint8_t response_length;
+    int i;
+
+    for(i=0; i<config_length; i++)
+    {
+        if((config[i].value_length == 0) || (config[i].value_length > MAX_USERSETTING_LENGTH))
+        {
+            /* error, invalid length */
+            return false;
+        }
+        read[i] = false;
+    }
+
+    while(true)
+    {
+        int first = -1;
+        int end = 0;
+
+        /* the next request starts at the lowest memory position not read yet */
+        for(i=0; i<config_length; i++)
+        {
+            if(!read[i] && ((first < 0) || (config[i].usersetting < config[first].usersetting)))
+            {
+                first = i;
+            }
+        }
+        if(first < 0)
+        {
+            /* all settings read */
+            return true;
+        }
+
+        /* and covers all further settings that fit into its answer */
+        for(i=0; i<config_length; i++)
+        {
+            if(!read[i] && (config[i].usersetting >= config[first].usersetting) && (config[i].usersetting + config[i].value_length <= config[first].usersetting + MAX_GETMULTIPLE_LENGTH))
+            {
+                read[i] = true;
+                if(config[i].usersetting + config[i].value_length > end)
+                {
+                    end = config[i].usersetting + config[i].value_length;
+                }
+            }
+        }
+        if((false == TelestoII_GetMultiple(config[first].usersetting, end - config[first].usersetting, response, &response_length)) ||
+           (response_length != end - config[first].usersetting))
+        {
+            /* error */
+            return false;
+        }
+
+        for(i=0; i<config_length; i++)
+        {
+            if(read[i] && (config[i].usersetting >= config[first].usersetting) && (config[i].usersetting + config[i].value_length <= end))
+            {
+                changed[i] = (memcmp(&response[config[i].usersetting - config[first].usersetting], config[i].value, config[i].value_length) != 0);
+            }
+        }
+    }
+}
+
 /*
  *Configure the TelestoII
  *
@@ -1500,59 +1539,55 @@ bool TelestoII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t dest_
  * -config_length: length of the configuration struct
  * -factory_reset: apply a factory reset before or not
  *
+ *note: only the settings whose values differ are written, the module is reset only if a setting was written
+ *
  *return true if request succeeded
  *       false otherwise
 */
 bool TelestoII_Configure(TelestoII_Configuration_t* config, uint8_t config_length, bool factory_reset)
 {
     int i = 0;
-    uint8_t help_length;
-    uint8_t help[MAX_USERSETTING_LENGTH];
+    bool changed[UINT8_MAX];
+    bool update = false;
 #ifdef _USE_FACTORY_RESET
     if(factory_reset)
     {
-        /* perform a factory reset */
-        if(false == TelestoII_FactoryReset())
+        /* perform a factory reset, the module restarts with the default settings */
+        if((false == TelestoII_FactoryReset()) || (false == Wait4CNF(CMD_WAIT_TIME, TelestoII_CMD_SETMODE_CNF, CMD_Status_Success, false)))
         {
             /* error */
             return false;
         }
     }
-    delay(500);
 #endif
-    /* now check all settings and update them if necessary */
-    for(i=0; i<config_length; i++)
+    /* now check all settings */
+    if(false == CompareConfiguration(config, config_length, changed))
     {
-        /* read current value */
-        if(false == TelestoII_Get(config[i].usersetting, help, &help_length))
-        {
-            /* error */
-            return false;
-        }
-        delay(200);
+        /* error */
+        return false;
+    }
 
-        /* check the value read out */
-        if(help_length != config[i].value_length)
-        {
-            /* error, length does not match */
-            return false;
-        }
-        if(memcmp(help,config[i].value,config[i].value_length) != 0)
+    /* and update those that are not up to date */
+    for(i=0; i<config_length; i++)
+    {
+        if(changed[i])
         {
-            /* read value is not up to date, thus write the new value */
             if(false == TelestoII_Set(config[i].usersetting, config[i].value, config[i].value_length))
             {
                 /* error */
                 return false;
             }
+            update = true;
         }
-        delay(200);
     }
 
-    /* reset to take effect of the updated parameters */
-    if(false == TelestoII_PinReset())
+    if(update)
     {
-        return false;
+        /* reset to take effect of the updated parameters */
+        if(false == TelestoII_PinReset())
+        {
+            return false;
+        }
     }
     return true;
 }
@@ -142,32 +142,36 @@ typedef struct
  *     Static function declarations   *
  **************************************/
 
-static void HandleRxPacket(uint8_t*RxBuffer);                                                      /* RX packet interpreter */
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                     /* RX packet interpreter */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);
-static bool FillChecksum(uint8_t* array, uint8_t length);                                           /* add the CS needed to finalize the command */
+static void ClearCNF();
 static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t), TelestoIII_AddressMode_t addrmode);
 
 /**************************************
  *          Static variables          *
  **************************************/
 
-int reset_pin;                             /* reset pin number */
-int wakeup_pin;                            /* wakeup pin number */
-int boot_pin;                              /* boot pin number */
-CMD_Frame_t RxPacket;                      /* data buffer for RX */
-bool AbortUartRxThread;                    /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                    /* boolean to reset the UART RX thread */
+/* command frames of the module: STX, CMD, 8 bit LEN, DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 1, HandleRxPacket };
 
-pthread_t thread_read;
+static int reset_pin;                      /* reset pin number */
+static int wakeup_pin;                     /* wakeup pin number */
+static int boot_pin;                       /* boot pin number */
+static CMD_Frame_t RxPacket;               /* data buffer for RX */
+static int rxThreadEvent = -1;                  /* eventfd to reset or abort the UART RX thread */
 
-void(*RXcallback)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t); /* callback function */
+static pthread_t thread_read;
+
+static void(*RXcallback)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8_t); /* callback function */
 
 #define CMDCONFIRMATIONARRAY_LENGTH 2
 
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
-uint8_t channelVolatile = CHANNELINVALID;           /* variable used to check if setting the channel was successfull */
-uint8_t powerVolatile = TXPOWERINVALID;             /* variable used to check if setting the TXPower was successfull */
-TelestoIII_AddressMode_t addressmode = AddressMode_0;  /* initial address mode */
+static CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
+static pthread_mutex_t cmdConfirmation_mutex = PTHREAD_MUTEX_INITIALIZER;  /* protects cmdConfirmation_array */
+static pthread_cond_t cmdConfirmation_cond = PTHREAD_COND_INITIALIZER;     /* signalled when a confirmation was stored */
+static uint8_t channelVolatile = CHANNELINVALID;    /* variable used to check if setting the channel was successfull */
+static uint8_t powerVolatile = TXPOWERINVALID;      /* variable used to check if setting the TXPower was successfull */
+static TelestoIII_AddressMode_t addressmode = AddressMode_0; /* initial address mode */
 
 
 /**************************************
@@ -175,100 +179,21 @@ TelestoIII_AddressMode_t addressmode = AddressMode_0;  /* initial address mode *
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint8_t RxByteCounter = 0;
-    uint8_t BytesToReceive = 0;
-    uint8_t readBuffer;
     static uint8_t RxBuffer[sizeof(CMD_Frame_t)]; /* data buffer for RX */
-
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    FrameCodec_t codec;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
 
-    while(1)
-    {
-        /* wait for 1ms, then check if new RX data is available */
-        delay (1) ;
-
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
-
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
-
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
-
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for start byte of frame */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field */
-                    RxByteCounter++;
-                    BytesToReceive = (RxBuffer[RxByteCounter - 1] + 4); /* len + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
-    }
+    FrameCodec_Init(&codec, &frameProtocol, RxBuffer, sizeof(RxBuffer), NULL);
+    FrameCodec_RxLoop(&codec, GetDefaultTransport(), rxThreadEvent);
     return 0;
 }
 
 /* interprete the valid received UART data packet */
-static void HandleRxPacket(uint8_t*RxBuffer)
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer)
 {
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
@@ -522,25 +447,30 @@ static void HandleRxPacket(uint8_t*RxBuffer)
     }
 
     int i = 0;
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
         if(cmdConfirmation_array[i].cmd == CNFINVALID)
         {
             cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
             cmdConfirmation_array[i].status = cmdConfirmation.status;
+            pthread_cond_broadcast(&cmdConfirmation_cond);
             break;
         }
     }
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 /* function that waits for the return value of TelestoIII (*_CNF), when a command (*_REQ) was sent before */
 static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
+    struct timespec deadline;
+    int waitResult = 0;
     int i = 0;
 
+    GetDeadline(&deadline, max_time_ms);
+
+    pthread_mutex_lock(&cmdConfirmation_mutex);
     if(reset_confirmstate)
     {
         for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
@@ -554,43 +484,38 @@ static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Statu
         {
             if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
             {
-                return (cmdConfirmation_array[i].status == expectedStatus);
+                bool ret = (cmdConfirmation_array[i].status == expectedStatus);
+                pthread_mutex_unlock(&cmdConfirmation_mutex);
+                return ret;
             }
         }
 
-        if (count >= max_count)
+        if (waitResult == ETIMEDOUT)
         {
             /* received no correct response within timeout */
+            pthread_mutex_unlock(&cmdConfirmation_mutex);
             return false;
         }
 
-        /* wait */
-        count++;
-        delay(time_step_ms);
+        /* sleep until HandleRxPacket stored a confirmation */
+        waitResult = pthread_cond_timedwait(&cmdConfirmation_cond, &cmdConfirmation_mutex, &deadline);
     }
     return true;
 }
 
-/* function to add the checksum at the end of the data packet */
-static bool FillChecksum(uint8_t* array, uint8_t length)
+/* function that discards all received confirmations, call it before the request is sent
+ * so that a fast confirmation can not be discarded by Wait4CNF */
+static void ClearCNF()
 {
-    bool ret = false;
+    int i = 0;
 
-    if ((length >= 4) && (array[0] == CMD_STX))
+    pthread_mutex_lock(&cmdConfirmation_mutex);
+    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
     {
-        uint8_t checksum = 0;
-        uint8_t payload_length = array[2];
-        int i = 0;
-        for (i = 0;
-                i < payload_length + 3;
-                i++)
-        {
-            checksum ^= array[i];
-        }
-        array[payload_length + 3] = checksum;
-        ret = true;
+        cmdConfirmation_array[i].status = CMD_Status_Invalid;
+        cmdConfirmation_array[i].cmd = CNFINVALID;
     }
-    return ret;
+    pthread_mutex_unlock(&cmdConfirmation_mutex);
 }
 
 /*
@@ -614,20 +539,35 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint8_t,uint8_t,uint8_t,uint8_t,int8
     /* set RX callback function */
     RXcallback = RXcb;
 
+    /* confirmations are waited for with CLOCK_MONOTONIC deadlines */
+    if(!InitMonotonicCond(&cmdConfirmation_cond))
+    {
+        fprintf(stdout, "Failed to initialize confirmation condition\n");
+        TelestoIII_Deinit();
+        return false;
+    }
+
+    /* create the event to reset and abort the RX thread */
+    rxThreadEvent = RxThreadEvent_Create();
+    if(rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        TelestoIII_Deinit();
+        return false;
+    }
+
     /* start RX thread */
     if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
     {
         fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
         TelestoIII_Deinit();
         return false;
     }
 
-    /* reset module*/
-    if(TelestoIII_PinReset())
-    {
-        delay(300);
-    }
-    else
+    /* reset module, it accepts requests as soon as it sent its RESET_IND */
+    if(false == TelestoIII_PinReset())
     {
         fprintf(stdout, "Pin Reset failed\n");
         TelestoIII_Deinit();
@@ -699,19 +639,16 @@ bool TelestoIII_Init(int baudrate, int rp, int wp, int bp, void(*RXcb)(uint8_t*,
     /* initialize the boot pin */
     boot_pin = bp;
     SetPin(boot_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
-    delay(10);
 
     /* initialize the wakeup pin */
     wakeup_pin = wp;
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
-    delay(10);
 
     /* initialize the reset pin,
      * we have to define it as input/pull-up such that the reset button
      * on the base PCB can pull the pin level down if the button is pressed */
     reset_pin = rp;
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
 
     /* empty the UART buffers */
     FlushSerial();
@@ -732,7 +669,13 @@ bool TelestoIII_Deinit()
     DeinitSerial();
 
     /* abort RX thread */
-    AbortUartRxThread = true;
+    if(rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(thread_read, NULL);
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
+    }
 
     /* deinit pins */
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
@@ -755,14 +698,9 @@ bool TelestoIII_Deinit()
  */
 bool TelestoIII_PinWakeup()
 {
-    int i = 0;
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
     delay (5);
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-    {
-        cmdConfirmation_array[i].status = CMD_Status_Invalid;
-        cmdConfirmation_array[i].cmd = CNFINVALID;
-    }
+    ClearCNF();
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
 
     /* wait for cnf */
@@ -782,7 +720,8 @@ bool TelestoIII_PinReset()
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
     FlushSerial();
-    ResetUartRxThread = true;
+    RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_RESET);
+    ClearCNF();
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
 
@@ -790,7 +729,7 @@ bool TelestoIII_PinReset()
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_RESET_IND, CMD_Status_Success, true);
+    return Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_RESET_IND, CMD_Status_Success, false);
 }
 
 /*
@@ -808,13 +747,14 @@ bool TelestoIII_Reset()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TelestoIII_CMD_RESET_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_RESET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_RESET_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -836,13 +776,14 @@ bool TelestoIII_FactoryReset()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TelestoIII_CMD_FACTORY_RESET_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(1500, TelestoIII_CMD_FACTORY_RESET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(1500, TelestoIII_CMD_FACTORY_RESET_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -862,13 +803,14 @@ bool TelestoIII_Standby()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TelestoIII_CMD_STANDBY_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_STANDBY_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_STANDBY_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -888,13 +830,14 @@ bool TelestoIII_Shutdown()
     CMD_ARRAY[0] = CMD_STX;
     CMD_ARRAY[1] = TelestoIII_CMD_SHUTDOWN_REQ;
     CMD_ARRAY[2] = 0x00;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SHUTDOWN_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SHUTDOWN_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -923,13 +866,14 @@ bool TelestoIII_Get(TelestoIII_UserSettings_t us, uint8_t* response, uint8_t* re
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = us;
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_GET_CNF, CMD_Status_Success, true))
+        if (Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_GET_CNF, CMD_Status_Success, false))
         {
             int length = RxPacket.Length - 1;
             memcpy(response,&RxPacket.Data[1],length);
@@ -965,13 +909,14 @@ bool TelestoIII_Set(TelestoIII_UserSettings_t us, uint8_t* value, uint8_t length
     CMD_ARRAY[2] = (1 + length);
     CMD_ARRAY[3] = us;
     memcpy(&CMD_ARRAY[4],value,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1450,14 +1395,15 @@ bool TelestoIII_SetVolatile_TXPower(uint8_t power)
     CMD_ARRAY[1] = TelestoIII_CMD_SET_PAPOWER_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = power;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         powerVolatile = power;
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_PAPOWER_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_PAPOWER_CNF, CMD_Status_Success, false);
         powerVolatile = TXPOWERINVALID;
     }
     return ret;
@@ -1489,14 +1435,15 @@ bool TelestoIII_SetVolatile_Channel(uint8_t channel)
     CMD_ARRAY[1] = TelestoIII_CMD_SET_CHANNEL_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = channel;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
         channelVolatile = channel;
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_CHANNEL_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_CHANNEL_CNF, CMD_Status_Success, false);
         channelVolatile = CHANNELINVALID;
     }
     return ret;
@@ -1528,13 +1475,14 @@ bool TelestoIII_SetVolatile_DestNetID(uint8_t destnetid)
     CMD_ARRAY[1] = TelestoIII_CMD_SET_DESTNETID_REQ;
     CMD_ARRAY[2] = 0x01;
     CMD_ARRAY[3] = destnetid;
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_DESTNETID_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_DESTNETID_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1576,7 +1524,7 @@ bool TelestoIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
         CMD_ARRAY[1] = TelestoIII_CMD_SET_DESTADDR_REQ;
         CMD_ARRAY[2] = 0x01;
         CMD_ARRAY[3] = destaddr_lsb;
-        ret = FillChecksum(CMD_ARRAY,5);
+        ret = FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,5);
     }
     break;
     case AddressMode_3:
@@ -1586,7 +1534,7 @@ bool TelestoIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
         CMD_ARRAY[2] = 0x02;
         CMD_ARRAY[3] = destaddr_lsb;
         CMD_ARRAY[4] = destaddr_msb;
-        ret = FillChecksum(CMD_ARRAY,6);
+        ret = FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,6);
     }
     break;
     default:
@@ -1595,11 +1543,12 @@ bool TelestoIII_SetVolatile_DestAddr(uint8_t destaddr_lsb, uint8_t destaddr_msb)
 
     if(ret == true)
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_DESTADDR_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_SET_DESTADDR_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1630,14 +1579,15 @@ bool TelestoIII_Transmit(uint8_t* payload, uint8_t length)
     CMD_ARRAY[1] = TelestoIII_CMD_DATA_REQ;
     CMD_ARRAY[2] = length;
     memcpy(&CMD_ARRAY[3],payload,length);
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
 
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_DATA_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_DATA_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1716,13 +1666,14 @@ bool TelestoIII_Transmit_Extended(uint8_t* payload, uint8_t length, uint8_t chan
         return false;
     }
 
-    if(FillChecksum(CMD_ARRAY,sizeof(CMD_ARRAY)))
+    if(FrameCodec_FillChecksum(&frameProtocol, CMD_ARRAY,sizeof(CMD_ARRAY)))
     {
+        ClearCNF();
         /* now send CMD_ARRAY */
         SendBytes(CMD_ARRAY,sizeof(CMD_ARRAY));
 
         /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_DATA_CNF, CMD_Status_Success, true);
+        ret = Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_DATA_CNF, CMD_Status_Success, false);
     }
     return ret;
 }
@@ -1742,11 +1693,12 @@ bool TelestoIII_Ping()
     /* rf-Profil=6, ch201, +14dBm, 100 packets*/
     uint8_t ping_command[] = {0x02,0x1F,0x08,0x20,0x06,0xC9,0x0E,0x64,0xFF,0xFF,0xFF,0x6F};
 
+    ClearCNF();
     /* now send the data */
     SendBytes(ping_command,sizeof(ping_command));
 
     /* wait for cnf */
-    return Wait4CNF(10000 /*10s*/, TelestoIII_CMD_PINGDUT_CNF, CMD_Status_Success, true);
+    return Wait4CNF(10000 /*10s*/, TelestoIII_CMD_PINGDUT_CNF, CMD_Status_Success, false);
 }
 
 /*
@@ -1757,6 +1709,8 @@ bool TelestoIII_Ping()
  * -config_length: length of the configuration struct
  * -factory_reset: apply a factory reset before or not
  *
+ *note: only the settings whose values differ are written, the module is reset only if a setting was written
+ *
  *return true if request succeeded
  *       false otherwise
 */
@@ -1765,19 +1719,20 @@ bool TelestoIII_Configure(TelestoIII_Configuration_t* config, uint8_t config_len
     int i = 0;
     uint8_t help_length;
     uint8_t help[MAX_USERSETTING_LENGTH];
+    bool changed[UINT8_MAX];
+    bool update = false;
 
     if(factory_reset)
     {
-        /* perform a factory reset */
-        if(false == TelestoIII_FactoryReset())
+        /* perform a factory reset, the module restarts with the default settings */
+        if((false == TelestoIII_FactoryReset()) || (false == Wait4CNF(CMD_WAIT_TIME, TelestoIII_CMD_RESET_IND, CMD_Status_Success, false)))
         {
             /* error */
             return false;
         }
     }
-    delay(500);
 
-    /* now check all settings and update them if necessary */
+    /* now check all settings, the module has no request to read several of them at once */
     for(i=0; i<config_length; i++)
     {
         /* read current value */
@@ -1786,7 +1741,6 @@ bool TelestoIII_Configure(TelestoIII_Configuration_t* config, uint8_t config_len
             /* error */
             return false;
         }
-        delay(200);
 
         /* check the value read out */
         if(help_length != config[i].value_length)
@@ -1794,22 +1748,30 @@ bool TelestoIII_Configure(TelestoIII_Configuration_t* config, uint8_t config_len
             /* error, length does not match */
             return false;
         }
-        if(memcmp(help,config[i].value,config[i].value_length) != 0)
+        changed[i] = (memcmp(help,config[i].value,config[i].value_length) != 0);
+    }
+
+    /* and update those that are not up to date */
+    for(i=0; i<config_length; i++)
+    {
+        if(changed[i])
         {
-            /* read value is not up to date, thus write the new value */
             if(false == TelestoIII_Set(config[i].usersetting, config[i].value, config[i].value_length))
             {
                 /* error */
                 return false;
             }
+            update = true;
         }
-        delay(200);
     }
 
-    /* reset to take effect of the updated parameters */
-    if(false == TelestoIII_PinReset())
+    if(update)
     {
-        return false;
+        /* reset to take effect of the updated parameters */
+        if(false == TelestoIII_PinReset())
+        {
+            return false;
+        }
     }
     return true;
 }
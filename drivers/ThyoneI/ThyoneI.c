@@ -45,6 +45,7 @@
 #define MAX_PAYLOAD_LENGTH_MULTICAST_EX (uint16_t)223
 #define MAX_PAYLOAD_LENGTH_UNICAST_EX   (uint16_t)220
 #define MAX_CMD_LENGTH                  (uint16_t)(MAX_PAYLOAD_LENGTH + LENGTH_CMD_OVERHEAD)
+#define MAX_RX_CMD_LENGTH               (uint16_t)(MAX_CMD_LENGTH + 5)  /* DATA_IND carries source address and RSSI in front of the payload */
 
 #define CMD_POSITION_STX        (uint8_t)0
 #define CMD_POSITION_CMD        (uint8_t)1
@@ -164,34 +165,41 @@ typedef struct
     CMD_Status_t status; /* variable used to check the response (*_CNF), when a request (*_REQ) was sent to the ThyoneI */
 } CMD_Confirmation_t;
 
+/* asynchronous remote GPIO read, stored as the context of its request */
+typedef struct
+{
+    ThyoneI_GPIORemoteReadCallback callback;
+    void *contextP;
+} AsyncGPIORead_t;
+
 /**************************************
  *     Static function declarations   *
  **************************************/
 
-static void HandleRxPacket(uint8_t*RxBuffer);                                                      /* RX packet interpreter */
-static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate);
-static bool FillChecksum(uint8_t* array, uint16_t length);                                           /* add the CS needed to finalize the command */
+static void HandleRxPacket(void *contextP, uint8_t *RxBuffer);                                     /* RX packet interpreter */
+static bool Wait4CNF(CommandQueue_Request_t *requestP, int max_time_ms, CMD_Status_t expectedStatus);
+static bool SendRequest(uint8_t *frameP, uint16_t length, CommandQueue_Request_t *requestP);
 static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint32_t,int8_t));
 
 /**************************************
  *          Static variables          *
  **************************************/
+
+/* command frames of the module: STX, CMD, 16 bit LEN (LSB first), DATA, CS */
+static const FrameCodec_Protocol_t frameProtocol = { CMD_STX, 2, HandleRxPacket };
 static uint8_t CMD_Array[MAX_CMD_LENGTH]; /* for UART TX to module*/
-static uint8_t RxPacket[MAX_CMD_LENGTH];
 
-bool AbortUartRxThread;                     /* boolean to abort the UART RX thread */
-bool ResetUartRxThread;                     /* boolean to reset the UART RX thread */
+static int rxThreadEvent = -1;                  /* eventfd to reset or abort the UART RX thread */
 
-pthread_t thread_read;
+static pthread_t thread_read;
 
-#define CMDCONFIRMATIONARRAY_LENGTH 3
-CMD_Confirmation_t cmdConfirmation_array[CMDCONFIRMATIONARRAY_LENGTH];
+static CommandQueue_t cmdQueue;                 /* requests waiting for their confirmation, one at a time as CMD_Array is shared */
 
-int reset_pin = 0;                              /* reset pin number */
-int wakeup_pin = 0;                             /* wakeup pin number */
-int boot_pin = 0;                               /* boot pin number */
+static int reset_pin = 0;                       /* reset pin number */
+static int wakeup_pin = 0;                      /* wakeup pin number */
+static int boot_pin = 0;                        /* boot pin number */
 
-void(*RXcallback)(uint8_t*,uint16_t,uint32_t,int8_t);       /* callback function */
+static void(*RXcallback)(uint8_t*,uint16_t,uint32_t,int8_t); /* callback function */
 
 
 /**************************************
@@ -199,100 +207,16 @@ void(*RXcallback)(uint8_t*,uint16_t,uint32_t,int8_t);       /* callback function
  **************************************/
 
 /* thread function to receive bytes from interface */
-void *rx_thread()
+static void *rx_thread(void *argP)
 {
-    uint8_t checksum = 0;
-    uint16_t RxByteCounter = 0;
-    uint16_t BytesToReceive = 0;
-    uint8_t readBuffer;
-    static uint8_t RxBuffer[MAX_CMD_LENGTH]; /* For UART RX from module */
-
-    ResetUartRxThread = false;
-    AbortUartRxThread = false;
+    static uint8_t RxBuffer[MAX_RX_CMD_LENGTH]; /* For UART RX from module */
+    FrameCodec_t codec;
 
     /* apply a higher priority to this thread to be prioritized w.r.t. the main function  */
     setThreadPrio(PRIO_UARTRXTHREAD);
-    while(1)
-    {
-        /* wait for 1ms, then check if new RX data is available */
-        delay (1);
-
-        if(AbortUartRxThread == true)
-        {
-            /* jump out of the while loop and finish the thread */
-            AbortUartRxThread = false;
-            break;
-        }
-
-        if(ResetUartRxThread == true)
-        {
-            /* reset the RX thread */
-            ResetUartRxThread = false;
-            RxByteCounter = 0;
-        }
 
-        while (BytesAvailable())
-        {
-            /* interprete received byte */
-            if(ReadByte(&readBuffer))
-            {
-                RxBuffer[RxByteCounter] = readBuffer;
-
-                switch (RxByteCounter)
-                {
-                case 0:
-                    /* wait for start byte of frame */
-                    if (RxBuffer[RxByteCounter] == CMD_STX)
-                    {
-                        BytesToReceive = 0;
-                        RxByteCounter = 1;
-                    }
-                    break;
-
-                case 1:
-                    /* CMD */
-                    RxByteCounter++;
-                    break;
-
-                case 2:
-                    /* length field lsb */
-                    RxByteCounter++;
-                    BytesToReceive = (uint16_t)(RxBuffer[RxByteCounter - 1]);
-                    break;
-
-                case 3:
-                    /* length field msb */
-                    RxByteCounter++;
-                    BytesToReceive += (((uint16_t)RxBuffer[RxByteCounter - 1]<<8) + LENGTH_CMD_OVERHEAD); /* len_msb + len_lsb + crc + sfd + cmd */
-                    break;
-
-                default:
-                    /* data field */
-                    RxByteCounter++;
-                    if (RxByteCounter == BytesToReceive)
-                    {
-                        /* check CRC */
-                        checksum = 0;
-                        int i = 0;
-                        for (i = 0; i < (BytesToReceive - 1); i++)
-                        {
-                            checksum ^= RxBuffer[i];
-                        }
-
-                        if (checksum == RxBuffer[BytesToReceive - 1])
-                        {
-                            /* received frame ok, interprete it now */
-                            HandleRxPacket(RxBuffer);
-                        }
-
-                        RxByteCounter = 0;
-                        BytesToReceive = 0;
-                    }
-                    break;
-                }
-            }
-        }
-    }
+    FrameCodec_Init(&codec, &frameProtocol, RxBuffer, sizeof(RxBuffer), NULL);
+    FrameCodec_RxLoop(&codec, GetDefaultTransport(), rxThreadEvent);
     return 0;
 }
 
@@ -310,20 +234,34 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint32_t,int8_t))
     /* set RX callback function */
     RXcallback = RXcb;
 
+    if(!CommandQueue_Init(&cmdQueue, 1))
+    {
+        fprintf(stdout, "Failed to initialize command queue\n");
+        ThyoneI_Deinit();
+        return false;
+    }
+
+    /* create the event to reset and abort the RX thread */
+    rxThreadEvent = RxThreadEvent_Create();
+    if(rxThreadEvent < 0)
+    {
+        fprintf(stdout, "Failed to create rx_Thread event\n");
+        ThyoneI_Deinit();
+        return false;
+    }
+
     /* start RX thread */
     if(pthread_create(&thread_read, NULL, &rx_thread, NULL))
     {
         fprintf(stdout, "Failed to start rx_Thread\n");
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
         ThyoneI_Deinit();
         return false;
     }
 
-    /* reset module*/
-    if(ThyoneI_PinReset())
-    {
-        delay(ThyoneI_BOOT_DURATION);
-    }
-    else
+    /* reset module, it accepts requests as soon as it sent its START_IND */
+    if(false == ThyoneI_PinReset())
     {
         fprintf(stdout, "Pin Reset failed\n");
         ThyoneI_Deinit();
@@ -335,132 +273,127 @@ static bool InitDriver(void(*RXcb)(uint8_t*,uint16_t,uint32_t,int8_t))
     {
         fprintf (stdout, COLOR_CYAN "ThyoneI driver version %d.%d.%d\n" COLOR_RESET,driver_version[0],driver_version[1],driver_version[2]);
     }
-    delay(100);
-
 
     uint8_t firmware_version[3];
     if(ThyoneI_GetFWVersion(firmware_version))
     {
         fprintf (stdout, COLOR_CYAN "Firmware version %d.%d.%d\n" COLOR_RESET,firmware_version[2],firmware_version[1],firmware_version[0]);
     }
-    delay(100);
 
     return true;
 }
 
-static void HandleRxPacket(uint8_t * pRxBuffer)
+static void HandleRxPacket(void *contextP, uint8_t *pRxBuffer)
 {
     CMD_Confirmation_t cmdConfirmation;
     cmdConfirmation.cmd = CNFINVALID;
     cmdConfirmation.status = CMD_Status_Invalid;
 
     uint16_t cmd_length = (uint16_t)(pRxBuffer[CMD_POSITION_LENGTH_LSB]+(pRxBuffer[CMD_POSITION_LENGTH_MSB]<<8));
-    memcpy(&RxPacket[0], pRxBuffer, cmd_length + LENGTH_CMD_OVERHEAD);
-
-    switch (RxPacket[CMD_POSITION_CMD])
+    switch (pRxBuffer[CMD_POSITION_CMD])
     {
     case ThyoneI_CMD_RESET_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
         cmdConfirmation.status = CMD_Status_NoStatus;
         break;
     }
 
     case ThyoneI_CMD_DATA_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GET_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_SET_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GETSTATE_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
         cmdConfirmation.status = CMD_Status_NoStatus;
         break;
     }
 
     case ThyoneI_CMD_FACTORYRESET_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_SLEEP_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GPIO_LOCAL_SETCONFIG_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GPIO_LOCAL_GETCONFIG_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GPIO_LOCAL_WRITE_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GPIO_LOCAL_READ_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GPIO_REMOTE_SETCONFIG_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GPIO_REMOTE_GETCONFIG_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
 
         break;
     }
 
     case ThyoneI_CMD_GPIO_REMOTE_WRITE_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GPIO_REMOTE_READ_CNF:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
         cmdConfirmation.status = CMD_Status_Invalid;
 
         break;
@@ -468,7 +401,7 @@ static void HandleRxPacket(uint8_t * pRxBuffer)
 
     case ThyoneI_CMD_START_IND:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
         cmdConfirmation.status = CMD_Status_NoStatus;
         break;
     }
@@ -477,35 +410,35 @@ static void HandleRxPacket(uint8_t * pRxBuffer)
     {
         if(RXcallback != NULL)
         {
-            uint16_t payload_length = ((((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) | ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8))) - 5;
+            uint16_t payload_length = ((((uint16_t) pRxBuffer[CMD_POSITION_LENGTH_LSB] << 0) | ((uint16_t) pRxBuffer[CMD_POSITION_LENGTH_MSB] << 8))) - 5;
 
-            uint32_t sourceAddress = (uint32_t)RxPacket[CMD_POSITION_DATA];
-            sourceAddress = (sourceAddress << 8) + (uint32_t)RxPacket[CMD_POSITION_DATA+1];
-            sourceAddress = (sourceAddress << 8) + (uint32_t)RxPacket[CMD_POSITION_DATA+2];
-            sourceAddress = (sourceAddress << 8) + (uint32_t)RxPacket[CMD_POSITION_DATA+3];
+            uint32_t sourceAddress = (uint32_t)pRxBuffer[CMD_POSITION_DATA];
+            sourceAddress = (sourceAddress << 8) + (uint32_t)pRxBuffer[CMD_POSITION_DATA+1];
+            sourceAddress = (sourceAddress << 8) + (uint32_t)pRxBuffer[CMD_POSITION_DATA+2];
+            sourceAddress = (sourceAddress << 8) + (uint32_t)pRxBuffer[CMD_POSITION_DATA+3];
 
-            RXcallback(&RxPacket[CMD_POSITION_DATA + 5], payload_length, sourceAddress, RxPacket[CMD_POSITION_DATA + 4]);
+            RXcallback(&pRxBuffer[CMD_POSITION_DATA + 5], payload_length, sourceAddress, pRxBuffer[CMD_POSITION_DATA + 4]);
         }
         break;
     }
 
     case ThyoneI_CMD_TXCOMPLETE_RSP:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
-        cmdConfirmation.status = RxPacket[CMD_POSITION_DATA];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
+        cmdConfirmation.status = pRxBuffer[CMD_POSITION_DATA];
         break;
     }
 
     case ThyoneI_CMD_GPIO_REMOTE_GETCONFIG_RSP:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
         cmdConfirmation.status = CMD_Status_NoStatus;
         break;
     }
 
     case ThyoneI_CMD_GPIO_REMOTE_READ_RSP:
     {
-        cmdConfirmation.cmd = RxPacket[CMD_POSITION_CMD];
+        cmdConfirmation.cmd = pRxBuffer[CMD_POSITION_CMD];
         cmdConfirmation.status = CMD_Status_NoStatus;
         break;
     }
@@ -516,77 +449,24 @@ static void HandleRxPacket(uint8_t * pRxBuffer)
     }
     }
 
-    int i = 0;
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+    if(cmdConfirmation.cmd != CNFINVALID)
     {
-        if(cmdConfirmation_array[i].cmd == CNFINVALID)
-        {
-            cmdConfirmation_array[i].cmd = cmdConfirmation.cmd;
-            cmdConfirmation_array[i].status = cmdConfirmation.status;
-            break;
-        }
+        /* the confirmation is copied for the command waiting for it */
+        CommandQueue_Confirm(&cmdQueue, cmdConfirmation.cmd, cmdConfirmation.status, pRxBuffer, cmd_length + LENGTH_CMD_OVERHEAD);
     }
 }
 
 /* function that waits for the return value of ThyoneI (*_CNF), when a command (*_REQ) was sent before */
-static bool Wait4CNF(int max_time_ms, uint8_t expectedCmdConfirmation, CMD_Status_t expectedStatus, bool reset_confirmstate)
+static bool Wait4CNF(CommandQueue_Request_t *requestP, int max_time_ms, CMD_Status_t expectedStatus)
 {
-    int count = 0;
-    int time_step_ms = 5; /* 5ms */
-    int max_count = max_time_ms / time_step_ms;
-    int i = 0;
-
-    if(reset_confirmstate)
-    {
-        for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-        {
-            cmdConfirmation_array[i].cmd = CNFINVALID;
-        }
-    }
-    while (1)
-    {
-        for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
-        {
-            if(expectedCmdConfirmation == cmdConfirmation_array[i].cmd)
-            {
-                return (cmdConfirmation_array[i].status == expectedStatus);
-            }
-        }
-
-        if (count >= max_count)
-        {
-            /* received no correct response within timeout */
-            return false;
-        }
-
-        /* wait */
-        count++;
-        delay(time_step_ms);
-    }
-    return true;
+    return CommandQueue_Wait(&cmdQueue, requestP, max_time_ms) && (requestP->status == expectedStatus);
 }
 
-/* function to add the checksum at the end of the data packet */
-static bool
-FillChecksum(uint8_t* pArray, uint16_t length)
+/* function to send a complete request frame as the request waiting for requestP */
+static bool SendRequest(uint8_t *frameP, uint16_t length, CommandQueue_Request_t *requestP)
 {
-    bool ret = false;
-
-    if ((length >= LENGTH_CMD_OVERHEAD) && (pArray[0] == CMD_STX))
-    {
-        uint8_t checksum = (uint8_t)0;
-        uint16_t payload_length = (uint16_t) (pArray[CMD_POSITION_LENGTH_MSB] << 8) + pArray[CMD_POSITION_LENGTH_LSB];
-        uint16_t i = 0;
-        for (i = 0;
-                i < (payload_length + LENGTH_CMD_OVERHEAD_WITHOUT_CRC);
-                i++)
-        {
-            checksum ^= pArray[i];
-        }
-        pArray[payload_length + LENGTH_CMD_OVERHEAD_WITHOUT_CRC] = checksum;
-        ret = true;
-    }
-    return ret;
+    struct iovec frame = { .iov_base = frameP, .iov_len = length };
+    return CommandQueue_Submit(&cmdQueue, requestP, GetDefaultTransport(), &frame, 1, CMD_WAIT_TIME);
 }
 
 
@@ -659,13 +539,19 @@ bool ThyoneI_Init(int baudrate, int rp,  int wp, int bp, void(*RXcb)(uint8_t*,ui
     }
     reset_pin = rp;
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
-    delay(10);
 
     /* empty the UART buffers */
     FlushSerial();
 
     /* init the driver and module*/
-    return InitDriver(RXcb);
+    if (false == InitDriver(RXcb))
+    {
+        return false;
+    }
+
+    /* let the timeouts of the commands adapt to the answer times of the module */
+    CommandQueue_SetLineRate(&cmdQueue, baudrate);
+    return true;
 }
 
 /*
@@ -681,7 +567,14 @@ bool ThyoneI_Deinit()
     DeinitSerial();
 
     /* abort RX thread */
-    AbortUartRxThread = true;
+    if(rxThreadEvent >= 0)
+    {
+        RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_ABORT);
+        pthread_join(thread_read, NULL);
+        RxThreadEvent_Destroy(rxThreadEvent);
+        rxThreadEvent = -1;
+    }
+    CommandQueue_Deinit(&cmdQueue);
 
     /* deinit pins */
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_No, SetPin_Out_High);
@@ -705,19 +598,18 @@ bool ThyoneI_Deinit()
  */
 bool ThyoneI_PinWakeup()
 {
-    int i = 0;
-
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
     delay (5);
-    for(i=0; i<CMDCONFIRMATIONARRAY_LENGTH; i++)
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ThyoneI_CMD_START_IND, NULL, 0);
+    if(!CommandQueue_Submit(&cmdQueue, &request, GetDefaultTransport(), NULL, 0, CMD_WAIT_TIME))
     {
-        cmdConfirmation_array[i].status = CMD_Status_Invalid;
-        cmdConfirmation_array[i].cmd = CNFINVALID;
+        return false;
     }
     SetPin(wakeup_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_START_IND, CMD_Status_NoStatus, false);
+    return Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_NoStatus);
 }
 
 /*
@@ -733,7 +625,13 @@ bool ThyoneI_PinReset()
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_Low);
     FlushSerial();
-    ResetUartRxThread = true;
+    RxThreadEvent_Signal(rxThreadEvent, RXTHREAD_EVENT_RESET);
+    CommandQueue_Request_t request;
+    CommandQueue_InitRequest(&request, ThyoneI_CMD_START_IND, NULL, 0);
+    if(!CommandQueue_Submit(&cmdQueue, &request, GetDefaultTransport(), NULL, 0, CMD_WAIT_TIME))
+    {
+        return false;
+    }
     delay (5);
     SetPin(reset_pin, SetPin_InputOutput_Output, SetPin_Pull_No, SetPin_Out_High);
 
@@ -741,7 +639,7 @@ bool ThyoneI_PinReset()
     SetPin(reset_pin, SetPin_InputOutput_Input, SetPin_Pull_Up, SetPin_Out_High);
 
     /* wait for cnf */
-    return Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_START_IND, CMD_Status_NoStatus, true);
+    return Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_NoStatus);
 }
 
 /*
@@ -760,13 +658,18 @@ bool ThyoneI_Reset()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_START_IND, NULL, 0);
+        /* answered once the module restarted */
+        CommandQueue_SetFixedTimeout(&request);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        return Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_START_IND, CMD_Status_NoStatus, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            return Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_NoStatus);
+        }
     }
     return ret;
 }
@@ -787,13 +690,16 @@ ThyoneI_Sleep()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_SLEEP_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes( CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_SLEEP_CNF, CMD_Status_Success, true);
+        if(SendRequest( CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -821,10 +727,16 @@ ThyoneI_TransmitBroadcast(uint8_t *payloadP, uint16_t length)
 
         memcpy(&CMD_Array[CMD_POSITION_DATA], payloadP, length);
 
-        if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+        if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
         {
-            SendBytes( CMD_Array, CMD_ARRAY_SIZE());
-            ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_TXCOMPLETE_RSP, CMD_Status_Success, true);
+            CommandQueue_Request_t request;
+            CommandQueue_InitRequest(&request, ThyoneI_CMD_TXCOMPLETE_RSP, NULL, 0);
+            /* answered once the data was sent over the air */
+            CommandQueue_SetFixedTimeout(&request);
+            if(SendRequest( CMD_Array, CMD_ARRAY_SIZE(), &request))
+            {
+                ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+            }
         }
     }
 
@@ -854,10 +766,16 @@ ThyoneI_TransmitMulticast(uint8_t *payloadP, uint16_t length)
 
         memcpy(&CMD_Array[CMD_POSITION_DATA], payloadP, length);
 
-        if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+        if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
         {
-            SendBytes( CMD_Array, CMD_ARRAY_SIZE());
-            ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_TXCOMPLETE_RSP, CMD_Status_Success, true);
+            CommandQueue_Request_t request;
+            CommandQueue_InitRequest(&request, ThyoneI_CMD_TXCOMPLETE_RSP, NULL, 0);
+            /* answered once the data was sent over the air */
+            CommandQueue_SetFixedTimeout(&request);
+            if(SendRequest( CMD_Array, CMD_ARRAY_SIZE(), &request))
+            {
+                ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+            }
         }
     }
 
@@ -887,10 +805,16 @@ ThyoneI_TransmitUnicast(uint8_t *payloadP, uint16_t length)
 
         memcpy(&CMD_Array[CMD_POSITION_DATA], payloadP, length);
 
-        if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+        if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
         {
-            SendBytes( CMD_Array, CMD_ARRAY_SIZE());
-            ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_TXCOMPLETE_RSP, CMD_Status_Success, true);
+            CommandQueue_Request_t request;
+            CommandQueue_InitRequest(&request, ThyoneI_CMD_TXCOMPLETE_RSP, NULL, 0);
+            /* answered once the data was sent over the air */
+            CommandQueue_SetFixedTimeout(&request);
+            if(SendRequest( CMD_Array, CMD_ARRAY_SIZE(), &request))
+            {
+                ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+            }
         }
     }
 
@@ -923,10 +847,16 @@ ThyoneI_TransmitMulticastExtended(uint8_t groupID, uint8_t *payloadP, uint16_t l
 
         memcpy(&CMD_Array[CMD_POSITION_DATA+1], payloadP, length);
 
-        if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+        if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
         {
-            SendBytes( CMD_Array, CMD_ARRAY_SIZE());
-            ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_TXCOMPLETE_RSP, CMD_Status_Success, true);
+            CommandQueue_Request_t request;
+            CommandQueue_InitRequest(&request, ThyoneI_CMD_TXCOMPLETE_RSP, NULL, 0);
+            /* answered once the data was sent over the air */
+            CommandQueue_SetFixedTimeout(&request);
+            if(SendRequest( CMD_Array, CMD_ARRAY_SIZE(), &request))
+            {
+                ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+            }
         }
     }
 
@@ -959,10 +889,16 @@ ThyoneI_TransmitUnicastExtended(uint32_t address, uint8_t *payloadP, uint16_t le
         memcpy(&CMD_Array[CMD_POSITION_DATA], &address, 4);
         memcpy(&CMD_Array[CMD_POSITION_DATA+4], payloadP, length);
 
-        if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+        if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
         {
-            SendBytes( CMD_Array, CMD_ARRAY_SIZE());
-            ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_TXCOMPLETE_RSP, CMD_Status_Success, true);
+            CommandQueue_Request_t request;
+            CommandQueue_InitRequest(&request, ThyoneI_CMD_TXCOMPLETE_RSP, NULL, 0);
+            /* answered once the data was sent over the air */
+            CommandQueue_SetFixedTimeout(&request);
+            if(SendRequest( CMD_Array, CMD_ARRAY_SIZE(), &request))
+            {
+                ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+            }
         }
     }
 
@@ -985,13 +921,18 @@ ThyoneI_FactoryReset()
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_START_IND, NULL, 0);
+        /* answered once the module restarted */
+        CommandQueue_SetFixedTimeout(&request);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for reset after factory reset */
-        return Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_START_IND, CMD_Status_NoStatus, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for reset after factory reset */
+            return Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_NoStatus);
+        }
     }
     return ret;
 
@@ -1024,13 +965,16 @@ ThyoneI_Set(ThyoneI_UserSettings_t userSetting, uint8_t *ValueP, uint8_t length)
     CMD_Array[CMD_POSITION_DATA] = userSetting;
     memcpy(&CMD_Array[CMD_POSITION_DATA + 1], ValueP, length);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_SET_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        return Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_SET_CNF, CMD_Status_Success, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            return Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
     return ret;
 }
@@ -1312,18 +1256,22 @@ ThyoneI_Get(ThyoneI_UserSettings_t userSetting, uint8_t *ResponseP, uint16_t *Re
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_DATA] = userSetting;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        uint8_t cnfPacket[MAX_RX_CMD_LENGTH];
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GET_CNF, cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GET_CNF, CMD_Status_Success, true))
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
         {
-            uint16_t length = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8);
-            memcpy(ResponseP, &RxPacket[CMD_POSITION_DATA + 1], length - 1); /* First Data byte is status, following bytes response*/
-            *Response_LengthP = length - 1;
-            ret = true;
+            /* wait for cnf */
+            if (Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success))
+            {
+                uint16_t length = ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_MSB] << 8);
+                memcpy(ResponseP, &cnfPacket[CMD_POSITION_DATA + 1], length - 1); /* First Data byte is status, following bytes response*/
+                *Response_LengthP = length - 1;
+                ret = true;
+            }
         }
     }
     return ret;
@@ -1644,15 +1592,20 @@ ThyoneI_GetState(ThyoneI_States_t* state)
     CMD_Array[CMD_POSITION_LENGTH_LSB] = (uint8_t)0;
     CMD_Array[CMD_POSITION_LENGTH_MSB] = (uint8_t)0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        uint8_t cnfPacket[MAX_RX_CMD_LENGTH];
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GETSTATE_CNF, cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-        /* wait for cnf */
-        if (Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GETSTATE_CNF, CMD_Status_Success, true))
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
         {
-            *state = RxPacket[CMD_POSITION_DATA+1];
-            ret = true;
+            /* wait for cnf */
+            if (Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success))
+            {
+                *state = cnfPacket[CMD_POSITION_DATA+1];
+                ret = true;
+            }
         }
     }
     return ret;
@@ -1678,13 +1631,16 @@ bool ThyoneI_GPIOLocalSetConfig(ThyoneI_GPIOConfigBlock_t* configP, uint16_t con
 
     memcpy(&CMD_Array[CMD_POSITION_DATA], configP, configLength);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GPIO_LOCAL_SETCONFIG_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GPIO_LOCAL_SETCONFIG_CNF, CMD_Status_Success, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
 
     return ret;
@@ -1708,16 +1664,23 @@ bool ThyoneI_GPIOLocalGetConfig(ThyoneI_GPIOConfigBlock_t* configP, uint16_t *co
     CMD_Array[CMD_POSITION_LENGTH_LSB]= 0;
     CMD_Array[CMD_POSITION_LENGTH_MSB]= 0;
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        uint8_t cnfPacket[MAX_RX_CMD_LENGTH];
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GPIO_LOCAL_GETCONFIG_CNF, cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GPIO_LOCAL_GETCONFIG_CNF, CMD_Status_Success, true);
-        /* config length is packetlength - 1 (status byte)*/
-        *configLengthP = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1;
-        memcpy(configP, &RxPacket[CMD_POSITION_DATA+1], *configLengthP);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
+        if(ret)
+        {
+            /* config length is packetlength - 1 (status byte)*/
+            *configLengthP = ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1;
+            memcpy(configP, &cnfPacket[CMD_POSITION_DATA+1], *configLengthP);
+        }
     }
 
     return ret;
@@ -1743,13 +1706,16 @@ bool ThyoneI_GPIOLocalWrite(ThyoneI_GPIOControlBlock_t* controlP, uint16_t contr
     CMD_Array[CMD_POSITION_LENGTH_MSB]= (controlLength & 0xFF00) >> 8;
     memcpy(&CMD_Array[CMD_POSITION_DATA], controlP, controlLength);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GPIO_LOCAL_WRITE_CNF, NULL, 0);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GPIO_LOCAL_WRITE_CNF, CMD_Status_Success, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
 
     return ret;
@@ -1779,16 +1745,23 @@ bool ThyoneI_GPIOLocalRead(uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, Thyon
     CMD_Array[CMD_POSITION_DATA] = amountGPIOToRead;
     memcpy(&CMD_Array[CMD_POSITION_DATA + 1], GPIOToReadP, amountGPIOToRead);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        uint8_t cnfPacket[MAX_RX_CMD_LENGTH];
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GPIO_LOCAL_READ_CNF, cnfPacket, sizeof(cnfPacket));
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GPIO_LOCAL_READ_CNF, CMD_Status_Success, true);
-        /* config length is packetlength - 1 (status byte)*/
-        *controlLengthP = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1;
-        memcpy(controlP, &RxPacket[CMD_POSITION_DATA+1], *controlLengthP);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
+        if(ret)
+        {
+            /* config length is packetlength - 1 (status byte)*/
+            *controlLengthP = ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1;
+            memcpy(controlP, &cnfPacket[CMD_POSITION_DATA+1], *controlLengthP);
+        }
     }
 
     return ret;
@@ -1819,13 +1792,18 @@ bool ThyoneI_GPIORemoteSetConfig(uint32_t destAddress, ThyoneI_GPIOConfigBlock_t
     memcpy(&CMD_Array[CMD_POSITION_DATA], &destAddress, 4);
     memcpy(&CMD_Array[CMD_POSITION_DATA+4], configP, configLength);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GPIO_REMOTE_SETCONFIG_CNF, NULL, 0);
+        /* answered by the remote device over the air */
+        CommandQueue_SetFixedTimeout(&request);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GPIO_REMOTE_SETCONFIG_CNF, CMD_Status_Success, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
 
     return ret;
@@ -1851,18 +1829,24 @@ bool ThyoneI_GPIORemoteGetConfig(uint32_t destAddress, ThyoneI_GPIOConfigBlock_t
     CMD_Array[CMD_POSITION_LENGTH_MSB]= 0;
     memcpy(&CMD_Array[CMD_POSITION_DATA], &destAddress, 4);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        uint8_t cnfPacket[MAX_RX_CMD_LENGTH];
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GPIO_REMOTE_GETCONFIG_RSP, cnfPacket, sizeof(cnfPacket));
+        /* answered by the remote device over the air */
+        CommandQueue_SetFixedTimeout(&request);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GPIO_REMOTE_GETCONFIG_RSP, CMD_Status_NoStatus, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_NoStatus);
+        }
 
         if(ret)
         {
-            *configLengthP = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1 - 4;
-            memcpy(configP, &RxPacket[CMD_POSITION_DATA + 5], *configLengthP);
+            *configLengthP = ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1 - 4;
+            memcpy(configP, &cnfPacket[CMD_POSITION_DATA + 5], *configLengthP);
         }
 
     }
@@ -1896,13 +1880,18 @@ bool ThyoneI_GPIORemoteWrite(uint32_t destAddress, ThyoneI_GPIOControlBlock_t* c
     memcpy(&CMD_Array[CMD_POSITION_DATA], &destAddress, 4);
     memcpy(&CMD_Array[CMD_POSITION_DATA+4], controlP, controlLength);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GPIO_REMOTE_WRITE_CNF, NULL, 0);
+        /* answered by the remote device over the air */
+        CommandQueue_SetFixedTimeout(&request);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(CMD_WAIT_TIME, ThyoneI_CMD_GPIO_REMOTE_WRITE_CNF, CMD_Status_Success, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, CMD_WAIT_TIME, CMD_Status_Success);
+        }
     }
 
     return ret;
@@ -1938,21 +1927,100 @@ bool ThyoneI_GPIORemoteRead(uint32_t destAddress, uint8_t *GPIOToReadP, uint8_t
     CMD_Array[CMD_POSITION_DATA+4] = amountGPIOToRead;
     memcpy(&CMD_Array[CMD_POSITION_DATA + 5], GPIOToReadP, amountGPIOToRead);
 
-    if (FillChecksum(CMD_Array, CMD_ARRAY_SIZE()))
+    if (FrameCodec_FillChecksum(&frameProtocol, CMD_Array, CMD_ARRAY_SIZE()))
     {
+        uint8_t cnfPacket[MAX_RX_CMD_LENGTH];
+        CommandQueue_Request_t request;
+        CommandQueue_InitRequest(&request, ThyoneI_CMD_GPIO_REMOTE_READ_RSP, cnfPacket, sizeof(cnfPacket));
+        /* answered by the remote device over the air */
+        CommandQueue_SetFixedTimeout(&request);
         /* now send CMD_ARRAY */
-        SendBytes(CMD_Array, CMD_ARRAY_SIZE());
-
-        /* wait for cnf */
-        ret = Wait4CNF(1000, ThyoneI_CMD_GPIO_REMOTE_READ_RSP, CMD_Status_NoStatus, true);
+        if(SendRequest(CMD_Array, CMD_ARRAY_SIZE(), &request))
+        {
+            /* wait for cnf */
+            ret = Wait4CNF(&request, 1000, CMD_Status_NoStatus);
+        }
 
         if(ret)
         {
-            *controlLengthP = ((uint16_t) RxPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) RxPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1 - 4;
-            memcpy(controlP, &RxPacket[CMD_POSITION_DATA + 5], *controlLengthP);
+            *controlLengthP = ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) cnfPacket[CMD_POSITION_LENGTH_MSB] << 8) - 1 - 4;
+            memcpy(controlP, &cnfPacket[CMD_POSITION_DATA + 5], *controlLengthP);
         }
     }
 
     return ret;
 }
 
+/* function called by the dispatcher of the command queue when ThyoneI_GPIORemoteReadAsync was answered or timed out */
+static void GPIORemoteReadDone(CommandQueue_Request_t *requestP, bool answered)
+{
+    AsyncGPIORead_t *readP = requestP->contextP;
+    uint8_t *rspP = requestP->responseP;
+    bool success = answered && (requestP->status == CMD_Status_NoStatus);
+    uint16_t controlLength = 0;
+
+    if(success)
+    {
+        /* skip status and destination address */
+        uint16_t length = ((uint16_t) rspP[CMD_POSITION_LENGTH_LSB] << 0) + ((uint16_t) rspP[CMD_POSITION_LENGTH_MSB] << 8);
+        controlLength = (length > 5) ? (length - 5) : 0;
+    }
+    readP->callback(success, (ThyoneI_GPIOControlBlock_t*)&rspP[CMD_POSITION_DATA + 5], controlLength, readP->contextP);
+}
+
+/*
+ *Read the input of the pins of a remote device without waiting for the response.
+ *See ThyoneI_GPIORemoteRead
+ *
+ *input:
+ * -destAddress: Destination address of the remote Thyone-I device
+ * -GPIOToReadP: One or more pins to read, copied before returning
+ * -amountGPIOToRead: amount of pins to read and therefore length of GPIOToReadP
+ * -cb: called with the control blocks read, or with success false on timeout
+ * -contextP: passed to cb
+ *
+ *note: cb is called by a thread of the driver, it must not block for long
+ *
+ *return true if the request was queued, cb is called exactly once then
+ *       false otherwise
+ */
+bool ThyoneI_GPIORemoteReadAsync(uint32_t destAddress, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ThyoneI_GPIORemoteReadCallback cb, void* contextP)
+{
+    if((cb == NULL) || (amountGPIOToRead > MAX_PAYLOAD_LENGTH - 5))
+    {
+        return false;
+    }
+
+    /* payload is 4-byte destination address + pin configuration,
+     * the frame is built apart from CMD_Array that is used by the blocking functions */
+    uint16_t commandLength = 1 + amountGPIOToRead + 4;
+    uint8_t header[CMD_POSITION_DATA + 5];
+    header[CMD_POSITION_STX] = CMD_STX;
+    header[CMD_POSITION_CMD] = ThyoneI_CMD_GPIO_REMOTE_READ_REQ;
+    header[CMD_POSITION_LENGTH_LSB] = (commandLength & 0x00FF);
+    header[CMD_POSITION_LENGTH_MSB] = (commandLength & 0xFF00) >> 8;
+    memcpy(&header[CMD_POSITION_DATA], &destAddress, 4);
+    header[CMD_POSITION_DATA + 4] = amountGPIOToRead;
+
+    uint8_t checksum = FrameCodec_Checksum(FrameCodec_Checksum(0, header, sizeof(header)), GPIOToReadP, amountGPIOToRead);
+    struct iovec frame[3] =
+    {
+        { .iov_base = header,      .iov_len = sizeof(header) },
+        { .iov_base = GPIOToReadP, .iov_len = amountGPIOToRead },
+        { .iov_base = &checksum,   .iov_len = 1 },
+    };
+
+    CommandQueue_Request_t *requestP = CommandQueue_NewRequest(ThyoneI_CMD_GPIO_REMOTE_READ_RSP, frame, 3, MAX_RX_CMD_LENGTH, sizeof(AsyncGPIORead_t));
+    if(requestP == NULL)
+    {
+        return false;
+    }
+    /* answered by the remote device over the air */
+    CommandQueue_SetFixedTimeout(requestP);
+    AsyncGPIORead_t *readP = requestP->contextP;
+    readP->callback = cb;
+    readP->contextP = contextP;
+
+    return CommandQueue_SubmitAsync(&cmdQueue, requestP, GetDefaultTransport(), 1000, GPIORemoteReadDone);
+}
+
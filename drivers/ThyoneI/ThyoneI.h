@@ -84,6 +84,9 @@ typedef struct ThyoneI_GPIOControlBlock_t{
     uint8_t value;
 } ThyoneI_GPIOControlBlock_t;
 
+/* completion of ThyoneI_GPIORemoteReadAsync, controlP is valid until the callback returns */
+typedef void (*ThyoneI_GPIORemoteReadCallback)(bool success, ThyoneI_GPIOControlBlock_t* controlP, uint16_t controlLength, void* contextP);
+
 typedef enum ThyoneI_ResetReason_t {
     ThyoneI_ResetReason_PowerOn   = (uint8_t)0x01,
     ThyoneI_ResetReason_PinReset  = (uint8_t)0x02,
@@ -215,6 +218,7 @@ extern bool ThyoneI_GPIORemoteSetConfig(uint32_t destAddress, ThyoneI_GPIOConfig
 extern bool ThyoneI_GPIORemoteGetConfig(uint32_t destAddress, ThyoneI_GPIOConfigBlock_t* configP, uint16_t* configLengthP);
 extern bool ThyoneI_GPIORemoteWrite(uint32_t destAddress, ThyoneI_GPIOControlBlock_t* controlP, uint16_t controlLength);
 extern bool ThyoneI_GPIORemoteRead(uint32_t destAddress, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ThyoneI_GPIOControlBlock_t* controlP, uint16_t* controlLengthP);
+extern bool ThyoneI_GPIORemoteReadAsync(uint32_t destAddress, uint8_t *GPIOToReadP, uint8_t amountGPIOToRead, ThyoneI_GPIORemoteReadCallback cb, void* contextP);
 
 /* functions that write the non-volatile settings in the flash,
  * after modification of any non-volatile setting, the module must be reset such that the update takes effect
@@ -31,6 +31,9 @@
 #include "string.h"
 
 #include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/eventfd.h>
 
 #include "../../drivers/WE-common.h"
 #include "global.h"
@@ -94,6 +97,1722 @@ void delay(unsigned int sleepFor)
     nanosleep(&sleeper, &dummy) ;
 }
 
+bool InitMonotonicCond(pthread_cond_t *condP)
+{
+    pthread_condattr_t attr;
+    bool ret;
+
+    if(pthread_condattr_init(&attr) != 0)
+    {
+        return false;
+    }
+    ret = (pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0) && (pthread_cond_init(condP, &attr) == 0);
+    pthread_condattr_destroy(&attr);
+    return ret;
+}
+
+void GetDeadline(struct timespec *deadlineP, int timeout_ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadlineP);
+    deadlineP->tv_sec += timeout_ms / 1000;
+    deadlineP->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if(deadlineP->tv_nsec >= 1000000000L)
+    {
+        deadlineP->tv_sec++;
+        deadlineP->tv_nsec -= 1000000000L;
+    }
+}
+
+int RxThreadEvent_Create()
+{
+    return eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+void RxThreadEvent_Destroy(int eventFd)
+{
+    if(eventFd >= 0)
+    {
+        close(eventFd);
+    }
+}
+
+bool RxThreadEvent_Signal(int eventFd, uint64_t event)
+{
+    if(eventFd < 0)
+    {
+        return false;
+    }
+
+    /* the eventfd counter adds up the written values, events of one kind are
+     * counted in their own 32 bit half so they never spill into the other */
+    return (write(eventFd, &event, sizeof(event)) == sizeof(event));
+}
+
+uint64_t RxThreadEvent_Read(int eventFd)
+{
+    uint64_t value = 0;
+    uint64_t events = 0;
+
+    if((eventFd < 0) || (read(eventFd, &value, sizeof(value)) != sizeof(value)))
+    {
+        return 0;
+    }
+
+    if(value >= RXTHREAD_EVENT_ABORT)
+    {
+        events |= RXTHREAD_EVENT_ABORT;
+    }
+    if((value & (RXTHREAD_EVENT_ABORT - 1)) != 0)
+    {
+        events |= RXTHREAD_EVENT_RESET;
+    }
+    return events;
+}
+
+void Transport_Destroy(Transport_t *transportP)
+{
+    if(transportP != NULL)
+    {
+        transportP->ops->destroy(transportP);
+    }
+}
+
+bool Transport_Open(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit)
+{
+    return (transportP != NULL) && transportP->ops->open(transportP, baudrate, parityBit);
+}
+
+bool Transport_Close(Transport_t *transportP)
+{
+    return (transportP != NULL) && transportP->ops->close(transportP);
+}
+
+bool Transport_Flush(Transport_t *transportP)
+{
+    return (transportP != NULL) && transportP->ops->flush(transportP);
+}
+
+bool Transport_SendBytes(Transport_t *transportP, uint8_t *dataP, uint16_t length)
+{
+    return (transportP != NULL) && transportP->ops->sendBytes(transportP, dataP, length);
+}
+
+bool Transport_SendFrame(Transport_t *transportP, const struct iovec *iov, int n)
+{
+    return (transportP != NULL) && transportP->ops->sendFrame(transportP, iov, n);
+}
+
+bool Transport_ReadBytes(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms)
+{
+    if(transportP == NULL)
+    {
+        *got = 0;
+        return false;
+    }
+    return transportP->ops->readBytes(transportP, buf, max, got, timeout_ms);
+}
+
+Serial_RxWait_t Transport_WaitForRxData(Transport_t *transportP, int eventFd, int timeout_ms)
+{
+    if(transportP == NULL)
+    {
+        return Serial_RxWait_Error;
+    }
+    return transportP->ops->waitForRxData(transportP, eventFd, timeout_ms);
+}
+
+int Transport_GetFd(Transport_t *transportP)
+{
+    return (transportP != NULL) ? transportP->ops->getFd(transportP) : -1;
+}
+
+bool Transport_InitPin(Transport_t *transportP, int pin_number)
+{
+    return (transportP != NULL) && transportP->ops->initPin(transportP, pin_number);
+}
+
+bool Transport_DeinitPin(Transport_t *transportP, int pin_number)
+{
+    return (transportP != NULL) && transportP->ops->deinitPin(transportP, pin_number);
+}
+
+bool Transport_SetPin(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+{
+    return (transportP != NULL) && transportP->ops->setPin(transportP, pin_number, inout, pull, out);
+}
+
+
+struct FramePool_t
+{
+    atomic_uint_least64_t freeHead;         /* unused buffers of the pool: index + 1 of the first one (0 if none) in the low 32 bits,
+                                             * a tag counting the changes in the high 32 bits, so that a stale head never matches */
+    atomic_uint outstanding;                /* buffers currently referenced, plus one until the pool is destroyed */
+    atomic_uint allocated;                  /* buffers currently taken from the heap */
+    uint8_t *memoryP;                       /* all buffers of the pool */
+    size_t stride;                          /* distance of the buffers in memoryP */
+    uint32_t maxAllocated;                  /* bound of allocated */
+    uint16_t bufferSize;
+};
+
+#define FRAMEPOOL_INDEX(head) ((uint32_t)(head))
+#define FRAMEPOOL_TAG(head)   ((uint32_t)((head) >> 32))
+#define FRAMEPOOL_HEAD(tag, index) (((uint_least64_t)(uint32_t)(tag) << 32) | (uint32_t)(index))
+
+/* size of a FrameBuffer_t with its data, rounded up to keep the following buffer aligned */
+static size_t FramePool_BufferStride(uint16_t bufferSize)
+{
+    const size_t alignment = sizeof(void *);
+    return (sizeof(FrameBuffer_t) + bufferSize + alignment - 1) & ~(alignment - 1);
+}
+
+/* buffer of the pool at index + 1, as stored in freeHead and nextIndex */
+static FrameBuffer_t *FramePool_Buffer(FramePool_t *poolP, uint32_t index)
+{
+    return (FrameBuffer_t *)&poolP->memoryP[(size_t)(index - 1) * poolP->stride];
+}
+
+/* put a buffer of the pool on the free list */
+static void FramePool_Push(FramePool_t *poolP, FrameBuffer_t *bufferP)
+{
+    const uint32_t index = (uint32_t)(((uint8_t *)bufferP - poolP->memoryP) / poolP->stride) + 1;
+    uint_least64_t head = atomic_load_explicit(&poolP->freeHead, memory_order_relaxed);
+
+    do
+    {
+        atomic_store_explicit(&bufferP->nextIndex, FRAMEPOOL_INDEX(head), memory_order_relaxed);
+    }
+    while(!atomic_compare_exchange_weak_explicit(&poolP->freeHead, &head, FRAMEPOOL_HEAD(FRAMEPOOL_TAG(head) + 1, index),
+                                                 memory_order_release, memory_order_relaxed));
+}
+
+/* take a buffer from the free list, NULL if it is empty; the tag makes the exchange fail when the
+ * head was taken and given back in between, even though its nextIndex changed meanwhile */
+static FrameBuffer_t *FramePool_Pop(FramePool_t *poolP)
+{
+    uint_least64_t head = atomic_load_explicit(&poolP->freeHead, memory_order_acquire);
+    FrameBuffer_t *bufferP;
+
+    do
+    {
+        if(FRAMEPOOL_INDEX(head) == 0)
+        {
+            return NULL;
+        }
+        bufferP = FramePool_Buffer(poolP, FRAMEPOOL_INDEX(head));
+    }
+    while(!atomic_compare_exchange_weak_explicit(&poolP->freeHead, &head,
+                                                 FRAMEPOOL_HEAD(FRAMEPOOL_TAG(head) + 1, atomic_load_explicit(&bufferP->nextIndex, memory_order_relaxed)),
+                                                 memory_order_acquire, memory_order_acquire));
+    return bufferP;
+}
+
+FramePool_t *FramePool_Create(uint16_t count, uint32_t maxAllocated, uint16_t bufferSize)
+{
+    const size_t stride = FramePool_BufferStride(bufferSize);
+    FramePool_t *poolP;
+    uint16_t i;
+
+    poolP = calloc(1, sizeof(FramePool_t));
+    if(poolP == NULL)
+    {
+        return NULL;
+    }
+    poolP->memoryP = calloc(count, stride);
+    if((poolP->memoryP == NULL) && (count > 0))
+    {
+        free(poolP);
+        return NULL;
+    }
+    atomic_init(&poolP->freeHead, 0);
+    atomic_init(&poolP->outstanding, 1);
+    atomic_init(&poolP->allocated, 0);
+    poolP->stride = stride;
+    poolP->maxAllocated = maxAllocated;
+    poolP->bufferSize = bufferSize;
+
+    for(i = 0; i < count; i++)
+    {
+        FrameBuffer_t *bufferP = (FrameBuffer_t *)&poolP->memoryP[i * stride];
+        bufferP->poolP = poolP;
+        atomic_init(&bufferP->references, 0);
+        FramePool_Push(poolP, bufferP);
+    }
+    return poolP;
+}
+
+static void FramePool_Free(FramePool_t *poolP)
+{
+    free(poolP->memoryP);
+    free(poolP);
+}
+
+/* give back a reference to the pool itself, it is freed with the last one */
+static void FramePool_Unreference(FramePool_t *poolP)
+{
+    if(atomic_fetch_sub_explicit(&poolP->outstanding, 1, memory_order_acq_rel) == 1)
+    {
+        FramePool_Free(poolP);
+    }
+}
+
+void FramePool_Destroy(FramePool_t *poolP)
+{
+    if(poolP == NULL)
+    {
+        return;
+    }
+
+    /* the reference taken by FramePool_Create */
+    FramePool_Unreference(poolP);
+}
+
+FrameBuffer_t *FramePool_Get(FramePool_t *poolP)
+{
+    FrameBuffer_t *bufferP = FramePool_Pop(poolP);
+
+    if(bufferP == NULL)
+    {
+        /* all buffers are held by the application, take one from the heap within the bound */
+        if(atomic_fetch_add_explicit(&poolP->allocated, 1, memory_order_relaxed) >= poolP->maxAllocated)
+        {
+            atomic_fetch_sub_explicit(&poolP->allocated, 1, memory_order_relaxed);
+            return NULL;
+        }
+        bufferP = malloc(sizeof(FrameBuffer_t) + poolP->bufferSize);
+        if(bufferP == NULL)
+        {
+            atomic_fetch_sub_explicit(&poolP->allocated, 1, memory_order_relaxed);
+            return NULL;
+        }
+        bufferP->poolP = poolP;
+        bufferP->allocated = true;
+    }
+    atomic_store_explicit(&bufferP->nextIndex, 0, memory_order_relaxed);
+    atomic_store_explicit(&bufferP->references, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&poolP->outstanding, 1, memory_order_relaxed);
+    return bufferP;
+}
+
+FrameBuffer_t *FrameBuffer_Of(uint8_t *dataP)
+{
+    return (FrameBuffer_t *)(dataP - offsetof(FrameBuffer_t, data));
+}
+
+void FrameBuffer_Retain(FrameBuffer_t *bufferP)
+{
+    atomic_fetch_add_explicit(&bufferP->references, 1, memory_order_relaxed);
+}
+
+void FrameBuffer_Release(FrameBuffer_t *bufferP)
+{
+    FramePool_t *poolP = bufferP->poolP;
+
+    if(atomic_fetch_sub_explicit(&bufferP->references, 1, memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+    if(bufferP->allocated)
+    {
+        free(bufferP);
+        atomic_fetch_sub_explicit(&poolP->allocated, 1, memory_order_relaxed);
+    }
+    else
+    {
+        FramePool_Push(poolP, bufferP);
+    }
+    FramePool_Unreference(poolP);
+}
+
+/* true, if the caller holds the only reference to the buffer */
+static bool FrameBuffer_IsExclusive(FrameBuffer_t *bufferP)
+{
+    return (atomic_load_explicit(&bufferP->references, memory_order_acquire) == 1);
+}
+
+
+void FrameCodec_Init(FrameCodec_t *codecP, const FrameCodec_Protocol_t *protocolP, uint8_t *bufferP, uint16_t bufferSize, void *contextP)
+{
+    codecP->protocolP = protocolP;
+    codecP->contextP = contextP;
+    codecP->poolP = NULL;
+    codecP->frameBufferP = NULL;
+    codecP->bufferP = bufferP;
+    codecP->bufferSize = bufferSize;
+    FrameCodec_Reset(codecP);
+}
+
+bool FrameCodec_InitPool(FrameCodec_t *codecP, const FrameCodec_Protocol_t *protocolP, FramePool_t *poolP, void *contextP)
+{
+    FrameBuffer_t *bufferP = FramePool_Get(poolP);
+
+    if(bufferP == NULL)
+    {
+        return false;
+    }
+    FrameCodec_Init(codecP, protocolP, bufferP->data, poolP->bufferSize, contextP);
+    codecP->poolP = poolP;
+    codecP->frameBufferP = bufferP;
+    return true;
+}
+
+void FrameCodec_Deinit(FrameCodec_t *codecP)
+{
+    if(codecP->frameBufferP != NULL)
+    {
+        FrameBuffer_Release(codecP->frameBufferP);
+        codecP->frameBufferP = NULL;
+    }
+    codecP->bufferP = NULL;
+}
+
+void FrameCodec_Reset(FrameCodec_t *codecP)
+{
+    codecP->received = 0;
+    codecP->frameLength = 0;
+    codecP->checksum = 0;
+}
+
+/* result of feeding bytes to the codec */
+typedef enum FrameCodec_FeedResult_t
+{
+    FrameCodec_FeedResult_Pending,      /* all bytes consumed, no frame completed */
+    FrameCodec_FeedResult_Frame,        /* a valid frame was handled */
+    FrameCodec_FeedResult_Rejected,     /* the current frame is invalid, its bytes are still in the buffer */
+} FrameCodec_FeedResult_t;
+
+static pthread_mutex_t frameCodecStatistics_mutex = PTHREAD_MUTEX_INITIALIZER;
+static FrameCodec_Statistics_t frameCodecStatistics;
+
+/* add to the counters of all codecs, called on the error paths only */
+static void FrameCodec_Count(uint32_t checksumErrors, uint32_t lengthErrors, uint32_t recoveredFrames, uint32_t discardedBytes)
+{
+    pthread_mutex_lock(&frameCodecStatistics_mutex);
+    frameCodecStatistics.checksumErrors += checksumErrors;
+    frameCodecStatistics.lengthErrors += lengthErrors;
+    frameCodecStatistics.recoveredFrames += recoveredFrames;
+    frameCodecStatistics.discardedBytes += discardedBytes;
+    pthread_mutex_unlock(&frameCodecStatistics_mutex);
+}
+
+/* make sure no callback holds the buffer the codec is about to write to: a buffer still
+ * referenced elsewhere is replaced by a new one of the pool, the reference to the old buffer
+ * is returned in *previousP if the caller still reads from it, otherwise it is released */
+static bool FrameCodec_OwnBuffer(FrameCodec_t *codecP, FrameBuffer_t **previousP)
+{
+    FrameBuffer_t *bufferP = codecP->frameBufferP;
+
+    if(previousP != NULL)
+    {
+        *previousP = NULL;
+    }
+    if((bufferP != NULL) && FrameBuffer_IsExclusive(bufferP))
+    {
+        return true;
+    }
+
+    codecP->frameBufferP = FramePool_Get(codecP->poolP);
+    codecP->bufferP = (codecP->frameBufferP != NULL) ? codecP->frameBufferP->data : NULL;
+    if(bufferP != NULL)
+    {
+        if(previousP != NULL)
+        {
+            *previousP = bufferP;
+        }
+        else
+        {
+            FrameBuffer_Release(bufferP);
+        }
+    }
+    return (codecP->frameBufferP != NULL);
+}
+
+/* consume bytes until a frame is completed or rejected, *consumedP returns the number of bytes taken from dataP */
+static FrameCodec_FeedResult_t FrameCodec_Feed(FrameCodec_t *codecP, const uint8_t *dataP, size_t length, size_t *consumedP)
+{
+    const FrameCodec_Protocol_t *protocolP = codecP->protocolP;
+    const uint16_t headerLength = FRAMECODEC_POSITION_LENGTH + protocolP->lengthBytes;   /* STX, CMD, LEN */
+    const uint8_t *startP = dataP;
+
+    while(length > 0)
+    {
+        size_t count;
+
+        if(codecP->received == 0)
+        {
+            /* skip everything up to the next start byte */
+            const uint8_t *stxP = memchr(dataP, protocolP->stx, length);
+            if(stxP == NULL)
+            {
+                break;
+            }
+            length -= (size_t)(stxP - dataP);
+            dataP = stxP;
+
+            if((codecP->poolP != NULL) && !FrameCodec_OwnBuffer(codecP, NULL))
+            {
+                /* the application holds all buffers the pool may give, drop the frame */
+                break;
+            }
+        }
+
+        if(codecP->received < headerLength)
+        {
+            codecP->checksum ^= *dataP;
+            codecP->bufferP[codecP->received++] = *dataP++;
+            length--;
+
+            if(codecP->received == headerLength)
+            {
+                uint16_t dataLength = codecP->bufferP[FRAMECODEC_POSITION_LENGTH];
+                if(protocolP->lengthBytes > 1)
+                {
+                    dataLength |= (uint16_t)codecP->bufferP[FRAMECODEC_POSITION_LENGTH + 1] << 8;
+                }
+
+                if((uint32_t)dataLength + headerLength + 1 > codecP->bufferSize)
+                {
+                    /* implausible length field */
+                    *consumedP = (size_t)(dataP - startP);
+                    return FrameCodec_FeedResult_Rejected;
+                }
+                codecP->frameLength = dataLength + headerLength + 1;
+            }
+            continue;
+        }
+
+        /* DATA and CS, the source may be the buffer itself when resynchronizing */
+        count = codecP->frameLength - codecP->received;
+        if(count > length)
+        {
+            count = length;
+        }
+        memmove(&codecP->bufferP[codecP->received], dataP, count);
+        codecP->checksum = FrameCodec_Checksum(codecP->checksum, dataP, count);
+        codecP->received += count;
+        dataP += count;
+        length -= count;
+
+        if(codecP->received == codecP->frameLength)
+        {
+            *consumedP = (size_t)(dataP - startP);
+
+            /* CS included, the XOR over a valid frame is 0 */
+            if(codecP->checksum != 0)
+            {
+                return FrameCodec_FeedResult_Rejected;
+            }
+
+            /* received frame ok, interprete it now */
+            protocolP->handleFrame(codecP->contextP, codecP->bufferP);
+            FrameCodec_Reset(codecP);
+            return FrameCodec_FeedResult_Frame;
+        }
+    }
+
+    *consumedP = (size_t)(dataP - startP) + length;
+    return FrameCodec_FeedResult_Pending;
+}
+
+/* the frame in the buffer was rejected: its start byte may have been a data byte of a
+ * frame that begins later in the buffer, so look for start bytes among the bytes already
+ * received and parse from there instead of waiting for the next start byte on the line */
+static void FrameCodec_Resync(FrameCodec_t *codecP, bool checksumError)
+{
+    size_t pending = codecP->received;      /* bytes at the start of the buffer still to be scanned */
+    size_t accounted = 0;                   /* bytes at the start of the buffer belonging to a recovered frame */
+    size_t index = 1;                       /* skip the rejected start byte */
+    uint32_t checksumErrors = checksumError ? 1 : 0;
+    uint32_t lengthErrors = checksumError ? 0 : 1;
+    uint32_t recoveredFrames = 0;
+    uint32_t discardedBytes = 0;
+
+    while(1)
+    {
+        uint8_t *bufferP = codecP->bufferP;
+        FrameBuffer_t *previousP = NULL;
+        FrameCodec_FeedResult_t result;
+        size_t consumed;
+        const uint8_t *stxP = NULL;
+        bool owned;
+
+        if(index < pending)
+        {
+            stxP = memchr(&bufferP[index], codecP->protocolP->stx, pending - index);
+        }
+        if(stxP == NULL)
+        {
+            discardedBytes += (uint32_t)(pending - accounted);
+            FrameCodec_Reset(codecP);
+            break;
+        }
+
+        /* move the candidate frame to the start of the buffer, a recovered frame
+         * may still be held by a callback, then a new buffer is used */
+        discardedBytes += (uint32_t)(stxP - &bufferP[accounted]);
+        pending -= (size_t)(stxP - bufferP);
+        owned = (codecP->poolP == NULL) || FrameCodec_OwnBuffer(codecP, &previousP);
+        if(owned)
+        {
+            memmove(codecP->bufferP, stxP, pending);
+        }
+        if(previousP != NULL)
+        {
+            FrameBuffer_Release(previousP);
+        }
+        if(!owned)
+        {
+            discardedBytes += (uint32_t)pending;
+            FrameCodec_Reset(codecP);
+            break;
+        }
+
+        FrameCodec_Reset(codecP);
+        result = FrameCodec_Feed(codecP, codecP->bufferP, pending, &consumed);
+        if(result == FrameCodec_FeedResult_Pending)
+        {
+            /* the candidate is the start of a frame still being received */
+            break;
+        }
+
+        if(result == FrameCodec_FeedResult_Frame)
+        {
+            /* continue behind the recovered frame */
+            recoveredFrames++;
+            accounted = consumed;
+            index = consumed;
+        }
+        else
+        {
+            /* candidate rejected as well, its bytes are still at the start of the buffer */
+            if(codecP->received == codecP->frameLength)
+            {
+                checksumErrors++;
+            }
+            else
+            {
+                lengthErrors++;
+            }
+            accounted = 0;
+            index = 1;
+        }
+    }
+
+    FrameCodec_Count(checksumErrors, lengthErrors, recoveredFrames, discardedBytes);
+}
+
+void FrameCodec_Parse(FrameCodec_t *codecP, const uint8_t *dataP, size_t length)
+{
+    while(length > 0)
+    {
+        size_t consumed;
+
+        if(FrameCodec_Feed(codecP, dataP, length, &consumed) == FrameCodec_FeedResult_Rejected)
+        {
+            FrameCodec_Resync(codecP, codecP->received == codecP->frameLength);
+        }
+        dataP += consumed;
+        length -= consumed;
+    }
+}
+
+void FrameCodec_GetStatistics(FrameCodec_Statistics_t *statisticsP)
+{
+    pthread_mutex_lock(&frameCodecStatistics_mutex);
+    *statisticsP = frameCodecStatistics;
+    pthread_mutex_unlock(&frameCodecStatistics_mutex);
+}
+
+void FrameCodec_RxLoop(FrameCodec_t *codecP, Transport_t *transportP, int eventFd)
+{
+    uint8_t rxChunk[SERIAL_RX_CHUNK_SIZE];          /* bytes drained from the interface by one read */
+    size_t rxChunkLength = 0;
+    Serial_RxWait_t rxWait;
+
+    while(1)
+    {
+        /* sleep until new RX data is available or the thread is signalled */
+        rxWait = Transport_WaitForRxData(transportP, eventFd, -1);
+        if(rxWait == Serial_RxWait_Event)
+        {
+            uint64_t rxEvents = RxThreadEvent_Read(eventFd);
+
+            if(rxEvents & RXTHREAD_EVENT_ABORT)
+            {
+                return;
+            }
+
+            if(rxEvents & RXTHREAD_EVENT_RESET)
+            {
+                FrameCodec_Reset(codecP);
+            }
+        }
+        else if(rxWait == Serial_RxWait_Error)
+        {
+            /* interface can not be waited on, do not spin */
+            delay(1);
+        }
+
+        while(Transport_ReadBytes(transportP, rxChunk, sizeof(rxChunk), &rxChunkLength, 0) && (rxChunkLength > 0))
+        {
+            FrameCodec_Parse(codecP, rxChunk, rxChunkLength);
+        }
+    }
+}
+
+uint8_t FrameCodec_Checksum(uint8_t checksum, const uint8_t *dataP, size_t length)
+{
+    uint64_t wideChecksum = 0;
+
+    /* XOR eight bytes at once, the byte order does not matter as all bytes are folded at the end */
+    while(length >= sizeof(wideChecksum))
+    {
+        uint64_t word;
+        memcpy(&word, dataP, sizeof(word));   /* dataP need not be aligned */
+        wideChecksum ^= word;
+        dataP += sizeof(word);
+        length -= sizeof(word);
+    }
+    wideChecksum ^= wideChecksum >> 32;
+    wideChecksum ^= wideChecksum >> 16;
+    wideChecksum ^= wideChecksum >> 8;
+    checksum ^= (uint8_t)wideChecksum;
+
+    while(length > 0)
+    {
+        checksum ^= *dataP++;
+        length--;
+    }
+    return checksum;
+}
+
+bool FrameCodec_FillChecksum(const FrameCodec_Protocol_t *protocolP, uint8_t *frameP, uint16_t length)
+{
+    const uint16_t headerLength = FRAMECODEC_POSITION_LENGTH + protocolP->lengthBytes;
+    uint16_t dataLength;
+
+    if((length < headerLength + 1) || (frameP[FRAMECODEC_POSITION_STX] != protocolP->stx))
+    {
+        return false;
+    }
+
+    dataLength = frameP[FRAMECODEC_POSITION_LENGTH];
+    if(protocolP->lengthBytes > 1)
+    {
+        dataLength |= (uint16_t)frameP[FRAMECODEC_POSITION_LENGTH + 1] << 8;
+    }
+    if((uint32_t)dataLength + headerLength + 1 > length)
+    {
+        return false;
+    }
+
+    frameP[headerLength + dataLength] = FrameCodec_Checksum(0, frameP, headerLength + dataLength);
+    return true;
+}
+
+bool CommandQueue_Init(CommandQueue_t *queueP, uint16_t depth)
+{
+    memset(queueP, 0, sizeof(CommandQueue_t));
+    queueP->depth = (depth > 0) ? depth : 1;
+
+    /* requests are waited for with CLOCK_MONOTONIC deadlines */
+    if(!InitMonotonicCond(&queueP->cond))
+    {
+        return false;
+    }
+    pthread_mutex_init(&queueP->mutex, NULL);
+    pthread_mutex_init(&queueP->submitMutex, NULL);
+    return true;
+}
+
+void CommandQueue_Deinit(CommandQueue_t *queueP)
+{
+    /* the dispatcher fails the asynchronous requests left before it ends */
+    pthread_mutex_lock(&queueP->mutex);
+    queueP->stop = true;
+    pthread_cond_broadcast(&queueP->cond);
+    pthread_mutex_unlock(&queueP->mutex);
+    if(queueP->dispatcherRunning)
+    {
+        pthread_join(queueP->dispatcher, NULL);
+        queueP->dispatcherRunning = false;
+    }
+
+    pthread_mutex_destroy(&queueP->submitMutex);
+    pthread_mutex_destroy(&queueP->mutex);
+    pthread_cond_destroy(&queueP->cond);
+}
+
+void CommandQueue_SetDepth(CommandQueue_t *queueP, uint16_t depth)
+{
+    pthread_mutex_lock(&queueP->mutex);
+    queueP->depth = (depth > 0) ? depth : 1;
+    pthread_cond_broadcast(&queueP->cond);
+    pthread_mutex_unlock(&queueP->mutex);
+}
+
+void CommandQueue_SetLineRate(CommandQueue_t *queueP, uint32_t baudrate)
+{
+    int cmd;
+
+    pthread_mutex_lock(&queueP->mutex);
+    queueP->baudrate = baudrate;
+    for(cmd = 0; cmd < 256; cmd++)
+    {
+        queueP->rtt[cmd].valid = false;
+    }
+    pthread_mutex_unlock(&queueP->mutex);
+}
+
+/* time a number of bytes needs on the line, in microseconds */
+static uint32_t CommandQueue_LineTime(CommandQueue_t *queueP, uint32_t length)
+{
+    return (uint32_t)(((uint64_t)length * COMMANDQUEUE_BITS_PER_BYTE * 1000000 + queueP->baudrate - 1) / queueP->baudrate);
+}
+
+/* time to wait for the answer of a request that was just sent, called with the mutex held */
+static int CommandQueue_Timeout(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, int max_time_ms)
+{
+    CommandQueue_Rtt_t *rttP = &queueP->rtt[requestP->confirmation];
+    uint64_t timeout_us;
+
+    if((queueP->baudrate == 0) || requestP->fixedTimeout || (requestP->frameLength == 0))
+    {
+        return max_time_ms;
+    }
+
+    timeout_us = (uint64_t)max_time_ms * 1000;
+    if(rttP->valid && (rttP->rto_us < timeout_us))
+    {
+        timeout_us = rttP->rto_us;
+    }
+
+    /* neither the request nor the answer are cut off by the time they need on the line */
+    timeout_us += CommandQueue_LineTime(queueP, (uint32_t)requestP->frameLength + rttP->answerLength);
+    return (int)((timeout_us + 999) / 1000);
+}
+
+/* update the round trip time of the CMD answering a request, called with the mutex held */
+static void CommandQueue_Measure(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, uint16_t answerLength)
+{
+    CommandQueue_Rtt_t *rttP = &queueP->rtt[requestP->confirmation];
+    struct timespec now;
+    int64_t sample_us;
+    uint32_t deviation_us;
+
+    if((queueP->baudrate == 0) || requestP->fixedTimeout || (requestP->frameLength == 0))
+    {
+        return;
+    }
+
+    if(answerLength > rttP->answerLength)
+    {
+        rttP->answerLength = answerLength;
+    }
+
+    /* time the module took, without the time the request and the answer needed on the line */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    sample_us = (int64_t)(now.tv_sec - requestP->sent.tv_sec) * 1000000 + (now.tv_nsec - requestP->sent.tv_nsec) / 1000;
+    sample_us -= CommandQueue_LineTime(queueP, (uint32_t)requestP->frameLength + answerLength);
+    if(sample_us < 0)
+    {
+        sample_us = 0;
+    }
+    else if(sample_us > UINT32_MAX / 8)
+    {
+        sample_us = UINT32_MAX / 8;
+    }
+
+    /* RFC 6298 with alpha = 1/8 and beta = 1/4 */
+    if(!rttP->valid)
+    {
+        rttP->srtt_us = (uint32_t)sample_us;
+        rttP->rttvar_us = (uint32_t)sample_us / 2;
+        rttP->valid = true;
+    }
+    else
+    {
+        deviation_us = (rttP->srtt_us > sample_us) ? rttP->srtt_us - (uint32_t)sample_us : (uint32_t)sample_us - rttP->srtt_us;
+        rttP->rttvar_us = (3 * rttP->rttvar_us + deviation_us) / 4;
+        rttP->srtt_us = (7 * rttP->srtt_us + (uint32_t)sample_us) / 8;
+    }
+    rttP->rto_us = rttP->srtt_us + ((4 * rttP->rttvar_us > 1000) ? 4 * rttP->rttvar_us : 1000);
+    if(rttP->rto_us < COMMANDQUEUE_MIN_TIMEOUT_MS * 1000)
+    {
+        rttP->rto_us = COMMANDQUEUE_MIN_TIMEOUT_MS * 1000;
+    }
+}
+
+/* back off after a request of a CMD was not answered in time, called with the mutex held */
+static void CommandQueue_Backoff(CommandQueue_t *queueP, CommandQueue_Request_t *requestP)
+{
+    CommandQueue_Rtt_t *rttP = &queueP->rtt[requestP->confirmation];
+
+    if(rttP->valid && (rttP->rto_us < UINT32_MAX / 2))
+    {
+        rttP->rto_us *= 2;
+    }
+}
+
+uint16_t CommandQueue_Pending(CommandQueue_t *queueP)
+{
+    uint16_t pending;
+
+    pthread_mutex_lock(&queueP->mutex);
+    pending = queueP->pending;
+    pthread_mutex_unlock(&queueP->mutex);
+    return pending;
+}
+
+void CommandQueue_InitRequest(CommandQueue_Request_t *requestP, uint8_t confirmation, uint8_t *responseP, uint16_t responseSize)
+{
+    requestP->confirmation = confirmation;
+    requestP->keyLength = 0;
+    requestP->keyOffset = 0;
+    requestP->responseP = responseP;
+    requestP->responseSize = (responseP != NULL) ? responseSize : 0;
+    requestP->responseLength = 0;
+    requestP->status = 0;
+    requestP->done = false;
+    requestP->fixedTimeout = false;
+    requestP->sending = false;
+    requestP->callback = NULL;
+    requestP->contextP = NULL;
+    requestP->transportP = NULL;
+    requestP->frameP = NULL;
+    requestP->frameLength = 0;
+    requestP->nextP = NULL;
+}
+
+bool CommandQueue_SetKey(CommandQueue_Request_t *requestP, uint16_t offset, const uint8_t *keyP, uint8_t length)
+{
+    if(length > COMMANDQUEUE_MAX_KEY_LENGTH)
+    {
+        return false;
+    }
+    memcpy(requestP->key, keyP, length);
+    requestP->keyLength = length;
+    requestP->keyOffset = offset;
+    return true;
+}
+
+void CommandQueue_SetFixedTimeout(CommandQueue_Request_t *requestP)
+{
+    requestP->fixedTimeout = true;
+}
+
+/* append a request to a list of the queue, called with the mutex held */
+static void CommandQueue_Append(CommandQueue_Request_t **headPP, CommandQueue_Request_t **tailPP, CommandQueue_Request_t *requestP)
+{
+    requestP->nextP = NULL;
+    if(*tailPP == NULL)
+    {
+        *headPP = requestP;
+    }
+    else
+    {
+        (*tailPP)->nextP = requestP;
+    }
+    *tailPP = requestP;
+}
+
+/* hand a finished asynchronous request to the dispatcher, called with the mutex held */
+static void CommandQueue_Complete(CommandQueue_t *queueP, CommandQueue_Request_t *requestP)
+{
+    CommandQueue_Append(&queueP->completedHeadP, &queueP->completedTailP, requestP);
+    pthread_cond_broadcast(&queueP->cond);
+}
+
+/* unlink a request of the queue and free its slot, called with the mutex held */
+static void CommandQueue_Remove(CommandQueue_t *queueP, CommandQueue_Request_t *requestP)
+{
+    CommandQueue_Request_t *previousP = NULL;
+    CommandQueue_Request_t *currentP;
+
+    for(currentP = queueP->headP; currentP != NULL; previousP = currentP, currentP = currentP->nextP)
+    {
+        if(currentP == requestP)
+        {
+            if(previousP == NULL)
+            {
+                queueP->headP = currentP->nextP;
+            }
+            else
+            {
+                previousP->nextP = currentP->nextP;
+            }
+            if(queueP->tailP == currentP)
+            {
+                queueP->tailP = previousP;
+            }
+            currentP->nextP = NULL;
+            queueP->pending--;
+            pthread_cond_broadcast(&queueP->cond);
+            return;
+        }
+    }
+}
+
+/* queue a request, and followP behind it if not NULL, in one slot and send the frame of the request */
+static bool CommandQueue_SubmitRequests(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, CommandQueue_Request_t *followP,
+                                        Transport_t *transportP, const struct iovec *iov, int n, int max_time_ms)
+{
+    struct timespec deadline;
+    int waitResult = 0;
+    bool ret = true;
+    int i;
+
+    GetDeadline(&deadline, max_time_ms);
+
+    /* a second command must not queue its request between queueing and sending this one */
+    pthread_mutex_lock(&queueP->submitMutex);
+
+    pthread_mutex_lock(&queueP->mutex);
+    while(queueP->pending >= queueP->depth)
+    {
+        if(waitResult == ETIMEDOUT)
+        {
+            pthread_mutex_unlock(&queueP->mutex);
+            pthread_mutex_unlock(&queueP->submitMutex);
+            return false;
+        }
+        waitResult = pthread_cond_timedwait(&queueP->cond, &queueP->mutex, &deadline);
+    }
+    requestP->done = false;
+    requestP->frameLength = 0;
+    for(i = 0; i < n; i++)
+    {
+        requestP->frameLength += iov[i].iov_len;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &requestP->sent);
+    CommandQueue_Append(&queueP->headP, &queueP->tailP, requestP);
+    queueP->pending++;
+    if(followP != NULL)
+    {
+        /* queued before the frame is sent, so it cannot miss the frame following the answer */
+        followP->done = false;
+        followP->frameLength = 0;
+        followP->sent = requestP->sent;
+        CommandQueue_Append(&queueP->headP, &queueP->tailP, followP);
+        queueP->pending++;
+    }
+    pthread_mutex_unlock(&queueP->mutex);
+
+    /* the answer may arrive before Transport_SendFrame returns, it finds the request queued */
+    if(n > 0)
+    {
+        ret = Transport_SendFrame(transportP, iov, n);
+    }
+
+    pthread_mutex_unlock(&queueP->submitMutex);
+
+    pthread_mutex_lock(&queueP->mutex);
+    if(!ret)
+    {
+        CommandQueue_Remove(queueP, requestP);
+        if(followP != NULL)
+        {
+            CommandQueue_Remove(queueP, followP);
+        }
+    }
+    else if(queueP->backlogHeadP != NULL)
+    {
+        /* the dispatcher may have found the submit mutex taken */
+        pthread_cond_broadcast(&queueP->cond);
+    }
+    pthread_mutex_unlock(&queueP->mutex);
+    return ret;
+}
+
+bool CommandQueue_Submit(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, Transport_t *transportP, const struct iovec *iov, int n, int max_time_ms)
+{
+    return CommandQueue_SubmitRequests(queueP, requestP, NULL, transportP, iov, n, max_time_ms);
+}
+
+bool CommandQueue_SubmitFollowUp(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, CommandQueue_Request_t *followP,
+                                 Transport_t *transportP, const struct iovec *iov, int n, int max_time_ms)
+{
+    return CommandQueue_SubmitRequests(queueP, requestP, followP, transportP, iov, n, max_time_ms);
+}
+
+bool CommandQueue_Wait(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, int max_time_ms)
+{
+    struct timespec deadline;
+    int waitResult = 0;
+    bool ret;
+
+    pthread_mutex_lock(&queueP->mutex);
+    GetDeadline(&deadline, CommandQueue_Timeout(queueP, requestP, max_time_ms));
+    while(!requestP->done && (waitResult != ETIMEDOUT))
+    {
+        /* sleep until CommandQueue_Confirm completed a request */
+        waitResult = pthread_cond_timedwait(&queueP->cond, &queueP->mutex, &deadline);
+    }
+    ret = requestP->done;
+    if(!ret)
+    {
+        /* a late answer must not complete the next request of this CMD */
+        CommandQueue_Remove(queueP, requestP);
+        CommandQueue_Backoff(queueP, requestP);
+    }
+    pthread_mutex_unlock(&queueP->mutex);
+    return ret;
+}
+
+void CommandQueue_Cancel(CommandQueue_t *queueP, CommandQueue_Request_t *requestP)
+{
+    pthread_mutex_lock(&queueP->mutex);
+    if(!requestP->done)
+    {
+        CommandQueue_Remove(queueP, requestP);
+    }
+    pthread_mutex_unlock(&queueP->mutex);
+}
+
+bool CommandQueue_Confirm(CommandQueue_t *queueP, uint8_t cmd, uint8_t status, const uint8_t *frameP, uint16_t length)
+{
+    CommandQueue_Request_t *requestP;
+
+    pthread_mutex_lock(&queueP->mutex);
+    for(requestP = queueP->headP; requestP != NULL; requestP = requestP->nextP)
+    {
+        if((requestP->confirmation == cmd) &&
+           ((requestP->keyLength == 0) ||
+            ((requestP->keyOffset + requestP->keyLength <= length) && (0 == memcmp(&frameP[requestP->keyOffset], requestP->key, requestP->keyLength)))))
+        {
+            break;
+        }
+    }
+    if(requestP == NULL)
+    {
+        /* nobody waits for it (anymore) */
+        pthread_mutex_unlock(&queueP->mutex);
+        return false;
+    }
+
+    CommandQueue_Measure(queueP, requestP, length);
+    requestP->status = status;
+    requestP->responseLength = length;
+    if(requestP->responseP != NULL)
+    {
+        memcpy(requestP->responseP, frameP, (length < requestP->responseSize) ? length : requestP->responseSize);
+    }
+    requestP->done = true;
+    CommandQueue_Remove(queueP, requestP);
+    if(requestP->callback != NULL)
+    {
+        CommandQueue_Complete(queueP, requestP);
+    }
+    pthread_mutex_unlock(&queueP->mutex);
+    return true;
+}
+
+/* send the oldest request of the backlog, called with the mutex and the submit mutex held,
+ * the mutex is released while the frame is written */
+static void CommandQueue_SendBacklog(CommandQueue_t *queueP)
+{
+    CommandQueue_Request_t *requestP = queueP->backlogHeadP;
+    Transport_t *transportP = requestP->transportP;
+    struct iovec frame = { .iov_base = requestP->frameP, .iov_len = requestP->frameLength };
+
+    queueP->backlogHeadP = requestP->nextP;
+    if(queueP->backlogHeadP == NULL)
+    {
+        queueP->backlogTailP = NULL;
+    }
+    CommandQueue_Append(&queueP->headP, &queueP->tailP, requestP);
+    queueP->pending++;
+    clock_gettime(CLOCK_MONOTONIC, &requestP->sent);
+    GetDeadline(&requestP->deadline, CommandQueue_Timeout(queueP, requestP, requestP->timeout_ms));
+    requestP->sending = true;
+    pthread_mutex_unlock(&queueP->mutex);
+
+    /* the request may be answered and completed before this returns, the dispatcher frees it
+     * only once the frame was written; if the frame could not be sent, the request times out */
+    Transport_SendFrame(transportP, &frame, 1);
+
+    pthread_mutex_lock(&queueP->mutex);
+    requestP->sending = false;
+    pthread_cond_broadcast(&queueP->cond);
+}
+
+/* fail the first asynchronous request in flight that is due, called with the mutex held,
+ * otherwise the earliest deadline is returned in nextP
+ *
+ * return: true, if a request was failed */
+static bool CommandQueue_Expire(CommandQueue_t *queueP, const struct timespec *nowP, struct timespec *nextP, bool *haveNextP)
+{
+    CommandQueue_Request_t *requestP;
+
+    for(requestP = queueP->headP; requestP != NULL; requestP = requestP->nextP)
+    {
+        if(requestP->callback == NULL)
+        {
+            /* timed out by CommandQueue_Wait */
+            continue;
+        }
+        if(queueP->stop ||
+           (requestP->deadline.tv_sec < nowP->tv_sec) ||
+           ((requestP->deadline.tv_sec == nowP->tv_sec) && (requestP->deadline.tv_nsec <= nowP->tv_nsec)))
+        {
+            CommandQueue_Remove(queueP, requestP);
+            if(!queueP->stop)
+            {
+                CommandQueue_Backoff(queueP, requestP);
+            }
+            CommandQueue_Complete(queueP, requestP);
+            return true;
+        }
+        if(!*haveNextP ||
+           (requestP->deadline.tv_sec < nextP->tv_sec) ||
+           ((requestP->deadline.tv_sec == nextP->tv_sec) && (requestP->deadline.tv_nsec < nextP->tv_nsec)))
+        {
+            *nextP = requestP->deadline;
+            *haveNextP = true;
+        }
+    }
+    return false;
+}
+
+/* thread function sending the backlog, timing out and completing the asynchronous requests of a queue */
+static void *CommandQueue_Dispatch(void *argP)
+{
+    CommandQueue_t *queueP = argP;
+    CommandQueue_Request_t *requestP;
+    struct timespec now, next;
+    bool haveNext;
+
+    pthread_mutex_lock(&queueP->mutex);
+    while(1)
+    {
+        /* callbacks are called without the mutex, they may submit further requests */
+        requestP = queueP->completedHeadP;
+        if(requestP != NULL)
+        {
+            queueP->completedHeadP = requestP->nextP;
+            if(queueP->completedHeadP == NULL)
+            {
+                queueP->completedTailP = NULL;
+            }
+            pthread_mutex_unlock(&queueP->mutex);
+            requestP->callback(requestP, requestP->done);
+            pthread_mutex_lock(&queueP->mutex);
+            /* a thread submitting the request may still write its frame */
+            while(requestP->sending)
+            {
+                pthread_cond_wait(&queueP->cond, &queueP->mutex);
+            }
+            free(requestP);
+            continue;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        haveNext = false;
+        if(CommandQueue_Expire(queueP, &now, &next, &haveNext))
+        {
+            continue;
+        }
+        if(queueP->stop)
+        {
+            if(queueP->backlogHeadP == NULL)
+            {
+                break;
+            }
+            /* fail the requests not sent yet */
+            requestP = queueP->backlogHeadP;
+            queueP->backlogHeadP = requestP->nextP;
+            if(queueP->backlogHeadP == NULL)
+            {
+                queueP->backlogTailP = NULL;
+            }
+            CommandQueue_Complete(queueP, requestP);
+            continue;
+        }
+
+        /* do not block on the submit mutex, a synchronous command holds it until it got a slot */
+        if((queueP->backlogHeadP != NULL) && (queueP->pending < queueP->depth) &&
+           (0 == pthread_mutex_trylock(&queueP->submitMutex)))
+        {
+            CommandQueue_SendBacklog(queueP);
+            pthread_mutex_unlock(&queueP->submitMutex);
+            continue;
+        }
+
+        /* sleep until a request was answered, queued or left the queue, or the next one is due */
+        if(haveNext)
+        {
+            pthread_cond_timedwait(&queueP->cond, &queueP->mutex, &next);
+        }
+        else
+        {
+            pthread_cond_wait(&queueP->cond, &queueP->mutex);
+        }
+    }
+    pthread_mutex_unlock(&queueP->mutex);
+    return NULL;
+}
+
+CommandQueue_Request_t *CommandQueue_NewRequest(uint8_t confirmation, const struct iovec *iov, int n, uint16_t responseSize, size_t contextSize)
+{
+    CommandQueue_Request_t *requestP;
+    size_t frameLength = 0;
+    uint8_t *dataP;
+    int i;
+
+    for(i = 0; i < n; i++)
+    {
+        frameLength += iov[i].iov_len;
+    }
+    if(frameLength > UINT16_MAX)
+    {
+        return NULL;
+    }
+
+    /* request, caller data, frame and answer in one block, freed by the dispatcher */
+    requestP = malloc(sizeof(CommandQueue_Request_t) + contextSize + frameLength + responseSize);
+    if(requestP == NULL)
+    {
+        return NULL;
+    }
+    dataP = (uint8_t*)(requestP + 1);
+
+    CommandQueue_InitRequest(requestP, confirmation, (responseSize > 0) ? &dataP[contextSize + frameLength] : NULL, responseSize);
+    requestP->contextP = (contextSize > 0) ? dataP : NULL;
+    requestP->frameP = &dataP[contextSize];
+    requestP->frameLength = (uint16_t)frameLength;
+    for(i = 0, frameLength = 0; i < n; i++)
+    {
+        if(iov[i].iov_len > 0)
+        {
+            memcpy(&requestP->frameP[frameLength], iov[i].iov_base, iov[i].iov_len);
+            frameLength += iov[i].iov_len;
+        }
+    }
+    return requestP;
+}
+
+bool CommandQueue_SubmitAsync(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, Transport_t *transportP, int max_time_ms, CommandQueue_Callback_t callback)
+{
+    requestP->transportP = transportP;
+    requestP->callback = callback;
+    requestP->done = false;
+    requestP->timeout_ms = max_time_ms;
+
+    pthread_mutex_lock(&queueP->mutex);
+    if(queueP->stop || !queueP->dispatcherRunning)
+    {
+        if(queueP->stop || (0 != pthread_create(&queueP->dispatcher, NULL, CommandQueue_Dispatch, queueP)))
+        {
+            pthread_mutex_unlock(&queueP->mutex);
+            free(requestP);
+            return false;
+        }
+        queueP->dispatcherRunning = true;
+    }
+    CommandQueue_Append(&queueP->backlogHeadP, &queueP->backlogTailP, requestP);
+
+    /* send at once if nothing is ahead of the request, the dispatcher sends it otherwise */
+    if((queueP->backlogHeadP == requestP) && (queueP->pending < queueP->depth) &&
+       (0 == pthread_mutex_trylock(&queueP->submitMutex)))
+    {
+        CommandQueue_SendBacklog(queueP);
+        pthread_mutex_unlock(&queueP->submitMutex);
+    }
+    else
+    {
+        pthread_cond_broadcast(&queueP->cond);
+    }
+    pthread_mutex_unlock(&queueP->mutex);
+    return true;
+}
+
+/* wake the executor thread, if it waits for jobs */
+static void CallbackExecutor_Wake(CallbackExecutor_t *executorP)
+{
+    /* pairs with the check of the ring after the executor set sleeping, one of both sees the other */
+    if(atomic_load(&executorP->sleeping))
+    {
+        pthread_mutex_lock(&executorP->mutex);
+        pthread_cond_signal(&executorP->cond);
+        pthread_mutex_unlock(&executorP->mutex);
+    }
+}
+
+/* run a job and give back its frame, or only give it back when the executor stops */
+static void CallbackExecutor_Run(CallbackExecutor_t *executorP, CallbackExecutor_Job_t *jobP)
+{
+    if(!atomic_load_explicit(&executorP->stop, memory_order_relaxed))
+    {
+        jobP->function(jobP->contextP, jobP->bufferP->data);
+    }
+    FrameBuffer_Release(jobP->bufferP);
+}
+
+/* run the jobs of the ring up to its tail */
+static void CallbackExecutor_RunRing(CallbackExecutor_t *executorP, unsigned int *headP)
+{
+    while(*headP != atomic_load_explicit(&executorP->tail, memory_order_acquire))
+    {
+        CallbackExecutor_Job_t job = executorP->ring[*headP & (CALLBACKEXECUTOR_RING_LENGTH - 1)];
+        atomic_store_explicit(&executorP->head, ++(*headP), memory_order_release);
+        CallbackExecutor_Run(executorP, &job);
+    }
+}
+
+/* thread function of an executor */
+static void *CallbackExecutor_Thread(void *argP)
+{
+    CallbackExecutor_t *executorP = argP;
+    CallbackExecutor_Job_t *overflowP;
+    unsigned int head = atomic_load_explicit(&executorP->head, memory_order_relaxed);
+
+    while(1)
+    {
+        /* the ring holds the jobs posted before the first job of the overflow list */
+        CallbackExecutor_RunRing(executorP, &head);
+
+        pthread_mutex_lock(&executorP->mutex);
+        overflowP = executorP->overflowHeadP;
+        if(overflowP != NULL)
+        {
+            /* jobs posted from now on go to a new overflow list, as long as overflowing is set */
+            executorP->overflowHeadP = NULL;
+            executorP->overflowTailP = NULL;
+            pthread_mutex_unlock(&executorP->mutex);
+
+            /* the ring may have been filled up since it was run above, its jobs
+             * are older than the list; it cannot grow while overflowing is set */
+            CallbackExecutor_RunRing(executorP, &head);
+            while(overflowP != NULL)
+            {
+                CallbackExecutor_Job_t *jobP = overflowP;
+                overflowP = jobP->nextP;
+                CallbackExecutor_Run(executorP, jobP);
+                free(jobP);
+            }
+            continue;
+        }
+        if(atomic_load(&executorP->overflowing))
+        {
+            /* all jobs of the overflow lists ran, jobs posted from now on go to the ring again */
+            atomic_store(&executorP->overflowing, false);
+            pthread_mutex_unlock(&executorP->mutex);
+            continue;
+        }
+
+        if(atomic_load(&executorP->stop))
+        {
+            pthread_mutex_unlock(&executorP->mutex);
+            break;
+        }
+
+        /* sleep until a job is posted, unless one was posted since the ring was checked */
+        atomic_store(&executorP->sleeping, true);
+        if(head == atomic_load(&executorP->tail))
+        {
+            pthread_cond_wait(&executorP->cond, &executorP->mutex);
+        }
+        atomic_store(&executorP->sleeping, false);
+        pthread_mutex_unlock(&executorP->mutex);
+    }
+    return NULL;
+}
+
+bool CallbackExecutor_Init(CallbackExecutor_t *executorP)
+{
+    atomic_init(&executorP->head, 0);
+    atomic_init(&executorP->tail, 0);
+    atomic_init(&executorP->overflowing, false);
+    atomic_init(&executorP->sleeping, false);
+    atomic_init(&executorP->stop, false);
+    executorP->overflowHeadP = NULL;
+    executorP->overflowTailP = NULL;
+    executorP->running = false;
+
+    if(0 != pthread_mutex_init(&executorP->mutex, NULL))
+    {
+        return false;
+    }
+    if(0 != pthread_cond_init(&executorP->cond, NULL))
+    {
+        pthread_mutex_destroy(&executorP->mutex);
+        return false;
+    }
+    if(0 != pthread_create(&executorP->thread, NULL, CallbackExecutor_Thread, executorP))
+    {
+        pthread_cond_destroy(&executorP->cond);
+        pthread_mutex_destroy(&executorP->mutex);
+        return false;
+    }
+    executorP->running = true;
+    return true;
+}
+
+void CallbackExecutor_Deinit(CallbackExecutor_t *executorP)
+{
+    if(!executorP->running)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&executorP->mutex);
+    atomic_store(&executorP->stop, true);
+    pthread_cond_signal(&executorP->cond);
+    pthread_mutex_unlock(&executorP->mutex);
+    pthread_join(executorP->thread, NULL);
+
+    pthread_cond_destroy(&executorP->cond);
+    pthread_mutex_destroy(&executorP->mutex);
+    executorP->running = false;
+}
+
+bool CallbackExecutor_Post(CallbackExecutor_t *executorP, CallbackExecutor_Function_t function, void *contextP, uint8_t *frameP)
+{
+    FrameBuffer_t *bufferP = FrameBuffer_Of(frameP);
+
+    FrameBuffer_Retain(bufferP);
+
+    /* the overflow list has to be empty, or the job would overtake its jobs */
+    if(!atomic_load_explicit(&executorP->overflowing, memory_order_acquire))
+    {
+        unsigned int tail = atomic_load_explicit(&executorP->tail, memory_order_relaxed);
+
+        if(tail - atomic_load_explicit(&executorP->head, memory_order_acquire) < CALLBACKEXECUTOR_RING_LENGTH)
+        {
+            CallbackExecutor_Job_t *jobP = &executorP->ring[tail & (CALLBACKEXECUTOR_RING_LENGTH - 1)];
+            jobP->function = function;
+            jobP->contextP = contextP;
+            jobP->bufferP = bufferP;
+            atomic_store(&executorP->tail, tail + 1);
+            CallbackExecutor_Wake(executorP);
+            return true;
+        }
+    }
+
+    /* the application is behind, keep the job in the overflow list */
+    CallbackExecutor_Job_t *jobP = malloc(sizeof(CallbackExecutor_Job_t));
+    if(jobP == NULL)
+    {
+        FrameBuffer_Release(bufferP);
+        return false;
+    }
+    jobP->function = function;
+    jobP->contextP = contextP;
+    jobP->bufferP = bufferP;
+    jobP->nextP = NULL;
+
+    pthread_mutex_lock(&executorP->mutex);
+    if(executorP->overflowTailP == NULL)
+    {
+        executorP->overflowHeadP = jobP;
+    }
+    else
+    {
+        executorP->overflowTailP->nextP = jobP;
+    }
+    executorP->overflowTailP = jobP;
+    atomic_store(&executorP->overflowing, true);
+    pthread_cond_signal(&executorP->cond);
+    pthread_mutex_unlock(&executorP->mutex);
+    return true;
+}
+
+bool Fragmenter_Init(Fragmenter_t *fragmenterP, Fragmenter_SendFunction_t send, void *sendContextP, uint16_t maxSegmentLength,
+                     uint32_t maxMessageLength, Fragmenter_MessageCallback_t messageCb, void *contextP)
+{
+    memset(fragmenterP, 0, sizeof(Fragmenter_t));
+    if((send == NULL) || (maxSegmentLength <= FRAGMENTER_FIRST_HEADER_LENGTH))
+    {
+        return false;
+    }
+    fragmenterP->segmentP = malloc(maxSegmentLength);
+    fragmenterP->messageP = malloc((maxMessageLength > 0) ? maxMessageLength : 1);
+    if((fragmenterP->segmentP == NULL) || (fragmenterP->messageP == NULL) ||
+       (pthread_mutex_init(&fragmenterP->sendMutex, NULL) != 0))
+    {
+        free(fragmenterP->segmentP);
+        free(fragmenterP->messageP);
+        fragmenterP->segmentP = NULL;
+        fragmenterP->messageP = NULL;
+        return false;
+    }
+    fragmenterP->send = send;
+    fragmenterP->sendContextP = sendContextP;
+    fragmenterP->messageCb = messageCb;
+    fragmenterP->contextP = contextP;
+    fragmenterP->maxSegmentLength = maxSegmentLength;
+    fragmenterP->segmentLength = maxSegmentLength;
+    fragmenterP->maxMessageLength = maxMessageLength;
+    return true;
+}
+
+void Fragmenter_Deinit(Fragmenter_t *fragmenterP)
+{
+    if(fragmenterP->segmentP == NULL)
+    {
+        return;
+    }
+    pthread_mutex_destroy(&fragmenterP->sendMutex);
+    free(fragmenterP->segmentP);
+    free(fragmenterP->messageP);
+    fragmenterP->segmentP = NULL;
+    fragmenterP->messageP = NULL;
+}
+
+bool Fragmenter_SetMaxPayload(Fragmenter_t *fragmenterP, uint16_t maxPayload)
+{
+    if(maxPayload <= FRAGMENTER_FIRST_HEADER_LENGTH)
+    {
+        return false;
+    }
+    pthread_mutex_lock(&fragmenterP->sendMutex);
+    fragmenterP->segmentLength = (maxPayload < fragmenterP->maxSegmentLength) ? maxPayload : fragmenterP->maxSegmentLength;
+    pthread_mutex_unlock(&fragmenterP->sendMutex);
+    return true;
+}
+
+bool Fragmenter_Send(Fragmenter_t *fragmenterP, const uint8_t *messageP, uint32_t length)
+{
+    uint8_t *segmentP = fragmenterP->segmentP;
+    uint32_t sent = 0;
+    uint16_t segment = 0;
+    bool ret = true;
+
+    pthread_mutex_lock(&fragmenterP->sendMutex);
+    do
+    {
+        uint16_t headerLength = (segment == 0) ? FRAGMENTER_FIRST_HEADER_LENGTH : FRAGMENTER_HEADER_LENGTH;
+        uint32_t dataLength = fragmenterP->segmentLength - headerLength;
+        if(dataLength > length - sent)
+        {
+            dataLength = length - sent;
+        }
+        if((segment == 0xFFFF) && (sent + dataLength < length))
+        {
+            /* the segment number would wrap */
+            ret = false;
+            break;
+        }
+
+        segmentP[0] = ((segment == 0) ? FRAGMENTER_FLAG_FIRST : 0) | ((sent + dataLength == length) ? FRAGMENTER_FLAG_LAST : 0);
+        segmentP[1] = fragmenterP->txMessage;
+        segmentP[2] = (uint8_t)(segment >> 0);
+        segmentP[3] = (uint8_t)(segment >> 8);
+        if(segment == 0)
+        {
+            segmentP[4] = (uint8_t)(length >> 0);
+            segmentP[5] = (uint8_t)(length >> 8);
+            segmentP[6] = (uint8_t)(length >> 16);
+            segmentP[7] = (uint8_t)(length >> 24);
+        }
+        memcpy(&segmentP[headerLength], &messageP[sent], dataLength);
+
+        if(!fragmenterP->send(fragmenterP->sendContextP, segmentP, (uint16_t)(headerLength + dataLength)))
+        {
+            ret = false;
+            break;
+        }
+        fragmenterP->statistics.segmentsSent++;
+        sent += dataLength;
+        segment++;
+    }
+    while(sent < length);
+
+    if(ret)
+    {
+        fragmenterP->statistics.messagesSent++;
+    }
+    fragmenterP->txMessage++;
+    pthread_mutex_unlock(&fragmenterP->sendMutex);
+    return ret;
+}
+
+void Fragmenter_Receive(Fragmenter_t *fragmenterP, const uint8_t *payloadP, uint16_t length)
+{
+    uint16_t headerLength = FRAGMENTER_HEADER_LENGTH;
+    uint16_t segment;
+    uint32_t dataLength;
+
+    if(length < FRAGMENTER_HEADER_LENGTH)
+    {
+        return;
+    }
+    segment = (uint16_t)(payloadP[2] | (payloadP[3] << 8));
+
+    if(payloadP[0] & FRAGMENTER_FLAG_FIRST)
+    {
+        if(length < FRAGMENTER_FIRST_HEADER_LENGTH)
+        {
+            return;
+        }
+        if(fragmenterP->rxActive)
+        {
+            /* the last segments of the previous message are missing */
+            fragmenterP->statistics.messagesDropped++;
+        }
+        headerLength = FRAGMENTER_FIRST_HEADER_LENGTH;
+        fragmenterP->rxLength = (uint32_t)payloadP[4] | ((uint32_t)payloadP[5] << 8) | ((uint32_t)payloadP[6] << 16) | ((uint32_t)payloadP[7] << 24);
+        fragmenterP->rxReceived = 0;
+        fragmenterP->rxSegment = 0;
+        fragmenterP->rxMessage = payloadP[1];
+        fragmenterP->rxActive = (segment == 0) && (fragmenterP->rxLength <= fragmenterP->maxMessageLength);
+        if(!fragmenterP->rxActive)
+        {
+            fragmenterP->statistics.messagesDropped++;
+            return;
+        }
+    }
+    else if(!fragmenterP->rxActive)
+    {
+        /* rest of a dropped message */
+        return;
+    }
+    else if((payloadP[1] != fragmenterP->rxMessage) || (segment != fragmenterP->rxSegment))
+    {
+        fragmenterP->rxActive = false;
+        fragmenterP->statistics.messagesDropped++;
+        return;
+    }
+
+    dataLength = length - headerLength;
+    if(dataLength > fragmenterP->rxLength - fragmenterP->rxReceived)
+    {
+        fragmenterP->rxActive = false;
+        fragmenterP->statistics.messagesDropped++;
+        return;
+    }
+    memcpy(&fragmenterP->messageP[fragmenterP->rxReceived], &payloadP[headerLength], dataLength);
+    fragmenterP->rxReceived += dataLength;
+    fragmenterP->rxSegment++;
+
+    if(payloadP[0] & FRAGMENTER_FLAG_LAST)
+    {
+        fragmenterP->rxActive = false;
+        if(fragmenterP->rxReceived != fragmenterP->rxLength)
+        {
+            fragmenterP->statistics.messagesDropped++;
+            return;
+        }
+        fragmenterP->statistics.messagesReceived++;
+        if(fragmenterP->messageCb != NULL)
+        {
+            fragmenterP->messageCb(fragmenterP->messageP, fragmenterP->rxLength, fragmenterP->contextP);
+        }
+    }
+}
+
+void Fragmenter_Reset(Fragmenter_t *fragmenterP)
+{
+    if(fragmenterP->rxActive)
+    {
+        fragmenterP->rxActive = false;
+        fragmenterP->statistics.messagesDropped++;
+    }
+}
+
+void Fragmenter_GetStatistics(Fragmenter_t *fragmenterP, Fragmenter_Statistics_t *statisticsP)
+{
+    *statisticsP = fragmenterP->statistics;
+}
 
 /*
  *Request the 3 byte driver version
@@ -25,7 +25,15 @@
 
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/uio.h>
+
+/* number of bytes the RX threads drain from the serial interface per ReadBytes call */
+#define SERIAL_RX_CHUNK_SIZE 256
 
 typedef enum SetPin_InputOutput_t {
     SetPin_InputOutput_Input   = (uint8_t) 0,
@@ -50,6 +58,49 @@ typedef enum Serial_ParityBit_t
     Serial_ParityBit_ODD,
 }Serial_ParityBit_t;
 
+typedef enum Serial_RxWait_t
+{
+    Serial_RxWait_Data = 0,     /* bytes are available in the serial interface */
+    Serial_RxWait_Event,        /* the event file descriptor was signalled */
+    Serial_RxWait_Timeout,      /* nothing happened within the timeout */
+    Serial_RxWait_Error,        /* the interface can not be waited on */
+}Serial_RxWait_t;
+
+/* events signalled to a driver RX thread, see RxThreadEvent_Signal */
+#define RXTHREAD_EVENT_RESET (uint64_t)((uint64_t)1 << 0)     /* drop the partially received frame */
+#define RXTHREAD_EVENT_ABORT (uint64_t)((uint64_t)1 << 32)    /* leave the RX thread */
+
+/*
+ * Communication interface to one module. A transport is created by a backend
+ * (SerialTransport_Create in global_serial.c, FTDITransport_Create in global_ftdi.c,
+ * PtyTransport_Create in global_pty.c)
+ * and used through the Transport_* functions, so several transports of
+ * different backends can be used in one process.
+ */
+typedef struct Transport_t Transport_t;
+
+typedef struct Transport_Ops_t
+{
+    bool (*open)(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit);
+    bool (*close)(Transport_t *transportP);
+    bool (*flush)(Transport_t *transportP);
+    bool (*sendBytes)(Transport_t *transportP, uint8_t *dataP, uint16_t length);
+    bool (*sendFrame)(Transport_t *transportP, const struct iovec *iov, int n);
+    bool (*readBytes)(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms);
+    Serial_RxWait_t (*waitForRxData)(Transport_t *transportP, int eventFd, int timeout_ms);
+    int (*getFd)(Transport_t *transportP);
+    bool (*initPin)(Transport_t *transportP, int pin_number);
+    bool (*deinitPin)(Transport_t *transportP, int pin_number);
+    bool (*setPin)(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out);
+    void (*destroy)(Transport_t *transportP);
+} Transport_Ops_t;
+
+struct Transport_t
+{
+    const Transport_Ops_t *ops;
+    void *contextP;             /* backend specific state */
+};
+
 /*
  *Request the 3 byte driver version
  *
@@ -105,6 +156,72 @@ extern void delay(unsigned int sleepFor);
  */
 extern int setThreadPrio(const int prio);
 
+/*
+ * Initialize a condition variable whose timed waits use CLOCK_MONOTONIC
+ *
+ * input:
+ * - condP: condition variable, must not be waited on while initializing
+ *
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool InitMonotonicCond(pthread_cond_t *condP);
+
+/*
+ * Get the CLOCK_MONOTONIC deadline for pthread_cond_timedwait on a condition
+ * variable initialized by InitMonotonicCond
+ *
+ * input:
+ * - timeout_ms: time from now in ms
+ * output:
+ * - deadlineP: absolute time
+ *
+ */
+extern void GetDeadline(struct timespec *deadlineP, int timeout_ms);
+
+/*
+ * Create the eventfd used to signal a driver RX thread
+ *
+ * return: file descriptor, if success
+ *         -1, otherwise
+ *
+ */
+extern int RxThreadEvent_Create();
+
+/*
+ * Close an eventfd created by RxThreadEvent_Create
+ *
+ * input:
+ * - eventFd: file descriptor of the event
+ *
+ */
+extern void RxThreadEvent_Destroy(int eventFd);
+
+/*
+ * Signal an event to the RX thread waiting on eventFd
+ *
+ * input:
+ * - eventFd: file descriptor of the event
+ * - event: RXTHREAD_EVENT_RESET or RXTHREAD_EVENT_ABORT
+ *
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool RxThreadEvent_Signal(int eventFd, uint64_t event);
+
+/*
+ * Consume the events signalled since the last call
+ *
+ * input:
+ * - eventFd: file descriptor of the event
+ *
+ * return: bit mask of RXTHREAD_EVENT_RESET and RXTHREAD_EVENT_ABORT
+ *
+ */
+extern uint64_t RxThreadEvent_Read(int eventFd);
+
 /*
  * Initialize a pin
  *
@@ -147,6 +264,18 @@ extern bool InitSerial();
  */
 extern bool DeinitSerial();
 
+/*
+ * Select the device opened by the next OpenSerial call
+ *
+ * input:
+ * - device: device path of the serial interface (e.g. "/dev/ttyUSB0"),
+ *           or the device index for FTDI interfaces (e.g. "1")
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool SetSerialDevice(const char *device);
+
 /*
  * Open the serial interface
  *
@@ -208,6 +337,45 @@ extern bool ReadByte(uint8_t *readBufferP);
  */
 extern bool BytesAvailable();
 
+/*
+ * Read all bytes currently available in the serial interface with one call
+ *
+ * input:
+ * - max: size of the buffer
+ * - timeout_ms: time to wait for the first byte in ms,
+ *               0 returns immediately, -1 waits without limit
+ * output:
+ * - buf: pointer to the buffer
+ * - got: number of bytes written to the buffer, 0 if none arrived in time
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool ReadBytes(uint8_t *buf, size_t max, size_t *got, int timeout_ms);
+
+/*
+ * Get the file descriptor of the serial interface, e.g. to add it to an own poll set
+ *
+ * return: file descriptor, if the interface is open and has one
+ *         -1, otherwise
+ *
+ */
+extern int GetSerialFd();
+
+/*
+ * Block until bytes are available in the serial interface or eventFd is signalled
+ *
+ * input:
+ * - eventFd: eventfd to wake up the caller, -1 if not used
+ * - timeout_ms: maximum time to wait in ms, -1 waits without limit
+ * return: Serial_RxWait_Event, if eventFd was signalled (checked first)
+ *         Serial_RxWait_Data, if bytes are available
+ *         Serial_RxWait_Timeout, if the timeout expired
+ *         Serial_RxWait_Error, otherwise
+ *
+ */
+extern Serial_RxWait_t WaitForRxData(int eventFd, int timeout_ms);
+
 /*
  * Send bytes via serial interface
  *
@@ -220,3 +388,827 @@ extern bool BytesAvailable();
  */
 extern bool SendBytes(uint8_t* dataP, uint16_t length);
 
+/*
+ * Send a frame given in several parts (e.g. header, payload and checksum)
+ * via serial interface with a single write, without copying the parts
+ * into one buffer first
+ *
+ * input:
+ * - iov: parts of the frame, sent in the given order
+ * - n: number of parts
+ * return: true, if the whole frame was sent
+ *         false, otherwise
+ *
+ */
+extern bool SendFrame(const struct iovec *iov, int n);
+
+/*
+ * The functions above use the default transport of the backend linked into
+ * the program. Programs linking more than one backend define
+ * GLOBAL_NO_DEFAULT_TRANSPORT and only use the Transport_* functions below.
+ *
+ * return: default transport of the backend
+ *
+ */
+extern Transport_t *GetDefaultTransport();
+
+/*
+ * Create a transport on a serial device (global_serial.c)
+ *
+ * input:
+ * - device: device path, e.g. "/dev/serial0"
+ *
+ * return: transport, if success
+ *         NULL, otherwise
+ *
+ */
+extern Transport_t *SerialTransport_Create(const char *device);
+
+/*
+ * Create a transport on a FTDI device (global_ftdi.c)
+ *
+ * input:
+ * - index: device index of the D2XX library
+ *
+ * return: transport, if success
+ *         NULL, otherwise
+ *
+ */
+extern Transport_t *FTDITransport_Create(int index);
+
+/*
+ * Pin access recorded by the pty backend (global_pty.c) instead of driving a pin
+ */
+typedef struct PtyTransport_PinEvent_t
+{
+    struct timespec time;       /* CLOCK_MONOTONIC */
+    int pin_number;
+    SetPin_InputOutput_t inout;
+    SetPin_Pull_t pull;
+    SetPin_Out_t out;
+} PtyTransport_PinEvent_t;
+
+typedef void (*PtyTransport_PinCallback_t)(Transport_t *transportP, const PtyTransport_PinEvent_t *eventP, void *contextP);
+
+/*
+ * Create a transport on a pseudo terminal (global_pty.c), to run drivers
+ * against a software peer instead of a module
+ *
+ * The driver uses the master side of a new pty pair, the peer opens the
+ * slave side returned by PtyTransport_GetPeerName. The pair lives as long
+ * as the transport, so the peer may stay attached while the driver closes
+ * and reopens the interface.
+ *
+ * input:
+ * - device: NULL to create a pty pair, or the slave side of a pty created
+ *           by the peer (e.g. a simulator) to attach to
+ *
+ * return: transport, if success
+ *         NULL, otherwise
+ *
+ */
+extern Transport_t *PtyTransport_Create(const char *device);
+
+/*
+ * Get the device the peer has to open
+ *
+ * return: slave side of the pty pair created by the transport,
+ *         NULL, if the transport attached to a device given by the peer
+ *
+ */
+extern const char *PtyTransport_GetPeerName(Transport_t *transportP);
+
+/*
+ * Register a function called for every SetPin on the transport,
+ * e.g. to let a simulated module react on its reset pin
+ *
+ * input:
+ * - callback: function called in the context of the SetPin caller, NULL to remove
+ * - contextP: passed to the callback
+ *
+ */
+extern void PtyTransport_SetPinCallback(Transport_t *transportP, PtyTransport_PinCallback_t callback, void *contextP);
+
+/*
+ * Write every SetPin on the transport as text line
+ * "pin <number> <in|out> <no|up|down> <low|high>" to a file descriptor,
+ * e.g. a FIFO read by a simulator running as separate process
+ *
+ * input:
+ * - fd: file descriptor, -1 to stop writing
+ *
+ */
+extern void PtyTransport_SetPinEventFd(Transport_t *transportP, int fd);
+
+/*
+ * Copy the pin events recorded last
+ *
+ * input:
+ * - eventsP: buffer for the events, oldest first
+ * - max: size of the buffer in events
+ *
+ * return: number of events copied
+ *
+ */
+extern size_t PtyTransport_GetPinEvents(Transport_t *transportP, PtyTransport_PinEvent_t *eventsP, size_t max);
+
+/*
+ * Free a transport created by SerialTransport_Create or FTDITransport_Create,
+ * the transport is closed if it is still open
+ *
+ * input:
+ * - transportP: transport
+ *
+ */
+extern void Transport_Destroy(Transport_t *transportP);
+
+/*
+ * The following functions behave like their counterparts without the
+ * Transport_ prefix, but act on the given transport
+ * (Transport_Open: InitSerial + OpenSerialWithParity, Transport_Close: CloseSerial + DeinitSerial)
+ */
+extern bool Transport_Open(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit);
+extern bool Transport_Close(Transport_t *transportP);
+extern bool Transport_Flush(Transport_t *transportP);
+extern bool Transport_SendBytes(Transport_t *transportP, uint8_t *dataP, uint16_t length);
+extern bool Transport_SendFrame(Transport_t *transportP, const struct iovec *iov, int n);
+extern bool Transport_ReadBytes(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms);
+extern Serial_RxWait_t Transport_WaitForRxData(Transport_t *transportP, int eventFd, int timeout_ms);
+extern int Transport_GetFd(Transport_t *transportP);
+extern bool Transport_InitPin(Transport_t *transportP, int pin_number);
+extern bool Transport_DeinitPin(Transport_t *transportP, int pin_number);
+extern bool Transport_SetPin(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out);
+
+/*
+ * Pool of fixed size frame buffers with reference counts
+ *
+ * The RX thread of a driver receives frames directly into buffers of a pool.
+ * A callback that wants to keep a frame after it returned takes a reference
+ * with FrameBuffer_Retain instead of copying the frame, and gives it back with
+ * FrameBuffer_Release. When all buffers of the pool are referenced, further
+ * buffers are taken from the heap up to a bound and freed on release, so the
+ * RX thread never waits for the application; beyond the bound FramePool_Get
+ * fails. Taking and giving back buffers is lock-free.
+ */
+typedef struct FramePool_t FramePool_t;
+
+typedef struct FrameBuffer_t
+{
+    FramePool_t *poolP;
+    atomic_uint nextIndex;                                  /* index + 1 of the next free buffer of the pool, 0 for none */
+    atomic_uint references;
+    bool allocated;                                         /* taken from the heap, not from the pool */
+    uint8_t data[];                                         /* the frame */
+} FrameBuffer_t;
+
+/*
+ * Create a pool of frame buffers
+ *
+ * input:
+ * - count: number of buffers allocated at once, i.e. frames held by the application without allocations
+ * - maxAllocated: number of further buffers taken from the heap while all buffers of the pool are held
+ * - bufferSize: size of each buffer, i.e. the maximum frame length
+ *
+ * return: the pool, NULL if out of memory
+ *
+ */
+extern FramePool_t *FramePool_Create(uint16_t count, uint32_t maxAllocated, uint16_t bufferSize);
+
+/*
+ * Destroy a pool, buffers still referenced stay valid until they are released
+ */
+extern void FramePool_Destroy(FramePool_t *poolP);
+
+/*
+ * Take an unused buffer of the pool
+ *
+ * return: buffer with one reference, NULL if the pool and its heap bound are exhausted or out of memory
+ *
+ */
+extern FrameBuffer_t *FramePool_Get(FramePool_t *poolP);
+
+/*
+ * Buffer holding the frame at dataP, dataP has to be the start of the data of a FrameBuffer_t
+ */
+extern FrameBuffer_t *FrameBuffer_Of(uint8_t *dataP);
+
+/*
+ * Take and give back a reference to a buffer, the buffer returns to its pool with the last reference
+ */
+extern void FrameBuffer_Retain(FrameBuffer_t *bufferP);
+extern void FrameBuffer_Release(FrameBuffer_t *bufferP);
+
+/*
+ * Codec of the command frames exchanged with the modules:
+ * STX, CMD, LEN, DATA, CS
+ * LEN is the length of DATA, either one byte or two bytes LSB first,
+ * CS is the XOR of all preceding bytes of the frame.
+ *
+ * A driver describes its protocol by a FrameCodec_Protocol_t and feeds the
+ * received bytes to FrameCodec_Parse (or lets FrameCodec_RxLoop read them),
+ * every frame with a valid checksum is passed to handleFrame.
+ */
+#define FRAMECODEC_POSITION_STX     0
+#define FRAMECODEC_POSITION_CMD     1
+#define FRAMECODEC_POSITION_LENGTH  2
+
+typedef struct FrameCodec_Protocol_t
+{
+    uint8_t stx;                                            /* start byte of a frame */
+    uint8_t lengthBytes;                                    /* size of the LEN field, 1 or 2 */
+    void (*handleFrame)(void *contextP, uint8_t *frameP);   /* called from the RX thread for each valid frame */
+} FrameCodec_Protocol_t;
+
+typedef struct FrameCodec_t
+{
+    const FrameCodec_Protocol_t *protocolP;
+    void *contextP;                                         /* passed to handleFrame, e.g. the driver instance */
+    FramePool_t *poolP;                                     /* pool of bufferP, see FrameCodec_InitPool */
+    FrameBuffer_t *frameBufferP;                            /* buffer of the pool holding bufferP */
+    uint8_t *bufferP;                                       /* frame being received */
+    uint16_t bufferSize;                                    /* frames not fitting into bufferP are dropped */
+    uint16_t received;                                      /* bytes of the current frame in bufferP */
+    uint16_t frameLength;                                   /* length of the current frame, once LEN is received */
+    uint8_t checksum;                                       /* XOR of the bytes of the current frame received so far */
+} FrameCodec_t;
+
+typedef struct FrameCodec_Statistics_t
+{
+    uint32_t checksumErrors;                                /* frames rejected for their checksum */
+    uint32_t lengthErrors;                                  /* frames rejected for a length field exceeding the buffer */
+    uint32_t recoveredFrames;                               /* valid frames found among the bytes of rejected frames */
+    uint32_t discardedBytes;                                /* bytes of rejected frames not belonging to a recovered frame */
+} FrameCodec_Statistics_t;
+
+/*
+ * Set up the receive state of a codec
+ *
+ * input:
+ * - protocolP: description of the protocol, not copied
+ * - bufferP: buffer holding the frame being received
+ * - bufferSize: size of bufferP, i.e. the maximum frame length
+ * - contextP: argument of handleFrame
+ *
+ */
+extern void FrameCodec_Init(FrameCodec_t *codecP, const FrameCodec_Protocol_t *protocolP, uint8_t *bufferP, uint16_t bufferSize, void *contextP);
+
+/*
+ * Set up the receive state of a codec receiving into the buffers of a pool
+ *
+ * Frames are passed to handleFrame in a FrameBuffer_t of the pool, see
+ * FrameBuffer_Of. A buffer retained by handleFrame is not written anymore,
+ * the codec continues with the next buffer of the pool.
+ *
+ * input:
+ * - protocolP: description of the protocol, not copied
+ * - poolP: pool of buffers, its buffer size is the maximum frame length
+ * - contextP: argument of handleFrame
+ *
+ * return: true, if success
+ *         false, if out of memory
+ *
+ */
+extern bool FrameCodec_InitPool(FrameCodec_t *codecP, const FrameCodec_Protocol_t *protocolP, FramePool_t *poolP, void *contextP);
+
+/*
+ * Release the buffer of a codec set up by FrameCodec_InitPool
+ */
+extern void FrameCodec_Deinit(FrameCodec_t *codecP);
+
+/*
+ * Drop the partially received frame and wait for the next start byte
+ */
+extern void FrameCodec_Reset(FrameCodec_t *codecP);
+
+/*
+ * Feed received bytes to the codec
+ *
+ * The start byte is searched in bulk and the data field is copied in bulk,
+ * frames are not bound to the chunks of the reads. The checksum is updated
+ * with every chunk, so a frame is validated as soon as its last byte arrives.
+ *
+ * When a frame is rejected, the bytes following its start byte are searched
+ * for the next start byte and parsed again from the buffer, as the rejected
+ * start byte may have been a data byte of a frame received in the meantime.
+ *
+ * input:
+ * - dataP: received bytes
+ * - length: number of received bytes
+ *
+ */
+extern void FrameCodec_Parse(FrameCodec_t *codecP, const uint8_t *dataP, size_t length);
+
+/*
+ * Read the error and recovery counters of all codecs of the process
+ *
+ * output:
+ * - statisticsP: counters since the start of the process
+ *
+ */
+extern void FrameCodec_GetStatistics(FrameCodec_Statistics_t *statisticsP);
+
+/*
+ * Body of a driver RX thread: wait for data on the transport, feed it to the
+ * codec and handle the events signalled by RxThreadEvent_Signal
+ *
+ * input:
+ * - transportP: transport to read from, GetDefaultTransport() for the drivers without instances
+ * - eventFd: event of the RX thread, see RxThreadEvent_Create
+ *
+ * return when RXTHREAD_EVENT_ABORT was signalled
+ *
+ */
+extern void FrameCodec_RxLoop(FrameCodec_t *codecP, Transport_t *transportP, int eventFd);
+
+/*
+ * XOR checksum of a frame
+ *
+ * The bytes are combined 64 bit wide, so the checksum of large frames
+ * costs about one operation per eight bytes.
+ *
+ * input:
+ * - checksum: checksum of the preceding bytes, 0 at the start of a frame
+ * - dataP: bytes to add
+ * - length: number of bytes
+ *
+ * return: checksum including dataP
+ *
+ */
+extern uint8_t FrameCodec_Checksum(uint8_t checksum, const uint8_t *dataP, size_t length);
+
+/*
+ * Write the CS of a frame whose STX, CMD, LEN and DATA are filled
+ *
+ * input:
+ * - protocolP: protocol of the frame
+ * - frameP: frame
+ * - length: size of the buffer holding the frame
+ *
+ * return: true, if success
+ *         false, if the buffer does not hold a frame of the protocol
+ *
+ */
+extern bool FrameCodec_FillChecksum(const FrameCodec_Protocol_t *protocolP, uint8_t *frameP, uint16_t length);
+
+/*
+ * Requests of a driver instance waiting for the frames answering them (*_CNF, *_RSP)
+ *
+ * A command registers its request and sends the request frame in one step by
+ * CommandQueue_Submit, so the queue holds the requests in the order the module
+ * receives them. The RX thread passes every answer to CommandQueue_Confirm,
+ * which completes the oldest request expecting this CMD and copies the answer
+ * into the buffer of that request. Answers of the same CMD are thus matched in
+ * request order, answers of remote devices can further be matched by a key in
+ * the frame, e.g. the address of the device.
+ *
+ * Up to 'depth' requests are in flight at once, further commands wait in
+ * CommandQueue_Submit for a free slot. A depth of 1 is the strict request/
+ * confirmation handshake, larger depths pipeline the requests where the
+ * module accepts a request before the previous one was confirmed.
+ *
+ * Asynchronous requests (CommandQueue_NewRequest, CommandQueue_SubmitAsync)
+ * carry a copy of their frame and return to the caller at once. If no slot is
+ * free, they wait in a backlog and are sent by the dispatcher thread of the
+ * queue. The dispatcher also calls their callback when they were answered or
+ * timed out, so that neither the caller nor the RX thread is blocked.
+ *
+ * Once the line rate is known (CommandQueue_SetLineRate), the time for an
+ * answer adapts to the module: the queue measures the round trip time of every
+ * answered request per confirmation CMD, without the time the request and the
+ * answer need on the line, and keeps a smoothed mean and mean deviation of it
+ * as TCP does for its retransmission timeout. A request then fails after the
+ * time both frames need on the line plus mean + 4 * deviation, but not before
+ * COMMANDQUEUE_MIN_TIMEOUT_MS, and the timeout passed by the driver is only the
+ * upper bound used until the first answer was measured. A module that does not
+ * answer is detected much faster, while a long frame at a low baud rate gets the
+ * time it needs on the line on top. Every timeout doubles the time of its CMD
+ * until the next answer was measured.
+ */
+#define COMMANDQUEUE_MAX_KEY_LENGTH 8
+#define COMMANDQUEUE_MIN_TIMEOUT_MS 100     /* lower bound of adaptive timeouts */
+#define COMMANDQUEUE_BITS_PER_BYTE 11       /* start bit, 8 data bits, parity and stop bit, on the safe side */
+
+struct CommandQueue_Request_t;
+
+/*
+ * Completion of an asynchronous request, called by the dispatcher thread of the queue
+ *
+ * input:
+ * - requestP: request, freed when the callback returns
+ * - answered: true if the answer was received, see status and responseP of the request,
+ *             false if the request timed out, could not be sent or the queue was deinitialized
+ */
+typedef void (*CommandQueue_Callback_t)(struct CommandQueue_Request_t *requestP, bool answered);
+
+typedef struct CommandQueue_Request_t
+{
+    uint8_t confirmation;                                   /* CMD of the frame answering the request */
+    uint8_t keyLength;                                      /* 0 to match by CMD only */
+    uint16_t keyOffset;                                     /* position of the key in the answer */
+    uint8_t key[COMMANDQUEUE_MAX_KEY_LENGTH];               /* bytes the answer has to hold at keyOffset */
+    uint8_t *responseP;                                     /* receives a copy of the answer, NULL if not needed */
+    uint16_t responseSize;                                  /* size of responseP */
+    uint16_t responseLength;                                /* length of the answer */
+    uint8_t status;                                         /* status of the answer, as passed to CommandQueue_Confirm */
+    bool done;                                              /* the answer was received */
+    bool fixedTimeout;                                      /* the timeout does not adapt, see CommandQueue_SetFixedTimeout */
+    bool sending;                                           /* asynchronous requests: the frame is being written, it is not freed meanwhile */
+    CommandQueue_Callback_t callback;                       /* asynchronous requests only, NULL otherwise */
+    void *contextP;                                         /* data of the caller of an asynchronous request */
+    Transport_t *transportP;                                /* asynchronous requests: transport to send the frame on */
+    uint8_t *frameP;                                        /* asynchronous requests: copy of the frame */
+    uint16_t frameLength;
+    int timeout_ms;                                         /* asynchronous requests: time for the answer once the frame was sent */
+    struct timespec deadline;                               /* asynchronous requests: CLOCK_MONOTONIC time the answer is due */
+    struct timespec sent;                                   /* CLOCK_MONOTONIC time the frame was sent */
+    struct CommandQueue_Request_t *nextP;
+} CommandQueue_Request_t;
+
+/* round trip time of the requests answered by one CMD */
+typedef struct CommandQueue_Rtt_t
+{
+    uint32_t srtt_us;                                       /* smoothed round trip time */
+    uint32_t rttvar_us;                                     /* smoothed mean deviation of the round trip time */
+    uint32_t rto_us;                                        /* time to wait for the answer on top of the line time */
+    uint16_t answerLength;                                  /* longest answer seen */
+    bool valid;                                             /* a round trip time was measured */
+} CommandQueue_Rtt_t;
+
+typedef struct CommandQueue_t
+{
+    pthread_mutex_t mutex;                                  /* protects the queue */
+    pthread_cond_t cond;                                    /* signalled when a request was answered or left the queue */
+    pthread_mutex_t submitMutex;                            /* keeps the order of the queue and of the frames sent the same */
+    CommandQueue_Request_t *headP;                          /* oldest request */
+    CommandQueue_Request_t *tailP;                          /* newest request */
+    uint16_t pending;                                       /* requests in the queue */
+    uint16_t depth;                                         /* maximum number of pending requests */
+    CommandQueue_Request_t *backlogHeadP;                   /* asynchronous requests waiting for a free slot */
+    CommandQueue_Request_t *backlogTailP;
+    CommandQueue_Request_t *completedHeadP;                 /* asynchronous requests whose callback is due */
+    CommandQueue_Request_t *completedTailP;
+    pthread_t dispatcher;                                   /* sends the backlog, times out and completes asynchronous requests */
+    bool dispatcherRunning;
+    bool stop;                                              /* the dispatcher fails the asynchronous requests and ends */
+    uint32_t baudrate;                                      /* line rate, 0 if the timeouts do not adapt */
+    CommandQueue_Rtt_t rtt[256];                            /* per confirmation CMD */
+} CommandQueue_t;
+
+/*
+ * Set up an empty queue
+ *
+ * input:
+ * - depth: maximum number of requests in flight, at least 1
+ *
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool CommandQueue_Init(CommandQueue_t *queueP, uint16_t depth);
+
+/*
+ * Free the resources of a queue, no synchronous request may be pending
+ *
+ * The callbacks of asynchronous requests still pending are called with answered = false.
+ */
+extern void CommandQueue_Deinit(CommandQueue_t *queueP);
+
+/*
+ * Change the maximum number of requests in flight, pending requests are kept
+ */
+extern void CommandQueue_SetDepth(CommandQueue_t *queueP, uint16_t depth);
+
+/*
+ * Let the timeouts adapt to the measured round trip times, see above
+ *
+ * input:
+ * - baudrate: line rate the frames are sent with, 0 to always wait the time passed by the driver
+ *
+ * The measurements are dropped, as they depend on the line rate.
+ */
+extern void CommandQueue_SetLineRate(CommandQueue_t *queueP, uint32_t baudrate);
+
+/*
+ * Number of requests in flight, i.e. sent and waiting for their answer
+ */
+extern uint16_t CommandQueue_Pending(CommandQueue_t *queueP);
+
+/*
+ * Prepare a request before it is submitted
+ *
+ * input:
+ * - confirmation: CMD of the frame answering the request
+ * - responseP: buffer receiving a copy of the answer, NULL if not needed
+ * - responseSize: size of responseP
+ *
+ */
+extern void CommandQueue_InitRequest(CommandQueue_Request_t *requestP, uint8_t confirmation, uint8_t *responseP, uint16_t responseSize);
+
+/*
+ * Match the answer of a request additionally by bytes of the frame
+ *
+ * input:
+ * - offset: position of the key in the answer
+ * - keyP: key
+ * - length: length of the key, up to COMMANDQUEUE_MAX_KEY_LENGTH
+ *
+ * return: true, if success
+ *         false, if the key is too long
+ *
+ */
+extern bool CommandQueue_SetKey(CommandQueue_Request_t *requestP, uint16_t offset, const uint8_t *keyP, uint8_t length);
+
+/*
+ * Always wait the time passed by the driver for the answer of a request, and do not measure it
+ *
+ * For answers whose time does not depend on the module alone, e.g. those
+ * sent after a radio transmission or after a reset. Requests without a
+ * frame, e.g. for the answer to a reset pin, always wait the time passed.
+ */
+extern void CommandQueue_SetFixedTimeout(CommandQueue_Request_t *requestP);
+
+/*
+ * Queue a request and send its frame
+ *
+ * Waits until less than 'depth' requests are in flight. The request stays in
+ * the queue until it was answered or CommandQueue_Wait or CommandQueue_Cancel
+ * removed it, so it has to stay valid until then.
+ *
+ * input:
+ * - transportP: transport to send the frame on
+ * - iov: parts of the frame, see Transport_SendFrame
+ * - n: number of parts, 0 to only queue the request, e.g. for the answer to a reset pin
+ * - max_time_ms: time to wait for a free slot
+ *
+ * return: true, if the request was queued and sent
+ *         false, if no slot got free in time or sending failed, the request is not queued then
+ *
+ */
+extern bool CommandQueue_Submit(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, Transport_t *transportP, const struct iovec *iov, int n, int max_time_ms);
+
+/*
+ * Queue a request and a second request for a frame the module sends after the
+ * answer on its own, e.g. the RESET_IND following the confirmation of a factory
+ * reset, and send the frame of the first request
+ *
+ * Both requests are queued before the frame is sent, so the second frame finds
+ * its request even if it directly follows the answer. They take one slot, i.e.
+ * no further request is sent until both left the queue. Wait for each of them
+ * with CommandQueue_Wait, or remove them with CommandQueue_Cancel.
+ *
+ * input:
+ * - followP: request for the frame following the answer to requestP
+ * - see CommandQueue_Submit for the others
+ *
+ * return: true, if both requests were queued and the frame was sent
+ *         false, if no slot got free in time or sending failed, no request is queued then
+ *
+ */
+extern bool CommandQueue_SubmitFollowUp(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, CommandQueue_Request_t *followP,
+                                        Transport_t *transportP, const struct iovec *iov, int n, int max_time_ms);
+
+/*
+ * Wait for the answer of a submitted request, the request leaves the queue in any case
+ *
+ * input:
+ * - max_time_ms: time to wait for the answer, the upper bound if the timeouts adapt
+ *
+ * return: true, if the answer was received, see the status and responseP of the request
+ *         false, if the request timed out
+ *
+ */
+extern bool CommandQueue_Wait(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, int max_time_ms);
+
+/*
+ * Remove a submitted request from the queue without waiting for its answer
+ */
+extern void CommandQueue_Cancel(CommandQueue_t *queueP, CommandQueue_Request_t *requestP);
+
+/*
+ * Complete the oldest request waiting for a frame, called from the RX thread
+ *
+ * input:
+ * - cmd: CMD of the frame
+ * - status: status of the answer, stored in the request
+ * - frameP: frame, copied into the buffer of the request
+ * - length: length of the frame
+ *
+ * return: true, if a request was waiting for the frame
+ *         false, otherwise
+ *
+ */
+extern bool CommandQueue_Confirm(CommandQueue_t *queueP, uint8_t cmd, uint8_t status, const uint8_t *frameP, uint16_t length);
+
+/*
+ * Allocate an asynchronous request holding a copy of its frame
+ *
+ * input:
+ * - confirmation: CMD of the frame answering the request
+ * - iov: parts of the frame, copied
+ * - n: number of parts
+ * - responseSize: size of the buffer for the answer, 0 if not needed
+ * - contextSize: size of the caller data at contextP of the request, 0 if not needed
+ *
+ * return: request to pass to CommandQueue_SubmitAsync, or free() if it is not submitted
+ *         NULL, if no memory was available
+ *
+ */
+extern CommandQueue_Request_t *CommandQueue_NewRequest(uint8_t confirmation, const struct iovec *iov, int n, uint16_t responseSize, size_t contextSize);
+
+/*
+ * Queue an asynchronous request and send its frame as soon as a slot is free, without waiting
+ *
+ * input:
+ * - requestP: request of CommandQueue_NewRequest, owned by the queue from now on
+ * - transportP: transport to send the frame on
+ * - max_time_ms: time for the answer, counted from sending the frame, the upper bound if the timeouts adapt
+ * - callback: called by the dispatcher thread when the request is completed
+ *
+ * return: true, if the request was queued, the callback will be called exactly once
+ *         false, if the dispatcher could not be started, the request is freed then
+ *
+ */
+extern bool CommandQueue_SubmitAsync(CommandQueue_t *queueP, CommandQueue_Request_t *requestP, Transport_t *transportP, int max_time_ms, CommandQueue_Callback_t callback);
+
+/*
+ * Executor running the callbacks of a driver instance on a thread of its own
+ *
+ * The RX thread posts a job for each indication and continues parsing at once,
+ * so a callback may send commands and wait for their confirmation, which the
+ * RX thread receives meanwhile, and a slow callback does not stall the UART.
+ * The jobs are passed in a lock-free ring with a single producer, the RX
+ * thread, and a single consumer, the executor thread. When the ring is full,
+ * jobs are appended to an overflow list instead, so the RX thread never waits
+ * for the application; the jobs are run in the order they were posted.
+ */
+#define CALLBACKEXECUTOR_RING_LENGTH 64                     /* power of two */
+
+typedef void (*CallbackExecutor_Function_t)(void *contextP, uint8_t *frameP);
+
+typedef struct CallbackExecutor_Job_t
+{
+    CallbackExecutor_Function_t function;
+    void *contextP;
+    struct FrameBuffer_t *bufferP;                          /* frame passed to function, referenced until it returned */
+    struct CallbackExecutor_Job_t *nextP;                   /* overflow list only */
+} CallbackExecutor_Job_t;
+
+typedef struct CallbackExecutor_t
+{
+    CallbackExecutor_Job_t ring[CALLBACKEXECUTOR_RING_LENGTH];
+    atomic_uint head;                                       /* next job to run, written by the executor thread only */
+    atomic_uint tail;                                       /* next free slot, written by the producer only */
+    atomic_bool overflowing;                                /* new jobs go to the overflow list until the executor ran all of it */
+    atomic_bool sleeping;                                   /* the executor thread waits for cond */
+    atomic_bool stop;                                       /* the executor thread drops the remaining jobs and ends */
+    pthread_mutex_t mutex;                                  /* protects the overflow list, held while signalling cond */
+    pthread_cond_t cond;
+    CallbackExecutor_Job_t *overflowHeadP;
+    CallbackExecutor_Job_t *overflowTailP;
+    pthread_t thread;
+    bool running;
+} CallbackExecutor_t;
+
+/*
+ * Start the thread of an executor
+ *
+ * return: true, if success
+ *         false, otherwise
+ *
+ */
+extern bool CallbackExecutor_Init(CallbackExecutor_t *executorP);
+
+/*
+ * Stop the thread of an executor, after the job being run returned
+ *
+ * Jobs not run yet are dropped. The producer must not post anymore, and it must
+ * not be called from a job. Calling it for an executor whose Init failed or that
+ * was zeroed is allowed.
+ */
+extern void CallbackExecutor_Deinit(CallbackExecutor_t *executorP);
+
+/*
+ * Queue a job, called by the producer only
+ *
+ * input:
+ * - function: called by the executor thread with contextP and frameP
+ * - frameP: start of the data of a FrameBuffer_t, see FrameBuffer_Of,
+ *           a reference is taken until the job was run
+ *
+ * return: true, if the job was queued
+ *         false, if no memory was available for the overflow list
+ *
+ */
+extern bool CallbackExecutor_Post(CallbackExecutor_t *executorP, CallbackExecutor_Function_t function, void *contextP, uint8_t *frameP);
+
+/*
+ * Fragmentation of large messages into the data packets of a radio link,
+ * e.g. the SPP channel of ProteusII and ProteusIII, and their reassembly
+ *
+ * Each segment starts with a header: flags (FRAGMENTER_FLAG_*), message
+ * number, segment number (16 bit, LSB first); the first segment of a message
+ * adds the message length (32 bit, LSB first). The segments are as long as
+ * the maximum payload of the link allows, see Fragmenter_SetMaxPayload.
+ * Received segments have to arrive in order: a missing or unexpected
+ * segment drops the message being reassembled.
+ *
+ * A driver sends the segments by the send function, e.g. over its instance
+ * passed as sendContextP, passes the max_payload of the channel open to
+ * Fragmenter_SetMaxPayload and the payload of each data indication to
+ * Fragmenter_Receive, and calls Fragmenter_Reset on disconnect; see
+ * ProteusIII_SetMessageCallbackEx and ProteusIII_SendMessageEx.
+ */
+#define FRAGMENTER_FLAG_FIRST           0x01                /* first segment of a message, carries its length */
+#define FRAGMENTER_FLAG_LAST            0x02                /* last segment of a message */
+#define FRAGMENTER_HEADER_LENGTH        4                   /* flags, message number, segment number */
+#define FRAGMENTER_FIRST_HEADER_LENGTH  8                   /* header of the first segment, with the message length */
+
+typedef bool (*Fragmenter_SendFunction_t)(void *contextP, uint8_t *payloadP, uint16_t length);
+typedef void (*Fragmenter_MessageCallback_t)(uint8_t *messageP, uint32_t length, void *contextP);
+
+typedef struct Fragmenter_Statistics_t
+{
+    uint64_t messagesSent;
+    uint64_t segmentsSent;
+    uint64_t messagesReceived;
+    uint64_t messagesDropped;                               /* started, but incomplete, too long or out of order */
+} Fragmenter_Statistics_t;
+
+typedef struct Fragmenter_t
+{
+    Fragmenter_SendFunction_t send;
+    void *sendContextP;
+    Fragmenter_MessageCallback_t messageCb;
+    void *contextP;
+    pthread_mutex_t sendMutex;                              /* keeps the segments of a message together */
+    uint16_t maxSegmentLength;                              /* limit of the send function */
+    uint16_t segmentLength;                                 /* limit of the link, see Fragmenter_SetMaxPayload */
+    uint8_t *segmentP;                                      /* segment being sent */
+    uint8_t txMessage;                                      /* number of the next message sent */
+    uint8_t *messageP;                                      /* message being reassembled */
+    uint32_t maxMessageLength;
+    uint32_t rxLength;                                      /* length of the message being reassembled */
+    uint32_t rxReceived;                                    /* bytes of it received */
+    uint16_t rxSegment;                                     /* number of the next segment expected */
+    uint8_t rxMessage;                                      /* number of the message being reassembled */
+    bool rxActive;                                          /* a message is being reassembled */
+    Fragmenter_Statistics_t statistics;
+} Fragmenter_t;
+
+/*
+ * Initialize a fragmenter
+ *
+ * input:
+ * - send: sends a segment over the link, the segment must be sent or copied on return
+ * - sendContextP: passed to send, e.g. the driver instance
+ * - maxSegmentLength: longest payload the send function accepts, more than FRAGMENTER_FIRST_HEADER_LENGTH
+ * - maxMessageLength: longest message reassembled, longer messages are dropped
+ * - messageCb: called from Fragmenter_Receive with each complete message, valid during the call
+ * - contextP: passed to messageCb
+ *
+ * return: true, if success
+ *         false, if the lengths are invalid or no memory was available
+ *
+ */
+extern bool Fragmenter_Init(Fragmenter_t *fragmenterP, Fragmenter_SendFunction_t send, void *sendContextP, uint16_t maxSegmentLength,
+                            uint32_t maxMessageLength, Fragmenter_MessageCallback_t messageCb, void *contextP);
+
+/*
+ * Free the buffers of a fragmenter, no other function may be running on it
+ */
+extern void Fragmenter_Deinit(Fragmenter_t *fragmenterP);
+
+/*
+ * Size the segments by the maximum payload of the link, e.g. the max_payload
+ * reported when the channel was opened; it is limited to maxSegmentLength
+ *
+ * return: true, if success
+ *         false, if the payload does not hold a first segment header and data
+ *
+ */
+extern bool Fragmenter_SetMaxPayload(Fragmenter_t *fragmenterP, uint16_t maxPayload);
+
+/*
+ * Send a message as segments, concurrent calls send their messages one after another
+ *
+ * return: true, if all segments were sent
+ *         false, otherwise; the receiver drops the incomplete message
+ *
+ */
+extern bool Fragmenter_Send(Fragmenter_t *fragmenterP, const uint8_t *messageP, uint32_t length);
+
+/*
+ * Pass a received segment, called from the RX callback of the driver only
+ */
+extern void Fragmenter_Receive(Fragmenter_t *fragmenterP, const uint8_t *payloadP, uint16_t length);
+
+/*
+ * Drop the message being reassembled, e.g. when the link was disconnected
+ */
+extern void Fragmenter_Reset(Fragmenter_t *fragmenterP);
+
+/*
+ * Copy the counters since Fragmenter_Init
+ */
+extern void Fragmenter_GetStatistics(Fragmenter_t *fragmenterP, Fragmenter_Statistics_t *statisticsP);
+
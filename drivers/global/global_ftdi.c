@@ -28,6 +28,9 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
 #include "string.h"
 #include "ftd2xx.h"
 #include <sched.h>
@@ -35,154 +38,118 @@
 #include "../../drivers/WE-common.h"
 #include "global.h"
 
+/* maximum size of a frame sent by FTDI_SendFrame */
+#define FTDI_MAX_FRAME_SIZE 2048
 
-#ifndef _global_ftdi_defined
-#define _global_ftdi_defined
-#ifdef _global_serial_defined
-#error "second interface defined"
-#endif
 
 /**************************************
  *     Static function declarations   *
  **************************************/
 static bool ConfigureCBUS0(int interface);
+static bool FTDI_Open(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit);
+static bool FTDI_Close(Transport_t *transportP);
+static bool FTDI_Flush(Transport_t *transportP);
+static bool FTDI_SendBytes(Transport_t *transportP, uint8_t *dataP, uint16_t length);
+static bool FTDI_SendFrame(Transport_t *transportP, const struct iovec *iov, int n);
+static bool FTDI_ReadBytes(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms);
+static Serial_RxWait_t FTDI_WaitForRxData(Transport_t *transportP, int eventFd, int timeout_ms);
+static int FTDI_GetFd(Transport_t *transportP);
+static bool FTDI_InitPin(Transport_t *transportP, int pin_number);
+static bool FTDI_DeinitPin(Transport_t *transportP, int pin_number);
+static bool FTDI_SetPin(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out);
+static void FTDI_Destroy(Transport_t *transportP);
 
 /**************************************
  *          Static variables          *
  **************************************/
 
-FT_HANDLE ft_handle = 0;                    /* handle for the FTDI interface */
-FT_STATUS ft_status = FT_OK;                /* used to return if ftdi fuctions are successfull or if an error occured */
-int interface = 0;
+typedef struct FTDI_Context_t
+{
+    FT_HANDLE handle;           /* handle for the FTDI interface, 0 if closed */
+    int index;                  /* device index of the D2XX library */
+    EVENT_HANDLE rxEvent;       /* signalled by the D2XX library when bytes arrive (FT_EVENT_RXCHAR) */
+} FTDI_Context_t;
+
+static const Transport_Ops_t ftdi_ops =
+{
+    .open = FTDI_Open,
+    .close = FTDI_Close,
+    .flush = FTDI_Flush,
+    .sendBytes = FTDI_SendBytes,
+    .sendFrame = FTDI_SendFrame,
+    .readBytes = FTDI_ReadBytes,
+    .waitForRxData = FTDI_WaitForRxData,
+    .getFd = FTDI_GetFd,
+    .initPin = FTDI_InitPin,
+    .deinitPin = FTDI_DeinitPin,
+    .setPin = FTDI_SetPin,
+    .destroy = FTDI_Destroy,
+};
+
+/* the eventfd can not be waited on together with rxEvent, it is checked between slices of this length */
+#define RX_EVENT_SLICE_MS 10
 
 /**************************************
  *         Global functions           *
  **************************************/
 
-bool SetPin( int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+Transport_t *FTDITransport_Create(int index)
 {
-    if(pin_number == PIN_INVALID)
+    Transport_t *transportP;
+    FTDI_Context_t *contextP;
+
+    if(index < 0)
     {
-        /* do nothing */
+        return NULL;
     }
-    else if(pin_number == PIN_FTDI_DTR)
-    {
-        /* workaround for DTR */
-        switch(inout)
-        {
-        case SetPin_InputOutput_Input:
-        {
-
-        }
-        break;
-
-        case SetPin_InputOutput_Output:
-        {
-            switch(out)
-            {
-            case SetPin_Out_Low:
-            {
-                ft_status = FT_SetDtr(ft_handle);
-            }
-            break;
-
-            case SetPin_Out_High:
-            {
-                ft_status = FT_ClrDtr(ft_handle);
-            }
-            break;
 
-            default:
-            {
-                return false;
-            }
-            break;
-            }
-        }
-        break;
-
-        default:
-        {
-            return false;
-        }
-        break;
-        }
-    }
-    else if(pin_number == PIN_FTDI_CBUS0)
+    transportP = calloc(1, sizeof(Transport_t));
+    contextP = calloc(1, sizeof(FTDI_Context_t));
+    if((transportP == NULL) || (contextP == NULL))
     {
-        uint8_t mode = 0x00;
-        pin_number = 0; /* CBUS0 */
-
-        switch(inout)
-        {
-        case SetPin_InputOutput_Input:
-        {
-            ft_status = FT_SetBitMode(ft_handle, 0x00, FT_BITMODE_RESET);
-        }
-        break;
-
-        case SetPin_InputOutput_Output:
-        {
-            /* set cbus0 to output mode
-               0x10 -> cbus0 output, cbus1-3 input */
-            mode = mode | (0x10 << pin_number);
+        free(transportP);
+        free(contextP);
+        return NULL;
+    }
 
-            switch(out)
-            {
-            case SetPin_Out_Low:
-            {
-                mode = mode | (0x00 << pin_number);
-            }
-            break;
+    contextP->index = index;
+    pthread_mutex_init(&contextP->rxEvent.eMutex, NULL);
+    pthread_cond_init(&contextP->rxEvent.eCondVar, NULL);
+    transportP->ops = &ftdi_ops;
+    transportP->contextP = contextP;
+    return transportP;
+}
 
-            case SetPin_Out_High:
-            {
-                mode = mode | (0x01 << pin_number);
-            }
-            break;
+#ifndef GLOBAL_NO_DEFAULT_TRANSPORT
 
-            default:
-            {
-                return false;
-            }
-            break;
-            }
-            ft_status = FT_SetBitMode(ft_handle, mode, FT_BITMODE_CBUS_BITBANG);
-        }
-        break;
+/* transport used by the functions without transport parameter */
+static FTDI_Context_t default_context = { .handle = 0, .index = 0, .rxEvent = { .eCondVar = PTHREAD_COND_INITIALIZER, .eMutex = PTHREAD_MUTEX_INITIALIZER } };
+static Transport_t default_transport = { .ops = &ftdi_ops, .contextP = &default_context };
 
-        default:
-        {
-            return false;
-        }
-        break;
-        }
-    }
-    else
-    {
-        /* not implemented */
-        return false;
-    }
+Transport_t *GetDefaultTransport()
+{
+    return &default_transport;
+}
 
-    return true;
+bool SetPin( int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+{
+    return FTDI_SetPin(&default_transport, pin_number, inout, pull, out);
 }
 
 bool SendBytes(uint8_t* dataP, uint16_t length)
 {
-    DWORD bytesWritten = 0;
-    ft_status = FT_Write(ft_handle, dataP, length, &bytesWritten);
-    if(ft_status != FT_OK)
-    {
-        fprintf(stdout,"SendBytes failed with ftdi error code %d\n",(int)ft_status);
-        return false;
-    }
-    return true;
+    return FTDI_SendBytes(&default_transport, dataP, length);
+}
+
+bool SendFrame(const struct iovec *iov, int n)
+{
+    return FTDI_SendFrame(&default_transport, iov, n);
 }
 
 bool BytesAvailable()
 {
     DWORD availableBytes = -1;
-    ft_status = FT_GetQueueStatus(ft_handle, &availableBytes);
+    FT_STATUS ft_status = FT_GetQueueStatus(default_context.handle, &availableBytes);
     if(ft_status == FT_OK)
     {
         return (availableBytes > 0);
@@ -197,7 +164,7 @@ bool BytesAvailable()
 bool ReadByte(uint8_t *readBufferP)
 {
     DWORD BytesRead = 0;
-    ft_status = FT_Read(ft_handle, readBufferP, 1, &BytesRead);
+    FT_STATUS ft_status = FT_Read(default_context.handle, readBufferP, 1, &BytesRead);
     if(ft_status != FT_OK)
     {
         fprintf(stdout,"ReadByte failed with ftdi error code %d\n",(int)ft_status);
@@ -207,69 +174,39 @@ bool ReadByte(uint8_t *readBufferP)
     return true;
 }
 
-bool CloseSerial()
+bool ReadBytes(uint8_t *buf, size_t max, size_t *got, int timeout_ms)
 {
-    if(ft_handle != 0)
-    {
-        /* empty rx/tx buffer */
-        ft_status = FT_Purge(ft_handle, FT_PURGE_RX | FT_PURGE_TX);
-        if(ft_status != FT_OK)
-        {
-            fprintf(stdout, "CloseSerial: Could not empty RX and TX Buffer\n");
-        }
+    return FTDI_ReadBytes(&default_transport, buf, max, got, timeout_ms);
+}
 
-        /*close connection*/
-        ft_status = FT_Close(ft_handle);
-        ft_handle = 0;
-        if(ft_status != FT_OK)
-        {
-            fprintf(stdout,"CloseSerial failed with ftdi error code %d\n",(int)ft_status);
-            return false;
-        }
-    }
-    return true;
+int GetSerialFd()
+{
+    return FTDI_GetFd(&default_transport);
 }
 
-bool FlushSerial()
+Serial_RxWait_t WaitForRxData(int eventFd, int timeout_ms)
 {
-    if(ft_handle != 0)
-    {
-        ft_status = FT_Purge(ft_handle, FT_PURGE_RX | FT_PURGE_TX);
-        if(ft_status != FT_OK)
-        {
-            fprintf(stdout, "FlushSerial: Could not empty RX and TX Buffer\n");
-        }
-    }
-    return true;
+    return FTDI_WaitForRxData(&default_transport, eventFd, timeout_ms);
 }
 
+bool CloseSerial()
+{
+    return FTDI_Close(&default_transport);
+}
+
+bool FlushSerial()
+{
+    return FTDI_Flush(&default_transport);
+}
 
 bool InitPin(int pin_number)
 {
-    if (pin_number == PIN_INVALID)
-    {
-        /* nothing to do */
-        return true;
-    }
-    else if (pin_number == PIN_FTDI_DTR)
-    {
-        /* nothing to do */
-        return true;
-    }
-    else if (pin_number == PIN_FTDI_CBUS0)
-    {
-        return ConfigureCBUS0(interface);
-    }
-    else
-    {
-        /* not implemented */
-        return false;
-    }
+    return FTDI_InitPin(&default_transport, pin_number);
 }
 
 bool DeinitPin(int pin_number)
 {
-    return true;
+    return FTDI_DeinitPin(&default_transport, pin_number);
 }
 
 bool InitSerial()
@@ -282,6 +219,26 @@ bool DeinitSerial()
     return true;
 }
 
+bool SetSerialDevice(const char *device)
+{
+    char *end;
+    long index;
+
+    if(device == NULL)
+    {
+        return false;
+    }
+
+    /* FTDI interfaces are selected by their device index */
+    index = strtol(device, &end, 10);
+    if((end == device) || (*end != '\0') || (index < 0))
+    {
+        return false;
+    }
+    default_context.index = (int)index;
+    return true;
+}
+
 bool OpenSerial(int baudrate)
 {
     return OpenSerialWithParity(baudrate, Serial_ParityBit_NONE);
@@ -289,68 +246,475 @@ bool OpenSerial(int baudrate)
 
 bool OpenSerialWithParity(int baudrate, Serial_ParityBit_t parityBit)
 {
+    return FTDI_Open(&default_transport, baudrate, parityBit);
+}
+
+#endif // GLOBAL_NO_DEFAULT_TRANSPORT
+
+/**************************************
+ *         Static functions           *
+ **************************************/
+
+static bool FTDI_Open(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+    FT_STATUS ft_status;
     UCHAR latency = 1;
     uint transferSize = 15*64;
 
+    if(contextP->handle != 0)
+    {
+        /* already open */
+        return true;
+    }
+
     /* start FTDI interface */
-    ft_status = FT_Open(interface, &ft_handle);
+    ft_status = FT_Open(contextP->index, &contextP->handle);
     if(ft_status != FT_OK)
     {
-        fprintf(stdout, "FT_Open(%d) failed, with error %d.\n", interface, (int)ft_status);
+        fprintf(stdout, "FT_Open(%d) failed, with error %d.\n", contextP->index, (int)ft_status);
         fprintf(stdout, "Use lsmod to check if ftdi_sio (and usbserial) are present.\n");
         fprintf(stdout, "If so, unload them using 'modprobe -r', as they conflict with ftd2xx.\n");
+        contextP->handle = 0;
         return false;
     }
 
     /* set baudrate as specified by paramter */
-    ft_status = FT_SetBaudRate(ft_handle, baudrate);
+    ft_status = FT_SetBaudRate(contextP->handle, baudrate);
     if(ft_status != FT_OK)
     {
         fprintf(stdout, "Setting Baudrate failed.\n");
-        CloseSerial();
+        FTDI_Close(transportP);
         return false;
     }
 
     /* set to 8 Bits, 1 Stop bit and parity none (8n1) */
-    ft_status = FT_SetDataCharacteristics(ft_handle, FT_BITS_8, FT_STOP_BITS_1, (UCHAR)parityBit);
+    ft_status = FT_SetDataCharacteristics(contextP->handle, FT_BITS_8, FT_STOP_BITS_1, (UCHAR)parityBit);
     if (ft_status != FT_OK)
     {
         printf("Setting Data Characeristics to 8n1 failed\n");
-        CloseSerial();
+        FTDI_Close(transportP);
         return false;
     }
 
-    ft_status = FT_SetLatencyTimer(ft_handle, latency);
+    ft_status = FT_SetLatencyTimer(contextP->handle, latency);
     if (ft_status != FT_OK)
     {
         printf("Setting Latency failed\n");
-        CloseSerial();
+        FTDI_Close(transportP);
         return false;
     }
 
-    ft_status = FT_SetUSBParameters(ft_handle,transferSize, 0);
+    ft_status = FT_SetUSBParameters(contextP->handle,transferSize, 0);
     if (ft_status != FT_OK)
     {
         printf("Setting InTransferSize failed\n");
-        CloseSerial();
+        FTDI_Close(transportP);
         return false;
     }
 
     /* empty the ftdi buffers */
-    ft_status = FT_Purge(ft_handle, FT_PURGE_RX | FT_PURGE_TX);
+    ft_status = FT_Purge(contextP->handle, FT_PURGE_RX | FT_PURGE_TX);
     if (ft_status != FT_OK)
     {
         printf("init: Could not empty RX and TX Puffer\n");
-        CloseSerial();
+        FTDI_Close(transportP);
+        return false;
+    }
+
+    /* let WaitForRxData sleep until bytes arrive */
+    ft_status = FT_SetEventNotification(contextP->handle, FT_EVENT_RXCHAR, (PVOID)&contextP->rxEvent);
+    if (ft_status != FT_OK)
+    {
+        printf("Setting event notification failed\n");
+        FTDI_Close(transportP);
         return false;
     }
 
     return true;
 }
 
-/**************************************
- *         Static functions           *
- **************************************/
+static bool FTDI_Close(Transport_t *transportP)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+    FT_STATUS ft_status;
+
+    if(contextP->handle != 0)
+    {
+        /* empty rx/tx buffer */
+        ft_status = FT_Purge(contextP->handle, FT_PURGE_RX | FT_PURGE_TX);
+        if(ft_status != FT_OK)
+        {
+            fprintf(stdout, "CloseSerial: Could not empty RX and TX Buffer\n");
+        }
+
+        /*close connection*/
+        ft_status = FT_Close(contextP->handle);
+        contextP->handle = 0;
+        if(ft_status != FT_OK)
+        {
+            fprintf(stdout,"CloseSerial failed with ftdi error code %d\n",(int)ft_status);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool FTDI_Flush(Transport_t *transportP)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+
+    if(contextP->handle != 0)
+    {
+        if(FT_Purge(contextP->handle, FT_PURGE_RX | FT_PURGE_TX) != FT_OK)
+        {
+            fprintf(stdout, "FlushSerial: Could not empty RX and TX Buffer\n");
+        }
+    }
+    return true;
+}
+
+static bool FTDI_SendBytes(Transport_t *transportP, uint8_t *dataP, uint16_t length)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+    DWORD bytesWritten = 0;
+    FT_STATUS ft_status = FT_Write(contextP->handle, dataP, length, &bytesWritten);
+    if(ft_status != FT_OK)
+    {
+        fprintf(stdout,"SendBytes failed with ftdi error code %d\n",(int)ft_status);
+        return false;
+    }
+    return true;
+}
+
+static bool FTDI_SendFrame(Transport_t *transportP, const struct iovec *iov, int n)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+    uint8_t frame[FTDI_MAX_FRAME_SIZE];
+    DWORD length = 0;
+    DWORD bytesWritten = 0;
+    FT_STATUS ft_status;
+    int i;
+
+    if(n <= 0)
+    {
+        return false;
+    }
+
+    if(n == 1)
+    {
+        /* nothing to gather */
+        ft_status = FT_Write(contextP->handle, iov[0].iov_base, iov[0].iov_len, &bytesWritten);
+        length = iov[0].iov_len;
+    }
+    else
+    {
+        /* the D2XX library has no gather write, so the parts are collected to hand
+         * the frame to the library with a single FT_Write */
+        for(i = 0; i < n; i++)
+        {
+            if(length + iov[i].iov_len > sizeof(frame))
+            {
+                fprintf(stdout,"SendFrame failed, frame exceeds %d bytes\n", FTDI_MAX_FRAME_SIZE);
+                return false;
+            }
+            memcpy(&frame[length], iov[i].iov_base, iov[i].iov_len);
+            length += iov[i].iov_len;
+        }
+        ft_status = FT_Write(contextP->handle, frame, length, &bytesWritten);
+    }
+
+    if((ft_status != FT_OK) || (bytesWritten != length))
+    {
+        fprintf(stdout,"SendFrame failed with ftdi error code %d\n",(int)ft_status);
+        return false;
+    }
+    return true;
+}
+
+static bool FTDI_ReadBytes(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+    FT_STATUS ft_status;
+    DWORD availableBytes = 0;
+    DWORD bytesRead = 0;
+
+    *got = 0;
+    if(max == 0)
+    {
+        return false;
+    }
+
+    ft_status = FT_GetQueueStatus(contextP->handle, &availableBytes);
+    if(ft_status != FT_OK)
+    {
+        fprintf(stdout,"ReadBytes failed with ftdi error code %d\n",(int)ft_status);
+        return false;
+    }
+
+    if((availableBytes == 0) && (timeout_ms != 0))
+    {
+        if(FTDI_WaitForRxData(transportP, -1, timeout_ms) != Serial_RxWait_Data)
+        {
+            return true;
+        }
+        ft_status = FT_GetQueueStatus(contextP->handle, &availableBytes);
+        if(ft_status != FT_OK)
+        {
+            fprintf(stdout,"ReadBytes failed with ftdi error code %d\n",(int)ft_status);
+            return false;
+        }
+    }
+
+    if(availableBytes == 0)
+    {
+        return true;
+    }
+
+    /* fetch the whole queue in one transfer instead of one FT_Read per byte */
+    ft_status = FT_Read(contextP->handle, buf, (availableBytes < max) ? availableBytes : (DWORD)max, &bytesRead);
+    if(ft_status != FT_OK)
+    {
+        fprintf(stdout,"ReadBytes failed with ftdi error code %d\n",(int)ft_status);
+        return false;
+    }
+
+    *got = (size_t)bytesRead;
+    return true;
+}
+
+static int FTDI_GetFd(Transport_t *transportP)
+{
+    /* the D2XX library does not expose a file descriptor */
+    return -1;
+}
+
+static Serial_RxWait_t FTDI_WaitForRxData(Transport_t *transportP, int eventFd, int timeout_ms)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+    int waited_ms = 0;
+
+    while(1)
+    {
+        int slice_ms = RX_EVENT_SLICE_MS;
+        struct pollfd pfd;
+
+        if(eventFd >= 0)
+        {
+            pfd.fd = eventFd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if(poll(&pfd, 1, 0) > 0)
+            {
+                return Serial_RxWait_Event;
+            }
+        }
+
+        if((timeout_ms >= 0) && ((timeout_ms - waited_ms) < slice_ms))
+        {
+            slice_ms = timeout_ms - waited_ms;
+        }
+
+        if(contextP->handle == 0)
+        {
+            /* interface closed, only the event can wake us up */
+            if(eventFd < 0)
+            {
+                return Serial_RxWait_Error;
+            }
+            pfd.fd = eventFd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if(poll(&pfd, 1, slice_ms) > 0)
+            {
+                return Serial_RxWait_Event;
+            }
+        }
+        else
+        {
+            DWORD availableBytes = 0;
+            struct timespec deadline;
+
+            pthread_mutex_lock(&contextP->rxEvent.eMutex);
+            if(FT_GetQueueStatus(contextP->handle, &availableBytes) != FT_OK)
+            {
+                pthread_mutex_unlock(&contextP->rxEvent.eMutex);
+                return Serial_RxWait_Error;
+            }
+            if(availableBytes > 0)
+            {
+                pthread_mutex_unlock(&contextP->rxEvent.eMutex);
+                return Serial_RxWait_Data;
+            }
+            if(slice_ms > 0)
+            {
+                clock_gettime(CLOCK_REALTIME, &deadline);
+                deadline.tv_nsec += (long)slice_ms * 1000000L;
+                deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+                deadline.tv_nsec %= 1000000000L;
+                pthread_cond_timedwait(&contextP->rxEvent.eCondVar, &contextP->rxEvent.eMutex, &deadline);
+            }
+            pthread_mutex_unlock(&contextP->rxEvent.eMutex);
+        }
+
+        waited_ms += slice_ms;
+        if((timeout_ms >= 0) && (waited_ms >= timeout_ms))
+        {
+            return Serial_RxWait_Timeout;
+        }
+    }
+}
+
+static bool FTDI_InitPin(Transport_t *transportP, int pin_number)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+
+    if (pin_number == PIN_INVALID)
+    {
+        /* nothing to do */
+        return true;
+    }
+    else if (pin_number == PIN_FTDI_DTR)
+    {
+        /* nothing to do */
+        return true;
+    }
+    else if (pin_number == PIN_FTDI_CBUS0)
+    {
+        return ConfigureCBUS0(contextP->index);
+    }
+    else
+    {
+        /* not implemented */
+        return false;
+    }
+}
+
+static bool FTDI_DeinitPin(Transport_t *transportP, int pin_number)
+{
+    return true;
+}
+
+static bool FTDI_SetPin(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+
+    if(pin_number == PIN_INVALID)
+    {
+        /* do nothing */
+    }
+    else if(pin_number == PIN_FTDI_DTR)
+    {
+        /* workaround for DTR */
+        switch(inout)
+        {
+        case SetPin_InputOutput_Input:
+        {
+
+        }
+        break;
+
+        case SetPin_InputOutput_Output:
+        {
+            switch(out)
+            {
+            case SetPin_Out_Low:
+            {
+                FT_SetDtr(contextP->handle);
+            }
+            break;
+
+            case SetPin_Out_High:
+            {
+                FT_ClrDtr(contextP->handle);
+            }
+            break;
+
+            default:
+            {
+                return false;
+            }
+            break;
+            }
+        }
+        break;
+
+        default:
+        {
+            return false;
+        }
+        break;
+        }
+    }
+    else if(pin_number == PIN_FTDI_CBUS0)
+    {
+        uint8_t mode = 0x00;
+        pin_number = 0; /* CBUS0 */
+
+        switch(inout)
+        {
+        case SetPin_InputOutput_Input:
+        {
+            FT_SetBitMode(contextP->handle, 0x00, FT_BITMODE_RESET);
+        }
+        break;
+
+        case SetPin_InputOutput_Output:
+        {
+            /* set cbus0 to output mode
+               0x10 -> cbus0 output, cbus1-3 input */
+            mode = mode | (0x10 << pin_number);
+
+            switch(out)
+            {
+            case SetPin_Out_Low:
+            {
+                mode = mode | (0x00 << pin_number);
+            }
+            break;
+
+            case SetPin_Out_High:
+            {
+                mode = mode | (0x01 << pin_number);
+            }
+            break;
+
+            default:
+            {
+                return false;
+            }
+            break;
+            }
+            FT_SetBitMode(contextP->handle, mode, FT_BITMODE_CBUS_BITBANG);
+        }
+        break;
+
+        default:
+        {
+            return false;
+        }
+        break;
+        }
+    }
+    else
+    {
+        /* not implemented */
+        return false;
+    }
+
+    return true;
+}
+
+static void FTDI_Destroy(Transport_t *transportP)
+{
+    FTDI_Context_t *contextP = transportP->contextP;
+
+    FTDI_Close(transportP);
+    pthread_cond_destroy(&contextP->rxEvent.eCondVar);
+    pthread_mutex_destroy(&contextP->rxEvent.eMutex);
+    free(contextP);
+    free(transportP);
+}
 
 /*
 * Configure FTDI chip for bitbang mode used in pinReset()
@@ -466,6 +830,3 @@ static bool ConfigureCBUS0(int interface)
 #endif // 0
     return true;
 }
-
-
-#endif // _global_ftdi_defined
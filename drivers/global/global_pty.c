@@ -0,0 +1,730 @@
+/**
+ ***************************************************************************************************
+ * This file is part of WIRELESS CONNECTIVITY SDK:
+ * https://www.we-online.com/wireless-connectivity
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS DRIVER PACKAGE.
+ *
+ * COPYRIGHT (c) 2020 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ ***************************************************************************************************
+ **/
+
+/*
+ * Transport on a pseudo terminal, for running the drivers and the example
+ * programs against a software peer (e.g. a module simulator) on any Linux
+ * system, without a module, wiringPi or the FTDI D2XX library.
+ *
+ * Pins do not exist: SetPin calls are recorded, passed to a callback and
+ * optionally written as text lines to a file descriptor, so that the peer
+ * can react on e.g. a pin reset.
+ *
+ * The default transport used by the functions without transport parameter
+ * creates a pty pair and prints the device the peer has to open. The
+ * environment variables WE_PTY_DEVICE (pty of the peer to attach to instead)
+ * and WE_PTY_PIN_EVENTS (FIFO or file receiving the pin events) configure it
+ * without changing the program.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "string.h"
+
+#include "../../drivers/WE-common.h"
+#include "global.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************
+ *     Static function declarations   *
+ **************************************/
+static bool Pty_Open(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit);
+static bool Pty_Close(Transport_t *transportP);
+static bool Pty_Flush(Transport_t *transportP);
+static bool Pty_SendBytes(Transport_t *transportP, uint8_t *dataP, uint16_t length);
+static bool Pty_SendFrame(Transport_t *transportP, const struct iovec *iov, int n);
+static bool Pty_ReadBytes(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms);
+static Serial_RxWait_t Pty_WaitForRxData(Transport_t *transportP, int eventFd, int timeout_ms);
+static int Pty_GetFd(Transport_t *transportP);
+static bool Pty_InitPin(Transport_t *transportP, int pin_number);
+static bool Pty_DeinitPin(Transport_t *transportP, int pin_number);
+static bool Pty_SetPin(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out);
+static void Pty_Destroy(Transport_t *transportP);
+static bool Pty_Setup(Transport_t *transportP);
+static bool Pty_MakeRaw(int fd);
+
+/**************************************
+ *          Static variables          *
+ **************************************/
+
+#define PTY_PIN_EVENT_COUNT 64                  /* number of pin events kept */
+#define PTY_SEND_TIMEOUT_MS 1000                /* time the peer may take to read a frame */
+#define PTY_DEVICE_ENV      "WE_PTY_DEVICE"
+#define PTY_PIN_EVENTS_ENV  "WE_PTY_PIN_EVENTS"
+
+typedef struct Pty_Context_t
+{
+    int fd;                                     /* side used by the driver, -1 until the pty is set up */
+    int peerFd;                                 /* slave side held open while no peer is attached, -1 if not created by the transport */
+    bool open;                                  /* interface opened by the driver */
+    bool useEnvironment;                        /* device and pin event file may be given by environment variables */
+    char device[64];                            /* pty of the peer to attach to, empty to create a pty pair */
+    char peerName[64];                          /* slave side of the created pty pair */
+    int baudrate;                               /* requested by the driver, the pty does not emulate it */
+    Serial_ParityBit_t parityBit;
+    pthread_mutex_t pinMutex;                   /* protects the pin event members */
+    PtyTransport_PinEvent_t pinEvents[PTY_PIN_EVENT_COUNT];
+    size_t pinEventCount;                       /* number of events recorded since creation */
+    PtyTransport_PinCallback_t pinCallback;
+    void *pinCallbackContextP;
+    int pinEventFd;                             /* receives the pin events as text, -1 if none */
+} Pty_Context_t;
+
+static const Transport_Ops_t pty_ops =
+{
+    .open = Pty_Open,
+    .close = Pty_Close,
+    .flush = Pty_Flush,
+    .sendBytes = Pty_SendBytes,
+    .sendFrame = Pty_SendFrame,
+    .readBytes = Pty_ReadBytes,
+    .waitForRxData = Pty_WaitForRxData,
+    .getFd = Pty_GetFd,
+    .initPin = Pty_InitPin,
+    .deinitPin = Pty_DeinitPin,
+    .setPin = Pty_SetPin,
+    .destroy = Pty_Destroy,
+};
+
+/**************************************
+ *         Global functions           *
+ **************************************/
+
+Transport_t *PtyTransport_Create(const char *device)
+{
+    Transport_t *transportP;
+    Pty_Context_t *contextP;
+
+    if((device != NULL) && (strlen(device) >= sizeof(contextP->device)))
+    {
+        return NULL;
+    }
+
+    transportP = calloc(1, sizeof(Transport_t));
+    contextP = calloc(1, sizeof(Pty_Context_t));
+    if((transportP == NULL) || (contextP == NULL))
+    {
+        free(transportP);
+        free(contextP);
+        return NULL;
+    }
+
+    contextP->fd = -1;
+    contextP->peerFd = -1;
+    contextP->pinEventFd = -1;
+    if(device != NULL)
+    {
+        strcpy(contextP->device, device);
+    }
+    pthread_mutex_init(&contextP->pinMutex, NULL);
+    transportP->ops = &pty_ops;
+    transportP->contextP = contextP;
+
+    /* set up the pty right away, so that the peer can attach before the driver opens it */
+    if(false == Pty_Setup(transportP))
+    {
+        Pty_Destroy(transportP);
+        return NULL;
+    }
+    return transportP;
+}
+
+const char *PtyTransport_GetPeerName(Transport_t *transportP)
+{
+    Pty_Context_t *contextP;
+
+    if((transportP == NULL) || (transportP->ops != &pty_ops) || (false == Pty_Setup(transportP)))
+    {
+        return NULL;
+    }
+    contextP = transportP->contextP;
+    return (contextP->peerName[0] != '\0') ? contextP->peerName : NULL;
+}
+
+void PtyTransport_SetPinCallback(Transport_t *transportP, PtyTransport_PinCallback_t callback, void *contextP)
+{
+    Pty_Context_t *ptyContextP;
+
+    if((transportP == NULL) || (transportP->ops != &pty_ops))
+    {
+        return;
+    }
+    ptyContextP = transportP->contextP;
+    pthread_mutex_lock(&ptyContextP->pinMutex);
+    ptyContextP->pinCallback = callback;
+    ptyContextP->pinCallbackContextP = contextP;
+    pthread_mutex_unlock(&ptyContextP->pinMutex);
+}
+
+void PtyTransport_SetPinEventFd(Transport_t *transportP, int fd)
+{
+    Pty_Context_t *contextP;
+
+    if((transportP == NULL) || (transportP->ops != &pty_ops))
+    {
+        return;
+    }
+    contextP = transportP->contextP;
+    pthread_mutex_lock(&contextP->pinMutex);
+    contextP->pinEventFd = fd;
+    pthread_mutex_unlock(&contextP->pinMutex);
+}
+
+size_t PtyTransport_GetPinEvents(Transport_t *transportP, PtyTransport_PinEvent_t *eventsP, size_t max)
+{
+    Pty_Context_t *contextP;
+    size_t count;
+    size_t i;
+
+    if((transportP == NULL) || (transportP->ops != &pty_ops) || (eventsP == NULL))
+    {
+        return 0;
+    }
+    contextP = transportP->contextP;
+
+    pthread_mutex_lock(&contextP->pinMutex);
+    count = contextP->pinEventCount;
+    if(count > PTY_PIN_EVENT_COUNT)
+    {
+        count = PTY_PIN_EVENT_COUNT;
+    }
+    if(count > max)
+    {
+        count = max;
+    }
+    /* the last count events, oldest first */
+    for(i = 0; i < count; i++)
+    {
+        eventsP[i] = contextP->pinEvents[(contextP->pinEventCount - count + i) % PTY_PIN_EVENT_COUNT];
+    }
+    pthread_mutex_unlock(&contextP->pinMutex);
+
+    return count;
+}
+
+#ifndef GLOBAL_NO_DEFAULT_TRANSPORT
+
+/* transport used by the functions without transport parameter */
+static Pty_Context_t default_context = { .fd = -1, .peerFd = -1, .useEnvironment = true, .pinMutex = PTHREAD_MUTEX_INITIALIZER, .pinEventFd = -1 };
+static Transport_t default_transport = { .ops = &pty_ops, .contextP = &default_context };
+
+Transport_t *GetDefaultTransport()
+{
+    return &default_transport;
+}
+
+bool SetPin( int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+{
+    return Pty_SetPin(&default_transport, pin_number, inout, pull, out);
+}
+
+bool SendBytes(uint8_t* dataP, uint16_t length)
+{
+    return Pty_SendBytes(&default_transport, dataP, length);
+}
+
+bool SendFrame(const struct iovec *iov, int n)
+{
+    return Pty_SendFrame(&default_transport, iov, n);
+}
+
+bool BytesAvailable()
+{
+    int availableBytes = 0;
+
+    if((default_context.open) && (ioctl(default_context.fd, FIONREAD, &availableBytes) == 0))
+    {
+        return (availableBytes > 0);
+    }
+    return false;
+}
+
+bool ReadByte(uint8_t *readBufferP)
+{
+    size_t got = 0;
+
+    /* like serialGetchar, wait for the byte */
+    return Pty_ReadBytes(&default_transport, readBufferP, 1, &got, -1) && (got == 1);
+}
+
+bool ReadBytes(uint8_t *buf, size_t max, size_t *got, int timeout_ms)
+{
+    return Pty_ReadBytes(&default_transport, buf, max, got, timeout_ms);
+}
+
+int GetSerialFd()
+{
+    return Pty_GetFd(&default_transport);
+}
+
+Serial_RxWait_t WaitForRxData(int eventFd, int timeout_ms)
+{
+    return Pty_WaitForRxData(&default_transport, eventFd, timeout_ms);
+}
+
+bool CloseSerial()
+{
+    return Pty_Close(&default_transport);
+}
+
+bool FlushSerial()
+{
+    return Pty_Flush(&default_transport);
+}
+
+bool InitPin(int pin_number)
+{
+    return Pty_InitPin(&default_transport, pin_number);
+}
+
+bool DeinitPin(int pin_number)
+{
+    return Pty_DeinitPin(&default_transport, pin_number);
+}
+
+bool InitSerial()
+{
+    return Pty_Setup(&default_transport);
+}
+
+bool DeinitSerial()
+{
+    return true;
+}
+
+bool SetSerialDevice(const char *device)
+{
+    if((device == NULL) || (strlen(device) >= sizeof(default_context.device)) || (default_context.fd >= 0))
+    {
+        /* the pty can not be changed once it is set up */
+        return false;
+    }
+    strcpy(default_context.device, device);
+    return true;
+}
+
+bool OpenSerial(int baudrate)
+{
+    return OpenSerialWithParity(baudrate, Serial_ParityBit_NONE);
+}
+
+bool OpenSerialWithParity(int baudrate, Serial_ParityBit_t parityBit)
+{
+    return Pty_Open(&default_transport, baudrate, parityBit);
+}
+
+#endif // GLOBAL_NO_DEFAULT_TRANSPORT
+
+/**************************************
+ *         Static functions           *
+ **************************************/
+
+/* configure a terminal to pass all bytes unchanged, without echo and without blocking reads */
+static bool Pty_MakeRaw(int fd)
+{
+    struct termios options;
+
+    if(tcgetattr(fd, &options) != 0)
+    {
+        return false;
+    }
+    cfmakeraw(&options);
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 0;
+    return (tcsetattr(fd, TCSANOW, &options) == 0);
+}
+
+/* create the pty pair or attach to the pty of the peer, once per transport */
+static bool Pty_Setup(Transport_t *transportP)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+    const char *envP;
+
+    if(contextP->fd >= 0)
+    {
+        return true;
+    }
+
+    if(contextP->useEnvironment)
+    {
+        envP = getenv(PTY_DEVICE_ENV);
+        if((contextP->device[0] == '\0') && (envP != NULL) && (strlen(envP) < sizeof(contextP->device)))
+        {
+            strcpy(contextP->device, envP);
+        }
+        envP = getenv(PTY_PIN_EVENTS_ENV);
+        if((contextP->pinEventFd < 0) && (envP != NULL))
+        {
+            /* do not wait for the reader of a FIFO, but write blocking once it is open */
+            contextP->pinEventFd = open(envP, O_WRONLY | O_APPEND | O_CREAT | O_NONBLOCK | O_CLOEXEC, 0644);
+            if(contextP->pinEventFd < 0)
+            {
+                fprintf(stdout, "Opening %s for the pin events failed: %s\n", envP, strerror(errno));
+            }
+            else
+            {
+                fcntl(contextP->pinEventFd, F_SETFL, fcntl(contextP->pinEventFd, F_GETFL) & ~O_NONBLOCK);
+            }
+        }
+    }
+
+    if(contextP->device[0] != '\0')
+    {
+        /* the peer created the pty, use its slave side like a serial device */
+        contextP->fd = open(contextP->device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if((contextP->fd < 0) || (false == Pty_MakeRaw(contextP->fd)))
+        {
+            fprintf(stdout, "Opening the pseudo terminal %s failed: %s\n", contextP->device, strerror(errno));
+            if(contextP->fd >= 0)
+            {
+                close(contextP->fd);
+                contextP->fd = -1;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    contextP->fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if((contextP->fd < 0) ||
+       (grantpt(contextP->fd) != 0) ||
+       (unlockpt(contextP->fd) != 0) ||
+       (ptsname_r(contextP->fd, contextP->peerName, sizeof(contextP->peerName)) != 0))
+    {
+        fprintf(stdout, "Creating the pseudo terminal failed: %s\n", strerror(errno));
+        goto failed;
+    }
+
+    /* keep the slave side open, otherwise the master reports a hang up until
+     * the peer attaches and after it detached; its settings apply to the peer as well */
+    contextP->peerFd = open(contextP->peerName, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if((contextP->peerFd < 0) || (false == Pty_MakeRaw(contextP->peerFd)))
+    {
+        fprintf(stdout, "Opening the pseudo terminal %s failed: %s\n", contextP->peerName, strerror(errno));
+        goto failed;
+    }
+
+    if(contextP->useEnvironment)
+    {
+        fprintf(stdout, "Pseudo terminal for the peer: %s\n", contextP->peerName);
+    }
+    return true;
+
+failed:
+    if(contextP->peerFd >= 0)
+    {
+        close(contextP->peerFd);
+        contextP->peerFd = -1;
+    }
+    if(contextP->fd >= 0)
+    {
+        close(contextP->fd);
+        contextP->fd = -1;
+    }
+    contextP->peerName[0] = '\0';
+    return false;
+}
+
+static bool Pty_Open(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+
+    if(false == Pty_Setup(transportP))
+    {
+        return false;
+    }
+
+    contextP->baudrate = baudrate;
+    contextP->parityBit = parityBit;
+    contextP->open = true;
+    return true;
+}
+
+static bool Pty_Close(Transport_t *transportP)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+
+    if(contextP->open)
+    {
+        /* the pty stays set up, only the driver stops using it */
+        Pty_Flush(transportP);
+        contextP->open = false;
+    }
+    return true;
+}
+
+static bool Pty_Flush(Transport_t *transportP)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+
+    if(contextP->open)
+    {
+        tcflush(contextP->fd, TCIOFLUSH);
+    }
+    return true;
+}
+
+static bool Pty_SendBytes(Transport_t *transportP, uint8_t *dataP, uint16_t length)
+{
+    struct iovec data = { .iov_base = dataP, .iov_len = length };
+
+    return Pty_SendFrame(transportP, &data, 1);
+}
+
+static bool Pty_SendFrame(Transport_t *transportP, const struct iovec *iov, int n)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+    int first = 0;
+    ssize_t written;
+
+    if((false == contextP->open) || (n <= 0))
+    {
+        return false;
+    }
+
+    /* copy of the parts, adjusted in case the kernel takes the frame in several steps */
+    struct iovec remaining[n];
+    memcpy(remaining, iov, n * sizeof(struct iovec));
+
+    while(first < n)
+    {
+        written = writev(contextP->fd, &remaining[first], n - first);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            if((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                /* the pty buffer is full, give the peer time to read */
+                struct pollfd pfd = { .fd = contextP->fd, .events = POLLOUT };
+                if(poll(&pfd, 1, PTY_SEND_TIMEOUT_MS) <= 0)
+                {
+                    fprintf(stdout, "SendFrame failed: peer does not read\n");
+                    return false;
+                }
+                continue;
+            }
+            fprintf(stdout, "SendFrame failed: %s\n", strerror(errno));
+            return false;
+        }
+
+        /* skip the parts written completely and continue within a partially written one */
+        while((first < n) && ((size_t)written >= remaining[first].iov_len))
+        {
+            written -= remaining[first].iov_len;
+            first++;
+        }
+        if(first < n)
+        {
+            remaining[first].iov_base = (uint8_t*)remaining[first].iov_base + written;
+            remaining[first].iov_len -= written;
+        }
+    }
+
+    return true;
+}
+
+static bool Pty_ReadBytes(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+    ssize_t bytesRead;
+
+    *got = 0;
+    if((false == contextP->open) || (max == 0))
+    {
+        return false;
+    }
+
+    /* the driver side is non-blocking, so read returns what is buffered */
+    bytesRead = read(contextP->fd, buf, max);
+    if((bytesRead < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)) && (timeout_ms != 0))
+    {
+        /* nothing buffered yet, sleep in the kernel until the first byte arrives */
+        struct pollfd pfd = { .fd = contextP->fd, .events = POLLIN };
+        if(poll(&pfd, 1, timeout_ms) <= 0)
+        {
+            /* timeout (or interrupted): report an empty read */
+            return true;
+        }
+        bytesRead = read(contextP->fd, buf, max);
+    }
+
+    if(bytesRead < 0)
+    {
+        return (errno == EINTR) || (errno == EAGAIN) || (errno == EWOULDBLOCK);
+    }
+
+    *got = (size_t)bytesRead;
+    return true;
+}
+
+static int Pty_GetFd(Transport_t *transportP)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+    return contextP->open ? contextP->fd : -1;
+}
+
+static Serial_RxWait_t Pty_WaitForRxData(Transport_t *transportP, int eventFd, int timeout_ms)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+    struct pollfd pfd[2];
+    nfds_t count = 0;
+    int eventIndex = -1;
+    int ptyIndex = -1;
+    int ret;
+
+    if(eventFd >= 0)
+    {
+        eventIndex = count;
+        pfd[count].fd = eventFd;
+        pfd[count].events = POLLIN;
+        pfd[count].revents = 0;
+        count++;
+    }
+    if(contextP->open)
+    {
+        /* while the interface is closed only the event is waited for */
+        ptyIndex = count;
+        pfd[count].fd = contextP->fd;
+        pfd[count].events = POLLIN;
+        pfd[count].revents = 0;
+        count++;
+    }
+    if(count == 0)
+    {
+        return Serial_RxWait_Error;
+    }
+
+    ret = poll(pfd, count, timeout_ms);
+    if(ret == 0)
+    {
+        return Serial_RxWait_Timeout;
+    }
+    if(ret < 0)
+    {
+        return (errno == EINTR) ? Serial_RxWait_Timeout : Serial_RxWait_Error;
+    }
+
+    if((eventIndex >= 0) && (pfd[eventIndex].revents & POLLIN))
+    {
+        return Serial_RxWait_Event;
+    }
+    if((ptyIndex >= 0) && (pfd[ptyIndex].revents & POLLIN))
+    {
+        return Serial_RxWait_Data;
+    }
+    return Serial_RxWait_Error;
+}
+
+static bool Pty_InitPin(Transport_t *transportP, int pin_number)
+{
+    /* no pins to set up */
+    return true;
+}
+
+static bool Pty_DeinitPin(Transport_t *transportP, int pin_number)
+{
+    return true;
+}
+
+static bool Pty_SetPin(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+    PtyTransport_PinEvent_t event;
+    PtyTransport_PinCallback_t callback;
+    void *callbackContextP;
+
+    if(pin_number == PIN_INVALID)
+    {
+        return true;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &event.time);
+    event.pin_number = pin_number;
+    event.inout = inout;
+    event.pull = pull;
+    event.out = out;
+
+    pthread_mutex_lock(&contextP->pinMutex);
+    contextP->pinEvents[contextP->pinEventCount % PTY_PIN_EVENT_COUNT] = event;
+    contextP->pinEventCount++;
+    callback = contextP->pinCallback;
+    callbackContextP = contextP->pinCallbackContextP;
+    if(contextP->pinEventFd >= 0)
+    {
+        dprintf(contextP->pinEventFd, "pin %d %s %s %s\n",
+                pin_number,
+                (inout == SetPin_InputOutput_Output) ? "out" : "in",
+                (pull == SetPin_Pull_Up) ? "up" : ((pull == SetPin_Pull_Down) ? "down" : "no"),
+                (out == SetPin_Out_High) ? "high" : "low");
+    }
+    pthread_mutex_unlock(&contextP->pinMutex);
+
+    /* called without the lock, the callback may use the transport */
+    if(callback != NULL)
+    {
+        callback(transportP, &event, callbackContextP);
+    }
+    return true;
+}
+
+static void Pty_Destroy(Transport_t *transportP)
+{
+    Pty_Context_t *contextP = transportP->contextP;
+
+    Pty_Close(transportP);
+    if(contextP->peerFd >= 0)
+    {
+        close(contextP->peerFd);
+    }
+    if(contextP->fd >= 0)
+    {
+        close(contextP->fd);
+    }
+    pthread_mutex_destroy(&contextP->pinMutex);
+    free(contextP);
+    free(transportP);
+}
+
+#ifdef __cplusplus
+}
+#endif
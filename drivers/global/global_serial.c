@@ -32,6 +32,11 @@
 #include <wiringPi.h>
 #include <wiringSerial.h>
 #include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
 #include "string.h"
 
 #include <sched.h>
@@ -44,120 +49,121 @@
 extern "C" {
 #endif
 
-#ifndef _global_serial_defined
-#define _global_serial_defined
-
-#ifdef _global_ftdi_defined
-#error "second interface defined"
-#endif
-
 /**************************************
  *     Static function declarations   *
  **************************************/
+static bool Serial_Open(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit);
+static bool Serial_Close(Transport_t *transportP);
+static bool Serial_Flush(Transport_t *transportP);
+static bool Serial_SendBytes(Transport_t *transportP, uint8_t *dataP, uint16_t length);
+static bool Serial_SendFrame(Transport_t *transportP, const struct iovec *iov, int n);
+static bool Serial_ReadBytes(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms);
+static Serial_RxWait_t Serial_WaitForRxData(Transport_t *transportP, int eventFd, int timeout_ms);
+static int Serial_GetFd(Transport_t *transportP);
+static bool Serial_InitPin(Transport_t *transportP, int pin_number);
+static bool Serial_DeinitPin(Transport_t *transportP, int pin_number);
+static bool Serial_SetPin(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out);
+static void Serial_Destroy(Transport_t *transportP);
+static void Serial_SetupWiringPi();
 
 /**************************************
  *          Static variables          *
  **************************************/
-int serial_handle = 0;
-int* serial_handleP = &serial_handle;
+
+typedef struct Serial_Context_t
+{
+    int fd;                     /* file descriptor of the open device, -1 if closed */
+    char device[64];            /* path of the serial device */
+} Serial_Context_t;
+
+static const Transport_Ops_t serial_ops =
+{
+    .open = Serial_Open,
+    .close = Serial_Close,
+    .flush = Serial_Flush,
+    .sendBytes = Serial_SendBytes,
+    .sendFrame = Serial_SendFrame,
+    .readBytes = Serial_ReadBytes,
+    .waitForRxData = Serial_WaitForRxData,
+    .getFd = Serial_GetFd,
+    .initPin = Serial_InitPin,
+    .deinitPin = Serial_DeinitPin,
+    .setPin = Serial_SetPin,
+    .destroy = Serial_Destroy,
+};
+
+/* wiringPi is set up once for all transports */
+static pthread_once_t wiringPi_once = PTHREAD_ONCE_INIT;
+static bool wiringPi_ready = false;
+
+#define SERIAL_DEFAULT_DEVICE "/dev/serial0"
 
 /**************************************
  *         Global functions           *
  **************************************/
 
-bool SetPin( int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+Transport_t *SerialTransport_Create(const char *device)
 {
-    switch(inout)
-    {
-        case SetPin_InputOutput_Input:
-        {
-            switch(pull)
-            {
-                case SetPin_Pull_Up:
-                {
-                    pullUpDnControl(pin_number, PUD_UP);
-                }
-                break;
+    Transport_t *transportP;
+    Serial_Context_t *contextP;
 
-                case SetPin_Pull_Down:
-                {
-                    pullUpDnControl(pin_number, PUD_DOWN);
-                }
-                break;
-
-                case SetPin_Pull_No:
-                {
-                    pullUpDnControl(pin_number, PUD_OFF);
-                }
-                break;
+    if(device == NULL)
+    {
+        device = SERIAL_DEFAULT_DEVICE;
+    }
+    if(strlen(device) >= sizeof(contextP->device))
+    {
+        return NULL;
+    }
 
-                default:
-                {
-                    return false;
-                }
-                break;
-            }
-            pinMode (pin_number, INPUT) ;
-        }
-        break;
+    transportP = calloc(1, sizeof(Transport_t));
+    contextP = calloc(1, sizeof(Serial_Context_t));
+    if((transportP == NULL) || (contextP == NULL))
+    {
+        free(transportP);
+        free(contextP);
+        return NULL;
+    }
 
-        case SetPin_InputOutput_Output:
-        {
-            switch(out)
-            {
-                case SetPin_Out_Low:
-                {
-                    digitalWrite (pin_number, LOW) ;
-                }
-                break;
+    contextP->fd = -1;
+    strcpy(contextP->device, device);
+    transportP->ops = &serial_ops;
+    transportP->contextP = contextP;
+    return transportP;
+}
 
-                case SetPin_Out_High:
-                {
-                    digitalWrite (pin_number, HIGH) ;
-                }
-                break;
+#ifndef GLOBAL_NO_DEFAULT_TRANSPORT
 
-                default:
-                {
-                    return false;
-                }
-                break;
-            }
-            pinMode (pin_number, OUTPUT) ;
-            pullUpDnControl(pin_number, PUD_OFF);
-        }
-        break;
+/* transport used by the functions without transport parameter */
+static Serial_Context_t default_context = { .fd = -1, .device = SERIAL_DEFAULT_DEVICE };
+static Transport_t default_transport = { .ops = &serial_ops, .contextP = &default_context };
 
-        default:
-        {
-            return false;
-        }
-        break;
-    }
+Transport_t *GetDefaultTransport()
+{
+    return &default_transport;
+}
 
-    return true;
+bool SetPin( int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+{
+    return Serial_SetPin(&default_transport, pin_number, inout, pull, out);
 }
 
 bool SendBytes(uint8_t* dataP, uint16_t length)
 {
-    if(*serial_handleP != 0)
-    {
-        int i = 0;
-        for(i=0; i<length; i++)
-        {
-            serialPutchar (*serial_handleP, dataP[i]);
-        }
-    }
+    return Serial_SendBytes(&default_transport, dataP, length);
+}
 
-    return true;
+bool SendFrame(const struct iovec *iov, int n)
+{
+    return Serial_SendFrame(&default_transport, iov, n);
 }
 
 bool BytesAvailable()
 {
-    if(*serial_handleP != 0)
+    if(default_context.fd >= 0)
     {
         int availableBytes = -1;
-        availableBytes = serialDataAvail(*serial_handleP);
+        availableBytes = serialDataAvail(default_context.fd);
         return (availableBytes > 0);
     }
     else
@@ -168,54 +174,93 @@ bool BytesAvailable()
 
 bool ReadByte(uint8_t *readBufferP)
 {
-    if(*serial_handleP != 0)
+    if(default_context.fd >= 0)
     {
-        *readBufferP = serialGetchar(*serial_handleP);
+        *readBufferP = serialGetchar(default_context.fd);
     }
 
     return true;
 }
 
+bool ReadBytes(uint8_t *buf, size_t max, size_t *got, int timeout_ms)
+{
+    return Serial_ReadBytes(&default_transport, buf, max, got, timeout_ms);
+}
+
+int GetSerialFd()
+{
+    return Serial_GetFd(&default_transport);
+}
+
+Serial_RxWait_t WaitForRxData(int eventFd, int timeout_ms)
+{
+    return Serial_WaitForRxData(&default_transport, eventFd, timeout_ms);
+}
+
 bool CloseSerial()
 {
-    if(*serial_handleP != 0)
-    {
-        /*empty UART buffer and close connection*/
-        serialFlush(*serial_handleP);
-        serialClose(*serial_handleP);
-        *serial_handleP = 0;
-    }
-    return true;
+    return Serial_Close(&default_transport);
 }
 
 bool FlushSerial()
 {
-    if(*serial_handleP != 0)
-    {
-        /* empty UART buffer and close connection */
-        serialFlush(*serial_handleP);
-    }
-    return true;
+    return Serial_Flush(&default_transport);
 }
 
 bool InitPin(int pin_number)
 {
-    return true;
+    return Serial_InitPin(&default_transport, pin_number);
 }
 
 bool DeinitPin(int pin_number)
 {
-    return true;
+    return Serial_DeinitPin(&default_transport, pin_number);
 }
 
 bool InitSerial()
+{
+    pthread_once(&wiringPi_once, Serial_SetupWiringPi);
+    return wiringPi_ready;
+}
+
+bool DeinitSerial()
+{
+    return true;
+}
+
+bool SetSerialDevice(const char *device)
+{
+    if((device == NULL) || (strlen(device) >= sizeof(default_context.device)))
+    {
+        return false;
+    }
+    strcpy(default_context.device, device);
+    return true;
+}
+
+bool OpenSerial(int baudrate)
+{
+    return OpenSerialWithParity(baudrate, Serial_ParityBit_NONE);
+}
+
+bool OpenSerialWithParity(int baudrate, Serial_ParityBit_t parityBit)
+{
+    return Serial_Open(&default_transport, baudrate, parityBit);
+}
+
+#endif // GLOBAL_NO_DEFAULT_TRANSPORT
+
+/**************************************
+ *         Static functions           *
+ **************************************/
+
+static void Serial_SetupWiringPi()
 {
     /* initialize wiringPi */
     if (wiringPiSetup() == -1)
     {
         fprintf (stdout, "Unable to start wiringPi: %s\n", strerror (errno)) ;
-        CloseSerial();
-        return false;
+        wiringPi_ready = false;
     }
     else
     {
@@ -224,29 +269,348 @@ bool InitSerial()
         int wiring_version_minor;
         wiringPiVersion(&wiring_version_major, &wiring_version_minor);
         fprintf (stdout, "WiringPi library version %d.%d\n\n",wiring_version_major,wiring_version_minor);
+        wiringPi_ready = true;
+    }
+}
+
+static bool Serial_Open(Transport_t *transportP, int baudrate, Serial_ParityBit_t parityBit)
+{
+    Serial_Context_t *contextP = transportP->contextP;
+
+    pthread_once(&wiringPi_once, Serial_SetupWiringPi);
+    if(false == wiringPi_ready)
+    {
+        return false;
+    }
+
+    if(contextP->fd >= 0)
+    {
+        /* already open */
+        return true;
+    }
+
+    /* start serial interface */
+    if ((contextP->fd = serialOpen (contextP->device, baudrate)) < 0)
+    {
+        fprintf (stdout, "Opening the serial interface failed. Probably invalid serial configuration.\n");
+        contextP->fd = -1;
+        return false ;
+    }
+
+    if(parityBit != Serial_ParityBit_NONE)
+    {
+        /* wiringSerial always configures 8n1 */
+        struct termios options;
+        tcgetattr(contextP->fd, &options);
+        options.c_cflag |= PARENB;
+        if(parityBit == Serial_ParityBit_ODD)
+        {
+            options.c_cflag |= PARODD;
+        }
+        else
+        {
+            options.c_cflag &= ~PARODD;
+        }
+        if(tcsetattr(contextP->fd, TCSANOW, &options) != 0)
+        {
+            fprintf (stdout, "Setting the parity of the serial interface failed.\n");
+            Serial_Close(transportP);
+            return false;
+        }
     }
 
     return true;
 }
 
-bool DeinitSerial()
+static bool Serial_Close(Transport_t *transportP)
+{
+    Serial_Context_t *contextP = transportP->contextP;
+
+    if(contextP->fd >= 0)
+    {
+        /*empty UART buffer and close connection*/
+        serialFlush(contextP->fd);
+        serialClose(contextP->fd);
+        contextP->fd = -1;
+    }
+    return true;
+}
+
+static bool Serial_Flush(Transport_t *transportP)
 {
+    Serial_Context_t *contextP = transportP->contextP;
+
+    if(contextP->fd >= 0)
+    {
+        /* empty UART buffer */
+        serialFlush(contextP->fd);
+    }
     return true;
 }
 
-bool OpenSerial(int baudrate)
+static bool Serial_SendBytes(Transport_t *transportP, uint8_t *dataP, uint16_t length)
 {
-    /* start serial interface */
-    if ((*serial_handleP = serialOpen ("/dev/serial0", baudrate)) < 0)
+    struct iovec data = { .iov_base = dataP, .iov_len = length };
+
+    return Serial_SendFrame(transportP, &data, 1);
+}
+
+static bool Serial_SendFrame(Transport_t *transportP, const struct iovec *iov, int n)
+{
+    Serial_Context_t *contextP = transportP->contextP;
+    int first = 0;
+    ssize_t written;
+
+    if((contextP->fd < 0) || (n <= 0))
     {
-        fprintf (stdout, "Opening the serial interface failed. Probably invalid serial configuration.\n");
-        return false ;
+        return false;
+    }
+
+    /* copy of the parts, adjusted in case the kernel takes the frame in several steps */
+    struct iovec remaining[n];
+    memcpy(remaining, iov, n * sizeof(struct iovec));
+
+    while(first < n)
+    {
+        written = writev(contextP->fd, &remaining[first], n - first);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            if((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                /* TX buffer of the interface is full */
+                struct pollfd pfd = { .fd = contextP->fd, .events = POLLOUT };
+                poll(&pfd, 1, -1);
+                continue;
+            }
+            fprintf(stdout, "SendFrame failed: %s\n", strerror(errno));
+            return false;
+        }
+
+        /* skip the parts written completely and continue within a partially written one */
+        while((first < n) && ((size_t)written >= remaining[first].iov_len))
+        {
+            written -= remaining[first].iov_len;
+            first++;
+        }
+        if(first < n)
+        {
+            remaining[first].iov_base = (uint8_t*)remaining[first].iov_base + written;
+            remaining[first].iov_len -= written;
+        }
+    }
+
+    return true;
+}
+
+static bool Serial_ReadBytes(Transport_t *transportP, uint8_t *buf, size_t max, size_t *got, int timeout_ms)
+{
+    Serial_Context_t *contextP = transportP->contextP;
+    int availableBytes = 0;
+    ssize_t bytesRead;
+
+    *got = 0;
+    if((contextP->fd < 0) || (max == 0))
+    {
+        return false;
+    }
+
+    if(ioctl(contextP->fd, FIONREAD, &availableBytes) == -1)
+    {
+        return false;
+    }
+
+    if((availableBytes == 0) && (timeout_ms != 0))
+    {
+        /* nothing buffered yet, sleep in the kernel until the first byte arrives */
+        struct pollfd pfd;
+        pfd.fd = contextP->fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if(poll(&pfd, 1, timeout_ms) <= 0)
+        {
+            /* timeout (or interrupted): report an empty read */
+            return true;
+        }
+        availableBytes = (int)max;
+    }
+
+    if(availableBytes == 0)
+    {
+        return true;
+    }
+
+    /* the termios settings of wiringSerial (VMIN = 0) let read() return what is
+     * buffered instead of waiting for the complete request */
+    bytesRead = read(contextP->fd, buf, ((size_t)availableBytes < max) ? (size_t)availableBytes : max);
+    if(bytesRead < 0)
+    {
+        return (errno == EINTR) || (errno == EAGAIN);
+    }
+
+    *got = (size_t)bytesRead;
+    return true;
+}
+
+static int Serial_GetFd(Transport_t *transportP)
+{
+    Serial_Context_t *contextP = transportP->contextP;
+    return contextP->fd;
+}
+
+static Serial_RxWait_t Serial_WaitForRxData(Transport_t *transportP, int eventFd, int timeout_ms)
+{
+    Serial_Context_t *contextP = transportP->contextP;
+    struct pollfd pfd[2];
+    nfds_t count = 0;
+    int eventIndex = -1;
+    int serialIndex = -1;
+    int ret;
+
+    if(eventFd >= 0)
+    {
+        eventIndex = count;
+        pfd[count].fd = eventFd;
+        pfd[count].events = POLLIN;
+        pfd[count].revents = 0;
+        count++;
+    }
+    if(contextP->fd >= 0)
+    {
+        /* while the interface is closed only the event is waited for */
+        serialIndex = count;
+        pfd[count].fd = contextP->fd;
+        pfd[count].events = POLLIN;
+        pfd[count].revents = 0;
+        count++;
+    }
+    if(count == 0)
+    {
+        return Serial_RxWait_Error;
+    }
+
+    ret = poll(pfd, count, timeout_ms);
+    if(ret == 0)
+    {
+        return Serial_RxWait_Timeout;
+    }
+    if(ret < 0)
+    {
+        return (errno == EINTR) ? Serial_RxWait_Timeout : Serial_RxWait_Error;
+    }
+
+    if((eventIndex >= 0) && (pfd[eventIndex].revents & POLLIN))
+    {
+        return Serial_RxWait_Event;
+    }
+    if((serialIndex >= 0) && (pfd[serialIndex].revents & POLLIN))
+    {
+        return Serial_RxWait_Data;
+    }
+    return Serial_RxWait_Error;
+}
+
+static bool Serial_InitPin(Transport_t *transportP, int pin_number)
+{
+    /* wiringPi has to be set up before the pins can be used */
+    pthread_once(&wiringPi_once, Serial_SetupWiringPi);
+    return wiringPi_ready;
+}
+
+static bool Serial_DeinitPin(Transport_t *transportP, int pin_number)
+{
+    return true;
+}
+
+static bool Serial_SetPin(Transport_t *transportP, int pin_number, SetPin_InputOutput_t inout, SetPin_Pull_t pull, SetPin_Out_t out)
+{
+    if(pin_number == PIN_INVALID)
+    {
+        /* pin not connected, e.g. a module on an USB serial adapter */
+        return true;
+    }
+
+    switch(inout)
+    {
+        case SetPin_InputOutput_Input:
+        {
+            switch(pull)
+            {
+                case SetPin_Pull_Up:
+                {
+                    pullUpDnControl(pin_number, PUD_UP);
+                }
+                break;
+
+                case SetPin_Pull_Down:
+                {
+                    pullUpDnControl(pin_number, PUD_DOWN);
+                }
+                break;
+
+                case SetPin_Pull_No:
+                {
+                    pullUpDnControl(pin_number, PUD_OFF);
+                }
+                break;
+
+                default:
+                {
+                    return false;
+                }
+                break;
+            }
+            pinMode (pin_number, INPUT) ;
+        }
+        break;
+
+        case SetPin_InputOutput_Output:
+        {
+            switch(out)
+            {
+                case SetPin_Out_Low:
+                {
+                    digitalWrite (pin_number, LOW) ;
+                }
+                break;
+
+                case SetPin_Out_High:
+                {
+                    digitalWrite (pin_number, HIGH) ;
+                }
+                break;
+
+                default:
+                {
+                    return false;
+                }
+                break;
+            }
+            pinMode (pin_number, OUTPUT) ;
+            pullUpDnControl(pin_number, PUD_OFF);
+        }
+        break;
+
+        default:
+        {
+            return false;
+        }
+        break;
     }
 
     return true;
 }
 
-#endif // _global_serial_defined
+static void Serial_Destroy(Transport_t *transportP)
+{
+    Serial_Close(transportP);
+    free(transportP->contextP);
+    free(transportP);
+}
+
 #ifdef __cplusplus
 }
 #endif